@@ -24,7 +24,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <amp.h>
+#include <ppl.h>
 #include <wrl\client.h>
 
 #include <xx_amp_algorithms_impl.h>
@@ -345,23 +352,6 @@ namespace amp_algorithms
         ::amp_algorithms::generate(_details::auto_select_target(), output_view, generator);
     }
 
-    //----------------------------------------------------------------------------
-    // merge_sort
-    //----------------------------------------------------------------------------
-
-    // TODO: NOT IMPLEMENTED radix_sort
-    template <typename T, typename BinaryOperator>
-    void merge_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<unsigned int>& input_view, BinaryOperator op)
-    {
-    }
-
-    // TODO: NOT IMPLEMENTED radix_sort
-    template <typename T>
-    void merge_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<unsigned int>& input_view)
-    {
-        ::amp_algorithms::merge_sort(accl_view, input_view, amp_algorithms::less<T>());
-    }
-
     //----------------------------------------------------------------------------
     // padded_read & padded_write
     //----------------------------------------------------------------------------
@@ -408,7 +398,6 @@ namespace amp_algorithms
 
     // "Histogram Calculation in CUDA" http://docs.nvidia.com/cuda/samples/3_Imaging/histogram/doc/histogram.pdf
 
-    // TODO: Move this to the impl file?
     namespace _details
     {
         template<typename T, int key_size>
@@ -418,171 +407,473 @@ namespace amp_algorithms
             return (value & (mask << key_idx)) >> key_idx;
         }
 
-        // TODO: T is limited to only integer types. Need to modify the template to restrict this.
-        template <typename T, int key_size, int tile_size>
-        void radix_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& input_view)
+        // Maps a key onto an unsigned integer with the same ordering so that the sort only ever has to
+        // deal with unsigned digits. Signed integers have their sign bit flipped, floating point values
+        // have all bits flipped when negative and only the sign bit flipped otherwise. 64-bit keys are
+        // only supported by the host implementation as C++ AMP has no 64-bit integer types.
+
+        template <typename T>
+        struct radix_key_traits
         {
-        }
+            static const bool is_supported = false;
+            static const bool is_amp_supported = false;
+        };
 
-        template <typename T, int key_size, int tile_size>
-        void histogram_tile(const concurrency::array_view<T>& input_view, concurrency::array_view<T>& output_view,
-            const int key_idx)
+        template <>
+        struct radix_key_traits<unsigned int>
         {
-            static const unsigned type_width = sizeof(T)* 8;
-            static_assert((type_width % key_size == 0), "The sort key width must be an exact multiple of the type width.");
+            static const bool is_supported = true;
+            static const bool is_amp_supported = true;
+            typedef unsigned int key_type;
 
-            static const unsigned bin_count = 1 << key_size;
-            static const T bin_mask = bin_count - 1;
-            static const int elements_per_thread = 1;          // TODO: Doesn't have to be a constant?
+            static key_type to_key(const unsigned int value) restrict(cpu, amp) { return value; }
+            static unsigned int from_key(const key_type key) restrict(cpu, amp) { return key; }
+        };
 
-            // histogram all elements in a block
-            concurrency::array<unsigned> histogram_bins(bin_count);
+        template <>
+        struct radix_key_traits<int>
+        {
+            static const bool is_supported = true;
+            static const bool is_amp_supported = true;
+            typedef unsigned int key_type;
 
-            concurrency::tiled_extent<tile_size> compute_domain = input_view.get_extent().tile<tile_size>().pad();
+            static key_type to_key(const int value) restrict(cpu, amp) { return static_cast<key_type>(value) ^ 0x80000000U; }
+            static int from_key(const key_type key) restrict(cpu, amp) { return static_cast<int>(key ^ 0x80000000U); }
+        };
 
-            concurrency::parallel_for_each(compute_domain,
-                [=, &histogram_bins](concurrency::tiled_index<tile_size> tidx) restrict(amp)
+        template <>
+        struct radix_key_traits<float>
+        {
+            static const bool is_supported = true;
+            static const bool is_amp_supported = true;
+            typedef unsigned int key_type;
+
+            static key_type to_key(const float value) restrict(cpu)
             {
-                // Each thread has its own histogram
-                tile_static unsigned bins[tile_size][bin_count];
-                const int gidx = tidx.global[0];
-                const int idx = tidx.local[0];
-                const int start_elem = idx * elements_per_thread;
+                key_type bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                return bits ^ ((bits & 0x80000000U) ? 0xFFFFFFFFU : 0x80000000U);
+            }
 
-                // One thread initializes the global histogram bins.
-                if (gidx == 0)
-                {
-                    for (int b = 0; b < bin_count; ++b)
-                    {
-                        histogram_bins(b) = 0;
-                    }
-                }
+            static key_type to_key(const float value) restrict(amp)
+            {
+                const key_type bits = concurrency::direct3d::asuint(value);
+                return bits ^ ((bits & 0x80000000U) ? 0xFFFFFFFFU : 0x80000000U);
+            }
 
-                // Initialize bins for this thread
-                for (int b = 0; b < bin_count; ++b)
-                {
-                    bins[idx][b] = 0u;
-                }
+            static float from_key(const key_type key) restrict(cpu)
+            {
+                const key_type bits = key ^ ((key & 0x80000000U) ? 0x80000000U : 0xFFFFFFFFU);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
 
-                // Increment bins for each element.
-                for (int i = start_elem; i < (start_elem + elements_per_thread); ++i)
-                {
-                    if (gidx < input_view.extent[0])
-                        bins[idx][_details::radix_key_value<T, key_size>(input_view[gidx], key_idx)]++;
-                }
+            static float from_key(const key_type key) restrict(amp)
+            {
+                return concurrency::direct3d::asfloat(key ^ ((key & 0x80000000U) ? 0x80000000U : 0xFFFFFFFFU));
+            }
+        };
 
-                // Wait for all threads to finish incrementing.
-                tidx.barrier.wait();
+        template <>
+        struct radix_key_traits<unsigned long long>
+        {
+            static const bool is_supported = true;
+            static const bool is_amp_supported = false;
+            typedef unsigned long long key_type;
 
-                // TODO: This could be more efficient. Don't do it all on one thread.
-                // Thread zero merges local histograms.
-                if (idx == 0)
-                {
-                    for (int i = 1; i < tile_size; ++i)
-                    {
-                        merge_bins(bins[0], bins[i], bin_count);
-                    }
+            static key_type to_key(const unsigned long long value) { return value; }
+            static unsigned long long from_key(const key_type key) { return key; }
+        };
 
-                    // TODO: This isn't smart either but it'll get things working.
+        template <>
+        struct radix_key_traits<long long>
+        {
+            static const bool is_supported = true;
+            static const bool is_amp_supported = false;
+            typedef unsigned long long key_type;
 
-                    for (int b = 0; b < bin_count; ++b)
-                    {
-                        concurrency::atomic_fetch_add(&histogram_bins(b), bins[0][b]);
-                    }
-                }
-            });
+            static key_type to_key(const long long value) { return static_cast<key_type>(value) ^ 0x8000000000000000ULL; }
+            static long long from_key(const key_type key) { return static_cast<long long>(key ^ 0x8000000000000000ULL); }
+        };
 
-#if _DEBUG
+        template <>
+        struct radix_key_traits<double>
+        {
+            static const bool is_supported = true;
+            static const bool is_amp_supported = false;
+            typedef unsigned long long key_type;
+
+            static key_type to_key(const double value)
             {
-                std::vector<unsigned> bins(4);
-                concurrency::copy(histogram_bins, begin(bins));
+                key_type bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                return bits ^ ((bits & 0x8000000000000000ULL) ? 0xFFFFFFFFFFFFFFFFULL : 0x8000000000000000ULL);
             }
-#endif
-            // prefix scan the histogram results to get offsets.
-            // TODO: This scan supports multi-tile. Probably need a simpler version that uses only one tile.
-            concurrency::array<unsigned> histogram_scan(bin_count);
-            amp_algorithms::scan s(2 * bin_count);
-            s.scan_exclusive(histogram_bins, histogram_bins);
 
-#if _DEBUG
+            static double from_key(const key_type key)
             {
-                std::vector<unsigned> scans(4);
-                concurrency::copy(histogram_bins, begin(scans));
+                const key_type bits = key ^ ((key & 0x8000000000000000ULL) ? 0x8000000000000000ULL : 0xFFFFFFFFFFFFFFFFULL);
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
             }
-#endif
-            // Sort elements for each tile to maximise memory affinity when writing to global memory.
+        };
+    }
 
-            // reorder the elements based on the offsets.
+    //----------------------------------------------------------------------------
+    // reduce
+    //----------------------------------------------------------------------------
 
-            concurrency::parallel_for_each(compute_domain,
-                [=, &histogram_bins](concurrency::tiled_index<tile_size> tidx) restrict(amp)
-            {
-                const int gidx = tidx.global[0];
-                const int idx = tidx.local[0];
+    // Generic reduction template for binary operators that are commutative and associative
+    template <typename InputIndexableView, typename BinaryFunction>
+    typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
+        reduce(const concurrency::accelerator_view &accl_view, const InputIndexableView &input_view, const BinaryFunction &binary_op)
+    {
+            return _details::reduce<512, 10000, InputIndexableView, BinaryFunction>(accl_view, input_view, binary_op);
+    }
 
-                const int d = idx - 0;
-                output_view[d] = input_view[];
-            });
-        }
+    template <typename InputIndexableView, typename BinaryFunction>
+    typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
+        reduce(const InputIndexableView &input_view, const BinaryFunction &binary_op)
+    {
+            return reduce(_details::auto_select_target(), input_view, binary_op);
     }
 
-    template<typename T>
-    inline void merge_bins(T* left, T*  right, const int bin_count) restrict(amp)
+    //----------------------------------------------------------------------------
+    // transform_reduce, reduction_tuple, tuple_reduction
+    //----------------------------------------------------------------------------
+    //
+    // transform_reduce applies the transform as each element is read, so transforming and reducing a
+    // view takes a single pass. To evaluate several reductions in the same pass, the transform
+    // returns a reduction_tuple and the reduction is a tuple_reduction, which applies one operator to each
+    // component. For example, the sum, sum of squares, minimum and maximum of a view:
+    //
+    //      auto stats = transform_reduce(input_view,
+    //          [=](const float& x) restrict(cpu, amp) { return make_reduction_tuple(x, x * x, x, x); },
+    //          make_tuple_reduction(plus<float>(), plus<float>(), min<float>(), max<float>()));
+    //
+    // Like reduce, the operators must be associative and commutative.
+
+    template <typename T, int N>
+    struct reduction_tuple
     {
-        for (int b = 0; b < bin_count; ++b)
+        T values[N];
+
+        T& operator[](const int i) restrict(cpu, amp)
+        {
+            return values[i];
+        }
+
+        const T& operator[](const int i) const restrict(cpu, amp)
         {
-            left[b] += right[b];
+            return values[i];
         }
+    };
+
+    template <typename T>
+    inline reduction_tuple<T, 2> make_reduction_tuple(const T& v0, const T& v1) restrict(cpu, amp)
+    {
+        reduction_tuple<T, 2> result;
+        result.values[0] = v0;
+        result.values[1] = v1;
+        return result;
     }
 
-    // TODO: NOT IMPLEMENTED radix_sort
-    inline void radix_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<int>& input_view)
+    template <typename T>
+    inline reduction_tuple<T, 3> make_reduction_tuple(const T& v0, const T& v1, const T& v2) restrict(cpu, amp)
     {
-        static const int bin_width = 4;
-        static const int tile_size = 256;
-        ::amp_algorithms::_details::radix_sort<int, bin_width, tile_size>(accl_view, input_view);
+        reduction_tuple<T, 3> result;
+        result.values[0] = v0;
+        result.values[1] = v1;
+        result.values[2] = v2;
+        return result;
     }
 
-    // TODO: NOT IMPLEMENTED radix_sort
-    inline void radix_sort(concurrency::array_view<int>& input_view)
+    template <typename T>
+    inline reduction_tuple<T, 4> make_reduction_tuple(const T& v0, const T& v1, const T& v2, const T& v3) restrict(cpu, amp)
     {
-        radix_sort(_details::auto_select_target(), input_view);
+        reduction_tuple<T, 4> result;
+        result.values[0] = v0;
+        result.values[1] = v1;
+        result.values[2] = v2;
+        result.values[3] = v3;
+        return result;
     }
 
-    /*
-    inline void radix_sort(concurrency::array_view<int>& input_view, const unsigned int digit_width)
+    namespace _details
     {
-    ::amp_algorithms::_details::radix_sort<int, 4>(_details::auto_select_target(), input_view);
+        // Placeholder for the unused operators of a tuple_reduction.
+        class unused_reduction
+        {
+        public:
+            template <typename T>
+            T operator()(const T& a, const T&) const restrict(cpu, amp)
+            {
+                return a;
+            }
+        };
     }
 
-    inline void radix_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<unsigned int>& input_view, const unsigned int digit_width)
+    template <typename Op0, typename Op1, typename Op2 = _details::unused_reduction, typename Op3 = _details::unused_reduction>
+    class tuple_reduction
+    {
+    public:
+        tuple_reduction(const Op0& op0, const Op1& op1, const Op2& op2 = Op2(), const Op3& op3 = Op3()) :
+            m_op0(op0), m_op1(op1), m_op2(op2), m_op3(op3)
+        {
+        }
+
+        template <typename T, int N>
+        reduction_tuple<T, N> operator()(const reduction_tuple<T, N>& a, const reduction_tuple<T, N>& b) const restrict(cpu, amp)
+        {
+            static_assert((N >= 2) && (N <= 4), "A tuple_reduction has between two and four operators.");
+
+            // The indices of unused components are clamped so they compile for shorter tuples.
+            reduction_tuple<T, N> result;
+            result.values[0] = m_op0(a.values[0], b.values[0]);
+            result.values[1] = m_op1(a.values[1], b.values[1]);
+            if (N > 2)
+            {
+                result.values[(N > 2) ? 2 : 0] = m_op2(a.values[(N > 2) ? 2 : 0], b.values[(N > 2) ? 2 : 0]);
+            }
+            if (N > 3)
+            {
+                result.values[(N > 3) ? 3 : 0] = m_op3(a.values[(N > 3) ? 3 : 0], b.values[(N > 3) ? 3 : 0]);
+            }
+            return result;
+        }
+
+        const Op0& op0() const { return m_op0; }
+        const Op1& op1() const { return m_op1; }
+        const Op2& op2() const { return m_op2; }
+        const Op3& op3() const { return m_op3; }
+
+    private:
+        Op0 m_op0;
+        Op1 m_op1;
+        Op2 m_op2;
+        Op3 m_op3;
+    };
+
+    template <typename Op0, typename Op1>
+    inline tuple_reduction<Op0, Op1> make_tuple_reduction(const Op0& op0, const Op1& op1)
     {
-    ::amp_algorithms::_details::radix_sort<unsigned int, 4>(accl_view, input_view);
+        return tuple_reduction<Op0, Op1>(op0, op1);
     }
 
-    inline void radix_sort(concurrency::array_view<unsigned int>& input_view)
+    template <typename Op0, typename Op1, typename Op2>
+    inline tuple_reduction<Op0, Op1, Op2> make_tuple_reduction(const Op0& op0, const Op1& op1, const Op2& op2)
     {
-    ::amp_algorithms::_details::radix_sort<unsigned int, 4>(_details::auto_select_target(), input_view);
+        return tuple_reduction<Op0, Op1, Op2>(op0, op1, op2);
     }
-    */
 
-    //----------------------------------------------------------------------------
-    // reduce
-    //----------------------------------------------------------------------------
+    template <typename Op0, typename Op1, typename Op2, typename Op3>
+    inline tuple_reduction<Op0, Op1, Op2, Op3> make_tuple_reduction(const Op0& op0, const Op1& op1, const Op2& op2, const Op3& op3)
+    {
+        return tuple_reduction<Op0, Op1, Op2, Op3>(op0, op1, op2, op3);
+    }
 
-    // Generic reduction template for binary operators that are commutative and associative
-    template <typename InputIndexableView, typename BinaryFunction>
-    typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
-        reduce(const concurrency::accelerator_view &accl_view, const InputIndexableView &input_view, const BinaryFunction &binary_op)
+    template <typename InputIndexableView, typename UnaryFunction, typename BinaryFunction>
+    typename std::result_of<UnaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
+        transform_reduce(const concurrency::accelerator_view &accl_view, const InputIndexableView &input_view, const UnaryFunction &transform_op, const BinaryFunction &binary_op)
     {
-            return _details::reduce<512, 10000, InputIndexableView, BinaryFunction>(accl_view, input_view, binary_op);
+            return _details::transform_reduce<512, 10000>(accl_view, input_view, transform_op, binary_op);
     }
 
-    template <typename InputIndexableView, typename BinaryFunction>
-    typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
-        reduce(const InputIndexableView &input_view, const BinaryFunction &binary_op)
+    template <typename InputIndexableView, typename UnaryFunction, typename BinaryFunction>
+    typename std::result_of<UnaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
+        transform_reduce(const InputIndexableView &input_view, const UnaryFunction &transform_op, const BinaryFunction &binary_op)
     {
-            return reduce(_details::auto_select_target(), input_view, binary_op);
+            return transform_reduce(_details::auto_select_target(), input_view, transform_op, binary_op);
+    }
+
+    //----------------------------------------------------------------------------
+    // reduce, transform_reduce - host implementation
+    //----------------------------------------------------------------------------
+    //
+    // Each worker reduces one chunk of the input into reduce_lane_count independent accumulators, one per
+    // SIMD lane, and combines the lanes at the end. A tuple_reduction keeps the lanes of each operator
+    // next to each other, so every operator is applied to a contiguous block of lanes that the compiler can
+    // vectorize.
+
+    namespace host
+    {
+        namespace _details
+        {
+            static const int reduce_lane_count = 8;
+
+            template <typename T, typename BinaryFunction>
+            class lane_accumulator
+            {
+            public:
+                lane_accumulator(const T (&values)[reduce_lane_count], const BinaryFunction& op) : m_op(op)
+                {
+                    std::copy(values, values + reduce_lane_count, m_lanes);
+                }
+
+                void accumulate(const T (&values)[reduce_lane_count])
+                {
+                    for (int l = 0; l < reduce_lane_count; ++l)
+                    {
+                        m_lanes[l] = m_op(m_lanes[l], values[l]);
+                    }
+                }
+
+                T result() const
+                {
+                    T result = m_lanes[0];
+                    for (int l = 1; l < reduce_lane_count; ++l)
+                    {
+                        result = m_op(result, m_lanes[l]);
+                    }
+                    return result;
+                }
+
+            private:
+                BinaryFunction m_op;
+                T m_lanes[reduce_lane_count];
+            };
+
+            template <typename T, int N, typename Op0, typename Op1, typename Op2, typename Op3>
+            class lane_accumulator<reduction_tuple<T, N>, tuple_reduction<Op0, Op1, Op2, Op3>>
+            {
+            public:
+                typedef reduction_tuple<T, N> tuple_type;
+
+                lane_accumulator(const tuple_type (&values)[reduce_lane_count], const tuple_reduction<Op0, Op1, Op2, Op3>& op) : m_op(op)
+                {
+                    for (int k = 0; k < N; ++k)
+                    {
+                        for (int l = 0; l < reduce_lane_count; ++l)
+                        {
+                            m_lanes[k][l] = values[l].values[k];
+                        }
+                    }
+                }
+
+                void accumulate(const tuple_type (&values)[reduce_lane_count])
+                {
+                    accumulate_component<0>(m_op.op0(), values);
+                    accumulate_component<1>(m_op.op1(), values);
+                    accumulate_component<2>(m_op.op2(), values);
+                    accumulate_component<3>(m_op.op3(), values);
+                }
+
+                tuple_type result() const
+                {
+                    tuple_type result;
+                    result_component<0>(m_op.op0(), result);
+                    result_component<1>(m_op.op1(), result);
+                    result_component<2>(m_op.op2(), result);
+                    result_component<3>(m_op.op3(), result);
+                    return result;
+                }
+
+            private:
+                template <int K, typename BinaryFunction>
+                void accumulate_component(const BinaryFunction& op, const tuple_type (&values)[reduce_lane_count])
+                {
+                    static const int k = (K < N) ? K : 0;
+                    if (K < N)
+                    {
+                        for (int l = 0; l < reduce_lane_count; ++l)
+                        {
+                            m_lanes[k][l] = op(m_lanes[k][l], values[l].values[k]);
+                        }
+                    }
+                }
+
+                template <int K, typename BinaryFunction>
+                void result_component(const BinaryFunction& op, tuple_type& result) const
+                {
+                    static const int k = (K < N) ? K : 0;
+                    if (K < N)
+                    {
+                        result.values[k] = m_lanes[k][0];
+                        for (int l = 1; l < reduce_lane_count; ++l)
+                        {
+                            result.values[k] = op(result.values[k], m_lanes[k][l]);
+                        }
+                    }
+                }
+
+                tuple_reduction<Op0, Op1, Op2, Op3> m_op;
+                T m_lanes[N][reduce_lane_count];
+            };
+        }
+
+        // Returns a value initialized result for an empty range.
+        template <typename InIt, typename UnaryFunction, typename BinaryFunction>
+        typename std::result_of<UnaryFunction(const typename std::iterator_traits<InIt>::value_type&)>::type
+            transform_reduce(InIt first, InIt last, const UnaryFunction& transform_op, const BinaryFunction& binary_op)
+        {
+            typedef typename std::result_of<UnaryFunction(const typename std::iterator_traits<InIt>::value_type&)>::type result_type;
+            static const int lane_count = _details::reduce_lane_count;
+            static const size_t min_chunk_size = 16384;
+
+            const size_t element_count = size_t(std::distance(first, last));
+            if (element_count == 0)
+            {
+                return result_type();
+            }
+
+            const size_t max_chunks = (element_count + min_chunk_size - 1) / min_chunk_size;
+            const size_t chunk_count = std::min<size_t>(concurrency::GetProcessorCount(), max_chunks);
+            const size_t chunk_size = (element_count + chunk_count - 1) / chunk_count;
+            std::vector<result_type> partials(chunk_count);
+
+            concurrency::parallel_for(size_t(0), chunk_count, [=, &partials](size_t c)
+            {
+                const size_t chunk_last = std::min(element_count, (c + 1) * chunk_size);
+                size_t i = c * chunk_size;
+                result_type result;
+                if (chunk_last - i >= size_t(lane_count))
+                {
+                    result_type values[lane_count];
+                    for (int l = 0; l < lane_count; ++l)
+                    {
+                        values[l] = transform_op(first[i + l]);
+                    }
+                    i += lane_count;
+
+                    _details::lane_accumulator<result_type, BinaryFunction> lanes(values, binary_op);
+                    for (; i + lane_count <= chunk_last; i += lane_count)
+                    {
+                        for (int l = 0; l < lane_count; ++l)
+                        {
+                            values[l] = transform_op(first[i + l]);
+                        }
+                        lanes.accumulate(values);
+                    }
+                    result = lanes.result();
+                }
+                else
+                {
+                    result = transform_op(first[i++]);
+                }
+
+                for (; i < chunk_last; ++i)
+                {
+                    result = binary_op(result, transform_op(first[i]));
+                }
+                partials[c] = result;
+            });
+
+            result_type result = partials[0];
+            for (size_t c = 1; c < chunk_count; ++c)
+            {
+                result = binary_op(result, partials[c]);
+            }
+            return result;
+        }
+
+        template <typename InIt, typename BinaryFunction>
+        typename std::iterator_traits<InIt>::value_type reduce(InIt first, InIt last, const BinaryFunction& binary_op)
+        {
+            typedef typename std::iterator_traits<InIt>::value_type T;
+            return ::amp_algorithms::host::transform_reduce(first, last, amp_algorithms::_details::identity<T>(), binary_op);
+        }
     }
 
     //----------------------------------------------------------------------------
@@ -911,36 +1202,903 @@ namespace amp_algorithms
         });
     }
 
-    // TODO: Refactor this to remove duplicate code. Also need to decide on final API.
+    //----------------------------------------------------------------------------
+    // scan_single_pass, segmented_scan_single_pass
+    //----------------------------------------------------------------------------
+    //
+    // Single pass scan with decoupled look-back, see "Single-pass Parallel Prefix Scan with Decoupled
+    // Look-back" https://research.nvidia.com/publication/single-pass-parallel-prefix-scan-decoupled-look-back
+    //
+    // scan_new reads the input once to reduce the tiles and again to scan them, and scans the tile results
+    // in separate kernels. Here each tile scans its elements in tile_static memory and publishes its
+    // aggregate together with a status flag. The first thread of the tile then walks back over the
+    // published results of the preceding tiles, adding up aggregates until it reaches a tile that has
+    // published its inclusive prefix, and publishes its own inclusive prefix in turn. Every element is read
+    // and written exactly once, about 2n of memory traffic rather than 3n.
+    //
+    // Tiles take their position in the scan in the order they start, from an atomic counter, so a tile only
+    // ever waits on tiles that are already running.
+    //
+    // The segmented scan is the same scan of (value, flag) pairs with an operator that restarts at every
+    // element whose flag is set. As with direct3d::scan a set flag marks the first element of a segment.
 
-    template <int TileSize, typename InIt, typename OutIt>
-    inline void scan_exclusive_new(InIt first, InIt last, OutIt dest_first)
+    namespace _details
     {
-        typedef InIt::value_type T;
+        static const unsigned int scan_status_invalid = 0;
+        static const unsigned int scan_status_aggregate = 1;
+        static const unsigned int scan_status_prefix = 2;
 
-        const int size = int(std::distance(first, last));
-        concurrency::array<T, 1> in(size);
-        concurrency::array<T, 1> out(size);
-        concurrency::copy(first, last, in);
+        template <typename T>
+        struct segmented_value
+        {
+            T value;
+            unsigned int flag;
+        };
 
-        scan_new<TileSize, amp_algorithms::scan_mode::exclusive>(in, out, amp_algorithms::plus<T>());
+        template <typename T>
+        inline segmented_value<T> make_segmented_value(const T& value, const unsigned int flag) restrict(cpu, amp)
+        {
+            segmented_value<T> result;
+            result.value = value;
+            result.flag = flag;
+            return result;
+        }
 
-        concurrency::copy(out, dest_first);
-    }
+        template <typename T, typename BinaryOp>
+        class segmented_op
+        {
+        public:
+            segmented_op(const BinaryOp& op) : m_op(op)
+            {
+            }
 
-    template <int TileSize, typename InIt, typename OutIt>
-    inline void scan_inclusive_new(InIt first, InIt last, OutIt dest_first)
-    {
-        typedef InIt::value_type T;
+            segmented_value<T> operator()(const segmented_value<T>& a, const segmented_value<T>& b) const restrict(cpu, amp)
+            {
+                return make_segmented_value((b.flag != 0) ? b.value : m_op(a.value, b.value), a.flag | b.flag);
+            }
 
-        const int size = int(std::distance(first, last));
-        concurrency::array<T, 1> in(size);
-        concurrency::array<T, 1> out(size);
-        concurrency::copy(first, last, in);
+        private:
+            BinaryOp m_op;
+        };
 
-        scan_new<TileSize, amp_algorithms::scan_mode::inclusive>(in, out, amp_algorithms::plus<T>());
+        // Scans element_count values, load(i) returns the i-th value and store(i, exclusive, inclusive) is
+        // given both scan results for it.
+        template <int TileSize, typename T, typename LoadFunc, typename StoreFunc, typename BinaryOp>
+        void scan_single_pass(const concurrency::accelerator_view& accl_view, const int element_count, const LoadFunc& load, const StoreFunc& store, const BinaryOp& op)
+        {
+            static_assert(TileSize >= _details::warp_size, "Tile size must be at least the size of a single warp.");
+            static_assert(TileSize % _details::warp_size == 0, "Tile size must be an exact multiple of warp size.");
+            static_assert(TileSize <= (_details::warp_size * _details::warp_size), "Tile size must less than or equal to the square of the warp size.");
 
-        concurrency::copy(out, dest_first);
+            if (element_count <= 0)
+            {
+                return;
+            }
+
+            // The last status element is the counter that hands out tile positions.
+            const int tile_count = (element_count + TileSize - 1) / TileSize;
+            concurrency::array<unsigned int> status(tile_count + 1, accl_view);
+            concurrency::array<T> aggregates(tile_count, accl_view);
+            concurrency::array<T> prefixes(tile_count, accl_view);
+            concurrency::array_view<unsigned int> status_vw(status);
+            concurrency::array_view<T> aggregates_vw(aggregates);
+            concurrency::array_view<T> prefixes_vw(prefixes);
+            amp_algorithms::fill(accl_view, status_vw, scan_status_invalid);
+
+            concurrency::tiled_extent<TileSize> compute_domain = concurrency::extent<1>(element_count).tile<TileSize>().pad();
+            concurrency::parallel_for_each(accl_view, compute_domain, [=](concurrency::tiled_index<TileSize> tidx) restrict(amp)
+            {
+                tile_static T tile_data[TileSize];
+                tile_static T tile_prefix;
+                tile_static int tile_id;
+                const int lidx = tidx.local[0];
+
+                if (lidx == 0)
+                {
+                    tile_id = int(concurrency::atomic_fetch_inc(&status_vw[tile_count]));
+                }
+                tidx.barrier.wait_with_tile_static_memory_fence();
+
+                const int gidx = tile_id * TileSize + lidx;
+                tile_data[lidx] = (gidx < element_count) ? load(gidx) : T();
+                tidx.barrier.wait_with_tile_static_memory_fence();
+
+                const T inclusive = _details::scan_tile<TileSize, scan_mode::inclusive>(tile_data, tidx, op);
+
+                if ((lidx == 0) && (tile_id > 0))
+                {
+                    const T aggregate = tile_data[TileSize - 1];
+                    aggregates_vw[tile_id] = aggregate;
+                    concurrency::global_memory_fence(tidx.barrier);
+                    concurrency::atomic_exchange(&status_vw[tile_id], scan_status_aggregate);
+
+                    // Look back until a tile with an inclusive prefix is found.
+                    T prefix = T();
+                    bool has_prefix = false;
+                    for (int p = tile_id - 1; ; --p)
+                    {
+                        unsigned int predecessor_status;
+                        do
+                        {
+                            predecessor_status = concurrency::atomic_fetch_add(&status_vw[p], 0u);
+                        }
+                        while (predecessor_status == scan_status_invalid);
+                        concurrency::global_memory_fence(tidx.barrier);
+
+                        const T predecessor = (predecessor_status == scan_status_prefix) ? prefixes_vw[p] : aggregates_vw[p];
+                        prefix = has_prefix ? op(predecessor, prefix) : predecessor;
+                        has_prefix = true;
+                        if (predecessor_status == scan_status_prefix)
+                        {
+                            break;
+                        }
+                    }
+
+                    prefixes_vw[tile_id] = op(prefix, aggregate);
+                    concurrency::global_memory_fence(tidx.barrier);
+                    concurrency::atomic_exchange(&status_vw[tile_id], scan_status_prefix);
+                    tile_prefix = prefix;
+                }
+                else if (lidx == 0)
+                {
+                    prefixes_vw[0] = tile_data[TileSize - 1];
+                    concurrency::global_memory_fence(tidx.barrier);
+                    concurrency::atomic_exchange(&status_vw[0], scan_status_prefix);
+                }
+                tidx.barrier.wait_with_tile_static_memory_fence();
+
+                if (gidx < element_count)
+                {
+                    if (tile_id == 0)
+                    {
+                        store(gidx, (lidx > 0) ? tile_data[lidx - 1] : T(), inclusive);
+                    }
+                    else
+                    {
+                        store(gidx, (lidx > 0) ? op(tile_prefix, tile_data[lidx - 1]) : tile_prefix, op(tile_prefix, inclusive));
+                    }
+                }
+            });
+        }
+    }
+
+    template <int TileSize, scan_mode _Mode, typename ConstInputIndexableView, typename OutputIndexableView, typename BinaryOp>
+    void scan_single_pass(const concurrency::accelerator_view& accl_view, const ConstInputIndexableView& input_view, OutputIndexableView& output_view, const BinaryOp& op)
+    {
+        typedef typename OutputIndexableView::value_type T;
+
+        _details::scan_single_pass<TileSize, T>(accl_view, output_view.extent.size(),
+            [=](const int i) restrict(amp) -> T { return input_view[i]; },
+            [=](const int i, const T& exclusive, const T& inclusive) restrict(amp)
+            {
+                output_view[i] = (_Mode == scan_mode::exclusive) ? exclusive : inclusive;
+            },
+            op);
+    }
+
+    template <int TileSize, scan_mode _Mode, typename ConstInputIndexableView, typename OutputIndexableView, typename BinaryOp>
+    void scan_single_pass(const ConstInputIndexableView& input_view, OutputIndexableView& output_view, const BinaryOp& op)
+    {
+        ::amp_algorithms::scan_single_pass<TileSize, _Mode>(concurrency::accelerator().default_view, input_view, output_view, op);
+    }
+
+    template <int TileSize, scan_mode _Mode, typename ConstInputIndexableView, typename ConstFlagsIndexableView, typename OutputIndexableView, typename BinaryOp>
+    void segmented_scan_single_pass(const concurrency::accelerator_view& accl_view, const ConstInputIndexableView& input_view, const ConstFlagsIndexableView& flags_view, OutputIndexableView& output_view, const BinaryOp& op)
+    {
+        typedef typename OutputIndexableView::value_type T;
+        typedef _details::segmented_value<T> segmented_type;
+
+        _details::scan_single_pass<TileSize, segmented_type>(accl_view, output_view.extent.size(),
+            [=](const int i) restrict(amp) -> segmented_type
+            {
+                return _details::make_segmented_value<T>(input_view[i], (flags_view[i] != 0) ? 1u : 0u);
+            },
+            [=](const int i, const segmented_type& exclusive, const segmented_type& inclusive) restrict(amp)
+            {
+                if (_Mode == scan_mode::exclusive)
+                {
+                    output_view[i] = (flags_view[i] != 0) ? T() : exclusive.value;
+                }
+                else
+                {
+                    output_view[i] = inclusive.value;
+                }
+            },
+            _details::segmented_op<T, BinaryOp>(op));
+    }
+
+    template <int TileSize, scan_mode _Mode, typename ConstInputIndexableView, typename ConstFlagsIndexableView, typename OutputIndexableView, typename BinaryOp>
+    void segmented_scan_single_pass(const ConstInputIndexableView& input_view, const ConstFlagsIndexableView& flags_view, OutputIndexableView& output_view, const BinaryOp& op)
+    {
+        ::amp_algorithms::segmented_scan_single_pass<TileSize, _Mode>(concurrency::accelerator().default_view, input_view, flags_view, output_view, op);
+    }
+
+    //----------------------------------------------------------------------------
+    // scan, segmented_scan - host implementation
+    //----------------------------------------------------------------------------
+    //
+    // The same decoupled look-back on the CPU. Workers claim small chunks in order from an atomic counter,
+    // reduce the chunk, publish the aggregate, look back for their prefix and then scan the chunk, which
+    // is still in cache, into the output. Input and output may be the same range.
+
+    namespace host
+    {
+        namespace _details
+        {
+            template <typename T, typename LoadFunc, typename StoreFunc, typename BinaryOp>
+            void scan_single_pass(const size_t element_count, const LoadFunc& load, const StoreFunc& store, const BinaryOp& op)
+            {
+                static const size_t chunk_size = 4096;
+
+                struct chunk_state
+                {
+                    std::atomic<unsigned int> status;
+                    T aggregate;
+                    T prefix;
+                };
+
+                if (element_count == 0)
+                {
+                    return;
+                }
+
+                const size_t chunk_count = (element_count + chunk_size - 1) / chunk_size;
+                const size_t worker_count = std::min<size_t>(concurrency::GetProcessorCount(), chunk_count);
+                std::unique_ptr<chunk_state[]> chunks(new chunk_state[chunk_count]);
+                for (size_t c = 0; c < chunk_count; ++c)
+                {
+                    chunks[c].status.store(amp_algorithms::_details::scan_status_invalid, std::memory_order_relaxed);
+                }
+                std::atomic<size_t> next_chunk(0);
+
+                // A chunk is only claimed by a running worker and every chunk it waits on was claimed
+                // earlier, so the look-back always makes progress.
+                concurrency::parallel_for(size_t(0), worker_count, [&](size_t)
+                {
+                    for (size_t c = next_chunk++; c < chunk_count; c = next_chunk++)
+                    {
+                        const size_t first = c * chunk_size;
+                        const size_t last = std::min(element_count, first + chunk_size);
+
+                        T aggregate = load(first);
+                        for (size_t i = first + 1; i < last; ++i)
+                        {
+                            aggregate = op(aggregate, load(i));
+                        }
+
+                        T prefix = T();
+                        bool has_prefix = false;
+                        if (c > 0)
+                        {
+                            chunks[c].aggregate = aggregate;
+                            chunks[c].status.store(amp_algorithms::_details::scan_status_aggregate, std::memory_order_release);
+
+                            for (size_t p = c - 1; ; --p)
+                            {
+                                unsigned int predecessor_status;
+                                while ((predecessor_status = chunks[p].status.load(std::memory_order_acquire)) == amp_algorithms::_details::scan_status_invalid)
+                                {
+                                    std::this_thread::yield();
+                                }
+
+                                const T& predecessor = (predecessor_status == amp_algorithms::_details::scan_status_prefix) ? chunks[p].prefix : chunks[p].aggregate;
+                                prefix = has_prefix ? op(predecessor, prefix) : predecessor;
+                                has_prefix = true;
+                                if (predecessor_status == amp_algorithms::_details::scan_status_prefix)
+                                {
+                                    break;
+                                }
+                            }
+                        }
+                        chunks[c].prefix = has_prefix ? op(prefix, aggregate) : aggregate;
+                        chunks[c].status.store(amp_algorithms::_details::scan_status_prefix, std::memory_order_release);
+
+                        T running = prefix;
+                        for (size_t i = first; i < last; ++i)
+                        {
+                            const T inclusive = has_prefix ? op(running, load(i)) : load(i);
+                            store(i, has_prefix ? running : T(), inclusive);
+                            running = inclusive;
+                            has_prefix = true;
+                        }
+                    }
+                });
+            }
+        }
+
+        template <typename InIt, typename OutIt, typename BinaryOp>
+        void scan_exclusive(InIt first, InIt last, OutIt dest_first, const BinaryOp& op)
+        {
+            typedef typename std::iterator_traits<InIt>::value_type T;
+
+            _details::scan_single_pass<T>(size_t(std::distance(first, last)),
+                [=](const size_t i) -> T { return first[i]; },
+                [=](const size_t i, const T& exclusive, const T&) { dest_first[i] = exclusive; },
+                op);
+        }
+
+        template <typename InIt, typename OutIt, typename BinaryOp>
+        void scan_inclusive(InIt first, InIt last, OutIt dest_first, const BinaryOp& op)
+        {
+            typedef typename std::iterator_traits<InIt>::value_type T;
+
+            _details::scan_single_pass<T>(size_t(std::distance(first, last)),
+                [=](const size_t i) -> T { return first[i]; },
+                [=](const size_t i, const T&, const T& inclusive) { dest_first[i] = inclusive; },
+                op);
+        }
+
+        template <typename InIt, typename FlagIt, typename OutIt, typename BinaryOp>
+        void segmented_scan_exclusive(InIt first, InIt last, FlagIt flags_first, OutIt dest_first, const BinaryOp& op)
+        {
+            typedef typename std::iterator_traits<InIt>::value_type T;
+            typedef amp_algorithms::_details::segmented_value<T> segmented_type;
+
+            _details::scan_single_pass<segmented_type>(size_t(std::distance(first, last)),
+                [=](const size_t i) -> segmented_type { return amp_algorithms::_details::make_segmented_value<T>(first[i], flags_first[i] ? 1u : 0u); },
+                [=](const size_t i, const segmented_type& exclusive, const segmented_type&) { dest_first[i] = flags_first[i] ? T() : exclusive.value; },
+                amp_algorithms::_details::segmented_op<T, BinaryOp>(op));
+        }
+
+        template <typename InIt, typename FlagIt, typename OutIt, typename BinaryOp>
+        void segmented_scan_inclusive(InIt first, InIt last, FlagIt flags_first, OutIt dest_first, const BinaryOp& op)
+        {
+            typedef typename std::iterator_traits<InIt>::value_type T;
+            typedef amp_algorithms::_details::segmented_value<T> segmented_type;
+
+            _details::scan_single_pass<segmented_type>(size_t(std::distance(first, last)),
+                [=](const size_t i) -> segmented_type { return amp_algorithms::_details::make_segmented_value<T>(first[i], flags_first[i] ? 1u : 0u); },
+                [=](const size_t i, const segmented_type&, const segmented_type& inclusive) { dest_first[i] = inclusive.value; },
+                amp_algorithms::_details::segmented_op<T, BinaryOp>(op));
+        }
+    }
+
+    // TODO: Refactor this to remove duplicate code. Also need to decide on final API.
+
+    template <int TileSize, typename InIt, typename OutIt>
+    inline void scan_exclusive_new(InIt first, InIt last, OutIt dest_first)
+    {
+        typedef InIt::value_type T;
+
+        const int size = int(std::distance(first, last));
+        concurrency::array<T, 1> in(size);
+        concurrency::array<T, 1> out(size);
+        concurrency::copy(first, last, in);
+
+        concurrency::array_view<T, 1> in_view(in);
+        concurrency::array_view<T, 1> out_view(out);
+        scan_single_pass<TileSize, amp_algorithms::scan_mode::exclusive>(in.accelerator_view, in_view, out_view, amp_algorithms::plus<T>());
+
+        concurrency::copy(out, dest_first);
+    }
+
+    template <int TileSize, typename InIt, typename OutIt>
+    inline void scan_inclusive_new(InIt first, InIt last, OutIt dest_first)
+    {
+        typedef InIt::value_type T;
+
+        const int size = int(std::distance(first, last));
+        concurrency::array<T, 1> in(size);
+        concurrency::array<T, 1> out(size);
+        concurrency::copy(first, last, in);
+
+        concurrency::array_view<T, 1> in_view(in);
+        concurrency::array_view<T, 1> out_view(out);
+        scan_single_pass<TileSize, amp_algorithms::scan_mode::inclusive>(in.accelerator_view, in_view, out_view, amp_algorithms::plus<T>());
+
+        concurrency::copy(out, dest_first);
+    }
+
+    //----------------------------------------------------------------------------
+    // merge_sort
+    //----------------------------------------------------------------------------
+    //
+    // Stable merge sort for any type and comparison. Each tile first sorts its own elements in tile_static
+    // memory, after that every pass merges pairs of sorted runs. Rather than having a thread walk a run
+    // each element computes its own destination from its rank in the other run of the pair, found with a
+    // binary search. Elements of the left run are placed before equal elements of the right run so the
+    // sort is stable.
+
+    namespace _details
+    {
+        template <typename TContainer, typename T, typename BinaryOperator>
+        inline int merge_position(const TContainer data, const int idx, const T& value, const int width, const int element_count, const BinaryOperator& op) restrict(amp)
+        {
+            const int run_start = (idx / width) * width;
+            const int pair_start = (idx / (2 * width)) * (2 * width);
+            const bool is_left = (run_start == pair_start);
+            const int other_start = is_left ? (run_start + width) : (run_start - width);
+
+            int first = other_start;
+            int last = (other_start + width < element_count) ? (other_start + width) : element_count;
+            if (last < first)
+            {
+                last = first;
+            }
+
+            // Left run uses lower_bound, right run uses upper_bound.
+            while (first < last)
+            {
+                const int mid = first + (last - first) / 2;
+                const bool before = is_left ? op(data[mid], value) : !op(value, data[mid]);
+                if (before)
+                {
+                    first = mid + 1;
+                }
+                else
+                {
+                    last = mid;
+                }
+            }
+            return pair_start + (idx - run_start) + (first - other_start);
+        }
+
+        template <typename T, int tile_size, typename BinaryOperator>
+        void merge_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& input_view, const BinaryOperator& op)
+        {
+            const int element_count = input_view.extent.size();
+            if (element_count <= 1)
+            {
+                return;
+            }
+
+            // Sort each tile in tile_static memory.
+
+            concurrency::tiled_extent<tile_size> compute_domain = input_view.extent.tile<tile_size>().pad();
+            concurrency::parallel_for_each(accl_view, compute_domain, [=](concurrency::tiled_index<tile_size> tidx) restrict(amp)
+            {
+                tile_static T tile_data[tile_size];
+                const int gidx = tidx.global[0];
+                const int lidx = tidx.local[0];
+                const int tile_start = tidx.tile_origin[0];
+                const int tile_count = (element_count - tile_start < tile_size) ? (element_count - tile_start) : tile_size;
+
+                T value = padded_read(input_view, gidx);
+                tile_data[lidx] = value;
+                tidx.barrier.wait_with_tile_static_memory_fence();
+
+                for (int width = 1; width < tile_size; width *= 2)
+                {
+                    const int dest = (lidx < tile_count) ? merge_position(tile_data, lidx, value, width, tile_count, op) : lidx;
+                    tidx.barrier.wait_with_tile_static_memory_fence();
+                    tile_data[dest] = value;
+                    tidx.barrier.wait_with_tile_static_memory_fence();
+                    value = tile_data[lidx];
+                }
+
+                if (gidx < element_count)
+                {
+                    input_view[gidx] = value;
+                }
+            });
+
+            if (element_count <= tile_size)
+            {
+                return;
+            }
+
+            // Merge sorted runs, ping-ponging between the input and a temporary array.
+
+            concurrency::array<T> temp(element_count, accl_view);
+            concurrency::array_view<T> src_view(input_view);
+            concurrency::array_view<T> dest_view(temp);
+            bool is_input = true;
+
+            for (int width = tile_size; width < element_count; width *= 2)
+            {
+                dest_view.discard_data();
+                concurrency::parallel_for_each(accl_view, src_view.extent, [=](concurrency::index<1> idx) restrict(amp)
+                {
+                    const T value = src_view[idx];
+                    dest_view[merge_position(src_view, idx[0], value, width, element_count, op)] = value;
+                });
+                std::swap(src_view, dest_view);
+                is_input = !is_input;
+            }
+
+            if (!is_input)
+            {
+                concurrency::copy(src_view, input_view);
+            }
+        }
+    }
+
+    template <typename T, typename BinaryOperator>
+    void merge_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& input_view, const BinaryOperator& op)
+    {
+        static const int tile_size = 256;
+        ::amp_algorithms::_details::merge_sort<T, tile_size>(accl_view, input_view, op);
+    }
+
+    template <typename T>
+    void merge_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& input_view)
+    {
+        ::amp_algorithms::merge_sort(accl_view, input_view, amp_algorithms::less<T>());
+    }
+
+    template <typename T, typename BinaryOperator>
+    void merge_sort(concurrency::array_view<T>& input_view, const BinaryOperator& op)
+    {
+        ::amp_algorithms::merge_sort(concurrency::accelerator().default_view, input_view, op);
+    }
+
+    template <typename T>
+    void merge_sort(concurrency::array_view<T>& input_view)
+    {
+        ::amp_algorithms::merge_sort(concurrency::accelerator().default_view, input_view, amp_algorithms::less<T>());
+    }
+
+    //----------------------------------------------------------------------------
+    // radix_sort, radix_sort_by_key
+    //----------------------------------------------------------------------------
+    //
+    // LSD radix sort taking key_size bits per pass. Each pass:
+    //
+    // 1. Sorts each tile locally by the current digit using key_size 1-bit splits built on scan_tile,
+    //    counts the digits of the tile and writes the counts to a bin major histogram.
+    // 2. Scans the histogram, giving the global offset of each digit for each tile.
+    // 3. Scatters the locally sorted elements. As elements with the same digit are contiguous within
+    //    a tile the writes are coalesced.
+    //
+    // Keys are transformed into unsigned integers by radix_key_traits so float and signed keys sort
+    // correctly. Values are moved with their keys and the sort is stable.
+    //
+    // The temporary arrays and the DirectX scan need a real device, so the overloads without an
+    // accelerator_view use the default accelerator rather than the auto selection view.
+
+    namespace _details
+    {
+        template <typename T, typename V, int key_size, int tile_size>
+        void radix_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& keys_view, concurrency::array_view<V>& values_view, const bool has_values)
+        {
+            static_assert(radix_key_traits<T>::is_amp_supported, "The key type is not supported by the C++ AMP radix sort.");
+            typedef typename radix_key_traits<T>::key_type key_type;
+
+            static const int type_width = sizeof(key_type) * 8;
+            static_assert((type_width % key_size == 0), "The sort key width must be an exact multiple of the type width.");
+            static_assert((tile_size >= (1 << key_size)), "The tile size must be at least the number of bins.");
+
+            static const int bin_count = 1 << key_size;
+            static const key_type bin_mask = bin_count - 1;
+
+            const int element_count = keys_view.extent.size();
+            if (element_count <= 1)
+            {
+                return;
+            }
+            if (has_values && (values_view.extent.size() < element_count))
+            {
+                throw runtime_exception("The values must have at least as many elements as the keys.", E_INVALIDARG);
+            }
+
+            concurrency::tiled_extent<tile_size> compute_domain = keys_view.extent.tile<tile_size>().pad();
+            const int tile_count = compute_domain[0] / tile_size;
+
+            concurrency::array<key_type> keys_a(element_count, accl_view);
+            concurrency::array<key_type> keys_b(element_count, accl_view);
+            concurrency::array<V> values_a(has_values ? element_count : 1, accl_view);
+            concurrency::array<V> values_b(has_values ? element_count : 1, accl_view);
+            concurrency::array_view<key_type> keys_in(keys_a);
+            concurrency::array_view<key_type> keys_out(keys_b);
+            concurrency::array_view<V> values_in(values_a);
+            concurrency::array_view<V> values_out(values_b);
+
+            // Histogram of digit counts per tile, stored bin major so that a single scan gives the
+            // global offsets. The start of each digit within its locally sorted tile is stored tile major.
+            concurrency::array<unsigned> histogram(bin_count * tile_count, accl_view);
+            concurrency::array<int> local_offsets(bin_count * tile_count, accl_view);
+            amp_algorithms::direct3d::scan s(bin_count * tile_count, accl_view);
+
+            concurrency::parallel_for_each(accl_view, keys_in.extent, [=](concurrency::index<1> idx) restrict(amp)
+            {
+                keys_in[idx] = radix_key_traits<T>::to_key(keys_view[idx]);
+                if (has_values)
+                {
+                    values_in[idx] = values_view[idx];
+                }
+            });
+
+            for (int shift = 0; shift < type_width; shift += key_size)
+            {
+                concurrency::parallel_for_each(accl_view, compute_domain,
+                    [=, &histogram, &local_offsets](concurrency::tiled_index<tile_size> tidx) restrict(amp)
+                {
+                    tile_static key_type tile_keys[tile_size];
+                    tile_static int tile_sources[tile_size];
+                    tile_static unsigned tile_data[tile_size];
+                    tile_static unsigned false_total;
+                    tile_static int bin_start[bin_count];
+                    tile_static int bin_end[bin_count];
+
+                    const int gidx = tidx.global[0];
+                    const int lidx = tidx.local[0];
+                    const int tile = tidx.tile[0];
+                    const int tile_start = tidx.tile_origin[0];
+                    const int tile_elements = (element_count - tile_start < tile_size) ? (element_count - tile_start) : tile_size;
+
+                    // Padding keys have every bit set so they always end up at the end of the tile.
+                    key_type key = (gidx < element_count) ? keys_in[gidx] : ~key_type(0);
+                    int source = lidx;
+
+                    // Stable split on each bit of the digit, elements with the bit cleared move to the front.
+                    for (int b = 0; b < key_size; ++b)
+                    {
+                        const unsigned is_false = static_cast<unsigned>(((key >> (shift + b)) & 1) ^ 1);
+                        tile_data[lidx] = is_false;
+                        tidx.barrier.wait_with_tile_static_memory_fence();
+
+                        const unsigned false_before = _details::scan_tile<tile_size, scan_mode::exclusive>(tile_data, tidx, amp_algorithms::plus<unsigned>());
+                        if (lidx == (tile_size - 1))
+                        {
+                            false_total = false_before + is_false;
+                        }
+                        tidx.barrier.wait_with_tile_static_memory_fence();
+
+                        const int dest = is_false ? int(false_before) : int(false_total + lidx - false_before);
+                        tile_keys[dest] = key;
+                        tile_sources[dest] = source;
+                        tidx.barrier.wait_with_tile_static_memory_fence();
+
+                        key = tile_keys[lidx];
+                        source = tile_sources[lidx];
+                    }
+
+                    // Find where each digit starts and ends within the sorted tile.
+                    const int digit = static_cast<int>((key >> shift) & bin_mask);
+                    if (lidx < bin_count)
+                    {
+                        bin_start[lidx] = 0;
+                        bin_end[lidx] = 0;
+                    }
+                    tidx.barrier.wait_with_tile_static_memory_fence();
+
+                    if (lidx < tile_elements)
+                    {
+                        if ((lidx == 0) || (digit != static_cast<int>((tile_keys[lidx - 1] >> shift) & bin_mask)))
+                        {
+                            bin_start[digit] = lidx;
+                        }
+                        if ((lidx == (tile_elements - 1)) || (digit != static_cast<int>((tile_keys[lidx + 1] >> shift) & bin_mask)))
+                        {
+                            bin_end[digit] = lidx + 1;
+                        }
+                    }
+                    tidx.barrier.wait_with_tile_static_memory_fence();
+
+                    if (lidx < bin_count)
+                    {
+                        histogram[lidx * tile_count + tile] = static_cast<unsigned>(bin_end[lidx] - bin_start[lidx]);
+                        local_offsets[tile * bin_count + lidx] = bin_start[lidx];
+                    }
+
+                    // Write the locally sorted tile back in place. Values are gathered from their source
+                    // position before any thread in the tile overwrites it.
+                    V value = V();
+                    if (has_values && (lidx < tile_elements))
+                    {
+                        value = values_in[tile_start + source];
+                    }
+                    tidx.barrier.wait_with_global_memory_fence();
+
+                    if (gidx < element_count)
+                    {
+                        keys_in[gidx] = key;
+                        if (has_values)
+                        {
+                            values_in[gidx] = value;
+                        }
+                    }
+                });
+
+                s.scan_exclusive(histogram, histogram);
+
+                keys_out.discard_data();
+                concurrency::parallel_for_each(accl_view, compute_domain,
+                    [=, &histogram, &local_offsets](concurrency::tiled_index<tile_size> tidx) restrict(amp)
+                {
+                    const int gidx = tidx.global[0];
+                    if (gidx >= element_count)
+                    {
+                        return;
+                    }
+                    const int lidx = tidx.local[0];
+                    const int tile = tidx.tile[0];
+                    const key_type key = keys_in[gidx];
+                    const int digit = static_cast<int>((key >> shift) & bin_mask);
+                    const int dest = static_cast<int>(histogram[digit * tile_count + tile]) + lidx - local_offsets[tile * bin_count + digit];
+
+                    keys_out[dest] = key;
+                    if (has_values)
+                    {
+                        values_out[dest] = values_in[gidx];
+                    }
+                });
+
+                std::swap(keys_in, keys_out);
+                std::swap(values_in, values_out);
+            }
+
+            keys_view.discard_data();
+            concurrency::parallel_for_each(accl_view, keys_view.extent, [=](concurrency::index<1> idx) restrict(amp)
+            {
+                keys_view[idx] = radix_key_traits<T>::from_key(keys_in[idx]);
+                if (has_values)
+                {
+                    values_view[idx] = values_in[idx];
+                }
+            });
+        }
+
+        template <typename T, int key_size, int tile_size>
+        void radix_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& input_view)
+        {
+            ::amp_algorithms::_details::radix_sort<T, T, key_size, tile_size>(accl_view, input_view, input_view, false);
+        }
+    }
+
+    template <typename T>
+    void radix_sort(const concurrency::accelerator_view& accl_view, concurrency::array_view<T>& input_view)
+    {
+        static const int bin_width = 4;
+        static const int tile_size = 256;
+        ::amp_algorithms::_details::radix_sort<T, bin_width, tile_size>(accl_view, input_view);
+    }
+
+    template <typename T>
+    void radix_sort(concurrency::array_view<T>& input_view)
+    {
+        ::amp_algorithms::radix_sort(concurrency::accelerator().default_view, input_view);
+    }
+
+    // Stable sort of values by their keys, both views are sorted in place.
+    template <typename K, typename V>
+    void radix_sort_by_key(const concurrency::accelerator_view& accl_view, concurrency::array_view<K>& keys_view, concurrency::array_view<V>& values_view)
+    {
+        static const int bin_width = 4;
+        static const int tile_size = 256;
+        ::amp_algorithms::_details::radix_sort<K, V, bin_width, tile_size>(accl_view, keys_view, values_view, true);
+    }
+
+    template <typename K, typename V>
+    void radix_sort_by_key(concurrency::array_view<K>& keys_view, concurrency::array_view<V>& values_view)
+    {
+        ::amp_algorithms::radix_sort_by_key(concurrency::accelerator().default_view, keys_view, values_view);
+    }
+
+    //----------------------------------------------------------------------------
+    // radix_sort, radix_sort_by_key - host implementation
+    //----------------------------------------------------------------------------
+    //
+    // Multicore LSD radix sort for data that lives on the CPU, also supporting 64-bit keys. The input
+    // is split into one chunk per worker, each pass builds per-chunk histograms of an 8-bit digit in
+    // parallel, scans them and then scatters each chunk to its offsets in parallel. Passes where every
+    // key has the same digit are skipped.
+
+    namespace host
+    {
+        namespace _details
+        {
+            template <typename T, typename V>
+            void radix_sort(T* const keys, V* const values, const size_t element_count)
+            {
+                static_assert(amp_algorithms::_details::radix_key_traits<T>::is_supported, "The key type is not supported by the radix sort.");
+                typedef amp_algorithms::_details::radix_key_traits<T> traits;
+                typedef typename traits::key_type key_type;
+
+                static const int digit_width = 8;
+                static const int bin_count = 1 << digit_width;
+                static const int type_width = sizeof(key_type) * 8;
+                static const size_t min_chunk_size = 16384;
+
+                if (element_count <= 1)
+                {
+                    return;
+                }
+
+                const size_t max_chunks = (element_count + min_chunk_size - 1) / min_chunk_size;
+                const size_t chunk_count = std::min<size_t>(concurrency::GetProcessorCount(), max_chunks);
+                const size_t chunk_size = (element_count + chunk_count - 1) / chunk_count;
+
+                std::vector<key_type> keys_a(element_count);
+                std::vector<key_type> keys_b(element_count);
+                std::vector<V> values_b((values != nullptr) ? element_count : 0);
+                std::vector<size_t> offsets(chunk_count * bin_count);
+
+                key_type* keys_in = keys_a.data();
+                key_type* keys_out = keys_b.data();
+                V* values_in = values;
+                V* values_out = values_b.data();
+
+                concurrency::parallel_for(size_t(0), chunk_count, [=](size_t c)
+                {
+                    const size_t end = std::min(element_count, (c + 1) * chunk_size);
+                    for (size_t i = c * chunk_size; i < end; ++i)
+                    {
+                        keys_in[i] = traits::to_key(keys[i]);
+                    }
+                });
+
+                for (int shift = 0; shift < type_width; shift += digit_width)
+                {
+                    // Per-chunk histograms, stored chunk major.
+                    concurrency::parallel_for(size_t(0), chunk_count, [=, &offsets](size_t c)
+                    {
+                        size_t* const counts = &offsets[c * bin_count];
+                        std::fill(counts, counts + bin_count, size_t(0));
+                        const size_t end = std::min(element_count, (c + 1) * chunk_size);
+                        for (size_t i = c * chunk_size; i < end; ++i)
+                        {
+                            ++counts[(keys_in[i] >> shift) & (bin_count - 1)];
+                        }
+                    });
+
+                    // Exclusive scan in bin major order so each chunk writes after all earlier chunks
+                    // with the same digit, which keeps the sort stable.
+                    size_t sum = 0;
+                    bool is_trivial = false;
+                    for (int b = 0; b < bin_count; ++b)
+                    {
+                        size_t bin_total = 0;
+                        for (size_t c = 0; c < chunk_count; ++c)
+                        {
+                            const size_t count = offsets[c * bin_count + b];
+                            offsets[c * bin_count + b] = sum;
+                            sum += count;
+                            bin_total += count;
+                        }
+                        is_trivial = is_trivial || (bin_total == element_count);
+                    }
+                    if (is_trivial)
+                    {
+                        continue;
+                    }
+
+                    concurrency::parallel_for(size_t(0), chunk_count, [=, &offsets](size_t c)
+                    {
+                        size_t* const dest = &offsets[c * bin_count];
+                        const size_t end = std::min(element_count, (c + 1) * chunk_size);
+                        for (size_t i = c * chunk_size; i < end; ++i)
+                        {
+                            const size_t d = dest[(keys_in[i] >> shift) & (bin_count - 1)]++;
+                            keys_out[d] = keys_in[i];
+                            if (values != nullptr)
+                            {
+                                values_out[d] = std::move(values_in[i]);
+                            }
+                        }
+                    });
+
+                    std::swap(keys_in, keys_out);
+                    std::swap(values_in, values_out);
+                }
+
+                concurrency::parallel_for(size_t(0), chunk_count, [=](size_t c)
+                {
+                    const size_t end = std::min(element_count, (c + 1) * chunk_size);
+                    for (size_t i = c * chunk_size; i < end; ++i)
+                    {
+                        keys[i] = traits::from_key(keys_in[i]);
+                        if ((values != nullptr) && (values_in != values))
+                        {
+                            values[i] = std::move(values_in[i]);
+                        }
+                    }
+                });
+            }
+        }
+
+        template <typename T>
+        void radix_sort(T* first, T* last)
+        {
+            _details::radix_sort<T, T>(first, static_cast<T*>(nullptr), size_t(last - first));
+        }
+
+        // Stable sort of values by their keys, both ranges are sorted in place.
+        template <typename K, typename V>
+        void radix_sort_by_key(K* keys_first, K* keys_last, V* values_first)
+        {
+            _details::radix_sort<K, V>(keys_first, values_first, size_t(keys_last - keys_first));
+        }
     }
 
     //----------------------------------------------------------------------------
@@ -294,43 +294,69 @@ namespace amp_stl_algorithms
     // lower_bound, upper_bound
     //----------------------------------------------------------------------------
 
-    // TODO: NOT IMPLEMENTED lower_bound
     template<typename ConstRandomAccessIterator, typename T>
     ConstRandomAccessIterator lower_bound( ConstRandomAccessIterator first, 
         ConstRandomAccessIterator last,
         const T& value ); 
 
-    // NOT IMPLEMENTED 
     template<typename ConstRandomAccessIterator, typename T, typename Compare>
     ConstRandomAccessIterator lower_bound( ConstRandomAccessIterator first, 
         ConstRandomAccessIterator last,
         const T& value, Compare comp ); 
 
-    // TODO: NOT IMPLEMENTED upper_bound
     template<typename ConstRandomAccessIterator, typename T>
     ConstRandomAccessIterator upper_bound( ConstRandomAccessIterator first, 
         ConstRandomAccessIterator last,
         const T& value ); 
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator, typename T, typename Compare>
     ConstRandomAccessIterator upper_bound( ConstRandomAccessIterator first, 
         ConstRandomAccessIterator last,
         const T& value, Compare comp ); 
 
+    // Vectorized versions, search for each of the values in [values_first, values_last) and write the
+    // positions of the bounds relative to first to result.
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator lower_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result );
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator lower_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result,
+        Compare comp );
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator upper_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result );
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator upper_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result,
+        Compare comp );
+
     //----------------------------------------------------------------------------
     // merge, inplace_merge
     //----------------------------------------------------------------------------
 
-    // TODO: NOT IMPLEMENTED merge
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator>
     RandomAccessIterator merge( ConstRandomAccessIterator1 first1, 
-        ConstRandomAccessIterator1 fast1,
+        ConstRandomAccessIterator1 last1,
         ConstRandomAccessIterator2 first2, 
         ConstRandomAccessIterator2 last2, 
         RandomAccessIterator result);
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator, typename BinaryPredicate>
     RandomAccessIterator merge( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -339,13 +365,11 @@ namespace amp_stl_algorithms
         RandomAccessIterator result,
         BinaryPredicate comp);
 
-    // TODO: NOT IMPLEMENTED inplace_merge
     template<typename RandomAccessIterator>
     void inplace_merge( RandomAccessIterator first,
         RandomAccessIterator middle,
         RandomAccessIterator last ); 
 
-    // NOT IMPLEMENTED
     template<typename RandomAccessIterator, typename Compare>
     void inplace_merge( RandomAccessIterator first,
         RandomAccessIterator middle,
@@ -465,13 +489,11 @@ namespace amp_stl_algorithms
     // nth_element
     //----------------------------------------------------------------------------
 
-    // TODO: NOT IMPLEMENTED nth_element
     template<typename RandomAccessIterator>
     void nth_element( RandomAccessIterator first, 
         RandomAccessIterator nth, 
         RandomAccessIterator last ); 
 
-    // NOT IMPLEMENTED 
     template<typename RandomAccessIterator, typename Compare>
     void nth_element( RandomAccessIterator first, 
         RandomAccessIterator nth,
@@ -498,19 +520,15 @@ namespace amp_stl_algorithms
     // partition, stable_partition, partition_point, is_partitioned
     //----------------------------------------------------------------------------
 
-    // TODO: NOT IMPLEMENTED is_partitioned
     template<typename ConstRandomAccessIterator, typename UnaryPredicate>
     bool is_partitioned( ConstRandomAccessIterator first, ConstRandomAccessIterator last, UnaryPredicate p );
 
-    // TODO: NOT IMPLEMENTED partition
     template<typename RandomAccessIterator, typename UnaryPredicate>
     RandomAccessIterator partition( RandomAccessIterator first, RandomAccessIterator last, UnaryPredicate comp);
 
-    // TODO: NOT IMPLEMENTED stable_partition
     template<typename RandomAccessIterator, typename UnaryPredicate>
     RandomAccessIterator stable_partition( RandomAccessIterator first, RandomAccessIterator last, UnaryPredicate p );
 
-    // TODO: NOT IMPLEMENTED partition_point
     template<typename ConstRandomAccessIterator, typename UnaryPredicate>
     ConstRandomAccessIterator partition_point( ConstRandomAccessIterator first, ConstRandomAccessIterator last, UnaryPredicate p);
 
@@ -609,14 +627,12 @@ namespace amp_stl_algorithms
     // search, search_n, binary_search
     //----------------------------------------------------------------------------
 
-    // TODO: NOT IMPLEMENTED search
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2>
     ConstRandomAccessIterator1 search( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1, 
         ConstRandomAccessIterator2 first2,
         ConstRandomAccessIterator2 last2);
 
-    // NOT IMPLEMENTED 
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename Predicate>
     ConstRandomAccessIterator1 search( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -639,11 +655,9 @@ namespace amp_stl_algorithms
         const Type& val, 
         Predicate p);
 
-    // TODO: NOT IMPLEMENTED binary_search
     template<typename ConstRandomAccessIterator, typename T>
     bool binary_search( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value ); 
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator, typename T, typename Compare>
     bool binary_search( ConstRandomAccessIterator first, 
         ConstRandomAccessIterator last,
@@ -654,7 +668,6 @@ namespace amp_stl_algorithms
     // set_difference, set_intersection, set_symetric_distance, set_union
     //----------------------------------------------------------------------------
 
-    // TODO: NOT IMPLEMENTED set_difference
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator>
     RandomAccessIterator set_difference( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -662,7 +675,6 @@ namespace amp_stl_algorithms
         ConstRandomAccessIterator2 last2,
         RandomAccessIterator d_first ); 
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator, typename Compare>
     RandomAccessIterator set_difference( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -671,7 +683,6 @@ namespace amp_stl_algorithms
         RandomAccessIterator d_first, 
         Compare comp ); 
 
-    // TODO: NOT IMPLEMENTED set_intersection
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator>
     RandomAccessIterator set_intersection( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -679,7 +690,6 @@ namespace amp_stl_algorithms
         ConstRandomAccessIterator2 last2,
         RandomAccessIterator d_first ); 
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator, typename Compare>
     RandomAccessIterator set_intersection( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -688,7 +698,6 @@ namespace amp_stl_algorithms
         RandomAccessIterator d_first, 
         Compare comp ); 
 
-    // TODO: NOT IMPLEMENTED set_symmetric_difference
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator>
     RandomAccessIterator set_symmetric_difference( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -696,7 +705,6 @@ namespace amp_stl_algorithms
         ConstRandomAccessIterator2 last2,
         RandomAccessIterator d_first ); 
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator, typename Compare>
     RandomAccessIterator set_symmetric_difference( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -705,7 +713,6 @@ namespace amp_stl_algorithms
         RandomAccessIterator d_first, 
         Compare comp); 
 
-    // TODO: NOT IMPLEMENTED set_union
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator>
     RandomAccessIterator set_union( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -713,7 +720,6 @@ namespace amp_stl_algorithms
         ConstRandomAccessIterator2 last2,
         RandomAccessIterator d_first ); 
 
-    // NOT IMPLEMENTED
     template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2,typename RandomAccessIterator, typename Compare>
     RandomAccessIterator set_union( ConstRandomAccessIterator1 first1, 
         ConstRandomAccessIterator1 last1,
@@ -764,34 +770,28 @@ namespace amp_stl_algorithms
     template<typename ConstRandomAccessIterator, typename Compare>
     ConstRandomAccessIterator is_sorted_until( ConstRandomAccessIterator first, ConstRandomAccessIterator last, Compare comp ); 
 
-    // TODO: NOT IMPLEMENTED sort
     template<typename RandomAccessIterator>
     void sort( RandomAccessIterator first, RandomAccessIterator last );
 
-    // NOT IMPLEMENTED 
     template<typename RandomAccessIterator, typename Compare>
     void sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp ); 
 
-    // TODO: NOT IMPLEMENTED partial_sort
     template<typename RandomAccessIterator>
     void partial_sort( RandomAccessIterator first, 
         RandomAccessIterator middle, 
         RandomAccessIterator last );
 
-    // NOT IMPLEMENTED 
     template<typename RandomAccessIterator, typename Compare>
     void partial_sort( RandomAccessIterator first, 
         RandomAccessIterator middle,
         RandomAccessIterator last, Compare comp );
 
-    // TODO: NOT IMPLEMENTED partial_sort_copy
     template<typename ConstRandomAccessIterator,typename RandomAccessIterator>
     RandomAccessIterator partial_sort_copy( ConstRandomAccessIterator first,
         ConstRandomAccessIterator last,
         RandomAccessIterator d_first, 
         RandomAccessIterator d_last ); 
 
-    // NOT IMPLEMENTED 
     template<typename ConstRandomAccessIterator,typename RandomAccessIterator, typename Compare>
     RandomAccessIterator partial_sort_copy( ConstRandomAccessIterator first, 
         ConstRandomAccessIterator last,
@@ -799,11 +799,9 @@ namespace amp_stl_algorithms
         RandomAccessIterator d_last,
         Compare comp ); 
 
-    // TODO: NOT IMPLEMENTED stable_sort
     template<typename RandomAccessIterator>
     void stable_sort( RandomAccessIterator first, RandomAccessIterator last );
 
-    // NOT IMPLEMENTED 
     template<typename RandomAccessIterator, typename Compare>
     void stable_sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp ); 
 
@@ -158,17 +158,30 @@ namespace amp_algorithms
             }
         }
 
-        // Generic reduction of a 1D indexable view with a reduction binary functor
+        template <typename T>
+        class identity
+        {
+        public:
+            T operator()(const T& value) const restrict(cpu, amp)
+            {
+                return value;
+            }
+        };
+
+        // Generic reduction of a 1D indexable view with a reduction binary functor, applied to the values
+        // returned by the transform functor. Each value is transformed as it is read so the transform and
+        // the reduction share a single pass over the input.
         template<unsigned int tile_size,
             unsigned int max_tiles,
             typename InputIndexableView,
+            typename UnaryFunction,
             typename BinaryFunction>
-            typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
-            reduce(const concurrency::accelerator_view &accl_view, const InputIndexableView &input_view, const BinaryFunction &binary_op)
+            typename std::result_of<UnaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
+            transform_reduce(const concurrency::accelerator_view &accl_view, const InputIndexableView &input_view, const UnaryFunction &transform_op, const BinaryFunction &binary_op)
         {
                 // The input view must be of rank 1
                 static_assert(indexable_view_traits<InputIndexableView>::rank == 1, "The input indexable view must be of rank 1");
-                typedef typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type result_type;
+                typedef typename std::result_of<UnaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&)>::type result_type;
 
                 // runtime sizes
                 int n = input_view.extent.size();
@@ -200,8 +213,11 @@ namespace amp_algorithms
                     // this variable is used to test if we are on the edge of data within tile
                     int partial_data_length = n - tid.tile[0] * tile_size;
 
-                    // initialize local buffer
-                    smem = input_view[concurrency::index<1>(idx)];
+                    // initialize local buffer, threads past the end of the data are excluded by partial_data_length
+                    if (idx < n)
+                    {
+                        smem = transform_op(input_view[concurrency::index<1>(idx)]);
+                    }
                     // next chunk
                     idx += thread_count;
 
@@ -209,7 +225,7 @@ namespace amp_algorithms
                     while (idx < n)
                     {
                         // reduction of smem and X[idx] with results stored in smem
-                        smem = binary_op(smem, input_view[concurrency::index<1>(idx)]);
+                        smem = binary_op(smem, transform_op(input_view[concurrency::index<1>(idx)]));
 
                         // next chunk
                         idx += thread_count;
@@ -239,6 +255,18 @@ namespace amp_algorithms
                 return retVal;
         }
 
+        // Generic reduction of a 1D indexable view with a reduction binary functor
+        template<unsigned int tile_size,
+            unsigned int max_tiles,
+            typename InputIndexableView,
+            typename BinaryFunction>
+            typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type
+            reduce(const concurrency::accelerator_view &accl_view, const InputIndexableView &input_view, const BinaryFunction &binary_op)
+        {
+                typedef typename std::result_of<BinaryFunction(const typename indexable_view_traits<InputIndexableView>::value_type&, const typename indexable_view_traits<InputIndexableView>::value_type&)>::type result_type;
+                return _details::transform_reduce<tile_size, max_tiles>(accl_view, input_view, _details::identity<result_type>(), binary_op);
+        }
+
     } // namespace amp_algorithms::_details
 
     namespace direct3d
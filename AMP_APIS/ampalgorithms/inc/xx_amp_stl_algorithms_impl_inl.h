@@ -21,6 +21,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <numeric>
 
 #include <amp_stl_algorithms.h>
@@ -163,6 +164,31 @@ namespace amp_stl_algorithms
     // copy, copy_if, copy_n
     //----------------------------------------------------------------------------
 
+    namespace _details
+    {
+        // Writes the exclusive scan of the predicate over the input to map, which must have element_count + 1
+        // elements, and returns the number of elements that satisfy it. An element is selected when
+        // map[i] != map[i + 1] and map[i] is then its position in the compacted output.
+        template<typename ConstInputView, typename UnaryPredicate>
+        int scan_predicate(const ConstInputView& input_view, const int element_count, concurrency::array<unsigned int>& map, const UnaryPredicate& p)
+        {
+            concurrency::array_view<unsigned int> map_vw(map);
+            map_vw.discard_data();
+            concurrency::parallel_for_each(concurrency::extent<1>(element_count + 1), [=](concurrency::index<1> idx) restrict(amp)
+            {
+                map_vw[idx] = ((idx[0] < element_count) && p(input_view[idx])) ? 1 : 0;
+            });
+
+            map_vw.synchronize();
+            amp_algorithms::direct3d::scan s(element_count + 1);
+            s.scan_exclusive(map, map);
+
+            unsigned int selected_count;
+            concurrency::copy(map_vw.section(element_count, 1), stdext::make_checked_array_iterator(&selected_count, 1));
+            return int(selected_count);
+        }
+    }
+
     template<typename ConstRandomAccessIterator, typename RandomAccessIterator>
     RandomAccessIterator copy( ConstRandomAccessIterator first,  ConstRandomAccessIterator last, RandomAccessIterator dest_first )
     {
@@ -593,9 +619,337 @@ namespace amp_stl_algorithms
     // lower_bound, upper_bound
     //----------------------------------------------------------------------------
 
+    namespace _details
+    {
+        // Binary search within [first, last) of a sorted view. Returns the first element that is not less than
+        // value (lower bound) or the first element that is greater than value (upper bound).
+        template<bool is_upper, typename ConstInputView, typename T, typename Compare>
+        int binary_search_bound(const ConstInputView data, int first, int last, const T& value, const Compare& comp) restrict(amp)
+        {
+            while (first < last)
+            {
+                const int mid = first + (last - first) / 2;
+                const bool is_before = is_upper ? !comp(value, data[mid]) : comp(data[mid], value);
+                if (is_before)
+                {
+                    first = mid + 1;
+                }
+                else
+                {
+                    last = mid;
+                }
+            }
+            return first;
+        }
+
+        template<bool is_upper, typename ConstRandomAccessIterator, typename T, typename Compare>
+        ConstRandomAccessIterator binary_search_bound(ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value, const Compare& comp)
+        {
+            typedef typename std::iterator_traits<ConstRandomAccessIterator>::difference_type diff_type;
+
+            const diff_type element_count = std::distance(first, last);
+            if (element_count <= 0)
+            {
+                return last;
+            }
+
+            auto section_view = _details::create_section(first, element_count);
+            int result_position = 0;
+            concurrency::array_view<int> result_position_av(1, &result_position);
+
+            concurrency::parallel_for_each(concurrency::extent<1>(1), [=](concurrency::index<1> idx) restrict(amp)
+            {
+                result_position_av[idx] = binary_search_bound<is_upper>(section_view, 0, int(element_count), value, comp);
+            });
+
+            result_position_av.synchronize();
+            return first + result_position;
+        }
+
+        // Searches for every value in [values_first, values_first + value_count). Each tile first loads tile_size
+        // evenly spaced splitters of the sorted range into tile_static memory and searches those, which leaves
+        // a single stride of the range to search in global memory.
+        template<bool is_upper, typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+        RandomAccessIterator binary_search_bound_n(ConstRandomAccessIterator1 first,
+            const typename std::iterator_traits<ConstRandomAccessIterator1>::difference_type element_count,
+            ConstRandomAccessIterator2 values_first,
+            const typename std::iterator_traits<ConstRandomAccessIterator2>::difference_type value_count,
+            RandomAccessIterator result,
+            const Compare& comp)
+        {
+            typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+            typedef typename std::iterator_traits<ConstRandomAccessIterator2>::value_type V;
+            typedef typename std::iterator_traits<RandomAccessIterator>::value_type R;
+            static const int tile_size = 256;
+
+            auto sorted_view = _details::create_section(first, element_count);
+            auto values_view = _details::create_section(values_first, value_count);
+            auto result_view = _details::create_section(result, value_count);
+            result_view.discard_data();
+
+            const int sorted_count = int(element_count);
+            const int stride = (sorted_count + tile_size - 1) / tile_size;
+            const int splitter_count = (sorted_count + stride - 1) / stride;
+
+            concurrency::tiled_extent<tile_size> compute_domain = concurrency::extent<1>(int(value_count)).tile<tile_size>().pad();
+            concurrency::parallel_for_each(compute_domain, [=](concurrency::tiled_index<tile_size> tidx) restrict(amp)
+            {
+                tile_static T splitters[tile_size];
+                const int gidx = tidx.global[0];
+                const int lidx = tidx.local[0];
+
+                if (lidx < splitter_count)
+                {
+                    splitters[lidx] = sorted_view[lidx * stride];
+                }
+                tidx.barrier.wait_with_tile_static_memory_fence();
+
+                if (gidx < value_count)
+                {
+                    const V value = values_view[gidx];
+                    const int s = binary_search_bound<is_upper>(splitters, 0, splitter_count, value, comp);
+                    const int range_first = (s == 0) ? 0 : ((s - 1) * stride + 1);
+                    const int range_last = (s * stride < sorted_count) ? (s * stride) : sorted_count;
+                    result_view[gidx] = R(binary_search_bound<is_upper>(sorted_view, range_first, range_last, value, comp));
+                }
+            });
+
+            return result + value_count;
+        }
+
+        template<bool is_upper, typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+        RandomAccessIterator binary_search_bound(ConstRandomAccessIterator1 first,
+            ConstRandomAccessIterator1 last,
+            ConstRandomAccessIterator2 values_first,
+            ConstRandomAccessIterator2 values_last,
+            RandomAccessIterator result,
+            const Compare& comp)
+        {
+            typedef typename std::iterator_traits<ConstRandomAccessIterator2>::difference_type diff_type;
+
+            const diff_type value_count = std::distance(values_first, values_last);
+            if (value_count <= 0)
+            {
+                return result;
+            }
+            const auto element_count = std::distance(first, last);
+            if (element_count <= 0)
+            {
+                auto result_view = _details::create_section(result, value_count);
+                amp_algorithms::fill(result_view, typename std::iterator_traits<RandomAccessIterator>::value_type());
+                return result + value_count;
+            }
+            return binary_search_bound_n<is_upper>(first, element_count, values_first, value_count, result, comp);
+        }
+    }
+
+    template<typename ConstRandomAccessIterator, typename T, typename Compare>
+    ConstRandomAccessIterator lower_bound( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value, Compare comp )
+    {
+        return _details::binary_search_bound<false>(first, last, value, comp);
+    }
+
+    template<typename ConstRandomAccessIterator, typename T>
+    ConstRandomAccessIterator lower_bound( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::value_type V;
+        return _details::binary_search_bound<false>(first, last, value, amp_algorithms::less<V>());
+    }
+
+    template<typename ConstRandomAccessIterator, typename T, typename Compare>
+    ConstRandomAccessIterator upper_bound( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value, Compare comp )
+    {
+        return _details::binary_search_bound<true>(first, last, value, comp);
+    }
+
+    template<typename ConstRandomAccessIterator, typename T>
+    ConstRandomAccessIterator upper_bound( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::value_type V;
+        return _details::binary_search_bound<true>(first, last, value, amp_algorithms::less<V>());
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator lower_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result,
+        Compare comp )
+    {
+        return _details::binary_search_bound<false>(first, last, values_first, values_last, result, comp);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator lower_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return _details::binary_search_bound<false>(first, last, values_first, values_last, result, amp_algorithms::less<T>());
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator upper_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result,
+        Compare comp )
+    {
+        return _details::binary_search_bound<true>(first, last, values_first, values_last, result, comp);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator upper_bound( ConstRandomAccessIterator1 first,
+        ConstRandomAccessIterator1 last,
+        ConstRandomAccessIterator2 values_first,
+        ConstRandomAccessIterator2 values_last,
+        RandomAccessIterator result )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return _details::binary_search_bound<true>(first, last, values_first, values_last, result, amp_algorithms::less<T>());
+    }
+
     //----------------------------------------------------------------------------
     // merge, inplace_merge
     //----------------------------------------------------------------------------
+    //
+    // Merge path partitioning, see "Merge Path - A Visually Intuitive Approach to Parallel Merging"
+    // http://arxiv.org/pdf/1406.2628.pdf
+    //
+    // The output is divided into equal slices of items_per_thread elements. The start of each slice is found
+    // with a binary search along its diagonal of the merge matrix, so every thread does the same amount of
+    // work however the values of the two ranges are distributed. Ties are taken from the first range, which
+    // keeps the merge stable.
+
+    namespace _details
+    {
+        static const int merge_items_per_thread = 8;
+
+        // Number of elements taken from the first range when the first diagonal elements of the merged output
+        // have been written.
+        template<typename ConstInputView1, typename ConstInputView2, typename Compare>
+        int merge_path_split(const ConstInputView1& input_view1, const int count1, const ConstInputView2& input_view2, const int count2, const int diagonal, const Compare& comp) restrict(amp)
+        {
+            int first = (diagonal > count2) ? (diagonal - count2) : 0;
+            int last = (diagonal < count1) ? diagonal : count1;
+            while (first < last)
+            {
+                const int mid = first + (last - first) / 2;
+                if (!comp(input_view2[diagonal - mid - 1], input_view1[mid]))
+                {
+                    first = mid + 1;
+                }
+                else
+                {
+                    last = mid;
+                }
+            }
+            return first;
+        }
+
+        template<typename ConstInputView1, typename ConstInputView2, typename OutputView, typename Compare>
+        void merge(const ConstInputView1& input_view1, const int count1, const ConstInputView2& input_view2, const int count2, OutputView& output_view, const Compare& comp)
+        {
+            static const int items_per_thread = merge_items_per_thread;
+            const int element_count = count1 + count2;
+            const int thread_count = (element_count + items_per_thread - 1) / items_per_thread;
+
+            output_view.discard_data();
+            concurrency::parallel_for_each(concurrency::extent<1>(thread_count), [=](concurrency::index<1> idx) restrict(amp)
+            {
+                const int diagonal = idx[0] * items_per_thread;
+                const int end = (diagonal + items_per_thread < element_count) ? (diagonal + items_per_thread) : element_count;
+                int i = merge_path_split(input_view1, count1, input_view2, count2, diagonal, comp);
+                int j = diagonal - i;
+
+                for (int k = diagonal; k < end; ++k)
+                {
+                    if ((j >= count2) || ((i < count1) && !comp(input_view2[j], input_view1[i])))
+                    {
+                        output_view[k] = input_view1[i++];
+                    }
+                    else
+                    {
+                        output_view[k] = input_view2[j++];
+                    }
+                }
+            });
+        }
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator merge( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator dest_first,
+        Compare comp )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::difference_type diff_type;
+
+        const diff_type count1 = std::distance(first1, last1);
+        const diff_type count2 = std::distance(first2, last2);
+        if (count1 <= 0)
+        {
+            return amp_stl_algorithms::copy(first2, last2, dest_first);
+        }
+        if (count2 <= 0)
+        {
+            return amp_stl_algorithms::copy(first1, last1, dest_first);
+        }
+
+        auto input_view1 = _details::create_section(first1, count1);
+        auto input_view2 = _details::create_section(first2, count2);
+        auto output_view = _details::create_section(dest_first, count1 + count2);
+        _details::merge(input_view1, int(count1), input_view2, int(count2), output_view, comp);
+        return dest_first + (count1 + count2);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator merge( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator dest_first )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return amp_stl_algorithms::merge(first1, last1, first2, last2, dest_first, amp_algorithms::less<T>());
+    }
+
+    template<typename RandomAccessIterator, typename Compare>
+    void inplace_merge( RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::difference_type diff_type;
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+
+        const diff_type count1 = std::distance(first, middle);
+        const diff_type count2 = std::distance(middle, last);
+        if ((count1 <= 0) || (count2 <= 0))
+        {
+            return;
+        }
+
+        // Merge into a temporary array and copy back, each thread of the merge reads from both halves.
+        auto input_view1 = _details::create_section(first, count1);
+        auto input_view2 = _details::create_section(middle, count2);
+        concurrency::array<T> temp(int(count1 + count2));
+        concurrency::array_view<T> temp_view(temp);
+        _details::merge(input_view1, int(count1), input_view2, int(count2), temp_view, comp);
+
+        auto output_view = _details::create_section(first, count1 + count2);
+        concurrency::copy(temp_view, output_view);
+    }
+
+    template<typename RandomAccessIterator>
+    void inplace_merge( RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+        amp_stl_algorithms::inplace_merge(first, middle, last, amp_algorithms::less<T>());
+    }
 
     //----------------------------------------------------------------------------
     // min, max,minmax, max_element, min_element, minmax_element
@@ -612,6 +966,164 @@ namespace amp_stl_algorithms
     //----------------------------------------------------------------------------
     // nth_element
     //----------------------------------------------------------------------------
+    //
+    // Sample select. Each round sorts a small sample of splitters, histograms the candidates into the buckets
+    // between and equal to the splitters and keeps only the bucket that holds the requested rank. Rounds stop
+    // when the rank falls on a splitter or when few enough candidates remain to sort them. The range is then
+    // partitioned three ways around the selected value, so the whole range is only ever scanned and never
+    // sorted.
+
+    namespace _details
+    {
+        static const int select_sort_threshold = 16384;
+
+        // Even buckets hold the values between two splitters, odd buckets the values equal to a splitter.
+        template<typename ConstInputView, typename T, typename Compare>
+        int select_bucket(const ConstInputView splitters, const int splitter_count, const T& value, const Compare& comp) restrict(amp)
+        {
+            const int i = binary_search_bound<false>(splitters, 0, splitter_count, value, comp);
+            return ((i < splitter_count) && !comp(value, splitters[i])) ? (2 * i + 1) : (2 * i);
+        }
+
+        // Returns the value at position rank of the sorted candidates. The candidates must be larger
+        // than select_sort_threshold and are not modified.
+        template<typename T, typename Compare>
+        T select(concurrency::array_view<T> candidates_view, int candidate_count, int rank, const Compare& comp)
+        {
+            static const int tile_size = 256;
+            static const int splitter_count = 255;
+            static const int bucket_count = 2 * splitter_count + 1;
+
+            std::unique_ptr<concurrency::array<T>> candidates;
+            while (candidate_count > select_sort_threshold)
+            {
+                // Sample evenly spaced splitters and sort them.
+                const int stride = candidate_count / splitter_count;
+                concurrency::array<T> splitters(splitter_count);
+                concurrency::array_view<T> splitters_view(splitters);
+                concurrency::parallel_for_each(splitters_view.extent, [=](concurrency::index<1> idx) restrict(amp)
+                {
+                    splitters_view[idx] = candidates_view[idx[0] * stride + stride / 2];
+                });
+                amp_algorithms::merge_sort(splitters_view, comp);
+
+                // Histogram the candidates, each tile counts in tile_static memory first.
+                std::vector<unsigned int> counts(bucket_count, 0);
+                concurrency::array_view<unsigned int> counts_av(bucket_count, counts);
+                concurrency::tiled_extent<tile_size> compute_domain = concurrency::extent<1>(candidate_count).tile<tile_size>().pad();
+                concurrency::parallel_for_each(compute_domain, [=](concurrency::tiled_index<tile_size> tidx) restrict(amp)
+                {
+                    tile_static T tile_splitters[splitter_count];
+                    tile_static unsigned int tile_counts[bucket_count];
+                    const int gidx = tidx.global[0];
+                    const int lidx = tidx.local[0];
+
+                    for (int i = lidx; i < bucket_count; i += tile_size)
+                    {
+                        tile_counts[i] = 0;
+                    }
+                    for (int i = lidx; i < splitter_count; i += tile_size)
+                    {
+                        tile_splitters[i] = splitters_view[i];
+                    }
+                    tidx.barrier.wait_with_tile_static_memory_fence();
+
+                    if (gidx < candidate_count)
+                    {
+                        concurrency::atomic_fetch_inc(&tile_counts[select_bucket(tile_splitters, splitter_count, candidates_view[gidx], comp)]);
+                    }
+                    tidx.barrier.wait_with_tile_static_memory_fence();
+
+                    for (int i = lidx; i < bucket_count; i += tile_size)
+                    {
+                        if (tile_counts[i] > 0)
+                        {
+                            concurrency::atomic_fetch_add(&counts_av[i], tile_counts[i]);
+                        }
+                    }
+                });
+                counts_av.synchronize();
+
+                int bucket = 0;
+                while (rank >= int(counts[bucket]))
+                {
+                    rank -= int(counts[bucket]);
+                    ++bucket;
+                }
+
+                if ((bucket % 2) == 1)
+                {
+                    T value;
+                    concurrency::copy(splitters_view.section((bucket - 1) / 2, 1), stdext::make_checked_array_iterator(&value, 1));
+                    return value;
+                }
+
+                // Compact the selected bucket into the next set of candidates. The bucket excludes at least the
+                // splitters so every round makes progress.
+                const int next_count = int(counts[bucket]);
+                concurrency::array<unsigned int> map(candidate_count + 1);
+                _details::scan_predicate(candidates_view, candidate_count, map, [=](const T& v) restrict(amp)
+                {
+                    return (select_bucket(splitters_view, splitter_count, v, comp) == bucket);
+                });
+
+                std::unique_ptr<concurrency::array<T>> next_candidates(new concurrency::array<T>(next_count));
+                concurrency::array_view<T> next_view(*next_candidates);
+                concurrency::array_view<unsigned int> map_vw(map);
+                next_view.discard_data();
+                concurrency::parallel_for_each(concurrency::extent<1>(candidate_count), [=](concurrency::index<1> idx) restrict(amp)
+                {
+                    const int i = idx[0];
+                    if (map_vw[i] != map_vw[i + 1])
+                    {
+                        next_view[map_vw[i]] = candidates_view[idx];
+                    }
+                });
+
+                candidates = std::move(next_candidates);
+                candidates_view = next_view;
+                candidate_count = next_count;
+            }
+
+            // At least one round ran, so the candidates are a private copy that can be sorted.
+            amp_algorithms::merge_sort(candidates_view, comp);
+            T value;
+            concurrency::copy(candidates_view.section(rank, 1), stdext::make_checked_array_iterator(&value, 1));
+            return value;
+        }
+    }
+
+    template<typename RandomAccessIterator, typename Compare>
+    void nth_element( RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last, Compare comp )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::difference_type diff_type;
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+
+        const diff_type element_count = std::distance(first, last);
+        const diff_type rank = std::distance(first, nth);
+        if ((element_count <= 1) || (rank < 0) || (rank >= element_count))
+        {
+            return;
+        }
+        if (element_count <= _details::select_sort_threshold)
+        {
+            amp_stl_algorithms::stable_sort(first, last, comp);
+            return;
+        }
+
+        auto section_view = _details::create_section(first, element_count);
+        const T value = _details::select(section_view, int(element_count), int(rank), comp);
+
+        auto middle = amp_stl_algorithms::stable_partition(first, last, [=](const T& v) restrict(amp) { return comp(v, value); });
+        amp_stl_algorithms::stable_partition(middle, last, [=](const T& v) restrict(amp) { return !comp(value, v); });
+    }
+
+    template<typename RandomAccessIterator>
+    void nth_element( RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+        amp_stl_algorithms::nth_element(first, nth, last, amp_algorithms::less<T>());
+    }
 
     //----------------------------------------------------------------------------
     // partial sum
@@ -621,6 +1133,95 @@ namespace amp_stl_algorithms
     // partition, stable_partition, partition_point, is_partitioned
     //----------------------------------------------------------------------------
 
+    template<typename ConstRandomAccessIterator, typename UnaryPredicate>
+    bool is_partitioned( ConstRandomAccessIterator first, ConstRandomAccessIterator last, UnaryPredicate p )
+    {
+        auto first_false = amp_stl_algorithms::find_if_not(first, last, p);
+        return (amp_stl_algorithms::find_if(first_false, last, p) == last);
+    }
+
+    // Stream compaction: a scan of the predicate gives each selected element its position, the others
+    // follow in their original order.
+    template<typename RandomAccessIterator, typename UnaryPredicate>
+    RandomAccessIterator stable_partition( RandomAccessIterator first, RandomAccessIterator last, UnaryPredicate p )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::difference_type diff_type;
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+
+        const diff_type element_count = std::distance(first, last);
+        if (element_count <= 0)
+        {
+            return first;
+        }
+
+        auto section_view = _details::create_section(first, element_count);
+        concurrency::array<unsigned int> map(int(element_count) + 1);
+        const int true_count = _details::scan_predicate(section_view, int(element_count), map, p);
+        if ((true_count == 0) || (true_count == element_count))
+        {
+            return first + true_count;
+        }
+
+        concurrency::array<T> temp(static_cast<int>(element_count));
+        concurrency::array_view<T> temp_view(temp);
+        concurrency::array_view<unsigned int> map_vw(map);
+        temp_view.discard_data();
+        concurrency::parallel_for_each(concurrency::extent<1>(int(element_count)), [=](concurrency::index<1> idx) restrict(amp)
+        {
+            const int i = idx[0];
+            const int position = int(map_vw[i]);
+            const int dest = (map_vw[i] != map_vw[i + 1]) ? position : (true_count + i - position);
+            temp_view[dest] = section_view[idx];
+        });
+
+        concurrency::copy(temp_view, section_view);
+        return first + true_count;
+    }
+
+    template<typename RandomAccessIterator, typename UnaryPredicate>
+    RandomAccessIterator partition( RandomAccessIterator first, RandomAccessIterator last, UnaryPredicate p )
+    {
+        return amp_stl_algorithms::stable_partition(first, last, p);
+    }
+
+    template<typename ConstRandomAccessIterator, typename UnaryPredicate>
+    ConstRandomAccessIterator partition_point( ConstRandomAccessIterator first, ConstRandomAccessIterator last, UnaryPredicate p )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::difference_type diff_type;
+
+        const diff_type element_count = std::distance(first, last);
+        if (element_count <= 0)
+        {
+            return last;
+        }
+
+        auto section_view = _details::create_section(first, element_count);
+        int result_position = 0;
+        concurrency::array_view<int> result_position_av(1, &result_position);
+
+        concurrency::parallel_for_each(concurrency::extent<1>(1), [=](concurrency::index<1> idx) restrict(amp)
+        {
+            int lo = 0;
+            int hi = int(element_count);
+            while (lo < hi)
+            {
+                const int mid = lo + (hi - lo) / 2;
+                if (p(section_view[mid]))
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            result_position_av[idx] = lo;
+        });
+
+        result_position_av.synchronize();
+        return first + result_position;
+    }
+
     //----------------------------------------------------------------------------
     // reduce
     //----------------------------------------------------------------------------
@@ -863,9 +1464,323 @@ namespace amp_stl_algorithms
     // search, search_n, binary_search
     //----------------------------------------------------------------------------
 
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename Predicate>
+    ConstRandomAccessIterator1 search( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        Predicate p )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::difference_type diff_type;
+
+        const diff_type element_count = std::distance(first1, last1);
+        const diff_type pattern_count = std::distance(first2, last2);
+        if (pattern_count <= 0)
+        {
+            return first1;
+        }
+        if (pattern_count > element_count)
+        {
+            return last1;
+        }
+
+        // Every candidate position compares the whole pattern, the first match wins.
+        auto section_view = _details::create_section(first1, element_count);
+        auto pattern_view = _details::create_section(first2, pattern_count);
+        const int candidate_count = int(element_count - pattern_count + 1);
+        int result_position = int(element_count);
+        concurrency::array_view<int> result_position_av(1, &result_position);
+
+        concurrency::parallel_for_each(concurrency::extent<1>(candidate_count), [=](concurrency::index<1> idx) restrict(amp)
+        {
+            const int i = idx[0];
+            for (int j = 0; j < pattern_count; ++j)
+            {
+                if (!p(section_view[i + j], pattern_view[j]))
+                {
+                    return;
+                }
+            }
+            concurrency::atomic_fetch_min(&result_position_av(0), i);
+        });
+
+        result_position_av.synchronize();
+        return first1 + result_position;
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2>
+    ConstRandomAccessIterator1 search( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2 )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return amp_stl_algorithms::search(first1, last1, first2, last2, amp_algorithms::equal_to<T>());
+    }
+
+    template<typename ConstRandomAccessIterator, typename T, typename Compare>
+    bool binary_search( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value, Compare comp )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::difference_type diff_type;
+
+        const diff_type element_count = std::distance(first, last);
+        if (element_count <= 0)
+        {
+            return false;
+        }
+
+        auto section_view = _details::create_section(first, element_count);
+        int found = 0;
+        concurrency::array_view<int> found_av(1, &found);
+
+        concurrency::parallel_for_each(concurrency::extent<1>(1), [=](concurrency::index<1> idx) restrict(amp)
+        {
+            const int i = _details::binary_search_bound<false>(section_view, 0, int(element_count), value, comp);
+            found_av[idx] = ((i < element_count) && !comp(value, section_view[i])) ? 1 : 0;
+        });
+
+        found_av.synchronize();
+        return (found != 0);
+    }
+
+    template<typename ConstRandomAccessIterator, typename T>
+    bool binary_search( ConstRandomAccessIterator first, ConstRandomAccessIterator last, const T& value )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::value_type V;
+        return amp_stl_algorithms::binary_search(first, last, value, amp_algorithms::less<V>());
+    }
+
     //----------------------------------------------------------------------------
     // set_difference, set_intersection, set_symetric_distance, set_union
     //----------------------------------------------------------------------------
+    //
+    // All of the set operations walk the merge of the two ranges using the same merge path partitioning as merge.
+    // Equal elements are handled as in the STL: if a value occurs m times in the first range and n times in the
+    // second, the k-th copy from the first range is kept by intersection when k < n and by difference and
+    // symmetric difference when k >= n. Union keeps every copy from the first range, and union and symmetric
+    // difference keep the k-th copy from the second range when k >= m. The walk writes a keep flag and the
+    // source of every merged element, an exclusive scan of the flags gives the output positions and a final
+    // pass scatters the kept elements.
+
+    namespace _details
+    {
+        enum class set_operation : int
+        {
+            union_of = 0,
+            intersection = 1,
+            difference = 2,
+            symmetric_difference = 3
+        };
+
+        template<set_operation op, typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+        RandomAccessIterator set_algorithm_n(ConstRandomAccessIterator1 first1,
+            const int count1,
+            ConstRandomAccessIterator2 first2,
+            const int count2,
+            RandomAccessIterator dest_first,
+            const Compare& comp)
+        {
+            static const int items_per_thread = merge_items_per_thread;
+            const int element_count = count1 + count2;
+            const int thread_count = (element_count + items_per_thread - 1) / items_per_thread;
+
+            auto input_view1 = _details::create_section(first1, count1);
+            auto input_view2 = _details::create_section(first2, count2);
+
+            concurrency::array<unsigned int> map(element_count + 1);
+            concurrency::array_view<unsigned int> map_vw(map);
+            concurrency::array<int> sources(element_count);
+            concurrency::array_view<int> sources_vw(sources);
+
+            map_vw.discard_data();
+            sources_vw.discard_data();
+            concurrency::parallel_for_each(concurrency::extent<1>(thread_count), [=](concurrency::index<1> idx) restrict(amp)
+            {
+                const int diagonal = idx[0] * items_per_thread;
+                const int end = (diagonal + items_per_thread < element_count) ? (diagonal + items_per_thread) : element_count;
+                int i = merge_path_split(input_view1, count1, input_view2, count2, diagonal, comp);
+                int j = diagonal - i;
+
+                for (int k = diagonal; k < end; ++k)
+                {
+                    // Taking input_view1[i] means input_view2[j] is the first element not less than it and taking
+                    // input_view2[j] means input_view1[i] is the first element greater than it, so only the run
+                    // starts need searching.
+                    bool keep = false;
+                    if ((j >= count2) || ((i < count1) && !comp(input_view2[j], input_view1[i])))
+                    {
+                        if (op == set_operation::union_of)
+                        {
+                            keep = true;
+                        }
+                        else
+                        {
+                            const int rank = i - binary_search_bound<false>(input_view1, 0, i, input_view1[i], comp);
+                            const int other_count = binary_search_bound<true>(input_view2, j, count2, input_view1[i], comp) - j;
+                            keep = (op == set_operation::intersection) ? (rank < other_count) : (rank >= other_count);
+                        }
+                        sources_vw[k] = i++;
+                    }
+                    else
+                    {
+                        if ((op == set_operation::union_of) || (op == set_operation::symmetric_difference))
+                        {
+                            const int rank = j - binary_search_bound<false>(input_view2, 0, j, input_view2[j], comp);
+                            const int other_count = i - binary_search_bound<false>(input_view1, 0, i, input_view2[j], comp);
+                            keep = (rank >= other_count);
+                        }
+                        sources_vw[k] = ~(j++);
+                    }
+                    map_vw[k] = keep ? 1 : 0;
+                }
+                if (diagonal == 0)
+                {
+                    map_vw[element_count] = 0;
+                }
+            });
+
+            map_vw.synchronize();
+            amp_algorithms::direct3d::scan s(element_count + 1);
+            s.scan_exclusive(map, map);
+
+            int kept_count;
+            concurrency::copy(map_vw.section(element_count, 1), stdext::make_checked_array_iterator(&kept_count, 1));
+            if (kept_count <= 0)
+            {
+                return dest_first;
+            }
+
+            auto dest_view = _details::create_section(dest_first, kept_count);
+            dest_view.discard_data();
+            concurrency::parallel_for_each(concurrency::extent<1>(element_count), [=](concurrency::index<1> idx) restrict(amp)
+            {
+                const int k = idx[0];
+                const unsigned int position = map_vw[k];
+                if (position != map_vw[k + 1])
+                {
+                    const int source = sources_vw[k];
+                    dest_view[position] = (source >= 0) ? input_view1[source] : input_view2[~source];
+                }
+            });
+
+            return dest_first + kept_count;
+        }
+
+        template<set_operation op, typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+        RandomAccessIterator set_algorithm(ConstRandomAccessIterator1 first1,
+            ConstRandomAccessIterator1 last1,
+            ConstRandomAccessIterator2 first2,
+            ConstRandomAccessIterator2 last2,
+            RandomAccessIterator dest_first,
+            const Compare& comp)
+        {
+            const int count1 = int(std::distance(first1, last1));
+            const int count2 = int(std::distance(first2, last2));
+
+            if ((count1 <= 0) && (count2 <= 0))
+            {
+                return dest_first;
+            }
+            if (count1 <= 0)
+            {
+                return ((op == set_operation::union_of) || (op == set_operation::symmetric_difference)) ?
+                    amp_stl_algorithms::copy(first2, last2, dest_first) : dest_first;
+            }
+            if (count2 <= 0)
+            {
+                return (op != set_operation::intersection) ? amp_stl_algorithms::copy(first1, last1, dest_first) : dest_first;
+            }
+            return set_algorithm_n<op>(first1, count1, first2, count2, dest_first, comp);
+        }
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator set_difference( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first,
+        Compare comp )
+    {
+        return _details::set_algorithm<_details::set_operation::difference>(first1, last1, first2, last2, d_first, comp);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator set_difference( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return amp_stl_algorithms::set_difference(first1, last1, first2, last2, d_first, amp_algorithms::less<T>());
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator set_intersection( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first,
+        Compare comp )
+    {
+        return _details::set_algorithm<_details::set_operation::intersection>(first1, last1, first2, last2, d_first, comp);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator set_intersection( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return amp_stl_algorithms::set_intersection(first1, last1, first2, last2, d_first, amp_algorithms::less<T>());
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator set_symmetric_difference( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first,
+        Compare comp )
+    {
+        return _details::set_algorithm<_details::set_operation::symmetric_difference>(first1, last1, first2, last2, d_first, comp);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator set_symmetric_difference( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return amp_stl_algorithms::set_symmetric_difference(first1, last1, first2, last2, d_first, amp_algorithms::less<T>());
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator set_union( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first,
+        Compare comp )
+    {
+        return _details::set_algorithm<_details::set_operation::union_of>(first1, last1, first2, last2, d_first, comp);
+    }
+
+    template<typename ConstRandomAccessIterator1, typename ConstRandomAccessIterator2, typename RandomAccessIterator>
+    RandomAccessIterator set_union( ConstRandomAccessIterator1 first1,
+        ConstRandomAccessIterator1 last1,
+        ConstRandomAccessIterator2 first2,
+        ConstRandomAccessIterator2 last2,
+        RandomAccessIterator d_first )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator1>::value_type T;
+        return amp_stl_algorithms::set_union(first1, last1, first2, last2, d_first, amp_algorithms::less<T>());
+    }
 
     //----------------------------------------------------------------------------
     // shuffle, random_shuffle, 
@@ -910,6 +1825,134 @@ namespace amp_stl_algorithms
         return amp_stl_algorithms::is_sorted_until(first, last, amp_algorithms::less_equal<T>());
     }
 
+    namespace _details
+    {
+        // Keys the radix sort understands are sorted with it, everything else falls back to merge sort.
+
+        template<typename T>
+        void sort(concurrency::array_view<T>& input_view, std::true_type)
+        {
+            amp_algorithms::radix_sort(input_view);
+        }
+
+        template<typename T>
+        void sort(concurrency::array_view<T>& input_view, std::false_type)
+        {
+            amp_algorithms::merge_sort(input_view, amp_algorithms::less<T>());
+        }
+    }
+
+    template<typename RandomAccessIterator>
+    void sort( RandomAccessIterator first, RandomAccessIterator last )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::difference_type diff_type;
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+
+        const diff_type element_count = std::distance(first, last);
+        if (element_count <= 1)
+        {
+            return;
+        }
+        auto input_view = _details::create_section(first, element_count);
+        _details::sort(input_view, std::integral_constant<bool, amp_algorithms::_details::radix_key_traits<T>::is_amp_supported>());
+    }
+
+    template<typename RandomAccessIterator, typename Compare>
+    void sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp )
+    {
+        amp_stl_algorithms::stable_sort(first, last, comp);
+    }
+
+    template<typename RandomAccessIterator>
+    void stable_sort( RandomAccessIterator first, RandomAccessIterator last )
+    {
+        // The radix sort is stable.
+        amp_stl_algorithms::sort(first, last);
+    }
+
+    template<typename RandomAccessIterator, typename Compare>
+    void stable_sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp )
+    {
+        typedef typename std::iterator_traits<RandomAccessIterator>::difference_type diff_type;
+
+        const diff_type element_count = std::distance(first, last);
+        if (element_count <= 1)
+        {
+            return;
+        }
+        auto input_view = _details::create_section(first, element_count);
+        amp_algorithms::merge_sort(input_view, comp);
+    }
+
+    // partial_sort selects the smallest elements with nth_element and only sorts those.
+
+    template<typename RandomAccessIterator, typename Compare>
+    void partial_sort( RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp )
+    {
+        const auto sorted_count = std::distance(first, middle);
+        if (sorted_count <= 0)
+        {
+            return;
+        }
+        if (middle != last)
+        {
+            amp_stl_algorithms::nth_element(first, middle - 1, last, comp);
+        }
+        amp_stl_algorithms::stable_sort(first, middle, comp);
+    }
+
+    template<typename RandomAccessIterator>
+    void partial_sort( RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last )
+    {
+        const auto sorted_count = std::distance(first, middle);
+        if (sorted_count <= 0)
+        {
+            return;
+        }
+        if (middle != last)
+        {
+            amp_stl_algorithms::nth_element(first, middle - 1, last);
+        }
+        amp_stl_algorithms::sort(first, middle);
+    }
+
+    template<typename ConstRandomAccessIterator, typename RandomAccessIterator, typename Compare>
+    RandomAccessIterator partial_sort_copy( ConstRandomAccessIterator first,
+        ConstRandomAccessIterator last,
+        RandomAccessIterator d_first,
+        RandomAccessIterator d_last,
+        Compare comp )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::value_type T;
+
+        const int element_count = int(std::distance(first, last));
+        const int dest_count = int(std::distance(d_first, d_last));
+        const int sorted_count = (element_count < dest_count) ? element_count : dest_count;
+        if (sorted_count <= 0)
+        {
+            return d_first;
+        }
+
+        concurrency::array<T> temp(element_count);
+        concurrency::array_view<T> temp_view(temp);
+        concurrency::copy(_details::create_section(first, element_count), temp_view);
+        amp_stl_algorithms::partial_sort(begin(temp_view), begin(temp_view) + sorted_count, end(temp_view), comp);
+
+        auto dest_view = _details::create_section(d_first, sorted_count);
+        concurrency::copy(temp_view.section(0, sorted_count), dest_view);
+        return d_first + sorted_count;
+    }
+
+    template<typename ConstRandomAccessIterator, typename RandomAccessIterator>
+    RandomAccessIterator partial_sort_copy( ConstRandomAccessIterator first,
+        ConstRandomAccessIterator last,
+        RandomAccessIterator d_first,
+        RandomAccessIterator d_last )
+    {
+        typedef typename std::iterator_traits<ConstRandomAccessIterator>::value_type T;
+        return amp_stl_algorithms::partial_sort_copy(first, last, d_first, d_last, amp_algorithms::less<T>());
+    }
+
     //----------------------------------------------------------------------------
     // swap, swap<T, N>, swap_ranges, iter_swap
     //----------------------------------------------------------------------------
@@ -225,6 +225,41 @@ namespace amp_algorithms_tests
             Assert::AreEqual(cpu_result, amp_result);
         }
 
+        TEST_METHOD(amp_transform_reduce_statistics)
+        {
+            const int element_count = 1023 * 1029;
+            std::vector<int> input(element_count);
+            generate_data(input);
+            std::transform(begin(input), end(input), begin(input), [](int v) { return v % 10; });
+            array_view<const int> input_av(element_count, input);
+
+            auto stats = amp_algorithms::transform_reduce(input_av,
+                [=](const int& v) restrict(cpu, amp) { return make_reduction_tuple(v, v * v, v, v); },
+                make_tuple_reduction(amp_algorithms::plus<int>(), amp_algorithms::plus<int>(), amp_algorithms::min<int>(), amp_algorithms::max<int>()));
+
+            Assert::AreEqual(std::accumulate(begin(input), end(input), 0), stats[0]);
+            Assert::AreEqual(std::inner_product(begin(input), end(input), begin(input), 0), stats[1]);
+            Assert::AreEqual(*std::min_element(begin(input), end(input)), stats[2]);
+            Assert::AreEqual(*std::max_element(begin(input), end(input)), stats[3]);
+        }
+
+        TEST_METHOD(host_transform_reduce_statistics)
+        {
+            const int element_count = 1023 * 1029 + 5;
+            std::vector<int> input(element_count);
+            generate_data(input);
+            std::transform(begin(input), end(input), begin(input), [](int v) { return v % 10; });
+
+            auto stats = amp_algorithms::host::transform_reduce(begin(input), end(input),
+                [](const int& v) { return make_reduction_tuple(v, v * v, v, v); },
+                make_tuple_reduction(amp_algorithms::plus<int>(), amp_algorithms::plus<int>(), amp_algorithms::min<int>(), amp_algorithms::max<int>()));
+
+            Assert::AreEqual(std::accumulate(begin(input), end(input), 0), stats[0]);
+            Assert::AreEqual(std::inner_product(begin(input), end(input), begin(input), 0), stats[1]);
+            Assert::AreEqual(*std::min_element(begin(input), end(input)), stats[2]);
+            Assert::AreEqual(*std::max_element(begin(input), end(input)), stats[3]);
+        }
+
     private:
         template <typename value_type, typename BinaryFunctor>
         void test_reduce(int element_count, BinaryFunctor func, value_type& cpu_result, value_type& amp_result)
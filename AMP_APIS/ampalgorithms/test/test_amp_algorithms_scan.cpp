@@ -251,5 +251,94 @@ namespace amp_algorithms_tests
 
             Assert::IsTrue(expected == result, Msg(expected, result).c_str());
         }
+
+        TEST_METHOD(amp_scan_single_pass_in_place)
+        {
+            const int tile_size = warp_size * 4;
+            std::vector<int> input(tile_size * (tile_size + 10) + 7);
+            generate_data(input);
+            std::vector<int> expected(input.size());
+            scan_sequential_exclusive(begin(input), end(input), begin(expected));
+            array_view<int> input_av(int(input.size()), input);
+
+            scan_single_pass<tile_size, scan_mode::exclusive>(input_av, input_av, amp_algorithms::plus<int>());
+
+            input_av.synchronize();
+            Assert::IsTrue(expected == input, Msg(expected, input).c_str());
+        }
+
+        TEST_METHOD(amp_segmented_scan_single_pass_exclusive)
+        {
+            const int tile_size = warp_size * 4;
+            std::vector<int> input(tile_size * 20 + 5, 1);
+            std::vector<unsigned int> flags(input.size(), 0);
+            std::vector<int> result(input.size(), -1);
+            std::vector<int> expected(input.size());
+            // Segments of 100 elements straddle the tile boundaries.
+            for (int i = 0; i < int(input.size()); ++i)
+            {
+                flags[i] = ((i % 100) == 0) ? 1 : 0;
+                expected[i] = i % 100;
+            }
+            array_view<const int> input_av(int(input.size()), input);
+            array_view<const unsigned int> flags_av(int(flags.size()), flags);
+            array_view<int> result_av(int(result.size()), result);
+
+            segmented_scan_single_pass<tile_size, scan_mode::exclusive>(input_av, flags_av, result_av, amp_algorithms::plus<int>());
+
+            result_av.synchronize();
+            Assert::IsTrue(expected == result, Msg(expected, result).c_str());
+        }
+
+        TEST_METHOD(amp_segmented_scan_single_pass_inclusive)
+        {
+            const int tile_size = warp_size * 4;
+            std::vector<int> input(tile_size * 20 + 5, 1);
+            std::vector<unsigned int> flags(input.size(), 0);
+            std::vector<int> result(input.size(), -1);
+            std::vector<int> expected(input.size());
+            for (int i = 0; i < int(input.size()); ++i)
+            {
+                flags[i] = ((i % 100) == 0) ? 1 : 0;
+                expected[i] = (i % 100) + 1;
+            }
+            array_view<const int> input_av(int(input.size()), input);
+            array_view<const unsigned int> flags_av(int(flags.size()), flags);
+            array_view<int> result_av(int(result.size()), result);
+
+            segmented_scan_single_pass<tile_size, scan_mode::inclusive>(input_av, flags_av, result_av, amp_algorithms::plus<int>());
+
+            result_av.synchronize();
+            Assert::IsTrue(expected == result, Msg(expected, result).c_str());
+        }
+
+        TEST_METHOD(host_scan_exclusive)
+        {
+            std::vector<int> input(1024 * 1024 + 3);
+            generate_data(input);
+            std::vector<int> result(input.size(), -1);
+            std::vector<int> expected(input.size());
+            scan_sequential_exclusive(begin(input), end(input), begin(expected));
+
+            amp_algorithms::host::scan_exclusive(begin(input), end(input), begin(result), amp_algorithms::plus<int>());
+
+            Assert::IsTrue(expected == result, Msg(expected, result).c_str());
+        }
+
+        TEST_METHOD(host_segmented_scan_inclusive)
+        {
+            std::vector<int> input(1024 * 1024 + 3, 1);
+            std::vector<unsigned int> flags(input.size(), 0);
+            std::vector<int> expected(input.size());
+            for (int i = 0; i < int(input.size()); ++i)
+            {
+                flags[i] = ((i % 10000) == 0) ? 1 : 0;
+                expected[i] = (i % 10000) + 1;
+            }
+
+            amp_algorithms::host::segmented_scan_inclusive(begin(input), end(input), begin(flags), begin(input), amp_algorithms::plus<int>());
+
+            Assert::IsTrue(expected == input, Msg(expected, input).c_str());
+        }
     };
 }
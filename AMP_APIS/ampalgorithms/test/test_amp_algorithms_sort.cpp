@@ -66,20 +66,98 @@ namespace amp_algorithms_tests
             }
         }
 
-        TEST_METHOD(aaa_amp_sort_radix)
+        TEST_METHOD(amp_radix_sort_int)
         {
-            std::array<unsigned, 16> input = {  3,  2,  1,  6, 10, 11, 13, 16, 15, 10,  5, 14,  4, 12,  9,  8 };
-            //                                  3   2   1   2   2   3   1   0   3   2   1   2   0   0   1   0
-            //std::array<unsigned, 4> expected = { 3, 2, 1, 6 };
-            std::array<int, 4> expected = { 4, 4, 5, 3 };
-            //std::array<unsigned, 4> expected = { 0, 4, 9, 12 };
-            array_view<unsigned> input_av(int(input.size()), input);
-
-            //radix_sort(input_av);
-            
-            //histogram_tile<unsigned, 2, 8>(input_av, 0);
-
-            //Assert::IsTrue(are_equal(expected, input_av.section(0, 4)));
+            std::vector<int> input(1023);
+            generate_data(input);
+            std::vector<int> expected(input);
+            std::sort(begin(expected), end(expected));
+            array_view<int> input_av(int(input.size()), input);
+
+            radix_sort(input_av);
+
+            Assert::IsTrue(are_equal(expected, input_av));
+        }
+
+        TEST_METHOD(amp_radix_sort_float)
+        {
+            std::vector<float> input(1023);
+            generate_data(input);
+            input[0] = -0.5f;
+            input[1] = 0.5f;
+            std::vector<float> expected(input);
+            std::sort(begin(expected), end(expected));
+            array_view<float> input_av(int(input.size()), input);
+
+            radix_sort(input_av);
+
+            Assert::IsTrue(are_equal(expected, input_av));
+        }
+
+        TEST_METHOD(amp_radix_sort_by_key_is_stable)
+        {
+            const int size = 1023;
+            std::vector<int> keys(size);
+            std::vector<int> values(size);
+            std::vector<std::pair<int, int>> expected(size);
+            for (int i = 0; i < size; ++i)
+            {
+                keys[i] = (i * 7) % 13 - 6;
+                values[i] = i;
+                expected[i] = std::make_pair(keys[i], i);
+            }
+            std::stable_sort(begin(expected), end(expected), [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+            array_view<int> keys_av(size, keys);
+            array_view<int> values_av(size, values);
+
+            radix_sort_by_key(keys_av, values_av);
+
+            keys_av.synchronize();
+            values_av.synchronize();
+            for (int i = 0; i < size; ++i)
+            {
+                Assert::AreEqual(expected[i].first, keys[i]);
+                Assert::AreEqual(expected[i].second, values[i]);
+            }
+        }
+
+        TEST_METHOD(amp_merge_sort_with_comparator)
+        {
+            std::vector<int> input(1023);
+            generate_data(input);
+            std::vector<int> expected(input);
+            std::sort(begin(expected), end(expected), std::greater<int>());
+            array_view<int> input_av(int(input.size()), input);
+
+            merge_sort(input_av, amp_algorithms::greater<int>());
+
+            Assert::IsTrue(are_equal(expected, input_av));
+        }
+
+        TEST_METHOD(host_radix_sort_by_key_64_bit_keys)
+        {
+            const int size = 100000;
+            std::vector<long long> keys(size);
+            std::vector<int> values(size);
+            for (int i = 0; i < size; ++i)
+            {
+                keys[i] = ((i * 7919LL) % 1000) * 0x100000000LL - 500;
+                values[i] = i;
+            }
+            std::vector<std::pair<long long, int>> expected(size);
+            for (int i = 0; i < size; ++i)
+            {
+                expected[i] = std::make_pair(keys[i], values[i]);
+            }
+            std::stable_sort(begin(expected), end(expected), [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) { return a.first < b.first; });
+
+            amp_algorithms::host::radix_sort_by_key(keys.data(), keys.data() + size, values.data());
+
+            for (int i = 0; i < size; ++i)
+            {
+                Assert::AreEqual(expected[i].first, keys[i]);
+                Assert::AreEqual(expected[i].second, values[i]);
+            }
         }
     };
 }; // namespace amp_algorithms_tests
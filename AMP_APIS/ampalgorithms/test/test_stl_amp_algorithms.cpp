@@ -735,6 +735,173 @@ namespace amp_stl_algorithms_tests
             }
         }
 
+        //----------------------------------------------------------------------------
+        // lower_bound, upper_bound
+        //----------------------------------------------------------------------------
+
+        TEST_METHOD(stl_lower_bound_upper_bound)
+        {
+            std::array<int, 10> input = { 1, 2, 2, 2, 4, 5, 5, 7, 8, 9 };
+            array_view<int> av(int(input.size()), input);
+
+            Assert::AreEqual(1, std::distance(begin(av), amp_stl_algorithms::lower_bound(begin(av), end(av), 2)));
+            Assert::AreEqual(4, std::distance(begin(av), amp_stl_algorithms::upper_bound(begin(av), end(av), 2)));
+            Assert::AreEqual(4, std::distance(begin(av), amp_stl_algorithms::lower_bound(begin(av), end(av), 3)));
+            Assert::AreEqual(0, std::distance(begin(av), amp_stl_algorithms::lower_bound(begin(av), end(av), 0)));
+            Assert::AreEqual(10, std::distance(begin(av), amp_stl_algorithms::upper_bound(begin(av), end(av), 9)));
+        }
+
+        TEST_METHOD(stl_lower_bound_upper_bound_vectorized)
+        {
+            const int size = 10000;
+            std::vector<int> sorted(size);
+            std::vector<int> values(size);
+            for (int i = 0; i < size; ++i)
+            {
+                sorted[i] = i / 3;
+                values[i] = (i * 7) % 3500 - 10;
+            }
+            std::vector<int> lower(size, -1);
+            std::vector<int> upper(size, -1);
+            array_view<int> sorted_av(size, sorted);
+            array_view<int> values_av(size, values);
+            array_view<int> lower_av(size, lower);
+            array_view<int> upper_av(size, upper);
+
+            amp_stl_algorithms::lower_bound(begin(sorted_av), end(sorted_av), begin(values_av), end(values_av), begin(lower_av));
+            amp_stl_algorithms::upper_bound(begin(sorted_av), end(sorted_av), begin(values_av), end(values_av), begin(upper_av));
+
+            lower_av.synchronize();
+            upper_av.synchronize();
+            for (int i = 0; i < size; ++i)
+            {
+                Assert::AreEqual(int(std::distance(begin(sorted), std::lower_bound(begin(sorted), end(sorted), values[i]))), lower[i]);
+                Assert::AreEqual(int(std::distance(begin(sorted), std::upper_bound(begin(sorted), end(sorted), values[i]))), upper[i]);
+            }
+        }
+
+        //----------------------------------------------------------------------------
+        // merge, inplace_merge
+        //----------------------------------------------------------------------------
+
+        TEST_METHOD(stl_merge)
+        {
+            // The ranges are skewed so only ten elements of the second range interleave with the first.
+            const int size = 1000;
+            std::vector<int> input1(size);
+            std::vector<int> input2(size);
+            std::iota(begin(input1), end(input1), 0);
+            std::iota(begin(input2), end(input2), 990);
+            std::vector<int> expected(2 * size);
+            std::merge(begin(input1), end(input1), begin(input2), end(input2), begin(expected));
+            std::vector<int> result(2 * size, -1);
+            array_view<int> input1_av(size, input1);
+            array_view<int> input2_av(size, input2);
+            array_view<int> result_av(2 * size, result);
+
+            auto result_end = amp_stl_algorithms::merge(begin(input1_av), end(input1_av), begin(input2_av), end(input2_av), begin(result_av));
+
+            Assert::AreEqual(2 * size, std::distance(begin(result_av), result_end));
+            Assert::IsTrue(are_equal(expected, result_av));
+        }
+
+        TEST_METHOD(stl_inplace_merge)
+        {
+            std::array<int, 10> input = { 1, 3, 5, 7, 9, 0, 2, 4, 6, 8 };
+            std::array<int, 10> expected = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+            array_view<int> av(int(input.size()), input);
+
+            amp_stl_algorithms::inplace_merge(begin(av), begin(av) + 5, end(av));
+
+            Assert::IsTrue(are_equal(expected, av));
+        }
+
+        //----------------------------------------------------------------------------
+        // nth_element
+        //----------------------------------------------------------------------------
+
+        TEST_METHOD(stl_nth_element)
+        {
+            // Large enough for several rounds of sample select before the remaining candidates are sorted.
+            const int size = 100000;
+            const int nth = 31337;
+            std::vector<int> vec(size);
+            generate_data(vec);
+            std::vector<int> expected(vec);
+            std::nth_element(begin(expected), begin(expected) + nth, end(expected));
+            array_view<int> av(size, vec);
+
+            amp_stl_algorithms::nth_element(begin(av), begin(av) + nth, end(av));
+
+            av.synchronize();
+            Assert::AreEqual(expected[nth], vec[nth]);
+            Assert::IsTrue(std::all_of(begin(vec), begin(vec) + nth, [=](int v) { return v <= vec[nth]; }));
+            Assert::IsTrue(std::all_of(begin(vec) + nth, end(vec), [=](int v) { return v >= vec[nth]; }));
+        }
+
+        TEST_METHOD(stl_nth_element_with_duplicates)
+        {
+            const int size = 50000;
+            std::vector<int> vec(size);
+            std::generate(begin(vec), end(vec), [] { return rand() % 4; });
+            std::vector<int> expected(vec);
+            std::sort(begin(expected), end(expected));
+            array_view<int> av(size, vec);
+
+            amp_stl_algorithms::nth_element(begin(av), begin(av) + size / 2, end(av), amp_algorithms::greater<int>());
+
+            av.synchronize();
+            Assert::AreEqual(expected[size - 1 - size / 2], vec[size / 2]);
+        }
+
+        //----------------------------------------------------------------------------
+        // partition, stable_partition, partition_point, is_partitioned
+        //----------------------------------------------------------------------------
+
+        TEST_METHOD(stl_partition)
+        {
+            const int size = 1000;
+            std::vector<int> vec(size);
+            generate_data(vec);
+            auto is_even = [](const int& v) restrict(cpu, amp) { return (v % 2) == 0; };
+            array_view<int> av(size, vec);
+
+            auto middle = amp_stl_algorithms::partition(begin(av), end(av), is_even);
+
+            av.synchronize();
+            Assert::AreEqual(int(std::count_if(begin(vec), end(vec), is_even)), int(std::distance(begin(av), middle)));
+            Assert::IsTrue(std::is_partitioned(begin(vec), end(vec), is_even));
+        }
+
+        TEST_METHOD(stl_stable_partition)
+        {
+            const int size = 1000;
+            std::vector<int> vec(size);
+            generate_data(vec);
+            auto is_even = [](const int& v) restrict(cpu, amp) { return (v % 2) == 0; };
+            std::vector<int> expected(vec);
+            auto expected_middle = std::stable_partition(begin(expected), end(expected), is_even);
+            array_view<int> av(size, vec);
+
+            auto middle = amp_stl_algorithms::stable_partition(begin(av), end(av), is_even);
+
+            Assert::AreEqual(int(std::distance(begin(expected), expected_middle)), int(std::distance(begin(av), middle)));
+            Assert::IsTrue(are_equal(expected, av));
+        }
+
+        TEST_METHOD(stl_partition_point_is_partitioned)
+        {
+            std::array<int, 10> input = { 2, 4, 6, 8, 1, 3, 5, 7, 9, 11 };
+            auto is_even = [](const int& v) restrict(cpu, amp) { return (v % 2) == 0; };
+            array_view<int> av(int(input.size()), input);
+
+            Assert::IsTrue(amp_stl_algorithms::is_partitioned(begin(av), end(av), is_even));
+            Assert::AreEqual(4, std::distance(begin(av), amp_stl_algorithms::partition_point(begin(av), end(av), is_even)));
+
+            av[1] = 3;
+            Assert::IsFalse(amp_stl_algorithms::is_partitioned(begin(av), end(av), is_even));
+        }
+
         //----------------------------------------------------------------------------
         // reduce
         //----------------------------------------------------------------------------
@@ -1030,6 +1197,68 @@ namespace amp_stl_algorithms_tests
             Assert::AreEqual(result_av[size - 1], *--result_end);
         }
 
+        //----------------------------------------------------------------------------
+        // search, binary_search
+        //----------------------------------------------------------------------------
+
+        TEST_METHOD(stl_search)
+        {
+            std::array<int, 10> input = { 1, 2, 3, 1, 2, 4, 1, 2, 4, 5 };
+            std::array<int, 3> pattern = { 1, 2, 4 };
+            std::array<int, 2> missing = { 4, 2 };
+            array_view<int> av(int(input.size()), input);
+            array_view<int> pattern_av(int(pattern.size()), pattern);
+            array_view<int> missing_av(int(missing.size()), missing);
+
+            Assert::AreEqual(3, std::distance(begin(av), amp_stl_algorithms::search(begin(av), end(av), begin(pattern_av), end(pattern_av))));
+            Assert::AreEqual(10, std::distance(begin(av), amp_stl_algorithms::search(begin(av), end(av), begin(missing_av), end(missing_av))));
+        }
+
+        TEST_METHOD(stl_binary_search)
+        {
+            std::array<int, 6> input = { 1, 3, 3, 5, 8, 9 };
+            array_view<int> av(int(input.size()), input);
+
+            Assert::IsTrue(amp_stl_algorithms::binary_search(begin(av), end(av), 3));
+            Assert::IsTrue(amp_stl_algorithms::binary_search(begin(av), end(av), 9));
+            Assert::IsFalse(amp_stl_algorithms::binary_search(begin(av), end(av), 4));
+            Assert::IsFalse(amp_stl_algorithms::binary_search(begin(av), end(av), 10));
+        }
+
+        //----------------------------------------------------------------------------
+        // set_difference, set_intersection, set_symmetric_difference, set_union
+        //----------------------------------------------------------------------------
+
+        TEST_METHOD(stl_set_operations)
+        {
+            std::array<int, 8> input1 = { 1, 2, 2, 2, 4, 5, 7, 7 };
+            std::array<int, 6> input2 = { 2, 2, 3, 5, 7, 8 };
+            array_view<int> input1_av(int(input1.size()), input1);
+            array_view<int> input2_av(int(input2.size()), input2);
+            std::vector<int> result(input1.size() + input2.size(), -1);
+            array_view<int> result_av(int(result.size()), result);
+
+            std::array<int, 10> expected_union = { 1, 2, 2, 2, 3, 4, 5, 7, 7, 8 };
+            auto result_end = amp_stl_algorithms::set_union(begin(input1_av), end(input1_av), begin(input2_av), end(input2_av), begin(result_av));
+            Assert::AreEqual(10, std::distance(begin(result_av), result_end));
+            Assert::IsTrue(are_equal(expected_union, result_av.section(0, 10)));
+
+            std::array<int, 4> expected_intersection = { 2, 2, 5, 7 };
+            result_end = amp_stl_algorithms::set_intersection(begin(input1_av), end(input1_av), begin(input2_av), end(input2_av), begin(result_av));
+            Assert::AreEqual(4, std::distance(begin(result_av), result_end));
+            Assert::IsTrue(are_equal(expected_intersection, result_av.section(0, 4)));
+
+            std::array<int, 4> expected_difference = { 1, 2, 4, 7 };
+            result_end = amp_stl_algorithms::set_difference(begin(input1_av), end(input1_av), begin(input2_av), end(input2_av), begin(result_av));
+            Assert::AreEqual(4, std::distance(begin(result_av), result_end));
+            Assert::IsTrue(are_equal(expected_difference, result_av.section(0, 4)));
+
+            std::array<int, 6> expected_symmetric_difference = { 1, 2, 3, 4, 7, 8 };
+            result_end = amp_stl_algorithms::set_symmetric_difference(begin(input1_av), end(input1_av), begin(input2_av), end(input2_av), begin(result_av));
+            Assert::AreEqual(6, std::distance(begin(result_av), result_end));
+            Assert::IsTrue(are_equal(expected_symmetric_difference, result_av.section(0, 6)));
+        }
+
         //----------------------------------------------------------------------------
         // sort, partial_sort, partial_sort_copy, stable_sort, is_sorted, is_sorted_until
         //----------------------------------------------------------------------------
@@ -1092,6 +1321,65 @@ namespace amp_stl_algorithms_tests
             Assert::IsTrue(amp_stl_algorithms::is_sorted(begin(av), begin(av) + 1));
         }
 
+        TEST_METHOD(stl_sort)
+        {
+            const int size = 1000;
+            std::vector<int> vec(size);
+            generate_data(vec);
+            std::vector<int> expected(vec);
+            std::sort(begin(expected), end(expected));
+            array_view<int> av(size, vec);
+
+            amp_stl_algorithms::sort(begin(av), end(av));
+
+            Assert::IsTrue(are_equal(expected, av));
+        }
+
+        TEST_METHOD(stl_stable_sort_with_comparator)
+        {
+            const int size = 1000;
+            std::vector<int> vec(size);
+            generate_data(vec);
+            auto abs_less = [](const int& a, const int& b) restrict(cpu, amp) { return ((a < 0) ? -a : a) < ((b < 0) ? -b : b); };
+            std::vector<int> expected(vec);
+            std::stable_sort(begin(expected), end(expected), abs_less);
+            array_view<int> av(size, vec);
+
+            amp_stl_algorithms::stable_sort(begin(av), end(av), abs_less);
+
+            Assert::IsTrue(are_equal(expected, av));
+        }
+
+        TEST_METHOD(stl_partial_sort)
+        {
+            const int size = 100000;
+            const int top_count = 100;
+            std::vector<int> vec(size);
+            generate_data(vec);
+            std::vector<int> expected(vec);
+            std::partial_sort(begin(expected), begin(expected) + top_count, end(expected));
+            expected.resize(top_count);
+            array_view<int> av(size, vec);
+
+            amp_stl_algorithms::partial_sort(begin(av), begin(av) + top_count, end(av));
+
+            Assert::IsTrue(are_equal(expected, av.section(0, top_count)));
+        }
+
+        TEST_METHOD(stl_partial_sort_copy)
+        {
+            std::array<int, 10> input = { 5, 7, 4, 2, 8, 6, 1, 9, 0, 3 };
+            std::array<int, 4> expected = { 9, 8, 7, 6 };
+            std::array<int, 4> result = { -1, -1, -1, -1 };
+            array_view<int> input_av(int(input.size()), input);
+            array_view<int> result_av(int(result.size()), result);
+
+            auto result_end = amp_stl_algorithms::partial_sort_copy(begin(input_av), end(input_av), begin(result_av), end(result_av), amp_algorithms::greater<int>());
+
+            Assert::AreEqual(4, std::distance(begin(result_av), result_end));
+            Assert::IsTrue(are_equal(expected, result_av));
+        }
+
         //----------------------------------------------------------------------------
         // swap, swap<T, N>, swap_ranges, iter_swap
         //----------------------------------------------------------------------------
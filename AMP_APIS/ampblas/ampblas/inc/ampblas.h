@@ -52,4 +52,9 @@
 #include "detail/trmm.h"
 #include "detail/trsm.h"
 
+// Batched
+#include "detail/gemm_batched.h"
+#include "detail/gemv_batched.h"
+#include "detail/trsm_batched.h"
+
 #endif //AMPBLAS_H
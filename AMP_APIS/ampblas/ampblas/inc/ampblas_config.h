@@ -70,6 +70,12 @@ struct is_array_view<concurrency::array_view<const value_type,rank>>
    static const bool value = true; 
 };
 
+// true for the CPU accelerator, which has no parallel_for_each; host implementations are used instead
+inline bool is_host_accelerator(const concurrency::accelerator_view& av)
+{
+    return av.accelerator.device_path == concurrency::accelerator::cpu_accelerator;
+}
+
 // extent helpers
 inline concurrency::extent<1> make_extent(int n) restrict(cpu, amp)
 {
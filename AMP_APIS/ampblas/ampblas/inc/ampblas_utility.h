@@ -25,10 +25,13 @@
 
 #include "utility/adapter.h"
 #include "utility/algorithm.h"
+#include "utility/aligned_buffer.h"
+#include "utility/batch.h"
 #include "utility/complex.h"
 #include "utility/math.h"
 #include "utility/reduction.h"
 #include "utility/parameter_check.h"
 #include "utility/storage.h"
+#include "utility/thread_pool.h"
 
 #endif // AMPBLAS_UTILITY_H
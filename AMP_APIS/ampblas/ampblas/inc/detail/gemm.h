@@ -25,6 +25,9 @@
 #include "ampblas_utility.h"
 
 #include "tuning/gemm.h"
+#include "tuning/candidates.h"
+#include "tuning/database.h"
+#include "host/gemm.h"
 
 namespace ampblas {
 namespace _detail {
@@ -42,48 +45,87 @@ void gemm(const concurrency::accelerator_view& av, enum class transpose transa,
     gemm_stage_2(av, transb, transa, alpha, b, a, beta, c);
 }
 
+// Host path: operates directly on the host memory of the (row major) views
+template <typename scalar_type, typename a_type, typename b_type, typename c_type>
+void gemm_host(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
+{
+    const int m = c.extent[0];
+    const int n = c.extent[1];
+    const int k = (transa != transpose::no_trans ? a.extent[0] : a.extent[1]);
+
+    if (m == 0 || n == 0)
+        return;
+
+    if (k == 0)
+    {
+        host::scale(m, n, beta, host::make_matrix_ref(c));
+        return;
+    }
+
+    // tuned cache blocking if the database has an entry for this problem
+    host::gemm_blocking blocking = host::default_gemm_blocking<scalar_type>();
+    std::vector<int> parameters;
+    if (find_gemm_tuning<scalar_type>(av, transa, transb, m, n, k, parameters) && parameters.size() == 3)
+    {
+        const host::gemm_blocking tuned(parameters[0], parameters[1], parameters[2]);
+        if (host::is_valid_gemm_blocking<scalar_type>(tuned))
+            blocking = tuned;
+    }
+
+    host::gemm(m, n, k, alpha, host::make_matrix_ref(a, transa), transa == transpose::conj_trans, host::make_matrix_ref(b, transb), transb == transpose::conj_trans, beta, host::make_matrix_ref(c), blocking);
+}
+
 // Stage 2: Hardcoded architecture as template parameter
+//   candidate selects an entry of the gemm_tuning_candidate list; a negative
+//   value looks the problem up in the tuning database
 template <typename scalar_type, typename a_type, typename b_type, typename c_type>
-void gemm_stage_2(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
+void gemm_stage_2(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c, int candidate = -1)
 {
+    // the CPU accelerator runs the packed host implementation
+    if (is_host_accelerator(av))
+    {
+        gemm_host(av, transa, transb, alpha, a, b, beta, c);
+        return;
+    }
+
     // obtain architecture based off information in the accelerator_view
     std::wstring desc = av.accelerator.get_description();
     const enum class architecture arch = get_architecture(desc);
     
     if (arch == architecture::amd)
     {
-        gemm_stage_3<architecture::amd>(av, transa, transb, alpha, a, b, beta, c);
+        gemm_stage_3<architecture::amd>(av, transa, transb, alpha, a, b, beta, c, candidate);
     }
     else if (arch == architecture::nvidia)
     {
-        gemm_stage_3<architecture::nvidia>(av, transa, transb, alpha, a, b, beta, c);
+        gemm_stage_3<architecture::nvidia>(av, transa, transb, alpha, a, b, beta, c, candidate);
     }
     else
     {
-        gemm_stage_3<architecture::unknown>(av, transa, transb, alpha, a, b, beta, c);
+        gemm_stage_3<architecture::unknown>(av, transa, transb, alpha, a, b, beta, c, candidate);
     }
 }
 
 // Stage 3: Hardcoded transpose operations as template parameters
 template <enum class architecture arch, typename scalar_type, typename a_type, typename b_type, typename c_type>
-void gemm_stage_3(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
+void gemm_stage_3(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c, int candidate)
 {
     if (transa == transpose::no_trans)
     {
         if (transb == transpose::no_trans)
         {
             // NN
-            gemm_stage_4<arch, transpose::no_trans, transpose::no_trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::no_trans, transpose::no_trans>(av, alpha, a, b, beta, c, candidate);
         }
         else if (transb == transpose::trans)
         {
             // NT
-            gemm_stage_4<arch, transpose::no_trans, transpose::trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::no_trans, transpose::trans>(av, alpha, a, b, beta, c, candidate);
         }
         else if (transb == transpose::conj_trans)
         {
             // NC
-            gemm_stage_4<arch, transpose::no_trans, transpose::conj_trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::no_trans, transpose::conj_trans>(av, alpha, a, b, beta, c, candidate);
         }
     }
     else if (transa == transpose::trans)
@@ -91,17 +133,17 @@ void gemm_stage_3(const concurrency::accelerator_view& av, enum class transpose
         if (transb == transpose::no_trans)
         {
             // TN
-            gemm_stage_4<arch, transpose::trans, transpose::no_trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::trans, transpose::no_trans>(av, alpha, a, b, beta, c, candidate);
         }
         else if (transb == transpose::trans)
         {
             // TT
-            gemm_stage_4<arch, transpose::trans, transpose::trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::trans, transpose::trans>(av, alpha, a, b, beta, c, candidate);
         }
         else if (transb == transpose::conj_trans)
         {
             // TC
-            gemm_stage_4<arch, transpose::trans, transpose::conj_trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::trans, transpose::conj_trans>(av, alpha, a, b, beta, c, candidate);
         }
     }
     else if (transa == transpose::conj_trans)
@@ -109,34 +151,31 @@ void gemm_stage_3(const concurrency::accelerator_view& av, enum class transpose
         if (transb == transpose::no_trans)
         {
             // CN
-            gemm_stage_4<arch, transpose::conj_trans, transpose::no_trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::conj_trans, transpose::no_trans>(av, alpha, a, b, beta, c, candidate);
         }
         else if (transb == transpose::trans)
         {
             // CT
-            gemm_stage_4<arch, transpose::conj_trans, transpose::trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::conj_trans, transpose::trans>(av, alpha, a, b, beta, c, candidate);
         }
         else if (transb == transpose::conj_trans)
         {
             // CC
-            gemm_stage_4<arch, transpose::conj_trans, transpose::conj_trans>(av, alpha, a, b, beta, c);
+            gemm_stage_4<arch, transpose::conj_trans, transpose::conj_trans>(av, alpha, a, b, beta, c, candidate);
         }
     }
 }
 
 // Stage 4: find tuning parameters, check if we need an IO guard, and finally pass to the kernel!
-template <enum class architecture arch, enum class transpose transa, enum class transpose transb, typename scalar_type, typename a_type, typename b_type, typename c_type>
-void gemm_stage_4(const concurrency::accelerator_view& av, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)  
-{ 
-    // alias to all important tuning parameters
-    typedef gemm_tuning_parameters<arch, scalar_type, transa, transb> tp;
-
+template <typename tp, enum class transpose transa, enum class transpose transb, typename scalar_type, typename a_type, typename b_type, typename c_type>
+void gemm_tuned(const concurrency::accelerator_view& av, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
+{
     // row major
     const int m = c.extent[0];  
     const int n = c.extent[1];
     const int k = (transa != transpose::no_trans ? a.extent[0] : a.extent[1]); 
 
-    if (tp::m_block % m || tp::n_block % n || tp::k_block % k) 
+    if (m % tp::m_block || n % tp::n_block || k % tp::k_block) 
     {
         // one or more dimensions doesn't align with work block size, must use IO guards
         const bool guarded = true;
@@ -150,6 +189,51 @@ void gemm_stage_4(const concurrency::accelerator_view& av, scalar_type alpha, co
     }
 }
 
+// runtime candidate index to compile time tuning parameters
+template <enum class architecture arch, enum class transpose transa, enum class transpose transb, int index = 0>
+struct gemm_candidate_dispatch
+{
+    template <typename scalar_type, typename a_type, typename b_type, typename c_type>
+    static void run(int candidate, const concurrency::accelerator_view& av, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
+    {
+        if (candidate == index)
+            gemm_tuned<gemm_tuning_candidate<arch, scalar_type, transa, transb, index>, transa, transb>(av, alpha, a, b, beta, c);
+        else
+            gemm_candidate_dispatch<arch, transa, transb, index + 1>::run(candidate, av, alpha, a, b, beta, c);
+    }
+};
+
+template <enum class architecture arch, enum class transpose transa, enum class transpose transb>
+struct gemm_candidate_dispatch<arch, transa, transb, gemm_tuning_candidate_count>
+{
+    template <typename scalar_type, typename a_type, typename b_type, typename c_type>
+    static void run(int, const concurrency::accelerator_view& av, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
+    {
+        // out of range; use the architecture table
+        gemm_tuned<gemm_tuning_parameters<arch, scalar_type, transa, transb>, transa, transb>(av, alpha, a, b, beta, c);
+    }
+};
+
+template <enum class architecture arch, enum class transpose transa, enum class transpose transb, typename scalar_type, typename a_type, typename b_type, typename c_type>
+void gemm_stage_4(const concurrency::accelerator_view& av, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c, int candidate)  
+{ 
+    if (candidate < 0)
+    {
+        // a tuned configuration from the database; otherwise the architecture table (candidate 0)
+        const int m = c.extent[0];  
+        const int n = c.extent[1];
+        const int k = (transa != transpose::no_trans ? a.extent[0] : a.extent[1]); 
+
+        std::vector<int> parameters;
+        if (find_gemm_tuning<scalar_type>(av, transa, transb, m, n, k, parameters))
+            candidate = find_gemm_candidate<arch, scalar_type, transa, transb>(parameters);
+
+        candidate = std::max(candidate, 0);
+    }
+
+    gemm_candidate_dispatch<arch, transa, transb>::run(candidate, av, alpha, a, b, beta, c);
+}
+
 // Stage 5: Highly parameterized GEMM
 template <bool guarded, enum class transpose transa, enum class transpose transb, int m_block, int n_block, int k_block, int m_c_tile, int n_c_tile, int m_a_tile, int n_a_tile, int m_b_tile, int n_b_tile, int use_padding, typename scalar_type, typename a_type, typename b_type, typename c_type>
 void gemm_kernel(const concurrency::accelerator_view& av, scalar_type alpha, const a_type& a, const b_type& b, scalar_type beta, const c_type& c)
@@ -0,0 +1,202 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemm_batched.h
+ *
+ * C[b] = alpha * op(A[b]) * op(B[b]) + beta * C[b] for a batch of equally
+ * sized column major problems, either strided in one buffer (batch_view) or
+ * given as separate views.
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_GEMM_BATCHED_H
+#define AMPBLAS_GEMM_BATCHED_H
+
+#include "ampblas_config.h"
+#include "ampblas_utility.h"
+
+#include "gemm.h"
+#include "host/batched.h"
+
+#include <vector>
+
+namespace ampblas {
+namespace _detail {
+
+//
+// Host path
+//
+
+template <typename value_type>
+void gemm_batched_host(enum class transpose transa, enum class transpose transb, int m, int n, int k, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& b, value_type beta, const batch_view<value_type>& c)
+{
+    const value_type* a_base = host::batch_data(a);
+    const value_type* b_base = host::batch_data(b);
+    value_type* c_base = host::batch_data(c);
+
+    const bool conj_a = (transa == transpose::conj_trans);
+    const bool conj_b = (transb == transpose::conj_trans);
+
+    // large items are better served by the blocked, multithreaded gemm
+    if (m > host::small_batch_limit || n > host::small_batch_limit || k > host::small_batch_limit)
+    {
+        for (int item = 0; item < c.count; item++)
+            host::gemm(m, n, k, alpha, host::make_matrix_ref(a, a_base, item, transa), conj_a, host::make_matrix_ref(b, b_base, item, transb), conj_b, beta, host::make_matrix_ref(c, c_base, item));
+        return;
+    }
+
+    const size_t scratch = host::small_gemm_scratch(m, k);
+    aligned_buffer<value_type> a_pack(size_t(get_thread_pool().concurrency()) * scratch);
+
+    host::batch_for(c.count, [&](int worker, int item)
+    {
+        host::small_gemm(m, n, k, alpha, host::make_matrix_ref(a, a_base, item, transa), conj_a, host::make_matrix_ref(b, b_base, item, transb), conj_b, beta, host::make_matrix_ref(c, c_base, item), a_pack.data() + worker * scratch);
+    });
+}
+
+template <typename value_type>
+void gemm_batched_host(enum class transpose transa, enum class transpose transb, int m, int n, int k, value_type alpha, const std::vector<concurrency::array_view<const value_type,2>>& a, const std::vector<concurrency::array_view<const value_type,2>>& b, value_type beta, const std::vector<concurrency::array_view<value_type,2>>& c)
+{
+    const int count = static_cast<int>(c.size());
+    const bool conj_a = (transa == transpose::conj_trans);
+    const bool conj_b = (transb == transpose::conj_trans);
+
+    // the views are column major, so the host references are transposed
+    if (m > host::small_batch_limit || n > host::small_batch_limit || k > host::small_batch_limit)
+    {
+        for (int item = 0; item < count; item++)
+            host::gemm(m, n, k, alpha, host::make_matrix_ref(a[item], transa).transposed(), conj_a, host::make_matrix_ref(b[item], transb).transposed(), conj_b, beta, host::make_matrix_ref(c[item]).transposed());
+        return;
+    }
+
+    const size_t scratch = host::small_gemm_scratch(m, k);
+    aligned_buffer<value_type> a_pack(size_t(get_thread_pool().concurrency()) * scratch);
+
+    host::batch_for(count, [&](int worker, int item)
+    {
+        host::small_gemm(m, n, k, alpha, host::make_matrix_ref(a[item], transa).transposed(), conj_a, host::make_matrix_ref(b[item], transb).transposed(), conj_b, beta, host::make_matrix_ref(c[item]).transposed(), a_pack.data() + worker * scratch);
+    });
+}
+
+//
+// Accelerator path: one thread per element of the whole batch
+//
+
+template <enum class transpose transa, enum class transpose transb, typename value_type>
+void gemm_batched(const concurrency::accelerator_view& av, int k, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& b, value_type beta, const batch_view<value_type>& c)
+{
+    // rows innermost so neighbouring threads write neighbouring elements of C
+    concurrency::parallel_for_each(
+        av,
+        concurrency::extent<3>(c.count, c.cols, c.rows),
+        [=] (concurrency::index<3> idx) restrict(amp)
+        {
+            const int item = idx[0];
+            const int j = idx[1];
+            const int i = idx[2];
+
+            value_type result = value_type();
+
+            for (int p = 0; p < k; ++p)
+            {
+                value_type a_value = (transa == transpose::no_trans ? a(item, i, p) : a(item, p, i));
+                if (transa == transpose::conj_trans)
+                    a_value = conjugate::op(a_value);
+
+                value_type b_value = (transb == transpose::no_trans ? b(item, p, j) : b(item, j, p));
+                if (transb == transpose::conj_trans)
+                    b_value = conjugate::op(b_value);
+
+                result += a_value * b_value;
+            }
+
+            value_type& c_value = c(item, i, j);
+            c_value = (beta == value_type() ? alpha * result : alpha * result + beta * c_value);
+        }
+    );
+}
+
+template <enum class transpose transa, typename value_type>
+void gemm_batched(const concurrency::accelerator_view& av, enum class transpose transb, int k, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& b, value_type beta, const batch_view<value_type>& c)
+{
+    if (transb == transpose::no_trans)
+        gemm_batched<transa, transpose::no_trans>(av, k, alpha, a, b, beta, c);
+    else if (transb == transpose::trans)
+        gemm_batched<transa, transpose::trans>(av, k, alpha, a, b, beta, c);
+    else if (transb == transpose::conj_trans)
+        gemm_batched<transa, transpose::conj_trans>(av, k, alpha, a, b, beta, c);
+}
+
+} // namespace _detail
+
+// strided batch; m and n are taken from C and k from op(A)
+template <typename value_type>
+void gemm_batched(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& b, value_type beta, const batch_view<value_type>& c)
+{
+    const int m = c.rows;
+    const int n = c.cols;
+    const int k = (transa == transpose::no_trans ? a.cols : a.rows);
+
+    if (a.count != c.count || b.count != c.count)
+        argument_error("gemm_batched: batch counts differ");
+    if ((transa == transpose::no_trans ? a.rows : a.cols) != m)
+        argument_error("gemm_batched: op(A) and C have different row counts");
+    if ((transb == transpose::no_trans ? b.rows : b.cols) != k || (transb == transpose::no_trans ? b.cols : b.rows) != n)
+        argument_error("gemm_batched: op(B) does not match op(A) and C");
+
+    // quick return
+    if (c.count <= 0 || m <= 0 || n <= 0)
+        return;
+
+    if (_detail::is_host_accelerator(av))
+    {
+        _detail::gemm_batched_host(transa, transb, m, n, k, alpha, a, b, beta, c);
+        return;
+    }
+
+    if (transa == transpose::no_trans)
+        _detail::gemm_batched<transpose::no_trans>(av, transb, k, alpha, a, b, beta, c);
+    else if (transa == transpose::trans)
+        _detail::gemm_batched<transpose::trans>(av, transb, k, alpha, a, b, beta, c);
+    else if (transa == transpose::conj_trans)
+        _detail::gemm_batched<transpose::conj_trans>(av, transb, k, alpha, a, b, beta, c);
+}
+
+// batch of separate [m x n] problems
+template <typename value_type>
+void gemm_batched(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, int m, int n, int k, value_type alpha, const std::vector<concurrency::array_view<const value_type,2>>& a, const std::vector<concurrency::array_view<const value_type,2>>& b, value_type beta, const std::vector<concurrency::array_view<value_type,2>>& c)
+{
+    if (a.size() != c.size() || b.size() != c.size())
+        argument_error("gemm_batched: batch counts differ");
+
+    // quick return
+    if (c.empty() || m <= 0 || n <= 0)
+        return;
+
+    if (_detail::is_host_accelerator(av))
+    {
+        _detail::gemm_batched_host(transa, transb, m, n, k, alpha, a, b, beta, c);
+        return;
+    }
+
+    // views cannot be gathered into one kernel, so the items are queued one after another
+    for (size_t item = 0; item < c.size(); item++)
+        gemm(av, transa, transb, m, n, k, alpha, a[item], b[item], beta, c[item]);
+}
+
+} // namespace ampblas
+
+#endif // AMPBLAS_GEMM_BATCHED_H
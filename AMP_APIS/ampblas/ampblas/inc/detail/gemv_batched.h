@@ -0,0 +1,162 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemv_batched.h
+ *
+ * y[b] = alpha * op(A[b]) * x[b] + beta * y[b] for a batch of equally sized
+ * column major problems.
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_GEMV_BATCHED_H
+#define AMPBLAS_GEMV_BATCHED_H
+
+#include "ampblas_config.h"
+#include "ampblas_utility.h"
+
+#include "gemv.h"
+#include "host/batched.h"
+
+#include <vector>
+
+namespace ampblas {
+namespace _detail {
+
+//
+// Host path
+//
+
+template <typename value_type>
+void gemv_batched_host(enum class transpose transa, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& x, value_type beta, const batch_view<value_type>& y)
+{
+    const value_type* a_base = host::batch_data(a);
+    const value_type* x_base = host::batch_data(x);
+    value_type* y_base = host::batch_data(y);
+
+    host::batch_for(y.count, [&](int, int item)
+    {
+        const host::matrix_ref<const value_type> x_ref = host::make_matrix_ref(x, x_base, item);
+        const host::matrix_ref<value_type> y_ref = host::make_matrix_ref(y, y_base, item);
+
+        host::small_gemv(transa, a.rows, a.cols, alpha, host::make_matrix_ref(a, a_base, item),
+            [&](int i) -> const value_type& { return x_ref(i,0); }, beta,
+            [&](int i) -> value_type& { return y_ref(i,0); });
+    });
+}
+
+template <typename value_type, typename x_vector_type, typename y_vector_type>
+void gemv_batched_host(enum class transpose transa, value_type alpha, const std::vector<concurrency::array_view<const value_type,2>>& a, const std::vector<x_vector_type>& x, value_type beta, const std::vector<y_vector_type>& y)
+{
+    host::batch_for(static_cast<int>(y.size()), [&](int, int item)
+    {
+        const x_vector_type& x_item = x[item];
+        const y_vector_type& y_item = y[item];
+
+        // the views are column major, so the host reference is transposed
+        host::small_gemv(transa, a[item].extent[1], a[item].extent[0], alpha, host::make_matrix_ref(a[item]).transposed(),
+            [&](int i) -> const value_type& { return x_item[concurrency::index<1>(i)]; }, beta,
+            [&](int i) -> value_type& { return y_item[concurrency::index<1>(i)]; });
+    });
+}
+
+//
+// Accelerator path: one thread per element of every y
+//
+
+template <enum class transpose transa, typename value_type>
+void gemv_batched(const concurrency::accelerator_view& av, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& x, value_type beta, const batch_view<value_type>& y)
+{
+    const int len = x.rows;
+
+    concurrency::parallel_for_each(
+        av,
+        concurrency::extent<2>(y.count, y.rows),
+        [=] (concurrency::index<2> idx) restrict(amp)
+        {
+            const int item = idx[0];
+            const int i = idx[1];
+
+            value_type result = value_type();
+
+            for (int p = 0; p < len; ++p)
+            {
+                value_type a_value = (transa == transpose::no_trans ? a(item, i, p) : a(item, p, i));
+                if (transa == transpose::conj_trans)
+                    a_value = conjugate::op(a_value);
+
+                result += a_value * x(item, p);
+            }
+
+            value_type& y_value = y(item, i);
+            y_value = (beta == value_type() ? alpha * result : alpha * result + beta * y_value);
+        }
+    );
+}
+
+} // namespace _detail
+
+// strided batch; x and y are batches of vectors (cols == 1)
+template <typename value_type>
+void gemv_batched(const concurrency::accelerator_view& av, enum class transpose transa, value_type alpha, const batch_view<const value_type>& a, const batch_view<const value_type>& x, value_type beta, const batch_view<value_type>& y)
+{
+    if (a.count != y.count || x.count != y.count)
+        argument_error("gemv_batched: batch counts differ");
+    if (x.rows != (transa == transpose::no_trans ? a.cols : a.rows) || y.rows != (transa == transpose::no_trans ? a.rows : a.cols))
+        argument_error("gemv_batched: x and y do not match op(A)");
+
+    // quick return
+    if (y.count <= 0 || y.rows <= 0)
+        return;
+
+    if (_detail::is_host_accelerator(av))
+    {
+        _detail::gemv_batched_host(transa, alpha, a, x, beta, y);
+        return;
+    }
+
+    if (transa == transpose::no_trans)
+        _detail::gemv_batched<transpose::no_trans>(av, alpha, a, x, beta, y);
+    else if (transa == transpose::trans)
+        _detail::gemv_batched<transpose::trans>(av, alpha, a, x, beta, y);
+    else if (transa == transpose::conj_trans)
+        _detail::gemv_batched<transpose::conj_trans>(av, alpha, a, x, beta, y);
+}
+
+// batch of separate problems
+template <typename value_type, typename x_vector_type, typename y_vector_type>
+void gemv_batched(const concurrency::accelerator_view& av, enum class transpose transa, value_type alpha, const std::vector<concurrency::array_view<const value_type,2>>& a, const std::vector<x_vector_type>& x, value_type beta, std::vector<y_vector_type>& y)
+{
+    if (a.size() != y.size() || x.size() != y.size())
+        argument_error("gemv_batched: batch counts differ");
+
+    // quick return
+    if (y.empty())
+        return;
+
+    if (_detail::is_host_accelerator(av))
+    {
+        _detail::gemv_batched_host(transa, alpha, a, x, beta, y);
+        return;
+    }
+
+    // views cannot be gathered into one kernel, so the items are queued one after another
+    for (size_t item = 0; item < y.size(); item++)
+        gemv(av, transa, alpha, a[item], x[item], beta, y[item]);
+}
+
+} // namespace ampblas
+
+#endif // AMPBLAS_GEMV_BATCHED_H
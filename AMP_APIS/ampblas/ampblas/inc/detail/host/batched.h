@@ -0,0 +1,223 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * batched.h
+ *
+ * Host (CPU) kernels for batches of small problems. The items of a batch are
+ * split into contiguous runs, one per pool thread, and every item is solved
+ * start to finish by one thread so its operands stay in L1. Items too large
+ * for that are handed to the blocked host GEMM.
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_HOST_BATCHED_H
+#define AMPBLAS_HOST_BATCHED_H
+
+#include "ampblas_config.h"
+#include "utility/aligned_buffer.h"
+#include "utility/batch.h"
+#include "utility/complex.h"
+#include "utility/thread_pool.h"
+
+#include "gemm.h"
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+namespace host {
+
+// largest dimension solved by the small kernels; 64x64 doubles are 32KB
+static const int small_batch_limit = 64;
+
+// host address of the first element of a batch
+template <typename value_type>
+inline value_type* batch_data(const batch_view<value_type>& x)
+{
+    return &x.data[concurrency::index<1>(0)];
+}
+
+// host reference to item b of a batch, starting from its batch_data
+template <typename value_type>
+inline matrix_ref<value_type> make_matrix_ref(const batch_view<value_type>& x, value_type* base, int b)
+{
+    return matrix_ref<value_type>(base + x.offset + size_t(b) * x.stride, x.inc, x.ld);
+}
+
+// host reference to op(item b) of a batch
+template <typename value_type>
+inline matrix_ref<value_type> make_matrix_ref(const batch_view<value_type>& x, value_type* base, int b, enum class transpose trans)
+{
+    const matrix_ref<value_type> ref = make_matrix_ref(x, base, b);
+    return (trans == transpose::no_trans ? ref : ref.transposed());
+}
+
+// body(worker, item) for every item in [0, count), each worker taking one contiguous run
+template <typename function_type>
+void batch_for(int count, const function_type& body)
+{
+    thread_pool& pool = get_thread_pool();
+    const int workers = std::min(pool.concurrency(), count);
+
+    pool.parallel_for(0, workers, [&](int w)
+    {
+        const int begin = int((long long)(count) * w / workers);
+        const int end = int((long long)(count) * (w + 1) / workers);
+
+        for (int item = begin; item < end; item++)
+            body(w, item);
+    });
+}
+
+//
+// C = alpha * op(A) * op(B) + beta * C for one small item
+//   op(A) is packed column major once so the inner loop runs down contiguous
+//   columns of the packed copy and of C. a_pack holds m*k + m values.
+//
+template <typename value_type>
+void small_gemm(int m, int n, int k, const value_type& alpha, const matrix_ref<const value_type>& a, bool conj_a, const matrix_ref<const value_type>& b, bool conj_b, const value_type& beta, const matrix_ref<value_type>& c, value_type* a_pack)
+{
+    value_type* acc = a_pack + size_t(m) * k;
+
+    for (int p = 0; p < k; p++)
+        for (int i = 0; i < m; i++)
+            a_pack[p*m + i] = (conj_a ? conjugate::op(a(i,p)) : a(i,p));
+
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = 0; i < m; i++)
+            acc[i] = value_type();
+
+        for (int p = 0; p < k; p++)
+        {
+            const value_type b_pj = (conj_b ? conjugate::op(b(p,j)) : b(p,j));
+            const value_type* a_p = a_pack + size_t(p) * m;
+
+            for (int i = 0; i < m; i++)
+                acc[i] += a_p[i] * b_pj;
+        }
+
+        // beta == 0 must not read C
+        for (int i = 0; i < m; i++)
+            c(i,j) = (beta == value_type() ? alpha * acc[i] : alpha * acc[i] + beta * c(i,j));
+    }
+}
+
+// scratch values needed by small_gemm
+inline size_t small_gemm_scratch(int m, int k)
+{
+    return size_t(m) * k + m;
+}
+
+//
+// Solves op(A) * X = alpha * B for X, overwriting B with X
+//   a is op(A) through its strides; lower tells which triangle of op(A) holds the data.
+//
+template <typename value_type>
+void small_trsm_left(int m, int n, const value_type& alpha, const matrix_ref<const value_type>& a, bool conj_a, bool lower, bool unit, const matrix_ref<value_type>& b)
+{
+    for (int j = 0; j < n; j++)
+    {
+        if (lower)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                value_type x = alpha * b(i,j);
+                for (int p = 0; p < i; p++)
+                    x -= (conj_a ? conjugate::op(a(i,p)) : a(i,p)) * b(p,j);
+
+                if (!unit)
+                    x /= (conj_a ? conjugate::op(a(i,i)) : a(i,i));
+
+                b(i,j) = x;
+            }
+        }
+        else
+        {
+            for (int i = m - 1; i >= 0; i--)
+            {
+                value_type x = alpha * b(i,j);
+                for (int p = i + 1; p < m; p++)
+                    x -= (conj_a ? conjugate::op(a(i,p)) : a(i,p)) * b(p,j);
+
+                if (!unit)
+                    x /= (conj_a ? conjugate::op(a(i,i)) : a(i,i));
+
+                b(i,j) = x;
+            }
+        }
+    }
+}
+
+//
+// op(A) * X = alpha * B (left) or X * op(A) = alpha * B (right) for one item
+//   The right side is the left side solve of the transposed system.
+//
+template <typename value_type>
+void small_trsm(enum class side side, enum class uplo uplo, enum class transpose transa, enum class diag diag, int m, int n, const value_type& alpha, const matrix_ref<const value_type>& a, const matrix_ref<value_type>& b)
+{
+    const matrix_ref<const value_type> op_a = (transa == transpose::no_trans ? a : a.transposed());
+    const bool conj_a = (transa == transpose::conj_trans);
+    const bool unit = (diag == diag::unit);
+
+    // lower + no trans <==> upper + trans
+    const bool lower = ((uplo == uplo::lower) != (transa != transpose::no_trans));
+
+    if (side == side::left)
+        small_trsm_left(m, n, alpha, op_a, conj_a, lower, unit, b);
+    else
+        small_trsm_left(n, m, alpha, op_a.transposed(), conj_a, !lower, unit, b.transposed());
+}
+
+//
+// y = alpha * op(A) * x + beta * y for one item
+//   x and y are accessed through functors taking the element index.
+//
+template <typename value_type, typename x_type, typename y_type>
+void small_gemv(enum class transpose transa, int m, int n, const value_type& alpha, const matrix_ref<const value_type>& a, const x_type& x, const value_type& beta, const y_type& y)
+{
+    const bool conj_a = (transa == transpose::conj_trans);
+
+    if (transa == transpose::no_trans)
+    {
+        // y gathers columns of A
+        for (int i = 0; i < m; i++)
+            y(i) = (beta == value_type() ? value_type() : beta * y(i));
+
+        for (int j = 0; j < n; j++)
+        {
+            const value_type t = alpha * x(j);
+            for (int i = 0; i < m; i++)
+                y(i) += t * a(i,j);
+        }
+    }
+    else
+    {
+        // each y element is a dot product with a column of A
+        for (int j = 0; j < n; j++)
+        {
+            value_type sum = value_type();
+            for (int i = 0; i < m; i++)
+                sum += (conj_a ? conjugate::op(a(i,j)) : a(i,j)) * x(i);
+
+            y(j) = (beta == value_type() ? alpha * sum : alpha * sum + beta * y(j));
+        }
+    }
+}
+
+} // namespace host
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_HOST_BATCHED_H
@@ -0,0 +1,332 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemm.h
+ *
+ * Host (CPU) GEMM. Blocked for the cache hierarchy with packed A and B panels
+ * feeding the register tile micro-kernels in gemm_kernel.h:
+ *
+ *   for jc in n step nc                   B panel [kc x nc] in last level cache
+ *     for pc in k step kc
+ *       pack B panel                      (parallel over nr slivers)
+ *       for ic in m step mc               (parallel over m blocks x n slivers)
+ *         pack A block [mc x kc]          A block in L2
+ *         for jr in nc step nr            B sliver in L1
+ *           for ir in mc step mr
+ *             micro-kernel                C tile in registers
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_HOST_GEMM_H
+#define AMPBLAS_HOST_GEMM_H
+
+#include "ampblas_config.h"
+#include "utility/aligned_buffer.h"
+#include "utility/complex.h"
+#include "utility/thread_pool.h"
+
+#include "gemm_kernel.h"
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+namespace host {
+
+//
+// matrix_ref
+//   Host address of a matrix whose (i,j) element is ptr[i*row_stride + j*col_stride].
+//   Transposition only exchanges the strides.
+//
+template <typename value_type>
+struct matrix_ref
+{
+    matrix_ref(value_type* ptr, int row_stride, int col_stride)
+        : ptr(ptr), row_stride(row_stride), col_stride(col_stride)
+    {
+    }
+
+    value_type& operator()(int i, int j) const
+    {
+        return ptr[i*row_stride + j*col_stride];
+    }
+
+    matrix_ref transposed() const
+    {
+        return matrix_ref(ptr, col_stride, row_stride);
+    }
+
+    matrix_ref offset(int i, int j) const
+    {
+        return matrix_ref(&(*this)(i,j), row_stride, col_stride);
+    }
+
+    value_type* ptr;
+    int row_stride;
+    int col_stride;
+};
+
+template <typename value_type>
+inline matrix_ref<value_type> make_matrix_ref(value_type* ptr, int row_stride, int col_stride)
+{
+    return matrix_ref<value_type>(ptr, row_stride, col_stride);
+}
+
+// row major host view of a 2D array_view; the pitch is recovered from the address of the second row
+template <typename value_type>
+inline matrix_ref<value_type> make_matrix_ref(const concurrency::array_view<value_type,2>& x)
+{
+    value_type* ptr = &x(0,0);
+    const int pitch = (x.extent[0] > 1 ? static_cast<int>(&x(1,0) - ptr) : x.extent[1]);
+    return matrix_ref<value_type>(ptr, pitch, 1);
+}
+
+// host view of op(x) for a row major array_view
+template <typename value_type>
+inline matrix_ref<value_type> make_matrix_ref(const concurrency::array_view<value_type,2>& x, enum class transpose trans)
+{
+    matrix_ref<value_type> ref = make_matrix_ref(x);
+    return (trans == transpose::no_trans ? ref : ref.transposed());
+}
+
+inline int ceil_div(int a, int b)
+{
+    return (a + b - 1) / b;
+}
+
+//
+// Packing
+//
+
+// copies the [mb x kb] block of op(A) into mr row slivers (k-major), zero filling the last sliver
+template <int mr, typename value_type>
+void pack_a(int mb, int kb, const matrix_ref<const value_type>& a, bool conj, value_type* a_pack)
+{
+    for (int i0 = 0; i0 < mb; i0 += mr)
+    {
+        const int rows = std::min(mr, mb - i0);
+        for (int p = 0; p < kb; p++, a_pack += mr)
+        {
+            const value_type* src = &a(i0, p);
+            for (int i = 0; i < rows; i++)
+                a_pack[i] = (conj ? conjugate::op(src[i*a.row_stride]) : src[i*a.row_stride]);
+            for (int i = rows; i < mr; i++)
+                a_pack[i] = value_type();
+        }
+    }
+}
+
+// copies a [kb x nb] sliver of op(B) into k rows of nr values, zero filling past nb
+template <int nr, typename value_type>
+void pack_b(int kb, int nb, const matrix_ref<const value_type>& b, bool conj, value_type* b_pack)
+{
+    for (int p = 0; p < kb; p++, b_pack += nr)
+    {
+        const value_type* src = &b(p, 0);
+        for (int j = 0; j < nb; j++)
+            b_pack[j] = (conj ? conjugate::op(src[j*b.col_stride]) : src[j*b.col_stride]);
+        for (int j = nb; j < nr; j++)
+            b_pack[j] = value_type();
+    }
+}
+
+//
+// Cache blocking; the defaults come from the kernel and can be replaced by tuned values
+//
+struct gemm_blocking
+{
+    int mc;
+    int kc;
+    int nc;
+
+    gemm_blocking(int mc, int kc, int nc)
+        : mc(mc), kc(kc), nc(nc)
+    {
+    }
+};
+
+template <typename value_type>
+inline gemm_blocking default_gemm_blocking()
+{
+    typedef gemm_host_kernel<value_type> kernel;
+    return gemm_blocking(kernel::mc, kernel::kc, kernel::nc);
+}
+
+// mc must be a multiple of mr and nc of nr
+template <typename value_type>
+inline bool is_valid_gemm_blocking(const gemm_blocking& blocking)
+{
+    typedef gemm_host_kernel<value_type> kernel;
+    return blocking.mc > 0 && blocking.kc > 0 && blocking.nc > 0 && blocking.mc % kernel::mr == 0 && blocking.nc % kernel::nr == 0;
+}
+
+//
+// C = beta * C (the alpha == 0 and k == 0 cases); beta == 0 clears C without reading it
+//
+template <typename value_type>
+void scale(int m, int n, const value_type& beta, const matrix_ref<value_type>& c)
+{
+    if (beta == value_type(1))
+        return;
+
+    host_parallel_for(0, m, [&](int i)
+    {
+        for (int j = 0; j < n; j++)
+            c(i,j) = (beta == value_type() ? value_type() : beta * c(i,j));
+    });
+}
+
+//
+// C = alpha * op(A) * op(B) + beta * C
+//   op(A) is [m x k], op(B) is [k x n]; transposition is carried by the
+//   matrix_ref strides and conjugation by the conj flags.
+//
+template <typename value_type>
+void gemm(int m, int n, int k, const value_type& alpha, const matrix_ref<const value_type>& a, bool conj_a, const matrix_ref<const value_type>& b, bool conj_b, const value_type& beta, const matrix_ref<value_type>& c, const gemm_blocking& blocking)
+{
+    typedef gemm_host_kernel<value_type> kernel;
+
+    static const int mr = kernel::mr;
+    static const int nr = kernel::nr;
+    static_assert(kernel::mc % mr == 0, "host tuning error: mc must be a multiple of mr");
+    static_assert(kernel::nc % nr == 0, "host tuning error: nc must be a multiple of nr");
+
+    if (!is_valid_gemm_blocking<value_type>(blocking))
+        argument_error("gemm: invalid host blocking");
+
+    // quick return
+    if (m <= 0 || n <= 0)
+        return;
+
+    if (k <= 0 || alpha == value_type())
+    {
+        scale(m, n, beta, c);
+        return;
+    }
+
+    // the micro-kernels write rows of C; solve the transposed problem for column major C
+    if (c.col_stride != 1 && c.row_stride == 1)
+    {
+        gemm(n, m, k, alpha, b.transposed(), conj_b, a.transposed(), conj_a, beta, c.transposed(), blocking);
+        return;
+    }
+
+    thread_pool& pool = get_thread_pool();
+    const int threads = pool.concurrency();
+
+    const int mc = blocking.mc;
+    const int kc = std::min(blocking.kc, k);
+    const int nc = std::min(blocking.nc, ceil_div(n, nr) * nr);
+    const int m_blocks = ceil_div(m, mc);
+
+    // shared B panel, one A block and one edge tile per participating thread
+    aligned_buffer<value_type> b_pack(size_t(kc) * nc);
+    aligned_buffer<value_type> a_pack(size_t(threads) * mc * kc);
+    aligned_buffer<value_type> c_edge(size_t(threads) * mr * nr);
+
+    for (int jc = 0; jc < n; jc += nc)
+    {
+        const int nb = std::min(nc, n - jc);
+        const int slivers = ceil_div(nb, nr);
+
+        for (int pc = 0; pc < k; pc += kc)
+        {
+            const int kb = std::min(kc, k - pc);
+
+            // beta only applies to the first pass over k
+            const value_type beta_pass = (pc == 0 ? beta : value_type(1));
+
+            pool.parallel_for(0, slivers, [&](int s)
+            {
+                const int jr = s * nr;
+                pack_b<nr>(kb, std::min(nr, nb - jr), b.offset(pc, jc + jr), conj_b, b_pack.data() + size_t(s) * nr * kb);
+            });
+
+            // when m has fewer blocks than threads, also split the slivers so every thread has work
+            const int n_groups = std::max(1, std::min(slivers, threads / m_blocks));
+            const int items = m_blocks * n_groups;
+            const int workers = std::min(threads, items);
+
+            pool.parallel_for(0, workers, [&](int w)
+            {
+                value_type* a_block = a_pack.data() + size_t(w) * mc * kc;
+                value_type* edge = c_edge.data() + size_t(w) * mr * nr;
+                int packed_block = -1;
+
+                for (int item = w; item < items; item += workers)
+                {
+                    const int ib = item / n_groups;
+                    const int group = item % n_groups;
+
+                    const int ic = ib * mc;
+                    const int mb = std::min(mc, m - ic);
+
+                    if (packed_block != ib)
+                    {
+                        pack_a<mr>(mb, kb, a.offset(ic, pc), conj_a, a_block);
+                        packed_block = ib;
+                    }
+
+                    const int s_begin = (slivers * group) / n_groups;
+                    const int s_end = (slivers * (group + 1)) / n_groups;
+
+                    for (int s = s_begin; s < s_end; s++)
+                    {
+                        const int jr = s * nr;
+                        const int nbr = std::min(nr, nb - jr);
+                        const value_type* b_sliver = b_pack.data() + size_t(s) * nr * kb;
+
+                        for (int ir = 0; ir < mb; ir += mr)
+                        {
+                            const int mbr = std::min(mr, mb - ir);
+                            const value_type* a_sliver = a_block + size_t(ir) * kb;
+                            value_type* c_tile = &c(ic + ir, jc + jr);
+
+                            if (mbr == mr && nbr == nr && c.col_stride == 1)
+                            {
+                                kernel::run(kb, a_sliver, b_sliver, alpha, beta_pass, c_tile, c.row_stride);
+                            }
+                            else
+                            {
+                                // partial tile: compute into scratch and merge the valid part
+                                kernel::run(kb, a_sliver, b_sliver, value_type(1), value_type(), edge, nr);
+
+                                for (int i = 0; i < mbr; i++)
+                                {
+                                    for (int j = 0; j < nbr; j++)
+                                    {
+                                        value_type& c_ij = c_tile[i*c.row_stride + j*c.col_stride];
+                                        c_ij = (beta_pass == value_type() ? alpha*edge[i*nr+j] : alpha*edge[i*nr+j] + beta_pass*c_ij);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+template <typename value_type>
+void gemm(int m, int n, int k, const value_type& alpha, const matrix_ref<const value_type>& a, bool conj_a, const matrix_ref<const value_type>& b, bool conj_b, const value_type& beta, const matrix_ref<value_type>& c)
+{
+    gemm(m, n, k, alpha, a, conj_a, b, conj_b, beta, c, default_gemm_blocking<value_type>());
+}
+
+} // namespace host
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_HOST_GEMM_H
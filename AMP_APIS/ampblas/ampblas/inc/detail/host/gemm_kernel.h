@@ -0,0 +1,438 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemm_kernel.h
+ *
+ * Register tile micro-kernels and cache blocking parameters for the host GEMM.
+ *
+ * A micro-kernel computes an [mr x nr] block of C from a packed A sliver
+ * (k columns of mr contiguous values) and a packed B sliver (k rows of nr
+ * contiguous values):
+ *
+ *     C = alpha * A_sliver * B_sliver + beta * C
+ *
+ * C must have unit column stride; when beta is zero C is not read.
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_HOST_GEMM_KERNEL_H
+#define AMPBLAS_HOST_GEMM_KERNEL_H
+
+#include "ampblas_config.h"
+
+// instruction set used by the host kernels (FMA3 always accompanies AVX2 under MSVC)
+#if defined(__AVX512F__)
+#define AMPBLAS_HOST_AVX512
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define AMPBLAS_HOST_AVX2
+#endif
+
+#if defined(AMPBLAS_HOST_AVX512) || defined(AMPBLAS_HOST_AVX2)
+#include <immintrin.h>
+#endif
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+namespace host {
+
+//
+// Portable Kernel
+//   Plain C++ used for any type/instruction set without a SIMD kernel. The
+//   fixed trip counts let the compiler unroll and vectorize where it can.
+//
+
+template <typename value_type, int mr_, int nr_>
+struct generic_gemm_kernel
+{
+    static const int mr = mr_;
+    static const int nr = nr_;
+
+    static void run(int k, const value_type* a, const value_type* b, const value_type& alpha, const value_type& beta, value_type* c, int rs_c)
+    {
+        value_type ab[mr][nr];
+
+        for (int i = 0; i < mr; i++)
+            for (int j = 0; j < nr; j++)
+                ab[i][j] = value_type();
+
+        for (int p = 0; p < k; p++, a += mr, b += nr)
+        {
+            for (int i = 0; i < mr; i++)
+            {
+                const value_type a_ip = a[i];
+                for (int j = 0; j < nr; j++)
+                    ab[i][j] += a_ip * b[j];
+            }
+        }
+
+        const bool read_c = !(beta == value_type());
+        for (int i = 0; i < mr; i++)
+        {
+            for (int j = 0; j < nr; j++)
+            {
+                value_type& c_ij = c[i*rs_c + j];
+                c_ij = read_c ? alpha*ab[i][j] + beta*c_ij : alpha*ab[i][j];
+            }
+        }
+    }
+};
+
+#if defined(AMPBLAS_HOST_AVX512) || defined(AMPBLAS_HOST_AVX2)
+
+//
+// SIMD Abstraction
+//   The minimum set of operations needed by the real and complex kernels.
+//   Packed buffers are host_alignment aligned so packed loads are aligned;
+//   C is accessed unaligned.
+//
+
+template <typename real_type>
+struct simd;
+
+#if defined(AMPBLAS_HOST_AVX512)
+
+template <>
+struct simd<float>
+{
+    typedef __m512 reg;
+    static const int width = 16;
+
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg load(const float* p) { return _mm512_load_ps(p); }
+    static reg loadu(const float* p) { return _mm512_loadu_ps(p); }
+    static void storeu(float* p, reg x) { _mm512_storeu_ps(p, x); }
+    static reg broadcast(float x) { return _mm512_set1_ps(x); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static reg fmaddsub(reg a, reg b, reg c) { return _mm512_fmaddsub_ps(a, b, c); }
+    static reg swap_pairs(reg x) { return _mm512_permute_ps(x, 0xB1); }
+};
+
+template <>
+struct simd<double>
+{
+    typedef __m512d reg;
+    static const int width = 8;
+
+    static reg zero() { return _mm512_setzero_pd(); }
+    static reg load(const double* p) { return _mm512_load_pd(p); }
+    static reg loadu(const double* p) { return _mm512_loadu_pd(p); }
+    static void storeu(double* p, reg x) { _mm512_storeu_pd(p, x); }
+    static reg broadcast(double x) { return _mm512_set1_pd(x); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    static reg fmaddsub(reg a, reg b, reg c) { return _mm512_fmaddsub_pd(a, b, c); }
+    static reg swap_pairs(reg x) { return _mm512_permute_pd(x, 0x55); }
+};
+
+#else // AMPBLAS_HOST_AVX2
+
+template <>
+struct simd<float>
+{
+    typedef __m256 reg;
+    static const int width = 8;
+
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg load(const float* p) { return _mm256_load_ps(p); }
+    static reg loadu(const float* p) { return _mm256_loadu_ps(p); }
+    static void storeu(float* p, reg x) { _mm256_storeu_ps(p, x); }
+    static reg broadcast(float x) { return _mm256_set1_ps(x); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static reg fmaddsub(reg a, reg b, reg c) { return _mm256_fmaddsub_ps(a, b, c); }
+    static reg swap_pairs(reg x) { return _mm256_permute_ps(x, 0xB1); }
+};
+
+template <>
+struct simd<double>
+{
+    typedef __m256d reg;
+    static const int width = 4;
+
+    static reg zero() { return _mm256_setzero_pd(); }
+    static reg load(const double* p) { return _mm256_load_pd(p); }
+    static reg loadu(const double* p) { return _mm256_loadu_pd(p); }
+    static void storeu(double* p, reg x) { _mm256_storeu_pd(p, x); }
+    static reg broadcast(double x) { return _mm256_set1_pd(x); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static reg fmaddsub(reg a, reg b, reg c) { return _mm256_fmaddsub_pd(a, b, c); }
+    static reg swap_pairs(reg x) { return _mm256_permute_pd(x, 0x5); }
+};
+
+#endif // AMPBLAS_HOST_AVX512
+
+//
+// Real SIMD Kernel
+//   mr rows by nv vectors; each k step broadcasts one A value per row and
+//   issues mr*nv FMAs against the B vectors.
+//
+
+template <typename real_type, int mr_, int nv>
+struct simd_real_gemm_kernel
+{
+    typedef simd<real_type> v;
+    typedef typename v::reg reg;
+
+    static const int mr = mr_;
+    static const int nr = nv * v::width;
+
+    static void run(int k, const real_type* a, const real_type* b, const real_type& alpha, const real_type& beta, real_type* c, int rs_c)
+    {
+        reg acc[mr][nv];
+
+        for (int i = 0; i < mr; i++)
+            for (int j = 0; j < nv; j++)
+                acc[i][j] = v::zero();
+
+        for (int p = 0; p < k; p++, a += mr, b += nr)
+        {
+            reg b_reg[nv];
+            for (int j = 0; j < nv; j++)
+                b_reg[j] = v::load(b + j*v::width);
+
+            for (int i = 0; i < mr; i++)
+            {
+                const reg a_reg = v::broadcast(a[i]);
+                for (int j = 0; j < nv; j++)
+                    acc[i][j] = v::fmadd(a_reg, b_reg[j], acc[i][j]);
+            }
+        }
+
+        const reg alpha_reg = v::broadcast(alpha);
+        if (beta == real_type())
+        {
+            for (int i = 0; i < mr; i++)
+                for (int j = 0; j < nv; j++)
+                    v::storeu(c + i*rs_c + j*v::width, v::mul(alpha_reg, acc[i][j]));
+        }
+        else
+        {
+            const reg beta_reg = v::broadcast(beta);
+            for (int i = 0; i < mr; i++)
+            {
+                for (int j = 0; j < nv; j++)
+                {
+                    real_type* c_ij = c + i*rs_c + j*v::width;
+                    v::storeu(c_ij, v::fmadd(beta_reg, v::loadu(c_ij), v::mul(alpha_reg, acc[i][j])));
+                }
+            }
+        }
+    }
+};
+
+//
+// Complex SIMD Kernel
+//   Values are interleaved (re,im) pairs. The real and imaginary parts of
+//   each A value are broadcast separately and accumulated against the same B
+//   vector; the two partial sums are recombined once at the end:
+//
+//     (ar + i*ai) * (br + i*bi) = (ar*br - ai*bi) + i*(ar*bi + ai*br)
+//
+
+template <typename real_type, int mr_, int nv>
+struct simd_complex_gemm_kernel
+{
+    typedef simd<real_type> v;
+    typedef typename v::reg reg;
+    typedef complex<real_type> value_type;
+
+    static const int mr = mr_;
+    static const int nr = nv * v::width / 2;
+
+    // x * (s_re + i*s_im) for a vector of interleaved complex values
+    static reg scale(reg x, reg s_re, reg s_im)
+    {
+        return v::fmaddsub(x, s_re, v::mul(v::swap_pairs(x), s_im));
+    }
+
+    static void run(int k, const value_type* a_, const value_type* b_, const value_type& alpha, const value_type& beta, value_type* c_, int rs_c)
+    {
+        const real_type* a = reinterpret_cast<const real_type*>(a_);
+        const real_type* b = reinterpret_cast<const real_type*>(b_);
+        real_type* c = reinterpret_cast<real_type*>(c_);
+
+        reg acc_re[mr][nv];
+        reg acc_im[mr][nv];
+
+        for (int i = 0; i < mr; i++)
+        {
+            for (int j = 0; j < nv; j++)
+            {
+                acc_re[i][j] = v::zero();
+                acc_im[i][j] = v::zero();
+            }
+        }
+
+        for (int p = 0; p < k; p++, a += 2*mr, b += 2*nr)
+        {
+            reg b_reg[nv];
+            for (int j = 0; j < nv; j++)
+                b_reg[j] = v::load(b + j*v::width);
+
+            for (int i = 0; i < mr; i++)
+            {
+                const reg a_re = v::broadcast(a[2*i]);
+                const reg a_im = v::broadcast(a[2*i+1]);
+                for (int j = 0; j < nv; j++)
+                {
+                    acc_re[i][j] = v::fmadd(a_re, b_reg[j], acc_re[i][j]);
+                    acc_im[i][j] = v::fmadd(a_im, b_reg[j], acc_im[i][j]);
+                }
+            }
+        }
+
+        const reg one = v::broadcast(real_type(1));
+        const reg alpha_re = v::broadcast(alpha.real());
+        const reg alpha_im = v::broadcast(alpha.imag());
+        const bool read_c = !(beta == value_type());
+        const reg beta_re = v::broadcast(beta.real());
+        const reg beta_im = v::broadcast(beta.imag());
+
+        for (int i = 0; i < mr; i++)
+        {
+            for (int j = 0; j < nv; j++)
+            {
+                real_type* c_ij = c + 2*i*rs_c + j*v::width;
+
+                // even lanes: ar*br - ai*bi, odd lanes: ar*bi + ai*br
+                const reg ab = v::fmaddsub(acc_re[i][j], one, v::swap_pairs(acc_im[i][j]));
+                reg out = scale(ab, alpha_re, alpha_im);
+
+                if (read_c)
+                    out = v::add(out, scale(v::loadu(c_ij), beta_re, beta_im));
+
+                v::storeu(c_ij, out);
+            }
+        }
+    }
+};
+
+#endif // AMPBLAS_HOST_AVX512 || AMPBLAS_HOST_AVX2
+
+//
+// Kernel Selection
+//   Register tile (mr x nr) plus cache blocking: an [mc x kc] block of A is
+//   sized for L2, a [kc x nr] sliver of B for L1 and the [kc x nc] panel of B
+//   for the last level cache. mc is a multiple of mr and nc of nr.
+//
+
+template <typename value_type>
+struct gemm_host_kernel : generic_gemm_kernel<value_type, 4, 4>
+{
+    static const int mc = 64;
+    static const int kc = 256;
+    static const int nc = 1024;
+};
+
+#if defined(AMPBLAS_HOST_AVX512)
+
+template <>
+struct gemm_host_kernel<float> : simd_real_gemm_kernel<float, 12, 2>
+{
+    static const int mc = 144;
+    static const int kc = 256;
+    static const int nc = 3072;
+};
+
+template <>
+struct gemm_host_kernel<double> : simd_real_gemm_kernel<double, 12, 2>
+{
+    static const int mc = 96;
+    static const int kc = 256;
+    static const int nc = 2048;
+};
+
+template <>
+struct gemm_host_kernel<complex<float>> : simd_complex_gemm_kernel<float, 6, 2>
+{
+    static const int mc = 96;
+    static const int kc = 256;
+    static const int nc = 2048;
+};
+
+template <>
+struct gemm_host_kernel<complex<double>> : simd_complex_gemm_kernel<double, 6, 2>
+{
+    static const int mc = 48;
+    static const int kc = 256;
+    static const int nc = 1024;
+};
+
+#elif defined(AMPBLAS_HOST_AVX2)
+
+template <>
+struct gemm_host_kernel<float> : simd_real_gemm_kernel<float, 6, 2>
+{
+    static const int mc = 144;
+    static const int kc = 256;
+    static const int nc = 3072;
+};
+
+template <>
+struct gemm_host_kernel<double> : simd_real_gemm_kernel<double, 6, 2>
+{
+    static const int mc = 96;
+    static const int kc = 256;
+    static const int nc = 2048;
+};
+
+template <>
+struct gemm_host_kernel<complex<float>> : simd_complex_gemm_kernel<float, 3, 2>
+{
+    static const int mc = 96;
+    static const int kc = 256;
+    static const int nc = 2048;
+};
+
+template <>
+struct gemm_host_kernel<complex<double>> : simd_complex_gemm_kernel<double, 3, 2>
+{
+    static const int mc = 48;
+    static const int kc = 256;
+    static const int nc = 1024;
+};
+
+#else
+
+template <>
+struct gemm_host_kernel<float> : generic_gemm_kernel<float, 4, 8>
+{
+    static const int mc = 128;
+    static const int kc = 256;
+    static const int nc = 2048;
+};
+
+template <>
+struct gemm_host_kernel<double> : generic_gemm_kernel<double, 4, 8>
+{
+    static const int mc = 64;
+    static const int kc = 256;
+    static const int nc = 2048;
+};
+
+#endif
+
+} // namespace host
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_HOST_GEMM_KERNEL_H
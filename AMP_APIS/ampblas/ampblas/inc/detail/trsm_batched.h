@@ -0,0 +1,187 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * trsm_batched.h
+ *
+ * op(A[b]) * X[b] = alpha * B[b] or X[b] * op(A[b]) = alpha * B[b] for a
+ * batch of equally sized column major problems, overwriting B[b] with X[b].
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_TRSM_BATCHED_H
+#define AMPBLAS_TRSM_BATCHED_H
+
+#include "ampblas_config.h"
+#include "ampblas_utility.h"
+
+#include "trsm.h"
+#include "host/batched.h"
+
+#include <vector>
+
+namespace ampblas {
+namespace _detail {
+
+//
+// Host path: each item is solved by one thread
+//
+
+template <typename value_type>
+void trsm_batched_host(enum class side side, enum class uplo uplo, enum class transpose transa, enum class diag diag, value_type alpha, const batch_view<const value_type>& a, const batch_view<value_type>& b)
+{
+    const value_type* a_base = host::batch_data(a);
+    value_type* b_base = host::batch_data(b);
+
+    host::batch_for(b.count, [&](int, int item)
+    {
+        host::small_trsm(side, uplo, transa, diag, b.rows, b.cols, alpha, host::make_matrix_ref(a, a_base, item), host::make_matrix_ref(b, b_base, item));
+    });
+}
+
+template <typename value_type>
+void trsm_batched_host(enum class side side, enum class uplo uplo, enum class transpose transa, enum class diag diag, value_type alpha, const std::vector<concurrency::array_view<const value_type,2>>& a, const std::vector<concurrency::array_view<value_type,2>>& b)
+{
+    // the views are column major, so the host references are transposed
+    host::batch_for(static_cast<int>(b.size()), [&](int, int item)
+    {
+        host::small_trsm(side, uplo, transa, diag, b[item].extent[1], b[item].extent[0], alpha, host::make_matrix_ref(a[item]).transposed(), host::make_matrix_ref(b[item]).transposed());
+    });
+}
+
+//
+// Accelerator path: one thread per right hand side of every item
+//
+
+// element (i,j) of op(A)
+template <enum class transpose transa, typename value_type>
+inline value_type trsm_batched_op(const batch_view<const value_type>& a, int item, int i, int j) restrict(cpu, amp)
+{
+    const value_type value = (transa == transpose::no_trans ? a(item, i, j) : a(item, j, i));
+    return (transa == transpose::conj_trans ? conjugate::op(value) : value);
+}
+
+// left solves run down the columns of B, right solves along its rows
+template <bool left, enum class transpose transa, typename value_type>
+void trsm_batched(const concurrency::accelerator_view& av, bool lower, bool unit, value_type alpha, const batch_view<const value_type>& a, const batch_view<value_type>& b)
+{
+    // order of the triangular system and number of right hand sides per item
+    const int m = (left ? b.rows : b.cols);
+    const int n = (left ? b.cols : b.rows);
+
+    // a right side solve is the left side solve of the transposed system
+    const bool t_lower = (left ? lower : !lower);
+
+    concurrency::parallel_for_each(
+        av,
+        concurrency::extent<2>(b.count, n),
+        [=] (concurrency::index<2> idx) restrict(amp)
+        {
+            const int item = idx[0];
+            const int r = idx[1];
+
+            for (int s = 0; s < m; ++s)
+            {
+                const int i = (t_lower ? s : m - 1 - s);
+                const int p_begin = (t_lower ? 0 : i + 1);
+                const int p_end = (t_lower ? i : m);
+
+                value_type x = alpha * (left ? b(item, i, r) : b(item, r, i));
+
+                for (int p = p_begin; p < p_end; ++p)
+                {
+                    const value_type t_ip = (left ? trsm_batched_op<transa>(a, item, i, p) : trsm_batched_op<transa>(a, item, p, i));
+                    x -= t_ip * (left ? b(item, p, r) : b(item, r, p));
+                }
+
+                if (!unit)
+                    x /= trsm_batched_op<transa>(a, item, i, i);
+
+                if (left)
+                    b(item, i, r) = x;
+                else
+                    b(item, r, i) = x;
+            }
+        }
+    );
+}
+
+template <bool left, typename value_type>
+void trsm_batched(const concurrency::accelerator_view& av, enum class transpose transa, bool lower, bool unit, value_type alpha, const batch_view<const value_type>& a, const batch_view<value_type>& b)
+{
+    if (transa == transpose::no_trans)
+        trsm_batched<left, transpose::no_trans>(av, lower, unit, alpha, a, b);
+    else if (transa == transpose::trans)
+        trsm_batched<left, transpose::trans>(av, lower, unit, alpha, a, b);
+    else if (transa == transpose::conj_trans)
+        trsm_batched<left, transpose::conj_trans>(av, lower, unit, alpha, a, b);
+}
+
+} // namespace _detail
+
+// strided batch; A is [m x m] for a left side solve and [n x n] for a right side solve of the [m x n] B
+template <typename value_type>
+void trsm_batched(const concurrency::accelerator_view& av, enum class side side, enum class uplo uplo, enum class transpose transa, enum class diag diag, value_type alpha, const batch_view<const value_type>& a, const batch_view<value_type>& b)
+{
+    if (a.count != b.count)
+        argument_error("trsm_batched: batch counts differ");
+    if (a.rows != a.cols || a.rows != (side == side::left ? b.rows : b.cols))
+        argument_error("trsm_batched: A does not match B");
+
+    // quick return
+    if (b.count <= 0 || b.rows <= 0 || b.cols <= 0)
+        return;
+
+    if (_detail::is_host_accelerator(av))
+    {
+        _detail::trsm_batched_host(side, uplo, transa, diag, alpha, a, b);
+        return;
+    }
+
+    // lower + no trans <==> upper + trans
+    const bool lower = ((uplo == uplo::lower) != (transa != transpose::no_trans));
+    const bool unit = (diag == diag::unit);
+
+    if (side == side::left)
+        _detail::trsm_batched<true>(av, transa, lower, unit, alpha, a, b);
+    else
+        _detail::trsm_batched<false>(av, transa, lower, unit, alpha, a, b);
+}
+
+// batch of separate problems
+template <typename value_type>
+void trsm_batched(const concurrency::accelerator_view& av, enum class side side, enum class uplo uplo, enum class transpose transa, enum class diag diag, value_type alpha, const std::vector<concurrency::array_view<const value_type,2>>& a, const std::vector<concurrency::array_view<value_type,2>>& b)
+{
+    if (a.size() != b.size())
+        argument_error("trsm_batched: batch counts differ");
+
+    // quick return
+    if (b.empty())
+        return;
+
+    if (_detail::is_host_accelerator(av))
+    {
+        _detail::trsm_batched_host(side, uplo, transa, diag, alpha, a, b);
+        return;
+    }
+
+    // views cannot be gathered into one kernel, so the items are queued one after another
+    for (size_t item = 0; item < b.size(); item++)
+        trsm(av, side, uplo, transa, diag, alpha, a[item], b[item]);
+}
+
+} // namespace ampblas
+
+#endif // AMPBLAS_TRSM_BATCHED_H
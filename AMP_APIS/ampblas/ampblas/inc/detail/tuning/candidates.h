@@ -0,0 +1,119 @@
+#ifndef AMPBLAS_TUNE_CANDIDATES_H
+#define AMPBLAS_TUNE_CANDIDATES_H
+
+#include "gemm.h"
+
+#include <vector>
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+
+//
+// GEMM kernel candidates
+//
+// The kernel parameters are template arguments, so a tuning database can only
+// select between configurations compiled into the library. Candidate 0 is the
+// architecture table entry from *gemm.h; the others are generic shapes with a
+// 16x16 thread tile, which are valid for every transpose and fit the 32KB of
+// tile_static memory for all four precisions. Adding a configuration here
+// makes it visible to the gemm_profile tuning mode.
+//
+
+static const int gemm_tuning_candidate_count = 5;
+
+template <int block_m, int block_n, int block_k>
+struct gemm_generic_parameters
+{
+    // work block
+    static const int m_block = block_m;
+    static const int n_block = block_n;
+    static const int k_block = block_k;
+
+    // tile sizes
+    static const int m_c_tile = 16;
+    static const int n_c_tile = 16;
+
+    static const int m_a_tile = 16;
+    static const int n_a_tile = 16;
+
+    static const int m_b_tile = 16;
+    static const int n_b_tile = 16;
+
+    // shared memory padding
+    static const int use_padding = 1;
+};
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb, int index>
+struct gemm_tuning_candidate;
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+struct gemm_tuning_candidate<arch, value_type, transa, transb, 0> : gemm_tuning_parameters<arch, value_type, transa, transb> {};
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+struct gemm_tuning_candidate<arch, value_type, transa, transb, 1> : gemm_generic_parameters<16, 16, 16> {};
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+struct gemm_tuning_candidate<arch, value_type, transa, transb, 2> : gemm_generic_parameters<32, 32, 16> {};
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+struct gemm_tuning_candidate<arch, value_type, transa, transb, 3> : gemm_generic_parameters<64, 32, 16> {};
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+struct gemm_tuning_candidate<arch, value_type, transa, transb, 4> : gemm_generic_parameters<32, 64, 16> {};
+
+// the parameters of a tuning parameter set in database order
+template <typename tp>
+inline std::vector<int> gemm_parameter_list()
+{
+    const int values[] = { tp::m_block, tp::n_block, tp::k_block, tp::m_c_tile, tp::n_c_tile, tp::m_a_tile, tp::n_a_tile, tp::m_b_tile, tp::n_b_tile, tp::use_padding };
+    return std::vector<int>(values, values + sizeof(values)/sizeof(values[0]));
+}
+
+// runtime access to the candidate list
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb, int index = 0>
+struct gemm_candidate_list
+{
+    typedef gemm_tuning_candidate<arch, value_type, transa, transb, index> tp;
+    typedef gemm_candidate_list<arch, value_type, transa, transb, index + 1> next;
+
+    static std::vector<int> parameters(int candidate)
+    {
+        return (candidate == index ? gemm_parameter_list<tp>() : next::parameters(candidate));
+    }
+};
+
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+struct gemm_candidate_list<arch, value_type, transa, transb, gemm_tuning_candidate_count>
+{
+    static std::vector<int> parameters(int)
+    {
+        return std::vector<int>();
+    }
+};
+
+// the first candidate with the given parameters, or -1
+template <enum class architecture arch, typename value_type, enum class transpose transa, enum class transpose transb>
+inline int find_gemm_candidate(const std::vector<int>& parameters)
+{
+    for (int i = 0; i < gemm_tuning_candidate_count; i++)
+        if (gemm_candidate_list<arch, value_type, transa, transb>::parameters(i) == parameters)
+            return i;
+
+    return -1;
+}
+
+template <typename value_type, enum class transpose transa, enum class transpose transb>
+inline std::vector<int> gemm_candidate_parameters(enum class architecture arch, int candidate)
+{
+    if (arch == architecture::amd)
+        return gemm_candidate_list<architecture::amd, value_type, transa, transb>::parameters(candidate);
+    else if (arch == architecture::nvidia)
+        return gemm_candidate_list<architecture::nvidia, value_type, transa, transb>::parameters(candidate);
+    else
+        return gemm_candidate_list<architecture::unknown, value_type, transa, transb>::parameters(candidate);
+}
+
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_TUNE_CANDIDATES_H
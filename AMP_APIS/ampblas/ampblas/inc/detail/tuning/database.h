@@ -0,0 +1,407 @@
+#ifndef AMPBLAS_TUNE_DATABASE_H
+#define AMPBLAS_TUNE_DATABASE_H
+
+#include "tune.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <intrin.h>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+
+//
+// GEMM tuning database
+//
+// A text file of measured winners written by the gemm_profile tool. Each line
+// holds tab separated fields:
+//
+//   device  type  transa  transb  size  parameters  gflops
+//
+//   device      accelerator description (the SKU rather than the slot); the
+//               CPU accelerator has the same description on every machine, so
+//               host entries use the processor brand string, logical processor
+//               count and L2/L3 cache sizes instead
+//   type        BLAS prefix: s, d, c or z
+//   transa/b    n, t or c (row major, as seen by the kernels)
+//   size        small, medium or large
+//   parameters  space separated integers; for accelerators the ten kernel
+//               parameters m_block ... use_padding, for the CPU accelerator
+//               the host blocking mc kc nc
+//
+// Lines starting with '#' are comments. The database named by the
+// AMPBLAS_GEMM_TUNING_DATABASE environment variable is loaded on first use.
+//
+
+// BLAS type and transpose characters
+template <typename value_type> struct blas_prefix;
+template <> struct blas_prefix<float> { static const char value = 's'; };
+template <> struct blas_prefix<double> { static const char value = 'd'; };
+template <> struct blas_prefix<complex<float>> { static const char value = 'c'; };
+template <> struct blas_prefix<complex<double>> { static const char value = 'z'; };
+
+template <typename value_type>
+inline char transpose_prefix(enum class transpose trans)
+{
+    // conjugation is a noop for real types
+    const bool real = (blas_prefix<value_type>::value == 's' || blas_prefix<value_type>::value == 'd');
+
+    if (trans == transpose::no_trans)
+        return 'n';
+    else if (trans == transpose::trans || real)
+        return 't';
+    else
+        return 'c';
+}
+
+// coarse problem size buckets; the boundaries are the cube roots of m*n*k
+enum class gemm_size_class
+{
+    small,      // below 256^3
+    medium,     // below 1024^3
+    large
+};
+
+inline enum class gemm_size_class get_gemm_size_class(int m, int n, int k)
+{
+    const double volume = double(m) * double(n) * double(k);
+
+    if (volume < 256.0 * 256.0 * 256.0)
+        return gemm_size_class::small;
+    else if (volume < 1024.0 * 1024.0 * 1024.0)
+        return gemm_size_class::medium;
+    else
+        return gemm_size_class::large;
+}
+
+inline std::string gemm_size_class_name(enum class gemm_size_class size)
+{
+    switch (size)
+    {
+    case gemm_size_class::small:  return "small";
+    case gemm_size_class::medium: return "medium";
+    default:                      return "large";
+    }
+}
+
+inline bool parse_gemm_size_class(const std::string& name, enum class gemm_size_class& size)
+{
+    if (name == "small")
+        size = gemm_size_class::small;
+    else if (name == "medium")
+        size = gemm_size_class::medium;
+    else if (name == "large")
+        size = gemm_size_class::large;
+    else
+        return false;
+
+    return true;
+}
+
+// database keys are tab separated fields of plain ASCII
+inline std::string tuning_key_field(const std::wstring& text)
+{
+    std::string field;
+
+    for (auto it = text.begin(); it != text.end(); ++it)
+        field += (*it == L'\t' || *it == L'\n' || *it > 0x7f ? '_' : static_cast<char>(*it));
+
+    return field;
+}
+
+// cpuid register values of a leaf; eax, ebx, ecx, edx
+inline void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int (&regs)[4])
+{
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+
+    for (int i = 0; i < 4; i++)
+        regs[i] = static_cast<unsigned int>(values[i]);
+}
+
+// level 2 and 3 cache sizes in KB, zero where the processor does not report them
+inline void host_cache_sizes(unsigned int& l2_kb, unsigned int& l3_kb)
+{
+    unsigned int regs[4];
+    l2_kb = 0;
+    l3_kb = 0;
+
+    // deterministic cache parameters (Intel): ways * partitions * line size * sets
+    cpuid(0, 0, regs);
+    if (regs[0] >= 4)
+    {
+        for (unsigned int index = 0; index < 16; index++)
+        {
+            cpuid(4, index, regs);
+
+            const unsigned int type = regs[0] & 0x1f;
+            if (type == 0)
+                break;
+
+            const unsigned int level = (regs[0] >> 5) & 0x7;
+            const unsigned int bytes = (((regs[1] >> 22) & 0x3ff) + 1) * (((regs[1] >> 12) & 0x3ff) + 1) * ((regs[1] & 0xfff) + 1) * (regs[2] + 1);
+
+            // data or unified caches only
+            if (type == 2)
+                continue;
+            if (level == 2)
+                l2_kb = bytes / 1024;
+            else if (level == 3)
+                l3_kb = bytes / 1024;
+        }
+    }
+
+    // extended leaf (AMD, also reports L2 on Intel)
+    cpuid(0x80000000, 0, regs);
+    if (regs[0] >= 0x80000006)
+    {
+        cpuid(0x80000006, 0, regs);
+        if (l2_kb == 0)
+            l2_kb = regs[2] >> 16;
+        if (l3_kb == 0)
+            l3_kb = (regs[3] >> 18) * 512;
+    }
+}
+
+// database key of the host processor, e.g. "Intel(R) Core(TM) i7-4770 CPU @ 3.40GHz threads=8 l2=256KB l3=8192KB"
+inline std::string host_tuning_device_name()
+{
+    unsigned int regs[4];
+    std::string brand;
+
+    cpuid(0x80000000, 0, regs);
+    if (regs[0] >= 0x80000004)
+    {
+        char text[49] = {};
+        for (unsigned int leaf = 0; leaf < 3; leaf++)
+        {
+            cpuid(0x80000002 + leaf, 0, regs);
+            std::memcpy(text + 16*leaf, regs, sizeof(regs));
+        }
+        brand = text;
+    }
+
+    // the brand string is padded with spaces
+    const size_t first = brand.find_first_not_of(' ');
+    const size_t last = brand.find_last_not_of(' ');
+    brand = (first == std::string::npos ? std::string("unknown processor") : brand.substr(first, last - first + 1));
+
+    unsigned int l2_kb, l3_kb;
+    host_cache_sizes(l2_kb, l3_kb);
+
+    std::stringstream name;
+    name << tuning_key_field(std::wstring(brand.begin(), brand.end())) << " threads=" << std::thread::hardware_concurrency() << " l2=" << l2_kb << "KB l3=" << l3_kb << "KB";
+    return name.str();
+}
+
+// database key of an accelerator
+inline std::string tuning_device_name(const concurrency::accelerator& acc)
+{
+    if (acc.device_path == concurrency::accelerator::cpu_accelerator)
+    {
+        // the processor does not change while the process runs
+        static const std::string host_name = host_tuning_device_name();
+        return host_name;
+    }
+
+    return tuning_key_field(acc.get_description());
+}
+
+struct gemm_tuning_key
+{
+    std::string device;
+    char type;
+    char transa;
+    char transb;
+    enum class gemm_size_class size;
+
+    gemm_tuning_key()
+        : type('s'), transa('n'), transb('n'), size(gemm_size_class::large)
+    {
+    }
+
+    gemm_tuning_key(const std::string& device, char type, char transa, char transb, enum class gemm_size_class size)
+        : device(device), type(type), transa(transa), transb(transb), size(size)
+    {
+    }
+
+    bool operator<(const gemm_tuning_key& rhs) const
+    {
+        return std::make_tuple(device, type, transa, transb, int(size)) < std::make_tuple(rhs.device, rhs.type, rhs.transa, rhs.transb, int(rhs.size));
+    }
+};
+
+struct gemm_tuning_record
+{
+    std::vector<int> parameters;
+    double gflops;
+
+    gemm_tuning_record()
+        : gflops(0)
+    {
+    }
+
+    gemm_tuning_record(const std::vector<int>& parameters, double gflops)
+        : parameters(parameters), gflops(gflops)
+    {
+    }
+};
+
+class gemm_tuning_database
+{
+public:
+
+    // merges the records of a file into the database; false if the file could not be read
+    bool load(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        if (!file)
+            return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            gemm_tuning_key key;
+            gemm_tuning_record record;
+            if (parse_line(line, key, record))
+                records[key] = record;
+        }
+
+        return true;
+    }
+
+    bool save(const std::string& filename) const
+    {
+        std::ofstream file(filename);
+        if (!file)
+            return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        file << "# ampblas gemm tuning database" << std::endl;
+        file << "# device\ttype\ttransa\ttransb\tsize\tparameters\tgflops" << std::endl;
+
+        for (auto it = records.begin(); it != records.end(); ++it)
+        {
+            const gemm_tuning_key& key = it->first;
+            const gemm_tuning_record& record = it->second;
+
+            file << key.device << '\t' << key.type << '\t' << key.transa << '\t' << key.transb << '\t' << gemm_size_class_name(key.size) << '\t';
+            for (size_t i = 0; i < record.parameters.size(); i++)
+                file << (i ? " " : "") << record.parameters[i];
+            file << '\t' << record.gflops << std::endl;
+        }
+
+        return file.good();
+    }
+
+    void insert(const gemm_tuning_key& key, const gemm_tuning_record& record)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        records[key] = record;
+    }
+
+    // copies the record for key into record; false if there is none
+    bool find(const gemm_tuning_key& key, gemm_tuning_record& record) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = records.find(key);
+        if (it == records.end())
+            return false;
+
+        record = it->second;
+        return true;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        records.clear();
+    }
+
+private:
+
+    static bool parse_line(const std::string& line, gemm_tuning_key& key, gemm_tuning_record& record)
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t'))
+            fields.push_back(field);
+
+        if (fields.size() != 7 || fields[1].size() != 1 || fields[2].size() != 1 || fields[3].size() != 1)
+            return false;
+
+        key.device = fields[0];
+        key.type = fields[1][0];
+        key.transa = fields[2][0];
+        key.transb = fields[3][0];
+        if (!parse_gemm_size_class(fields[4], key.size))
+            return false;
+
+        std::stringstream parameters(fields[5]);
+        int value;
+        record.parameters.clear();
+        while (parameters >> value)
+            record.parameters.push_back(value);
+
+        std::stringstream gflops(fields[6]);
+        if (record.parameters.empty() || !(gflops >> record.gflops))
+            return false;
+
+        return true;
+    }
+
+    mutable std::mutex mutex;
+    std::map<gemm_tuning_key, gemm_tuning_record> records;
+};
+
+// process wide database, loaded from AMPBLAS_GEMM_TUNING_DATABASE on first use
+inline gemm_tuning_database& get_gemm_tuning_database()
+{
+    struct loaded_database : gemm_tuning_database
+    {
+        loaded_database()
+        {
+            const char* filename = std::getenv("AMPBLAS_GEMM_TUNING_DATABASE");
+            if (filename != nullptr && *filename != '\0')
+                load(filename);
+        }
+    };
+
+    static loaded_database database;
+    return database;
+}
+
+// looks up the tuned parameters of a gemm call on av; false if the problem has not been tuned
+template <typename value_type>
+inline bool find_gemm_tuning(const concurrency::accelerator_view& av, enum class transpose transa, enum class transpose transb, int m, int n, int k, std::vector<int>& parameters)
+{
+    const gemm_tuning_key key(tuning_device_name(av.accelerator), blas_prefix<value_type>::value, transpose_prefix<value_type>(transa), transpose_prefix<value_type>(transb), get_gemm_size_class(m, n, k));
+
+    gemm_tuning_record record;
+    if (!get_gemm_tuning_database().find(key, record))
+        return false;
+
+    parameters = record.parameters;
+    return true;
+}
+
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_TUNE_DATABASE_H
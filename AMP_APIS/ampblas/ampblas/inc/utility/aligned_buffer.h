@@ -0,0 +1,92 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * aligned_buffer.h
+ *
+ * Cache line aligned scratch storage for the host (CPU) execution paths
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_UTILITY_ALIGNED_BUFFER_H
+#define AMPBLAS_UTILITY_ALIGNED_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ampblas_config.h"
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+
+// a wide enough alignment for any SIMD load used by the host kernels (AVX-512)
+static const size_t host_alignment = 64;
+
+//
+// aligned_buffer
+//   Storage of value_type whose first element sits on a host_alignment
+//   boundary. Growing discards the previous contents.
+//
+template <typename value_type>
+class aligned_buffer
+{
+public:
+    aligned_buffer()
+        : ptr(nullptr), count(0)
+    {
+    }
+
+    explicit aligned_buffer(size_t n)
+        : ptr(nullptr), count(0)
+    {
+        reserve(n);
+    }
+
+    void reserve(size_t n)
+    {
+        if (n <= count)
+            return;
+
+        storage.resize(n * sizeof(value_type) + host_alignment);
+        const uintptr_t base = reinterpret_cast<uintptr_t>(storage.data());
+        const uintptr_t aligned = (base + host_alignment - 1) & ~uintptr_t(host_alignment - 1);
+        ptr = reinterpret_cast<value_type*>(aligned);
+        count = n;
+    }
+
+    value_type* data() const
+    {
+        return ptr;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+private:
+    aligned_buffer(const aligned_buffer&);
+    aligned_buffer& operator=(const aligned_buffer&);
+
+    std::vector<unsigned char> storage;
+    value_type* ptr;
+    size_t count;
+};
+
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_UTILITY_ALIGNED_BUFFER_H
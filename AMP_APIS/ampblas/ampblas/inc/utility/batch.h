@@ -0,0 +1,102 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * batch.h
+ *
+ * Strided batches of equally sized column major matrices or vectors stored
+ * in one buffer, as used by the *_batched routines
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_UTILITY_BATCH_H
+#define AMPBLAS_UTILITY_BATCH_H
+
+#include "ampblas_config.h"
+
+AMPBLAS_NAMESPACE_BEGIN
+
+//
+// batch_view
+//   count items of rows x cols elements. Element (i,j) of item b is
+//
+//     data[offset + b*stride + i*inc + j*ld]
+//
+//   Matrices are column major with inc == 1. Vectors have cols == 1 and may
+//   use a negative increment, in which case offset moves the first element to
+//   the end of the item as in BLAS.
+//
+template <typename value_type>
+struct batch_view
+{
+    batch_view(const concurrency::array_view<value_type,1>& data, int count, int rows, int cols, int ld, int stride, int inc = 1)
+        : data(data), count(count), rows(rows), cols(cols), ld(ld), stride(stride), inc(inc), offset(inc < 0 ? -(rows - 1) * inc : 0)
+    {
+    }
+
+    // read only view of a mutable batch
+    template <typename other_type>
+    batch_view(const batch_view<other_type>& other)
+        : data(other.data), count(other.count), rows(other.rows), cols(other.cols), ld(other.ld), stride(other.stride), inc(other.inc), offset(other.offset)
+    {
+    }
+
+    value_type& operator()(int b, int i, int j) const restrict(cpu, amp)
+    {
+        return data[concurrency::index<1>(offset + b*stride + i*inc + j*ld)];
+    }
+
+    value_type& operator()(int b, int i) const restrict(cpu, amp)
+    {
+        return data[concurrency::index<1>(offset + b*stride + i*inc)];
+    }
+
+    concurrency::array_view<value_type,1> data;
+    int count;
+    int rows;
+    int cols;
+    int ld;
+    int stride;
+    int inc;
+    int offset;
+};
+
+// number of elements spanned by a batch
+inline int batch_span(int count, int rows, int cols, int ld, int stride, int inc = 1)
+{
+    if (count <= 0 || rows <= 0 || cols <= 0)
+        return 0;
+
+    const int item = (cols - 1) * ld + (rows - 1) * (inc < 0 ? -inc : inc) + 1;
+    return (count - 1) * stride + item;
+}
+
+// batch of count column major [rows x cols] matrices, item b starting at data[b*stride]
+template <typename value_type>
+inline batch_view<value_type> make_batch_view(int count, int rows, int cols, const concurrency::array_view<value_type,1>& data, int ld, int stride)
+{
+    return batch_view<value_type>(data, count, rows, cols, ld, stride);
+}
+
+// batch of count vectors of length n with increment inc, item b starting at data[b*stride]
+template <typename value_type>
+inline batch_view<value_type> make_batch_vector_view(int count, int n, const concurrency::array_view<value_type,1>& data, int inc, int stride)
+{
+    return batch_view<value_type>(data, count, n, 1, 1, stride, inc);
+}
+
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_UTILITY_BATCH_H
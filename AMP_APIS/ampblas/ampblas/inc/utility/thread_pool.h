@@ -0,0 +1,212 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * thread_pool.h
+ *
+ * Persistent worker threads used by the host (CPU) execution paths
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef AMPBLAS_UTILITY_THREAD_POOL_H
+#define AMPBLAS_UTILITY_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ampblas_config.h"
+
+AMPBLAS_NAMESPACE_BEGIN
+DETAIL_NAMESPACE_BEGIN
+
+//
+// thread_pool
+//   A fixed set of workers which cooperatively execute the iterations of a
+//   parallel_for. The calling thread takes part in the loop, so a pool with
+//   n workers runs n+1 iterations at a time. Only one loop is in flight at a
+//   time; nested or concurrent loops are executed serially by their caller.
+//   ampfft keeps a copy of this pool (fft_thread_pool in amp_fft_host.h) so
+//   that it stays independent of ampblas and C++ AMP.
+//
+class thread_pool
+{
+public:
+    explicit thread_pool(unsigned int worker_count)
+        : generation(0), pending(0), stopping(false), next(0), limit(0)
+    {
+        for (unsigned int i = 0; i < worker_count; i++)
+            workers.push_back(std::thread(&thread_pool::worker_loop, this));
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (auto it = workers.begin(); it != workers.end(); ++it)
+            it->join();
+    }
+
+    // number of threads taking part in a parallel_for
+    int concurrency() const
+    {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    // executes body(i) for i in [begin, end)
+    template <typename function_type>
+    void parallel_for(int begin, int end, const function_type& body)
+    {
+        if (end <= begin)
+            return;
+
+        std::unique_lock<std::mutex> loop_lock(loop_mutex, std::try_to_lock);
+        if (end - begin == 1 || workers.empty() || !loop_lock.owns_lock())
+        {
+            for (int i = begin; i < end; i++)
+                body(i);
+            return;
+        }
+
+        job = [&body](int i) { body(i); };
+        error = nullptr;
+        limit = end;
+        next.store(begin);
+
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            pending = static_cast<int>(workers.size());
+            generation++;
+        }
+        wake.notify_all();
+
+        run_iterations();
+
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            done.wait(lock, [this] { return pending == 0; });
+        }
+
+        job = nullptr;
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    thread_pool(const thread_pool&);
+    thread_pool& operator=(const thread_pool&);
+
+    void worker_loop()
+    {
+        unsigned long long seen = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(state_mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            run_iterations();
+
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                if (--pending == 0)
+                    done.notify_one();
+            }
+        }
+    }
+
+    void run_iterations()
+    {
+        for (;;)
+        {
+            const int i = next.fetch_add(1);
+            if (i >= limit)
+                return;
+
+            try
+            {
+                job(i);
+            }
+            catch (...)
+            {
+                // keep the first exception and abandon the remaining iterations
+                std::lock_guard<std::mutex> lock(state_mutex);
+                if (!error)
+                    error = std::current_exception();
+                next.store(limit);
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+
+    // worker signalling
+    std::mutex state_mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned long long generation;
+    int pending;
+    bool stopping;
+
+    // current loop
+    std::mutex loop_mutex;
+    std::function<void(int)> job;
+    std::exception_ptr error;
+    std::atomic<int> next;
+    int limit;
+};
+
+// number of host threads: AMPBLAS_NUM_THREADS if set, otherwise one per hardware thread
+inline unsigned int host_thread_count()
+{
+    const char* env = std::getenv("AMPBLAS_NUM_THREADS");
+    if (env != nullptr && std::atoi(env) > 0)
+        return static_cast<unsigned int>(std::atoi(env));
+
+    const unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// process wide pool shared by all host routines
+inline thread_pool& get_thread_pool()
+{
+    static thread_pool pool(host_thread_count() - 1);
+    return pool;
+}
+
+template <typename function_type>
+inline void host_parallel_for(int begin, int end, const function_type& body)
+{
+    get_thread_pool().parallel_for(begin, end, body);
+}
+
+DETAIL_NAMESPACE_END
+AMPBLAS_NAMESPACE_END
+
+#endif // AMPBLAS_UTILITY_THREAD_POOL_H
@@ -578,6 +578,160 @@ AMPBLAS_DLL void ampblas_zher2k(const enum AMPBLAS_ORDER Order, const enum AMPBL
                                 const ampblas_dcomplex *alpha, const ampblas_dcomplex *A, const int lda,
                                 const ampblas_dcomplex *B, const int ldb, const double beta,
                                 ampblas_dcomplex *C, const int ldc);
+
+//----------------------------------------------------------------------------
+// Prototypes for batched BLAS
+//
+// The *_batched routines take arrays of batch_count matrix pointers; the
+// *_strided_batched routines take one pointer per operand with item i
+// starting stride elements after item i-1. A stride of 0 shares one A (or B,
+// or x) across the batch.
+//----------------------------------------------------------------------------
+
+AMPBLAS_DLL void ampblas_sgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                       const int K, const float alpha, const float* const A[],
+                                       const int lda, const float* const B[], const int ldb,
+                                       const float beta, float* const C[], const int ldc,
+                                       const int batch_count);
+AMPBLAS_DLL void ampblas_sgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                               const int K, const float alpha, const float *A,
+                                               const int lda, const int strideA, const float *B,
+                                               const int ldb, const int strideB, const float beta,
+                                               float *C, const int ldc, const int strideC,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_strsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                       const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                       const float alpha, const float* const A[], const int lda,
+                                       float* const B[], const int ldb, const int batch_count);
+AMPBLAS_DLL void ampblas_strsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                               const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                               const float alpha, const float *A, const int lda, const int strideA,
+                                               float *B, const int ldb, const int strideB,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_sgemv_batched(const enum AMPBLAS_ORDER order,
+                                       const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                       const float alpha, const float* const A[], const int lda,
+                                       const float* const X[], const int incX, const float beta,
+                                       float* const Y[], const int incY, const int batch_count);
+AMPBLAS_DLL void ampblas_sgemv_strided_batched(const enum AMPBLAS_ORDER order,
+                                               const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                               const float alpha, const float *A, const int lda, const int strideA,
+                                               const float *X, const int incX, const int strideX,
+                                               const float beta, float *Y, const int incY, const int strideY,
+                                               const int batch_count);
+
+AMPBLAS_DLL void ampblas_dgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                       const int K, const double alpha, const double* const A[],
+                                       const int lda, const double* const B[], const int ldb,
+                                       const double beta, double* const C[], const int ldc,
+                                       const int batch_count);
+AMPBLAS_DLL void ampblas_dgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                               const int K, const double alpha, const double *A,
+                                               const int lda, const int strideA, const double *B,
+                                               const int ldb, const int strideB, const double beta,
+                                               double *C, const int ldc, const int strideC,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_dtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                       const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                       const double alpha, const double* const A[], const int lda,
+                                       double* const B[], const int ldb, const int batch_count);
+AMPBLAS_DLL void ampblas_dtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                               const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                               const double alpha, const double *A, const int lda, const int strideA,
+                                               double *B, const int ldb, const int strideB,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_dgemv_batched(const enum AMPBLAS_ORDER order,
+                                       const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                       const double alpha, const double* const A[], const int lda,
+                                       const double* const X[], const int incX, const double beta,
+                                       double* const Y[], const int incY, const int batch_count);
+AMPBLAS_DLL void ampblas_dgemv_strided_batched(const enum AMPBLAS_ORDER order,
+                                               const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                               const double alpha, const double *A, const int lda, const int strideA,
+                                               const double *X, const int incX, const int strideX,
+                                               const double beta, double *Y, const int incY, const int strideY,
+                                               const int batch_count);
+
+AMPBLAS_DLL void ampblas_cgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                       const int K, const ampblas_fcomplex *alpha, const ampblas_fcomplex* const A[],
+                                       const int lda, const ampblas_fcomplex* const B[], const int ldb,
+                                       const ampblas_fcomplex *beta, ampblas_fcomplex* const C[], const int ldc,
+                                       const int batch_count);
+AMPBLAS_DLL void ampblas_cgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                               const int K, const ampblas_fcomplex *alpha, const ampblas_fcomplex *A,
+                                               const int lda, const int strideA, const ampblas_fcomplex *B,
+                                               const int ldb, const int strideB, const ampblas_fcomplex *beta,
+                                               ampblas_fcomplex *C, const int ldc, const int strideC,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_ctrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                       const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                       const ampblas_fcomplex *alpha, const ampblas_fcomplex* const A[], const int lda,
+                                       ampblas_fcomplex* const B[], const int ldb, const int batch_count);
+AMPBLAS_DLL void ampblas_ctrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                               const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                               const ampblas_fcomplex *alpha, const ampblas_fcomplex *A, const int lda, const int strideA,
+                                               ampblas_fcomplex *B, const int ldb, const int strideB,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_cgemv_batched(const enum AMPBLAS_ORDER order,
+                                       const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                       const ampblas_fcomplex *alpha, const ampblas_fcomplex* const A[], const int lda,
+                                       const ampblas_fcomplex* const X[], const int incX, const ampblas_fcomplex *beta,
+                                       ampblas_fcomplex* const Y[], const int incY, const int batch_count);
+AMPBLAS_DLL void ampblas_cgemv_strided_batched(const enum AMPBLAS_ORDER order,
+                                               const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                               const ampblas_fcomplex *alpha, const ampblas_fcomplex *A, const int lda, const int strideA,
+                                               const ampblas_fcomplex *X, const int incX, const int strideX,
+                                               const ampblas_fcomplex *beta, ampblas_fcomplex *Y, const int incY, const int strideY,
+                                               const int batch_count);
+
+AMPBLAS_DLL void ampblas_zgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                       const int K, const ampblas_dcomplex *alpha, const ampblas_dcomplex* const A[],
+                                       const int lda, const ampblas_dcomplex* const B[], const int ldb,
+                                       const ampblas_dcomplex *beta, ampblas_dcomplex* const C[], const int ldc,
+                                       const int batch_count);
+AMPBLAS_DLL void ampblas_zgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N,
+                                               const int K, const ampblas_dcomplex *alpha, const ampblas_dcomplex *A,
+                                               const int lda, const int strideA, const ampblas_dcomplex *B,
+                                               const int ldb, const int strideB, const ampblas_dcomplex *beta,
+                                               ampblas_dcomplex *C, const int ldc, const int strideC,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_ztrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                       const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                       const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                       const ampblas_dcomplex *alpha, const ampblas_dcomplex* const A[], const int lda,
+                                       ampblas_dcomplex* const B[], const int ldb, const int batch_count);
+AMPBLAS_DLL void ampblas_ztrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side,
+                                               const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA,
+                                               const enum AMPBLAS_DIAG Diag, const int M, const int N,
+                                               const ampblas_dcomplex *alpha, const ampblas_dcomplex *A, const int lda, const int strideA,
+                                               ampblas_dcomplex *B, const int ldb, const int strideB,
+                                               const int batch_count);
+AMPBLAS_DLL void ampblas_zgemv_batched(const enum AMPBLAS_ORDER order,
+                                       const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                       const ampblas_dcomplex *alpha, const ampblas_dcomplex* const A[], const int lda,
+                                       const ampblas_dcomplex* const X[], const int incX, const ampblas_dcomplex *beta,
+                                       ampblas_dcomplex* const Y[], const int incY, const int batch_count);
+AMPBLAS_DLL void ampblas_zgemv_strided_batched(const enum AMPBLAS_ORDER order,
+                                               const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N,
+                                               const ampblas_dcomplex *alpha, const ampblas_dcomplex *A, const int lda, const int strideA,
+                                               const ampblas_dcomplex *X, const int incX, const int strideX,
+                                               const ampblas_dcomplex *beta, ampblas_dcomplex *Y, const int incY, const int strideY,
+                                               const int batch_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -69,18 +69,20 @@ void gemm(enum AMPBLAS_ORDER order, enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_
 	auto b_mat = make_matrix_view(b_row, b_col, b, ldb);
 	auto c_mat = make_matrix_view(m, n, c, ldc);
     
-    // special cases
-	if (alpha == value_type())
+    const concurrency::accelerator_view av = get_current_accelerator_view();
+
+    // special cases (the host implementation handles these itself)
+	if (alpha == value_type() && !ampblas::_detail::is_host_accelerator(av))
 	{
 		if (beta == value_type())
-			ampblas::_detail::fill(get_current_accelerator_view(), c_mat.extent, value_type(), c_mat);
+			ampblas::_detail::fill(av, c_mat.extent, value_type(), c_mat);
 		else
-			ampblas::_detail::scale(get_current_accelerator_view(), c_mat.extent, beta, c_mat);
+			ampblas::_detail::scale(av, c_mat.extent, beta, c_mat);
 		return;
 	}
 
     // forward to ampblas
-    ampblas::gemm(get_current_accelerator_view(), cast(transa), cast(transb), alpha, a_mat, b_mat, beta, c_mat);
+    ampblas::gemm(av, cast(transa), cast(transb), alpha, a_mat, b_mat, beta, c_mat);
 }
 
 } // namespace ampcblas
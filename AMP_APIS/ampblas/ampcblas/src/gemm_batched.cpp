@@ -0,0 +1,234 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemm_batched.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+#include "ampcblas_config.h"
+
+#include "detail/gemm_batched.h"
+
+namespace ampcblas {
+
+// array of pointers
+template <typename value_type>
+void gemm_batched(enum AMPBLAS_ORDER order, enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_TRANSPOSE transb, int m, int n, int k, value_type alpha, const value_type* const a[], int lda, const value_type* const b[], int ldb, value_type beta, value_type* const c[], int ldc, int batch_count)
+{
+    // recursive order adjustment
+    if (order == AmpblasRowMajor)
+    {
+        gemm_batched(AmpblasColMajor, transb, transa, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc, batch_count);
+        return;
+    }
+
+    // quick return
+    if (batch_count == 0 || ((m == 0 || n == 0 || alpha == value_type() || k == 0) && beta == value_type(1)))
+        return;
+
+    // derived parameters
+    auto a_row = (transa == AmpblasNoTrans ? m : k);
+    auto a_col = (transa == AmpblasNoTrans ? k : m);
+    auto b_row = (transb == AmpblasNoTrans ? k : n);
+    auto b_col = (transb == AmpblasNoTrans ? n : k);
+
+    // error check
+    if (m < 0)
+        argument_error("gemm_batched", 4);
+    if (n < 0)
+        argument_error("gemm_batched", 5);
+    if (k < 0)
+        argument_error("gemm_batched", 6);
+    if (a == nullptr)
+        argument_error("gemm_batched", 8);
+    if (lda < a_row)
+        argument_error("gemm_batched", 9);
+    if (b == nullptr)
+        argument_error("gemm_batched", 10);
+    if (ldb < b_row)
+        argument_error("gemm_batched", 11);
+    if (c == nullptr)
+        argument_error("gemm_batched", 13);
+    if (ldc < m)
+        argument_error("gemm_batched", 14);
+    if (batch_count < 0)
+        argument_error("gemm_batched", 15);
+
+    // create views
+    std::vector<concurrency::array_view<const value_type,2>> a_mats;
+    std::vector<concurrency::array_view<const value_type,2>> b_mats;
+    std::vector<concurrency::array_view<value_type,2>> c_mats;
+
+    for (int i = 0; i < batch_count; i++)
+    {
+        if (a[i] == nullptr)
+            argument_error("gemm_batched", 8);
+        if (b[i] == nullptr)
+            argument_error("gemm_batched", 10);
+        if (c[i] == nullptr)
+            argument_error("gemm_batched", 13);
+
+        a_mats.push_back(make_matrix_view(a_row, a_col, a[i], lda));
+        b_mats.push_back(make_matrix_view(b_row, b_col, b[i], ldb));
+        c_mats.push_back(make_matrix_view(m, n, c[i], ldc));
+    }
+
+    const concurrency::accelerator_view av = get_current_accelerator_view();
+
+    // special cases (the host implementation handles these itself)
+    if (alpha == value_type() && !ampblas::_detail::is_host_accelerator(av))
+    {
+        for (int i = 0; i < batch_count; i++)
+        {
+            if (beta == value_type())
+                ampblas::_detail::fill(av, c_mats[i].extent, value_type(), c_mats[i]);
+            else
+                ampblas::_detail::scale(av, c_mats[i].extent, beta, c_mats[i]);
+        }
+        return;
+    }
+
+    // forward to templated routine
+    ampblas::gemm_batched(av, cast(transa), cast(transb), m, n, k, alpha, a_mats, b_mats, beta, c_mats);
+}
+
+// strided
+template <typename value_type>
+void gemm_strided_batched(enum AMPBLAS_ORDER order, enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_TRANSPOSE transb, int m, int n, int k, value_type alpha, const value_type* a, int lda, int stride_a, const value_type* b, int ldb, int stride_b, value_type beta, value_type* c, int ldc, int stride_c, int batch_count)
+{
+    // recursive order adjustment
+    if (order == AmpblasRowMajor)
+    {
+        gemm_strided_batched(AmpblasColMajor, transb, transa, n, m, k, alpha, b, ldb, stride_b, a, lda, stride_a, beta, c, ldc, stride_c, batch_count);
+        return;
+    }
+
+    // quick return
+    if (batch_count == 0 || m == 0 || n == 0 || ((alpha == value_type() || k == 0) && beta == value_type(1)))
+        return;
+
+    // derived parameters
+    auto a_row = (transa == AmpblasNoTrans ? m : k);
+    auto a_col = (transa == AmpblasNoTrans ? k : m);
+    auto b_row = (transb == AmpblasNoTrans ? k : n);
+    auto b_col = (transb == AmpblasNoTrans ? n : k);
+
+    // error check
+    if (m < 0)
+        argument_error("gemm_strided_batched", 4);
+    if (n < 0)
+        argument_error("gemm_strided_batched", 5);
+    if (k < 0)
+        argument_error("gemm_strided_batched", 6);
+    if (a == nullptr)
+        argument_error("gemm_strided_batched", 8);
+    if (lda < a_row)
+        argument_error("gemm_strided_batched", 9);
+    if (stride_a < 0)
+        argument_error("gemm_strided_batched", 10);
+    if (b == nullptr)
+        argument_error("gemm_strided_batched", 11);
+    if (ldb < b_row)
+        argument_error("gemm_strided_batched", 12);
+    if (stride_b < 0)
+        argument_error("gemm_strided_batched", 13);
+    if (c == nullptr)
+        argument_error("gemm_strided_batched", 15);
+    if (ldc < m)
+        argument_error("gemm_strided_batched", 16);
+    if (stride_c < ldc * n)
+        argument_error("gemm_strided_batched", 17);
+    if (batch_count < 0)
+        argument_error("gemm_strided_batched", 18);
+
+    // create views; a zero stride shares one A or B across the batch
+    const int a_span = ampblas::batch_span(batch_count, a_row, a_col, lda, stride_a);
+    const int b_span = ampblas::batch_span(batch_count, b_row, b_col, ldb, stride_b);
+    const int c_span = ampblas::batch_span(batch_count, m, n, ldc, stride_c);
+
+    const ampblas::batch_view<const value_type> a_batch = ampblas::make_batch_view(batch_count, a_row, a_col, get_array_view(a, std::max(a_span, 1)), lda, stride_a);
+    const ampblas::batch_view<const value_type> b_batch = ampblas::make_batch_view(batch_count, b_row, b_col, get_array_view(b, std::max(b_span, 1)), ldb, stride_b);
+    const ampblas::batch_view<value_type> c_batch = ampblas::make_batch_view(batch_count, m, n, get_array_view(c, c_span), ldc, stride_c);
+
+    // forward to templated routine; the batched kernels handle alpha == 0 themselves
+    ampblas::gemm_batched(get_current_accelerator_view(), cast(transa), cast(transb), alpha, a_batch, b_batch, beta, c_batch);
+}
+
+} // namespace ampcblas
+
+extern "C" {
+
+void ampblas_sgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float alpha, const float* const A[], const int lda, const float* const B[], const int ldb, const float beta, float* const C[], const int ldc, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_batched(Order, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, batch_count) );
+}
+
+void ampblas_dgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const double alpha, const double* const A[], const int lda, const double* const B[], const int ldb, const double beta, double* const C[], const int ldc, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_batched(Order, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, batch_count) );
+}
+
+void ampblas_cgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_fcomplex *alpha, const ampblas_fcomplex* const A[], const int lda, const ampblas_fcomplex* const B[], const int ldb, const ampblas_fcomplex *beta, ampblas_fcomplex* const C[], const int ldc, const int batch_count)
+{
+    using ampcblas::fcomplex;
+    using ampcblas::ampblas_cast;
+
+    const fcomplex calpha = *ampblas_cast(alpha);
+    const fcomplex cbeta = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_batched(Order, TransA, TransB, M, N, K, calpha, reinterpret_cast<const fcomplex* const*>(A), lda, reinterpret_cast<const fcomplex* const*>(B), ldb, cbeta, reinterpret_cast<fcomplex* const*>(C), ldc, batch_count) );
+}
+
+void ampblas_zgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_dcomplex *alpha, const ampblas_dcomplex* const A[], const int lda, const ampblas_dcomplex* const B[], const int ldb, const ampblas_dcomplex *beta, ampblas_dcomplex* const C[], const int ldc, const int batch_count)
+{
+    using ampcblas::dcomplex;
+    using ampcblas::ampblas_cast;
+
+    const dcomplex zalpha = *ampblas_cast(alpha);
+    const dcomplex zbeta = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_batched(Order, TransA, TransB, M, N, K, zalpha, reinterpret_cast<const dcomplex* const*>(A), lda, reinterpret_cast<const dcomplex* const*>(B), ldb, zbeta, reinterpret_cast<dcomplex* const*>(C), ldc, batch_count) );
+}
+
+void ampblas_sgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float alpha, const float *A, const int lda, const int strideA, const float *B, const int ldb, const int strideB, const float beta, float *C, const int ldc, const int strideC, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_strided_batched(Order, TransA, TransB, M, N, K, alpha, A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batch_count) );
+}
+
+void ampblas_dgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const double alpha, const double *A, const int lda, const int strideA, const double *B, const int ldb, const int strideB, const double beta, double *C, const int ldc, const int strideC, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_strided_batched(Order, TransA, TransB, M, N, K, alpha, A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batch_count) );
+}
+
+void ampblas_cgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_fcomplex *alpha, const ampblas_fcomplex *A, const int lda, const int strideA, const ampblas_fcomplex *B, const int ldb, const int strideB, const ampblas_fcomplex *beta, ampblas_fcomplex *C, const int ldc, const int strideC, const int batch_count)
+{
+    using ampcblas::fcomplex;
+    using ampcblas::ampblas_cast;
+
+    const fcomplex calpha = *ampblas_cast(alpha);
+    const fcomplex cbeta = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_strided_batched(Order, TransA, TransB, M, N, K, calpha, ampblas_cast(A), lda, strideA, ampblas_cast(B), ldb, strideB, cbeta, ampblas_cast(C), ldc, strideC, batch_count) );
+}
+
+void ampblas_zgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_dcomplex *alpha, const ampblas_dcomplex *A, const int lda, const int strideA, const ampblas_dcomplex *B, const int ldb, const int strideB, const ampblas_dcomplex *beta, ampblas_dcomplex *C, const int ldc, const int strideC, const int batch_count)
+{
+    using ampcblas::dcomplex;
+    using ampcblas::ampblas_cast;
+
+    const dcomplex zalpha = *ampblas_cast(alpha);
+    const dcomplex zbeta = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemm_strided_batched(Order, TransA, TransB, M, N, K, zalpha, ampblas_cast(A), lda, strideA, ampblas_cast(B), ldb, strideB, zbeta, ampblas_cast(C), ldc, strideC, batch_count) );
+}
+
+} // extern "C"
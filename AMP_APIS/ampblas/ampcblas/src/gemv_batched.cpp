@@ -0,0 +1,193 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemv_batched.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+#include "ampcblas_config.h"
+
+#include "detail/gemv_batched.h"
+
+namespace ampcblas {
+
+// array of pointers
+template <typename value_type>
+void gemv_batched(enum AMPBLAS_ORDER order, enum AMPBLAS_TRANSPOSE transa, int m, int n, value_type alpha, const value_type* const a[], int lda, const value_type* const x[], int incx, value_type beta, value_type* const y[], int incy, int batch_count)
+{
+    // quick return
+    if (m == 0 || n == 0 || batch_count == 0 || (alpha == value_type() && beta == value_type(1)))
+        return;
+
+    // error check
+    if (order != AmpblasColMajor)
+        feature_not_implemented();
+    if (m < 0)
+        argument_error("gemv_batched", 3);
+    if (n < 0)
+        argument_error("gemv_batched", 4);
+    if (a == nullptr)
+        argument_error("gemv_batched", 6);
+    if (lda < m)
+        argument_error("gemv_batched", 7);
+    if (x == nullptr)
+        argument_error("gemv_batched", 8);
+    if (y == nullptr)
+        argument_error("gemv_batched", 11);
+    if (batch_count < 0)
+        argument_error("gemv_batched", 13);
+
+    typedef decltype(make_vector_view(0, x[0], incx)) x_vector_type;
+    typedef decltype(make_vector_view(0, y[0], incy)) y_vector_type;
+
+    std::vector<concurrency::array_view<const value_type,2>> a_mats;
+    std::vector<x_vector_type> x_vecs;
+    std::vector<y_vector_type> y_vecs;
+
+    for (int i = 0; i < batch_count; i++)
+    {
+        if (a[i] == nullptr)
+            argument_error("gemv_batched", 6);
+        if (x[i] == nullptr)
+            argument_error("gemv_batched", 8);
+        if (y[i] == nullptr)
+            argument_error("gemv_batched", 11);
+
+        a_mats.push_back(make_matrix_view(m, n, a[i], lda));
+        x_vecs.push_back(make_vector_view((transa == AmpblasNoTrans ? n : m), x[i], incx));
+        y_vecs.push_back(make_vector_view((transa == AmpblasNoTrans ? m : n), y[i], incy));
+    }
+
+    ampblas::gemv_batched(get_current_accelerator_view(), cast(transa), alpha, a_mats, x_vecs, beta, y_vecs);
+}
+
+// strided
+template <typename value_type>
+void gemv_strided_batched(enum AMPBLAS_ORDER order, enum AMPBLAS_TRANSPOSE transa, int m, int n, value_type alpha, const value_type* a, int lda, int stride_a, const value_type* x, int incx, int stride_x, value_type beta, value_type* y, int incy, int stride_y, int batch_count)
+{
+    // quick return
+    if (m == 0 || n == 0 || batch_count == 0 || (alpha == value_type() && beta == value_type(1)))
+        return;
+
+    // derived parameters
+    const int x_len = (transa == AmpblasNoTrans ? n : m);
+    const int y_len = (transa == AmpblasNoTrans ? m : n);
+
+    // error check
+    if (order != AmpblasColMajor)
+        feature_not_implemented();
+    if (m < 0)
+        argument_error("gemv_strided_batched", 3);
+    if (n < 0)
+        argument_error("gemv_strided_batched", 4);
+    if (a == nullptr)
+        argument_error("gemv_strided_batched", 6);
+    if (lda < m)
+        argument_error("gemv_strided_batched", 7);
+    if (stride_a < 0)
+        argument_error("gemv_strided_batched", 8);
+    if (x == nullptr)
+        argument_error("gemv_strided_batched", 9);
+    if (incx == 0)
+        argument_error("gemv_strided_batched", 10);
+    if (stride_x < 0)
+        argument_error("gemv_strided_batched", 11);
+    if (y == nullptr)
+        argument_error("gemv_strided_batched", 13);
+    if (incy == 0)
+        argument_error("gemv_strided_batched", 14);
+    if (stride_y < (y_len - 1) * std::abs(incy) + 1)
+        argument_error("gemv_strided_batched", 15);
+    if (batch_count < 0)
+        argument_error("gemv_strided_batched", 16);
+
+    // amp data; a zero stride shares one A or x across the batch
+    const int a_span = ampblas::batch_span(batch_count, m, n, lda, stride_a);
+    const int x_span = ampblas::batch_span(batch_count, x_len, 1, 1, stride_x, incx);
+    const int y_span = ampblas::batch_span(batch_count, y_len, 1, 1, stride_y, incy);
+
+    const ampblas::batch_view<const value_type> a_batch = ampblas::make_batch_view(batch_count, m, n, get_array_view(a, a_span), lda, stride_a);
+    const ampblas::batch_view<const value_type> x_batch = ampblas::make_batch_vector_view(batch_count, x_len, get_array_view(x, x_span), incx, stride_x);
+    const ampblas::batch_view<value_type> y_batch = ampblas::make_batch_vector_view(batch_count, y_len, get_array_view(y, y_span), incy, stride_y);
+
+    ampblas::gemv_batched(get_current_accelerator_view(), cast(transa), alpha, a_batch, x_batch, beta, y_batch);
+}
+
+} // namespace ampcblas
+
+extern "C" {
+
+void ampblas_sgemv_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const float alpha, const float* const A[], const int lda, const float* const X[], const int incX, const float beta, float* const Y[], const int incY, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_batched(order, TransA, M, N, alpha, A, lda, X, incX, beta, Y, incY, batch_count) );
+}
+
+void ampblas_dgemv_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const double alpha, const double* const A[], const int lda, const double* const X[], const int incX, const double beta, double* const Y[], const int incY, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_batched(order, TransA, M, N, alpha, A, lda, X, incX, beta, Y, incY, batch_count) );
+}
+
+void ampblas_cgemv_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_fcomplex* alpha, const ampblas_fcomplex* const A[], const int lda, const ampblas_fcomplex* const X[], const int incX, const ampblas_fcomplex* beta, ampblas_fcomplex* const Y[], const int incY, const int batch_count)
+{
+    using ampcblas::fcomplex;
+    using ampcblas::ampblas_cast;
+
+    const fcomplex calpha = *ampblas_cast(alpha);
+    const fcomplex cbeta  = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_batched(order, TransA, M, N, calpha, reinterpret_cast<const fcomplex* const*>(A), lda, reinterpret_cast<const fcomplex* const*>(X), incX, cbeta, reinterpret_cast<fcomplex* const*>(Y), incY, batch_count) );
+}
+
+void ampblas_zgemv_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_dcomplex* alpha, const ampblas_dcomplex* const A[], const int lda, const ampblas_dcomplex* const X[], const int incX, const ampblas_dcomplex* beta, ampblas_dcomplex* const Y[], const int incY, const int batch_count)
+{
+    using ampcblas::dcomplex;
+    using ampcblas::ampblas_cast;
+
+    const dcomplex zalpha = *ampblas_cast(alpha);
+    const dcomplex zbeta  = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_batched(order, TransA, M, N, zalpha, reinterpret_cast<const dcomplex* const*>(A), lda, reinterpret_cast<const dcomplex* const*>(X), incX, zbeta, reinterpret_cast<dcomplex* const*>(Y), incY, batch_count) );
+}
+
+void ampblas_sgemv_strided_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const float alpha, const float *A, const int lda, const int strideA, const float *X, const int incX, const int strideX, const float beta, float *Y, const int incY, const int strideY, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_strided_batched(order, TransA, M, N, alpha, A, lda, strideA, X, incX, strideX, beta, Y, incY, strideY, batch_count) );
+}
+
+void ampblas_dgemv_strided_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const double alpha, const double *A, const int lda, const int strideA, const double *X, const int incX, const int strideX, const double beta, double *Y, const int incY, const int strideY, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_strided_batched(order, TransA, M, N, alpha, A, lda, strideA, X, incX, strideX, beta, Y, incY, strideY, batch_count) );
+}
+
+void ampblas_cgemv_strided_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_fcomplex* alpha, const ampblas_fcomplex *A, const int lda, const int strideA, const ampblas_fcomplex *X, const int incX, const int strideX, const ampblas_fcomplex* beta, ampblas_fcomplex *Y, const int incY, const int strideY, const int batch_count)
+{
+    using ampcblas::fcomplex;
+    using ampcblas::ampblas_cast;
+
+    const fcomplex calpha = *ampblas_cast(alpha);
+    const fcomplex cbeta  = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_strided_batched(order, TransA, M, N, calpha, ampblas_cast(A), lda, strideA, ampblas_cast(X), incX, strideX, cbeta, ampblas_cast(Y), incY, strideY, batch_count) );
+}
+
+void ampblas_zgemv_strided_batched(const enum AMPBLAS_ORDER order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_dcomplex* alpha, const ampblas_dcomplex *A, const int lda, const int strideA, const ampblas_dcomplex *X, const int incX, const int strideX, const ampblas_dcomplex* beta, ampblas_dcomplex *Y, const int incY, const int strideY, const int batch_count)
+{
+    using ampcblas::dcomplex;
+    using ampcblas::ampblas_cast;
+
+    const dcomplex zalpha = *ampblas_cast(alpha);
+    const dcomplex zbeta  = *ampblas_cast(beta);
+    AMPBLAS_CHECKED_CALL( ampcblas::gemv_strided_batched(order, TransA, M, N, zalpha, ampblas_cast(A), lda, strideA, ampblas_cast(X), incX, strideX, zbeta, ampblas_cast(Y), incY, strideY, batch_count) );
+}
+
+} // extern "C"
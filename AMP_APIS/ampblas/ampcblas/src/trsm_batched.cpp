@@ -0,0 +1,199 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * trsm_batched.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+#include "ampcblas_config.h"
+
+#include "detail/trsm_batched.h"
+
+namespace ampcblas {
+
+// array of pointers
+template <typename value_type>
+void trsm_batched(enum AMPBLAS_ORDER order, enum AMPBLAS_SIDE side, enum AMPBLAS_UPLO uplo, enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_DIAG diag, int m, int n, value_type alpha, const value_type* const a[], int lda, value_type* const b[], int ldb, int batch_count)
+{
+    // recursive order adjustment
+    if (order == AmpblasRowMajor)
+    {
+        trsm_batched(AmpblasColMajor, (side == AmpblasLeft ? AmpblasRight : AmpblasLeft), (uplo == AmpblasUpper ? AmpblasLower : AmpblasUpper), transa, diag, n, m, alpha, a, lda, b, ldb, batch_count);
+        return;
+    }
+
+    // quick return
+    if (m == 0 || n == 0 || batch_count == 0)
+        return;
+
+    // derived parameters
+    int k = (side == AmpblasLeft ? m : n);
+
+    // error check
+    if (m < 0)
+        argument_error("trsm_batched", 6);
+    if (n < 0)
+        argument_error("trsm_batched", 7);
+    if (a == nullptr)
+        argument_error("trsm_batched", 9);
+    if (lda < k)
+        argument_error("trsm_batched", 10);
+    if (b == nullptr)
+        argument_error("trsm_batched", 11);
+    if (ldb < m)
+        argument_error("trsm_batched", 12);
+    if (batch_count < 0)
+        argument_error("trsm_batched", 13);
+
+    // amp data
+    std::vector<concurrency::array_view<const value_type,2>> a_mats;
+    std::vector<concurrency::array_view<value_type,2>> b_mats;
+
+    for (int i = 0; i < batch_count; i++)
+    {
+        if (a[i] == nullptr)
+            argument_error("trsm_batched", 9);
+        if (b[i] == nullptr)
+            argument_error("trsm_batched", 11);
+
+        a_mats.push_back(make_matrix_view(k, k, a[i], lda));
+        b_mats.push_back(make_matrix_view(m, n, b[i], ldb));
+    }
+
+    const concurrency::accelerator_view av = get_current_accelerator_view();
+
+    // special paths
+    if (alpha == value_type() && !ampblas::_detail::is_host_accelerator(av))
+    {
+        for (int i = 0; i < batch_count; i++)
+            ampblas::_detail::fill(av, make_extent(m,n), value_type(), b_mats[i]);
+        return;
+    }
+
+    // implementation
+    ampblas::trsm_batched(av, cast(side), cast(uplo), cast(transa), cast(diag), alpha, a_mats, b_mats);
+}
+
+// strided
+template <typename value_type>
+void trsm_strided_batched(enum AMPBLAS_ORDER order, enum AMPBLAS_SIDE side, enum AMPBLAS_UPLO uplo, enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_DIAG diag, int m, int n, value_type alpha, const value_type* a, int lda, int stride_a, value_type* b, int ldb, int stride_b, int batch_count)
+{
+    // recursive order adjustment
+    if (order == AmpblasRowMajor)
+    {
+        trsm_strided_batched(AmpblasColMajor, (side == AmpblasLeft ? AmpblasRight : AmpblasLeft), (uplo == AmpblasUpper ? AmpblasLower : AmpblasUpper), transa, diag, n, m, alpha, a, lda, stride_a, b, ldb, stride_b, batch_count);
+        return;
+    }
+
+    // quick return
+    if (m == 0 || n == 0 || batch_count == 0)
+        return;
+
+    // derived parameters
+    int k = (side == AmpblasLeft ? m : n);
+
+    // error check
+    if (m < 0)
+        argument_error("trsm_strided_batched", 6);
+    if (n < 0)
+        argument_error("trsm_strided_batched", 7);
+    if (a == nullptr)
+        argument_error("trsm_strided_batched", 9);
+    if (lda < k)
+        argument_error("trsm_strided_batched", 10);
+    if (stride_a < 0)
+        argument_error("trsm_strided_batched", 11);
+    if (b == nullptr)
+        argument_error("trsm_strided_batched", 12);
+    if (ldb < m)
+        argument_error("trsm_strided_batched", 13);
+    if (stride_b < ldb * n)
+        argument_error("trsm_strided_batched", 14);
+    if (batch_count < 0)
+        argument_error("trsm_strided_batched", 15);
+
+    // amp data; a zero stride shares one A across the batch
+    const int a_span = ampblas::batch_span(batch_count, k, k, lda, stride_a);
+    const int b_span = ampblas::batch_span(batch_count, m, n, ldb, stride_b);
+
+    const ampblas::batch_view<const value_type> a_batch = ampblas::make_batch_view(batch_count, k, k, get_array_view(a, a_span), lda, stride_a);
+    const ampblas::batch_view<value_type> b_batch = ampblas::make_batch_view(batch_count, m, n, get_array_view(b, b_span), ldb, stride_b);
+
+    // implementation
+    ampblas::trsm_batched(get_current_accelerator_view(), cast(side), cast(uplo), cast(transa), cast(diag), alpha, a_batch, b_batch);
+}
+
+} // namespace ampcblas
+
+extern "C" {
+
+void ampblas_strsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const float alpha, const float* const A[], const int lda, float* const B[], const int ldb, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_batched(Order, Side, Uplo, TransA, Diag, M, N, alpha, A, lda, B, ldb, batch_count) );
+}
+
+void ampblas_dtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const double alpha, const double* const A[], const int lda, double* const B[], const int ldb, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_batched(Order, Side, Uplo, TransA, Diag, M, N, alpha, A, lda, B, ldb, batch_count) );
+}
+
+void ampblas_ctrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_fcomplex *alpha, const ampblas_fcomplex* const A[], const int lda, ampblas_fcomplex* const B[], const int ldb, const int batch_count)
+{
+    using ampcblas::fcomplex;
+    using ampcblas::ampblas_cast;
+
+    const fcomplex calpha = *ampblas_cast(alpha);
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_batched(Order, Side, Uplo, TransA, Diag, M, N, calpha, reinterpret_cast<const fcomplex* const*>(A), lda, reinterpret_cast<fcomplex* const*>(B), ldb, batch_count) );
+}
+
+void ampblas_ztrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_dcomplex *alpha, const ampblas_dcomplex* const A[], const int lda, ampblas_dcomplex* const B[], const int ldb, const int batch_count)
+{
+    using ampcblas::dcomplex;
+    using ampcblas::ampblas_cast;
+
+    const dcomplex zalpha = *ampblas_cast(alpha);
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_batched(Order, Side, Uplo, TransA, Diag, M, N, zalpha, reinterpret_cast<const dcomplex* const*>(A), lda, reinterpret_cast<dcomplex* const*>(B), ldb, batch_count) );
+}
+
+void ampblas_strsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const float alpha, const float *A, const int lda, const int strideA, float *B, const int ldb, const int strideB, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N, alpha, A, lda, strideA, B, ldb, strideB, batch_count) );
+}
+
+void ampblas_dtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const double alpha, const double *A, const int lda, const int strideA, double *B, const int ldb, const int strideB, const int batch_count)
+{
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N, alpha, A, lda, strideA, B, ldb, strideB, batch_count) );
+}
+
+void ampblas_ctrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_fcomplex *alpha, const ampblas_fcomplex *A, const int lda, const int strideA, ampblas_fcomplex *B, const int ldb, const int strideB, const int batch_count)
+{
+    using ampcblas::fcomplex;
+    using ampcblas::ampblas_cast;
+
+    const fcomplex calpha = *ampblas_cast(alpha);
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N, calpha, ampblas_cast(A), lda, strideA, ampblas_cast(B), ldb, strideB, batch_count) );
+}
+
+void ampblas_ztrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_dcomplex *alpha, const ampblas_dcomplex *A, const int lda, const int strideA, ampblas_dcomplex *B, const int ldb, const int strideB, const int batch_count)
+{
+    using ampcblas::dcomplex;
+    using ampcblas::ampblas_cast;
+
+    const dcomplex zalpha = *ampblas_cast(alpha);
+    AMPBLAS_CHECKED_CALL( ampcblas::trsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N, zalpha, ampblas_cast(A), lda, strideA, ampblas_cast(B), ldb, strideB, batch_count) );
+}
+
+} // extern "C"
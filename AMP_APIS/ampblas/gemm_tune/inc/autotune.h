@@ -0,0 +1,18 @@
+#ifndef AMPBLAS_GEMM_PROFILE_AUTOTUNE_H
+#define AMPBLAS_GEMM_PROFILE_AUTOTUNE_H
+
+#include <string>
+
+#include "tune.h"
+
+TUNE_NAMESPACE_BEGIN
+
+// Times the kernel candidates compiled into ampblas on the default accelerator
+// and a sweep of host blocking sizes on the CPU accelerator, then merges the
+// winners for every (type, transa, transb, size class) into the tuning
+// database file. Returns false if the file could not be written.
+bool build_database(const std::string& filename);
+
+TUNE_NAMESPACE_END
+
+#endif // AMPBLAS_GEMM_PROFILE_AUTOTUNE_H
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "tune.h"
+#include "autotune.h"
+#include "high_resolution_timer.h"
+
+// use the GEMM implementation from actual AMPBLAS project
+#include "detail/gemm.h"
+
+TUNE_NAMESPACE_BEGIN
+
+using ampblas::_detail::gemm_size_class;
+using ampblas::_detail::gemm_tuning_database;
+using ampblas::_detail::gemm_tuning_key;
+using ampblas::_detail::gemm_tuning_record;
+
+// square problem timed for each size class
+inline int representative_size(enum class gemm_size_class size)
+{
+    switch (size)
+    {
+    case gemm_size_class::small:  return 128;
+    case gemm_size_class::medium: return 512;
+    default:                      return 1536;
+    }
+}
+
+// deterministic data in [-1,1]
+template <typename value_type>
+void fill_data(std::vector<value_type>& x, int seed)
+{
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = value_type(float((i * 7919 + seed * 104729) % 2001) / 1000.0f - 1.0f);
+}
+
+template <typename value_type>
+double gflops(int n, double seconds)
+{
+    return double(gemm_flops_multiplier<value_type>::value) * double(n) * double(n) * double(n) / (seconds * 1e9);
+}
+
+// best of batch_size timed runs after a warm up run
+template <typename function_type>
+double time_best(const function_type& f)
+{
+    high_resolution_timer timer;
+    double best = std::numeric_limits<double>::max();
+
+    f();
+    for (int i = 0; i < batch_size; i++)
+    {
+        timer.restart();
+        f();
+        best = std::min(best, timer.elapsed());
+    }
+
+    return best;
+}
+
+//
+// accelerator: every compiled kernel candidate
+//
+
+template <typename value_type, enum class transpose transa, enum class transpose transb>
+void tune_accelerator(const concurrency::accelerator_view& av, enum class gemm_size_class size, gemm_tuning_database& database)
+{
+    typedef typename ampblas::real_type<value_type>::type real_type;
+
+    const int n = representative_size(size);
+    const value_type alpha = value_type(1);
+    const value_type beta = value_type(0);
+
+    std::vector<value_type> a(n*n), b(n*n), c(n*n), c_first(n*n), c_host(n*n);
+    fill_data(a, 1);
+    fill_data(b, 2);
+
+    concurrency::array<value_type,2> a_array(n, n, a.begin(), av);
+    concurrency::array<value_type,2> b_array(n, n, b.begin(), av);
+    concurrency::array<value_type,2> c_array(n, n, c.begin(), av);
+
+    concurrency::array_view<const value_type,2> a_view(a_array);
+    concurrency::array_view<const value_type,2> b_view(b_array);
+    concurrency::array_view<value_type,2> c_view(c_array);
+
+    std::wstring description = av.accelerator.get_description();
+    const enum class ampblas::_detail::architecture arch = ampblas::_detail::get_architecture(description);
+
+    int best_candidate = -1;
+    double best_gflops = 0;
+
+    for (int candidate = 0; candidate < ampblas::_detail::gemm_tuning_candidate_count; candidate++)
+    {
+        try
+        {
+            const double seconds = time_best([&]
+            {
+                ampblas::_detail::gemm_stage_2(av, transa, transb, alpha, a_view, b_view, beta, c_view, candidate);
+                av.wait();
+            });
+
+            // every candidate must agree with the first one
+            concurrency::copy(c_array, c_host.begin());
+            if (candidate == 0)
+                c_first = c_host;
+
+            using std::abs;
+            real_type error = 0;
+            for (int i = 0; i < n*n; i++)
+                error = std::max(error, real_type(abs(c_host[i] - c_first[i])));
+
+            const double rate = gflops<value_type>(n, seconds);
+            std::cout << type_prefix<value_type>::value << "gemm_" << trans_prefix<transa>::value << trans_prefix<transb>::value << "," << n << ",candidate " << candidate << "," << rate;
+
+            if (error > std::numeric_limits<real_type>::epsilon() * n * 16)
+            {
+                std::cout << ",accuracy failure" << std::endl;
+                continue;
+            }
+
+            std::cout << std::endl;
+
+            if (rate > best_gflops)
+            {
+                best_gflops = rate;
+                best_candidate = candidate;
+            }
+        }
+        catch (const concurrency::runtime_exception& e)
+        {
+            std::cout << "C++ AMP Runtime Exception for candidate " << candidate << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (best_candidate >= 0)
+    {
+        const gemm_tuning_key key(ampblas::_detail::tuning_device_name(av.accelerator), type_prefix<value_type>::value, trans_prefix<transa>::value, trans_prefix<transb>::value, size);
+        database.insert(key, gemm_tuning_record(ampblas::_detail::gemm_candidate_parameters<value_type, transa, transb>(arch, best_candidate), best_gflops));
+    }
+}
+
+//
+// CPU accelerator: host cache blocking
+//
+
+template <typename value_type>
+void tune_host(const concurrency::accelerator_view& av, enum class gemm_size_class size, gemm_tuning_database& database)
+{
+    namespace host = ampblas::_detail::host;
+    typedef ampblas::_detail::gemm_host_kernel<value_type> kernel;
+
+    const int n = representative_size(size);
+    const value_type alpha = value_type(1);
+    const value_type beta = value_type(0);
+
+    std::vector<value_type> a(n*n), b(n*n), c(n*n);
+    fill_data(a, 1);
+    fill_data(b, 2);
+
+    const host::matrix_ref<const value_type> a_ref(a.data(), n, 1);
+    const host::matrix_ref<const value_type> b_ref(b.data(), n, 1);
+    const host::matrix_ref<value_type> c_ref(c.data(), n, 1);
+
+    // multiples of the register tile around the built in defaults
+    const int mc_tiles[] = { 4, 8, 16, 24 };
+    const int kc_values[] = { 128, 256, 384, 512 };
+    const int nc_tiles[] = { 64, 128, 256 };
+
+    host::gemm_blocking best(kernel::mc, kernel::kc, kernel::nc);
+    double best_gflops = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int p = 0; p < 4; p++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                const host::gemm_blocking blocking(mc_tiles[i] * kernel::mr, kc_values[p], nc_tiles[j] * kernel::nr);
+
+                const double seconds = time_best([&]
+                {
+                    host::gemm(n, n, n, alpha, a_ref, false, b_ref, false, beta, c_ref, blocking);
+                });
+
+                const double rate = gflops<value_type>(n, seconds);
+                std::cout << type_prefix<value_type>::value << "gemm_host," << n << "," << blocking.mc << "," << blocking.kc << "," << blocking.nc << "," << rate << std::endl;
+
+                if (rate > best_gflops)
+                {
+                    best_gflops = rate;
+                    best = blocking;
+                }
+            }
+        }
+    }
+
+    // keyed by the processor, the CPU accelerator description is the same on every machine
+    const std::string device = ampblas::_detail::tuning_device_name(av.accelerator);
+
+    // packing absorbs the transposes, so one sweep serves every transpose key
+    const char trans[] = { 'n', 't', 'c' };
+    const int trans_count = (type_prefix<value_type>::value == 's' || type_prefix<value_type>::value == 'd' ? 2 : 3);
+
+    std::vector<int> parameters;
+    parameters.push_back(best.mc);
+    parameters.push_back(best.kc);
+    parameters.push_back(best.nc);
+
+    for (int ta = 0; ta < trans_count; ta++)
+        for (int tb = 0; tb < trans_count; tb++)
+            database.insert(gemm_tuning_key(device, type_prefix<value_type>::value, trans[ta], trans[tb], size), gemm_tuning_record(parameters, best_gflops));
+}
+
+template <typename value_type>
+void tune_type(const concurrency::accelerator_view& av, gemm_tuning_database& database)
+{
+    const enum class gemm_size_class sizes[] = { gemm_size_class::small, gemm_size_class::medium, gemm_size_class::large };
+
+    for (int s = 0; s < 3; s++)
+    {
+        if (ampblas::_detail::is_host_accelerator(av))
+        {
+            tune_host<value_type>(av, sizes[s], database);
+            continue;
+        }
+
+        tune_accelerator<value_type, transpose::no_trans, transpose::no_trans>(av, sizes[s], database);
+        tune_accelerator<value_type, transpose::no_trans, transpose::trans>(av, sizes[s], database);
+        tune_accelerator<value_type, transpose::trans, transpose::no_trans>(av, sizes[s], database);
+        tune_accelerator<value_type, transpose::trans, transpose::trans>(av, sizes[s], database);
+
+        // conjugation has its own kernels for complex types only
+        if (type_prefix<value_type>::value == 'c' || type_prefix<value_type>::value == 'z')
+        {
+            tune_accelerator<value_type, transpose::no_trans, transpose::conj_trans>(av, sizes[s], database);
+            tune_accelerator<value_type, transpose::trans, transpose::conj_trans>(av, sizes[s], database);
+            tune_accelerator<value_type, transpose::conj_trans, transpose::no_trans>(av, sizes[s], database);
+            tune_accelerator<value_type, transpose::conj_trans, transpose::trans>(av, sizes[s], database);
+            tune_accelerator<value_type, transpose::conj_trans, transpose::conj_trans>(av, sizes[s], database);
+        }
+    }
+}
+
+bool build_database(const std::string& filename)
+{
+    // merge into the existing results for other devices
+    gemm_tuning_database database;
+    database.load(filename);
+
+    std::vector<concurrency::accelerator_view> views;
+    views.push_back(concurrency::accelerator(concurrency::accelerator::cpu_accelerator).default_view);
+
+    concurrency::accelerator device;
+    if (!device.is_emulated)
+        views.push_back(device.create_view());
+
+    for (auto it = views.begin(); it != views.end(); ++it)
+    {
+        std::wcout << L"--- " << it->accelerator.get_description() << L" ---" << std::endl;
+        std::cout << "database key: " << ampblas::_detail::tuning_device_name(it->accelerator) << std::endl;
+
+        try
+        {
+            tune_type<float>(*it, database);
+            if (ampblas::_detail::is_host_accelerator(*it) || it->accelerator.supports_double_precision)
+                tune_type<double>(*it, database);
+
+            tune_type<fcomplex>(*it, database);
+            if (ampblas::_detail::is_host_accelerator(*it) || it->accelerator.supports_double_precision)
+                tune_type<dcomplex>(*it, database);
+        }
+        catch (const concurrency::runtime_exception& e)
+        {
+            std::cout << "C++ AMP Runtime Exception: " << e.what() << std::endl;
+        }
+    }
+
+    if (!database.save(filename))
+    {
+        std::cout << "Unable to write " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "Tuning database written to " << filename << std::endl;
+    return true;
+}
+
+TUNE_NAMESPACE_END
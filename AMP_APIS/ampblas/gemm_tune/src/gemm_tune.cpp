@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <iostream>
+#include <string>
 
 #include "tune.h"
 #include "template.h"
 #include "host_gemm.h"
+#include "autotune.h"
 
 TUNE_NAMESPACE_BEGIN
 
@@ -133,10 +135,14 @@ search_result build_test(int m, int n, int k, int offset = 0)
 
 TUNE_NAMESPACE_END
 
-int main()
+int main(int argc, char* argv[])
 {
     using namespace tune;
 
+    // gemm_profile --database <file>: store the fastest compiled configurations for this machine
+    if (argc == 3 && std::string(argv[1]) == "--database")
+        return build_database(argv[2]) ? 0 : 1;
+
     // TODO: support a range of data sizes or pass in as an argument
     const int m = 2048;
     const int n = 2048;
@@ -191,4 +191,46 @@ template <>             inline void ampblas_xtrmm(const enum AMPBLAS_ORDER Order
 template <>             inline void ampblas_xtrmm(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_fcomplex alpha, const ampblas_fcomplex *A, const int lda, ampblas_fcomplex *B, const int ldb) { ampblas_ctrmm(Order, Side, Uplo, TransA, Diag, M, N, &alpha, A, lda, B, ldb); }
 template <>             inline void ampblas_xtrmm(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_dcomplex alpha, const ampblas_dcomplex *A, const int lda, ampblas_dcomplex *B, const int ldb) { ampblas_ztrmm(Order, Side, Uplo, TransA, Diag, M, N, &alpha, A, lda, B, ldb); }
 
+// ampblas_xgemm_batched
+template <typename value_type> void ampblas_xgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const value_type       alpha, const value_type      * const A[], const int lda, const value_type      * const B[], const int ldb, const value_type       beta, value_type      * const C[], const int ldc, const int batch_count);
+template <>             inline void ampblas_xgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float            alpha, const float           * const A[], const int lda, const float           * const B[], const int ldb, const float            beta, float           * const C[], const int ldc, const int batch_count) { ampblas_sgemm_batched(Order, TransA, TransB, M, N, K,  alpha, A, lda, B, ldb,  beta, C, ldc, batch_count); }
+template <>             inline void ampblas_xgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const double           alpha, const double          * const A[], const int lda, const double          * const B[], const int ldb, const double           beta, double          * const C[], const int ldc, const int batch_count) { ampblas_dgemm_batched(Order, TransA, TransB, M, N, K,  alpha, A, lda, B, ldb,  beta, C, ldc, batch_count); }
+template <>             inline void ampblas_xgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_fcomplex alpha, const ampblas_fcomplex* const A[], const int lda, const ampblas_fcomplex* const B[], const int ldb, const ampblas_fcomplex beta, ampblas_fcomplex* const C[], const int ldc, const int batch_count) { ampblas_cgemm_batched(Order, TransA, TransB, M, N, K, &alpha, A, lda, B, ldb, &beta, C, ldc, batch_count); }
+template <>             inline void ampblas_xgemm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_dcomplex alpha, const ampblas_dcomplex* const A[], const int lda, const ampblas_dcomplex* const B[], const int ldb, const ampblas_dcomplex beta, ampblas_dcomplex* const C[], const int ldc, const int batch_count) { ampblas_zgemm_batched(Order, TransA, TransB, M, N, K, &alpha, A, lda, B, ldb, &beta, C, ldc, batch_count); }
+
+// ampblas_xgemm_strided_batched
+template <typename value_type> void ampblas_xgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const value_type       alpha, const value_type       *A, const int lda, const int strideA, const value_type       *B, const int ldb, const int strideB, const value_type       beta, value_type       *C, const int ldc, const int strideC, const int batch_count);
+template <>             inline void ampblas_xgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const float            alpha, const float            *A, const int lda, const int strideA, const float            *B, const int ldb, const int strideB, const float            beta, float            *C, const int ldc, const int strideC, const int batch_count) { ampblas_sgemm_strided_batched(Order, TransA, TransB, M, N, K,  alpha, A, lda, strideA, B, ldb, strideB,  beta, C, ldc, strideC, batch_count); }
+template <>             inline void ampblas_xgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const double           alpha, const double           *A, const int lda, const int strideA, const double           *B, const int ldb, const int strideB, const double           beta, double           *C, const int ldc, const int strideC, const int batch_count) { ampblas_dgemm_strided_batched(Order, TransA, TransB, M, N, K,  alpha, A, lda, strideA, B, ldb, strideB,  beta, C, ldc, strideC, batch_count); }
+template <>             inline void ampblas_xgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_fcomplex alpha, const ampblas_fcomplex *A, const int lda, const int strideA, const ampblas_fcomplex *B, const int ldb, const int strideB, const ampblas_fcomplex beta, ampblas_fcomplex *C, const int ldc, const int strideC, const int batch_count) { ampblas_cgemm_strided_batched(Order, TransA, TransB, M, N, K, &alpha, A, lda, strideA, B, ldb, strideB, &beta, C, ldc, strideC, batch_count); }
+template <>             inline void ampblas_xgemm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_TRANSPOSE TransB, const int M, const int N, const int K, const ampblas_dcomplex alpha, const ampblas_dcomplex *A, const int lda, const int strideA, const ampblas_dcomplex *B, const int ldb, const int strideB, const ampblas_dcomplex beta, ampblas_dcomplex *C, const int ldc, const int strideC, const int batch_count) { ampblas_zgemm_strided_batched(Order, TransA, TransB, M, N, K, &alpha, A, lda, strideA, B, ldb, strideB, &beta, C, ldc, strideC, batch_count); }
+
+// ampblas_xtrsm_batched
+template <typename value_type> void ampblas_xtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const value_type       alpha, const value_type      * const A[], const int lda, value_type      * const B[], const int ldb, const int batch_count);
+template <>             inline void ampblas_xtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const float            alpha, const float           * const A[], const int lda, float           * const B[], const int ldb, const int batch_count) { ampblas_strsm_batched(Order, Side, Uplo, TransA, Diag, M, N,  alpha, A, lda, B, ldb, batch_count); }
+template <>             inline void ampblas_xtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const double           alpha, const double          * const A[], const int lda, double          * const B[], const int ldb, const int batch_count) { ampblas_dtrsm_batched(Order, Side, Uplo, TransA, Diag, M, N,  alpha, A, lda, B, ldb, batch_count); }
+template <>             inline void ampblas_xtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_fcomplex alpha, const ampblas_fcomplex* const A[], const int lda, ampblas_fcomplex* const B[], const int ldb, const int batch_count) { ampblas_ctrsm_batched(Order, Side, Uplo, TransA, Diag, M, N, &alpha, A, lda, B, ldb, batch_count); }
+template <>             inline void ampblas_xtrsm_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_dcomplex alpha, const ampblas_dcomplex* const A[], const int lda, ampblas_dcomplex* const B[], const int ldb, const int batch_count) { ampblas_ztrsm_batched(Order, Side, Uplo, TransA, Diag, M, N, &alpha, A, lda, B, ldb, batch_count); }
+
+// ampblas_xtrsm_strided_batched
+template <typename value_type> void ampblas_xtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const value_type       alpha, const value_type       *A, const int lda, const int strideA, value_type       *B, const int ldb, const int strideB, const int batch_count);
+template <>             inline void ampblas_xtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const float            alpha, const float            *A, const int lda, const int strideA, float            *B, const int ldb, const int strideB, const int batch_count) { ampblas_strsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N,  alpha, A, lda, strideA, B, ldb, strideB, batch_count); }
+template <>             inline void ampblas_xtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const double           alpha, const double           *A, const int lda, const int strideA, double           *B, const int ldb, const int strideB, const int batch_count) { ampblas_dtrsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N,  alpha, A, lda, strideA, B, ldb, strideB, batch_count); }
+template <>             inline void ampblas_xtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_fcomplex alpha, const ampblas_fcomplex *A, const int lda, const int strideA, ampblas_fcomplex *B, const int ldb, const int strideB, const int batch_count) { ampblas_ctrsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N, &alpha, A, lda, strideA, B, ldb, strideB, batch_count); }
+template <>             inline void ampblas_xtrsm_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_SIDE Side, const enum AMPBLAS_UPLO Uplo, const enum AMPBLAS_TRANSPOSE TransA, const enum AMPBLAS_DIAG Diag, const int M, const int N, const ampblas_dcomplex alpha, const ampblas_dcomplex *A, const int lda, const int strideA, ampblas_dcomplex *B, const int ldb, const int strideB, const int batch_count) { ampblas_ztrsm_strided_batched(Order, Side, Uplo, TransA, Diag, M, N, &alpha, A, lda, strideA, B, ldb, strideB, batch_count); }
+
+// ampblas_xgemv_batched
+template <typename value_type> void ampblas_xgemv_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const value_type       alpha, const value_type      * const A[], const int lda, const value_type      * const X[], const int incX, const value_type       beta, value_type      * const Y[], const int incY, const int batch_count);
+template <>             inline void ampblas_xgemv_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const float            alpha, const float           * const A[], const int lda, const float           * const X[], const int incX, const float            beta, float           * const Y[], const int incY, const int batch_count) { ampblas_sgemv_batched(Order, TransA, M, N,  alpha, A, lda, X, incX,  beta, Y, incY, batch_count); }
+template <>             inline void ampblas_xgemv_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const double           alpha, const double          * const A[], const int lda, const double          * const X[], const int incX, const double           beta, double          * const Y[], const int incY, const int batch_count) { ampblas_dgemv_batched(Order, TransA, M, N,  alpha, A, lda, X, incX,  beta, Y, incY, batch_count); }
+template <>             inline void ampblas_xgemv_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_fcomplex alpha, const ampblas_fcomplex* const A[], const int lda, const ampblas_fcomplex* const X[], const int incX, const ampblas_fcomplex beta, ampblas_fcomplex* const Y[], const int incY, const int batch_count) { ampblas_cgemv_batched(Order, TransA, M, N, &alpha, A, lda, X, incX, &beta, Y, incY, batch_count); }
+template <>             inline void ampblas_xgemv_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_dcomplex alpha, const ampblas_dcomplex* const A[], const int lda, const ampblas_dcomplex* const X[], const int incX, const ampblas_dcomplex beta, ampblas_dcomplex* const Y[], const int incY, const int batch_count) { ampblas_zgemv_batched(Order, TransA, M, N, &alpha, A, lda, X, incX, &beta, Y, incY, batch_count); }
+
+// ampblas_xgemv_strided_batched
+template <typename value_type> void ampblas_xgemv_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const value_type       alpha, const value_type       *A, const int lda, const int strideA, const value_type       *X, const int incX, const int strideX, const value_type       beta, value_type       *Y, const int incY, const int strideY, const int batch_count);
+template <>             inline void ampblas_xgemv_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const float            alpha, const float            *A, const int lda, const int strideA, const float            *X, const int incX, const int strideX, const float            beta, float            *Y, const int incY, const int strideY, const int batch_count) { ampblas_sgemv_strided_batched(Order, TransA, M, N,  alpha, A, lda, strideA, X, incX, strideX,  beta, Y, incY, strideY, batch_count); }
+template <>             inline void ampblas_xgemv_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const double           alpha, const double           *A, const int lda, const int strideA, const double           *X, const int incX, const int strideX, const double           beta, double           *Y, const int incY, const int strideY, const int batch_count) { ampblas_dgemv_strided_batched(Order, TransA, M, N,  alpha, A, lda, strideA, X, incX, strideX,  beta, Y, incY, strideY, batch_count); }
+template <>             inline void ampblas_xgemv_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_fcomplex alpha, const ampblas_fcomplex *A, const int lda, const int strideA, const ampblas_fcomplex *X, const int incX, const int strideX, const ampblas_fcomplex beta, ampblas_fcomplex *Y, const int incY, const int strideY, const int batch_count) { ampblas_cgemv_strided_batched(Order, TransA, M, N, &alpha, A, lda, strideA, X, incX, strideX, &beta, Y, incY, strideY, batch_count); }
+template <>             inline void ampblas_xgemv_strided_batched(const enum AMPBLAS_ORDER Order, const enum AMPBLAS_TRANSPOSE TransA, const int M, const int N, const ampblas_dcomplex alpha, const ampblas_dcomplex *A, const int lda, const int strideA, const ampblas_dcomplex *X, const int incX, const int strideX, const ampblas_dcomplex beta, ampblas_dcomplex *Y, const int incY, const int strideY, const int batch_count) { ampblas_zgemv_strided_batched(Order, TransA, M, N, &alpha, A, lda, strideA, X, incX, strideX, &beta, Y, incY, strideY, batch_count); }
+
 #endif //AMPXBLAS_H
@@ -0,0 +1,235 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemm_batched_test.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+// testing headers
+#include "ampblas_test_bench.h"
+#include "ampblas_test_util.h"
+
+#include <vector>
+#include <sstream>
+
+// unique paramaters for gemm_batched
+template <typename value_type>
+struct gemm_batched_parameters
+{
+    gemm_batched_parameters(enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_TRANSPOSE transb, int m, int n, int k, value_type alpha, value_type beta, int ld_offset, int batch_count, bool strided)
+      : transa(transa), transb(transb), m(m), n(n), k(k), alpha(alpha), beta(beta), ld_offset(ld_offset), batch_count(batch_count), strided(strided)
+    {}
+
+    enum AMPBLAS_TRANSPOSE transa;
+    enum AMPBLAS_TRANSPOSE transb;
+    int m;
+    int n;
+    int k;
+    value_type alpha;
+    value_type beta;
+    int ld_offset;
+    int batch_count;
+    bool strided;
+
+    std::string name() const
+    {
+        std::stringstream out;
+
+        out << AMPBLAS_NAMED_TYPE(transa)
+            << AMPBLAS_NAMED_TYPE(transb)
+            << AMPBLAS_NAMED_TYPE(m)
+            << AMPBLAS_NAMED_TYPE(n)
+            << AMPBLAS_NAMED_TYPE(k)
+            << AMPBLAS_NAMED_TYPE(alpha)
+            << AMPBLAS_NAMED_TYPE(beta)
+            << AMPBLAS_NAMED_TYPE(ld_offset)
+            << AMPBLAS_NAMED_TYPE(batch_count)
+            << AMPBLAS_NAMED_TYPE(strided);
+
+        return out.str();
+    }
+
+};
+
+template <typename value_type>
+class gemm_batched_test : public test_case<value_type,gemm_batched_parameters>
+{
+public:
+
+    std::string name() const
+    {
+        return "GEMM (batched)";
+    }
+
+    double flops(const typed_parameters& p)
+    {
+        return 2.0 * double(p.m) * double(p.n) * double(p.k) * double(p.batch_count);
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        typedef typename ampcblas_type<value_type>::type ampcblas_value_type;
+
+        // derived parameters
+        auto row_a = (p.transa == AmpblasNoTrans ? p.m : p.k);
+        auto col_a = (p.transa == AmpblasNoTrans ? p.k : p.m);
+        auto row_b = (p.transb == AmpblasNoTrans ? p.k : p.n);
+        auto col_b = (p.transb == AmpblasNoTrans ? p.n : p.k);
+
+        // column major
+        int lda = row_a + p.ld_offset;
+        int ldb = row_b + p.ld_offset;
+        int ldc = p.m + p.ld_offset;
+
+        // the items of a batch are stored side by side
+        int stride_a = lda * col_a;
+        int stride_b = ldb * col_b;
+        int stride_c = ldc * p.n;
+
+        // reference data
+        ampblas_test_matrix<value_type> A(row_a, col_a * p.batch_count, lda);
+        ampblas_test_matrix<value_type> B(row_b, col_b * p.batch_count, ldb);
+        test_matrix<value_type> C(p.m, p.n * p.batch_count, ldc);
+
+        // generate data
+        randomize(A);
+        randomize(B);
+        randomize(C);
+
+        // ampblas data
+        ampblas_test_matrix<value_type> C_amp(C);
+
+        // test references
+        start_reference_test();
+        for (int i = 0; i < p.batch_count; i++)
+            cblas::xGEMM(cblas_cast(p.transa), cblas_cast(p.transb), p.m, p.n, p.k, cblas_cast(p.alpha), cblas_cast(A.data() + i*stride_a), A.ld(), cblas_cast(B.data() + i*stride_b), B.ld(), cblas_cast(p.beta), cblas_cast(C.data() + i*stride_c), C.ld());
+        stop_reference_test();
+
+        // test ampblas
+        if (p.strided)
+        {
+            start_ampblas_test();
+            ampblas_xgemm_strided_batched(AmpblasColMajor, p.transa, p.transb, p.m, p.n, p.k, ampcblas_cast(p.alpha), ampcblas_cast(A.data()), A.ld(), stride_a, ampcblas_cast(B.data()), B.ld(), stride_b, ampcblas_cast(p.beta), ampcblas_cast(C_amp.data()), C_amp.ld(), stride_c, p.batch_count);
+            stop_ampblas_test();
+        }
+        else
+        {
+            std::vector<const ampcblas_value_type*> a_ptrs;
+            std::vector<const ampcblas_value_type*> b_ptrs;
+            std::vector<ampcblas_value_type*> c_ptrs;
+
+            for (int i = 0; i < p.batch_count; i++)
+            {
+                a_ptrs.push_back(ampcblas_cast(A.data() + i*stride_a));
+                b_ptrs.push_back(ampcblas_cast(B.data() + i*stride_b));
+                c_ptrs.push_back(ampcblas_cast(C_amp.data() + i*stride_c));
+            }
+
+            start_ampblas_test();
+            ampblas_xgemm_batched(AmpblasColMajor, p.transa, p.transb, p.m, p.n, p.k, ampcblas_cast(p.alpha), &a_ptrs[0], A.ld(), &b_ptrs[0], B.ld(), ampcblas_cast(p.beta), &c_ptrs[0], C_amp.ld(), p.batch_count);
+            stop_ampblas_test();
+        }
+
+        // synchronize outputs
+        C_amp.synchronize();
+
+        // calculate error
+        check_error(C, C_amp);
+    }
+
+    gemm_batched_test()
+    {
+        // bulk test example
+        std::vector<enum AMPBLAS_TRANSPOSE> transa;
+        transa.push_back(AmpblasNoTrans);
+        transa.push_back(AmpblasTrans);
+        transa.push_back(AmpblasConjTrans);
+
+        std::vector<enum AMPBLAS_TRANSPOSE> transb;
+        transb.push_back(AmpblasNoTrans);
+        transb.push_back(AmpblasTrans);
+        transb.push_back(AmpblasConjTrans);
+
+        // small items plus one size past the host small kernel limit
+        std::vector<int> m;
+        m.push_back(3);
+        m.push_back(16);
+        m.push_back(80);
+
+        std::vector<int> n;
+        n.push_back(5);
+        n.push_back(16);
+
+        std::vector<int> k;
+        k.push_back(4);
+        k.push_back(16);
+
+        std::vector<value_type> alpha;
+        alpha.push_back( value_type(1) );
+        alpha.push_back( value_type(-1) );
+        alpha.push_back( value_type(0) );
+
+        std::vector<value_type> beta;
+        beta.push_back( value_type(1) );
+        beta.push_back( value_type(0) );
+
+        std::vector<int> ld_offset;
+        ld_offset.push_back(0);
+        ld_offset.push_back(3);
+
+        std::vector<int> batch_count;
+        batch_count.push_back(1);
+        batch_count.push_back(37);
+
+        std::vector<bool> strided;
+        strided.push_back(true);
+        strided.push_back(false);
+
+        paramter_exploder(transa,transb,m,n,k,alpha,beta,ld_offset,batch_count,strided);
+    }
+};
+
+REGISTER_TEST(gemm_batched_test, float);
+REGISTER_TEST(gemm_batched_test, double);
+REGISTER_TEST(gemm_batched_test, complex_float);
+REGISTER_TEST(gemm_batched_test, complex_double);
+
+// the same cases executed by the host implementation on the CPU accelerator
+template <typename value_type>
+class gemm_batched_host_test : public gemm_batched_test<value_type>
+{
+public:
+
+    std::string name() const
+    {
+        return "GEMM (batched, host)";
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        concurrency::accelerator_view previous = ampcblas::get_current_accelerator_view();
+        ampcblas::set_current_accelerator_view(concurrency::accelerator(concurrency::accelerator::cpu_accelerator).default_view);
+
+        gemm_batched_test<value_type>::run_cblas_test(p);
+
+        ampcblas::set_current_accelerator_view(previous);
+    }
+};
+
+REGISTER_TEST(gemm_batched_host_test, float);
+REGISTER_TEST(gemm_batched_host_test, double);
+REGISTER_TEST(gemm_batched_host_test, complex_float);
+REGISTER_TEST(gemm_batched_host_test, complex_double);
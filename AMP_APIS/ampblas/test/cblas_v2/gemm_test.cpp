@@ -180,3 +180,30 @@ REGISTER_TEST(gemm_test, float);
 REGISTER_TEST(gemm_test, double);
 REGISTER_TEST(gemm_test, complex_float);
 REGISTER_TEST(gemm_test, complex_double);
+
+// the same cases executed by the host implementation on the CPU accelerator
+template <typename value_type>
+class gemm_host_test : public gemm_test<value_type>
+{
+public:
+
+    std::string name() const
+    {
+        return "GEMM (host)";
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        concurrency::accelerator_view previous = ampcblas::get_current_accelerator_view();
+        ampcblas::set_current_accelerator_view(concurrency::accelerator(concurrency::accelerator::cpu_accelerator).default_view);
+
+        gemm_test<value_type>::run_cblas_test(p);
+
+        ampcblas::set_current_accelerator_view(previous);
+    }
+};
+
+REGISTER_TEST(gemm_host_test, float);
+REGISTER_TEST(gemm_host_test, double);
+REGISTER_TEST(gemm_host_test, complex_float);
+REGISTER_TEST(gemm_host_test, complex_double);
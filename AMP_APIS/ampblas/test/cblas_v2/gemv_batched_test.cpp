@@ -0,0 +1,214 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * gemv_batched_test.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+// testing headers
+#include "ampblas_test_bench.h"
+#include "ampblas_test_util.h"
+
+#include <vector>
+#include <sstream>
+
+// unique paramaters for gemv_batched
+template <typename value_type>
+struct gemv_batched_parameters
+{
+    gemv_batched_parameters(enum AMPBLAS_TRANSPOSE transa, int m, int n, value_type alpha, int incx, value_type beta, int incy, int batch_count, bool strided)
+      : transa(transa), m(m), n(n), alpha(alpha), incx(incx), beta(beta), incy(incy), batch_count(batch_count), strided(strided)
+    {}
+
+    enum AMPBLAS_TRANSPOSE transa;
+    int m;
+    int n;
+    value_type alpha;
+    int incx;
+    value_type beta;
+    int incy;
+    int batch_count;
+    bool strided;
+
+    std::string name() const
+    {
+        std::stringstream out;
+
+        out << AMPBLAS_NAMED_TYPE(transa)
+            << AMPBLAS_NAMED_TYPE(m)
+            << AMPBLAS_NAMED_TYPE(n)
+            << AMPBLAS_NAMED_TYPE(alpha)
+            << AMPBLAS_NAMED_TYPE(incx)
+            << AMPBLAS_NAMED_TYPE(beta)
+            << AMPBLAS_NAMED_TYPE(incy)
+            << AMPBLAS_NAMED_TYPE(batch_count)
+            << AMPBLAS_NAMED_TYPE(strided);
+
+        return out.str();
+    }
+
+};
+
+template <typename value_type>
+class gemv_batched_test : public test_case<value_type,gemv_batched_parameters>
+{
+public:
+
+    std::string name() const
+    {
+        return "GEMV (batched)";
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        typedef typename ampcblas_type<value_type>::type ampcblas_value_type;
+
+        // derived parameters
+        int len_x = (p.transa == AmpblasNoTrans ? p.n : p.m);
+        int len_y = (p.transa == AmpblasNoTrans ? p.m : p.n);
+
+        // the items of a batch are stored side by side; vectors are the columns of a matrix
+        int lda = p.m + 1;
+        int ldx = (len_x - 1) * std::abs(p.incx) + 1;
+        int ldy = (len_y - 1) * std::abs(p.incy) + 1;
+        int stride_a = lda * p.n;
+
+        // reference data
+        ampblas_test_matrix<value_type> A(p.m, p.n * p.batch_count, lda);
+        ampblas_test_matrix<value_type> x(ldx, p.batch_count, ldx);
+        test_matrix<value_type> y(ldy, p.batch_count, ldy);
+
+        // generate data
+        randomize(A);
+        randomize(x);
+        randomize(y);
+
+        // ampblas data
+        ampblas_test_matrix<value_type> y_amp(y);
+
+        // test references
+        start_reference_test();
+        for (int i = 0; i < p.batch_count; i++)
+            cblas::xGEMV(cblas_cast(p.transa), p.m, p.n, cblas_cast(p.alpha), cblas_cast(A.data() + i*stride_a), A.ld(), cblas_cast(x.data() + i*ldx), p.incx, cblas_cast(p.beta), cblas_cast(y.data() + i*ldy), p.incy);
+        stop_reference_test();
+
+        // test ampblas
+        if (p.strided)
+        {
+            start_ampblas_test();
+            ampblas_xgemv_strided_batched(AmpblasColMajor, p.transa, p.m, p.n, ampcblas_cast(p.alpha), ampcblas_cast(A.data()), A.ld(), stride_a, ampcblas_cast(x.data()), p.incx, ldx, ampcblas_cast(p.beta), ampcblas_cast(y_amp.data()), p.incy, ldy, p.batch_count);
+            stop_ampblas_test();
+        }
+        else
+        {
+            std::vector<const ampcblas_value_type*> a_ptrs;
+            std::vector<const ampcblas_value_type*> x_ptrs;
+            std::vector<ampcblas_value_type*> y_ptrs;
+
+            for (int i = 0; i < p.batch_count; i++)
+            {
+                a_ptrs.push_back(ampcblas_cast(A.data() + i*stride_a));
+                x_ptrs.push_back(ampcblas_cast(x.data() + i*ldx));
+                y_ptrs.push_back(ampcblas_cast(y_amp.data() + i*ldy));
+            }
+
+            start_ampblas_test();
+            ampblas_xgemv_batched(AmpblasColMajor, p.transa, p.m, p.n, ampcblas_cast(p.alpha), &a_ptrs[0], A.ld(), &x_ptrs[0], p.incx, ampcblas_cast(p.beta), &y_ptrs[0], p.incy, p.batch_count);
+            stop_ampblas_test();
+        }
+
+        // synchronize outputs
+        y_amp.synchronize();
+
+        // calculate error
+        check_error(y, y_amp);
+    }
+
+    gemv_batched_test()
+    {
+        // bulk test example
+        std::vector<enum AMPBLAS_TRANSPOSE> transa;
+        transa.push_back(AmpblasNoTrans);
+        transa.push_back(AmpblasTrans);
+        transa.push_back(AmpblasConjTrans);
+
+        std::vector<int> m;
+        m.push_back(5);
+        m.push_back(32);
+
+        std::vector<int> n;
+        n.push_back(7);
+        n.push_back(32);
+
+        std::vector<value_type> alpha;
+        alpha.push_back( value_type(1) );
+        alpha.push_back( value_type(-1) );
+
+        std::vector<int> incx;
+        incx.push_back(1);
+        incx.push_back(-2);
+
+        std::vector<value_type> beta;
+        beta.push_back( value_type(1) );
+        beta.push_back( value_type(0) );
+
+        std::vector<int> incy;
+        incy.push_back(1);
+        incy.push_back(2);
+
+        std::vector<int> batch_count;
+        batch_count.push_back(1);
+        batch_count.push_back(41);
+
+        std::vector<bool> strided;
+        strided.push_back(true);
+        strided.push_back(false);
+
+        paramter_exploder(transa,m,n,alpha,incx,beta,incy,batch_count,strided);
+    }
+};
+
+REGISTER_TEST(gemv_batched_test, float);
+REGISTER_TEST(gemv_batched_test, double);
+REGISTER_TEST(gemv_batched_test, complex_float);
+REGISTER_TEST(gemv_batched_test, complex_double);
+
+// the same cases executed by the host implementation on the CPU accelerator
+template <typename value_type>
+class gemv_batched_host_test : public gemv_batched_test<value_type>
+{
+public:
+
+    std::string name() const
+    {
+        return "GEMV (batched, host)";
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        concurrency::accelerator_view previous = ampcblas::get_current_accelerator_view();
+        ampcblas::set_current_accelerator_view(concurrency::accelerator(concurrency::accelerator::cpu_accelerator).default_view);
+
+        gemv_batched_test<value_type>::run_cblas_test(p);
+
+        ampcblas::set_current_accelerator_view(previous);
+    }
+};
+
+REGISTER_TEST(gemv_batched_host_test, float);
+REGISTER_TEST(gemv_batched_host_test, double);
+REGISTER_TEST(gemv_batched_host_test, complex_float);
+REGISTER_TEST(gemv_batched_host_test, complex_double);
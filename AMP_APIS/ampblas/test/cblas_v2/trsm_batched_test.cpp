@@ -0,0 +1,226 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ *
+ * trsm_batched_test.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+// testing headers
+#include "ampblas_test_bench.h"
+#include "ampblas_test_util.h"
+
+#include <vector>
+#include <sstream>
+
+// unique paramaters for trsm_batched
+template <typename value_type>
+struct trsm_batched_parameters
+{
+    trsm_batched_parameters(enum AMPBLAS_SIDE side, enum AMPBLAS_UPLO uplo, enum AMPBLAS_TRANSPOSE transa, enum AMPBLAS_DIAG diag, int m, int n, value_type alpha, int batch_count, bool strided)
+        : side(side), uplo(uplo), transa(transa), diag(diag), m(m), n(n), alpha(alpha), batch_count(batch_count), strided(strided)
+    {}
+
+    enum AMPBLAS_SIDE side;
+    enum AMPBLAS_UPLO uplo;
+    enum AMPBLAS_TRANSPOSE transa;
+    enum AMPBLAS_DIAG diag;
+    int m;
+    int n;
+    value_type alpha;
+    int batch_count;
+    bool strided;
+
+    std::string name() const
+    {
+        std::stringstream out;
+
+        out << AMPBLAS_NAMED_TYPE(side)
+            << AMPBLAS_NAMED_TYPE(uplo)
+            << AMPBLAS_NAMED_TYPE(transa)
+            << AMPBLAS_NAMED_TYPE(diag)
+            << AMPBLAS_NAMED_TYPE(m)
+            << AMPBLAS_NAMED_TYPE(n)
+            << AMPBLAS_NAMED_TYPE(alpha)
+            << AMPBLAS_NAMED_TYPE(batch_count)
+            << AMPBLAS_NAMED_TYPE(strided);
+
+        return out.str();
+    }
+
+};
+
+template <typename value_type>
+class trsm_batched_test : public test_case<value_type,trsm_batched_parameters>
+{
+public:
+
+    std::string name() const
+    {
+        return "TRSM (batched)";
+    }
+
+    bool requires_full_double() const
+    {
+        // uses division
+        return true;
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        typedef typename ampcblas_type<value_type>::type ampcblas_value_type;
+
+        // derived parameters
+        int k = (p.side == AmpblasLeft ? p.m : p.n);
+
+        // column major, the items of a batch stored side by side
+        int lda = k + 1;
+        int ldb = p.m + 2;
+        int stride_a = lda * k;
+        int stride_b = ldb * p.n;
+
+        // reference data
+        ampblas_test_matrix<value_type> A(k, k * p.batch_count, lda);
+        test_matrix<value_type> B(p.m, p.n * p.batch_count, ldb);
+
+        // generate data
+        randomize(A, value_type(1), value_type(2));
+        randomize(B);
+
+        // this will quickly generate "happy" matrices that can be solved without floating point overflow
+        for (int j=0; j<k*p.batch_count; j++)
+        {
+            const int i = j % k;
+            value_type Aii = A(i,j);
+            A(i,j) = value_type(1);
+            real_type scale = cblas::xNRM2(k, cblas_cast(A.data()+j*A.ld()), 1);
+            cblas::xSCAL(k, real_type(1)/scale, cblas_cast(A.data()+j*A.ld()), 1);
+            A(i,j) = Aii;
+        }
+
+        // ampblas data
+        ampblas_test_matrix<value_type> B_amp(B);
+
+        // test references
+        start_reference_test();
+        for (int i = 0; i < p.batch_count; i++)
+            cblas::xTRSM(cblas_cast(p.side), cblas_cast(p.uplo), cblas_cast(p.transa), cblas_cast(p.diag), p.m, p.n, cblas_cast(p.alpha), cblas_cast(A.data() + i*stride_a), A.ld(), cblas_cast(B.data() + i*stride_b), B.ld());
+        stop_reference_test();
+
+        // test ampblas
+        if (p.strided)
+        {
+            start_ampblas_test();
+            ampblas_xtrsm_strided_batched(AmpblasColMajor, p.side, p.uplo, p.transa, p.diag, p.m, p.n, ampcblas_cast(p.alpha), ampcblas_cast(A.data()), A.ld(), stride_a, ampcblas_cast(B_amp.data()), B_amp.ld(), stride_b, p.batch_count);
+            stop_ampblas_test();
+        }
+        else
+        {
+            std::vector<const ampcblas_value_type*> a_ptrs;
+            std::vector<ampcblas_value_type*> b_ptrs;
+
+            for (int i = 0; i < p.batch_count; i++)
+            {
+                a_ptrs.push_back(ampcblas_cast(A.data() + i*stride_a));
+                b_ptrs.push_back(ampcblas_cast(B_amp.data() + i*stride_b));
+            }
+
+            start_ampblas_test();
+            ampblas_xtrsm_batched(AmpblasColMajor, p.side, p.uplo, p.transa, p.diag, p.m, p.n, ampcblas_cast(p.alpha), &a_ptrs[0], A.ld(), &b_ptrs[0], B_amp.ld(), p.batch_count);
+            stop_ampblas_test();
+        }
+
+        // synchronize outputs
+        B_amp.synchronize();
+
+        // calculate error
+        check_error(B, B_amp);
+    }
+
+    trsm_batched_test()
+    {
+        // bulk test example
+        std::vector<enum AMPBLAS_SIDE> side;
+        side.push_back(AmpblasLeft);
+        side.push_back(AmpblasRight);
+
+        std::vector<enum AMPBLAS_UPLO> uplo;
+        uplo.push_back(AmpblasUpper);
+        uplo.push_back(AmpblasLower);
+
+        std::vector<enum AMPBLAS_TRANSPOSE> transa;
+        transa.push_back(AmpblasNoTrans);
+        transa.push_back(AmpblasTrans);
+        transa.push_back(AmpblasConjTrans);
+
+        std::vector<enum AMPBLAS_DIAG> diag;
+        diag.push_back(AmpblasNonUnit);
+        diag.push_back(AmpblasUnit);
+
+        std::vector<int> m;
+        m.push_back(4);
+        m.push_back(24);
+
+        std::vector<int> n;
+        n.push_back(3);
+        n.push_back(16);
+
+        std::vector<value_type> alpha;
+        alpha.push_back( value_type(1) );
+        alpha.push_back( value_type(-1) );
+
+        std::vector<int> batch_count;
+        batch_count.push_back(1);
+        batch_count.push_back(29);
+
+        std::vector<bool> strided;
+        strided.push_back(true);
+        strided.push_back(false);
+
+        paramter_exploder(side,uplo,transa,diag,m,n,alpha,batch_count,strided);
+    }
+};
+
+REGISTER_TEST(trsm_batched_test, float);
+REGISTER_TEST(trsm_batched_test, double);
+REGISTER_TEST(trsm_batched_test, complex_float);
+REGISTER_TEST(trsm_batched_test, complex_double);
+
+// the same cases executed by the host implementation on the CPU accelerator
+template <typename value_type>
+class trsm_batched_host_test : public trsm_batched_test<value_type>
+{
+public:
+
+    std::string name() const
+    {
+        return "TRSM (batched, host)";
+    }
+
+    void run_cblas_test(const typed_parameters& p)
+    {
+        concurrency::accelerator_view previous = ampcblas::get_current_accelerator_view();
+        ampcblas::set_current_accelerator_view(concurrency::accelerator(concurrency::accelerator::cpu_accelerator).default_view);
+
+        trsm_batched_test<value_type>::run_cblas_test(p);
+
+        ampcblas::set_current_accelerator_view(previous);
+    }
+};
+
+REGISTER_TEST(trsm_batched_host_test, float);
+REGISTER_TEST(trsm_batched_host_test, double);
+REGISTER_TEST(trsm_batched_host_test, complex_float);
+REGISTER_TEST(trsm_batched_host_test, complex_double);
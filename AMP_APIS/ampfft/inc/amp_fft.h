@@ -1,29 +1,69 @@
 //--------------------------------------------------------------------------------------
 // File: amp_fft.h
 //
-// Header file for the C++ AMP wrapper over the Direct3D FFT API's.
+// Header file for the C++ AMP wrapper over the Direct3D FFT API's, and the portable
+// host FFT engine (amp_fft_host.h) used where Direct3D is not available, including its
+// out-of-core transforms of files (amp_fft_out_of_core.h).
 //
 // Copyright (c) Microsoft Corporation. All rights reserved.
 //--------------------------------------------------------------------------------------
 
+#pragma once
+
+//--------------------------------------------------------------------------------------
+// Configuration.
+//
+// C++ AMP is only available with the Microsoft compiler. When it is, single precision
+// transforms of concurrency::array's use the Direct3D FFT API's unless
+// AMP_FFT_NO_DIRECT3D is defined. Everything else (double precision, the CPU
+// accelerator, host pointers and platforms without C++ AMP) uses the host engine.
+//--------------------------------------------------------------------------------------
+#ifdef _MSC_VER
+#define _AMP_FFT_HAS_AMP
+#ifndef AMP_FFT_NO_DIRECT3D
+#define _AMP_FFT_DIRECT3D
+#endif
+#endif
+
+#ifdef _AMP_FFT_DIRECT3D
 #include <d3d11.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
 #include <complex>
+#ifdef _AMP_FFT_HAS_AMP
 #include <amp.h>
+#endif
+#ifdef _AMP_FFT_DIRECT3D
 #include <wrl\client.h>
+#endif
 #include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#ifdef _AMP_FFT_DIRECT3D
 #include <d3dcsx.h>
 
 #pragma comment(lib, "d3dcsx")
+#endif
+
+#include "amp_fft_host.h"
+#include "amp_fft_out_of_core.h"
 
 //----------------------------------------------------------------------------
 // DLL export/import specifiers
 //
-// The export/import mechanism used here is the __declspec(export) method 
+// The export/import mechanism used here is the __declspec(export) method
 // supported by Microsoft Visual Studio, but any other export method supported
 // by your development environment may be substituted.
 //----------------------------------------------------------------------------
-#ifndef AMP_FFT_DLL 
+#ifndef _WIN32
+#undef AMP_FFT_DLL
+#define AMP_FFT_DLL
+#elif !defined(AMP_FFT_DLL)
 #define AMP_FFT_DLL __declspec(dllimport)
 #else
 #undef AMP_FFT_DLL
@@ -31,13 +71,29 @@
 #endif
 
 //--------------------------------------------------------------------------------------
-// This exception type should be expected from all public methods in this header, 
+// Error codes on platforms without the Windows headers.
+//--------------------------------------------------------------------------------------
+#ifndef _WIN32
+typedef int HRESULT;
+#ifndef E_INVALIDARG
+#define E_INVALIDARG ((HRESULT)0x80070057)
+#endif
+#ifndef E_OUTOFMEMORY
+#define E_OUTOFMEMORY ((HRESULT)0x8007000E)
+#endif
+#ifndef E_FAIL
+#define E_FAIL ((HRESULT)0x80004005)
+#endif
+#endif
+
+//--------------------------------------------------------------------------------------
+// This exception type should be expected from all public methods in this header,
 // except for destructors.
 //--------------------------------------------------------------------------------------
 class fft_exception : public std::exception
 {
 public:
-    explicit fft_exception(HRESULT error_code) throw() 
+    explicit fft_exception(HRESULT error_code) throw()
         : err_code(error_code) {}
 
     fft_exception(const char *const& msg, HRESULT error_code) throw()
@@ -66,12 +122,126 @@ private:
     std::string err_msg;
     HRESULT err_code;
 };
+
+#ifndef _AMP_FFT_HAS_AMP
+//--------------------------------------------------------------------------------------
+// class fft_extent.
+//
+// The extent of a transform on platforms without C++ AMP, with the same layout as
+// concurrency::extent: the last dimension is the one stored contiguously.
+//--------------------------------------------------------------------------------------
+template <int _Rank>
+class fft_extent
+{
+public:
+    fft_extent()
+    {
+        for (int i = 0; i < _Rank; i++)
+            _M_extent[i] = 0;
+    }
+
+    explicit fft_extent(int _E0)
+    {
+        static_assert(_Rank == 1, "this constructor is only available for one dimension");
+        _M_extent[0] = _E0;
+    }
+
+    fft_extent(int _E0, int _E1)
+    {
+        static_assert(_Rank == 2, "this constructor is only available for two dimensions");
+        _M_extent[0] = _E0;
+        _M_extent[1] = _E1;
+    }
+
+    fft_extent(int _E0, int _E1, int _E2)
+    {
+        static_assert(_Rank == 3, "this constructor is only available for three dimensions");
+        _M_extent[0] = _E0;
+        _M_extent[1] = _E1;
+        _M_extent[2] = _E2;
+    }
+
+    int& operator[](int _Index)
+    {
+        return _M_extent[_Index];
+    }
+
+    const int& operator[](int _Index) const
+    {
+        return _M_extent[_Index];
+    }
+
+    unsigned int size() const
+    {
+        unsigned int count = 1;
+        for (int i = 0; i < _Rank; i++)
+            count *= _M_extent[i];
+        return count;
+    }
+
+    bool operator==(const fft_extent& _Other) const
+    {
+        for (int i = 0; i < _Rank; i++)
+            if (_M_extent[i] != _Other._M_extent[i])
+                return false;
+        return true;
+    }
+
+    bool operator!=(const fft_extent& _Other) const
+    {
+        return !(*this == _Other);
+    }
+
+private:
+    int _M_extent[_Rank];
+};
+#endif
+
 //--------------------------------------------------------------------------------------
 // Implementation details, amp_fft.cpp contains the implementation for the functions
-// declared in this namespace. 
+// declared in this namespace.
 //--------------------------------------------------------------------------------------
 namespace _details
 {
+    template <typename _Type>
+    struct fft_type_helper
+    {
+        static const bool is_type_supported = false;
+    };
+
+    template <>
+    struct fft_type_helper<float>
+    {
+        static const bool is_type_supported = true;
+        static const bool is_complex = false;
+        typedef float precision_type;
+    };
+
+    template <>
+    struct fft_type_helper<double>
+    {
+        static const bool is_type_supported = true;
+        static const bool is_complex = false;
+        typedef double precision_type;
+    };
+
+    template <>
+    struct fft_type_helper<std::complex<float>>
+    {
+        static const bool is_type_supported = true;
+        static const bool is_complex = true;
+        typedef float precision_type;
+    };
+
+    template <>
+    struct fft_type_helper<std::complex<double>>
+    {
+        static const bool is_type_supported = true;
+        static const bool is_complex = true;
+        typedef double precision_type;
+    };
+
+#ifdef _AMP_FFT_DIRECT3D
     template <typename _Type>
     struct dx_fft_type_helper
     {
@@ -94,16 +264,29 @@ namespace _details
         static const D3DX11_FFT_DATA_TYPE dx_type = D3DX11_FFT_DATA_TYPE_COMPLEX;
     };
 
+    // the D3DX11_FFT_DATA_TYPE of types without Direct3D support is never used
+    template <typename _Type, bool _Supported = dx_fft_type_helper<_Type>::is_type_supported>
+    struct dx_fft_data_type
+    {
+        static const D3DX11_FFT_DATA_TYPE value = D3DX11_FFT_DATA_TYPE_COMPLEX;
+    };
+
+    template <typename _Type>
+    struct dx_fft_data_type<_Type, true>
+    {
+        static const D3DX11_FFT_DATA_TYPE value = dx_fft_type_helper<_Type>::dx_type;
+    };
+
     class fft_base
     {
     public:
+        AMP_FFT_DLL fft_base(D3DX11_FFT_DATA_TYPE _Dx_type, int _Dim, const int* _Transform_extent, const concurrency::accelerator_view& _Av, float _Forward_scale, float _Inverse_scale);
+
         AMP_FFT_DLL void set_forward_scale(float scale);
         AMP_FFT_DLL float get_forward_scale() const;
         AMP_FFT_DLL void set_inverse_scale(float scale);
         AMP_FFT_DLL float get_inverse_scale() const;
 
-    protected:
-        AMP_FFT_DLL fft_base(D3DX11_FFT_DATA_TYPE _Dx_type, int _Dim, const int* _Transform_extent, const concurrency::accelerator_view& _Av, float _Forward_scale, float _Inverse_scale);
         AMP_FFT_DLL HRESULT base_transform(bool _Forward, ID3D11Buffer *pBufferIn, ID3D11Buffer *pBufferOut) const;
 
     private:
@@ -119,96 +302,361 @@ namespace _details
         Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> _M_pTempUAVs[D3DX11_FFT_MAX_TEMP_BUFFERS];
         Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> _M_pPrecomputeUAVs[D3DX11_FFT_MAX_PRECOMPUTE_BUFFERS];
     };
+#endif
 } // namespace _details
 
 //--------------------------------------------------------------------------------------
 // class fft.
 //
 // This is the class which provides the FFT transformation functionality. At this point
-// it exposes 1d, 2d and 3d transformations over floats or std::complex<float>, although
-// Direct3D also provides the ability to transform higher dimensions, or be more 
-// selective about which dimensions to transform. Such an extension is left for the 
-// future or to the interested reader...
+// it exposes 1d, 2d and 3d transformations over float, double, std::complex<float> and
+// std::complex<double>.
 //
 // After creating an instance, you can use forward_transform and backward_tranform to
-// transform your data. The constructor initializes some internal data structures, so 
-// it's beneficial to reuse the fft object as long as possible.
+// transform your data. The constructor initializes some internal data structures, so
+// it's beneficial to reuse the fft object as long as possible. Objects of the same
+// extent and element type share the twiddle tables and scratch memory of the host
+// engine.
+//
+// Data can be passed as concurrency::array's (where C++ AMP is available) or as host
+// pointers to row major data with the extent of the fft (the last dimension being the
+// contiguous one). Transforms of real data produce the complete complex spectrum.
+// Many data sets of the same extent can be transformed with a single call by passing
+// a batch count together with the stride and distance of the data sets, and data sets
+// larger than memory can be transformed out-of-core from a file.
 //
-// Note that the dimensions (extent) of the fft and the extent of all input and output 
-// arrays must be identical. If an array is used which has a different extent, an 
+// Single precision transforms of arrays on a Direct3D accelerator use the Direct3D FFT
+// API's. All other transforms run on the host with the engine in amp_fft_host.h, which
+// is multi-threaded (AMP_FFT_NUM_THREADS sets the thread count).
+//
+// Note that the dimensions (extent) of the fft and the extent of all input and output
+// arrays must be identical. If an array is used which has a different extent, an
 // fft_exception is thrown.
 //
-// The library supports arbitrary extents but best performance can be achieved for 
-// powers of 2, followed by numbers whose prime factors are in the set {2,3,5}.
+// The library supports arbitrary extents but best performance can be achieved for
+// powers of 2, followed by numbers whose prime factors are in the set {2,3,5,7}.
 //
 // Limitations:
 //
-//   -- You should only allocate one fft class per accelerator_view. If you need 
-//      additional fft classes, create additional accelerator_view's first. This is a 
-//      limitation of the Direct3D FFT API's.
+//   -- You should only allocate one Direct3D fft class per accelerator_view. If you
+//      need additional fft classes, create additional accelerator_view's first. This
+//      is a limitation of the Direct3D FFT API's.
 //
-//   -- Class fft is not thread safe. Or more accurately, the FFT API is not thread 
+//   -- Class fft is not thread safe. Or more accurately, the FFT API is not thread
 //      safe. So again, create additional fft objects such that each thread has its own.
 //
 //--------------------------------------------------------------------------------------
 template <typename _Element_type, int _Dim>
-class fft : public _details::fft_base
+class fft
 {
 private:
     static_assert(_Dim>=1 && _Dim<=3, "class fft is only available for one, two or three dimensions");
-    static_assert(_details::dx_fft_type_helper<_Element_type>::is_type_supported, "class fft only supports element types float and std::complex<float>");
+    static_assert(_details::fft_type_helper<_Element_type>::is_type_supported, "class fft only supports element types float, double, std::complex<float> and std::complex<double>");
 
 public:
+    typedef typename _details::fft_type_helper<_Element_type>::precision_type precision_type;
+    typedef std::complex<precision_type> complex_type;
+
+#ifdef _AMP_FFT_HAS_AMP
+    typedef concurrency::extent<_Dim> extent_type;
+#else
+    typedef fft_extent<_Dim> extent_type;
+#endif
+
     //--------------------------------------------------------------------------------------
-    // Constructor. Throws fft_exception on failure.
+    // Constructor. Throws fft_exception on failure. A scale of zero selects the default
+    // (one for the forward transform and one over the number of elements for the
+    // inverse transform).
     //--------------------------------------------------------------------------------------
+#ifdef _AMP_FFT_HAS_AMP
+    fft(
+        extent_type _Transform_extent,
+        const concurrency::accelerator_view& _Av = concurrency::accelerator().default_view,
+        precision_type _Forward_scale = 0,
+        precision_type _Inverse_scale = 0)
+        :extent(_Transform_extent)
+    {
+        initialize(_Forward_scale, _Inverse_scale);
+
+#ifdef _AMP_FFT_DIRECT3D
+        if (_details::dx_fft_type_helper<_Element_type>::is_type_supported && _Av.accelerator.device_path != concurrency::accelerator::cpu_accelerator)
+        {
+            _M_direct3d = std::make_shared<_details::fft_base>(
+                _details::dx_fft_data_type<_Element_type>::value,
+                _Dim,
+                &_Transform_extent[0],
+                _Av,
+                static_cast<float>(_Forward_scale),
+                static_cast<float>(_Inverse_scale));
+        }
+#else
+        (void)_Av;
+#endif
+    }
+#else
     fft(
-        concurrency::extent<_Dim> _Transform_extent, 
-        const concurrency::accelerator_view& _Av = concurrency::accelerator().default_view, 
-        float _Forward_scale = 0.0f, 
-        float _Inverse_scale = 0.0f)
-        :extent(_Transform_extent), 
-        fft_base(
-            _details::dx_fft_type_helper<_Element_type>::dx_type, 
-            _Dim, 
-            &_Transform_extent[0], 
-            _Av, 
-            _Forward_scale, 
-            _Inverse_scale)
+        extent_type _Transform_extent,
+        precision_type _Forward_scale = 0,
+        precision_type _Inverse_scale = 0)
+        :extent(_Transform_extent)
+    {
+        initialize(_Forward_scale, _Inverse_scale);
+    }
+#endif
+
+    //--------------------------------------------------------------------------------------
+    // Scales applied to the results of the forward and inverse transforms. A value of
+    // zero may NOT be used and results in an fft_exception.
+    //--------------------------------------------------------------------------------------
+    void set_forward_scale(precision_type scale)
+    {
+        if (scale == 0)
+            throw fft_exception("Invalid scale value in set_forward_scale", E_INVALIDARG);
+
+#ifdef _AMP_FFT_DIRECT3D
+        if (_M_direct3d)
+            _M_direct3d->set_forward_scale(static_cast<float>(scale));
+#endif
+        _M_forward_scale = scale;
+    }
+
+    precision_type get_forward_scale() const
+    {
+        return _M_forward_scale;
+    }
+
+    void set_inverse_scale(precision_type scale)
+    {
+        if (scale == 0)
+            throw fft_exception("Invalid scale value in set_inverse_scale", E_INVALIDARG);
+
+#ifdef _AMP_FFT_DIRECT3D
+        if (_M_direct3d)
+            _M_direct3d->set_inverse_scale(static_cast<float>(scale));
+#endif
+        _M_inverse_scale = scale;
+    }
+
+    precision_type get_inverse_scale() const
     {
+        return _M_inverse_scale;
     }
 
+#ifdef _AMP_FFT_HAS_AMP
     //--------------------------------------------------------------------------------------
-    // Forward transform. 
-    //  -- Throws fft_exception on failure. 
+    // Forward transform.
+    //  -- Throws fft_exception on failure.
     //  -- Arrays extents must be identical to those of the fft object.
-    //  -- It is permissible for the input and output arrays to be references to the same 
+    //  -- It is permissible for the input and output arrays to be references to the same
     //     array.
     //--------------------------------------------------------------------------------------
-    void forward_transform(const concurrency::array<_Element_type, _Dim>& input, concurrency::array<std::complex<typename _details::dx_fft_type_helper<_Element_type>::precision_type>, _Dim>& output) const
+    void forward_transform(const concurrency::array<_Element_type, _Dim>& input, concurrency::array<complex_type, _Dim>& output) const
     {
         transform(true, input, output);
     }
 
     //--------------------------------------------------------------------------------------
-    // Inverse transform. 
-    //  -- Throws fft_exception on failure. 
+    // Inverse transform.
+    //  -- Throws fft_exception on failure.
     //  -- Arrays extents must be identical to those of the fft object.
-    //  -- It is permissible for the input and output arrays to be references to the same 
+    //  -- It is permissible for the input and output arrays to be references to the same
     //     array.
     //--------------------------------------------------------------------------------------
-    void inverse_transform(const concurrency::array<std::complex<typename _details::dx_fft_type_helper<_Element_type>::precision_type>, _Dim>& input, concurrency::array<_Element_type, _Dim>& output) const
+    void inverse_transform(const concurrency::array<complex_type, _Dim>& input, concurrency::array<_Element_type, _Dim>& output) const
     {
         transform(false, input, output);
     }
+#endif
+
+    //--------------------------------------------------------------------------------------
+    // Forward transform of host data.
+    //  -- Throws fft_exception on failure.
+    //  -- Both pointers address extent.size() elements in row major order.
+    //  -- The input and output may be the same memory for complex element types.
+    //--------------------------------------------------------------------------------------
+    void forward_transform(const _Element_type* input, complex_type* output) const
+    {
+        host_transform(true, input, output);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Inverse transform of host data.
+    //  -- Throws fft_exception on failure.
+    //  -- Both pointers address extent.size() elements in row major order.
+    //  -- The input and output may be the same memory for complex element types.
+    //--------------------------------------------------------------------------------------
+    void inverse_transform(const complex_type* input, _Element_type* output) const
+    {
+        host_transform(false, input, output);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Batched forward transform of host data.
+    //  -- Throws fft_exception on failure.
+    //  -- Transforms batch_count data sets with the extent of the fft. Element i (the row
+    //     major index within extent) of data set b is read from
+    //     input[b*input_distance + i*input_stride] and its transform is written to
+    //     output[b*output_distance + i*output_stride].
+    //  -- For complex element types the transform may be in place: input equal to output
+    //     with identical strides and distances.
+    //  -- Batches always run on the host, with the data sets spread over the threads.
+    //--------------------------------------------------------------------------------------
+    void forward_transform(int batch_count, const _Element_type* input, int input_stride, int input_distance, complex_type* output, int output_stride, int output_distance) const
+    {
+        host_batch_transform(true, batch_count, input, input_stride, input_distance, output, output_stride, output_distance);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Batched inverse transform of host data.
+    //  -- Throws fft_exception on failure.
+    //  -- The layout of the data sets is described in the same way as for the batched
+    //     forward transform.
+    //  -- For complex element types the transform may be in place: input equal to output
+    //     with identical strides and distances.
+    //--------------------------------------------------------------------------------------
+    void inverse_transform(int batch_count, const complex_type* input, int input_stride, int input_distance, _Element_type* output, int output_stride, int output_distance) const
+    {
+        host_batch_transform(false, batch_count, input, input_stride, input_distance, output, output_stride, output_distance);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Out-of-core forward transform, for data which does not fit in memory.
+    //  -- Throws fft_exception on failure.
+    //  -- input_path is a binary file holding the elements of the extent in row major
+    //     order. The complete spectrum is written to output_path the same way; the file is
+    //     created if needed and resized to fit.
+    //  -- For complex element types output_path may be the same file as input_path.
+    //  -- About memory_limit bytes of memory are used; the transform streams the file
+    //     through memory in as few passes as the limit allows. One dimensional transforms
+    //     need a temporary file next to output_path, as do inverse transforms of real
+    //     element types.
+    //  -- Transforms of files always run on the host. Create the fft object on the CPU
+    //     accelerator for extents which do not fit in the memory of an accelerator.
+    //--------------------------------------------------------------------------------------
+    void forward_transform_file(const std::string& input_path, const std::string& output_path, std::size_t memory_limit) const
+    {
+        file_transform<_Element_type, complex_type>(true, input_path, output_path, memory_limit);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Out-of-core inverse transform, for data which does not fit in memory.
+    //  -- Throws fft_exception on failure.
+    //  -- The files and the memory limit are used in the same way as for the out-of-core
+    //     forward transform.
+    //--------------------------------------------------------------------------------------
+    void inverse_transform_file(const std::string& input_path, const std::string& output_path, std::size_t memory_limit) const
+    {
+        file_transform<complex_type, _Element_type>(false, input_path, output_path, memory_limit);
+    }
 
     //--------------------------------------------------------------------------------------
     // The extent of the fft transform.
     //--------------------------------------------------------------------------------------
-    const concurrency::extent<_Dim> extent;
+    const extent_type extent;
 
 private:
 
+    void initialize(precision_type _Forward_scale, precision_type _Inverse_scale)
+    {
+        // out-of-core extents may hold more elements than extent.size() can count
+        std::vector<int> dims(_Dim);
+        precision_type element_count = 1;
+        for (int i = 0; i < _Dim; i++)
+        {
+            if (extent[i] <= 0)
+                throw fft_exception("The transform extent is invalid", E_INVALIDARG);
+            dims[i] = extent[i];
+            element_count *= extent[i];
+        }
+
+        try
+        {
+            _M_plan = _details::get_fft_plan<precision_type>(dims, !_details::fft_type_helper<_Element_type>::is_complex);
+        }
+        catch (const std::bad_alloc&)
+        {
+            throw fft_exception("Failed in fft constructor", E_OUTOFMEMORY);
+        }
+
+        _M_forward_scale = (_Forward_scale != 0) ? _Forward_scale : precision_type(1);
+        _M_inverse_scale = (_Inverse_scale != 0) ? _Inverse_scale : precision_type(1) / element_count;
+    }
+
+    template <typename _Input_element_type, typename _Output_element_type>
+    void host_transform(bool _Forward, const _Input_element_type* _Input, _Output_element_type* _Output) const
+    {
+        if (_Input == nullptr || _Output == nullptr)
+            throw fft_exception("The data of a transform may not be null", E_INVALIDARG);
+
+        try
+        {
+            _M_plan->execute(_Forward, _Input, _Output, _Forward ? _M_forward_scale : _M_inverse_scale);
+        }
+        catch (const std::bad_alloc&)
+        {
+            throw fft_exception("Out of memory in transform", E_OUTOFMEMORY);
+        }
+    }
+
+    template <typename _Input_element_type, typename _Output_element_type>
+    void host_batch_transform(bool _Forward, int _Batch_count, const _Input_element_type* _Input, int _Input_stride, int _Input_distance, _Output_element_type* _Output, int _Output_stride, int _Output_distance) const
+    {
+        if (_Batch_count < 0)
+            throw fft_exception("The batch count in transform is invalid", E_INVALIDARG);
+
+        if (_Input_stride < 1 || _Output_stride < 1)
+            throw fft_exception("The strides in transform must be positive", E_INVALIDARG);
+
+        if (_Input_distance < 0 || _Output_distance < 0)
+            throw fft_exception("The distances in transform may not be negative", E_INVALIDARG);
+
+        if (_Batch_count == 0)
+            return;
+
+        if (_Input == nullptr || _Output == nullptr)
+            throw fft_exception("The data of a transform may not be null", E_INVALIDARG);
+
+        try
+        {
+            _M_plan->execute_batch(_Forward, _Batch_count, _Input, _Input_stride, _Input_distance, _Output, _Output_stride, _Output_distance, _Forward ? _M_forward_scale : _M_inverse_scale);
+        }
+        catch (const std::bad_alloc&)
+        {
+            throw fft_exception("Out of memory in transform", E_OUTOFMEMORY);
+        }
+    }
+
+    template <typename _Input_element_type, typename _Output_element_type>
+    void file_transform(bool _Forward, const std::string& _Input_path, const std::string& _Output_path, std::size_t _Memory_limit) const
+    {
+        // a spectrum is larger than the reals it overwrites
+        if (!_details::fft_type_helper<_Element_type>::is_complex && _Input_path == _Output_path)
+            throw fft_exception("The output of a real transform must be a different file", E_INVALIDARG);
+
+        std::vector<int> dims(_Dim);
+        for (int i = 0; i < _Dim; i++)
+            dims[i] = extent[i];
+
+        try
+        {
+            _details::fft_out_of_core<precision_type> plan(dims, _Memory_limit);
+            plan.template execute<_Input_element_type, _Output_element_type>(_Forward, _Input_path, _Output_path, _Forward ? _M_forward_scale : _M_inverse_scale);
+        }
+        catch (const std::bad_alloc&)
+        {
+            throw fft_exception("Out of memory in transform", E_OUTOFMEMORY);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            throw fft_exception(e.what(), E_INVALIDARG);
+        }
+        catch (const _details::fft_file_error& e)
+        {
+            throw fft_exception(e.what(), E_FAIL);
+        }
+    }
+
+#ifdef _AMP_FFT_HAS_AMP
     template <typename _Input_element_type, typename _Output_element_type>
     void transform(bool _Forward, const concurrency::array<_Input_element_type, _Dim>& _Input, concurrency::array<_Output_element_type, _Dim>& _Output) const
     {
@@ -218,16 +666,39 @@ private:
         if (_Output.extent != extent)
             throw fft_exception("The output extent in transform is invalid", E_INVALIDARG);
 
-        HRESULT hr = S_OK;
+#ifdef _AMP_FFT_DIRECT3D
+        if (_M_direct3d)
+        {
+            HRESULT hr = S_OK;
+
+            Microsoft::WRL::ComPtr<ID3D11Buffer> pBufferIn;
+            concurrency::direct3d::get_buffer(_Input)->QueryInterface(__uuidof(ID3D11Buffer), reinterpret_cast<void**>(pBufferIn.GetAddressOf()));
+
+            Microsoft::WRL::ComPtr<ID3D11Buffer> pBufferOut;
+            concurrency::direct3d::get_buffer(_Output)->QueryInterface(__uuidof(ID3D11Buffer), reinterpret_cast<void**>(pBufferOut.GetAddressOf()));
+
+            hr = _M_direct3d->base_transform(_Forward, pBufferIn.Get(), pBufferOut.Get());
 
-        Microsoft::WRL::ComPtr<ID3D11Buffer> pBufferIn;
-        direct3d::get_buffer(_Input)->QueryInterface(__uuidof(ID3D11Buffer), reinterpret_cast<void**>(pBufferIn.GetAddressOf()));
-        
-        Microsoft::WRL::ComPtr<ID3D11Buffer> pBufferOut;
-        direct3d::get_buffer(_Output)->QueryInterface(__uuidof(ID3D11Buffer), reinterpret_cast<void**>(pBufferOut.GetAddressOf()));
-        
-        hr = base_transform(_Forward, pBufferIn.Get(), pBufferOut.Get());
+            if (FAILED(hr)) throw fft_exception("transform failed", hr);
+            return;
+        }
+#endif
+
+        // stage through host memory for the host engine
+        std::vector<_Input_element_type> input(extent.size());
+        std::vector<_Output_element_type> output(extent.size());
 
-        if (FAILED(hr)) throw fft_exception("transform failed", hr);
+        concurrency::copy(_Input, input.begin());
+        host_transform(_Forward, input.data(), output.data());
+        concurrency::copy(output.begin(), output.end(), _Output);
     }
+#endif
+
+    std::shared_ptr<const _details::fft_plan<precision_type>> _M_plan;
+    precision_type _M_forward_scale;
+    precision_type _M_inverse_scale;
+
+#ifdef _AMP_FFT_DIRECT3D
+    std::shared_ptr<_details::fft_base> _M_direct3d;
+#endif
 };
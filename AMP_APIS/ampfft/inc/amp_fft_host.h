@@ -0,0 +1,1063 @@
+//--------------------------------------------------------------------------------------
+// File: amp_fft_host.h
+//
+// Portable host FFT engine behind class fft. It is used for double precision data,
+// for the CPU accelerator, for host pointers and on platforms without Direct3D, and
+// has no dependency on C++ AMP.
+//
+// A number of important notes regarding the implementation:
+//
+// Transforms are mixed radix Stockham autosort FFTs with radix 2, 3, 4, 5 and 7
+// butterflies (other prime factors use a generic odd radix butterfly). Every stage
+// applies the same twiddle to a run of consecutive elements, so the inner loops have
+// unit stride and are vectorized by the compiler. Multi-dimensional transforms
+// process all the columns of a slab at once by treating them as interleaved
+// sequences, which keeps the column passes unit stride as well.
+//
+// Real transforms pack n real values into n/2 complex values, run a half length
+// complex transform and split the result using Hermitian symmetry. Only half of the
+// spectrum is computed along the other dimensions; the rest is filled in by symmetry.
+//
+// Plans (factorizations, twiddles and scratch buffers) are cached per extent and
+// element type, so fft objects of the same shape share them.
+//
+// Batched transforms spread the data sets of a batch over the threads, each thread
+// running whole transforms with its own scratch; strided data sets are gathered into
+// contiguous scratch first. Batches with fewer data sets than threads parallelize
+// within each transform instead.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace _details
+{
+    //----------------------------------------------------------------------------------
+    // Worker threads used by the host engine. The calling thread takes part in each
+    // loop; loops issued while another one is running are executed serially.
+    //
+    // This is the same pool as ampblas::_detail::thread_pool (ampblas/inc/utility/
+    // thread_pool.h), kept as a copy on purpose: ampfft is built and released on its
+    // own with only its inc directory on the include path, and this header must not
+    // need C++ AMP, while the ampblas pool comes with ampblas_config.h and thus amp.h.
+    // Fixes to either pool should be applied to both.
+    //----------------------------------------------------------------------------------
+    class fft_thread_pool
+    {
+    public:
+        explicit fft_thread_pool(unsigned int _Worker_count)
+            : _M_generation(0), _M_pending(0), _M_stopping(false), _M_next(0), _M_limit(0)
+        {
+            for (unsigned int i = 0; i < _Worker_count; i++)
+                _M_workers.push_back(std::thread(&fft_thread_pool::worker_loop, this));
+        }
+
+        ~fft_thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_M_state_mutex);
+                _M_stopping = true;
+            }
+            _M_wake.notify_all();
+
+            for (auto it = _M_workers.begin(); it != _M_workers.end(); ++it)
+                it->join();
+        }
+
+        // number of threads taking part in a parallel_for
+        int concurrency() const
+        {
+            return static_cast<int>(_M_workers.size()) + 1;
+        }
+
+        // executes _Body(i) for i in [0, _Count)
+        template <typename _Function_type>
+        void parallel_for(int _Count, const _Function_type& _Body)
+        {
+            if (_Count <= 0)
+                return;
+
+            std::unique_lock<std::mutex> loop_lock(_M_loop_mutex, std::try_to_lock);
+            if (_Count == 1 || _M_workers.empty() || !loop_lock.owns_lock())
+            {
+                for (int i = 0; i < _Count; i++)
+                    _Body(i);
+                return;
+            }
+
+            _M_job = [&_Body](int i) { _Body(i); };
+            _M_error = nullptr;
+            _M_limit = _Count;
+            _M_next.store(0);
+
+            {
+                std::lock_guard<std::mutex> lock(_M_state_mutex);
+                _M_pending = static_cast<int>(_M_workers.size());
+                _M_generation++;
+            }
+            _M_wake.notify_all();
+
+            run_iterations();
+
+            {
+                std::unique_lock<std::mutex> lock(_M_state_mutex);
+                _M_done.wait(lock, [this] { return _M_pending == 0; });
+            }
+
+            _M_job = nullptr;
+            if (_M_error)
+                std::rethrow_exception(_M_error);
+        }
+
+    private:
+        fft_thread_pool(const fft_thread_pool&);
+        fft_thread_pool& operator=(const fft_thread_pool&);
+
+        void worker_loop()
+        {
+            unsigned long long seen = 0;
+
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_M_state_mutex);
+                    _M_wake.wait(lock, [&] { return _M_stopping || _M_generation != seen; });
+                    if (_M_stopping)
+                        return;
+                    seen = _M_generation;
+                }
+
+                run_iterations();
+
+                {
+                    std::lock_guard<std::mutex> lock(_M_state_mutex);
+                    if (--_M_pending == 0)
+                        _M_done.notify_one();
+                }
+            }
+        }
+
+        void run_iterations()
+        {
+            for (;;)
+            {
+                const int i = _M_next.fetch_add(1);
+                if (i >= _M_limit)
+                    return;
+
+                try
+                {
+                    _M_job(i);
+                }
+                catch (...)
+                {
+                    // keep the first exception and abandon the remaining iterations
+                    std::lock_guard<std::mutex> lock(_M_state_mutex);
+                    if (!_M_error)
+                        _M_error = std::current_exception();
+                    _M_next.store(_M_limit);
+                }
+            }
+        }
+
+        std::vector<std::thread> _M_workers;
+
+        // worker signalling
+        std::mutex _M_state_mutex;
+        std::condition_variable _M_wake;
+        std::condition_variable _M_done;
+        unsigned long long _M_generation;
+        int _M_pending;
+        bool _M_stopping;
+
+        // current loop
+        std::mutex _M_loop_mutex;
+        std::function<void(int)> _M_job;
+        std::exception_ptr _M_error;
+        std::atomic<int> _M_next;
+        int _M_limit;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Number of host threads: AMP_FFT_NUM_THREADS if set, otherwise one per hardware
+    // thread.
+    //--------------------------------------------------------------------------------------
+    inline unsigned int fft_host_thread_count()
+    {
+        const char* env = std::getenv("AMP_FFT_NUM_THREADS");
+        if (env != nullptr && std::atoi(env) > 0)
+            return static_cast<unsigned int>(std::atoi(env));
+
+        const unsigned int hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+
+    inline fft_thread_pool& get_fft_thread_pool()
+    {
+        static fft_thread_pool pool(fft_host_thread_count() - 1);
+        return pool;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Transforms with fewer elements than this run on the calling thread.
+    //--------------------------------------------------------------------------------------
+    static const std::ptrdiff_t fft_parallel_threshold = 1 << 15;
+
+    inline int fft_workers(std::ptrdiff_t _Element_count)
+    {
+        return (_Element_count < fft_parallel_threshold) ? 1 : get_fft_thread_pool().concurrency();
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Runs _Body(_Begin, _End, _Chunk) over _Chunks contiguous chunks of [0, _Count). Each
+    // chunk is executed by a single thread, so _Chunk can index per thread scratch.
+    //--------------------------------------------------------------------------------------
+    template <typename _Function_type>
+    void fft_parallel_chunks(std::ptrdiff_t _Count, int _Chunks, const _Function_type& _Body)
+    {
+        _Chunks = static_cast<int>((std::min)(static_cast<std::ptrdiff_t>(_Chunks), _Count));
+        if (_Chunks <= 1)
+        {
+            if (_Count > 0)
+                _Body(std::ptrdiff_t(0), _Count, 0);
+            return;
+        }
+
+        get_fft_thread_pool().parallel_for(_Chunks, [&](int _Chunk) {
+            _Body(_Count * _Chunk / _Chunks, _Count * (_Chunk + 1) / _Chunks, _Chunk);
+        });
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Complex arithmetic helpers. Products are written out by hand because the library
+    // complex multiply checks for infinities and does not vectorize.
+    //--------------------------------------------------------------------------------------
+
+    // _A * _W for the forward transform and _A * conj(_W) for the inverse transform
+    template <bool _Forward, typename _Precision>
+    inline std::complex<_Precision> twiddle_mul(const std::complex<_Precision>& _A, const std::complex<_Precision>& _W)
+    {
+        const _Precision ar = _A.real(), ai = _A.imag();
+        const _Precision wr = _W.real(), wi = _W.imag();
+
+        return _Forward ? std::complex<_Precision>(ar*wr - ai*wi, ar*wi + ai*wr)
+                        : std::complex<_Precision>(ar*wr + ai*wi, ai*wr - ar*wi);
+    }
+
+    // -i * _A for the forward transform and i * _A for the inverse transform
+    template <bool _Forward, typename _Precision>
+    inline std::complex<_Precision> rotate(const std::complex<_Precision>& _A)
+    {
+        return _Forward ? std::complex<_Precision>(_A.imag(), -_A.real())
+                        : std::complex<_Precision>(-_A.imag(), _A.real());
+    }
+
+    // exp(-2 pi i _K / _N), evaluated in extended precision
+    template <typename _Precision>
+    inline std::complex<_Precision> unit_root(long long _K, long long _N)
+    {
+        const long double pi = 3.141592653589793238462643383279502884L;
+        const long double angle = -2 * pi * static_cast<long double>(_K % _N) / static_cast<long double>(_N);
+
+        return std::complex<_Precision>(static_cast<_Precision>(std::cos(angle)), static_cast<_Precision>(std::sin(angle)));
+    }
+
+    //--------------------------------------------------------------------------------------
+    // One Stockham stage of a plan.
+    //
+    // A stage of radix r over the current length n = r*m reads r elements m apart,
+    // computes an r point DFT, multiplies output k by w^(k*p) (w = exp(-2 pi i/n)) and
+    // writes the r results next to each other. Sequences are interleaved _Count apart
+    // and the previous stages have produced _L sub-sequences, so consecutive elements
+    // of the inner loop sit at unit stride and share the same twiddle.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    struct fft_stage
+    {
+        typedef std::complex<_Precision> complex_type;
+
+        int radix;
+        int m;
+
+        // twiddles[p*(radix-1) + k-1] = w^(k*p)
+        std::vector<complex_type> twiddles;
+
+        // cos and sin of 2 pi t/radix for the odd radix butterflies
+        std::vector<_Precision> cos_table;
+        std::vector<_Precision> sin_table;
+    };
+
+    // r point DFT of a into b
+    template <int _Radix, bool _Forward, typename _Precision>
+    inline void fft_butterfly(int _R, std::complex<_Precision>* _A, std::complex<_Precision>* _B, const fft_stage<_Precision>& _Stage)
+    {
+        typedef std::complex<_Precision> complex_type;
+
+        if (_Radix == 2)
+        {
+            _B[0] = _A[0] + _A[1];
+            _B[1] = _A[0] - _A[1];
+        }
+        else if (_Radix == 4)
+        {
+            const complex_type t0 = _A[0] + _A[2];
+            const complex_type t1 = _A[0] - _A[2];
+            const complex_type t2 = _A[1] + _A[3];
+            const complex_type t3 = rotate<_Forward>(_A[1] - _A[3]);
+
+            _B[0] = t0 + t2;
+            _B[1] = t1 + t3;
+            _B[2] = t0 - t2;
+            _B[3] = t1 - t3;
+        }
+        else
+        {
+            // odd radix: pair inputs j and r-j so every product is real
+            const int r = (_Radix != 0 ? _Radix : _R);
+            const int h = r / 2;
+            const _Precision* c = _Stage.cos_table.data();
+            const _Precision* s = _Stage.sin_table.data();
+
+            complex_type sum = _A[0];
+            for (int j = 1; j <= h; j++)
+            {
+                const complex_type p = _A[j] + _A[r-j];
+                const complex_type d = _A[j] - _A[r-j];
+                _A[j] = p;
+                _A[r-j] = d;
+                sum += p;
+            }
+            _B[0] = sum;
+
+            for (int k = 1; k <= h; k++)
+            {
+                _Precision re_r = _A[0].real(), re_i = _A[0].imag();
+                _Precision im_r = 0, im_i = 0;
+
+                int t = 0;
+                for (int j = 1; j <= h; j++)
+                {
+                    // t = j*k mod r
+                    t += k;
+                    if (t >= r)
+                        t -= r;
+
+                    re_r += _A[j].real() * c[t];
+                    re_i += _A[j].imag() * c[t];
+                    im_r += _A[r-j].real() * s[t];
+                    im_i += _A[r-j].imag() * s[t];
+                }
+
+                const complex_type re(re_r, re_i);
+                const complex_type im = rotate<_Forward>(complex_type(im_r, im_i));
+
+                _B[k] = re + im;
+                _B[r-k] = re - im;
+            }
+        }
+    }
+
+    template <int _Radix, bool _Forward, typename _Precision>
+    void stockham_stage(const fft_stage<_Precision>& _Stage, const std::complex<_Precision>* _X, std::complex<_Precision>* _Y, std::ptrdiff_t _Count, std::ptrdiff_t _L, std::ptrdiff_t _First, std::ptrdiff_t _Last)
+    {
+        typedef std::complex<_Precision> complex_type;
+
+        const int r = (_Radix != 0 ? _Radix : _Stage.radix);
+        const int m = _Stage.m;
+        const std::ptrdiff_t s = _Count * _L;
+        const std::ptrdiff_t sm = s * m;
+        const complex_type* tw = _Stage.twiddles.data();
+
+        // butterfly inputs and outputs
+        complex_type fixed_a[_Radix != 0 ? _Radix : 1];
+        complex_type fixed_b[_Radix != 0 ? _Radix : 1];
+        std::vector<complex_type> dynamic_a(_Radix != 0 ? 0 : r);
+        std::vector<complex_type> dynamic_b(_Radix != 0 ? 0 : r);
+        complex_type* a = (_Radix != 0 ? fixed_a : dynamic_a.data());
+        complex_type* b = (_Radix != 0 ? fixed_b : dynamic_b.data());
+
+        auto butterfly = [&](std::ptrdiff_t _Q, int _P)
+        {
+            const complex_type* x = _X + _Q + s*_P;
+            for (int k = 0; k < r; k++)
+                a[k] = x[sm*k];
+
+            fft_butterfly<_Radix, _Forward>(r, a, b, _Stage);
+
+            complex_type* y = _Y + _Q + s*r*_P;
+            const complex_type* w = tw + _P*(r-1);
+            y[0] = b[0];
+            for (int k = 1; k < r; k++)
+                y[s*k] = twiddle_mul<_Forward>(b[k], w[k-1]);
+        };
+
+        if (_First == 0 && _Last == _Count)
+        {
+            // all sequences: one run of s elements per twiddle
+            if (s >= 8)
+            {
+                for (int p = 0; p < m; p++)
+                    for (std::ptrdiff_t q = 0; q < s; q++)
+                        butterfly(q, p);
+            }
+            else
+            {
+                for (std::ptrdiff_t q = 0; q < s; q++)
+                    for (int p = 0; p < m; p++)
+                        butterfly(q, p);
+            }
+        }
+        else
+        {
+            // a subset of the sequences: sequence q of sub-sequence j is at q + _Count*j
+            for (int p = 0; p < m; p++)
+                for (std::ptrdiff_t j = 0; j < _L; j++)
+                    for (std::ptrdiff_t q = _First; q < _Last; q++)
+                        butterfly(q + _Count*j, p);
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // One dimensional complex plan.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    class fft_plan_1d
+    {
+    public:
+        typedef std::complex<_Precision> complex_type;
+
+        explicit fft_plan_1d(int _Length)
+            : _M_length(_Length)
+        {
+            // radix 4 first, then the small primes, then whatever is left
+            std::vector<int> radices;
+            int n = _Length;
+            while (n % 4 == 0) { radices.push_back(4); n /= 4; }
+            while (n % 2 == 0) { radices.push_back(2); n /= 2; }
+            for (int f = 3; f <= n; f += 2)
+            {
+                while (n % f == 0) { radices.push_back(f); n /= f; }
+                if (f*f > n && n > 1) { radices.push_back(n); break; }
+            }
+
+            n = _Length;
+            for (auto it = radices.begin(); it != radices.end(); ++it)
+            {
+                fft_stage<_Precision> stage;
+                stage.radix = *it;
+                stage.m = n / stage.radix;
+
+                stage.twiddles.resize(static_cast<size_t>(stage.m) * (stage.radix - 1));
+                for (int p = 0; p < stage.m; p++)
+                    for (int k = 1; k < stage.radix; k++)
+                        stage.twiddles[p*(stage.radix-1) + k-1] = unit_root<_Precision>(static_cast<long long>(k) * p, n);
+
+                if (stage.radix % 2 == 1)
+                {
+                    for (int t = 0; t < stage.radix; t++)
+                    {
+                        const complex_type w = unit_root<_Precision>(t, stage.radix);
+                        stage.cos_table.push_back(w.real());
+                        stage.sin_table.push_back(-w.imag());
+                    }
+                }
+
+                _M_stages.push_back(stage);
+                n = stage.m;
+            }
+        }
+
+        int length() const
+        {
+            return _M_length;
+        }
+
+        //--------------------------------------------------------------------------------------
+        // Transforms the sequences [_First, _Last) of _Count interleaved sequences in place;
+        // element k of sequence q is _Data[q + _Count*k]. _Work must be as large as _Data and
+        // only the elements of the selected sequences are touched in either buffer.
+        //--------------------------------------------------------------------------------------
+        void execute(bool _Forward, complex_type* _Data, complex_type* _Work, std::ptrdiff_t _Count, std::ptrdiff_t _First, std::ptrdiff_t _Last) const
+        {
+            const complex_type* src = _Data;
+            complex_type* dst = _Work;
+            std::ptrdiff_t l = 1;
+
+            for (auto it = _M_stages.begin(); it != _M_stages.end(); ++it)
+            {
+                if (_Forward)
+                    run_stage<true>(*it, src, dst, _Count, l, _First, _Last);
+                else
+                    run_stage<false>(*it, src, dst, _Count, l, _First, _Last);
+
+                l *= it->radix;
+                src = dst;
+                dst = (dst == _Work ? _Data : _Work);
+            }
+
+            // an odd number of stages leaves the result in the work buffer
+            if (src != _Data)
+            {
+                for (std::ptrdiff_t k = 0; k < _M_length; k++)
+                    std::copy(src + _Count*k + _First, src + _Count*k + _Last, _Data + _Count*k + _First);
+            }
+        }
+
+    private:
+        template <bool _Forward>
+        static void run_stage(const fft_stage<_Precision>& _Stage, const complex_type* _X, complex_type* _Y, std::ptrdiff_t _Count, std::ptrdiff_t _L, std::ptrdiff_t _First, std::ptrdiff_t _Last)
+        {
+            switch (_Stage.radix)
+            {
+            case 2: stockham_stage<2, _Forward>(_Stage, _X, _Y, _Count, _L, _First, _Last); break;
+            case 3: stockham_stage<3, _Forward>(_Stage, _X, _Y, _Count, _L, _First, _Last); break;
+            case 4: stockham_stage<4, _Forward>(_Stage, _X, _Y, _Count, _L, _First, _Last); break;
+            case 5: stockham_stage<5, _Forward>(_Stage, _X, _Y, _Count, _L, _First, _Last); break;
+            case 7: stockham_stage<7, _Forward>(_Stage, _X, _Y, _Count, _L, _First, _Last); break;
+            default: stockham_stage<0, _Forward>(_Stage, _X, _Y, _Count, _L, _First, _Last); break;
+            }
+        }
+
+        int _M_length;
+        std::vector<fft_stage<_Precision>> _M_stages;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Plan cache. Plans stay cached while they are small in number; once the cache is
+    // full, plans which are no longer referenced by any fft object are dropped.
+    //--------------------------------------------------------------------------------------
+    template <typename _Key_type, typename _Plan_type>
+    class fft_plan_cache
+    {
+    public:
+        template <typename _Factory_type>
+        std::shared_ptr<const _Plan_type> get(const _Key_type& _Key, const _Factory_type& _Factory)
+        {
+            std::lock_guard<std::mutex> lock(_M_mutex);
+
+            auto it = _M_plans.find(_Key);
+            if (it != _M_plans.end())
+                return it->second;
+
+            if (_M_plans.size() >= capacity)
+            {
+                for (auto p = _M_plans.begin(); p != _M_plans.end(); )
+                {
+                    if (p->second.use_count() == 1)
+                        p = _M_plans.erase(p);
+                    else
+                        ++p;
+                }
+            }
+
+            std::shared_ptr<const _Plan_type> plan = _Factory();
+            _M_plans.insert(std::make_pair(_Key, plan));
+            return plan;
+        }
+
+    private:
+        static const size_t capacity = 64;
+
+        std::mutex _M_mutex;
+        std::map<_Key_type, std::shared_ptr<const _Plan_type>> _M_plans;
+    };
+
+    template <typename _Precision>
+    std::shared_ptr<const fft_plan_1d<_Precision>> get_fft_plan_1d(int _Length)
+    {
+        static fft_plan_cache<int, fft_plan_1d<_Precision>> cache;
+
+        return cache.get(_Length, [=]() {
+            return std::make_shared<fft_plan_1d<_Precision>>(_Length);
+        });
+    }
+
+    //--------------------------------------------------------------------------------------
+    // One dimensional real plan; the spectrum of n reals is stored as its first n/2+1
+    // complex values.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    class fft_real_plan_1d
+    {
+    public:
+        typedef std::complex<_Precision> complex_type;
+
+        explicit fft_real_plan_1d(int _Length)
+            : _M_length(_Length), _M_half(_Length / 2)
+        {
+            if (_Length % 2 == 0)
+            {
+                _M_plan = get_fft_plan_1d<_Precision>(_M_half);
+
+                for (int k = 0; k <= _M_half; k++)
+                    _M_twiddles.push_back(unit_root<_Precision>(k, _Length));
+            }
+            else
+            {
+                // odd lengths are transformed as complex data
+                _M_plan = get_fft_plan_1d<_Precision>(_Length);
+            }
+        }
+
+        // number of complex values in the spectrum
+        int spectrum_length() const
+        {
+            return _M_half + 1;
+        }
+
+        // number of complex values of scratch needed per transform
+        std::ptrdiff_t work_length() const
+        {
+            return 2 * static_cast<std::ptrdiff_t>(_M_length);
+        }
+
+        // _Output receives spectrum_length() values
+        void forward(const _Precision* _Input, complex_type* _Output, complex_type* _Work) const
+        {
+            const int n = _M_length;
+            const int h = _M_half;
+
+            if (n % 2 != 0)
+            {
+                for (int j = 0; j < n; j++)
+                    _Work[j] = complex_type(_Input[j]);
+
+                _M_plan->execute(true, _Work, _Work + n, 1, 0, 1);
+                std::copy(_Work, _Work + h + 1, _Output);
+                return;
+            }
+
+            // z[j] = x[2j] + i x[2j+1]
+            for (int j = 0; j < h; j++)
+                _Output[j] = complex_type(_Input[2*j], _Input[2*j+1]);
+
+            _M_plan->execute(true, _Output, _Work, 1, 0, 1);
+
+            // split into the transforms of the even and odd samples and combine
+            const complex_type z0 = _Output[0];
+            _Output[0] = complex_type(z0.real() + z0.imag());
+            _Output[h] = complex_type(z0.real() - z0.imag());
+
+            for (int k = 1; k <= h/2; k++)
+            {
+                const complex_type zk = _Output[k];
+                const complex_type zc = std::conj(_Output[h-k]);
+
+                const complex_type even = (zk + zc) * _Precision(0.5);
+                const complex_type odd = twiddle_mul<true>(rotate<true>(zk - zc) * _Precision(0.5), _M_twiddles[k]);
+
+                _Output[k] = even + odd;
+                _Output[h-k] = std::conj(even - odd);
+            }
+        }
+
+        // unnormalized inverse: _Output receives n times the real sequence
+        void inverse(const complex_type* _Input, _Precision* _Output, complex_type* _Work) const
+        {
+            const int n = _M_length;
+            const int h = _M_half;
+
+            if (n % 2 != 0)
+            {
+                // rebuild the full spectrum
+                _Work[0] = _Input[0];
+                for (int k = 1; k <= h; k++)
+                {
+                    _Work[k] = _Input[k];
+                    _Work[n-k] = std::conj(_Input[k]);
+                }
+
+                _M_plan->execute(false, _Work, _Work + n, 1, 0, 1);
+
+                for (int j = 0; j < n; j++)
+                    _Output[j] = _Work[j].real();
+                return;
+            }
+
+            // z[k] = 2 (even[k] + i odd[k])
+            for (int k = 0; k < h; k++)
+            {
+                const complex_type xk = _Input[k];
+                const complex_type xc = std::conj(_Input[h-k]);
+
+                const complex_type odd = twiddle_mul<false>(xk - xc, _M_twiddles[k]);
+                _Work[k] = (xk + xc) + rotate<false>(odd);
+            }
+
+            _M_plan->execute(false, _Work, _Work + h, 1, 0, 1);
+
+            for (int j = 0; j < h; j++)
+            {
+                _Output[2*j] = _Work[j].real();
+                _Output[2*j+1] = _Work[j].imag();
+            }
+        }
+
+    private:
+        int _M_length;
+        int _M_half;
+        std::shared_ptr<const fft_plan_1d<_Precision>> _M_plan;
+        std::vector<complex_type> _M_twiddles;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Scratch buffers handed out to transforms; a buffer is returned to the pool when the
+    // lease goes out of scope.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    class fft_scratch_pool
+    {
+    public:
+        typedef std::vector<std::complex<_Precision>> buffer_type;
+
+        class lease
+        {
+        public:
+            lease(fft_scratch_pool& _Pool, std::ptrdiff_t _Size)
+                : _M_pool(_Pool), _M_buffer(_Pool.acquire())
+            {
+                if (static_cast<std::ptrdiff_t>(_M_buffer->size()) < _Size)
+                    _M_buffer->resize(static_cast<size_t>(_Size));
+            }
+
+            ~lease()
+            {
+                _M_pool.release(std::move(_M_buffer));
+            }
+
+            std::complex<_Precision>* data() const
+            {
+                return _M_buffer->data();
+            }
+
+        private:
+            lease(const lease&);
+            lease& operator=(const lease&);
+
+            fft_scratch_pool& _M_pool;
+            std::unique_ptr<buffer_type> _M_buffer;
+        };
+
+    private:
+        std::unique_ptr<buffer_type> acquire()
+        {
+            std::lock_guard<std::mutex> lock(_M_mutex);
+
+            if (_M_buffers.empty())
+                return std::unique_ptr<buffer_type>(new buffer_type);
+
+            std::unique_ptr<buffer_type> buffer = std::move(_M_buffers.back());
+            _M_buffers.pop_back();
+            return buffer;
+        }
+
+        void release(std::unique_ptr<buffer_type> _Buffer)
+        {
+            std::lock_guard<std::mutex> lock(_M_mutex);
+            _M_buffers.push_back(std::move(_Buffer));
+        }
+
+        std::mutex _M_mutex;
+        std::vector<std::unique_ptr<buffer_type>> _M_buffers;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Multi-dimensional plan over a row major extent (the last dimension is contiguous).
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    class fft_plan
+    {
+    public:
+        typedef std::complex<_Precision> complex_type;
+
+        fft_plan(const std::vector<int>& _Dims, bool _Real)
+            : _M_dims(_Dims), _M_size(1)
+        {
+            for (auto it = _Dims.begin(); it != _Dims.end(); ++it)
+            {
+                _M_size *= *it;
+                _M_axes.push_back(get_fft_plan_1d<_Precision>(*it));
+            }
+
+            if (_Real)
+                _M_real = std::make_shared<fft_real_plan_1d<_Precision>>(_Dims.back());
+        }
+
+        std::ptrdiff_t size() const
+        {
+            return _M_size;
+        }
+
+        //--------------------------------------------------------------------------------------
+        // Complex to complex, real to complex (_Output receives the full Hermitian spectrum)
+        // and complex to real (only the first n/2+1 values of each row are read). For complex
+        // to complex transforms _Input may be the same as _Output.
+        //--------------------------------------------------------------------------------------
+        template <typename _Input_type, typename _Output_type>
+        void execute(bool _Forward, const _Input_type* _Input, _Output_type* _Output, _Precision _Scale) const
+        {
+            const int workers = fft_workers(_M_size);
+            typename fft_scratch_pool<_Precision>::lease work(_M_scratch, work_length(workers));
+
+            transform(_Forward, _Input, _Output, _Scale, work.data(), workers);
+        }
+
+        //--------------------------------------------------------------------------------------
+        // Batched transforms. Element i (the row major index within the extent) of transform
+        // b is read from _Input[b*_Input_distance + i*_Input_stride] and written to
+        // _Output[b*_Output_distance + i*_Output_stride]. Complex to complex transforms may
+        // be in place, with the same pointer, strides and distances for input and output.
+        //--------------------------------------------------------------------------------------
+        template <typename _Input_type, typename _Output_type>
+        void execute_batch(bool _Forward, std::ptrdiff_t _Batch,
+            const _Input_type* _Input, std::ptrdiff_t _Input_stride, std::ptrdiff_t _Input_distance,
+            _Output_type* _Output, std::ptrdiff_t _Output_stride, std::ptrdiff_t _Output_distance,
+            _Precision _Scale) const
+        {
+            if (_Batch <= 0)
+                return;
+
+            const int workers = fft_workers(_M_size * _Batch);
+
+            // many transforms are spread over the threads; a few large ones are parallelized
+            // internally (the thread pool does not nest)
+            const bool across_batch = (_Batch >= workers || fft_workers(_M_size) == 1);
+            const int chunks = across_batch ? workers : 1;
+            const int item_workers = across_batch ? 1 : workers;
+
+            fft_parallel_chunks(_Batch, chunks, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                typename fft_scratch_pool<_Precision>::lease work(_M_scratch, work_length(item_workers));
+                typename fft_scratch_pool<_Precision>::lease staging_in(_M_scratch, (_Input_stride != 1) ? _M_size : 0);
+                typename fft_scratch_pool<_Precision>::lease staging_out(_M_scratch, (_Output_stride != 1) ? _M_size : 0);
+
+                // complex buffers are large enough for real data of the same extent
+                _Input_type* staged_input = reinterpret_cast<_Input_type*>(staging_in.data());
+                _Output_type* staged_output = reinterpret_cast<_Output_type*>(staging_out.data());
+
+                for (std::ptrdiff_t b = _Begin; b < _End; b++)
+                {
+                    const _Input_type* input = _Input + b * _Input_distance;
+                    _Output_type* output = _Output + b * _Output_distance;
+
+                    if (_Input_stride != 1)
+                    {
+                        for (std::ptrdiff_t i = 0; i < _M_size; i++)
+                            staged_input[i] = input[i * _Input_stride];
+                        input = staged_input;
+                    }
+
+                    transform(_Forward, input, (_Output_stride != 1) ? staged_output : output, _Scale, work.data(), item_workers);
+
+                    if (_Output_stride != 1)
+                    {
+                        for (std::ptrdiff_t i = 0; i < _M_size; i++)
+                            output[i * _Output_stride] = staged_output[i];
+                    }
+                }
+            });
+        }
+
+    private:
+        // complex values of scratch needed by transform
+        std::ptrdiff_t work_length(int _Workers) const
+        {
+            if (!_M_real)
+                return _M_size;
+
+            const std::ptrdiff_t half = (_M_size / _M_dims.back()) * _M_real->spectrum_length();
+            return half + (std::max)(half, _Workers * _M_real->work_length());
+        }
+
+        void transform(bool _Forward, const complex_type* _Input, complex_type* _Output, _Precision _Scale, complex_type* _Work, int _Workers) const
+        {
+            if (_Input != _Output)
+                std::copy(_Input, _Input + _M_size, _Output);
+
+            transform_axes(_Forward, _Output, _Work, _M_dims, static_cast<int>(_M_dims.size()), _Workers);
+            scale(_Output, _M_size, _Scale, _Workers);
+        }
+
+        void transform(bool /*_Forward*/, const _Precision* _Input, complex_type* _Output, _Precision _Scale, complex_type* _Work, int _Workers) const
+        {
+            const int rank = static_cast<int>(_M_dims.size());
+            const int n = _M_dims.back();
+            const int h = _M_real->spectrum_length();
+            const std::ptrdiff_t rows = _M_size / n;
+
+            std::vector<int> half_dims(_M_dims);
+            half_dims.back() = h;
+
+            complex_type* half_data = _Work;
+            complex_type* work_data = _Work + rows * h;
+
+            // rows
+            fft_parallel_chunks(rows, _Workers, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int _Chunk) {
+                for (std::ptrdiff_t i = _Begin; i < _End; i++)
+                    _M_real->forward(_Input + i*n, half_data + i*h, work_data + _Chunk * _M_real->work_length());
+            });
+
+            // remaining dimensions on half of the spectrum
+            transform_axes(true, half_data, work_data, half_dims, rank - 1, _Workers);
+
+            // the other half follows from X[k] = conj(X[-k])
+            fft_parallel_chunks(rows, _Workers, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                for (std::ptrdiff_t i = _Begin; i < _End; i++)
+                {
+                    const std::ptrdiff_t mirror = mirror_row(i);
+                    const complex_type* src = half_data + i*h;
+                    const complex_type* src_mirror = half_data + mirror*h;
+                    complex_type* dst = _Output + i*n;
+
+                    for (int k = 0; k < h; k++)
+                        dst[k] = src[k] * _Scale;
+                    for (int k = h; k < n; k++)
+                        dst[k] = std::conj(src_mirror[n-k]) * _Scale;
+                }
+            });
+        }
+
+        void transform(bool /*_Forward*/, const complex_type* _Input, _Precision* _Output, _Precision _Scale, complex_type* _Work, int _Workers) const
+        {
+            const int rank = static_cast<int>(_M_dims.size());
+            const int n = _M_dims.back();
+            const int h = _M_real->spectrum_length();
+            const std::ptrdiff_t rows = _M_size / n;
+
+            std::vector<int> half_dims(_M_dims);
+            half_dims.back() = h;
+
+            complex_type* half_data = _Work;
+            complex_type* work_data = _Work + rows * h;
+
+            fft_parallel_chunks(rows, _Workers, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                for (std::ptrdiff_t i = _Begin; i < _End; i++)
+                    std::copy(_Input + i*n, _Input + i*n + h, half_data + i*h);
+            });
+
+            // leading dimensions on half of the spectrum
+            transform_axes(false, half_data, work_data, half_dims, rank - 1, _Workers);
+
+            // rows
+            fft_parallel_chunks(rows, _Workers, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int _Chunk) {
+                for (std::ptrdiff_t i = _Begin; i < _End; i++)
+                {
+                    _Precision* dst = _Output + i*n;
+                    _M_real->inverse(half_data + i*h, dst, work_data + _Chunk * _M_real->work_length());
+
+                    if (_Scale != _Precision(1))
+                        for (int k = 0; k < n; k++)
+                            dst[k] *= _Scale;
+                }
+            });
+        }
+
+        //--------------------------------------------------------------------------------------
+        // Transforms dimensions [0, _Axis_count) of a row major array with extent _Dims in
+        // place. _Work must be as large as the array.
+        //--------------------------------------------------------------------------------------
+        void transform_axes(bool _Forward, complex_type* _Data, complex_type* _Work, const std::vector<int>& _Dims, int _Axis_count, int _Workers) const
+        {
+            std::ptrdiff_t total = 1;
+            for (auto it = _Dims.begin(); it != _Dims.end(); ++it)
+                total *= *it;
+
+            for (int axis = 0; axis < _Axis_count; axis++)
+            {
+                const int n = _Dims[axis];
+                if (n == 1)
+                    continue;
+
+                // sequences are interleaved 'stride' apart in 'outer' independent slabs
+                std::ptrdiff_t stride = 1;
+                for (size_t d = axis + 1; d < _Dims.size(); d++)
+                    stride *= _Dims[d];
+
+                const std::ptrdiff_t outer = total / (n * stride);
+                const fft_plan_1d<_Precision>& plan = *_M_axes[axis];
+
+                // split slabs into column ranges when there are fewer slabs than threads
+                const std::ptrdiff_t splits = (outer >= _Workers) ? 1 : (std::min)(stride, (_Workers + outer - 1) / outer);
+                const std::ptrdiff_t slab = n * stride;
+
+                fft_parallel_chunks(outer * splits, _Workers, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                    for (std::ptrdiff_t i = _Begin; i < _End; i++)
+                    {
+                        const std::ptrdiff_t o = i / splits;
+                        const std::ptrdiff_t part = i % splits;
+                        const std::ptrdiff_t first = stride * part / splits;
+                        const std::ptrdiff_t last = stride * (part + 1) / splits;
+
+                        plan.execute(_Forward, _Data + o*slab, _Work + o*slab, stride, first, last);
+                    }
+                });
+            }
+        }
+
+        // row index of the negated (modulo extent) multi-index of row _Row
+        std::ptrdiff_t mirror_row(std::ptrdiff_t _Row) const
+        {
+            std::ptrdiff_t mirror = 0;
+            std::ptrdiff_t scale = 1;
+
+            for (int d = static_cast<int>(_M_dims.size()) - 2; d >= 0; d--)
+            {
+                const int n = _M_dims[d];
+                const std::ptrdiff_t i = _Row % n;
+                _Row /= n;
+
+                mirror += ((n - i) % n) * scale;
+                scale *= n;
+            }
+
+            return mirror;
+        }
+
+        void scale(complex_type* _Data, std::ptrdiff_t _Count, _Precision _Scale, int _Workers) const
+        {
+            if (_Scale == _Precision(1))
+                return;
+
+            fft_parallel_chunks(_Count, _Workers, [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                for (std::ptrdiff_t i = _Begin; i < _End; i++)
+                    _Data[i] *= _Scale;
+            });
+        }
+
+        std::vector<int> _M_dims;
+        std::ptrdiff_t _M_size;
+        std::vector<std::shared_ptr<const fft_plan_1d<_Precision>>> _M_axes;
+        std::shared_ptr<const fft_real_plan_1d<_Precision>> _M_real;
+        mutable fft_scratch_pool<_Precision> _M_scratch;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Returns the cached plan for an extent, creating it on first use.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    std::shared_ptr<const fft_plan<_Precision>> get_fft_plan(const std::vector<int>& _Dims, bool _Real)
+    {
+        static fft_plan_cache<std::pair<std::vector<int>, bool>, fft_plan<_Precision>> cache;
+
+        return cache.get(std::make_pair(_Dims, _Real), [&]() {
+            return std::make_shared<fft_plan<_Precision>>(_Dims, _Real);
+        });
+    }
+} // namespace _details
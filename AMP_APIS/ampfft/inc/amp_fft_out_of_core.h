@@ -0,0 +1,603 @@
+//--------------------------------------------------------------------------------------
+// File: amp_fft_out_of_core.h
+//
+// Out-of-core transforms of the portable host FFT engine, for data sets which are
+// stored in a file and do not fit in memory.
+//
+// A number of important notes regarding the implementation:
+//
+// A multi-dimensional transform runs in two passes over the file. The first pass
+// reads slabs of consecutive rows along the leading axis (each row holds the
+// remaining axes and is contiguous in the file) and transforms them in memory with a
+// batched plan. The second pass reads pencils: blocks of adjacent columns along the
+// leading axis, one contiguous run per row, and transforms them as interleaved
+// sequences.
+//
+// A one dimensional transform of length n = n1*n2 uses the four-step algorithm:
+// n1 point transforms of the columns of the n1 x n2 matrix with a twiddle
+// multiplication (a pencil pass), then n2 point transforms of the rows, transposed
+// into the output on the way out. The intermediate data goes through a temporary
+// file next to the output.
+//
+// Each pass streams blocks through three buffers, so reading the next block and
+// writing the previous one overlap the computation of the current one. Real data is
+// widened to complex values when it is read and narrowed again when it is written.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "amp_fft_host.h"
+
+namespace _details
+{
+    //--------------------------------------------------------------------------------------
+    // Errors reported by the file operations of the out-of-core transforms.
+    //--------------------------------------------------------------------------------------
+    class fft_file_error : public std::runtime_error
+    {
+    public:
+        explicit fft_file_error(const std::string& _Message)
+            : std::runtime_error(_Message) {}
+    };
+
+    //--------------------------------------------------------------------------------------
+    // A file with positional reads and writes, which may be issued concurrently.
+    //--------------------------------------------------------------------------------------
+    class fft_file
+    {
+    public:
+        fft_file(const std::string& _Path, bool _Writable)
+            : _M_path(_Path)
+        {
+#ifdef _WIN32
+            _M_handle = CreateFileA(
+                _Path.c_str(),
+                _Writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr,
+                _Writable ? OPEN_ALWAYS : OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+
+            if (_M_handle == INVALID_HANDLE_VALUE)
+                throw fft_file_error("Failed to open " + _Path);
+#else
+            _M_handle = ::open(_Path.c_str(), _Writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0666);
+
+            if (_M_handle < 0)
+                throw fft_file_error("Failed to open " + _Path);
+#endif
+        }
+
+        ~fft_file()
+        {
+#ifdef _WIN32
+            CloseHandle(_M_handle);
+#else
+            ::close(_M_handle);
+#endif
+        }
+
+        const std::string& path() const
+        {
+            return _M_path;
+        }
+
+        long long size() const
+        {
+#ifdef _WIN32
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(_M_handle, &size))
+                throw fft_file_error("Failed to get the size of " + _M_path);
+            return size.QuadPart;
+#else
+            struct stat status;
+            if (::fstat(_M_handle, &status) != 0)
+                throw fft_file_error("Failed to get the size of " + _M_path);
+            return static_cast<long long>(status.st_size);
+#endif
+        }
+
+        void resize(long long _Bytes)
+        {
+#ifdef _WIN32
+            LARGE_INTEGER position;
+            position.QuadPart = _Bytes;
+            if (!SetFilePointerEx(_M_handle, position, nullptr, FILE_BEGIN) || !SetEndOfFile(_M_handle))
+                throw fft_file_error("Failed to resize " + _M_path);
+#else
+            if (::ftruncate(_M_handle, static_cast<off_t>(_Bytes)) != 0)
+                throw fft_file_error("Failed to resize " + _M_path);
+#endif
+        }
+
+        void read(void* _Data, long long _Bytes, long long _Offset) const
+        {
+            char* data = static_cast<char*>(_Data);
+
+            while (_Bytes > 0)
+            {
+                const long long done = transfer(false, data, _Bytes, _Offset);
+                if (done <= 0)
+                    throw fft_file_error("Failed to read " + _M_path);
+
+                data += done;
+                _Bytes -= done;
+                _Offset += done;
+            }
+        }
+
+        void write(const void* _Data, long long _Bytes, long long _Offset) const
+        {
+            char* data = const_cast<char*>(static_cast<const char*>(_Data));
+
+            while (_Bytes > 0)
+            {
+                const long long done = transfer(true, data, _Bytes, _Offset);
+                if (done <= 0)
+                    throw fft_file_error("Failed to write " + _M_path);
+
+                data += done;
+                _Bytes -= done;
+                _Offset += done;
+            }
+        }
+
+    private:
+        fft_file(const fft_file&);
+        fft_file& operator=(const fft_file&);
+
+        // transfers up to _Bytes at _Offset; returns the number of bytes transferred
+        long long transfer(bool _Write, char* _Data, long long _Bytes, long long _Offset) const
+        {
+            const long long chunk = (std::min)(_Bytes, 1LL << 30);
+
+#ifdef _WIN32
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(_Offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(_Offset >> 32);
+
+            DWORD done = 0;
+            const BOOL succeeded = _Write
+                ? WriteFile(_M_handle, _Data, static_cast<DWORD>(chunk), &done, &overlapped)
+                : ReadFile(_M_handle, _Data, static_cast<DWORD>(chunk), &done, &overlapped);
+
+            return succeeded ? static_cast<long long>(done) : -1;
+#else
+            for (;;)
+            {
+                const ssize_t done = _Write
+                    ? ::pwrite(_M_handle, _Data, static_cast<size_t>(chunk), static_cast<off_t>(_Offset))
+                    : ::pread(_M_handle, _Data, static_cast<size_t>(chunk), static_cast<off_t>(_Offset));
+
+                if (done < 0 && errno == EINTR)
+                    continue;
+
+                return static_cast<long long>(done);
+            }
+#endif
+        }
+
+        std::string _M_path;
+#ifdef _WIN32
+        HANDLE _M_handle;
+#else
+        int _M_handle;
+#endif
+    };
+
+    //--------------------------------------------------------------------------------------
+    // A scratch file which is deleted when it goes out of scope.
+    //--------------------------------------------------------------------------------------
+    class fft_temporary_file
+    {
+    public:
+        explicit fft_temporary_file(const std::string& _Path)
+            : _M_file(new fft_file(_Path, true)) {}
+
+        ~fft_temporary_file()
+        {
+            const std::string path = _M_file->path();
+            _M_file.reset();
+            std::remove(path.c_str());
+        }
+
+        fft_file& file() const
+        {
+            return *_M_file;
+        }
+
+    private:
+        fft_temporary_file(const fft_temporary_file&);
+        fft_temporary_file& operator=(const fft_temporary_file&);
+
+        std::unique_ptr<fft_file> _M_file;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Element conversion. Files hold _Element_type values (real or complex); in memory
+    // all data is complex. Conversions are done in place in the complex buffer.
+    //--------------------------------------------------------------------------------------
+
+    // reads _Count elements starting at element _Offset into _Data
+    template <typename _Element_type, typename _Precision>
+    void read_elements(const fft_file& _File, long long _Offset, long long _Count, std::complex<_Precision>* _Data)
+    {
+        _File.read(_Data, _Count * sizeof(_Element_type), _Offset * sizeof(_Element_type));
+
+        if (sizeof(_Element_type) != sizeof(std::complex<_Precision>))
+        {
+            // widen from the back; value j of the reals is still unread when complex j is written
+            const _Precision* real = reinterpret_cast<const _Precision*>(_Data);
+            for (long long j = _Count - 1; j >= 0; j--)
+                _Data[j] = std::complex<_Precision>(real[j]);
+        }
+    }
+
+    // narrows _Data to _Element_type in place; returns the narrowed elements
+    template <typename _Element_type, typename _Precision>
+    const _Element_type* narrow_elements(std::complex<_Precision>* _Data, long long _Count)
+    {
+        if (sizeof(_Element_type) != sizeof(std::complex<_Precision>))
+        {
+            // narrow from the front; complex j has been read when real j is written
+            _Precision* real = reinterpret_cast<_Precision*>(_Data);
+            for (long long j = 0; j < _Count; j++)
+                real[j] = _Data[j].real();
+        }
+
+        return reinterpret_cast<const _Element_type*>(_Data);
+    }
+
+    // writes _Count elements of _Data starting at element _Offset; _Data is overwritten
+    template <typename _Element_type, typename _Precision>
+    void write_elements(const fft_file& _File, long long _Offset, long long _Count, std::complex<_Precision>* _Data)
+    {
+        const _Element_type* data = narrow_elements<_Element_type>(_Data, _Count);
+        _File.write(data, _Count * sizeof(_Element_type), _Offset * sizeof(_Element_type));
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Streams _Count blocks through three buffers: block i is read by _Load(i, buffer),
+    // transformed by _Compute(i, buffer) and written by _Store(i, buffer). Loading block
+    // i+1 and storing block i-1 run asynchronously while block i is computed. _Compute
+    // may replace the buffer pointer with one it owns.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision, typename _Load_type, typename _Compute_type, typename _Store_type>
+    void fft_stream_blocks(long long _Count, std::complex<_Precision>* (&_Buffers)[3], const _Load_type& _Load, const _Compute_type& _Compute, const _Store_type& _Store)
+    {
+        typedef std::complex<_Precision>* pointer_type;
+
+        std::future<void> loading;
+        std::future<void> storing;
+
+        try
+        {
+            if (_Count > 0)
+            {
+                const pointer_type first = _Buffers[0];
+                loading = std::async(std::launch::async, [&_Load, first]() { _Load(0LL, first); });
+            }
+
+            for (long long i = 0; i < _Count; i++)
+            {
+                loading.get();
+
+                if (i + 1 < _Count)
+                {
+                    const pointer_type next = _Buffers[(i + 1) % 3];
+                    loading = std::async(std::launch::async, [&_Load, next, i]() { _Load(i + 1, next); });
+                }
+
+                pointer_type& current = _Buffers[i % 3];
+                _Compute(i, current);
+
+                // the buffer of block i-2 is loaded next, so block i-1 must be stored by then
+                if (storing.valid())
+                    storing.get();
+
+                const pointer_type done = current;
+                storing = std::async(std::launch::async, [&_Store, done, i]() { _Store(i, done); });
+            }
+
+            if (storing.valid())
+                storing.get();
+        }
+        catch (...)
+        {
+            // the asynchronous operations use the buffers, so let them finish first
+            if (loading.valid())
+                loading.wait();
+            if (storing.valid())
+                storing.wait();
+            throw;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // w^m for w = exp(-2 pi i/n) and any m in [0, n), as the product of two entries of
+    // tables with about sqrt(n) values each.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    class fft_twiddle_table
+    {
+    public:
+        explicit fft_twiddle_table(long long _Length)
+        {
+            _M_step = 1;
+            while (_M_step * _M_step < _Length)
+                _M_step++;
+
+            for (long long j = 0; j < _M_step; j++)
+                _M_low.push_back(unit_root<_Precision>(j, _Length));
+            for (long long j = 0; j * _M_step < _Length; j++)
+                _M_high.push_back(unit_root<_Precision>(j * _M_step, _Length));
+        }
+
+        std::complex<_Precision> operator()(long long _Power) const
+        {
+            return twiddle_mul<true>(_M_high[static_cast<size_t>(_Power / _M_step)], _M_low[static_cast<size_t>(_Power % _M_step)]);
+        }
+
+    private:
+        long long _M_step;
+        std::vector<std::complex<_Precision>> _M_low;
+        std::vector<std::complex<_Precision>> _M_high;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Out-of-core plan over a row major extent stored in a file.
+    //--------------------------------------------------------------------------------------
+    template <typename _Precision>
+    class fft_out_of_core
+    {
+    public:
+        typedef std::complex<_Precision> complex_type;
+
+        fft_out_of_core(const std::vector<int>& _Dims, std::size_t _Memory_limit)
+            : _M_dims(_Dims), _M_size(1),
+            _M_budget(static_cast<long long>(_Memory_limit / sizeof(complex_type))),
+            _M_workers(get_fft_thread_pool().concurrency())
+        {
+            for (auto it = _Dims.begin(); it != _Dims.end(); ++it)
+                _M_size *= *it;
+        }
+
+        //--------------------------------------------------------------------------------------
+        // Transforms the _Input_type elements in _Input_path into _Output_type elements in
+        // _Output_path. For complex data the paths may be the same file.
+        //--------------------------------------------------------------------------------------
+        template <typename _Input_type, typename _Output_type>
+        void execute(bool _Forward, const std::string& _Input_path, const std::string& _Output_path, _Precision _Scale) const
+        {
+            const fft_file input(_Input_path, false);
+            if (input.size() < _M_size * static_cast<long long>(sizeof(_Input_type)))
+                throw fft_file_error(_Input_path + " is smaller than the extent of the transform");
+
+            fft_file output(_Output_path, true);
+            output.resize(_M_size * sizeof(_Output_type));
+
+            // small enough for memory after all
+            if (2 * _M_size <= _M_budget)
+            {
+                std::vector<complex_type> data(static_cast<size_t>(_M_size));
+                read_elements<_Input_type>(input, 0, _M_size, data.data());
+                get_fft_plan<_Precision>(_M_dims, false)->execute(_Forward, data.data(), data.data(), _Scale);
+                write_elements<_Output_type>(output, 0, _M_size, data.data());
+                return;
+            }
+
+            if (_M_dims.size() == 1)
+            {
+                const long long n = _M_size;
+
+                // n = n1 * n2 with n1 the largest factor up to sqrt(n)
+                long long n1 = 1;
+                for (long long f = 2; f * f <= n; f++)
+                    if (n % f == 0)
+                        n1 = f;
+                const long long n2 = n / n1;
+
+                if (n1 == 1)
+                    throw std::invalid_argument("The transform length is prime and does not fit in the memory limit");
+
+                fft_temporary_file temporary(_Output_path + ".tmp");
+                temporary.file().resize(n * sizeof(complex_type));
+
+                const fft_twiddle_table<_Precision> twiddles(n);
+                pencil_pass<_Input_type, complex_type>(_Forward, input, temporary.file(), static_cast<int>(n1), n2, _Precision(1), &twiddles);
+                slab_pass<complex_type, _Output_type>(_Forward, temporary.file(), output, n1, std::vector<int>(1, static_cast<int>(n2)), _Scale, true);
+            }
+            else
+            {
+                const int n = _M_dims[0];
+                const std::vector<int> row_dims(_M_dims.begin() + 1, _M_dims.end());
+
+                if (sizeof(_Output_type) == sizeof(complex_type))
+                {
+                    slab_pass<_Input_type, complex_type>(_Forward, input, output, n, row_dims, _Precision(1), false);
+                    pencil_pass<complex_type, _Output_type>(_Forward, output, output, n, _M_size / n, _Scale, nullptr);
+                }
+                else
+                {
+                    // the complex intermediate does not fit in a file of reals
+                    fft_temporary_file temporary(_Output_path + ".tmp");
+                    temporary.file().resize(_M_size * sizeof(complex_type));
+
+                    slab_pass<_Input_type, complex_type>(_Forward, input, temporary.file(), n, row_dims, _Precision(1), false);
+                    pencil_pass<complex_type, _Output_type>(_Forward, temporary.file(), output, n, _M_size / n, _Scale, nullptr);
+                }
+            }
+        }
+
+    private:
+        //--------------------------------------------------------------------------------------
+        // Transforms _Rows contiguous rows with extent _Row_dims, a slab of rows at a time.
+        // With _Transposed, element k of row r is written to k*_Rows + r instead.
+        //--------------------------------------------------------------------------------------
+        template <typename _Input_type, typename _Output_type>
+        void slab_pass(bool _Forward, const fft_file& _Input, const fft_file& _Output, long long _Rows, const std::vector<int>& _Row_dims, _Precision _Scale, bool _Transposed) const
+        {
+            const std::shared_ptr<const fft_plan<_Precision>> plan = get_fft_plan<_Precision>(_Row_dims, false);
+            const long long row = plan->size();
+
+            // three streaming buffers (and one to transpose into) plus scratch for each thread
+            const long long buffer_count = _Transposed ? 4 : 3;
+            const long long available = _M_budget - _M_workers * row;
+            if (available < buffer_count * row)
+                throw std::invalid_argument("The memory limit is too small for the out-of-core transform");
+
+            const long long block_rows = (std::min)(_Rows, available / (buffer_count * row));
+            const long long block_count = (_Rows + block_rows - 1) / block_rows;
+
+            std::vector<std::vector<complex_type>> storage(static_cast<size_t>(buffer_count), std::vector<complex_type>(static_cast<size_t>(block_rows * row)));
+            complex_type* buffers[3] = { storage[0].data(), storage[1].data(), storage[2].data() };
+            complex_type* spare = _Transposed ? storage[3].data() : nullptr;
+
+            fft_stream_blocks(block_count, buffers,
+                [&](long long _Block, complex_type* _Data) {
+                    const long long first = _Block * block_rows;
+                    const long long count = (std::min)(block_rows, _Rows - first);
+
+                    read_elements<_Input_type>(_Input, first * row, count * row, _Data);
+                },
+                [&](long long _Block, complex_type*& _Data) {
+                    const long long first = _Block * block_rows;
+                    const long long count = (std::min)(block_rows, _Rows - first);
+
+                    plan->execute_batch(_Forward, count, _Data, 1, row, _Data, 1, row, _Scale);
+
+                    if (_Transposed)
+                    {
+                        transpose(_Data, spare, count, row);
+                        std::swap(_Data, spare);
+                    }
+                },
+                [&](long long _Block, complex_type* _Data) {
+                    const long long first = _Block * block_rows;
+                    const long long count = (std::min)(block_rows, _Rows - first);
+
+                    if (!_Transposed)
+                    {
+                        write_elements<_Output_type>(_Output, first * row, count * row, _Data);
+                        return;
+                    }
+
+                    // each column of the slab is a contiguous run of the output
+                    const _Output_type* data = narrow_elements<_Output_type>(_Data, count * row);
+                    for (long long k = 0; k < row; k++)
+                        _Output.write(data + k * count, count * sizeof(_Output_type), (k * _Rows + first) * sizeof(_Output_type));
+                });
+        }
+
+        //--------------------------------------------------------------------------------------
+        // Transforms the _Length point sequences along the leading axis of a file with
+        // _Columns columns (element k of column c is at k*_Columns + c), a block of adjacent
+        // columns at a time. With _Twiddles, element k of column c of the result is also
+        // multiplied by w^(c*k) (conjugated for the inverse transform).
+        //--------------------------------------------------------------------------------------
+        template <typename _Input_type, typename _Output_type>
+        void pencil_pass(bool _Forward, const fft_file& _Input, const fft_file& _Output, int _Length, long long _Columns, _Precision _Scale, const fft_twiddle_table<_Precision>* _Twiddles) const
+        {
+            const std::shared_ptr<const fft_plan_1d<_Precision>> plan = get_fft_plan_1d<_Precision>(_Length);
+
+            // three streaming buffers plus the work buffer of the plan
+            const long long width = (std::min)(_Columns, _M_budget / (4LL * _Length));
+            if (width < 1)
+                throw std::invalid_argument("The memory limit is too small for the out-of-core transform");
+
+            const long long block_count = (_Columns + width - 1) / width;
+
+            std::vector<std::vector<complex_type>> storage(4, std::vector<complex_type>(static_cast<size_t>(_Length * width)));
+            complex_type* buffers[3] = { storage[0].data(), storage[1].data(), storage[2].data() };
+            complex_type* work = storage[3].data();
+
+            fft_stream_blocks(block_count, buffers,
+                [&](long long _Block, complex_type* _Data) {
+                    const long long first = _Block * width;
+                    const long long count = (std::min)(width, _Columns - first);
+
+                    for (long long k = 0; k < _Length; k++)
+                        read_elements<_Input_type>(_Input, k * _Columns + first, count, _Data + k * count);
+                },
+                [&](long long _Block, complex_type*& _Data) {
+                    const long long first = _Block * width;
+                    const long long count = (std::min)(width, _Columns - first);
+                    complex_type* data = _Data;
+
+                    fft_parallel_chunks(count, fft_workers(_Length * count), [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                        plan->execute(_Forward, data, work, count, _Begin, _End);
+
+                        for (long long k = 0; k < _Length; k++)
+                        {
+                            complex_type* sequence = data + k * count;
+
+                            if (_Twiddles != nullptr)
+                            {
+                                for (std::ptrdiff_t c = _Begin; c < _End; c++)
+                                {
+                                    const complex_type w = (*_Twiddles)(((first + c) * k) % (static_cast<long long>(_Length) * _Columns));
+                                    sequence[c] = _Forward ? twiddle_mul<true>(sequence[c], w) : twiddle_mul<false>(sequence[c], w);
+                                }
+                            }
+
+                            if (_Scale != _Precision(1))
+                                for (std::ptrdiff_t c = _Begin; c < _End; c++)
+                                    sequence[c] *= _Scale;
+                        }
+                    });
+                },
+                [&](long long _Block, complex_type* _Data) {
+                    const long long first = _Block * width;
+                    const long long count = (std::min)(width, _Columns - first);
+
+                    for (long long k = 0; k < _Length; k++)
+                        write_elements<_Output_type>(_Output, k * _Columns + first, count, _Data + k * count);
+                });
+        }
+
+        // _Output[k*_Rows + r] = _Input[r*_Columns + k], in tiles
+        void transpose(const complex_type* _Input, complex_type* _Output, long long _Rows, long long _Columns) const
+        {
+            const long long tile = 32;
+            const long long tiles = (_Columns + tile - 1) / tile;
+
+            fft_parallel_chunks(tiles, fft_workers(_Rows * _Columns), [&](std::ptrdiff_t _Begin, std::ptrdiff_t _End, int) {
+                for (long long t = _Begin; t < _End; t++)
+                {
+                    const long long k_end = (std::min)(_Columns, (t + 1) * tile);
+
+                    for (long long r0 = 0; r0 < _Rows; r0 += tile)
+                    {
+                        const long long r_end = (std::min)(_Rows, r0 + tile);
+
+                        for (long long k = t * tile; k < k_end; k++)
+                            for (long long r = r0; r < r_end; r++)
+                                _Output[k * _Rows + r] = _Input[r * _Columns + k];
+                    }
+                }
+            });
+        }
+
+        std::vector<int> _M_dims;
+        long long _M_size;
+        long long _M_budget;
+        long long _M_workers;
+    };
+} // namespace _details
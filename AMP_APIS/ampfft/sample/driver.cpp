@@ -13,9 +13,11 @@
 using namespace concurrency;
 
 const float ALLOWED_ERROR_RATIO = 0.00001f;
-bool compare_with_error_margin(const float &actual, const float &expected) 
+
+template <typename real_type>
+bool compare_with_error_margin(const real_type &actual, const real_type &expected) 
 {
-    float actual_error_ratio = fabs((actual - expected)/expected);
+    real_type actual_error_ratio = std::abs((actual - expected)/expected);
     if (actual_error_ratio > ALLOWED_ERROR_RATIO) {
         return false;
     }
@@ -23,16 +25,10 @@ bool compare_with_error_margin(const float &actual, const float &expected)
     return true;
 }
 
-bool compare_with_error_margin(const std::complex<float> &actual, const std::complex<float> &expected) 
+template <typename real_type>
+bool compare_with_error_margin(const std::complex<real_type> &actual, const std::complex<real_type> &expected) 
 {
-    float actual_real_error_ratio = fabs((actual.real() - expected.real())/expected.real());
-    float actual_imag_error_ratio = fabs((actual.imag() - expected.imag())/expected.imag());
-
-    if ((actual_real_error_ratio > ALLOWED_ERROR_RATIO) || (actual_imag_error_ratio > ALLOWED_ERROR_RATIO)) {
-        return false;
-    }
-
-    return true;
+    return compare_with_error_margin(actual.real(), expected.real()) && compare_with_error_margin(actual.imag(), expected.imag());
 }
 
 template <typename value_type>
@@ -167,6 +163,157 @@ void test_fft_complex(bool inPlace = false)
     verify_results(output_vec, input_vec);
 }
 
+template <typename real_type, int dims>
+void test_fft_host(bool inPlace = false)
+{
+    extent<dims> e;
+    if (dims == 1) { e[0] = 10000; }
+    if (dims == 2) { e[0] = 100; e[1] = 100; }
+    if (dims == 3) { e[0] = 10; e[1] = 10; e[2] = 100; }
+
+    // Create the FFT transformation objects on the CPU accelerator, so that neither
+    // allocates Direct3D resources
+    accelerator_view host_view = accelerator(accelerator::cpu_accelerator).default_view;
+    fft<real_type, dims> real_transform(e, host_view);
+    fft<std::complex<real_type>, dims> complex_transform(e, host_view);
+
+    // Initialize some input
+    std::vector<real_type> input_vec(10000);
+    for (int y = 0; y < 100; y++)
+    {
+        for (int x = 0; x < 100; x++)
+        {
+            input_vec[y*100 + x] = static_cast<real_type>(10.0 * sin(x*0.05) * cos(y*0.1) + 10.0 * log(2.0 + x + y) + cos(x));
+        }
+    }
+
+    // Transform the real data and back again
+    std::vector<std::complex<real_type>> transformed_vec(10000);
+    real_transform.forward_transform(input_vec.data(), transformed_vec.data());
+
+    std::vector<real_type> output_vec(10000);
+    real_transform.inverse_transform(transformed_vec.data(), output_vec.data());
+
+    verify_results(output_vec, input_vec);
+
+    // Transform the same data as complex values and back again
+    std::vector<std::complex<real_type>> complex_vec(input_vec.begin(), input_vec.end());
+    std::vector<std::complex<real_type>> complex_output_vec(complex_vec);
+
+    if (inPlace)
+    {
+        complex_transform.forward_transform(complex_output_vec.data(), complex_output_vec.data());
+        complex_transform.inverse_transform(complex_output_vec.data(), complex_output_vec.data());
+    }
+    else
+    {
+        complex_transform.forward_transform(complex_vec.data(), transformed_vec.data());
+        complex_transform.inverse_transform(transformed_vec.data(), complex_output_vec.data());
+    }
+
+    // The imaginary parts are zero, so only compare the real parts
+    for (size_t i = 0; i < complex_output_vec.size(); ++i)
+    {
+        output_vec[i] = complex_output_vec[i].real();
+    }
+
+    verify_results(output_vec, input_vec);
+}
+
+template <typename real_type>
+void test_fft_batch()
+{
+    // Transform the 100 rows and then the 100 columns of a 100x100 image as batches
+    // of one dimensional transforms
+    extent<1> e(100);
+    accelerator_view host_view = accelerator(accelerator::cpu_accelerator).default_view;
+    fft<real_type, 1> real_transform(e, host_view);
+    fft<std::complex<real_type>, 1> complex_transform(e, host_view);
+
+    // Initialize some input
+    std::vector<real_type> input_vec(10000);
+    for (int y = 0; y < 100; y++)
+    {
+        for (int x = 0; x < 100; x++)
+        {
+            input_vec[y*100 + x] = static_cast<real_type>(10.0 * sin(x*0.05) * cos(y*0.1) + 10.0 * log(2.0 + x + y) + cos(x));
+        }
+    }
+
+    // Rows: elements are adjacent (stride 1) and rows are 100 elements apart (distance 100)
+    std::vector<std::complex<real_type>> transformed_vec(10000);
+    real_transform.forward_transform(100, input_vec.data(), 1, 100, transformed_vec.data(), 1, 100);
+
+    std::vector<real_type> output_vec(10000);
+    real_transform.inverse_transform(100, transformed_vec.data(), 1, 100, output_vec.data(), 1, 100);
+
+    verify_results(output_vec, input_vec);
+
+    // Columns in-place: elements are 100 apart (stride 100) and columns are adjacent (distance 1)
+    std::vector<std::complex<real_type>> complex_vec(input_vec.begin(), input_vec.end());
+    complex_transform.forward_transform(100, complex_vec.data(), 100, 1, complex_vec.data(), 100, 1);
+    complex_transform.inverse_transform(100, complex_vec.data(), 100, 1, complex_vec.data(), 100, 1);
+
+    // The imaginary parts are zero, so only compare the real parts
+    for (size_t i = 0; i < complex_vec.size(); ++i)
+    {
+        output_vec[i] = complex_vec[i].real();
+    }
+
+    verify_results(output_vec, input_vec);
+}
+
+template <typename real_type, int dims>
+void test_fft_file()
+{
+    extent<dims> e;
+    if (dims == 1) { e[0] = 10000; }
+    if (dims == 2) { e[0] = 100; e[1] = 100; }
+    if (dims == 3) { e[0] = 10; e[1] = 10; e[2] = 100; }
+
+    accelerator_view host_view = accelerator(accelerator::cpu_accelerator).default_view;
+    fft<real_type, dims> transform(e, host_view);
+
+    // Initialize some input and store it in a file
+    std::vector<real_type> input_vec(10000);
+    for (int y = 0; y < 100; y++)
+    {
+        for (int x = 0; x < 100; x++)
+        {
+            input_vec[y*100 + x] = static_cast<real_type>(10.0 * sin(x*0.05) * cos(y*0.1) + 10.0 * log(2.0 + x + y) + cos(x));
+        }
+    }
+
+    FILE * fdata = NULL;
+    if (fopen_s(&fdata, "fft_input.bin", "wb") != 0)
+    {
+        printf("failed to create fft_input.bin\n");
+        return;
+    }
+    fwrite(input_vec.data(), sizeof(real_type), input_vec.size(), fdata);
+    fclose(fdata);
+
+    // Transform the file with 64KB of memory, which is less than the data itself
+    const size_t memory_limit = 64 * 1024;
+    transform.forward_transform_file("fft_input.bin", "fft_spectrum.bin", memory_limit);
+    transform.inverse_transform_file("fft_spectrum.bin", "fft_output.bin", memory_limit);
+
+    std::vector<real_type> output_vec(10000);
+    if (fopen_s(&fdata, "fft_output.bin", "rb") != 0)
+    {
+        printf("failed to open fft_output.bin\n");
+        return;
+    }
+    fread(output_vec.data(), sizeof(real_type), output_vec.size(), fdata);
+    fclose(fdata);
+
+    remove("fft_input.bin");
+    remove("fft_spectrum.bin");
+    remove("fft_output.bin");
+
+    verify_results(output_vec, input_vec);
+}
+
 void test_fft()
 {
     // Test 1D real data
@@ -186,6 +333,21 @@ void test_fft()
 
     // Test 3D complex data in-place
     test_fft_complex<3>(true);
+
+    // Test 1D and 3D single precision host data
+    test_fft_host<float, 1>();
+    test_fft_host<float, 3>(true);
+
+    // Test 2D double precision host data in-place
+    test_fft_host<double, 2>(true);
+
+    // Test batches of 1D transforms
+    test_fft_batch<float>();
+    test_fft_batch<double>();
+
+    // Test out-of-core 1D and 3D transforms of files
+    test_fft_file<double, 1>();
+    test_fft_file<float, 3>();
 }
 
 template <int dims>
@@ -14,6 +14,9 @@
 
 #include "amp_fft.h"
 
+// the host engine is header only; this file is only needed for Direct3D
+#ifdef _AMP_FFT_DIRECT3D
+
 namespace _details
 {
 
@@ -277,3 +280,5 @@ HRESULT fft_base::create_uav(UINT floatSize, ID3D11Buffer *pBuffer, ID3D11Unorde
 }
 
 } // namespace _details
+
+#endif // _AMP_FFT_DIRECT3D
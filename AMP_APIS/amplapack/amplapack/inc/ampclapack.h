@@ -71,6 +71,19 @@ enum amplapack_status
     amplapack_unknown_error        // catch all 
 };
 
+//----------------------------------------------------------------------------
+// Scheduling
+//----------------------------------------------------------------------------
+
+enum amplapack_schedule
+{
+    amplapack_schedule_hybrid,     // panels on the host, trailing updates on the accelerator (default)
+    amplapack_schedule_task_graph  // tiles scheduled as a task graph on the host threads
+};
+
+AMPLAPACK_DLL void amplapack_set_schedule(enum amplapack_schedule schedule);
+AMPLAPACK_DLL enum amplapack_schedule amplapack_get_schedule();
+
 //----------------------------------------------------------------------------
 // LAPACK Routines
 //---------------------------------------------------------------------------- 
@@ -90,6 +103,19 @@ AMPLAPACK_DLL amplapack_status amplapack_dpotrf(char uplo, int n, double* a, int
 AMPLAPACK_DLL amplapack_status amplapack_cpotrf(char uplo, int n, amplapack_fcomplex* a, int lda, int* info);
 AMPLAPACK_DLL amplapack_status amplapack_zpotrf(char uplo, int n, amplapack_dcomplex* a, int lda, int* info);
 
+//----------------------------------------------------------------------------
+// Mixed Precision Drivers
+//----------------------------------------------------------------------------
+
+// factor in single precision and refine the solution in double precision; on return
+// iter is the number of refinement steps or, if negative, the reason the driver fell
+// back to a double precision factorization (-2 overflow, -3 singular, -31 no convergence)
+AMPLAPACK_DLL amplapack_status amplapack_dsgesv(int n, int nrhs, double* a, int lda, int* ipiv, double* b, int ldb, double* x, int ldx, int* iter, int* info);
+AMPLAPACK_DLL amplapack_status amplapack_zcgesv(int n, int nrhs, amplapack_dcomplex* a, int lda, int* ipiv, amplapack_dcomplex* b, int ldb, amplapack_dcomplex* x, int ldx, int* iter, int* info);
+
+AMPLAPACK_DLL amplapack_status amplapack_dsposv(char uplo, int n, int nrhs, double* a, int lda, double* b, int ldb, double* x, int ldx, int* iter, int* info);
+AMPLAPACK_DLL amplapack_status amplapack_zcposv(char uplo, int n, int nrhs, amplapack_dcomplex* a, int lda, amplapack_dcomplex* b, int ldb, amplapack_dcomplex* x, int ldx, int* iter, int* info);
+
 #ifdef __cplusplus
 }
 #endif
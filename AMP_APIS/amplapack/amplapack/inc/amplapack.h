@@ -24,7 +24,9 @@
 #define AMPLAPACK_H
 
 #include "detail/geqrf.h"
+#include "detail/gesv.h"
 #include "detail/getrf.h"
+#include "detail/posv.h"
 #include "detail/potrf.h"
 
 #endif // AMPLAPACK_H
@@ -96,4 +96,32 @@ inline amplapack_status amplapack_potrf(char uplo, int n, amplapack_dcomplex* a,
     return amplapack_zpotrf(uplo, n, a, lda, info);
 }
 
+//
+// Mixed Precision GESV
+//
+
+inline amplapack_status amplapack_mixed_gesv(int n, int nrhs, double* a, int lda, int* ipiv, double* b, int ldb, double* x, int ldx, int* iter, int* info)
+{
+    return amplapack_dsgesv(n, nrhs, a, lda, ipiv, b, ldb, x, ldx, iter, info);
+}
+
+inline amplapack_status amplapack_mixed_gesv(int n, int nrhs, amplapack_dcomplex* a, int lda, int* ipiv, amplapack_dcomplex* b, int ldb, amplapack_dcomplex* x, int ldx, int* iter, int* info)
+{
+    return amplapack_zcgesv(n, nrhs, a, lda, ipiv, b, ldb, x, ldx, iter, info);
+}
+
+//
+// Mixed Precision POSV
+//
+
+inline amplapack_status amplapack_mixed_posv(char uplo, int n, int nrhs, double* a, int lda, double* b, int ldb, double* x, int ldx, int* iter, int* info)
+{
+    return amplapack_dsposv(uplo, n, nrhs, a, lda, b, ldb, x, ldx, iter, info);
+}
+
+inline amplapack_status amplapack_mixed_posv(char uplo, int n, int nrhs, amplapack_dcomplex* a, int lda, amplapack_dcomplex* b, int ldb, amplapack_dcomplex* x, int ldx, int* iter, int* info)
+{
+    return amplapack_zcposv(uplo, n, nrhs, a, lda, b, ldb, x, ldx, iter, info);
+}
+
 #endif // AMPXLAPACK_H
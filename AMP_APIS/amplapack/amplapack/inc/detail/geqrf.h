@@ -22,6 +22,8 @@
 #define AMPLAPACK_GEQRF_H
 
 #include "amplapack_config.h"
+#include "host_blas.h"
+#include "task_graph.h"
 
 // external lapack functions
 namespace amplapack {
@@ -338,6 +340,61 @@ void geqrf(const concurrency::accelerator_view& av, concurrency::array_view<valu
     }
 }
 
+//
+// Tiled Factorization
+//
+
+// Householder QR by tile columns, run as a task graph on the host. Each panel
+// stores its triangular factor so the block reflector can be applied to every
+// tile column to its right independently; panel k+1 starts as soon as tile
+// column k+1 has been updated. The result matches LAPACK's geqrf layout.
+template <int tile_size, typename value_type>
+void tiled_geqrf(int m, int n, value_type* a, int lda, value_type* tau)
+{
+    const tile_layout tiles(m, n, tile_size);
+    const int kt = (std::min(m,n) + tile_size - 1) / tile_size;
+
+    // triangular factors of the block reflectors, one per panel
+    std::vector<value_type> t(tile_size*tile_size*kt);
+
+    task_graph graph(tiles.count());
+
+    for (int k = 0; k < kt; k++)
+    {
+        const int k0 = k*tile_size;
+        const int m_ = m-k0;
+        const int ib = std::min(m_, tiles.cols(k));
+
+        value_type* a_kk = a + k0 + k0*lda;
+        value_type* t_k = t.data() + k*tile_size*tile_size;
+
+        // panel factorization and the triangular factor of its block reflector
+        graph.add([=]()
+        {
+            int info = 0;
+            lapack::geqrf(m_, tiles.cols(k), a_kk, lda, tau+k0, info);
+            info_check(info);
+
+            if (k+1 < tiles.nt)
+                lapack::larft('f', 'c', m_, ib, a_kk, lda, tau+k0, t_k, tile_size);
+        }, std::vector<int>(), tiles.column(k, k), true);
+
+        // apply Q^H of this panel to each tile column to the right
+        for (int j = k+1; j < tiles.nt; j++)
+        {
+            const int j0 = j*tile_size;
+
+            graph.add([=]()
+            {
+                std::vector<value_type> work(tiles.cols(j)*ib);
+                lapack::larfb('l', 'c', 'f', 'c', m_, tiles.cols(j), ib, a_kk, lda, t_k, tile_size, a + k0 + j0*lda, lda, work.data(), tiles.cols(j));
+            }, tiles.column(k, k), tiles.column(j, k), (j == k+1));
+        }
+    }
+
+    graph.execute();
+}
+
 // this is a work around until VS std::bind can accept more paramaters
 template <typename value_type>
 struct geqrf_params
@@ -398,6 +455,15 @@ void geqrf(concurrency::accelerator_view& av, int m, int n, value_type* a, int l
     if (tau == nullptr)
         argument_error(6);
 
+    // the task graph schedule runs entirely on the host
+    if (amplapack_get_schedule() == amplapack_schedule_task_graph)
+    {
+        const int tile_size = 256;
+
+        _detail::tiled_geqrf<tile_size>(m, n, a, lda, tau);
+        return;
+    }
+
     // host views
     concurrency::array_view<value_type,2> host_view_a(n, lda, a);
     concurrency::array_view<value_type,2> host_view_a_sub = host_view_a.section(concurrency::index<2>(0,0), concurrency::extent<2>(n,m));
@@ -0,0 +1,243 @@
+/*----------------------------------------------------------------------------
+* Copyright  Microsoft Corp.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License.  You may obtain a copy
+* of the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+* KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+* WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+* MERCHANTABLITY OR NON-INFRINGEMENT.
+*
+* See the Apache Version 2.0 License for specific language governing
+* permissions and limitations under the License.
+*---------------------------------------------------------------------------
+*
+* gesv.h
+*
+*---------------------------------------------------------------------------*/
+
+#ifndef AMPLAPACK_GESV_H
+#define AMPLAPACK_GESV_H
+
+#include "amplapack_config.h"
+#include "getrf.h"
+#include "refinement.h"
+
+namespace amplapack {
+namespace _detail {
+
+//
+// Triangular Solves
+//
+
+// solves a * x = b using the factors from getrf; x overwrites b
+template <enum class ordering storage_type, typename value_type>
+void getrs(const concurrency::accelerator_view& av, const concurrency::array_view<value_type,2>& a, concurrency::array_view<int,1>& ipiv, concurrency::array_view<value_type,2>& b)
+{
+    const int n = require_square(a);
+
+    // apply row interchanges
+    laswp<storage_type>(av, b, 0, n, ipiv);
+
+    // solve l * y = b and u * x = y
+    concurrency::array_view<const value_type,2> a_const(a);
+    ampblas::link::trsm(av, ampblas::side::left, ampblas::uplo::lower, ampblas::transpose::no_trans, ampblas::diag::unit, value_type(1), a_const, b);
+    ampblas::link::trsm(av, ampblas::side::left, ampblas::uplo::upper, ampblas::transpose::no_trans, ampblas::diag::non_unit, value_type(1), a_const, b);
+}
+
+//
+// Mixed Precision Iterative Refinement
+//
+
+// factors a in the lower precision and refines x in the precision of a; returns false
+// (with the reason in iter) if the factorization fails or refinement does not converge
+template <enum class ordering storage_type, typename value_type>
+bool refined_gesv(const concurrency::accelerator_view& av, const concurrency::array_view<value_type,2>& a, concurrency::array_view<int,1>& ipiv, const concurrency::array_view<value_type,2>& b, concurrency::array_view<value_type,2>& x, typename ampblas::real_type<value_type>::type tolerance, int& iter)
+{
+    typedef typename lower_precision<value_type>::type lower_type;
+
+    using concurrency::array;
+    using concurrency::array_view;
+
+    // lower precision copies of a and the right hand sides
+    array<lower_type,2> array_sa(a.extent, av);
+    array_view<lower_type,2> sa(array_sa);
+
+    array<lower_type,2> array_sx(b.extent, av);
+    array_view<lower_type,2> sx(array_sx);
+
+    // residual
+    array<value_type,2> array_r(b.extent, av);
+    array_view<value_type,2> r(array_r);
+
+    convert(av, array_view<const value_type,2>(a), sa);
+
+    // factor in the lower precision
+    try
+    {
+        getrf<storage_type>(av, sa, ipiv);
+    }
+    catch(const data_error_exception&)
+    {
+        iter = -3;
+        return false;
+    }
+
+    // initial solution
+    convert(av, array_view<const value_type,2>(b), sx);
+    getrs<storage_type>(av, sa, ipiv, sx);
+    convert(av, array_view<const lower_type,2>(sx), x);
+
+    for (iter = 0; ; iter++)
+    {
+        // r = b - a * x
+        concurrency::copy(b, r);
+        ampblas::link::gemm(av, ampblas::transpose::no_trans, ampblas::transpose::no_trans, value_type(-1), array_view<const value_type,2>(a), array_view<const value_type,2>(x), value_type(1), r);
+
+        const refinement_status status = check_refinement(x, r, tolerance);
+
+        if (status == refinement_status::converged)
+            return true;
+
+        if (status == refinement_status::overflow)
+        {
+            iter = -2;
+            return false;
+        }
+
+        if (iter == max_refinement_iterations)
+        {
+            iter = -(max_refinement_iterations + 1);
+            return false;
+        }
+
+        // x += a \ r in the lower precision
+        convert(av, array_view<const value_type,2>(r), sx);
+        getrs<storage_type>(av, sa, ipiv, sx);
+        add_converted(av, array_view<const lower_type,2>(sx), x);
+    }
+}
+
+// this is a work around until VS std::bind can accept more paramaters
+template <typename value_type>
+struct mixed_gesv_params
+{
+    int n;
+    int nrhs;
+    value_type* a;
+    int lda;
+    int* ipiv;
+    value_type* b;
+    int ldb;
+    value_type* x;
+    int ldx;
+    int* iter;
+
+    mixed_gesv_params(int n, int nrhs, value_type* a, int lda, int* ipiv, value_type* b, int ldb, value_type* x, int ldx, int* iter)
+        : n(n), nrhs(nrhs), a(a), lda(lda), ipiv(ipiv), b(b), ldb(ldb), x(x), ldx(ldx), iter(iter)
+    {}
+};
+
+template <typename value_type>
+void mixed_gesv_unpack(concurrency::accelerator_view& av, const mixed_gesv_params<value_type>& p)
+{
+    amplapack::mixed_gesv(av, p.n, p.nrhs, p.a, p.lda, p.ipiv, p.b, p.ldb, p.x, p.ldx, *p.iter);
+}
+
+} // namespace _detail
+
+//
+// Host Interface Function
+//
+
+// Solves a * x = b by factoring a in single precision and refining x in double
+// precision. If refinement fails, a is factored in double precision instead; iter
+// reports what happened:
+//
+//   iter >= 0   refinement converged after iter corrections (a is unchanged)
+//   iter = -2   a value overflowed the single precision range
+//   iter = -3   the single precision factorization failed
+//   iter = -31  refinement did not converge after 30 corrections
+//
+// When iter < 0, a and ipiv hold the double precision factorization.
+template <typename value_type>
+void mixed_gesv(concurrency::accelerator_view& av, int n, int nrhs, value_type* a, int lda, int* ipiv, value_type* b, int ldb, value_type* x, int ldx, int& iter)
+{
+    typedef typename ampblas::real_type<value_type>::type real_type;
+
+    iter = 0;
+
+    // quick return
+    if (n == 0 || nrhs == 0)
+        return;
+
+    // error checking
+    if (n < 0)
+        argument_error(1);
+    if (nrhs < 0)
+        argument_error(2);
+    if (a == nullptr)
+        argument_error(3);
+    if (lda < n)
+        argument_error(4);
+    if (ipiv == nullptr)
+        argument_error(5);
+    if (b == nullptr)
+        argument_error(6);
+    if (ldb < n)
+        argument_error(7);
+    if (x == nullptr)
+        argument_error(8);
+    if (ldx < n)
+        argument_error(9);
+
+    // residual tolerance (as in LAPACK)
+    const real_type eps = std::numeric_limits<real_type>::epsilon() / 2;
+    const real_type tolerance = _detail::inf_norm(n, n, a, lda) * eps * std::sqrt(real_type(n));
+
+    // host views
+    concurrency::array_view<value_type,2> host_view_a(n, lda, a);
+    concurrency::array_view<value_type,2> host_view_a_sub = host_view_a.section(concurrency::index<2>(0,0), concurrency::extent<2>(n,n));
+    concurrency::array_view<value_type,2> host_view_b(nrhs, ldb, b);
+    concurrency::array_view<value_type,2> host_view_b_sub = host_view_b.section(concurrency::index<2>(0,0), concurrency::extent<2>(nrhs,n));
+    concurrency::array_view<value_type,2> host_view_x(nrhs, ldx, x);
+    concurrency::array_view<value_type,2> host_view_x_sub = host_view_x.section(concurrency::index<2>(0,0), concurrency::extent<2>(nrhs,n));
+    concurrency::array_view<int,1> host_view_ipiv(n, ipiv);
+
+    // accelerator arrays (allocation and copy)
+    concurrency::array<value_type,2> accl_a(host_view_a_sub);
+    concurrency::array<value_type,2> accl_b(host_view_b_sub);
+    concurrency::array<value_type,2> accl_x(accl_b.extent, av);
+
+    // accelerator views
+    concurrency::array_view<value_type,2> accl_view_a(accl_a);
+    concurrency::array_view<value_type,2> accl_view_b(accl_b);
+    concurrency::array_view<value_type,2> accl_view_x(accl_x);
+
+    bool refined = false;
+
+    if (!_detail::fits_lower_precision(n, n, a, lda) || !_detail::fits_lower_precision(n, nrhs, b, ldb))
+        iter = -2;
+    else
+        refined = _detail::refined_gesv<ordering::column_major>(av, accl_view_a, host_view_ipiv, accl_view_b, accl_view_x, tolerance, iter);
+
+    if (!refined)
+    {
+        // fall back to a full precision factorization
+        concurrency::copy(accl_view_b, accl_view_x);
+        getrf<ordering::column_major>(av, accl_view_a, host_view_ipiv);
+        _detail::getrs<ordering::column_major>(av, accl_view_a, host_view_ipiv, accl_view_x);
+
+        // copy factors back to host
+        concurrency::copy(accl_view_a, host_view_a_sub);
+    }
+
+    // copy solution back to host
+    concurrency::copy(accl_view_x, host_view_x_sub);
+}
+
+} // namespace amplapack
+
+#endif // AMPLAPACK_GESV_H
@@ -22,6 +22,8 @@
 #define AMPLAPACK_GETRF_H
 
 #include "amplapack_config.h"
+#include "host_blas.h"
+#include "task_graph.h"
 
 // external lapack functions
 
@@ -38,25 +40,25 @@ template <typename value_type>
 void getrf(int m, int n, value_type* a, int lda, int* ipiv, int& info);
 
 template <>
-void getrf(int m, int n, float* a, int lda, int* ipiv, int& info)
+inline void getrf(int m, int n, float* a, int lda, int* ipiv, int& info)
 { 
     LAPACK_SGETRF(&m, &n, a, &lda, ipiv, &info); 
 }
 
 template <>
-void getrf(int m, int n, double* a, int lda, int* ipiv, int& info)
+inline void getrf(int m, int n, double* a, int lda, int* ipiv, int& info)
 { 
     LAPACK_DGETRF(&m, &n, a, &lda, ipiv, &info); 
 }
 
 template <>
-void getrf(int m, int n, ampblas::complex<float>* a, int lda, int* ipiv, int& info)
+inline void getrf(int m, int n, ampblas::complex<float>* a, int lda, int* ipiv, int& info)
 { 
     LAPACK_CGETRF(&m, &n, a, &lda, ipiv, &info); 
 }
 
 template <>
-void getrf(int m, int n, ampblas::complex<double>* a, int lda, int* ipiv, int& info)
+inline void getrf(int m, int n, ampblas::complex<double>* a, int lda, int* ipiv, int& info)
 {
     LAPACK_ZGETRF(&m, &n, a, &lda, ipiv, &info); 
 }
@@ -241,6 +243,93 @@ void getrf(const concurrency::accelerator_view& av, concurrency::array_view<valu
         data_error(info);
 }
 
+//
+// Tiled Factorization
+//
+
+// Right looking LU over a grid of tiles, run as a task graph on the host. The
+// panel of tile column k is factored as soon as its last update from step k-1
+// is done, so it overlaps the remaining trailing updates of step k-1.
+template <int tile_size, typename value_type>
+void tiled_getrf(int m, int n, value_type* a, int lda, int* ipiv)
+{
+    const tile_layout tiles(m, n, tile_size);
+    const int kt = (std::min(m,n) + tile_size - 1) / tile_size;
+
+    task_graph graph(tiles.count());
+
+    // panels run one after another, so the first data error needs no lock
+    int info = 0;
+
+    for (int k = 0; k < kt; k++)
+    {
+        const int k0 = k*tile_size;
+        value_type* a_kk = a + k0 + k0*lda;
+
+        // panel: tiles k through mt-1 of tile column k
+        graph.add([=, &info]()
+        {
+            const int m_ = m-k0;
+            const int n_ = tiles.cols(k);
+            const int k_ = std::min(m_,n_);
+
+            int panel_info = 0;
+            lapack::getrf(m_, n_, a_kk, lda, ipiv+k0, panel_info);
+
+            // offset data error (do not rethrow)
+            if (panel_info > 0 && info == 0)
+                info = k0 + panel_info;
+
+            // offset pivot vector
+            for (int i = 0; i < k_; i++)
+                ipiv[k0+i] += k0;
+        }, std::vector<int>(), tiles.column(k, k), true);
+
+        // pivots of this panel
+        const int k1 = k0+1;
+        const int k2 = k0+std::min(m-k0, tiles.cols(k));
+
+        // apply interchanges to tile columns 0:k-1
+        for (int j = 0; j < k; j++)
+        {
+            graph.add([=]()
+            {
+                lapack::laswp(tiles.cols(j), a + j*tile_size*lda, lda, k1, k2, ipiv, 1);
+            }, tile_list(tiles.id(k,k)), tiles.column(j, k));
+        }
+
+        for (int j = k+1; j < tiles.nt; j++)
+        {
+            const int j0 = j*tile_size;
+            const bool look_ahead = (j == k+1);
+
+            // apply interchanges to tile column j and compute its block row of U
+            graph.add([=]()
+            {
+                lapack::laswp(tiles.cols(j), a + j0*lda, lda, k1, k2, ipiv, 1);
+                lapack::trsm('l', 'l', 'n', 'u', tiles.rows(k), tiles.cols(j), value_type(1), a_kk, lda, a + k0 + j0*lda, lda);
+            }, tile_list(tiles.id(k,k)), tiles.column(j, k), look_ahead);
+
+            // update the trailing tiles of column j
+            for (int i = k+1; i < tiles.mt; i++)
+            {
+                const int i0 = i*tile_size;
+
+                graph.add([=]()
+                {
+                    lapack::gemm('n', 'n', tiles.rows(i), tiles.cols(j), tiles.cols(k), value_type(-1), a + i0 + k0*lda, lda, a + k0 + j0*lda, lda, value_type(1), a + i0 + j0*lda, lda);
+                }, tile_list(tiles.id(i,k), tiles.id(k,j)), tile_list(tiles.id(i,j)), look_ahead);
+            }
+        }
+    }
+
+    graph.execute();
+
+    // rethrow data error (if any)
+    if (info)
+        data_error(info);
+}
+
 //
 // Forwarding Function
 //
@@ -304,6 +393,15 @@ void getrf(concurrency::accelerator_view& av, int m, int n, value_type* a, int l
     if (ipiv == nullptr)
         argument_error(6);
 
+    // the task graph schedule runs entirely on the host
+    if (amplapack_get_schedule() == amplapack_schedule_task_graph)
+    {
+        const int tile_size = 256;
+
+        _detail::tiled_getrf<tile_size>(m, n, a, lda, ipiv);
+        return;
+    }
+
     // host views
     concurrency::array_view<value_type,2> host_view_a(n, lda, a);
     concurrency::array_view<value_type,2> host_view_a_sub = host_view_a.section(concurrency::index<2>(0,0), concurrency::extent<2>(n,m));
@@ -0,0 +1,175 @@
+/*----------------------------------------------------------------------------
+* Copyright  Microsoft Corp.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License.  You may obtain a copy
+* of the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+* KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+* WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+* MERCHANTABLITY OR NON-INFRINGEMENT.
+*
+* See the Apache Version 2.0 License for specific language governing
+* permissions and limitations under the License.
+*---------------------------------------------------------------------------
+*
+* host_blas.h
+*
+* Host BLAS and LAPACK kernels shared by the tiled factorizations. These are
+* included by several routines and are therefore inline.
+*
+*---------------------------------------------------------------------------*/
+
+#ifndef AMPLAPACK_HOST_BLAS_H
+#define AMPLAPACK_HOST_BLAS_H
+
+#include "amplapack_config.h"
+
+namespace amplapack {
+namespace _detail {
+
+//
+// External LAPACK Wrappers
+//
+
+namespace lapack {
+
+// gemm
+template <typename value_type>
+void gemm(char transa, char transb, int m, int n, int k, value_type alpha, const value_type* a, int lda, const value_type* b, int ldb, value_type beta, value_type* c, int ldc);
+
+template <>
+inline void gemm(char transa, char transb, int m, int n, int k, float alpha, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc)
+{
+    LAPACK_SGEMM(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+}
+
+template <>
+inline void gemm(char transa, char transb, int m, int n, int k, double alpha, const double* a, int lda, const double* b, int ldb, double beta, double* c, int ldc)
+{
+    LAPACK_DGEMM(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+}
+
+template <>
+inline void gemm(char transa, char transb, int m, int n, int k, ampblas::complex<float> alpha, const ampblas::complex<float>* a, int lda, const ampblas::complex<float>* b, int ldb, ampblas::complex<float> beta, ampblas::complex<float>* c, int ldc)
+{
+    LAPACK_CGEMM(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+}
+
+template <>
+inline void gemm(char transa, char transb, int m, int n, int k, ampblas::complex<double> alpha, const ampblas::complex<double>* a, int lda, const ampblas::complex<double>* b, int ldb, ampblas::complex<double> beta, ampblas::complex<double>* c, int ldc)
+{
+    LAPACK_ZGEMM(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+}
+
+// trsm
+template <typename value_type>
+void trsm(char side, char uplo, char transa, char diag, int m, int n, value_type alpha, const value_type* a, int lda, value_type* b, int ldb);
+
+template <>
+inline void trsm(char side, char uplo, char transa, char diag, int m, int n, float alpha, const float* a, int lda, float* b, int ldb)
+{
+    LAPACK_STRSM(&side, &uplo, &transa, &diag, &m, &n, &alpha, a, &lda, b, &ldb);
+}
+
+template <>
+inline void trsm(char side, char uplo, char transa, char diag, int m, int n, double alpha, const double* a, int lda, double* b, int ldb)
+{
+    LAPACK_DTRSM(&side, &uplo, &transa, &diag, &m, &n, &alpha, a, &lda, b, &ldb);
+}
+
+template <>
+inline void trsm(char side, char uplo, char transa, char diag, int m, int n, ampblas::complex<float> alpha, const ampblas::complex<float>* a, int lda, ampblas::complex<float>* b, int ldb)
+{
+    LAPACK_CTRSM(&side, &uplo, &transa, &diag, &m, &n, &alpha, a, &lda, b, &ldb);
+}
+
+template <>
+inline void trsm(char side, char uplo, char transa, char diag, int m, int n, ampblas::complex<double> alpha, const ampblas::complex<double>* a, int lda, ampblas::complex<double>* b, int ldb)
+{
+    LAPACK_ZTRSM(&side, &uplo, &transa, &diag, &m, &n, &alpha, a, &lda, b, &ldb);
+}
+
+// herk (syrk for real types)
+inline void herk(char uplo, char trans, int n, int k, float alpha, const float* a, int lda, float beta, float* c, int ldc)
+{
+    LAPACK_SSYRK(&uplo, &trans, &n, &k, &alpha, a, &lda, &beta, c, &ldc);
+}
+
+inline void herk(char uplo, char trans, int n, int k, double alpha, const double* a, int lda, double beta, double* c, int ldc)
+{
+    LAPACK_DSYRK(&uplo, &trans, &n, &k, &alpha, a, &lda, &beta, c, &ldc);
+}
+
+inline void herk(char uplo, char trans, int n, int k, float alpha, const ampblas::complex<float>* a, int lda, float beta, ampblas::complex<float>* c, int ldc)
+{
+    LAPACK_CHERK(&uplo, &trans, &n, &k, &alpha, a, &lda, &beta, c, &ldc);
+}
+
+inline void herk(char uplo, char trans, int n, int k, double alpha, const ampblas::complex<double>* a, int lda, double beta, ampblas::complex<double>* c, int ldc)
+{
+    LAPACK_ZHERK(&uplo, &trans, &n, &k, &alpha, a, &lda, &beta, c, &ldc);
+}
+
+// laswp
+template <typename value_type>
+void laswp(int n, value_type* a, int lda, int k1, int k2, int* ipiv, int incx);
+
+template <>
+inline void laswp(int n, float* a, int lda, int k1, int k2, int* ipiv, int incx)
+{
+    LAPACK_SLASWP(&n, a, &lda, &k1, &k2, ipiv, &incx);
+}
+
+template <>
+inline void laswp(int n, double* a, int lda, int k1, int k2, int* ipiv, int incx)
+{
+    LAPACK_DLASWP(&n, a, &lda, &k1, &k2, ipiv, &incx);
+}
+
+template <>
+inline void laswp(int n, ampblas::complex<float>* a, int lda, int k1, int k2, int* ipiv, int incx)
+{
+    LAPACK_CLASWP(&n, a, &lda, &k1, &k2, ipiv, &incx);
+}
+
+template <>
+inline void laswp(int n, ampblas::complex<double>* a, int lda, int k1, int k2, int* ipiv, int incx)
+{
+    LAPACK_ZLASWP(&n, a, &lda, &k1, &k2, ipiv, &incx);
+}
+
+// larfb
+template <typename value_type>
+void larfb(char side, char trans, char direct, char storev, int m, int n, int k, const value_type* v, int ldv, const value_type* t, int ldt, value_type* c, int ldc, value_type* work, int ldwork);
+
+template <>
+inline void larfb(char side, char trans, char direct, char storev, int m, int n, int k, const float* v, int ldv, const float* t, int ldt, float* c, int ldc, float* work, int ldwork)
+{
+    LAPACK_SLARFB(&side, &trans, &direct, &storev, &m, &n, &k, v, &ldv, t, &ldt, c, &ldc, work, &ldwork);
+}
+
+template <>
+inline void larfb(char side, char trans, char direct, char storev, int m, int n, int k, const double* v, int ldv, const double* t, int ldt, double* c, int ldc, double* work, int ldwork)
+{
+    LAPACK_DLARFB(&side, &trans, &direct, &storev, &m, &n, &k, v, &ldv, t, &ldt, c, &ldc, work, &ldwork);
+}
+
+template <>
+inline void larfb(char side, char trans, char direct, char storev, int m, int n, int k, const ampblas::complex<float>* v, int ldv, const ampblas::complex<float>* t, int ldt, ampblas::complex<float>* c, int ldc, ampblas::complex<float>* work, int ldwork)
+{
+    LAPACK_CLARFB(&side, &trans, &direct, &storev, &m, &n, &k, v, &ldv, t, &ldt, c, &ldc, work, &ldwork);
+}
+
+template <>
+inline void larfb(char side, char trans, char direct, char storev, int m, int n, int k, const ampblas::complex<double>* v, int ldv, const ampblas::complex<double>* t, int ldt, ampblas::complex<double>* c, int ldc, ampblas::complex<double>* work, int ldwork)
+{
+    LAPACK_ZLARFB(&side, &trans, &direct, &storev, &m, &n, &k, v, &ldv, t, &ldt, c, &ldc, work, &ldwork);
+}
+
+} // namespace lapack
+} // namespace _detail
+} // namespace amplapack
+
+#endif // AMPLAPACK_HOST_BLAS_H
@@ -0,0 +1,259 @@
+/*----------------------------------------------------------------------------
+* Copyright  Microsoft Corp.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License.  You may obtain a copy
+* of the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+* KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+* WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+* MERCHANTABLITY OR NON-INFRINGEMENT.
+*
+* See the Apache Version 2.0 License for specific language governing
+* permissions and limitations under the License.
+*---------------------------------------------------------------------------
+*
+* posv.h
+*
+*---------------------------------------------------------------------------*/
+
+#ifndef AMPLAPACK_POSV_H
+#define AMPLAPACK_POSV_H
+
+#include "amplapack_config.h"
+#include "potrf.h"
+#include "refinement.h"
+
+namespace amplapack {
+namespace _detail {
+
+//
+// Triangular Solves
+//
+
+// solves a * x = b using the factor from potrf; x overwrites b
+template <enum class ordering storage_type, typename value_type>
+void potrs(const concurrency::accelerator_view& av, enum class uplo uplo, const concurrency::array_view<value_type,2>& a, concurrency::array_view<value_type,2>& b)
+{
+    concurrency::array_view<const value_type,2> a_const(a);
+
+    if (uplo == uplo::upper)
+    {
+        // solve u^h * y = b and u * x = y
+        ampblas::link::trsm(av, ampblas::side::left, ampblas::uplo::upper, ampblas::transpose::conj_trans, ampblas::diag::non_unit, value_type(1), a_const, b);
+        ampblas::link::trsm(av, ampblas::side::left, ampblas::uplo::upper, ampblas::transpose::no_trans, ampblas::diag::non_unit, value_type(1), a_const, b);
+    }
+    else if (uplo == uplo::lower)
+    {
+        // solve l * y = b and l^h * x = y
+        ampblas::link::trsm(av, ampblas::side::left, ampblas::uplo::lower, ampblas::transpose::no_trans, ampblas::diag::non_unit, value_type(1), a_const, b);
+        ampblas::link::trsm(av, ampblas::side::left, ampblas::uplo::lower, ampblas::transpose::conj_trans, ampblas::diag::non_unit, value_type(1), a_const, b);
+    }
+}
+
+//
+// Mixed Precision Iterative Refinement
+//
+
+// factors a in the lower precision and refines x in the precision of a; the residual
+// uses full, which holds both triangles of a. Returns false (with the reason in iter)
+// if the factorization fails or refinement does not converge.
+template <enum class ordering storage_type, typename value_type>
+bool refined_posv(const concurrency::accelerator_view& av, enum class uplo uplo, const concurrency::array_view<value_type,2>& full, const concurrency::array_view<value_type,2>& b, concurrency::array_view<value_type,2>& x, typename ampblas::real_type<value_type>::type tolerance, int& iter)
+{
+    typedef typename lower_precision<value_type>::type lower_type;
+
+    using concurrency::array;
+    using concurrency::array_view;
+
+    // lower precision copies of a and the right hand sides
+    array<lower_type,2> array_sa(full.extent, av);
+    array_view<lower_type,2> sa(array_sa);
+
+    array<lower_type,2> array_sx(b.extent, av);
+    array_view<lower_type,2> sx(array_sx);
+
+    // residual
+    array<value_type,2> array_r(b.extent, av);
+    array_view<value_type,2> r(array_r);
+
+    convert(av, array_view<const value_type,2>(full), sa);
+
+    // factor in the lower precision
+    try
+    {
+        potrf<storage_type>(av, uplo, sa);
+    }
+    catch(const data_error_exception&)
+    {
+        iter = -3;
+        return false;
+    }
+
+    // initial solution
+    convert(av, array_view<const value_type,2>(b), sx);
+    potrs<storage_type>(av, uplo, sa, sx);
+    convert(av, array_view<const lower_type,2>(sx), x);
+
+    for (iter = 0; ; iter++)
+    {
+        // r = b - a * x
+        concurrency::copy(b, r);
+        ampblas::link::gemm(av, ampblas::transpose::no_trans, ampblas::transpose::no_trans, value_type(-1), array_view<const value_type,2>(full), array_view<const value_type,2>(x), value_type(1), r);
+
+        const refinement_status status = check_refinement(x, r, tolerance);
+
+        if (status == refinement_status::converged)
+            return true;
+
+        if (status == refinement_status::overflow)
+        {
+            iter = -2;
+            return false;
+        }
+
+        if (iter == max_refinement_iterations)
+        {
+            iter = -(max_refinement_iterations + 1);
+            return false;
+        }
+
+        // x += a \ r in the lower precision
+        convert(av, array_view<const value_type,2>(r), sx);
+        potrs<storage_type>(av, uplo, sa, sx);
+        add_converted(av, array_view<const lower_type,2>(sx), x);
+    }
+}
+
+// this is a work around until VS std::bind can accept more paramaters
+template <typename value_type>
+struct mixed_posv_params
+{
+    char uplo;
+    int n;
+    int nrhs;
+    value_type* a;
+    int lda;
+    value_type* b;
+    int ldb;
+    value_type* x;
+    int ldx;
+    int* iter;
+
+    mixed_posv_params(char uplo, int n, int nrhs, value_type* a, int lda, value_type* b, int ldb, value_type* x, int ldx, int* iter)
+        : uplo(uplo), n(n), nrhs(nrhs), a(a), lda(lda), b(b), ldb(ldb), x(x), ldx(ldx), iter(iter)
+    {}
+};
+
+template <typename value_type>
+void mixed_posv_unpack(concurrency::accelerator_view& av, const mixed_posv_params<value_type>& p)
+{
+    amplapack::mixed_posv(av, p.uplo, p.n, p.nrhs, p.a, p.lda, p.b, p.ldb, p.x, p.ldx, *p.iter);
+}
+
+} // namespace _detail
+
+//
+// Host Interface Function
+//
+
+// Solves a * x = b for a Hermitian positive definite a by factoring a in single
+// precision and refining x in double precision. Only the uplo triangle of a is
+// referenced. iter reports the outcome in the same way as mixed_gesv; when iter < 0
+// the uplo triangle of a holds the double precision Cholesky factor.
+template <typename value_type>
+void mixed_posv(concurrency::accelerator_view& av, char uplo, int n, int nrhs, value_type* a, int lda, value_type* b, int ldb, value_type* x, int ldx, int& iter)
+{
+    typedef typename ampblas::real_type<value_type>::type real_type;
+
+    iter = 0;
+
+    // quick return
+    if (n == 0 || nrhs == 0)
+        return;
+
+    // error checking
+    uplo = static_cast<char>(toupper(uplo));
+
+    if (uplo != 'L' && uplo != 'U')
+        argument_error(1);
+    if (n < 0)
+        argument_error(2);
+    if (nrhs < 0)
+        argument_error(3);
+    if (a == nullptr)
+        argument_error(4);
+    if (lda < n)
+        argument_error(5);
+    if (b == nullptr)
+        argument_error(6);
+    if (ldb < n)
+        argument_error(7);
+    if (x == nullptr)
+        argument_error(8);
+    if (ldx < n)
+        argument_error(9);
+
+    // both triangles of a for the residual
+    std::vector<value_type> full(n*n);
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            const bool stored = (uplo == 'U' ? i <= j : i >= j);
+            full[j*n+i] = (stored ? a[j*lda+i] : _detail::conjugate(a[i*lda+j]));
+        }
+    }
+
+    // residual tolerance (as in LAPACK)
+    const real_type eps = std::numeric_limits<real_type>::epsilon() / 2;
+    const real_type tolerance = _detail::inf_norm(n, n, &full[0], n) * eps * std::sqrt(real_type(n));
+
+    // host views
+    concurrency::array_view<value_type,2> host_view_a(n, lda, a);
+    concurrency::array_view<value_type,2> host_view_a_sub = host_view_a.section(concurrency::index<2>(0,0), concurrency::extent<2>(n,n));
+    concurrency::array_view<value_type,2> host_view_full(n, n, &full[0]);
+    concurrency::array_view<value_type,2> host_view_b(nrhs, ldb, b);
+    concurrency::array_view<value_type,2> host_view_b_sub = host_view_b.section(concurrency::index<2>(0,0), concurrency::extent<2>(nrhs,n));
+    concurrency::array_view<value_type,2> host_view_x(nrhs, ldx, x);
+    concurrency::array_view<value_type,2> host_view_x_sub = host_view_x.section(concurrency::index<2>(0,0), concurrency::extent<2>(nrhs,n));
+
+    // accelerator arrays (allocation and copy)
+    concurrency::array<value_type,2> accl_full(host_view_full);
+    concurrency::array<value_type,2> accl_b(host_view_b_sub);
+    concurrency::array<value_type,2> accl_x(accl_b.extent, av);
+
+    // accelerator views
+    concurrency::array_view<value_type,2> accl_view_full(accl_full);
+    concurrency::array_view<value_type,2> accl_view_b(accl_b);
+    concurrency::array_view<value_type,2> accl_view_x(accl_x);
+
+    bool refined = false;
+
+    if (!_detail::fits_lower_precision(n, n, &full[0], n) || !_detail::fits_lower_precision(n, nrhs, b, ldb))
+        iter = -2;
+    else
+        refined = _detail::refined_posv<ordering::column_major>(av, to_option(uplo), accl_view_full, accl_view_b, accl_view_x, tolerance, iter);
+
+    if (!refined)
+    {
+        // fall back to a full precision factorization
+        concurrency::array<value_type,2> accl_a(host_view_a_sub);
+        concurrency::array_view<value_type,2> accl_view_a(accl_a);
+
+        concurrency::copy(accl_view_b, accl_view_x);
+        potrf<ordering::column_major>(av, to_option(uplo), accl_view_a);
+        _detail::potrs<ordering::column_major>(av, to_option(uplo), accl_view_a, accl_view_x);
+
+        // copy factor back to host
+        concurrency::copy(accl_view_a, host_view_a_sub);
+    }
+
+    // copy solution back to host
+    concurrency::copy(accl_view_x, host_view_x_sub);
+}
+
+} // namespace amplapack
+
+#endif // AMPLAPACK_POSV_H
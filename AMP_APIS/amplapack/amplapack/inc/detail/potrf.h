@@ -22,6 +22,8 @@
 #define AMPLAPACK_POTRF_H
 
 #include "amplapack_config.h"
+#include "host_blas.h"
+#include "task_graph.h"
 
 // external lapack functions
 
@@ -38,25 +40,25 @@ template <typename value_type>
 void potrf(char uplo, int n, value_type* a, int lda, int& info);
 
 template <>
-void potrf(char uplo, int n, float* a, int lda, int& info)
+inline void potrf(char uplo, int n, float* a, int lda, int& info)
 { 
     LAPACK_SPOTRF(&uplo, &n, a, &lda, &info); 
 }
 
 template <>
-void potrf(char uplo, int n, double* a, int lda, int& info)
+inline void potrf(char uplo, int n, double* a, int lda, int& info)
 { 
     LAPACK_DPOTRF(&uplo, &n, a, &lda, &info); 
 }
 
 template <>
-void potrf(char uplo, int n, ampblas::complex<float>* a, int lda, int& info)
+inline void potrf(char uplo, int n, ampblas::complex<float>* a, int lda, int& info)
 { 
     LAPACK_CPOTRF(&uplo, &n, a, &lda, &info); 
 }
 
 template <>
-void potrf(char uplo, int n, ampblas::complex<double>* a, int lda, int& info)
+inline void potrf(char uplo, int n, ampblas::complex<double>* a, int lda, int& info)
 { 
     LAPACK_ZPOTRF(&uplo, &n, a, &lda, &info); 
 }
@@ -248,6 +250,114 @@ void potrf(const concurrency::accelerator_view& av, enum class uplo uplo, const
     }
 }
 
+//
+// Tiled Factorization
+//
+
+// Cholesky over the stored triangle of a grid of tiles, run as a task graph on
+// the host. The diagonal tile of step k+1 is factored as soon as its own update
+// from step k is done, ahead of the rest of the trailing matrix.
+template <int tile_size, typename value_type>
+void tiled_potrf(char uplo, int n, value_type* a, int lda)
+{
+    typedef typename ampblas::real_type<value_type>::type real_type;
+
+    const tile_layout tiles(n, n, tile_size);
+    const bool lower = (uplo == 'L');
+
+    task_graph graph(tiles.count());
+
+    for (int k = 0; k < tiles.nt; k++)
+    {
+        const int k0 = k*tile_size;
+        value_type* a_kk = a + k0 + k0*lda;
+
+        // factor the diagonal tile
+        graph.add([=]()
+        {
+            int info = 0;
+            lapack::potrf(uplo, tiles.rows(k), a_kk, lda, info);
+
+            // offset local block error
+            if (info > 0)
+                data_error(k0 + info);
+            info_check(info);
+        }, std::vector<int>(), tile_list(tiles.id(k,k)), true);
+
+        // solve for the off diagonal tiles of this step
+        for (int i = k+1; i < tiles.nt; i++)
+        {
+            const int i0 = i*tile_size;
+            const bool look_ahead = (i == k+1);
+
+            if (lower)
+            {
+                // A(i,k) = A(i,k) * L(k,k)^-H
+                graph.add([=]()
+                {
+                    lapack::trsm('r', 'l', 'c', 'n', tiles.rows(i), tiles.cols(k), value_type(1), a_kk, lda, a + i0 + k0*lda, lda);
+                }, tile_list(tiles.id(k,k)), tile_list(tiles.id(i,k)), look_ahead);
+            }
+            else
+            {
+                // A(k,i) = U(k,k)^-H * A(k,i)
+                graph.add([=]()
+                {
+                    lapack::trsm('l', 'u', 'c', 'n', tiles.rows(k), tiles.cols(i), value_type(1), a_kk, lda, a + k0 + i0*lda, lda);
+                }, tile_list(tiles.id(k,k)), tile_list(tiles.id(k,i)), look_ahead);
+            }
+        }
+
+        // update the trailing triangle
+        for (int j = k+1; j < tiles.nt; j++)
+        {
+            const int j0 = j*tile_size;
+            const bool look_ahead = (j == k+1);
+
+            if (lower)
+            {
+                // A(j,j) -= A(j,k) * A(j,k)^H
+                graph.add([=]()
+                {
+                    lapack::herk('l', 'n', tiles.rows(j), tiles.cols(k), real_type(-1), a + j0 + k0*lda, lda, real_type(1), a + j0 + j0*lda, lda);
+                }, tile_list(tiles.id(j,k)), tile_list(tiles.id(j,j)), look_ahead);
+
+                // A(i,j) -= A(i,k) * A(j,k)^H
+                for (int i = j+1; i < tiles.nt; i++)
+                {
+                    const int i0 = i*tile_size;
+
+                    graph.add([=]()
+                    {
+                        lapack::gemm('n', 'c', tiles.rows(i), tiles.rows(j), tiles.cols(k), value_type(-1), a + i0 + k0*lda, lda, a + j0 + k0*lda, lda, value_type(1), a + i0 + j0*lda, lda);
+                    }, tile_list(tiles.id(i,k), tiles.id(j,k)), tile_list(tiles.id(i,j)), look_ahead);
+                }
+            }
+            else
+            {
+                // A(j,j) -= A(k,j)^H * A(k,j)
+                graph.add([=]()
+                {
+                    lapack::herk('u', 'c', tiles.cols(j), tiles.rows(k), real_type(-1), a + k0 + j0*lda, lda, real_type(1), a + j0 + j0*lda, lda);
+                }, tile_list(tiles.id(k,j)), tile_list(tiles.id(j,j)), look_ahead);
+
+                // A(i,j) -= A(k,i)^H * A(k,j)
+                for (int i = k+1; i < j; i++)
+                {
+                    const int i0 = i*tile_size;
+
+                    graph.add([=]()
+                    {
+                        lapack::gemm('c', 'n', tiles.cols(i), tiles.cols(j), tiles.rows(k), value_type(-1), a + k0 + i0*lda, lda, a + k0 + j0*lda, lda, value_type(1), a + i0 + j0*lda, lda);
+                    }, tile_list(tiles.id(k,i), tiles.id(k,j)), tile_list(tiles.id(i,j)), (i == k+1));
+                }
+            }
+        }
+    }
+
+    graph.execute();
+}
+
 } // namespace _detail
 
 //
@@ -287,6 +397,15 @@ void potrf(concurrency::accelerator_view& av, char uplo, int n, value_type* a, i
     if (lda < n)
         argument_error(5);
 
+    // the task graph schedule runs entirely on the host
+    if (amplapack_get_schedule() == amplapack_schedule_task_graph)
+    {
+        const int tile_size = 256;
+
+        _detail::tiled_potrf<tile_size>(uplo, n, a, lda);
+        return;
+    }
+
     // host views
     concurrency::array_view<value_type,2> host_view_a(n, lda, a);
     concurrency::array_view<value_type,2> host_view_a_sub = host_view_a.section(concurrency::index<2>(0,0), concurrency::extent<2>(n,n));
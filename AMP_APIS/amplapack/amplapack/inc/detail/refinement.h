@@ -0,0 +1,201 @@
+/*----------------------------------------------------------------------------
+* Copyright  Microsoft Corp.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License.  You may obtain a copy
+* of the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+* KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+* WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+* MERCHANTABLITY OR NON-INFRINGEMENT.
+*
+* See the Apache Version 2.0 License for specific language governing
+* permissions and limitations under the License.
+*---------------------------------------------------------------------------
+*
+* refinement.h
+*
+* Helpers shared by the mixed precision iterative refinement drivers.
+*
+*---------------------------------------------------------------------------*/
+
+#ifndef AMPLAPACK_REFINEMENT_H
+#define AMPLAPACK_REFINEMENT_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "amplapack_config.h"
+
+namespace amplapack {
+namespace _detail {
+
+//
+// Precision Traits
+//
+
+// the type a mixed precision driver factors in
+template <typename value_type>
+struct lower_precision;
+
+template <>
+struct lower_precision<double>
+{
+    typedef float type;
+};
+
+template <>
+struct lower_precision<ampblas::complex<double>>
+{
+    typedef ampblas::complex<float> type;
+};
+
+// results of a refinement step
+enum class refinement_status { converged, not_converged, overflow };
+
+// refinement gives up after this many corrections (as in LAPACK)
+static const int max_refinement_iterations = 30;
+
+//
+// Accelerator Helper Functions
+//
+
+// y = x in the precision of y
+template <typename to_type, typename from_type>
+void convert(const concurrency::accelerator_view& av, const concurrency::array_view<const from_type,2>& x, const concurrency::array_view<to_type,2>& y)
+{
+    y.discard_data();
+
+    concurrency::parallel_for_each(av, y.extent, [=] (concurrency::index<2> idx) restrict(amp)
+    {
+        y[idx] = to_type(x[idx]);
+    });
+}
+
+// y += x in the precision of y
+template <typename to_type, typename from_type>
+void add_converted(const concurrency::accelerator_view& av, const concurrency::array_view<const from_type,2>& x, const concurrency::array_view<to_type,2>& y)
+{
+    concurrency::parallel_for_each(av, y.extent, [=] (concurrency::index<2> idx) restrict(amp)
+    {
+        y[idx] += to_type(x[idx]);
+    });
+}
+
+//
+// Host Helper Functions
+//
+
+// magnitude of the largest part of a value; checks if it can be represented in single precision
+template <typename real_type>
+real_type max_part(const real_type& value)
+{
+    return std::abs(value);
+}
+
+template <typename real_type>
+real_type max_part(const ampblas::complex<real_type>& value)
+{
+    return std::max(std::abs(value.real()), std::abs(value.imag()));
+}
+
+// complex conjugate; real values are returned as they are
+template <typename real_type>
+real_type conjugate(const real_type& value)
+{
+    return value;
+}
+
+template <typename real_type>
+ampblas::complex<real_type> conjugate(const ampblas::complex<real_type>& value)
+{
+    return ampblas::complex<real_type>(value.real(), -value.imag());
+}
+
+// true if every element of an m by n column major matrix can be stored in the lower precision
+template <typename value_type>
+bool fits_lower_precision(int m, int n, const value_type* a, int lda)
+{
+    typedef typename ampblas::real_type<typename lower_precision<value_type>::type>::type lower_real_type;
+    typedef typename ampblas::real_type<value_type>::type real_type;
+
+    const real_type limit = real_type(std::numeric_limits<lower_real_type>::max());
+
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < m; i++)
+            if (max_part(a[j*lda+i]) > limit)
+                return false;
+
+    return true;
+}
+
+// infinity norm of an m by n column major matrix
+template <typename value_type>
+typename ampblas::real_type<value_type>::type inf_norm(int m, int n, const value_type* a, int lda)
+{
+    typedef typename ampblas::real_type<value_type>::type real_type;
+
+    using std::abs;
+    using ampblas::abs;
+
+    std::vector<real_type> row_sums(m, real_type());
+
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < m; i++)
+            row_sums[i] += abs(a[j*lda+i]);
+
+    return m ? *std::max_element(row_sums.begin(), row_sums.end()) : real_type();
+}
+
+// compares each column of the residual r against the same column of the solution x;
+// refinement has converged when max|r| <= max|x| * tolerance for every column
+template <typename value_type>
+refinement_status check_refinement(const concurrency::array_view<value_type,2>& x, const concurrency::array_view<value_type,2>& r, typename ampblas::real_type<value_type>::type tolerance)
+{
+    typedef typename ampblas::real_type<value_type>::type real_type;
+    typedef typename ampblas::real_type<typename lower_precision<value_type>::type>::type lower_real_type;
+
+    using std::abs;
+    using ampblas::abs;
+
+    // column major: extent is (columns, rows)
+    const int nrhs = x.extent[0];
+    const int n = x.extent[1];
+
+    std::vector<value_type> host_x(n*nrhs);
+    std::vector<value_type> host_r(n*nrhs);
+    concurrency::copy(x, host_x.begin());
+    concurrency::copy(r, host_r.begin());
+
+    const real_type limit = real_type(std::numeric_limits<lower_real_type>::max());
+    refinement_status status = refinement_status::converged;
+
+    for (int j = 0; j < nrhs; j++)
+    {
+        real_type x_norm = real_type();
+        real_type r_norm = real_type();
+
+        for (int i = 0; i < n; i++)
+        {
+            x_norm = std::max(x_norm, abs(host_x[j*n+i]));
+            r_norm = std::max(r_norm, abs(host_r[j*n+i]));
+
+            // the residual is corrected in the lower precision
+            if (max_part(host_r[j*n+i]) > limit)
+                return refinement_status::overflow;
+        }
+
+        if (r_norm > x_norm * tolerance)
+            status = refinement_status::not_converged;
+    }
+
+    return status;
+}
+
+} // namespace _detail
+} // namespace amplapack
+
+#endif // AMPLAPACK_REFINEMENT_H
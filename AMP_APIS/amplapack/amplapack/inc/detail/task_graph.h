@@ -0,0 +1,315 @@
+/*----------------------------------------------------------------------------
+* Copyright  Microsoft Corp.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License.  You may obtain a copy
+* of the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+* KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+* WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+* MERCHANTABLITY OR NON-INFRINGEMENT.
+*
+* See the Apache Version 2.0 License for specific language governing
+* permissions and limitations under the License.
+*---------------------------------------------------------------------------
+*
+* task_graph.h
+*
+* A tile task graph and the work stealing scheduler that executes it on the
+* host. Tasks declare the tiles they read and write; dependencies follow from
+* the order the tasks are added in, in the same way as a sequential program.
+*
+*---------------------------------------------------------------------------*/
+
+#ifndef AMPLAPACK_TASK_GRAPH_H
+#define AMPLAPACK_TASK_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace amplapack {
+namespace _detail {
+
+//
+// Worker Count
+//
+
+// one worker per hardware thread unless AMPLAPACK_NUM_THREADS says otherwise
+inline int task_graph_threads()
+{
+    static const int count = []() -> int
+    {
+        const char* env = std::getenv("AMPLAPACK_NUM_THREADS");
+        int threads = (env ? std::atoi(env) : 0);
+        if (threads <= 0)
+            threads = static_cast<int>(std::thread::hardware_concurrency());
+        return std::max(threads, 1);
+    }();
+
+    return count;
+}
+
+//
+// Tile Helpers
+//
+
+// the tiles of an m by n column major matrix, numbered down the columns
+struct tile_layout
+{
+    tile_layout(int m, int n, int tile_size)
+        : m(m), n(n), tile_size(tile_size), mt((m + tile_size - 1) / tile_size), nt((n + tile_size - 1) / tile_size)
+    {}
+
+    int rows(int i) const { return std::min(tile_size, m - i*tile_size); }
+    int cols(int j) const { return std::min(tile_size, n - j*tile_size); }
+    int id(int i, int j) const { return i + j*mt; }
+    int count() const { return mt*nt; }
+
+    // tiles i0 through mt-1 of tile column j
+    std::vector<int> column(int j, int i0) const
+    {
+        std::vector<int> ids;
+        for (int i = i0; i < mt; i++)
+            ids.push_back(id(i,j));
+        return ids;
+    }
+
+    int m;
+    int n;
+    int tile_size;
+    int mt;
+    int nt;
+};
+
+inline std::vector<int> tile_list(int a)
+{
+    return std::vector<int>(1, a);
+}
+
+inline std::vector<int> tile_list(int a, int b)
+{
+    std::vector<int> ids(1, a);
+    ids.push_back(b);
+    return ids;
+}
+
+//
+// Task Graph
+//
+
+class task_graph
+{
+public:
+
+    // tiles are numbered 0 to tile_count-1 by the caller
+    explicit task_graph(int tile_count)
+        : tile_states(tile_count)
+    {}
+
+    // adds a task; critical tasks (panels) are run ahead of other ready tasks
+    void add(const std::function<void()>& work, const std::vector<int>& reads, const std::vector<int>& writes, bool critical = false)
+    {
+        const int id = static_cast<int>(tasks.size());
+        tasks.push_back(task(work, critical));
+
+        // read after write
+        for (auto it = reads.begin(); it != reads.end(); ++it)
+        {
+            tile_state& tile = tile_states[*it];
+            depend(tile.writer, id);
+            tile.readers.push_back(id);
+        }
+
+        // write after write and write after read
+        for (auto it = writes.begin(); it != writes.end(); ++it)
+        {
+            tile_state& tile = tile_states[*it];
+            depend(tile.writer, id);
+            for (auto r = tile.readers.begin(); r != tile.readers.end(); ++r)
+                depend(*r, id);
+
+            tile.writer = id;
+            tile.readers.clear();
+        }
+    }
+
+    // runs every task; the first exception thrown by a task cancels the
+    // tasks that have not started and is rethrown here
+    void execute(int thread_count = task_graph_threads())
+    {
+        const int task_count = static_cast<int>(tasks.size());
+        if (task_count == 0)
+            return;
+
+        thread_count = std::max(1, std::min(thread_count, task_count));
+
+        // dependency counters
+        std::unique_ptr<std::atomic<int>[]> waiting(new std::atomic<int>[task_count]);
+        for (int i = 0; i < task_count; i++)
+            waiting[i] = tasks[i].dependencies;
+
+        // one deque per worker; the owner works at the back and thieves take from the front
+        std::vector<std::unique_ptr<worker_queue>> queues;
+        for (int i = 0; i < thread_count; i++)
+            queues.push_back(std::unique_ptr<worker_queue>(new worker_queue));
+
+        // deal the initially ready tasks round robin
+        int next = 0;
+        for (int i = 0; i < task_count; i++)
+        {
+            if (tasks[i].dependencies == 0)
+            {
+                queues[next]->tasks.push_back(i);
+                next = (next + 1) % thread_count;
+            }
+        }
+
+        std::atomic<int> remaining(task_count);
+        std::atomic<bool> cancelled(false);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        auto run = [&](int self)
+        {
+            worker_queue& own = *queues[self];
+
+            while (remaining.load() > 0)
+            {
+                int id = -1;
+
+                // own work, newest first
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (!own.tasks.empty())
+                    {
+                        id = own.tasks.back();
+                        own.tasks.pop_back();
+                    }
+                }
+
+                // steal the oldest task of another worker
+                for (int i = 1; id < 0 && i < thread_count; i++)
+                {
+                    worker_queue& victim = *queues[(self + i) % thread_count];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.tasks.empty())
+                    {
+                        id = victim.tasks.front();
+                        victim.tasks.pop_front();
+                    }
+                }
+
+                if (id < 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // cancelled tasks still release their successors so the graph drains
+                if (!cancelled.load())
+                {
+                    try
+                    {
+                        tasks[id].work();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        cancelled = true;
+                    }
+                }
+
+                // release successors; critical ones are queued last so they are taken next
+                const std::vector<int>& successors = tasks[id].successors;
+                std::vector<int> ready;
+                for (auto it = successors.begin(); it != successors.end(); ++it)
+                    if (--waiting[*it] == 0)
+                        ready.push_back(*it);
+
+                if (!ready.empty())
+                {
+                    std::stable_partition(ready.begin(), ready.end(), [&](int t) { return !tasks[t].critical; });
+
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    own.tasks.insert(own.tasks.end(), ready.begin(), ready.end());
+                }
+
+                --remaining;
+            }
+        };
+
+        // the calling thread is worker 0
+        std::vector<std::thread> threads;
+        for (int i = 1; i < thread_count; i++)
+            threads.push_back(std::thread(run, i));
+
+        run(0);
+
+        for (auto it = threads.begin(); it != threads.end(); ++it)
+            it->join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+
+    struct task
+    {
+        task(const std::function<void()>& work, bool critical)
+            : work(work), dependencies(0), critical(critical)
+        {}
+
+        std::function<void()> work;
+        std::vector<int> successors;
+        int dependencies;
+        bool critical;
+    };
+
+    struct tile_state
+    {
+        tile_state() : writer(-1) {}
+
+        int writer;
+        std::vector<int> readers;
+    };
+
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    void depend(int from, int to)
+    {
+        if (from < 0 || from == to)
+            return;
+
+        // edges from one task are added together, so a repeat is always the last one
+        std::vector<int>& successors = tasks[from].successors;
+        if (!successors.empty() && successors.back() == to)
+            return;
+
+        successors.push_back(to);
+        tasks[to].dependencies++;
+    }
+
+    std::vector<task> tasks;
+    std::vector<tile_state> tile_states;
+};
+
+} // namespace _detail
+} // namespace amplapack
+
+#endif // AMPLAPACK_TASK_GRAPH_H
@@ -141,6 +141,42 @@ void LAPACK_DPOTRF(const char*, lapack_int*, double*, lapack_int*, lapack_int*);
 void LAPACK_CPOTRF(const char*, lapack_int*, void*, lapack_int*, lapack_int*);
 void LAPACK_ZPOTRF(const char*, lapack_int*, void*, lapack_int*, lapack_int*);
 
+// trsm name
+#define LAPACK_STRSM LAPACK_NAME(strsm, STRSM)
+#define LAPACK_DTRSM LAPACK_NAME(dtrsm, DTRSM)
+#define LAPACK_CTRSM LAPACK_NAME(ctrsm, CTRSM)
+#define LAPACK_ZTRSM LAPACK_NAME(ztrsm, ZTRSM)
+
+// trsm signature
+void LAPACK_STRSM(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const float*, const float*, const lapack_int*, float*, const lapack_int*);
+void LAPACK_DTRSM(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const double*, const double*, const lapack_int*, double*, const lapack_int*);
+void LAPACK_CTRSM(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const void*, const void*, const lapack_int*, void*, const lapack_int*);
+void LAPACK_ZTRSM(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const void*, const void*, const lapack_int*, void*, const lapack_int*);
+
+// syrk/herk name
+#define LAPACK_SSYRK LAPACK_NAME(ssyrk, SSYRK)
+#define LAPACK_DSYRK LAPACK_NAME(dsyrk, DSYRK)
+#define LAPACK_CHERK LAPACK_NAME(cherk, CHERK)
+#define LAPACK_ZHERK LAPACK_NAME(zherk, ZHERK)
+
+// syrk/herk signature
+void LAPACK_SSYRK(const char*, const char*, const lapack_int*, const lapack_int*, const float*, const float*, const lapack_int*, const float*, float*, const lapack_int*);
+void LAPACK_DSYRK(const char*, const char*, const lapack_int*, const lapack_int*, const double*, const double*, const lapack_int*, const double*, double*, const lapack_int*);
+void LAPACK_CHERK(const char*, const char*, const lapack_int*, const lapack_int*, const float*, const void*, const lapack_int*, const float*, void*, const lapack_int*);
+void LAPACK_ZHERK(const char*, const char*, const lapack_int*, const lapack_int*, const double*, const void*, const lapack_int*, const double*, void*, const lapack_int*);
+
+// larfb name
+#define LAPACK_SLARFB LAPACK_NAME(slarfb, SLARFB)
+#define LAPACK_DLARFB LAPACK_NAME(dlarfb, DLARFB)
+#define LAPACK_CLARFB LAPACK_NAME(clarfb, CLARFB)
+#define LAPACK_ZLARFB LAPACK_NAME(zlarfb, ZLARFB)
+
+// larfb signature
+void LAPACK_SLARFB(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const lapack_int*, const float*, const lapack_int*, const float*, const lapack_int*, float*, const lapack_int*, float*, const lapack_int*);
+void LAPACK_DLARFB(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const lapack_int*, const double*, const lapack_int*, const double*, const lapack_int*, double*, const lapack_int*, double*, const lapack_int*);
+void LAPACK_CLARFB(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const lapack_int*, const void*, const lapack_int*, const void*, const lapack_int*, void*, const lapack_int*, void*, const lapack_int*);
+void LAPACK_ZLARFB(const char*, const char*, const char*, const char*, const lapack_int*, const lapack_int*, const lapack_int*, const void*, const lapack_int*, const void*, const lapack_int*, void*, const lapack_int*, void*, const lapack_int*);
+
 #ifdef __cplusplus
 }
 #endif
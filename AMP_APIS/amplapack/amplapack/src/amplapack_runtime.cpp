@@ -1,3 +1,5 @@
+#include <atomic>
+
 #include "amplapack_runtime.h"
 
 namespace amplapack {
@@ -63,3 +65,24 @@ amplapack_status safe_call_interface(std::function<void(concurrency::accelerator
 }
 
 } // namespace amplapack
+
+namespace {
+
+// the schedule used by the host interface functions
+std::atomic<int> current_schedule(amplapack_schedule_hybrid);
+
+} // namespace
+
+extern "C" {
+
+void amplapack_set_schedule(enum amplapack_schedule schedule)
+{
+    current_schedule = schedule;
+}
+
+enum amplapack_schedule amplapack_get_schedule()
+{
+    return static_cast<enum amplapack_schedule>(current_schedule.load());
+}
+
+} // extern "C"
@@ -0,0 +1,57 @@
+/*----------------------------------------------------------------------------
+ * Copyright  Microsoft Corp.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not 
+ * use this file except in compliance with the License.  You may obtain a copy 
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0  
+ * 
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED 
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE, 
+ * MERCHANTABLITY OR NON-INFRINGEMENT. 
+ *
+ * See the Apache Version 2.0 License for specific language governing 
+ * permissions and limitations under the License.
+ *---------------------------------------------------------------------------
+ * 
+ * gesv.cpp
+ *
+ *---------------------------------------------------------------------------*/
+
+#include <functional>
+
+#include <amp.h>
+
+#include "ampclapack.h"      
+#include "amplapack_runtime.h"
+
+#include "detail\gesv.h"    
+
+namespace _detail {
+
+template <typename value_type>
+amplapack_status do_mixed_gesv(int n, int nrhs, value_type* a, int lda, int* ipiv, value_type* b, int ldb, value_type* x, int ldx, int* iter, int& info)
+{
+    // create interface functor
+    // NOTE: VS11 std::bind doesn't support over 5 arguments; using a transport struct as a workaround
+    std::function<void(concurrency::accelerator_view&)> f = std::bind(amplapack::_detail::mixed_gesv_unpack<value_type>, std::placeholders::_1, amplapack::_detail::mixed_gesv_params<value_type>(n, nrhs, a, lda, ipiv, b, ldb, x, ldx, iter));
+
+    // execute using interface
+    return amplapack::safe_call_interface(f, info);
+}
+
+} // namespace _detail
+
+extern "C" {
+
+amplapack_status amplapack_dsgesv(int n, int nrhs, double* a, int lda, int* ipiv, double* b, int ldb, double* x, int ldx, int* iter, int* info)
+{
+    return _detail::do_mixed_gesv(n, nrhs, a, lda, ipiv, b, ldb, x, ldx, iter, *info); 
+}
+
+amplapack_status amplapack_zcgesv(int n, int nrhs, amplapack_dcomplex* a, int lda, int* ipiv, amplapack_dcomplex* b, int ldb, amplapack_dcomplex* x, int ldx, int* iter, int* info)
+{
+    return _detail::do_mixed_gesv(n, nrhs, amplapack::amplapack_cast(a), lda, ipiv, amplapack::amplapack_cast(b), ldb, amplapack::amplapack_cast(x), ldx, iter, *info); 
+}
+
+} // extern "C"
\ No newline at end of file
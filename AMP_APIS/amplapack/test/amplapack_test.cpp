@@ -127,4 +127,6 @@ int main()
     potrf_test();
     getrf_test();
     geqrf_test();
+    gesv_test();
+    posv_test();
 }
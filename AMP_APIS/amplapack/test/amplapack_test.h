@@ -34,6 +34,8 @@ inline const amplapack_dcomplex* cast(const dcomplex* ptr) { return reinterpret_
 void potrf_test();
 void getrf_test();
 void geqrf_test();
+void gesv_test();
+void posv_test();
 
 // LAPACK data type prefix (SDCZ)
 template <typename value_type>
@@ -43,7 +43,7 @@ void do_geqrf_test(int m, int n, int lda_offset = 0)
     // mark data outside of the leading dimension for debugging purposes
     for (int j = 0; j < n; j++)
         for (int i = 0; i < lda; i++)
-            if (i >= n)
+            if (i >= m)
                 a[j*lda+i] = value_type(-1);
 
     // backup a for reconstruction purposes
@@ -104,10 +104,10 @@ void do_geqrf_test(int m, int n, int lda_offset = 0)
         orgqr(m, m, k, q.data(), ldq, tau.data());
 
         // a = a - qr
-        gemm('n', 'n', m, k, m, value_type(1), q.data(), ldq, r.data(), ldr, value_type(-1), a_in.data(), lda);
+        gemm('n', 'n', m, n, m, value_type(1), q.data(), ldq, r.data(), ldr, value_type(-1), a_in.data(), lda);
 
         // norm
-        std::cout << " Error = " << one_norm(n, n, a_in.data(), lda);
+        std::cout << " Error = " << one_norm(m, n, a_in.data(), lda);
 
         // gflops
         std::cout << " GFLOPs = " << gflops<value_type>(sec, m,n) << std::endl; 
@@ -119,4 +119,20 @@ void geqrf_test()
     // quick tests
     do_geqrf_test<float>(1024, 1024); 
     do_geqrf_test<fcomplex>(1024, 1024);
+
+    // task graph schedule
+    amplapack_set_schedule(amplapack_schedule_task_graph);
+
+    do_geqrf_test<float>(1024, 1024);
+    do_geqrf_test<fcomplex>(1024, 1024);
+    do_geqrf_test<double>(1000, 1000, 3);
+    do_geqrf_test<dcomplex>(1000, 1000, 3);
+
+    // tall and wide panels
+    do_geqrf_test<float>(1500, 700);
+    do_geqrf_test<float>(700, 1500, 5);
+    do_geqrf_test<double>(1200, 1000, 3);
+    do_geqrf_test<dcomplex>(900, 1300);
+
+    amplapack_set_schedule(amplapack_schedule_hybrid);
 }
\ No newline at end of file
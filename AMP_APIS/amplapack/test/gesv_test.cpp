@@ -0,0 +1,92 @@
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include "amplapack_test.h"
+#include "ampxlapack.h"
+
+// host GEMM used for the residual
+#include "lapack_host.h"
+
+template <typename value_type>
+void do_gesv_test(int n, int nrhs, int lda_offset = 0, bool overflow = false)
+{
+    // header
+    std::cout << "Testing " << type_prefix<value_type>() << "GESV (mixed) for N=" << n << " NRHS=" << nrhs << " LDA=" << n+lda_offset << (overflow ? " (overflow)" : "") << "... ";
+
+    // performance timer
+    high_resolution_timer timer;
+
+    // create data
+    int lda = n + lda_offset;
+    int ldb = n;
+    std::vector<value_type> a(lda*n);
+    std::vector<value_type> b(ldb*nrhs);
+    std::vector<value_type> x(ldb*nrhs);
+    std::vector<int> ipiv(n);
+
+    // fill with random values
+    std::for_each(a.begin(), a.end(), [&](value_type& val) {
+        val = random_value(value_type(0), value_type(1));
+    });
+
+    std::for_each(b.begin(), b.end(), [&](value_type& val) {
+        val = random_value(value_type(0), value_type(1));
+    });
+
+    // a value out of single precision range forces the double precision fallback
+    if (overflow)
+        a[0] = value_type(1e39);
+
+    // backup a and b for the residual
+    std::vector<value_type> a_in(a);
+    std::vector<value_type> r(b);
+
+    int iter;
+    int info;
+
+    timer.restart();
+    amplapack_status status = amplapack_mixed_gesv(n, nrhs, cast(a.data()), lda, ipiv.data(), cast(b.data()), ldb, cast(x.data()), ldb, &iter, &info);
+    double sec = timer.elapsed();
+
+    switch(status)
+    {
+    case amplapack_success:
+        std::cout << "Success!";
+        break;
+    case amplapack_data_error:
+        std::cout << "Date Error @ " << info << std::endl;
+        break;
+    case amplapack_argument_error:
+        std::cout << "Argument Error @ " << -info << std::endl;
+        break;
+    case amplapack_runtime_error:
+        std::cout << "Runtime Error" << std::endl;
+        break;
+    case amplapack_memory_error:
+        std::cout << "Insuffecient Memory" << std::endl;
+        break;
+    default:
+        std::cout << "Unexpected Error?" << std::endl;
+        break;
+    }
+
+    if (status == amplapack_success)
+    {
+        // r = b - a*x
+        gemm('n', 'n', n, nrhs, n, value_type(-1), a_in.data(), lda, x.data(), ldb, value_type(1), r.data(), ldb);
+
+        // norm
+        std::cout << " Error = " << one_norm(n, nrhs, r.data(), ldb) << " ITER = " << iter << " Time = " << sec << std::endl;
+    }
+}
+
+void gesv_test()
+{
+    do_gesv_test<double>(1024, 1);
+    do_gesv_test<double>(1000, 16, 3);
+    do_gesv_test<double>(512, 4, 0, true);
+
+    do_gesv_test<dcomplex>(1024, 1);
+    do_gesv_test<dcomplex>(1000, 16, 3);
+}
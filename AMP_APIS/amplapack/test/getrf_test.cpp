@@ -38,13 +38,13 @@ void do_getrf_test(int m, int n, int lda_offset = 0)
     });
 
     // adjust diagonal for stability
-    for (int i = 0; i < (lda*n); i += (lda+1))
-        a[i] = random_value(value_type(1), value_type(2));
+    for (int i = 0; i < k; i++)
+        a[i*lda+i] = random_value(value_type(1), value_type(2));
 
     // mark data outside of the leading dimension for debugging purposes
     for (int j = 0; j < n; j++)
         for (int i = 0; i < lda; i++)
-            if (i >= n)
+            if (i >= m)
                 a[j*lda+i] = value_type(-1);
 
     // backup a for reconstruction purposes
@@ -81,7 +81,7 @@ void do_getrf_test(int m, int n, int lda_offset = 0)
     if (status == amplapack_success)
     {
         // swap on a
-        laswp(k, a_in.data(), lda, 1, k, ipiv.data(), 1);
+        laswp(n, a_in.data(), lda, 1, k, ipiv.data(), 1);
 
         // extract l and u
         std::vector<value_type> l(a);
@@ -106,7 +106,7 @@ void do_getrf_test(int m, int n, int lda_offset = 0)
         gemm('n', 'n', m, n, k, value_type(1), l.data(), lda, u.data(), lda, value_type(-1), a_in.data(), lda);
 
         // norm
-        std::cout << " Error = " << one_norm(n, n, a_in.data(), lda) << " GFLOPs = " << gflops<value_type>(sec, m, n) << std::endl;
+        std::cout << " Error = " << one_norm(m, n, a_in.data(), lda) << " GFLOPs = " << gflops<value_type>(sec, m, n) << std::endl;
     }
 }
 
@@ -115,4 +115,20 @@ void getrf_test()
     // quick tests
     do_getrf_test<float>(1024, 1024); 
     do_getrf_test<fcomplex>(1024, 1024);
+
+    // task graph schedule
+    amplapack_set_schedule(amplapack_schedule_task_graph);
+
+    do_getrf_test<float>(1024, 1024);
+    do_getrf_test<fcomplex>(1024, 1024);
+    do_getrf_test<double>(1000, 1000, 3);
+    do_getrf_test<dcomplex>(1000, 1000, 3);
+
+    // tall and wide panels
+    do_getrf_test<float>(1500, 700);
+    do_getrf_test<float>(700, 1500, 5);
+    do_getrf_test<double>(1200, 1000, 3);
+    do_getrf_test<dcomplex>(900, 1300);
+
+    amplapack_set_schedule(amplapack_schedule_hybrid);
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include "amplapack_test.h"
+#include "ampxlapack.h"
+
+// host GEMM used for the residual
+#include "lapack_host.h"
+
+template <typename value_type>
+inline value_type conjugate(const value_type& value)
+{
+    return value;
+}
+
+template <typename value_type>
+inline ampblas::complex<value_type> conjugate(const ampblas::complex<value_type>& value)
+{
+    return ampblas::complex<value_type>(value.real(), -value.imag());
+}
+
+template <typename value_type>
+void do_posv_test(char uplo, int n, int nrhs, int lda_offset = 0)
+{
+    // header
+    std::cout << "Testing " << type_prefix<value_type>() << "POSV (mixed) for UPLO=" << uplo << " N=" << n << " NRHS=" << nrhs << " LDA=" << n+lda_offset << "... ";
+
+    // performance timer
+    high_resolution_timer timer;
+
+    // create data
+    int lda = n + lda_offset;
+    int ldb = n;
+    std::vector<value_type> a(lda*n);
+    std::vector<value_type> b(ldb*nrhs);
+    std::vector<value_type> x(ldb*nrhs);
+
+    // fill with random values
+    std::for_each(a.begin(), a.end(), [&](value_type& val) {
+        val = random_value(value_type(0), value_type(1));
+    });
+
+    std::for_each(b.begin(), b.end(), [&](value_type& val) {
+        val = random_value(value_type(0), value_type(1));
+    });
+
+    // scale diagonal
+    for (int i = 0; i < (lda*n); i += (lda+1))
+        a[i] = value_type(ampblas::real_type<value_type>::type(n));
+
+    // reflect the referenced half so a is Hermitian for the residual
+    std::vector<value_type> a_in(a);
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+            if ((uplo == 'L' && i < j) || (uplo == 'U' && i > j))
+                a_in[j*lda+i] = conjugate(a_in[i*lda+j]);
+
+    // backup b for the residual
+    std::vector<value_type> r(b);
+
+    int iter;
+    int info;
+
+    timer.restart();
+    amplapack_status status = amplapack_mixed_posv(uplo, n, nrhs, cast(a.data()), lda, cast(b.data()), ldb, cast(x.data()), ldb, &iter, &info);
+    double sec = timer.elapsed();
+
+    switch(status)
+    {
+    case amplapack_success:
+        std::cout << "Success!";
+        break;
+    case amplapack_data_error:
+        std::cout << "Date Error @ " << info << std::endl;
+        break;
+    case amplapack_argument_error:
+        std::cout << "Argument Error @ " << -info << std::endl;
+        break;
+    case amplapack_runtime_error:
+        std::cout << "Runtime Error" << std::endl;
+        break;
+    case amplapack_memory_error:
+        std::cout << "Insuffecient Memory" << std::endl;
+        break;
+    default:
+        std::cout << "Unexpected Error?" << std::endl;
+        break;
+    }
+
+    if (status == amplapack_success)
+    {
+        // r = b - a*x
+        gemm('n', 'n', n, nrhs, n, value_type(-1), a_in.data(), lda, x.data(), ldb, value_type(1), r.data(), ldb);
+
+        // norm
+        std::cout << " Error = " << one_norm(n, nrhs, r.data(), ldb) << " ITER = " << iter << " Time = " << sec << std::endl;
+    }
+}
+
+void posv_test()
+{
+    do_posv_test<double>('L', 1024, 1);
+    do_posv_test<double>('U', 1000, 16, 3);
+
+    do_posv_test<dcomplex>('L', 1000, 16, 3);
+    do_posv_test<dcomplex>('U', 1024, 1);
+}
@@ -136,4 +136,17 @@ void potrf_test()
 
     do_potrf_test<fcomplex>('L', 1024);
     do_potrf_test<fcomplex>('U', 1024);
+
+    // task graph schedule
+    amplapack_set_schedule(amplapack_schedule_task_graph);
+
+    do_potrf_test<float>('L', 1024);
+    do_potrf_test<float>('U', 1024);
+    do_potrf_test<fcomplex>('L', 1000, 3);
+    do_potrf_test<fcomplex>('U', 1000, 3);
+    do_potrf_test<double>('L', 1000, 3);
+    do_potrf_test<dcomplex>('L', 1000, 3);
+    do_potrf_test<dcomplex>('U', 1000);
+
+    amplapack_set_schedule(amplapack_schedule_hybrid);
 }
\ No newline at end of file
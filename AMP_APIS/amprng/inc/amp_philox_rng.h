@@ -0,0 +1,196 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corp. 
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not 
+ * use this file except in compliance with the License.  You may obtain a copy 
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0  
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY 
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED 
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE, 
+ * MERCHANTABLITY OR NON-INFRINGEMENT. 
+ *
+ * See the Apache Version 2.0 License for specific language governing 
+ * permissions and limitations under the License.
+ *
+ * The generator is the Philox4x32-10 counter based generator described in
+ * "Parallel Random Numbers: As Easy as 1, 2, 3", J. K. Salmon, M. A. Moraes,
+ * R. O. Dror and D. E. Shaw, SC11 (2011).
+ *
+ * -----------------------------------------------------------------------------------
+ * 
+ * File: amp_philox_rng.h
+ * 
+ * Implements the 32b Philox counter based random number generator using C++ AMP
+ *------------------------------------------------------------------------------------ */
+
+#pragma once
+
+#include "amp_rand_collection.h"
+
+/// This is the class implementing the Philox4x32-10 engine. The engine holds no state
+/// apart from its key (the seed) and counter: the k-th number of stream s is the word
+/// k % 4 of the block philox(key, {k / 4, s}), so any number can be computed directly
+/// and an engine costs nothing to set up.
+class philox_rng
+{
+static const unsigned s_philox_m0           = 0xD2511F53U;
+static const unsigned s_philox_m1           = 0xCD9E8D57U;
+static const unsigned s_philox_w0           = 0x9E3779B9U;
+static const unsigned s_philox_w1           = 0xBB67AE85U;
+static const unsigned s_philox_rounds       = 10;
+static const unsigned s_philox_single_mask  = 0x3f800000U;
+
+private:
+    /// High and low words of the 64b product a * b. C++ AMP has no 64b integers, so the
+    /// high word is assembled from 16b halves.
+    static unsigned mulhilo(unsigned a, unsigned b, unsigned& hi) restrict(cpu, amp)
+    {
+        const unsigned a_lo = a & 0xffff, a_hi = a >> 16;
+        const unsigned b_lo = b & 0xffff, b_hi = b >> 16;
+
+        const unsigned lo_lo = a_lo * b_lo;
+        const unsigned hi_lo = a_hi * b_lo;
+        const unsigned lo_hi = a_lo * b_hi;
+        const unsigned mid = (lo_lo >> 16) + (hi_lo & 0xffff) + (lo_hi & 0xffff);
+
+        hi = a_hi * b_hi + (hi_lo >> 16) + (lo_hi >> 16) + (mid >> 16);
+        return a * b;
+    }
+
+    /// Computes the four words of block (counter0, counter1) of the stream
+    void block(unsigned counter0, unsigned counter1, unsigned out[4]) const restrict(cpu, amp)
+    {
+        unsigned c0 = counter0, c1 = counter1, c2 = stream, c3 = 0;
+        unsigned k0 = key[0], k1 = key[1];
+
+        for (unsigned r = 0; r < s_philox_rounds; r++)
+        {
+            unsigned hi0, hi1;
+            const unsigned lo0 = mulhilo(s_philox_m0, c0, hi0);
+            const unsigned lo1 = mulhilo(s_philox_m1, c2, hi1);
+
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+
+            k0 += s_philox_w0;
+            k1 += s_philox_w1;
+        }
+
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    unsigned key[2];
+    unsigned stream;
+    unsigned position[2];
+
+public:
+    /// Setup state: the engine generates stream number stream_id of the seed, starting
+    /// from its first number
+    void initialize(int seed = 0, unsigned stream_id = 0) restrict(cpu, amp)
+    {
+        key[0] = seed;
+        key[1] = 0;
+        stream = stream_id;
+        position[0] = 0;
+        position[1] = 0;
+    }
+
+    /// Moves the engine to the n-th number of its stream
+    void seek(unsigned n_lo, unsigned n_hi = 0) restrict(cpu, amp)
+    {
+        position[0] = n_lo;
+        position[1] = n_hi;
+    }
+
+    /// Skip ahead from current position
+    void skip(unsigned n) restrict(cpu, amp)
+    {
+        const unsigned old = position[0];
+        position[0] += n;
+        position[1] += (position[0] < old) ? 1 : 0;
+    }
+
+    /// Get the n-th unsigned random number of the stream, without moving the engine
+    unsigned get_uint(unsigned n_lo, unsigned n_hi = 0) const restrict(cpu, amp)
+    {
+        unsigned out[4];
+        block((n_lo >> 2) | (n_hi << 30), n_hi >> 2, out);
+        return out[n_lo & 3];
+    }
+
+    /// Get next unsigned random number
+    unsigned next_uint() restrict(cpu, amp)
+    {
+        const unsigned result = get_uint(position[0], position[1]);
+        skip(1);
+        return result;
+    }
+
+    /// Get next four unsigned random numbers, a whole block when the position is a
+    /// multiple of 4
+    void next_uint4(unsigned out[4]) restrict(cpu, amp)
+    {
+        if ((position[0] & 3) == 0)
+        {
+            block((position[0] >> 2) | (position[1] << 30), position[1] >> 2, out);
+            skip(4);
+        }
+        else
+        {
+            for (int i = 0; i < 4; i++)
+                out[i] = next_uint();
+        }
+    }
+
+    /// Get next floating point random number between 1.0 - 2.0
+    float next_single12() restrict(cpu, amp)
+    {
+        unsigned t0 = next_uint();
+        t0 = t0 >> 9;
+        t0 ^= s_philox_single_mask;
+        return *(reinterpret_cast<float*>(&t0));
+    }
+
+    /// Get next floating point random number
+    float next_single() restrict(cpu, amp)
+    {
+        return next_single12() - 1.0f;
+    }
+};
+
+
+/// This class makes the Philox engines available by index. Unlike the other collections
+/// it allocates no state: operator[] returns an engine for the stream numbered by the
+/// linear (row major) index, so the numbers depend only on the seed and the index and
+/// not on how the work is divided between threads.
+template<int _rank>
+class philox_collection
+{
+private:
+    concurrency::extent<_rank> m_extent;
+    int m_seed;
+
+public:
+    philox_collection(const concurrency::extent<_rank> rand_extent, int seed = 0)
+        : m_extent(rand_extent), m_seed(seed)
+    {
+    }
+
+    philox_rng operator[] (concurrency::index<_rank> idx) const restrict(cpu, amp)
+    {
+        unsigned stream_id = 0;
+        for (int i = 0; i < _rank; i++)
+        {
+            stream_id = stream_id * m_extent[i] + idx[i];
+        }
+
+        philox_rng rng;
+        rng.initialize(m_seed, stream_id);
+        return rng;
+    }
+};
@@ -0,0 +1,235 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corp. 
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not 
+ * use this file except in compliance with the License.  You may obtain a copy 
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0  
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY 
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED 
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE, 
+ * MERCHANTABLITY OR NON-INFRINGEMENT. 
+ *
+ * See the Apache Version 2.0 License for specific language governing 
+ * permissions and limitations under the License.
+ *
+ * The generator is the Philox4x32-10 counter based generator described in
+ * "Parallel Random Numbers: As Easy as 1, 2, 3", J. K. Salmon, M. A. Moraes,
+ * R. O. Dror and D. E. Shaw, SC11 (2011).
+ *
+ * -----------------------------------------------------------------------------------
+ * 
+ * File: amp_philox_rng_host.h
+ * 
+ * Implements the 32b Philox counter based random number generator on the host (CPU)
+ *------------------------------------------------------------------------------------ */
+
+#pragma once
+
+#include <cstddef>
+#include "amp_rand_host.h"
+
+/// Host (CPU) implementation of the Philox4x32-10 engine. It produces the numbers of the
+/// philox_rng class on the accelerator: engine (seed, stream) here generates the same
+/// stream as philox_rng::initialize(seed, stream). Bulk generation computes _lanes
+/// blocks at a time in code the compiler vectorizes.
+template<unsigned _lanes = 8>
+class philox_host_rng
+{
+    static_assert(_lanes > 0, "the number of lanes must be positive");
+
+    static const unsigned s_philox_m0           = 0xD2511F53U;
+    static const unsigned s_philox_m1           = 0xCD9E8D57U;
+    static const unsigned s_philox_w0           = 0x9E3779B9U;
+    static const unsigned s_philox_w1           = 0xBB67AE85U;
+    static const unsigned s_philox_rounds       = 10;
+
+    /// Computes _lanes consecutive blocks starting at block first
+    void blocks(unsigned long long first, unsigned out[4][_lanes]) const
+    {
+        unsigned c0[_lanes], c1[_lanes], c2[_lanes], c3[_lanes];
+
+        for (unsigned l = 0; l < _lanes; l++)
+        {
+            const unsigned long long counter = first + l;
+            c0[l] = static_cast<unsigned>(counter);
+            c1[l] = static_cast<unsigned>(counter >> 32);
+            c2[l] = static_cast<unsigned>(m_stream);
+            c3[l] = static_cast<unsigned>(m_stream >> 32);
+        }
+
+        unsigned k0 = m_key[0], k1 = m_key[1];
+
+        for (unsigned r = 0; r < s_philox_rounds; r++)
+        {
+            for (unsigned l = 0; l < _lanes; l++)
+            {
+                const unsigned long long p0 = static_cast<unsigned long long>(s_philox_m0) * c0[l];
+                const unsigned long long p1 = static_cast<unsigned long long>(s_philox_m1) * c2[l];
+
+                const unsigned next0 = static_cast<unsigned>(p1 >> 32) ^ c1[l] ^ k0;
+                const unsigned next2 = static_cast<unsigned>(p0 >> 32) ^ c3[l] ^ k1;
+
+                c1[l] = static_cast<unsigned>(p1);
+                c3[l] = static_cast<unsigned>(p0);
+                c0[l] = next0;
+                c2[l] = next2;
+            }
+
+            k0 += s_philox_w0;
+            k1 += s_philox_w1;
+        }
+
+        for (unsigned l = 0; l < _lanes; l++)
+        {
+            out[0][l] = c0[l];
+            out[1][l] = c1[l];
+            out[2][l] = c2[l];
+            out[3][l] = c3[l];
+        }
+    }
+
+    /// Writes numbers [first, first + n) of the stream to data, converted by convert
+    template<typename value_type, typename convert_type>
+    void fill(unsigned long long first, value_type* data, std::size_t n, convert_type convert) const
+    {
+        unsigned out[4][_lanes];
+
+        std::size_t i = 0;
+        while (i < n)
+        {
+            const unsigned long long position = first + i;
+            const unsigned offset = static_cast<unsigned>(position & 3);
+
+            blocks(position >> 2, out);
+
+            // the lane blocks hold 4 * _lanes consecutive numbers from position - offset
+            for (unsigned j = offset; j < 4 * _lanes && i < n; j++, i++)
+                data[i] = convert(out[j & 3][j >> 2]);
+        }
+    }
+
+    struct uint_convert
+    {
+        unsigned operator()(unsigned value) const { return value; }
+    };
+
+    struct single_convert
+    {
+        float operator()(unsigned value) const { return rand_host_lib::uint_to_single12(value) - 1.0f; }
+    };
+
+    unsigned m_key[2];
+    unsigned long long m_stream;
+    unsigned long long m_position;
+
+public:
+    philox_host_rng(unsigned long long key = 0, unsigned long long stream_id = 0)
+    {
+        initialize(key, stream_id);
+    }
+
+    /// Setup state. A seed of the accelerator engine is passed as its unsigned value.
+    void initialize(unsigned long long key = 0, unsigned long long stream_id = 0)
+    {
+        m_key[0] = static_cast<unsigned>(key);
+        m_key[1] = static_cast<unsigned>(key >> 32);
+        m_stream = stream_id;
+        m_position = 0;
+    }
+
+    /// Moves the engine to the n-th number of its stream
+    void seek(unsigned long long n)
+    {
+        m_position = n;
+    }
+
+    /// Skip ahead from current position
+    void skip(unsigned long long n)
+    {
+        m_position += n;
+    }
+
+    /// Current position in the stream
+    unsigned long long position() const
+    {
+        return m_position;
+    }
+
+    /// Get the n-th unsigned random number of the stream, without moving the engine
+    unsigned get_uint(unsigned long long n) const
+    {
+        unsigned value;
+        fill(n, &value, 1, uint_convert());
+        return value;
+    }
+
+    /// Get next unsigned random number
+    unsigned next_uint()
+    {
+        return get_uint(m_position++);
+    }
+
+    /// Get next floating point random number between 1.0 - 2.0
+    float next_single12()
+    {
+        return rand_host_lib::uint_to_single12(next_uint());
+    }
+
+    /// Get next floating point random number
+    float next_single()
+    {
+        return next_single12() - 1.0f;
+    }
+
+    /// Fills data with the next n unsigned random numbers
+    void generate(unsigned* data, std::size_t n)
+    {
+        fill(m_position, data, n, uint_convert());
+        m_position += n;
+    }
+
+    /// Fills data with the next n floating point random numbers
+    void generate(float* data, std::size_t n)
+    {
+        fill(m_position, data, n, single_convert());
+        m_position += n;
+    }
+
+    /// Fills data with the next n normally distributed numbers. The numbers at positions
+    /// 2j and 2j + 1 are the Box-Muller pair of the uniform numbers at the same
+    /// positions, so each one depends only on its position and a stream can be split
+    /// between workers at any point.
+    void generate_normal(float* data, std::size_t n, float mean = 0.0f, float stddev = 1.0f)
+    {
+        const std::size_t chunk = 512;
+        float uniform[chunk];
+
+        std::size_t i = 0;
+        while (i < n)
+        {
+            // uniform numbers from the even position at or before the next output
+            const unsigned long long first = m_position & ~1ULL;
+            const std::size_t count = (n - i + static_cast<std::size_t>(m_position - first) + 1) & ~static_cast<std::size_t>(1);
+            const std::size_t length = (count < chunk) ? count : chunk;
+
+            fill(first, uniform, length, single_convert());
+
+            for (std::size_t j = 0; j < length && i < n; j += 2)
+            {
+                float z0, z1;
+                rand_host_lib::box_muller(1.0f - uniform[j], uniform[j + 1], z0, z1);
+
+                if (first + j == m_position)
+                {
+                    data[i++] = mean + stddev * z0;
+                    m_position++;
+                }
+                if (i < n)
+                {
+                    data[i++] = mean + stddev * z1;
+                    m_position++;
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,85 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corp.
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *
+ *------------------------------------------------------------------------------------
+ *
+ * File: amp_rand_host.h
+ *
+ * Conversions shared by the host (CPU) implementations of the RNG engines
+ *------------------------------------------------------------------------------------ */
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+namespace rand_host_lib
+{
+    /// Floating point number between 1.0 - 2.0 from the top 23 bits, computed the same
+    /// way as on the accelerator
+    inline float uint_to_single12(unsigned value)
+    {
+        value = (value >> 9) ^ 0x3f800000U;
+
+        float result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    /// Two independent standard normal numbers from u1 in (0, 1] and u2 in [0, 1)
+    /// (Box-Muller transform)
+    inline void box_muller(float u1, float u2, float& z0, float& z1)
+    {
+        const float two_pi = 6.28318530717958647692f;
+        const float radius = std::sqrt(-2.0f * std::log(u1));
+
+        z0 = radius * std::cos(two_pi * u2);
+        z1 = radius * std::sin(two_pi * u2);
+    }
+
+    /// Inverse of the standard normal distribution function for p in (0, 1)
+    /// (Acklam's rational approximation, relative error below 1.2e-9)
+    inline double normal_quantile(double p)
+    {
+        static const double a[] = { -3.969683028665376e+01,  2.209460984245205e+02, -2.759285104469687e+02,
+                                     1.383577518672690e+02, -3.066479806614716e+01,  2.506628277459239e+00 };
+        static const double b[] = { -5.447609879822406e+01,  1.615858368580409e+02, -1.556989798598866e+02,
+                                     6.680131188771972e+01, -1.328068155288572e+01 };
+        static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                    -2.549732539343734e+00,  4.374664141464968e+00,  2.938163982698783e+00 };
+        static const double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,  2.445134137142996e+00,
+                                     3.754408661907416e+00 };
+
+        const double p_low = 0.02425;
+
+        if (p < p_low)
+        {
+            const double q = std::sqrt(-2.0 * std::log(p));
+            return (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+                   ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+        }
+
+        if (p > 1.0 - p_low)
+        {
+            const double q = std::sqrt(-2.0 * std::log(1.0 - p));
+            return -(((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+                    ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+        }
+
+        const double q = p - 0.5;
+        const double r = q * q;
+        return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5]) * q /
+               (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.0);
+    }
+}
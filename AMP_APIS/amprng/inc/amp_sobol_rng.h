@@ -119,7 +119,12 @@ public:
         // Compute gray code from position
         unsigned gray_code = state.position ^ (state.position>>1);
         
-        // Compute new state 
+        // Compute new state from the start of the sequence
+        for (int i=0; i<sobol_dimension; i++)
+        {
+            state.sobol_num[i] = 0;
+        }
+
         for (int j=0; j<sobol_rng_lib::rng_bits; ++j)
         {
             if (gray_code & (1<<j))
@@ -135,10 +140,8 @@ public:
     /// Get to the next state
     void next(const direction_num_view &direction_nums) restrict(cpu, amp)
     {
-        // Update position. Overflow is handled as position wrapped to zero. 
-        state.position++;
-
-        // Find the rightmost zero digit
+        // Find the rightmost zero digit, where the gray codes of position and 
+        // position + 1 differ
         unsigned j = 0;
         unsigned p = state.position;
         while (p & 1) 
@@ -147,10 +150,23 @@ public:
             j++;
         }
 
+        // Update position. Overflow is handled as position wrapped to zero. 
+        state.position++;
+
         // Compute new state 
-        for (int i=0; i<sobol_dimension; ++i)
+        if (j < sobol_rng_lib::rng_bits)
         {
-            state.sobol_num[i] ^= direction_nums(i,j);
+            for (int i=0; i<sobol_dimension; ++i)
+            {
+                state.sobol_num[i] ^= direction_nums(i,j);
+            }
+        }
+        else
+        {
+            for (int i=0; i<sobol_dimension; ++i)
+            {
+                state.sobol_num[i] = 0;
+            }
         }
     }
 
@@ -0,0 +1,228 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corp. 
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not 
+ * use this file except in compliance with the License.  You may obtain a copy 
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0  
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY 
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED 
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE, 
+ * MERCHANTABLITY OR NON-INFRINGEMENT. 
+ *
+ * See the Apache Version 2.0 License for specific language governing 
+ * permissions and limitations under the License.
+ *  
+ * The data set of direction numbers for Sobol sequences is based the project 
+ * on or incorporating material from the following project(s):
+ * Sobol sequence generator, available at http://web.maths.unsw.edu.au/~fkuo/sobol/index.html
+ * 
+ * Specifically it is based on the file "new-joe-kuo-6.21201" containing the direction 
+ * numbers obtained using the search criterion D(6) up to dimension 21201.
+ *
+ * Copyright (c) 2008, Frances Y. Kuo and Stephen Joe
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *  * Neither the names of the copyright holders nor the names of the
+ *    University of New South Wales and the University of Waikato
+ *    and its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * -----------------------------------------------------------------------------------
+ * 
+ * File: amp_sobol_rng_host.h
+ * 
+ * Implements the 32b Sobol quasi random number generator on the host (CPU)
+ *------------------------------------------------------------------------------------ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "amp_rand_host.h"
+#include "xxamp_sobol_rng.h"
+
+/// Host (CPU) implementation of the Sobol sequence engine. The point at each position
+/// is exactly the point the sobol_rng class produces on the accelerator.
+template<unsigned sobol_dimension>
+class sobol_rng_host
+{
+    static_assert(sobol_dimension >= 1 && 
+                  sobol_dimension <= sobol_rng_lib::dimension_limit, 
+                  "the specified sobol RNG dimension is not supported");
+
+public:
+    sobol_rng_host(unsigned skipahead = 0)
+        : direction_nums(sobol_rng_lib::rng_bits * sobol_dimension), sobol_num(sobol_dimension)
+    {
+        // direction numbers are stored bit major so that one update touches
+        // consecutive memory for all the dimensions
+        for (unsigned j = 0; j < sobol_rng_lib::rng_bits; j++)
+        {
+            for (unsigned i = 0; i < sobol_dimension; i++)
+            {
+                direction_nums[j * sobol_dimension + i] = sobol_rng_lib::direction_nums[i * sobol_rng_lib::rng_bits + j];
+            }
+        }
+
+        initialize(skipahead);
+    }
+
+    /// Setup state
+    void initialize(unsigned skipahead = 0)
+    {
+        position = 0;
+        skip(skipahead);
+    }
+
+    /// Skip ahead from current position
+    void skip(unsigned n)
+    {
+        // Update position. Overflow is handled as position wrapped to zero. 
+        position += n;
+
+        // Compute gray code from position
+        const unsigned gray_code = position ^ (position >> 1);
+
+        for (unsigned i = 0; i < sobol_dimension; i++)
+        {
+            sobol_num[i] = 0;
+        }
+
+        for (unsigned j = 0; j < sobol_rng_lib::rng_bits; j++)
+        {
+            if (gray_code & (1u << j))
+            {
+                xor_direction(j);
+            }
+        }
+    }
+
+    /// Current position in the sequence
+    unsigned get_position() const
+    {
+        return position;
+    }
+
+    /// Get to the next state
+    void next()
+    {
+        // The gray code of position + 1 differs in the rightmost zero digit of position
+        unsigned j = 0;
+        unsigned p = position;
+        while (p & 1) 
+        {
+            p >>= 1;
+            j++;
+        }
+
+        // Update position. Overflow is handled as position wrapped to zero. 
+        position++;
+
+        if (j < sobol_rng_lib::rng_bits)
+        {
+            xor_direction(j);
+        }
+        else
+        {
+            skip(0);
+        }
+    }
+
+    /// Get the unsigned sobol number at specified dimension
+    unsigned get_uint(unsigned dim) const
+    {
+        return sobol_num[dim-1];
+    }
+
+    /// Get the floating point sobol number between [0, 1) at specified dimension
+    float get_single(unsigned dim) const
+    {
+        // Trick to avoid overflow of (1<<32)
+        const float scale_factor = 0.5f/(unsigned)(1<<(sobol_rng_lib::rng_bits-1)); 
+
+        return static_cast<float>(get_uint(dim))* scale_factor;
+    }
+
+    /// Get the floating point random number between [1, 2) at specified dimension
+    float get_single12(unsigned dim) const
+    {
+        return get_single(dim) + 1.0f;
+    }
+
+    /// Fills data with n points starting at the current position and advances past
+    /// them; data[i * sobol_dimension + d] is dimension d + 1 of point i
+    void generate(unsigned* data, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++, next())
+        {
+            for (unsigned d = 0; d < sobol_dimension; d++)
+                data[i * sobol_dimension + d] = sobol_num[d];
+        }
+    }
+
+    /// Fills data with n points of floating point numbers between [0, 1), laid out as
+    /// in generate(unsigned*, n)
+    void generate(float* data, std::size_t n)
+    {
+        const float scale_factor = 0.5f/(unsigned)(1<<(sobol_rng_lib::rng_bits-1)); 
+
+        for (std::size_t i = 0; i < n; i++, next())
+        {
+            for (unsigned d = 0; d < sobol_dimension; d++)
+                data[i * sobol_dimension + d] = static_cast<float>(sobol_num[d]) * scale_factor;
+        }
+    }
+
+    /// Fills data with n points of normally distributed numbers, laid out as in
+    /// generate(unsigned*, n). Each coordinate is mapped through the inverse normal
+    /// distribution function, which keeps the low discrepancy of the points (Box-Muller
+    /// would pair up and mix the dimensions).
+    void generate_normal(float* data, std::size_t n, float mean = 0.0f, float stddev = 1.0f)
+    {
+        const double scale_factor = 1.0 / 4294967296.0;
+
+        for (std::size_t i = 0; i < n; i++, next())
+        {
+            for (unsigned d = 0; d < sobol_dimension; d++)
+            {
+                const double p = (static_cast<double>(sobol_num[d]) + 0.5) * scale_factor;
+                data[i * sobol_dimension + d] = mean + stddev * static_cast<float>(rand_host_lib::normal_quantile(p));
+            }
+        }
+    }
+
+private:
+    void xor_direction(unsigned j)
+    {
+        const unsigned* v = &direction_nums[j * sobol_dimension];
+        for (unsigned i = 0; i < sobol_dimension; i++)
+        {
+            sobol_num[i] ^= v[i];
+        }
+    }
+
+    std::vector<unsigned> direction_nums;
+    std::vector<unsigned> sobol_num;
+    unsigned position;
+};
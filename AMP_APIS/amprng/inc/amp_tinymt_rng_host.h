@@ -0,0 +1,625 @@
+/*----------------------------------------------------------------------------
+ * Copyright (c) Microsoft Corp. 
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not 
+ * use this file except in compliance with the License.  You may obtain a copy 
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0  
+ *
+ * THIS CODE IS PROVIDED *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY 
+ * KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY IMPLIED 
+ * WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE, 
+ * MERCHANTABLITY OR NON-INFRINGEMENT. 
+ *
+ * See the Apache Version 2.0 License for specific language governing 
+ * permissions and limitations under the License.
+ *  
+ * Based on or incorporating material from the following project(s):
+ * TINY MT project, available at http://www.math.sci.hiroshima-u.ac.jp/~m-mat/MT/TINYMT/index.html.
+ * @file tinymt32.h
+ * 
+ *  @brief Tiny Mersenne Twister only 127 bit internal state
+ * 
+ *  @author Mutsuo Saito (Hiroshima University)
+ *  @author Makoto Matsumoto (University of Tokyo)
+ * 
+ *  Copyright (C) 2011 Mutsuo Saito, Makoto Matsumoto,
+ *  Hiroshima University and The University of Tokyo.
+ *  All rights reserved.
+ * 
+ * 
+ * For Informational Purposes:
+ * 
+ * Copyright (c) 2011 Mutsuo Saito, Makoto Matsumoto, Hiroshima
+ * University and The University of Tokyo. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of the Hiroshima University nor the names of
+ *       its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * -----------------------------------------------------------------------------------
+ * 
+ * File: amp_tinymt_rng_host.h
+ * 
+ * Implements the tiny Mersenne twister engines on the host (CPU) with jump ahead
+ *------------------------------------------------------------------------------------ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "amp_rand_host.h"
+#include "xxamp_tinymt_precalc_dc.h"
+
+namespace tinymt_lib
+{
+    /// Polynomial over GF(2) of degree up to 127, bit i is the coefficient of x^i
+    struct tinymt_poly
+    {
+        unsigned long long lo;
+        unsigned long long hi;
+
+        bool bit(unsigned i) const
+        {
+            return (i < 64 ? (lo >> i) : (hi >> (i - 64))) & 1;
+        }
+
+        void flip(unsigned i)
+        {
+            if (i < 64)
+                lo ^= 1ULL << i;
+            else
+                hi ^= 1ULL << (i - 64);
+        }
+    };
+
+    /// x * a mod p, where p has degree p_degree and a has a lower degree
+    inline tinymt_poly tinymt_poly_mul_x(tinymt_poly a, const tinymt_poly& p, unsigned p_degree)
+    {
+        a.hi = (a.hi << 1) | (a.lo >> 63);
+        a.lo <<= 1;
+        if (a.bit(p_degree))
+        {
+            a.lo ^= p.lo;
+            a.hi ^= p.hi;
+        }
+        return a;
+    }
+
+    /// a * b mod p
+    inline tinymt_poly tinymt_poly_mul_mod(const tinymt_poly& a, const tinymt_poly& b, const tinymt_poly& p, unsigned p_degree)
+    {
+        tinymt_poly r = { 0, 0 };
+        for (int i = p_degree - 1; i >= 0; i--)
+        {
+            r = tinymt_poly_mul_x(r, p, p_degree);
+            if (b.bit(i))
+            {
+                r.lo ^= a.lo;
+                r.hi ^= a.hi;
+            }
+        }
+        return r;
+    }
+
+    /// a * b, where the degrees add up to at most 127
+    inline tinymt_poly tinymt_poly_mul(const tinymt_poly& a, const tinymt_poly& b)
+    {
+        tinymt_poly r = { 0, 0 };
+        for (unsigned i = 0; i < 128; i++)
+        {
+            if (b.bit(i))
+            {
+                r.lo ^= (i < 64) ? (a.lo << i) : 0;
+                r.hi ^= (i < 64) ? ((a.hi << i) | (i ? a.lo >> (64 - i) : 0)) : (a.lo << (i - 64));
+            }
+        }
+        return r;
+    }
+
+    /// x^n mod p
+    inline tinymt_poly tinymt_poly_x_pow_mod(unsigned long long n, const tinymt_poly& p, unsigned p_degree)
+    {
+        tinymt_poly r = { 1, 0 };
+        for (int i = 63; i >= 0; i--)
+        {
+            r = tinymt_poly_mul_mod(r, r, p, p_degree);
+            if ((n >> i) & 1)
+                r = tinymt_poly_mul_x(r, p, p_degree);
+        }
+        return r;
+    }
+}
+
+/// Host (CPU) implementation of the tinyMT engine. Given the same parameter set and
+/// seed it produces exactly the numbers of the tinymt class on the accelerator
+class tinymt_host
+{
+    static const unsigned s_tinymt_shift0       = 11;
+    static const unsigned s_tinymt_shift1       = 10;
+    static const unsigned s_tinymt_min_loop     = 8;
+    static const unsigned s_tinymt_pre_loop     = 8;
+    static const unsigned s_tinymt_mask         = 0x7fffffffU;
+    static const unsigned s_tinymt_max_degree   = 127;
+
+    template<unsigned _lanes> friend class tinymt_host_collection;
+
+private:
+    void next()
+    {
+        unsigned y = status.status[3];
+        unsigned x = (status.status[0] & s_tinymt_mask) ^ status.status[1] ^ status.status[2];
+
+        x ^= (x << s_tinymt_shift0);
+        y ^= (y >> s_tinymt_shift0) ^ x;
+
+        status.status[0] = status.status[1];
+        status.status[1] = status.status[2];
+        status.status[2] = x ^ (y << s_tinymt_shift1);
+        status.status[3] = y;
+
+        if (y & 1)
+        {
+            status.status[1] ^= status.state.mat1;
+            status.status[2] ^= status.state.mat2;
+        }
+    }
+
+    unsigned temper() const
+    {
+        unsigned t0, t1;
+        t0 = status.status[3];
+        t1 = status.status[0] + (status.status[2] >> 8);
+        t0 ^= t1;
+        if (t1 & 1)
+        {
+            t0 ^= status.state.tmat;
+        }
+        return t0;
+    }
+
+    /// Replaces the state s with p(T) s, where T is the (linear) state transition and
+    /// p has degree top (Horner)
+    void evaluate(const tinymt_lib::tinymt_poly& p, int top)
+    {
+        const tinymt_lib::tinymt_status_t start = status;
+        for (unsigned k = 0; k < 4; k++)
+            status.status[k] = 0;
+
+        for (int i = top; i >= 0; i--)
+        {
+            next();
+            if (p.bit(i))
+            {
+                for (unsigned k = 0; k < 4; k++)
+                    status.status[k] ^= start.status[k];
+            }
+        }
+    }
+
+    /// Minimal polynomial of one bit of the states from the current one (Berlekamp-Massey)
+    void bit_polynomial(unsigned word, unsigned shift, tinymt_lib::tinymt_poly& poly, unsigned& degree) const
+    {
+        const unsigned samples = 2 * s_tinymt_max_degree + 2;
+
+        unsigned char sequence[samples];
+        tinymt_host copy(*this);
+        for (unsigned i = 0; i < samples; i++)
+        {
+            sequence[i] = (copy.status.status[word] >> shift) & 1;
+            copy.next();
+        }
+
+        unsigned char c[samples + 1] = { 1 };
+        unsigned char b[samples + 1] = { 1 };
+        unsigned char t[samples + 1];
+        unsigned length = 0;
+        unsigned m = 1;
+
+        for (unsigned n = 0; n < samples; n++)
+        {
+            unsigned char d = sequence[n];
+            for (unsigned i = 1; i <= length; i++)
+                d ^= c[i] & sequence[n - i];
+
+            if (d == 0)
+            {
+                m++;
+            }
+            else if (2 * length <= n)
+            {
+                std::copy(c, c + samples + 1, t);
+                for (unsigned i = 0; i + m <= samples; i++)
+                    c[i + m] ^= b[i];
+                length = n + 1 - length;
+                std::copy(t, t + samples + 1, b);
+                m = 1;
+            }
+            else
+            {
+                for (unsigned i = 0; i + m <= samples; i++)
+                    c[i + m] ^= b[i];
+                m++;
+            }
+        }
+
+        // the minimal polynomial is the reciprocal of the connection polynomial
+        tinymt_lib::tinymt_poly p = { 0, 0 };
+        for (unsigned i = 0; i <= length; i++)
+        {
+            if (c[i])
+                p.flip(length - i);
+        }
+
+        poly = p;
+        degree = length;
+    }
+
+    /// Minimal polynomial of the transition on the states reachable from the current one.
+    /// With this engine's shifts the transition polynomial need not be irreducible, so a
+    /// single output bit may miss factors; the factors left over are found from the bits
+    /// of the state with the known factors removed.
+    void minimal_polynomial(tinymt_lib::tinymt_poly& poly, unsigned& degree) const
+    {
+        tinymt_lib::tinymt_poly p = { 1, 0 };
+        unsigned p_degree = 0;
+
+        for (;;)
+        {
+            tinymt_host residual(*this);
+            residual.evaluate(p, p_degree);
+
+            unsigned word = 0;
+            while (word < 4 && residual.status.status[word] == 0)
+                word++;
+            if (word == 4)
+                break;
+
+            unsigned shift = 0;
+            while (((residual.status.status[word] >> shift) & 1) == 0)
+                shift++;
+
+            tinymt_lib::tinymt_poly q;
+            unsigned q_degree;
+            residual.bit_polynomial(word, shift, q, q_degree);
+            if (q_degree == 0)
+                break;
+
+            p = tinymt_lib::tinymt_poly_mul(p, q);
+            p_degree += q_degree;
+        }
+
+        poly = p;
+        degree = p_degree;
+    }
+
+    tinymt_lib::tinymt_status_t  status;
+
+public:
+    tinymt_host()
+    {
+        tinymt_lib::tinymt_status_t init = {0};
+        status = init;
+    }
+
+    tinymt_host(const tinymt_lib::tinymt_status_t& init, int seed = 0)
+    {
+        initialize(init, seed);
+    }
+
+    /// Setup state
+    void initialize(const tinymt_lib::tinymt_status_t& init, int seed = 0)
+    {
+        status = init;
+        initialize(seed);
+    }
+
+    /// Setup state
+    void initialize(int seed = 0)
+    {
+        status.status[0] = seed;
+        status.status[1] = status.state.mat1;
+        status.status[2] = status.state.mat2;
+        status.status[3] = status.state.tmat;
+        for (unsigned i = 1; i < s_tinymt_min_loop; i++)
+        {
+            status.status[i & 3] =  (status.status[i & 3] ^ i) + (1812433253U * (status.status[(i - 1) & 3] ^ (status.status[(i - 1) & 3] >> 30)));
+        }
+        if ((status.status[0] & s_tinymt_mask) == 0 &&
+            status.status[1] == 0 && status.status[2] == 0 && status.status[3] == 0)
+        {
+            status.status[0] = 'T';
+            status.status[1] = 'I';
+            status.status[2] = 'N';
+            status.status[3] = 'Y';
+        }
+        for (unsigned i = 0; i < s_tinymt_pre_loop; i++)
+        {
+            next();
+        }
+    }
+
+    /// Advances the engine by n numbers in O(log n) using x^n modulo the minimal
+    /// polynomial of the state transition. Workers sharing one stream jump to disjoint
+    /// offsets of it.
+    void jump(unsigned long long n)
+    {
+        if (n <= 2 * s_tinymt_max_degree)
+        {
+            for (unsigned long long i = 0; i < n; i++)
+                next();
+            return;
+        }
+
+        tinymt_lib::tinymt_poly poly;
+        unsigned degree;
+        minimal_polynomial(poly, degree);
+        if (degree == 0)
+            return;
+
+        // the state after n steps is x^n mod the minimal polynomial evaluated at the
+        // transition, applied to the current state
+        evaluate(tinymt_lib::tinymt_poly_x_pow_mod(n, poly, degree), degree - 1);
+    }
+
+    /// Get next unsigned random number
+    unsigned next_uint()
+    {
+        next();
+        return temper();
+    }
+
+    /// Get next floating point random number between 1.0 - 2.0
+    float next_single12()
+    {
+        next();
+        return rand_host_lib::uint_to_single12(temper());
+    }
+
+    /// Get next floating point random number
+    float next_single()
+    {
+        return next_single12() - 1.0f;
+    }
+
+    /// Fills data with the next n unsigned random numbers
+    void generate(unsigned* data, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+            data[i] = next_uint();
+    }
+
+    /// Fills data with the next n floating point random numbers
+    void generate(float* data, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+            data[i] = next_single();
+    }
+
+    /// Fills data with n normally distributed numbers. Every pair of outputs consumes two
+    /// numbers of the stream; an odd n consumes one more and discards its second output.
+    void generate_normal(float* data, std::size_t n, float mean = 0.0f, float stddev = 1.0f)
+    {
+        for (std::size_t i = 0; i < n; i += 2)
+        {
+            const float u1 = 1.0f - next_single();
+            const float u2 = next_single();
+
+            float z0, z1;
+            rand_host_lib::box_muller(u1, u2, z0, z1);
+
+            data[i] = mean + stddev * z0;
+            if (i + 1 < n)
+                data[i + 1] = mean + stddev * z1;
+        }
+    }
+};
+
+
+/// Host counterpart of tinymt_collection. Engine i uses the same parameter set and seed
+/// as element i (in row major order) of a tinymt_collection, so the host reproduces the
+/// accelerator results bit for bit. The engines are stored _lanes at a time in structure
+/// of arrays form and advanced together with branch free code the compiler vectorizes
+/// (8 lanes fill an AVX register, 16 an AVX-512 register).
+template<unsigned _lanes = 8>
+class tinymt_host_collection
+{
+    static_assert(_lanes > 0, "the number of lanes must be positive");
+
+    static const unsigned s_tinymt_shift0       = 11;
+    static const unsigned s_tinymt_shift1       = 10;
+    static const unsigned s_tinymt_mask         = 0x7fffffffU;
+
+    struct lane_group
+    {
+        unsigned status0[_lanes];
+        unsigned status1[_lanes];
+        unsigned status2[_lanes];
+        unsigned status3[_lanes];
+        unsigned mat1[_lanes];
+        unsigned mat2[_lanes];
+        unsigned tmat[_lanes];
+    };
+
+    std::vector<lane_group> m_groups;
+    std::size_t m_size;
+
+    static void next(lane_group& g, unsigned* out)
+    {
+        for (unsigned l = 0; l < _lanes; l++)
+        {
+            unsigned y = g.status3[l];
+            unsigned x = (g.status0[l] & s_tinymt_mask) ^ g.status1[l] ^ g.status2[l];
+
+            x ^= (x << s_tinymt_shift0);
+            y ^= (y >> s_tinymt_shift0) ^ x;
+
+            const unsigned mask = 0u - (y & 1);
+
+            g.status0[l] = g.status1[l];
+            g.status1[l] = g.status2[l] ^ (g.mat1[l] & mask);
+            g.status2[l] = x ^ (y << s_tinymt_shift1) ^ (g.mat2[l] & mask);
+            g.status3[l] = y;
+
+            // temper
+            unsigned t0 = g.status3[l];
+            const unsigned t1 = g.status0[l] + (g.status2[l] >> 8);
+            t0 ^= t1;
+            out[l] = t0 ^ (g.tmat[l] & (0u - (t1 & 1)));
+        }
+    }
+
+    void load(std::size_t i, const tinymt_host& engine)
+    {
+        lane_group& g = m_groups[i / _lanes];
+        const unsigned l = i % _lanes;
+
+        g.status0[l] = engine.status.status[0];
+        g.status1[l] = engine.status.status[1];
+        g.status2[l] = engine.status.status[2];
+        g.status3[l] = engine.status.status[3];
+        g.mat1[l] = engine.status.state.mat1;
+        g.mat2[l] = engine.status.state.mat2;
+        g.tmat[l] = engine.status.state.tmat;
+    }
+
+    template<typename value_type, typename convert_type>
+    void generate(value_type* data, std::size_t steps, convert_type convert)
+    {
+        unsigned out[_lanes];
+
+        for (std::size_t k = 0; k < steps; k++)
+        {
+            value_type* row = data + k * m_size;
+
+            for (std::size_t g = 0; g < m_groups.size(); g++)
+            {
+                next(m_groups[g], out);
+
+                const std::size_t first = g * _lanes;
+                const std::size_t count = (m_size - first < _lanes) ? m_size - first : _lanes;
+                for (std::size_t l = 0; l < count; l++)
+                    row[first + l] = convert(out[l]);
+            }
+        }
+    }
+
+    struct uint_convert
+    {
+        unsigned operator()(unsigned value) const { return value; }
+    };
+
+    struct single_convert
+    {
+        float operator()(unsigned value) const { return rand_host_lib::uint_to_single12(value) - 1.0f; }
+    };
+
+public:
+    tinymt_host_collection(std::size_t size, int seed = 0)
+        : m_groups((size + _lanes - 1) / _lanes), m_size(size)
+    {
+        if (tinymt_lib::max_dc_count < size)
+            throw "Default MT DC state is less than the specified number";
+
+        for (std::size_t i = 0; i < m_groups.size() * _lanes; i++)
+        {
+            // padding lanes repeat the last engine and are never written out
+            tinymt_lib::tinymt_status_t init = {0};
+            init.state = tinymt_lib::tinymt_dc_data[i < size ? i : size - 1].state;
+            load(i, tinymt_host(init, seed));
+        }
+    }
+
+    /// Number of engines
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    /// Copy of engine i at its current position
+    tinymt_host engine(std::size_t i) const
+    {
+        const lane_group& g = m_groups[i / _lanes];
+        const unsigned l = i % _lanes;
+
+        tinymt_host result;
+        result.status.status[0] = g.status0[l];
+        result.status.status[1] = g.status1[l];
+        result.status.status[2] = g.status2[l];
+        result.status.status[3] = g.status3[l];
+        result.status.state.mat1 = g.mat1[l];
+        result.status.state.mat2 = g.mat2[l];
+        result.status.state.tmat = g.tmat[l];
+        return result;
+    }
+
+    /// Advances every engine by n numbers
+    void jump(unsigned long long n)
+    {
+        for (std::size_t i = 0; i < m_groups.size() * _lanes; i++)
+        {
+            tinymt_host e = engine(i);
+            e.jump(n);
+            load(i, e);
+        }
+    }
+
+    /// Fills data with steps numbers from every engine; data[k * size() + i] is the k-th
+    /// number of engine i
+    void generate(unsigned* data, std::size_t steps)
+    {
+        generate(data, steps, uint_convert());
+    }
+
+    /// Fills data with steps floating point numbers between 0.0 - 1.0 from every engine,
+    /// laid out as in generate(unsigned*, steps)
+    void generate(float* data, std::size_t steps)
+    {
+        generate(data, steps, single_convert());
+    }
+
+    /// Fills data with steps normally distributed numbers from every engine, laid out as
+    /// in generate(unsigned*, steps). Engine i produces the same numbers as
+    /// engine(i).generate_normal.
+    void generate_normal(float* data, std::size_t steps, float mean = 0.0f, float stddev = 1.0f)
+    {
+        std::vector<float> uniform(2 * m_size);
+
+        for (std::size_t k = 0; k < steps; k += 2)
+        {
+            generate(&uniform[0], 2);
+
+            for (std::size_t i = 0; i < m_size; i++)
+            {
+                float z0, z1;
+                rand_host_lib::box_muller(1.0f - uniform[i], uniform[m_size + i], z0, z1);
+
+                data[k * m_size + i] = mean + stddev * z0;
+                if (k + 1 < steps)
+                    data[(k + 1) * m_size + i] = mean + stddev * z1;
+            }
+        }
+    }
+};
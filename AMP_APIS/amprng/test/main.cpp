@@ -23,6 +23,10 @@
 #include <iostream>
 #include "amp_tinymt_rng.h"
 #include "amp_sobol_rng.h"
+#include "amp_philox_rng.h"
+#include "amp_tinymt_rng_host.h"
+#include "amp_sobol_rng_host.h"
+#include "amp_philox_rng_host.h"
 
 using namespace concurrency;
 
@@ -233,6 +237,100 @@ void sobol_rng_test()
     fclose(ofile);
 }
 
+void host_test()
+{
+    std::cout << "Host     Usage  : comparing the host engines with the accelerator" << std::endl;
+
+    // tinyMT: 4 numbers from each of 1000 engines
+    const int seed = 5489;
+    const int steps = 4;
+    extent<1> e_size(1000);
+    tinymt_collection<1> myrand(e_size, seed);
+    array<float, 2> rand_out_data(steps, e_size[0]);
+
+    parallel_for_each(e_size, [=, &rand_out_data] (index<1> idx) restrict(amp)
+    {
+        auto t = myrand[idx];
+
+        for (int k = 0; k < steps; k++)
+            rand_out_data(k, idx[0]) = t.next_single();
+    });
+
+    std::vector<float> ref_data(rand_out_data.extent.size());
+    copy(rand_out_data, ref_data.begin());
+
+    tinymt_host_collection<> host_rand(e_size[0], seed);
+    std::vector<float> host_data(ref_data.size());
+    host_rand.generate(&host_data[0], steps);
+
+    unsigned mismatches = 0;
+    for (unsigned i = 0; i < ref_data.size(); i++)
+        mismatches += (ref_data[i] != host_data[i]);
+
+    // the second half of a stream, taken by another worker after a jump
+    tinymt_host first = host_rand.engine(0);
+    first.jump(1000000 - steps);
+    tinymt_host second = tinymt_host_collection<>(1, seed).engine(0);
+    second.jump(1000000);
+    mismatches += (first.next_uint() != second.next_uint());
+
+    // Sobol: 1000 2-dimension points from position 5489
+    static const unsigned dimensions = 2;
+    const unsigned skipahead = 5489;
+    extent<1> s_size(1000);
+    sobol_rng_collection<sobol_rng<dimensions>, 1> sc_rng(s_size, skipahead);
+
+    typedef sobol_rng<dimensions>::sobol_number<unsigned> sobol_uint_number;
+    array<sobol_uint_number, 1> sobol_out_data(s_size);
+
+    parallel_for_each(s_size, [=, &sobol_out_data] (index<1> idx) restrict(amp)
+    {
+        auto rng = sc_rng[idx];
+        rng.skip(sc_rng.direction_numbers(), idx[0]);
+
+        for (int i=1; i<=dimensions; i++)
+            sobol_out_data[idx][i-1] = rng.get_uint(i);
+    });
+
+    std::vector<sobol_uint_number> sobol_ref_data(s_size.size());
+    copy(sobol_out_data, sobol_ref_data.begin());
+
+    sobol_rng_host<dimensions> host_sobol(skipahead);
+    std::vector<unsigned> sobol_host_data(s_size.size() * dimensions);
+    host_sobol.generate(&sobol_host_data[0], s_size.size());
+
+    for (unsigned i = 0; i < sobol_ref_data.size(); i++)
+        for (unsigned j = 0; j < dimensions; j++)
+            mismatches += (sobol_ref_data[i][j] != sobol_host_data[i * dimensions + j]);
+
+    // Philox: 4 numbers from each of 1000 streams, without any state array
+    philox_collection<1> philox_rand(e_size, seed);
+    array<unsigned, 2> philox_out_data(steps, e_size[0]);
+
+    parallel_for_each(e_size, [=, &philox_out_data] (index<1> idx) restrict(amp)
+    {
+        auto t = philox_rand[idx];
+
+        for (int k = 0; k < steps; k++)
+            philox_out_data(k, idx[0]) = t.next_uint();
+    });
+
+    std::vector<unsigned> philox_ref_data(philox_out_data.extent.size());
+    copy(philox_out_data, philox_ref_data.begin());
+
+    for (int i = 0; i < e_size[0]; i++)
+    {
+        unsigned philox_host_data[steps];
+        philox_host_rng<> host_philox(seed, i);
+        host_philox.generate(philox_host_data, steps);
+
+        for (int k = 0; k < steps; k++)
+            mismatches += (philox_ref_data[k * e_size[0] + i] != philox_host_data[k]);
+    }
+
+    std::cout << "         " << mismatches << " mismatches" << std::endl;
+}
+
 int main()
 {
     accelerator default_device;
@@ -242,6 +340,7 @@ int main()
 
     tinymt_test();
     sobol_rng_test();
+    host_test();
 
     return 0;
 }
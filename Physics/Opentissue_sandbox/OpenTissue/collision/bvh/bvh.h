@@ -10,13 +10,19 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/collision/bvh/bvh_bounding_volume_hierarchy.h>
+#include <OpenTissue/collision/bvh/bvh_flat_bounding_volume_hierarchy.h>
 
 #include <OpenTissue/collision/bvh/bvh_self_collision_query.h>
 #include <OpenTissue/collision/bvh/bvh_world_collision_query.h>
 #include <OpenTissue/collision/bvh/bvh_model_collision_query.h>
 #include <OpenTissue/collision/bvh/bvh_single_collision_query.h>
+#include <OpenTissue/collision/bvh/bvh_flat_self_collision_query.h>
+#include <OpenTissue/collision/bvh/bvh_flat_model_collision_query.h>
 
 #include <OpenTissue/collision/bvh/bvh_bottom_up_refitter.h>
+#include <OpenTissue/collision/bvh/bvh_flat_bottom_up_refitter.h>
+#include <OpenTissue/collision/bvh/bvh_flat_lbvh_constructor.h>
+#include <OpenTissue/collision/bvh/bvh_flat_binned_sah_constructor.h>
 
 #include <OpenTissue/collision/bvh/bvh_get_all_nodes.h>
 #include <OpenTissue/collision/bvh/bvh_get_leaf_nodes.h>
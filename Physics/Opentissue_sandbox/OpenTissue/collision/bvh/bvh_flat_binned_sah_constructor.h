@@ -0,0 +1,310 @@
+#ifndef OPENTISSUE_COLLISION_BVH_BVH_FLAT_BINNED_SAH_CONSTRUCTOR_H
+#define OPENTISSUE_COLLISION_BVH_BVH_FLAT_BINNED_SAH_CONSTRUCTOR_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace bvh
+  {
+
+    /**
+    * Binned SAH Top Down Construction Algorithm.
+    *
+    * Builds a flat BVH top down. Every node is split by evaluating the
+    * surface area heuristic at the borders of a fixed number of bins
+    * along the axis of largest centroid extent, as described in
+    *
+    *   I. Wald, "On fast Construction of SAH-based Bounding Volume
+    *   Hierarchies", IEEE Symposium on Interactive Ray Tracing 2007.
+    *
+    * Since every leaf holds a single geometry the size of a subtree is
+    * known as soon as its node is split, thus the depth first position of
+    * both children is known and subtrees are build concurrently as OpenMP
+    * tasks. The AABBs are computed in parallel before the construction.
+    *
+    * The AABB policy must define the bvh_type (a FlatBoundingVolumeHierarchy) and
+    * the method
+    *
+    *   void compute_aabb(geometry_type const & geometry, vector3_type & min_coord, vector3_type & max_coord)
+    *
+    * which is invoked concurrently from multiple threads.
+    */
+    template <typename aabb_policy>
+    class BinnedSAHConstructor
+      : public aabb_policy
+    {
+    public:
+
+      typedef typename aabb_policy::bvh_type          bvh_type;
+      typedef typename bvh_type::node_type            node_type;
+      typedef typename bvh_type::vector3_type         vector3_type;
+      typedef typename bvh_type::real_type            real_type;
+      typedef typename bvh_type::geometry_type        geometry_type;
+
+    protected:
+
+      typedef std::vector<vector3_type>               vector3_container;
+      typedef std::vector<int>                        index_container;
+
+      /**
+      * Partition Predicate, true for geometry with centroid in a bin left of the split.
+      */
+      class in_left_bins
+      {
+      public:
+        in_left_bins(BinnedSAHConstructor const * owner, int axis, real_type lower, real_type scale, int split)
+          : m_owner(owner), m_axis(axis), m_lower(lower), m_scale(scale), m_split(split)
+        {}
+        bool operator()(int g) const { return m_owner->bin( g, m_axis, m_lower, m_scale ) <= m_split; }
+      protected:
+        BinnedSAHConstructor const * m_owner;
+        int       m_axis;
+        real_type m_lower;
+        real_type m_scale;
+        int       m_split;
+      };
+
+      /**
+      * Comparison of geometry by centroid coordinate.
+      */
+      class centroid_less
+      {
+      public:
+        centroid_less(BinnedSAHConstructor const * owner, int axis):m_owner(owner),m_axis(axis){}
+        bool operator()(int a, int b) const { return m_owner->m_centroid[a](m_axis) < m_owner->m_centroid[b](m_axis); }
+      protected:
+        BinnedSAHConstructor const * m_owner;
+        int m_axis;
+      };
+
+      enum { bins = 16 };   ///< Number of bins used to evaluate the SAH.
+
+      vector3_container  m_min;             ///< Minimum corner of the AABB of every geometry.
+      vector3_container  m_max;             ///< Maximum corner of the AABB of every geometry.
+      vector3_container  m_centroid;        ///< Center of the AABB of every geometry.
+      index_container    m_index;           ///< Geometry indices, partitioned during construction.
+      int                m_task_threshold;  ///< Subtrees with fewer geometries are build by the thread that split their parent.
+
+    public:
+
+      BinnedSAHConstructor()
+        : m_task_threshold(4096)
+      {}
+
+    public:
+
+      void set_task_threshold(int threshold) { m_task_threshold = threshold; }
+      int  get_task_threshold() const        { return m_task_threshold; }
+
+      /**
+      * Run Algorithm.
+      *
+      * @param begin      Iterator to first geometry.
+      * @param end        Iterator to one position past last geometry.
+      * @param bvh        Upon return this argument holds the resulting BVH.
+      */
+      template< typename iterator >
+      void run(iterator begin, iterator end, bvh_type & bvh)
+      {
+        bvh.clear();
+        std::copy( begin, end, std::back_inserter( bvh.geometry() ) );
+
+        int const N = static_cast<int>( bvh.geometry().size() );
+        if(N == 0)
+          return;
+
+        m_min.resize(N);
+        m_max.resize(N);
+        m_centroid.resize(N);
+        m_index.resize(N);
+#pragma omp parallel for
+        for(int g = 0; g < N; ++g)
+        {
+          this->compute_aabb( bvh.geometry()[g], m_min[g], m_max[g] );  //--- From aabb policy
+          m_centroid[g] = (m_min[g] + m_max[g]) / real_type(2);
+          m_index[g] = g;
+        }
+
+        bvh.nodes().resize( 2*N - 1 );
+#pragma omp parallel
+        {
+#pragma omp single
+          build( bvh, 0, 0, N, -1 );
+        }
+
+        bvh.update_levels();
+        bvh.update_internal_nodes();
+      }
+
+    protected:
+
+      int bin(int g, int axis, real_type lower, real_type scale) const
+      {
+        int b = static_cast<int>( (m_centroid[g](axis) - lower) * scale );
+        return b < 0 ? 0 : ( b > bins - 1 ? bins - 1 : b );
+      }
+
+      static real_type area(vector3_type const & lower, vector3_type const & upper)
+      {
+        vector3_type d = upper - lower;
+        return d(0)*d(1) + d(1)*d(2) + d(2)*d(0);
+      }
+
+      static void grow(vector3_type & lower, vector3_type & upper, vector3_type const & p_min, vector3_type const & p_max)
+      {
+        for(int j = 0; j < 3; ++j)
+        {
+          lower(j) = p_min(j) < lower(j) ? p_min(j) : lower(j);
+          upper(j) = p_max(j) > upper(j) ? p_max(j) : upper(j);
+        }
+      }
+
+      /**
+      * Build the subtree of the geometry m_index[first] to m_index[last-1] at the given depth first position.
+      */
+      void build(bvh_type & bvh, int position, int first, int last, int parent)
+      {
+        int const count = last - first;
+        node_type & nd = bvh.nodes()[position];
+        nd.m_parent = parent;
+        nd.m_skip   = position + 2*count - 1;
+
+        if(count == 1)
+        {
+          int const g   = m_index[first];
+          nd.m_right    = -1;
+          nd.m_geometry = g;
+          nd.m_min      = m_min[g];
+          nd.m_max      = m_max[g];
+          return;
+        }
+
+        int const mid   = split( first, last );
+        int const right = position + 2*(mid - first);
+        nd.m_right    = right;
+        nd.m_geometry = -1;
+
+        //--- The bvh must be shared explicitly, reference arguments are firstprivate in tasks by default
+        if(count > m_task_threshold)
+        {
+#pragma omp task shared(bvh)
+          build( bvh, position + 1, first, mid, position );
+#pragma omp task shared(bvh)
+          build( bvh, right, mid, last, position );
+        }
+        else
+        {
+          build( bvh, position + 1, first, mid, position );
+          build( bvh, right, mid, last, position );
+        }
+      }
+
+      /**
+      * Partition the geometry m_index[first] to m_index[last-1] and return the start of the right part.
+      */
+      int split(int first, int last)
+      {
+        int const count = last - first;
+
+        vector3_type lower = m_centroid[ m_index[first] ];
+        vector3_type upper = lower;
+        for(int k = first + 1; k < last; ++k)
+          grow( lower, upper, m_centroid[ m_index[k] ], m_centroid[ m_index[k] ] );
+
+        vector3_type extent = upper - lower;
+        int axis = 0;
+        if(extent(1) > extent(axis)) axis = 1;
+        if(extent(2) > extent(axis)) axis = 2;
+
+        int mid = first + count/2;
+        if(extent(axis) > real_type(0))
+        {
+          real_type const scale = real_type(bins) / extent(axis);
+
+          int          bin_count[bins];
+          vector3_type bin_min[bins];
+          vector3_type bin_max[bins];
+          for(int b = 0; b < bins; ++b)
+            bin_count[b] = 0;
+          for(int k = first; k < last; ++k)
+          {
+            int const g = m_index[k];
+            int const b = bin( g, axis, lower(axis), scale );
+            if(bin_count[b]++ == 0)
+            {
+              bin_min[b] = m_min[g];
+              bin_max[b] = m_max[g];
+            }
+            else
+              grow( bin_min[b], bin_max[b], m_min[g], m_max[g] );
+          }
+
+          //--- Sweep from the right to get the cost of the right sides, then from the left
+          real_type right_cost[bins];
+          int n = 0;
+          vector3_type r_min, r_max;
+          for(int b = bins - 1; b > 0; --b)
+          {
+            if(bin_count[b] > 0)
+            {
+              if(n == 0) { r_min = bin_min[b]; r_max = bin_max[b]; }
+              else       grow( r_min, r_max, bin_min[b], bin_max[b] );
+              n += bin_count[b];
+            }
+            right_cost[b] = (n > 0) ? area(r_min, r_max) * n : real_type(0);
+          }
+
+          int best = -1;
+          real_type best_cost = real_type(0);
+          n = 0;
+          vector3_type l_min, l_max;
+          for(int b = 0; b < bins - 1; ++b)
+          {
+            if(bin_count[b] > 0)
+            {
+              if(n == 0) { l_min = bin_min[b]; l_max = bin_max[b]; }
+              else       grow( l_min, l_max, bin_min[b], bin_max[b] );
+              n += bin_count[b];
+            }
+            if(n == 0 || n == count)
+              continue;
+            real_type const cost = area(l_min, l_max) * n + right_cost[b+1];
+            if(best < 0 || cost < best_cost)
+            {
+              best = b;
+              best_cost = cost;
+            }
+          }
+
+          if(best >= 0)
+            mid = static_cast<int>( std::partition( m_index.begin() + first, m_index.begin() + last, in_left_bins(this, axis, lower(axis), scale, best) ) - m_index.begin() );
+        }
+
+        //--- All centroids in one bin, split in the middle
+        if(mid == first || mid == last || extent(axis) <= real_type(0))
+        {
+          mid = first + count/2;
+          std::nth_element( m_index.begin() + first, m_index.begin() + mid, m_index.begin() + last, centroid_less(this, axis) );
+        }
+        return mid;
+      }
+
+    };
+
+  } // namespace bvh
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_BVH_BVH_FLAT_BINNED_SAH_CONSTRUCTOR_H
+#endif
@@ -0,0 +1,64 @@
+#ifndef OPENTISSUE_COLLISION_BVH_BVH_FLAT_BOTTOM_UP_REFITTER_H
+#define OPENTISSUE_COLLISION_BVH_BVH_FLAT_BOTTOM_UP_REFITTER_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+namespace OpenTissue
+{
+  namespace bvh
+  {
+
+    /**
+    * Parallel Bottom-Up refitting of a flat BVH.
+    * The leaves are refitted in parallel, then the internal nodes are
+    * refitted one level at a time starting from the deepest level.
+    *
+    * The AABB policy must define the bvh_type (a FlatBoundingVolumeHierarchy) and
+    * the method
+    *
+    *   void compute_aabb(geometry_type const & geometry, vector3_type & min_coord, vector3_type & max_coord)
+    *
+    * which is invoked concurrently from multiple threads.
+    */
+    template <typename aabb_policy>
+    class FlatBottomUpRefitter
+      : public aabb_policy
+    {
+    public:
+
+      typedef typename aabb_policy::bvh_type          bvh_type;
+      typedef typename bvh_type::node_type            node_type;
+      typedef typename bvh_type::index_container      index_container;
+
+    public:
+
+      /**
+      * Run update algorithm.
+      *
+      * @param bvh    Reference to the flat BVH that should be updated.
+      */
+      void run( bvh_type & bvh )
+      {
+        index_container const & leaves = bvh.leaves();
+        int const count = static_cast<int>( leaves.size() );
+#pragma omp parallel for
+        for(int k = 0; k < count; ++k)
+        {
+          node_type & leaf = bvh.node( leaves[k] );
+          this->compute_aabb( bvh.geometry(leaf), leaf.m_min, leaf.m_max );  //--- From aabb policy
+        }
+        bvh.update_internal_nodes();
+      }
+    };
+
+  } // namespace bvh
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_BVH_BVH_FLAT_BOTTOM_UP_REFITTER_H
+#endif
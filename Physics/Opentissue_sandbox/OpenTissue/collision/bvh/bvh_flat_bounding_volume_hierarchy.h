@@ -0,0 +1,221 @@
+#ifndef OPENTISSUE_COLLISION_BVH_BVH_FLAT_BOUNDING_VOLUME_HIERARCHY_H
+#define OPENTISSUE_COLLISION_BVH_BVH_FLAT_BOUNDING_VOLUME_HIERARCHY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <boost/align/aligned_allocator.hpp>
+
+#include <vector>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace bvh
+  {
+
+    /**
+    * Flat Bounding Volume Hierarchy Class.
+    *
+    * A binary AABB tree stored in one array, intended for large models that
+    * are rebuild or refitted every frame. Unlike BoundingVolumeHierarchy
+    * there is no node objects allocated one at a time, instead the nodes
+    * are laid out in depth first order:
+    *
+    *   - The left child of an internal node i is node i+1.
+    *   - The right child of an internal node i is node m_right.
+    *   - The skip index of node i is the first node after the subtree of i.
+    *
+    * Thus a traversal can be done without a stack, if the volume of node i
+    * is overlapping continue at i+1 otherwise continue at the skip index.
+    * Every leaf holds exactly one geometry. The node array is cache line
+    * aligned, with double precision one node fills one cache line.
+    *
+    * The hierarchy is build by LBVHConstructor or BinnedSAHConstructor
+    * and refitted by FlatBottomUpRefitter.
+    */
+    template <typename vector3_type_, typename geometry_type_>
+    class FlatBoundingVolumeHierarchy
+    {
+    public:
+
+      typedef vector3_type_                             vector3_type;
+      typedef typename vector3_type::value_type         real_type;
+      typedef geometry_type_                            geometry_type;
+
+      class node_type
+      {
+      public:
+
+        vector3_type m_min;       ///< Minimum corner of the AABB of the node.
+        vector3_type m_max;       ///< Maximum corner of the AABB of the node.
+        int          m_right;     ///< Index of the right child, -1 for leaves.
+        int          m_skip;      ///< Index of the first node after the subtree of the node.
+        int          m_parent;    ///< Index of the parent node, -1 for the root.
+        int          m_geometry;  ///< Index of the geometry of a leaf, -1 for internal nodes.
+
+      public:
+
+        node_type()
+          : m_right(-1)
+          , m_skip(0)
+          , m_parent(-1)
+          , m_geometry(-1)
+        {}
+
+      public:
+
+        bool is_leaf() const { return m_right < 0; }
+      };
+
+      typedef std::vector< node_type, boost::alignment::aligned_allocator<node_type, 64> >  node_container;
+      typedef std::vector< geometry_type >                                                 geometry_container;
+      typedef std::vector< int >                                                           index_container;
+
+    protected:
+
+      node_container      m_nodes;          ///< The nodes in depth first order.
+      geometry_container  m_geometry;       ///< The geometry, in the order given at construction.
+      index_container     m_leaves;         ///< Indices of all leaf nodes.
+      index_container     m_levels;         ///< Indices of all internal nodes, sorted by depth.
+      index_container     m_level_offsets;  ///< The internal nodes at depth d are m_levels[m_level_offsets[d]] to m_levels[m_level_offsets[d+1]-1].
+
+    public:
+
+      size_t size()  const { return m_nodes.size(); }
+      bool   empty() const { return m_nodes.empty(); }
+
+      node_type       & node(size_t i)       { assert(i < m_nodes.size()); return m_nodes[i]; }
+      node_type const & node(size_t i) const { assert(i < m_nodes.size()); return m_nodes[i]; }
+
+      node_container       & nodes()       { return m_nodes; }
+      node_container const & nodes() const { return m_nodes; }
+
+      geometry_container       & geometry()       { return m_geometry; }
+      geometry_container const & geometry() const { return m_geometry; }
+
+      geometry_type const & geometry(node_type const & leaf) const
+      {
+        assert(leaf.is_leaf() || !"FlatBoundingVolumeHierarchy::geometry(): node was not a leaf");
+        return m_geometry[leaf.m_geometry];
+      }
+
+      index_container const & leaves()        const { return m_leaves; }
+      index_container const & levels()        const { return m_levels; }
+      index_container const & level_offsets() const { return m_level_offsets; }
+
+      /**
+      * Number of levels in the hierarchy, not counting the level of the deepest leaves.
+      */
+      size_t depth() const { return m_level_offsets.empty() ? 0 : m_level_offsets.size() - 1; }
+
+      void clear()
+      {
+        m_nodes.clear();
+        m_geometry.clear();
+        m_leaves.clear();
+        m_levels.clear();
+        m_level_offsets.clear();
+      }
+
+      /**
+      * Update Levels.
+      * Computes the leaf and level lists used for refitting. Constructors
+      * invoke this after the node layout is done. In depth first order a
+      * parent always comes before its children, so one sweep is enough.
+      */
+      void update_levels()
+      {
+        int const N = static_cast<int>( m_nodes.size() );
+
+        index_container depth( N, 0 );
+        int max_depth = 0;
+        int internal = 0;
+        m_leaves.clear();
+        for(int i = 0; i < N; ++i)
+        {
+          node_type const & nd = m_nodes[i];
+          if(nd.is_leaf())
+          {
+            m_leaves.push_back(i);
+            continue;
+          }
+          depth[i+1]        = depth[i] + 1;
+          depth[nd.m_right] = depth[i] + 1;
+          max_depth = (depth[i] > max_depth) ? depth[i] : max_depth;
+          ++internal;
+        }
+
+        m_level_offsets.assign( internal ? max_depth + 2 : 1, 0 );
+        for(int i = 0; i < N; ++i)
+          if(!m_nodes[i].is_leaf())
+            ++m_level_offsets[ depth[i] + 1 ];
+        for(size_t d = 1; d < m_level_offsets.size(); ++d)
+          m_level_offsets[d] += m_level_offsets[d-1];
+
+        m_levels.resize( internal );
+        index_container next( m_level_offsets.begin(), m_level_offsets.end() );
+        for(int i = 0; i < N; ++i)
+          if(!m_nodes[i].is_leaf())
+            m_levels[ next[ depth[i] ]++ ] = i;
+      }
+
+      /**
+      * Update Internal Nodes.
+      * Fits the AABBs of all internal nodes to the AABBs of their children,
+      * assuming the leaves are up to date. Levels are processed from the
+      * deepest and up, the nodes of a level are fitted in parallel.
+      */
+      void update_internal_nodes()
+      {
+        for(int d = static_cast<int>( depth() ) - 1; d >= 0; --d)
+        {
+          int const first = m_level_offsets[d];
+          int const last  = m_level_offsets[d+1];
+#pragma omp parallel for
+          for(int k = first; k < last; ++k)
+          {
+            int const i = m_levels[k];
+            node_type & nd          = m_nodes[i];
+            node_type const & left  = m_nodes[i+1];
+            node_type const & right = m_nodes[nd.m_right];
+            for(int j = 0; j < 3; ++j)
+            {
+              nd.m_min(j) = left.m_min(j) < right.m_min(j) ? left.m_min(j) : right.m_min(j);
+              nd.m_max(j) = left.m_max(j) > right.m_max(j) ? left.m_max(j) : right.m_max(j);
+            }
+          }
+        }
+      }
+
+      /**
+      * AABB Overlap Test.
+      */
+      static bool overlap(vector3_type const & min_a, vector3_type const & max_a, vector3_type const & min_b, vector3_type const & max_b)
+      {
+        if(min_a(0) > max_b(0) || min_b(0) > max_a(0))
+          return false;
+        if(min_a(1) > max_b(1) || min_b(1) > max_a(1))
+          return false;
+        if(min_a(2) > max_b(2) || min_b(2) > max_a(2))
+          return false;
+        return true;
+      }
+
+      static bool overlap(node_type const & a, node_type const & b)
+      {
+        return overlap(a.m_min, a.m_max, b.m_min, b.m_max);
+      }
+
+    };
+
+  } // namespace bvh
+} // namespace OpenTissue
+
+//OPENTISSUE_COLLISION_BVH_BVH_FLAT_BOUNDING_VOLUME_HIERARCHY_H
+#endif
@@ -0,0 +1,356 @@
+#ifndef OPENTISSUE_COLLISION_BVH_BVH_FLAT_LBVH_CONSTRUCTOR_H
+#define OPENTISSUE_COLLISION_BVH_BVH_FLAT_LBVH_CONSTRUCTOR_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <iterator>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace bvh
+  {
+
+    /**
+    * Linear BVH Construction Algorithm.
+    *
+    * Builds a flat BVH by sorting the geometry along a Morton curve and
+    * deriving the hierarchy from the sorted Morton codes as described in
+    *
+    *   T. Karras, "Maximizing Parallelism in the Construction of BVHs,
+    *   Octrees, and k-d Trees", High Performance Graphics 2012.
+    *
+    * Every step runs in parallel: the AABBs and Morton codes are computed
+    * per geometry, the codes are sorted by a block parallel radix sort,
+    * every internal node finds its own key range and split, and every node
+    * finds its own depth first position from the leaf range and the number
+    * of ancestors it is a left descendant of.
+    *
+    * The tree quality is lower than the tree of the BinnedSAHConstructor,
+    * but the construction is much faster, which makes it a good choice for
+    * deforming geometry that is rebuilt every frame.
+    *
+    * The AABB policy must define the bvh_type (a FlatBoundingVolumeHierarchy) and
+    * the method
+    *
+    *   void compute_aabb(geometry_type const & geometry, vector3_type & min_coord, vector3_type & max_coord)
+    *
+    * which is invoked concurrently from multiple threads.
+    */
+    template <typename aabb_policy>
+    class LBVHConstructor
+      : public aabb_policy
+    {
+    public:
+
+      typedef typename aabb_policy::bvh_type          bvh_type;
+      typedef typename bvh_type::node_type            node_type;
+      typedef typename bvh_type::vector3_type         vector3_type;
+      typedef typename bvh_type::real_type            real_type;
+      typedef typename bvh_type::geometry_type        geometry_type;
+
+    protected:
+
+      typedef std::vector<vector3_type>               vector3_container;
+      typedef std::vector<unsigned int>               code_container;
+      typedef std::vector<int>                        index_container;
+
+      vector3_container  m_min;       ///< Minimum corner of the AABB of every geometry.
+      vector3_container  m_max;       ///< Maximum corner of the AABB of every geometry.
+      code_container     m_codes;     ///< Sorted Morton codes.
+      index_container    m_order;     ///< Geometry index of the sorted Morton codes.
+      code_container     m_code_tmp;  ///< Radix sort scratch.
+      index_container    m_order_tmp; ///< Radix sort scratch.
+      index_container    m_first;     ///< First leaf covered by every node, internal nodes first followed by the leaves.
+      index_container    m_last;      ///< Last leaf covered by every node.
+      index_container    m_left;      ///< Left child of every internal node.
+      index_container    m_right;     ///< Right child of every internal node.
+      index_container    m_parent;    ///< Parent of every node.
+      index_container    m_position;  ///< Depth first position of every node.
+
+    public:
+
+      /**
+      * Run Algorithm.
+      *
+      * @param begin      Iterator to first geometry.
+      * @param end        Iterator to one position past last geometry.
+      * @param bvh        Upon return this argument holds the resulting BVH.
+      */
+      template< typename iterator >
+      void run(iterator begin, iterator end, bvh_type & bvh)
+      {
+        bvh.clear();
+        std::copy( begin, end, std::back_inserter( bvh.geometry() ) );
+
+        int const N = static_cast<int>( bvh.geometry().size() );
+        if(N == 0)
+          return;
+
+        compute_aabbs(bvh);
+        compute_codes();
+        sort_codes();
+
+        int const internal = N - 1;
+        m_first.resize( 2*N - 1 );
+        m_last.resize( 2*N - 1 );
+        m_left.resize( internal );
+        m_right.resize( internal );
+        m_parent.assign( 2*N - 1, -1 );
+        m_position.resize( 2*N - 1 );
+
+        //--- Leaves are numbered N-1 and up
+#pragma omp parallel for
+        for(int j = 0; j < N; ++j)
+        {
+          m_first[internal + j] = j;
+          m_last[internal + j]  = j;
+        }
+
+#pragma omp parallel for
+        for(int i = 0; i < internal; ++i)
+          create_internal_node(i, N);
+
+        //--- Depth first position is two times the leaves to the left plus the number of left turns from the root
+#pragma omp parallel for
+        for(int k = 0; k < 2*N - 1; ++k)
+        {
+          int left_turns = 0;
+          for(int c = k, p = m_parent[k]; p >= 0; c = p, p = m_parent[p])
+            if(m_left[p] == c)
+              ++left_turns;
+          m_position[k] = 2*m_first[k] + left_turns;
+        }
+
+        typename bvh_type::node_container & nodes = bvh.nodes();
+        nodes.resize( 2*N - 1 );
+#pragma omp parallel for
+        for(int k = 0; k < 2*N - 1; ++k)
+        {
+          node_type & nd = nodes[ m_position[k] ];
+          nd.m_parent = (m_parent[k] >= 0) ? m_position[ m_parent[k] ] : -1;
+          nd.m_skip   = m_position[k] + 2*(m_last[k] - m_first[k] + 1) - 1;
+          if(k < internal)
+          {
+            nd.m_right    = m_position[ m_right[k] ];
+            nd.m_geometry = -1;
+          }
+          else
+          {
+            int const g   = m_order[ k - internal ];
+            nd.m_right    = -1;
+            nd.m_geometry = g;
+            nd.m_min      = m_min[g];
+            nd.m_max      = m_max[g];
+          }
+        }
+
+        bvh.update_levels();
+        bvh.update_internal_nodes();
+      }
+
+    protected:
+
+      void compute_aabbs(bvh_type & bvh)
+      {
+        int const N = static_cast<int>( bvh.geometry().size() );
+        m_min.resize(N);
+        m_max.resize(N);
+#pragma omp parallel for
+        for(int g = 0; g < N; ++g)
+          this->compute_aabb( bvh.geometry()[g], m_min[g], m_max[g] );  //--- From aabb policy
+      }
+
+      /**
+      * Spread the lower 10 bits of the value such that there are two zero bits between every bit.
+      */
+      static unsigned int expand_bits(unsigned int v)
+      {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+      }
+
+      static int count_leading_zeros(unsigned int v)
+      {
+        if(v == 0)
+          return 32;
+        int n = 0;
+        if((v & 0xFFFF0000u) == 0) { n += 16; v <<= 16; }
+        if((v & 0xFF000000u) == 0) { n +=  8; v <<=  8; }
+        if((v & 0xF0000000u) == 0) { n +=  4; v <<=  4; }
+        if((v & 0xC0000000u) == 0) { n +=  2; v <<=  2; }
+        if((v & 0x80000000u) == 0) { n +=  1; }
+        return n;
+      }
+
+      /**
+      * Compute 30 bit Morton codes of the AABB centers, quantized to the bounds of all centers.
+      */
+      void compute_codes()
+      {
+        int const N = static_cast<int>( m_min.size() );
+
+        vector3_type lower = (m_min[0] + m_max[0]) / real_type(2);
+        vector3_type upper = lower;
+        for(int g = 1; g < N; ++g)
+        {
+          vector3_type c = (m_min[g] + m_max[g]) / real_type(2);
+          for(int j = 0; j < 3; ++j)
+          {
+            lower(j) = c(j) < lower(j) ? c(j) : lower(j);
+            upper(j) = c(j) > upper(j) ? c(j) : upper(j);
+          }
+        }
+
+        real_type scale[3];
+        for(int j = 0; j < 3; ++j)
+          scale[j] = (upper(j) > lower(j)) ? real_type(1023) / (upper(j) - lower(j)) : real_type(0);
+
+        m_codes.resize(N);
+        m_order.resize(N);
+#pragma omp parallel for
+        for(int g = 0; g < N; ++g)
+        {
+          vector3_type c = (m_min[g] + m_max[g]) / real_type(2);
+          unsigned int q[3];
+          for(int j = 0; j < 3; ++j)
+          {
+            real_type t = (c(j) - lower(j)) * scale[j];
+            q[j] = static_cast<unsigned int>( t < real_type(0) ? real_type(0) : ( t > real_type(1023) ? real_type(1023) : t ) );
+          }
+          m_codes[g] = (expand_bits(q[0]) << 2) | (expand_bits(q[1]) << 1) | expand_bits(q[2]);
+          m_order[g] = g;
+        }
+      }
+
+      /**
+      * Stable LSD radix sort of the codes in three passes of ten bits. The
+      * codes are split into blocks, each pass histograms and scatters the
+      * blocks in parallel.
+      */
+      void sort_codes()
+      {
+        int const N       = static_cast<int>( m_codes.size() );
+        int const radix   = 1024;
+        int const block   = 4096;
+        int const blocks  = (N + block - 1) / block;
+
+        m_code_tmp.resize(N);
+        m_order_tmp.resize(N);
+        index_container offsets( blocks * radix );
+
+        for(int shift = 0; shift < 30; shift += 10)
+        {
+#pragma omp parallel for
+          for(int b = 0; b < blocks; ++b)
+          {
+            int * count = &offsets[b*radix];
+            std::fill( count, count + radix, 0 );
+            int const last = (b+1)*block < N ? (b+1)*block : N;
+            for(int i = b*block; i < last; ++i)
+              ++count[ (m_codes[i] >> shift) & (radix - 1) ];
+          }
+
+          //--- Exclusive scan in digit major, block minor order keeps the sort stable
+          int sum = 0;
+          for(int digit = 0; digit < radix; ++digit)
+            for(int b = 0; b < blocks; ++b)
+            {
+              int const cnt = offsets[b*radix + digit];
+              offsets[b*radix + digit] = sum;
+              sum += cnt;
+            }
+
+#pragma omp parallel for
+          for(int b = 0; b < blocks; ++b)
+          {
+            int * next = &offsets[b*radix];
+            int const last = (b+1)*block < N ? (b+1)*block : N;
+            for(int i = b*block; i < last; ++i)
+            {
+              int const slot = next[ (m_codes[i] >> shift) & (radix - 1) ]++;
+              m_code_tmp[slot]  = m_codes[i];
+              m_order_tmp[slot] = m_order[i];
+            }
+          }
+
+          m_codes.swap(m_code_tmp);
+          m_order.swap(m_order_tmp);
+        }
+      }
+
+      /**
+      * Length of the common prefix of the keys i and j, duplicate codes are made unique by their index.
+      */
+      int delta(int i, int j, int N) const
+      {
+        if(j < 0 || j >= N)
+          return -1;
+        unsigned int const a = m_codes[i];
+        unsigned int const b = m_codes[j];
+        if(a == b)
+          return 32 + count_leading_zeros( static_cast<unsigned int>(i ^ j) );
+        return count_leading_zeros(a ^ b);
+      }
+
+      void create_internal_node(int i, int N)
+      {
+        int const internal = N - 1;
+
+        //--- Direction of the range and upper bound of its length
+        int const d = ( delta(i, i+1, N) - delta(i, i-1, N) ) >= 0 ? 1 : -1;
+        int const delta_min = delta(i, i - d, N);
+        int l_max = 2;
+        while( delta(i, i + l_max*d, N) > delta_min )
+          l_max *= 2;
+
+        //--- Binary search for the other end of the range
+        int l = 0;
+        for(int t = l_max / 2; t >= 1; t /= 2)
+          if( delta(i, i + (l + t)*d, N) > delta_min )
+            l += t;
+        int const j = i + l*d;
+
+        //--- Binary search for the split position
+        int const delta_node = delta(i, j, N);
+        int s = 0;
+        int t = l;
+        do
+        {
+          t = (t + 1) / 2;
+          if( delta(i, i + (s + t)*d, N) > delta_node )
+            s += t;
+        }
+        while(t > 1);
+        int const split = i + s*d + (d < 0 ? -1 : 0);
+
+        int const first = (d > 0) ? i : j;
+        int const last  = (d > 0) ? j : i;
+        int const left  = (first == split)     ? internal + split     : split;
+        int const right = (last  == split + 1) ? internal + split + 1 : split + 1;
+
+        m_first[i] = first;
+        m_last[i]  = last;
+        m_left[i]  = left;
+        m_right[i] = right;
+        m_parent[left]  = i;
+        m_parent[right] = i;
+      }
+
+    };
+
+  } // namespace bvh
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_BVH_BVH_FLAT_LBVH_CONSTRUCTOR_H
+#endif
@@ -0,0 +1,150 @@
+#ifndef OPENTISSUE_BVH_BVH_FLAT_MODEL_COLLISION_QUERY_H
+#define OPENTISSUE_BVH_BVH_FLAT_MODEL_COLLISION_QUERY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace bvh
+  {
+    /**
+    * Flat Model Frame Query.
+    * The counterpart of ModelCollisionQuery for a FlatBoundingVolumeHierarchy,
+    * bvh A is transformed into the frame of bvh B.
+    *
+    * The AABB of every leaf of A is transformed into the frame of B and
+    * enclosed in an AABB, which is tested against the hierarchy of B using
+    * a stackless traversal. The leaves of A are processed in parallel chunks,
+    * each chunk reporting into its own result container, and the chunk
+    * results are appended in leaf order.
+    *
+    * The collision policy must support the following interface:
+    *
+    *   void reset(result_type)
+    *   void report(coordsys_type,geometry_type,geometry_type,result_type)
+    *
+    * The report method is invoked concurrently, it is given geometry pairs
+    * with overlapping AABBs and is responsible for performing the exact
+    * test. The result_type must be default constructible and support
+    * insert(end(),first,last).
+    */
+    template <typename collision_policy>
+    class FlatModelCollisionQuery : public collision_policy
+    {
+    public:
+
+      typedef typename collision_policy::bvh_type     bvh_type;
+      typedef typename bvh_type::node_type            node_type;
+      typedef typename bvh_type::node_container       node_container;
+      typedef typename bvh_type::index_container      index_container;
+      typedef typename bvh_type::vector3_type         vector3_type;
+
+    protected:
+
+      int m_chunk_size;   ///< Number of leaves handled by a thread at a time.
+
+    public:
+
+      FlatModelCollisionQuery()
+        : m_chunk_size(256)
+      {}
+
+    public:
+
+      void set_chunk_size(int size)
+      {
+        assert( size > 0 || !"FlatModelCollisionQuery::set_chunk_size(): size must be positive");
+        m_chunk_size = size;
+      }
+
+      /**
+      * Model Frame Query.
+      *
+      * @param A2B       Model transform, brings bvh A into same frame as bvh B.
+      * @param bvh_A     bvh A.
+      * @param bvh_B     bvh B
+      * @param results   Upon return this container contains any results from the
+      *                  collision query.
+      */
+      template<typename coordsys_type, typename results_container>
+      void run( coordsys_type const & A2B, bvh_type const & bvh_A, bvh_type const & bvh_B, results_container & results )
+      {
+        this->reset(results);//--- collision_policy
+
+        if(bvh_B.empty())
+          return;
+
+        index_container const & leaves = bvh_A.leaves();
+        int const count  = static_cast<int>( leaves.size() );
+        int const chunks = (count + m_chunk_size - 1) / m_chunk_size;
+        std::vector<results_container> parts( chunks );
+
+#pragma omp parallel for schedule(dynamic)
+        for(int chunk = 0; chunk < chunks; ++chunk)
+        {
+          results_container & part = parts[chunk];
+          this->reset(part);
+          int const last = (chunk+1)*m_chunk_size < count ? (chunk+1)*m_chunk_size : count;
+          for(int k = chunk*m_chunk_size; k < last; ++k)
+            leaf_test( A2B, bvh_A, bvh_A.node( leaves[k] ), bvh_B, part );
+        }
+
+        for(int chunk = 0; chunk < chunks; ++chunk)
+          results.insert( results.end(), parts[chunk].begin(), parts[chunk].end() );
+      }
+
+    protected:
+
+      template<typename coordsys_type, typename results_container>
+      void leaf_test( coordsys_type const & A2B, bvh_type const & bvh_A, node_type const & A, bvh_type const & bvh_B, results_container & results )
+      {
+        //--- Enclose the transformed corners of the leaf AABB
+        vector3_type lower, upper;
+        for(int c = 0; c < 8; ++c)
+        {
+          vector3_type p(
+            (c & 1) ? A.m_max(0) : A.m_min(0)
+            , (c & 2) ? A.m_max(1) : A.m_min(1)
+            , (c & 4) ? A.m_max(2) : A.m_min(2)
+            );
+          A2B.xform_point(p);
+          for(int j = 0; j < 3; ++j)
+          {
+            lower(j) = (c == 0 || p(j) < lower(j)) ? p(j) : lower(j);
+            upper(j) = (c == 0 || p(j) > upper(j)) ? p(j) : upper(j);
+          }
+        }
+
+        node_container const & nodes = bvh_B.nodes();
+        int const N = static_cast<int>( nodes.size() );
+        int i = 0;
+        while( i < N )
+        {
+          node_type const & B = nodes[i];
+          if( !bvh_type::overlap( lower, upper, B.m_min, B.m_max ) )
+          {
+            i = B.m_skip;
+            continue;
+          }
+          if( B.is_leaf() )
+            this->report( A2B, bvh_A.geometry(A), bvh_B.geometry(B), results );  //--- collision_policy
+          ++i;
+        }
+      }
+
+    };
+
+  } // namespace bvh
+} // namespace OpenTissue
+
+// OPENTISSUE_BVH_BVH_FLAT_MODEL_COLLISION_QUERY_H
+#endif
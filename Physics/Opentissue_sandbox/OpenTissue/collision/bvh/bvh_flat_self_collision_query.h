@@ -0,0 +1,129 @@
+#ifndef OPENTISSUE_BVH_BVH_FLAT_SELF_COLLISION_QUERY_H
+#define OPENTISSUE_BVH_BVH_FLAT_SELF_COLLISION_QUERY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace bvh
+  {
+    /**
+    * Flat Self Collision Query.
+    * The counterpart of SelfCollisionQuery for a FlatBoundingVolumeHierarchy.
+    *
+    * Every leaf is tested against the hierarchy using a stackless traversal,
+    * only leaves after it in depth first order are considered, so each pair
+    * of overlapping leaves is found exactly once. Subtrees ending before the
+    * leaf are skipped without testing their volumes. The leaves are processed
+    * in parallel chunks, each chunk reporting into its own result container,
+    * and the chunk results are appended in leaf order.
+    *
+    * The collision policy must support the following interface:
+    *
+    *   void reset(result_type)
+    *   void report(geometry_type,geometry_type,result_type)
+    *
+    * The report method is invoked concurrently, it is given geometry pairs
+    * with overlapping AABBs and is responsible for discarding adjacent
+    * geometry and performing the exact test. The result_type must be
+    * default constructible and support insert(end(),first,last).
+    */
+    template <typename collision_policy>
+    class FlatSelfCollisionQuery : public collision_policy
+    {
+    public:
+
+      typedef typename collision_policy::bvh_type     bvh_type;
+      typedef typename bvh_type::node_type            node_type;
+      typedef typename bvh_type::node_container       node_container;
+      typedef typename bvh_type::index_container      index_container;
+
+    protected:
+
+      int m_chunk_size;   ///< Number of leaves handled by a thread at a time.
+
+    public:
+
+      FlatSelfCollisionQuery()
+        : m_chunk_size(256)
+      {}
+
+    public:
+
+      void set_chunk_size(int size)
+      {
+        assert( size > 0 || !"FlatSelfCollisionQuery::set_chunk_size(): size must be positive");
+        m_chunk_size = size;
+      }
+
+      /**
+      * Run Collision Query.
+      *
+      * @param bvh       The bvh upon which to perform self-collision.
+      * @param results   Upon return this container contains any results from the
+      *                  collision query.
+      */
+      template<typename results_container>
+      void run( bvh_type const & bvh, results_container & results )
+      {
+        this->reset(results);//--- from collision_policy
+
+        index_container const & leaves = bvh.leaves();
+        int const count  = static_cast<int>( leaves.size() );
+        int const chunks = (count + m_chunk_size - 1) / m_chunk_size;
+        std::vector<results_container> parts( chunks );
+
+#pragma omp parallel for schedule(dynamic)
+        for(int chunk = 0; chunk < chunks; ++chunk)
+        {
+          results_container & part = parts[chunk];
+          this->reset(part);
+          int const last = (chunk+1)*m_chunk_size < count ? (chunk+1)*m_chunk_size : count;
+          for(int k = chunk*m_chunk_size; k < last; ++k)
+            leaf_test( bvh, leaves[k], part );
+        }
+
+        for(int chunk = 0; chunk < chunks; ++chunk)
+          results.insert( results.end(), parts[chunk].begin(), parts[chunk].end() );
+      }
+
+    protected:
+
+      template<typename results_container>
+      void leaf_test( bvh_type const & bvh, int leaf, results_container & results )
+      {
+        node_container const & nodes = bvh.nodes();
+        node_type const & A = nodes[leaf];
+        int const N = static_cast<int>( nodes.size() );
+
+        int i = 0;
+        while( i < N )
+        {
+          node_type const & B = nodes[i];
+          if( B.m_skip <= leaf + 1 || !bvh_type::overlap( A, B ) )
+          {
+            i = B.m_skip;
+            continue;
+          }
+          if( B.is_leaf() && i > leaf )
+            this->report( bvh.geometry(A), bvh.geometry(B), results );  //--- collision_policy
+          ++i;
+        }
+      }
+
+    };
+
+  } // namespace bvh
+} // namespace OpenTissue
+
+// OPENTISSUE_BVH_BVH_FLAT_SELF_COLLISION_QUERY_H
+#endif
@@ -0,0 +1,57 @@
+#ifndef OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_AABB_DATA_QUERY_H
+#define OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_AABB_DATA_QUERY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/collision/spatial_hashing/spatial_hashing_compact_query.h>
+
+#include <vector>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace spatial_hashing
+  {
+
+    template<typename compact_grid, typename collision_policy>
+    class CompactAABBDataQuery 
+      : public CompactQuery< CompactAABBDataQuery<compact_grid,collision_policy>, compact_grid, collision_policy >
+    {
+    protected:
+
+      typedef typename compact_grid::triplet_type  triplet_type;
+      typedef typename compact_grid::point_type    point_type;
+
+    public:
+
+      void keys(typename compact_grid::data_type const & data, std::vector<size_t> & keys)
+      {
+        point_type min_corner = this->min_coord( data ); //--- from collision policy
+        point_type max_corner = this->max_coord( data ); //--- from collision policy
+        triplet_type m = this->get_triplet(min_corner);
+        triplet_type M = this->get_triplet(max_corner);
+
+        assert( m(0) <= M(0) || !"Minimum was larger than maximum");
+        assert( m(1) <= M(1) || !"Minimum was larger than maximum");
+        assert( m(2) <= M(2) || !"Minimum was larger than maximum");
+
+        triplet_type triplet(m);
+        for ( triplet(0)= m(0) ; triplet(0) <= M(0); ++triplet(0) )
+          for ( triplet(1)= m(1) ; triplet(1) <= M(1); ++triplet(1) )
+            for ( triplet(2)= m(2) ; triplet(2) <= M(2); ++triplet(2) )
+              keys.push_back( this->get_key(triplet) );
+      }
+
+    };
+
+  } // namespace spatial_hashing
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_AABB_DATA_QUERY_H
+#endif
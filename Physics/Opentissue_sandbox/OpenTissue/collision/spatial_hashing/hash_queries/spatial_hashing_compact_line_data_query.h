@@ -0,0 +1,96 @@
+#ifndef OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_LINE_DATA_QUERY_H
+#define OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_LINE_DATA_QUERY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/collision/spatial_hashing/spatial_hashing_compact_query.h>
+
+#include <vector>
+#include <cstdlib>
+
+namespace OpenTissue
+{
+  namespace spatial_hashing
+  {
+
+    template<typename compact_grid, typename collision_policy>
+    class CompactLineDataQuery 
+      : public CompactQuery< CompactLineDataQuery<compact_grid,collision_policy>, compact_grid, collision_policy >
+    {
+    protected:
+
+      typedef typename compact_grid::triplet_type  triplet_type;
+      typedef typename compact_grid::point_type    point_type;
+      typedef typename compact_grid::real_type     real_type;
+
+    public:
+
+      /**
+      * Walks the grid cells along the line segment from origin to destination.
+      * The walk takes exactly as many steps as the Manhattan distance between
+      * the end cells, so it always terminates at the destination cell.
+      */
+      void keys(typename compact_grid::data_type const & data, std::vector<size_t> & keys)
+      {
+        point_type o = this->origin(data);         //--- from collision policy
+        point_type d = this->destination(data);    //--- from collision policy
+        point_type u = d - o;
+        triplet_type T = this->get_triplet(o);
+        triplet_type E = this->get_triplet(d);
+        real_type dx = this->get_spacing();
+
+        int step[3];
+        real_type t_max[3];
+        real_type t_delta[3];
+        int steps = 0;
+        for(int i = 0;i<3;++i)
+        {
+          steps += std::abs( E(i) - T(i) );
+          if(u(i)>0)
+          {
+            step[i]    = 1;
+            t_max[i]   = ( (T(i)+1)*dx - o(i) ) / u(i);
+            t_delta[i] = dx / u(i);
+          }
+          else if(u(i)<0)
+          {
+            step[i]    = -1;
+            t_max[i]   = ( T(i)*dx - o(i) ) / u(i);
+            t_delta[i] = -dx / u(i);
+          }
+          else
+          {
+            step[i]    = 0;
+            t_max[i]   = 10e30;
+            t_delta[i] = 10e30;
+          }
+        }
+
+        keys.push_back( this->get_key(T) );
+        for(int n = 0;n<steps;++n)
+        {
+          //--- Step along the axis whose cell boundary is crossed first, axes that reached the end cell are done
+          int i = -1;
+          for(int j = 0;j<3;++j)
+            if( T(j)!=E(j) && ( i<0 || t_max[j] < t_max[i] ) )
+              i = j;
+          T(i)     += step[i];
+          t_max[i] += t_delta[i];
+          keys.push_back( this->get_key(T) );
+        }
+      }
+
+    };
+
+  } // namespace spatial_hashing
+
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_LINE_DATA_QUERY_H
+#endif
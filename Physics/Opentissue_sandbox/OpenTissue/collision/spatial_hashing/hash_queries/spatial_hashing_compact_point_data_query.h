@@ -0,0 +1,40 @@
+#ifndef OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_POINT_DATA_QUERY_H
+#define OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_POINT_DATA_QUERY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/collision/spatial_hashing/spatial_hashing_compact_query.h>
+
+#include <vector>
+
+namespace OpenTissue
+{
+  namespace spatial_hashing
+  {
+
+    template<typename compact_grid, typename collision_policy>
+    class CompactPointDataQuery 
+      : public CompactQuery< CompactPointDataQuery<compact_grid,collision_policy>, compact_grid, collision_policy >
+    {
+    public:
+
+      void keys(typename compact_grid::data_type const & data, std::vector<size_t> & keys)
+      {
+        typename compact_grid::point_type p = this->position(data);
+        keys.push_back( this->get_key(p) );
+      }
+
+    };
+
+  } // namespace spatial_hashing
+
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_SPATIAL_HASHING_HASH_QUERIES_SPATIAL_HASHING_COMPACT_POINT_DATA_QUERY_H
+#endif
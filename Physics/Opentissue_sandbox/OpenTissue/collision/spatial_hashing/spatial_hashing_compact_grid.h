@@ -0,0 +1,294 @@
+#ifndef OPENTISSUE_COLLISION_SPATIAL_HASHING_SPATIAL_HASHING_COMPACT_GRID_H
+#define OPENTISSUE_COLLISION_SPATIAL_HASHING_SPATIAL_HASHING_COMPACT_GRID_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <boost/iterator/indirect_iterator.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace spatial_hashing
+  {
+
+    /**
+    * Compact Hash Grid.
+    * This class stores the same infinite uniform 3D grid as the Grid class and
+    * uses the same hash functions, but the content of all hash cells are
+    * kept in one flat array. Each hash cell is a range in this array.
+    *
+    * The grid is filled in one go by the build method, which counting sorts
+    * all (hash key, data) entries by hash key. The counting and the scatter
+    * of the entries are done in parallel using OpenMP atomics. Cells are reset
+    * by a time-stamp, so only the hash cells actually used are touched when
+    * the grid is rebuilt.
+    *
+    * Unlike the Grid class the compact grid does not support adding or
+    * removing single data objects, it is meant for data that is rebuilt
+    * every time the data moves. Once build the grid is read-only, and any
+    * number of threads can query it concurrently.
+    *
+    * The hash function must support the same interface as required by the Grid
+    * class. Its operator() is invoked concurrently from multiple threads.
+    */
+    template <
+      typename real_vector3
+      , typename int_vector3
+      , typename data_type_
+      , typename hash_function_type
+    >
+    class CompactGrid
+    {
+    public:
+      typedef          data_type_                                   data_type;
+      typedef typename real_vector3::value_type                     real_type;
+      typedef          int_vector3                                  triplet_type;   ///< Type of discretized points.
+      typedef          real_vector3                                 point_type;     ///< Type of continuous points.
+
+    protected:
+
+      typedef std::vector<data_type*>                               data_ptr_container;
+      typedef typename data_ptr_container::const_iterator           const_data_ptr_iterator;
+      typedef std::vector<size_t>                                   index_container;
+
+    public:
+
+      typedef boost::indirect_iterator<const_data_ptr_iterator,data_type> data_iterator;
+
+    protected:
+
+      size_t                  m_time_stamp;       ///< Build time-stamp, a hash cell is empty unless its time-stamp equals this value.
+      real_type               m_delta;            ///< Grid cell spacing.
+      hash_function_type      m_hash_function;
+      index_container         m_cell_stamp;       ///< Time-stamp of the last build that used the hash cell.
+      index_container         m_cell_begin;       ///< Offset of the first entry of the hash cell.
+      index_container         m_cell_end;         ///< Offset one past the last entry of the hash cell.
+      index_container         m_touched;          ///< The hash cells used by the last build.
+      index_container         m_entries;          ///< Data indices of all entries sorted by hash cell.
+      data_ptr_container      m_data;             ///< Data pointers of all entries sorted by hash cell.
+
+    public:
+
+      CompactGrid( )
+        : m_time_stamp(0)
+        , m_delta(5.0)
+      {
+        resize(1000);
+      }
+
+      CompactGrid( size_t size )
+        : m_time_stamp(0)
+        , m_delta(5.0)
+      {
+        resize( size );
+      }
+
+    public:
+
+      void resize( size_t size )
+      {
+        m_hash_function.resize(size);
+        m_cell_stamp.assign( m_hash_function.size(), 0 );
+        m_cell_begin.assign( m_hash_function.size(), 0 );
+        m_cell_end.assign( m_hash_function.size(), 0 );
+        m_touched.clear();
+        m_entries.clear();
+        m_data.clear();
+        m_time_stamp = 0;
+      }
+
+      size_t size( ) const  { return m_hash_function.size(); }
+
+      /**
+      * Set Grid Cell Spacing.
+      * See Grid::set_spacing() for advice on how to pick the spacing.
+      *
+      * @param delta   The new grid cell spacing size, must be a positive number.
+      */
+      void set_spacing( real_type delta )
+      {
+        assert( delta > 0 );
+        m_delta = delta;
+      }
+
+      real_type get_spacing( ) const { return m_delta; }
+
+      /**
+      * Point Discretization.
+      *
+      * @param p   A 3D point in continious space
+      *
+      * @return    A discretized point identifying the grid
+      *            cell (not the hash cell!) which the contineous
+      *            point lies inside.
+      */
+      triplet_type get_triplet( point_type const & point )const
+      {
+        typedef typename triplet_type::value_type value_type;
+        assert( m_delta > 0 );
+        return triplet_type(
+          static_cast<value_type>( std::floor( point(0) / m_delta ) ),
+          static_cast<value_type>( std::floor( point(1) / m_delta ) ),
+          static_cast<value_type>( std::floor( point(2) / m_delta ) )
+          );
+      }
+
+      /**
+      * Find the hash key of the grid cell identified by the discretized point.
+      */
+      size_t get_key(triplet_type const & triplet)
+      {
+        return m_hash_function( triplet(0), triplet(1), triplet(2) );
+      }
+
+      /**
+      * Find the hash key of the grid cell enclosing the continuous point.
+      */
+      size_t get_key(point_type const & p)
+      {
+        return get_key( get_triplet(p) );
+      }
+
+      bool empty(size_t key) const
+      {
+        assert( key < m_cell_stamp.size() );
+        return m_cell_stamp[key] != m_time_stamp;
+      }
+
+      size_t size(size_t key) const
+      {
+        if(empty(key))
+          return 0;
+        return m_cell_end[key] - m_cell_begin[key];
+      }
+
+      data_iterator begin(size_t key) const
+      {
+        if(empty(key))
+          return data_iterator(m_data.end());
+        return data_iterator(m_data.begin() + m_cell_begin[key]);
+      }
+
+      data_iterator end(size_t key) const
+      {
+        if(empty(key))
+          return data_iterator(m_data.end());
+        return data_iterator(m_data.begin() + m_cell_end[key]);
+      }
+
+      void clear()
+      {
+        ++m_time_stamp; //--- Lazy deallocation
+        m_touched.clear();
+        m_entries.clear();
+        m_data.clear();
+      }
+
+      /**
+      * Build Grid.
+      * Any previous content of the grid is discarded.
+      *
+      * @param data      Pointers to the data objects.
+      * @param offsets   The hash keys of the i'th data object are keys[offsets[i]] to keys[offsets[i+1]-1].
+      *                  A data object must not list the same hash key twice.
+      * @param keys      The hash keys of all data objects.
+      */
+      void build(
+        data_ptr_container const & data
+        , index_container const & offsets
+        , index_container const & keys
+        )
+      {
+        assert( offsets.size() == data.size() + 1 || !"CompactGrid::build(): offsets and data do not match");
+        assert( offsets.back() == keys.size()     || !"CompactGrid::build(): offsets and keys do not match");
+
+        clear();
+
+        int const count = static_cast<int>( keys.size() );
+        int const objects = static_cast<int>( data.size() );
+
+        //--- The end offsets are used as counters, reset only those cells that will be used
+#pragma omp parallel for
+        for(int e = 0; e < count; ++e)
+        {
+#pragma omp atomic write
+          m_cell_end[ keys[e] ] = 0;
+        }
+
+        //--- Count the entries of every cell, the thread that sees a cell first records it as touched
+        size_t touched = 0;
+        m_touched.resize( keys.size() );
+#pragma omp parallel for
+        for(int e = 0; e < count; ++e)
+        {
+          size_t const key = keys[e];
+          size_t old;
+#pragma omp atomic capture
+          old = m_cell_end[key]++;
+          if(old == 0)
+          {
+            size_t slot;
+#pragma omp atomic capture
+            slot = touched++;
+            m_touched[slot] = key;
+          }
+        }
+        m_touched.resize( touched );
+
+        //--- Exclusive scan of the cell counts, sorting the touched cells keep the layout independent of the thread scheduling
+        std::sort( m_touched.begin(), m_touched.end() );
+        size_t offset = 0;
+        for(size_t i = 0; i < m_touched.size(); ++i)
+        {
+          size_t const key = m_touched[i];
+          size_t const cnt = m_cell_end[key];
+          m_cell_stamp[key] = m_time_stamp;
+          m_cell_begin[key] = offset;
+          m_cell_end[key]   = offset;
+          offset += cnt;
+        }
+
+        //--- Scatter the entries, the end offsets are used as insertion points
+        m_entries.resize( keys.size() );
+#pragma omp parallel for
+        for(int i = 0; i < objects; ++i)
+        {
+          for(size_t e = offsets[i]; e < offsets[i+1]; ++e)
+          {
+            size_t slot;
+#pragma omp atomic capture
+            slot = m_cell_end[ keys[e] ]++;
+            m_entries[slot] = i;
+          }
+        }
+
+        //--- Restore data order within each cell and resolve the data pointers
+        m_data.resize( keys.size() );
+        int const cells = static_cast<int>( m_touched.size() );
+#pragma omp parallel for
+        for(int c = 0; c < cells; ++c)
+        {
+          size_t const key = m_touched[c];
+          std::sort( m_entries.begin() + m_cell_begin[key], m_entries.begin() + m_cell_end[key] );
+          for(size_t e = m_cell_begin[key]; e < m_cell_end[key]; ++e)
+            m_data[e] = data[ m_entries[e] ];
+        }
+      }
+    };
+
+  } // namespace spatial_hashing
+
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_SPATIAL_HASHING_SPATIAL_HASHING_COMPACT_GRID_H
+#endif
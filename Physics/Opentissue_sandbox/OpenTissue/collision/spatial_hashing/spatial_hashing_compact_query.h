@@ -0,0 +1,344 @@
+#ifndef OPENTISSUE_COLLISION_SPATIAL_HASHING_SPATIAL_HASHING_COMPACT_QUERY_H
+#define OPENTISSUE_COLLISION_SPATIAL_HASHING_SPATIAL_HASHING_COMPACT_QUERY_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <boost/cast.hpp> // needed for boost::numeric_cast
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace spatial_hashing
+  {
+
+    /**
+    * Compact Spatial Query Class.
+    * This is the counterpart of the Query class for the CompactGrid. It uses
+    * the same collision_policy interface and report tags as the Query class.
+    *
+    * Data is mapped into the grid in parallel. The child type must implement
+    * the method
+    *
+    *   void keys(data_type const & data, std::vector<size_t> & keys)
+    *
+    * which appends the hash keys of all grid cells the data overlaps. A hash
+    * key may be appended more than once, duplicates are removed afterwards.
+    *
+    * Queries are batched, the query objects are split into chunks that are
+    * processed in parallel. Every chunk reports into its own result container,
+    * the chunk results are appended to the final results in the order of the
+    * query objects, so the results are the same as when queries are run one
+    * at a time. Hash collisions are guarded against by sorting the hash keys
+    * of a query rather than time-stamping the cells, so the grid is never
+    * written to during a query.
+    *
+    * Because of this the collision_policy methods (position, min_coord,
+    * max_coord, origin, destination and report) are invoked concurrently
+    * and must only modify the results container they are given. The
+    * result_container type must be default constructible and support
+    * insert(end(),first,last), like std::vector and std::list.
+    */
+    template<typename child_type,typename compact_grid, typename collision_policy>
+    class CompactQuery
+      : public compact_grid
+      , public collision_policy
+    {
+    protected:
+
+      typedef typename compact_grid::triplet_type     triplet_type;
+      typedef typename compact_grid::point_type       point_type;
+      typedef typename compact_grid::real_type        real_type;
+      typedef typename compact_grid::data_type        data_type;
+      typedef typename compact_grid::data_iterator    cell_data_iterator;
+      typedef std::vector<data_type*>                 data_ptr_container;
+      typedef std::vector<size_t>                     key_container;
+
+    protected:
+
+      data_ptr_container m_data_ptrs;   ///< The data mapped into the grid.
+      key_container      m_offsets;     ///< Offsets into m_keys for every data object.
+      key_container      m_keys;        ///< Hash keys of all data objects.
+      int                m_chunk_size;  ///< Number of queries handled by a thread at a time.
+
+    public:
+
+      struct no_collisions_tag {};   ///< See Query::no_collisions_tag.
+      struct all_tag {};             ///< See Query::all_tag.
+
+    public:
+
+      CompactQuery()
+        : m_chunk_size(256)
+      {}
+
+    public:
+
+      /**
+      * Full Query.
+      * This is a two-pass query. In first pass data is mapped into a grid, in the
+      * second pass query data is tested against content of overlapping grid cells.
+      *
+      * @param d0        Iterator to position of first data object.
+      * @param d1        Iterator to position one past last data object.
+      * @param q0        Iterator to position of first query object.
+      * @param q1        Iterator to position one past last query object.
+      * @param results   Upon return contains results of query.
+      * @param type      This argument specifies the report type, possible types are all_tag or no_collisions_tag.
+      */
+      template< typename data_iterator, typename query_iterator,typename result_container,typename report_type >
+      void operator()(
+        data_iterator d0
+        , data_iterator d1
+        , query_iterator q0
+        , query_iterator q1
+        , result_container & results
+        , report_type const & type
+        )
+      {
+        init_data(d0,d1);
+        (*this)(q0,q1,results,type);
+      }
+
+      /**
+      * Re-run query.
+      * This method reruns the query on any previous mapped data.
+      *
+      * @param q0        Iterator to position of first query object.
+      * @param q1        Iterator to position one past last query object.
+      * @param results   Upon return contains results of query.
+      * @param type      This argument specifies the report type, possible types are all_tag or no_collisions_tag.
+      */
+      template< typename query_iterator,typename result_container,typename report_type >
+      void operator()(
+        query_iterator q0
+        , query_iterator q1
+        , result_container & results
+        , report_type const & type
+        )
+      {
+        std::vector< typename std::iterator_traits<query_iterator>::value_type const * > queries;
+        for(query_iterator q=q0;q!=q1;++q)
+          queries.push_back( &(*q) );
+
+        this->reset(results);
+
+        int const count  = static_cast<int>( queries.size() );
+        int const chunks = (count + m_chunk_size - 1) / m_chunk_size;
+        std::vector<result_container> parts( chunks );
+
+#pragma omp parallel for schedule(dynamic)
+        for(int chunk = 0; chunk < chunks; ++chunk)
+        {
+          key_container keys;
+          data_ptr_container found;
+          result_container & part = parts[chunk];
+          this->reset(part);
+          int const last = std::min( count, (chunk+1)*m_chunk_size );
+          for(int i = chunk*m_chunk_size; i < last; ++i)
+            query( *queries[i], part, type, keys, found );
+        }
+
+        for(int chunk = 0; chunk < chunks; ++chunk)
+          results.insert( results.end(), parts[chunk].begin(), parts[chunk].end() );
+      }
+
+      /**
+      * Single Shoot Query.
+      * This method runs a single shoot query on any previous mapped data.
+      *
+      * @param q         Query data to perform query with.
+      * @param results   Upon return contains results of query.
+      * @param type      This argument specifies the report type, possible types are all_tag or no_collisions_tag.
+      */
+      template< typename query_type,typename result_container,typename report_type >
+      void operator()(
+        query_type const & q
+        , result_container & results
+        , report_type const & type
+        )
+      {
+        key_container keys;
+        data_ptr_container found;
+        this->reset(results);
+        query(q, results, type, keys, found );
+      }
+
+      /**
+      * Data Mapping.
+      * Clears the grid and maps the data into it. The hash keys of
+      * the data objects are computed in parallel.
+      *
+      * @param d0        Iterator to position of first data object.
+      * @param d1        Iterator to position one past last data object.
+      */
+      template< typename data_iterator  >
+      void init_data(  data_iterator d0, data_iterator d1 )
+      {
+        child_type & self = static_cast<child_type &>(*this);
+
+        m_data_ptrs.clear();
+        for(data_iterator data=d0;data!=d1;++data)
+          m_data_ptrs.push_back( const_cast<data_type*>( &(*data) ) );
+
+        int const count = static_cast<int>( m_data_ptrs.size() );
+        m_offsets.resize( count + 1 );
+        m_offsets[0] = 0;
+
+        //--- First pass counts the keys of every data object, second pass writes them
+#pragma omp parallel
+        {
+          key_container keys;
+#pragma omp for
+          for(int i = 0; i < count; ++i)
+          {
+            unique_keys( self, *m_data_ptrs[i], keys );
+            m_offsets[i+1] = keys.size();
+          }
+        }
+
+        for(int i = 0; i < count; ++i)
+          m_offsets[i+1] += m_offsets[i];
+        m_keys.resize( m_offsets[count] );
+
+#pragma omp parallel
+        {
+          key_container keys;
+#pragma omp for
+          for(int i = 0; i < count; ++i)
+          {
+            unique_keys( self, *m_data_ptrs[i], keys );
+            std::copy( keys.begin(), keys.end(), m_keys.begin() + m_offsets[i] );
+          }
+        }
+
+        this->build( m_data_ptrs, m_offsets, m_keys );
+      }
+
+      /**
+      * Set Chunk Size.
+      *
+      * @param size   The number of queries a thread handles at a time, must be positive.
+      */
+      void set_chunk_size(int size)
+      {
+        assert( size > 0 || !"CompactQuery::set_chunk_size(): size must be positive");
+        m_chunk_size = size;
+      }
+
+      int get_chunk_size() const { return m_chunk_size; }
+
+      /**
+      * Automatically Initialization of Settings.
+      * See Query::auto_init_settings().
+      *
+      * @param begin    Iterator to position of first query object.
+      * @param end      Iterator to position one past last query object.
+      */
+      template<typename iterator  >
+      void auto_init_settings ( iterator begin, iterator end)
+      {
+        using std::max;
+
+        size_t cnt = 0;
+        point_type mean;
+        mean.clear();
+
+        for(iterator cur = begin;cur!=end;++cur,++cnt)
+        {
+          point_type d = this->max_coord(*cur) - this->min_coord(*cur);//--- min_coord and max_coord by collision_policy
+          mean += d;
+        }
+        mean /= boost::numeric_cast<typename point_type::value_type>( cnt );
+        real_type spacing =  max (mean(0),  max( mean(1), mean(2) ) );
+        this->resize( cnt );
+        this->set_spacing( spacing  );
+      }
+
+    protected:
+
+      void unique_keys(child_type & self, data_type const & data, key_container & keys)
+      {
+        keys.clear();
+        self.keys( data, keys );
+        std::sort( keys.begin(), keys.end() );
+        keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+      }
+
+      /**
+      * Collect the keys of all non-empty hash cells overlapping the query.
+      */
+      template< typename query_type >
+      void query_keys(query_type const & query, key_container & keys)
+      {
+        point_type       min_corner = this->min_coord(query); //--- by collision_policy
+        point_type       max_corner = this->max_coord(query); //--- by collision_policy
+        triplet_type     m          = this->get_triplet(min_corner);
+        triplet_type     M          = this->get_triplet(max_corner);
+
+        assert( m(0) <= M(0) || !"Minimum was larger than maximum");
+        assert( m(1) <= M(1) || !"Minimum was larger than maximum");
+        assert( m(2) <= M(2) || !"Minimum was larger than maximum");
+
+        keys.clear();
+        triplet_type     triplet(m);
+        for ( triplet(0)= m(0) ; triplet(0) <= M(0); ++triplet(0) )
+          for ( triplet(1)= m(1) ; triplet(1) <= M(1); ++triplet(1) )
+            for ( triplet(2)= m(2) ; triplet(2) <= M(2); ++triplet(2) )
+            {
+              size_t key = this->get_key(triplet);
+              if(!this->empty(key))
+                keys.push_back(key);
+            }
+        std::sort( keys.begin(), keys.end() );
+        keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+      }
+
+      template< typename query_type,typename result_container >
+      void query(query_type const & query, result_container & results, no_collisions_tag, key_container & keys, data_ptr_container & found)
+      {
+        query_keys(query, keys);
+
+        found.clear();
+        for(size_t i = 0; i < keys.size(); ++i)
+        {
+          cell_data_iterator Dend = this->end(keys[i]);
+          for( cell_data_iterator data = this->begin(keys[i]); data!=Dend; ++data)
+            found.push_back( &(*data) );
+        }
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+        for(size_t i = 0; i < found.size(); ++i)
+          this->report( *found[i], query, results);
+      }
+
+      template< typename query_type,typename result_container >
+      void query(query_type const & query, result_container & results, all_tag, key_container & keys, data_ptr_container & /*found*/)
+      {
+        query_keys(query, keys);
+
+        for(size_t i = 0; i < keys.size(); ++i)
+        {
+          cell_data_iterator Dend = this->end(keys[i]);
+          for( cell_data_iterator data = this->begin(keys[i]); data!=Dend; ++data)
+            this->report( (*data), query, results);
+        }
+      }
+
+    };
+
+  } // namespace spatial_hashing
+} // namespace OpenTissue
+
+// OPENTISSUE_COLLISION_SPATIAL_HASHING_SPATIAL_HASHING_COMPACT_QUERY_H
+#endif
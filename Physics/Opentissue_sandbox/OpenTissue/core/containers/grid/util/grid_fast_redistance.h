@@ -0,0 +1,568 @@
+#ifndef OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_FAST_REDISTANCE_H
+#define OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_FAST_REDISTANCE_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace grid
+  {
+
+    namespace detail
+    {
+
+      /**
+      * Nodes are swept in cubic tiles of this many nodes along each axis.
+      */
+      static int const fast_sweeping_tile = 8;
+
+      /**
+      * Local Eikonal Update.
+      * Solves the Godunov upwind discretization of |\nabla d| = 1 at a node,
+      *
+      *   \sum_a \left( \frac{ (u - a_a)^+ }{ h_a } \right)^2 = 1
+      *
+      * where a_a is the smallest neighbor value along axis a and h_a is the
+      * spacing along the axis. Axes are added in order of increasing a_a
+      * until the solution is no larger than the next neighbor value.
+      *
+      * @param a      The smallest neighbor value along each axis, far if there is none.
+      * @param h      The grid spacing along each axis.
+      * @param far    Value used for unknown distances.
+      *
+      * @return       The solution u, or far if all neighbors are far.
+      */
+      template<typename real_type>
+      inline real_type eikonal_update(real_type const * a, real_type const * h, real_type const & far)
+      {
+        using std::sqrt;
+
+        real_type v[3] = { a[0], a[1], a[2] };
+        real_type w[3] = { h[0], h[1], h[2] };
+        for(int m = 1; m < 3; ++m)
+          for(int n = m; n > 0 && v[n] < v[n - 1]; --n)
+          {
+            std::swap( v[n], v[n - 1] );
+            std::swap( w[n], w[n - 1] );
+          }
+
+        if(v[0] >= far)
+          return far;
+
+        //--- Solve for s = u - v[0] to avoid cancellation in the discriminant
+        real_type s = w[0];
+        real_type A = real_type(0);
+        real_type B = real_type(0);
+        real_type C = real_type(-1);
+        for(int m = 0; m < 3; ++m)
+        {
+          real_type const b = v[m] - v[0];
+          if(m > 0 && s <= b)
+            break;
+          real_type const inv_h2 = real_type(1) / (w[m]*w[m]);
+          A += inv_h2;
+          B += b*inv_h2;
+          C += b*b*inv_h2;
+          real_type const discriminant = B*B - A*C;
+          s = ( B + sqrt( std::max( discriminant, real_type(0) ) ) ) / A;
+        }
+        return v[0] + s;
+      }
+
+      /**
+      * Initialize Distances at the Interface.
+      * Nodes with a neighbor of opposite sign get the distance to the plane
+      * through the linearly interpolated zero crossings along each axis, and
+      * are marked as fixed. Unused nodes are fixed at distance far, all other
+      * nodes are set to far.
+      *
+      * @param phi               The level set.
+      * @param d                 Upon return holds the unsigned distances at the interface.
+      * @param fixed             Upon return is non-zero for interface and unused nodes.
+      * @param far               Value used for unknown distances.
+      * @param interface_nodes   If not null, upon return holds the indices of the interface nodes in grid order.
+      */
+      template<typename grid_type, typename real_type>
+      inline void init_interface(
+        grid_type const & phi
+        , std::vector<real_type> & d
+        , std::vector<unsigned char> & fixed
+        , real_type const & far
+        , std::vector<int> * interface_nodes = 0
+        )
+      {
+        typedef typename grid_type::value_type  value_type;
+
+        int const I = static_cast<int>( phi.I() );
+        int const J = static_cast<int>( phi.J() );
+        int const K = static_cast<int>( phi.K() );
+        int const stride[3] = { 1, I, I*J };
+        real_type const h[3] = { real_type( phi.dx() ), real_type( phi.dy() ), real_type( phi.dz() ) };
+        value_type const unused = phi.unused();
+        value_type const * values = phi.data();
+
+        d.resize( I*J*K );
+        fixed.resize( I*J*K );
+
+        //--- Interface nodes are collected per z-slab, so the slabs can be processed in parallel
+        std::vector< std::vector<int> > slabs( interface_nodes ? K : 0 );
+
+#pragma omp parallel for
+        for(int k = 0; k < K; ++k)
+          for(int j = 0; j < J; ++j)
+            for(int i = 0; i < I; ++i)
+            {
+              int const coord[3] = { i, j, k };
+              int const size[3]  = { I, J, K };
+              int const idx = (k*J + j)*I + i;
+              value_type const center = values[idx];
+
+              d[idx] = far;
+              fixed[idx] = 0;
+              if(center == unused)
+              {
+                fixed[idx] = 1;
+                continue;
+              }
+              if(center == value_type(0))
+              {
+                d[idx] = real_type(0);
+                fixed[idx] = 1;
+                if(interface_nodes)
+                  slabs[k].push_back( idx );
+                continue;
+              }
+
+              real_type sum = real_type(0);
+              for(int axis = 0; axis < 3; ++axis)
+              {
+                real_type closest = far;
+                for(int side = -1; side <= 1; side += 2)
+                {
+                  int const n = coord[axis] + side;
+                  if(n < 0 || n >= size[axis])
+                    continue;
+                  value_type const neighbor = values[idx + side*stride[axis]];
+                  if(neighbor == unused)
+                    continue;
+                  if( (center > value_type(0)) == (neighbor > value_type(0)) && neighbor != value_type(0) )
+                    continue;
+                  real_type const t = real_type( center / (center - neighbor) );
+                  closest = std::min( closest, t*h[axis] );
+                }
+                if(closest < far)
+                  sum += real_type(1) / std::max( closest*closest, std::numeric_limits<real_type>::min() );
+              }
+              if(sum > real_type(0))
+              {
+                d[idx] = real_type(1) / std::sqrt(sum);
+                fixed[idx] = 1;
+                if(interface_nodes)
+                  slabs[k].push_back( idx );
+              }
+            }
+
+        if(interface_nodes)
+        {
+          interface_nodes->clear();
+          for(int k = 0; k < K; ++k)
+            interface_nodes->insert( interface_nodes->end(), slabs[k].begin(), slabs[k].end() );
+        }
+      }
+
+      /**
+      * Smallest neighbor distance along each axis.
+      */
+      template<typename real_type>
+      inline void upwind_neighbors(
+        real_type const * d
+        , int idx
+        , int i, int j, int k
+        , int I, int J, int K
+        , real_type const & far
+        , real_type * a
+        )
+      {
+        a[0] = std::min( i > 0 ? d[idx - 1]   : far, i < I - 1 ? d[idx + 1]   : far );
+        a[1] = std::min( j > 0 ? d[idx - I]   : far, j < J - 1 ? d[idx + I]   : far );
+        a[2] = std::min( k > 0 ? d[idx - I*J] : far, k < K - 1 ? d[idx + I*J] : far );
+      }
+
+      /**
+      * Sweep in a single direction.
+      * The grid is split into tiles. Along the sweep direction a tile only
+      * depends on the tiles before it, so all tiles on the same diagonal
+      * plane of tiles are independent and are swept in parallel. Inside a
+      * tile the nodes are visited in the sweep direction, so every node
+      * sees the updated values of all its upstream neighbors, just as in a
+      * sequential Gauss-Seidel sweep.
+      *
+      * The update of a node does not depend on the sweep direction, so a
+      * tile is skipped if neither the tile nor its neighbors changed during
+      * the previous sweep, and no upstream neighbor changed during this one.
+      *
+      * @param tolerance   Tiles with a decrease below this are not marked as changed.
+      * @param direction   Bit 0, 1 and 2 reverse the x, y and z order.
+      * @param active      Non-zero for every tile that should be swept.
+      * @param changed     Upon return is non-zero for every tile that changed.
+      *
+      * @return            The largest decrease of any distance.
+      */
+      template<typename real_type>
+      inline real_type sweep(
+        int I, int J, int K
+        , real_type const * h
+        , unsigned char const * fixed
+        , real_type * d
+        , real_type const & far
+        , real_type const & tolerance
+        , int direction
+        , unsigned char const * active
+        , unsigned char * changed
+        )
+      {
+        int const T  = fast_sweeping_tile;
+        int const TI = (I + T - 1)/T;
+        int const TJ = (J + T - 1)/T;
+        int const TK = (K + T - 1)/T;
+        bool const rx = (direction & 1) != 0;
+        bool const ry = (direction & 2) != 0;
+        bool const rz = (direction & 4) != 0;
+        int const tiles = TJ*TK;
+
+        real_type change = real_type(0);
+        for(int L = 0; L <= TI + TJ + TK - 3; ++L)
+        {
+#pragma omp parallel for schedule(dynamic,1) reduction(max:change)
+          for(int t = 0; t < tiles; ++t)
+          {
+            int const sj = t % TJ;
+            int const sk = t / TJ;
+            int const si = L - sj - sk;
+            if(si < 0 || si >= TI)
+              continue;
+
+            int const ti = rx ? TI - 1 - si : si;
+            int const tj = ry ? TJ - 1 - sj : sj;
+            int const tk = rz ? TK - 1 - sk : sk;
+            int const i0 = ti*T, i1 = std::min( i0 + T, I );
+            int const j0 = tj*T, j1 = std::min( j0 + T, J );
+            int const k0 = tk*T, k1 = std::min( k0 + T, K );
+            int const tile = (tk*TJ + tj)*TI + ti;
+
+            //--- Upstream tiles were swept before this tile, so their flags are from this sweep
+            int const ui = rx ? ti + 1 : ti - 1;
+            int const uj = ry ? tj + 1 : tj - 1;
+            int const uk = rz ? tk + 1 : tk - 1;
+            bool const run = active[tile]
+              || (ui >= 0 && ui < TI && changed[ (tk*TJ + tj)*TI + ui ])
+              || (uj >= 0 && uj < TJ && changed[ (tk*TJ + uj)*TI + ti ])
+              || (uk >= 0 && uk < TK && changed[ (uk*TJ + tj)*TI + ti ]);
+
+            changed[tile] = 0;
+            if(!run)
+              continue;
+
+            real_type tile_change = real_type(0);
+            for(int kk = k0; kk < k1; ++kk)
+            {
+              int const k = rz ? k0 + k1 - 1 - kk : kk;
+              for(int jj = j0; jj < j1; ++jj)
+              {
+                int const j = ry ? j0 + j1 - 1 - jj : jj;
+                for(int ii = i0; ii < i1; ++ii)
+                {
+                  int const i = rx ? i0 + i1 - 1 - ii : ii;
+                  int const idx = (k*J + j)*I + i;
+                  if(fixed[idx])
+                    continue;
+                  real_type a[3];
+                  upwind_neighbors( d, idx, i, j, k, I, J, K, far, a );
+                  real_type const u = eikonal_update( a, h, far );
+                  if(u < d[idx])
+                  {
+                    tile_change = std::max( tile_change, d[idx] - u );
+                    d[idx] = u;
+                  }
+                }
+              }
+            }
+            changed[tile] = tile_change > tolerance ? 1 : 0;
+            change = std::max( change, tile_change );
+          }
+        }
+        return change;
+      }
+
+      /**
+      * Activate all tiles that changed or have a neighbor that changed.
+      */
+      inline void activate_tiles(int TI, int TJ, int TK, unsigned char const * changed, unsigned char * active)
+      {
+#pragma omp parallel for
+        for(int tk = 0; tk < TK; ++tk)
+          for(int tj = 0; tj < TJ; ++tj)
+            for(int ti = 0; ti < TI; ++ti)
+            {
+              int const tile = (tk*TJ + tj)*TI + ti;
+              active[tile] = changed[tile]
+                || (ti > 0      && changed[tile - 1])
+                || (ti < TI - 1 && changed[tile + 1])
+                || (tj > 0      && changed[tile - TI])
+                || (tj < TJ - 1 && changed[tile + TI])
+                || (tk > 0      && changed[tile - TI*TJ])
+                || (tk < TK - 1 && changed[tile + TI*TJ]);
+            }
+      }
+
+      /**
+      * Update the tentative distances of the neighbors of a newly accepted
+      * node, using only accepted distances, and push the improved ones on
+      * the heap.
+      */
+      template<typename real_type, typename heap_type>
+      inline void fast_marching_neighbors(
+        int I, int J, int K
+        , real_type const * h
+        , unsigned char const * accepted
+        , real_type * d
+        , real_type const & far
+        , int idx
+        , heap_type & heap
+        )
+      {
+        int const i = idx % I;
+        int const j = (idx / I) % J;
+        int const k = idx / (I*J);
+        int const neighbors[6] = {
+            i > 0     ? idx - 1   : -1
+          , i < I - 1 ? idx + 1   : -1
+          , j > 0     ? idx - I   : -1
+          , j < J - 1 ? idx + I   : -1
+          , k > 0     ? idx - I*J : -1
+          , k < K - 1 ? idx + I*J : -1
+        };
+
+        for(int n = 0; n < 6; ++n)
+        {
+          int const m = neighbors[n];
+          if(m < 0 || accepted[m])
+            continue;
+
+          int const mi = m % I;
+          int const mj = (m / I) % J;
+          int const mk = m / (I*J);
+          int const around[6] = {
+              mi > 0     ? m - 1   : -1
+            , mi < I - 1 ? m + 1   : -1
+            , mj > 0     ? m - I   : -1
+            , mj < J - 1 ? m + I   : -1
+            , mk > 0     ? m - I*J : -1
+            , mk < K - 1 ? m + I*J : -1
+          };
+          real_type a[3] = { far, far, far };
+          for(int r = 0; r < 6; ++r)
+            if(around[r] >= 0 && accepted[ around[r] ])
+              a[r/2] = std::min( a[r/2], d[ around[r] ] );
+
+          real_type const u = eikonal_update( a, h, far );
+          if(u < d[m])
+          {
+            d[m] = u;
+            heap.push( typename heap_type::value_type( u, m ) );
+          }
+        }
+      }
+
+      /**
+      * Write the signed distances, unused nodes are kept unused.
+      */
+      template<typename grid_type, typename real_type>
+      inline void write_signed_distance(
+        grid_type const & phi
+        , std::vector<real_type> const & d
+        , real_type const & max_distance
+        , grid_type & psi
+        )
+      {
+        typedef typename grid_type::value_type  value_type;
+
+        if(&psi != &phi)
+          psi = phi;
+
+        value_type const unused = phi.unused();
+        value_type * values = psi.data();
+        int const N = static_cast<int>( d.size() );
+
+#pragma omp parallel for
+        for(int idx = 0; idx < N; ++idx)
+        {
+          value_type const v = values[idx];
+          if(v == unused)
+            continue;
+          value_type const distance = value_type( std::min( d[idx], max_distance ) );
+          if(v > value_type(0))
+            values[idx] = distance;
+          else if(v < value_type(0))
+            values[idx] = -distance;
+        }
+      }
+
+    } // namespace detail
+
+    /**
+    * Fast Sweeping Redistancing.
+    *
+    * Replaces a level set by the signed distance to its zero level set, like
+    * redistance(), but by solving the Eikonal equation |\nabla d| = 1
+    * directly with the fast sweeping method of Zhao. The cost is O(N) per
+    * iteration and a single iteration is usually enough.
+    *
+    * Distances at nodes next to the zero crossings are computed from the
+    * linearly interpolated crossings and kept fixed. The remaining nodes are
+    * updated by Gauss-Seidel sweeps of the Godunov upwind scheme in all
+    * eight diagonal orderings of the grid. Every sweep is done in parallel
+    * over independent tiles of the grid.
+    *
+    * Unused nodes are left unchanged and act as a boundary. Nodes that can
+    * not be reached from the zero level set get the largest representable
+    * distance.
+    *
+    * @param phi              Input level set.
+    * @param psi              Upon return holds the signed distance grid, may be the same grid as phi.
+    * @param max_iterations   The maximum number of iterations, each of eight sweeps.
+    *
+    * @return                 The number of iterations used.
+    */
+    template < typename grid_type >
+    inline size_t fast_sweeping_redistance(
+      grid_type const & phi
+      , grid_type & psi
+      , size_t max_iterations = 4
+      )
+    {
+      typedef typename grid_type::value_type    value_type;
+
+      int const I = static_cast<int>( phi.I() );
+      int const J = static_cast<int>( phi.J() );
+      int const K = static_cast<int>( phi.K() );
+      value_type const h[3] = { value_type( phi.dx() ), value_type( phi.dy() ), value_type( phi.dz() ) };
+      value_type const far = std::numeric_limits<value_type>::max();
+      value_type const tolerance = value_type(1e-3) * std::min( h[0], std::min( h[1], h[2] ) );
+
+      std::vector<value_type>     d;
+      std::vector<unsigned char>  fixed;
+      detail::init_interface( phi, d, fixed, far );
+
+      int const T  = detail::fast_sweeping_tile;
+      int const TI = (I + T - 1)/T;
+      int const TJ = (J + T - 1)/T;
+      int const TK = (K + T - 1)/T;
+      std::vector<unsigned char>  active( TI*TJ*TK, 1 );
+      std::vector<unsigned char>  changed( TI*TJ*TK, 0 );
+
+      size_t iteration = 0;
+      while(iteration < max_iterations)
+      {
+        ++iteration;
+        value_type change = value_type(0);
+        for(int direction = 0; direction < 8; ++direction)
+        {
+          change = std::max( change, detail::sweep( I, J, K, h, &fixed[0], &d[0], far, tolerance, direction, &active[0], &changed[0] ) );
+          detail::activate_tiles( TI, TJ, TK, &changed[0], &active[0] );
+        }
+        if(change <= tolerance)
+          break;
+      }
+
+      detail::write_signed_distance( phi, d, far, psi );
+      return iteration;
+    }
+
+    /**
+    * Narrow Band Fast Marching Redistancing.
+    *
+    * Computes the signed distance to the zero level set of phi, but only in
+    * a band around the zero level set. Distances are computed by the fast
+    * marching method of Sethian, starting from the nodes next to the zero
+    * crossings and accepting nodes in order of increasing distance until
+    * the band width is reached, so the cost of the marching is proportional
+    * to the number of nodes inside the band.
+    *
+    * Nodes outside the band get the band width as distance, with the sign
+    * of phi. Unused nodes are left unchanged.
+    *
+    * Only the marching is restricted to the band. Finding the zero crossings
+    * and writing the clamped distances are still parallel passes over the
+    * whole grid, and if psi is not phi then phi is copied into psi first.
+    * These passes do a small constant amount of work per node, but for a
+    * thin band in a large grid they can cost more than the marching.
+    *
+    * @param phi              Input level set.
+    * @param psi              Upon return holds the signed distance grid, may be the same grid as phi.
+    * @param band_width       The width of the band on each side of the zero level set.
+    */
+    template < typename grid_type, typename real_type >
+    inline void fast_marching_redistance(
+      grid_type const & phi
+      , grid_type & psi
+      , real_type const & band_width
+      )
+    {
+      typedef typename grid_type::value_type              value_type;
+      typedef std::pair<value_type, int>                  entry_type;
+      typedef std::priority_queue< entry_type, std::vector<entry_type>, std::greater<entry_type> > heap_type;
+
+      assert(band_width > real_type(0) || !"fast_marching_redistance(): band width must be positive");
+
+      int const I = static_cast<int>( phi.I() );
+      int const J = static_cast<int>( phi.J() );
+      int const K = static_cast<int>( phi.K() );
+      value_type const h[3] = { value_type( phi.dx() ), value_type( phi.dy() ), value_type( phi.dz() ) };
+      value_type const far  = std::numeric_limits<value_type>::max();
+      value_type const band = value_type( band_width );
+
+      std::vector<value_type>     d;
+      std::vector<unsigned char>  accepted;
+      std::vector<int>            interface_nodes;
+      detail::init_interface( phi, d, accepted, far, &interface_nodes );
+
+      heap_type heap;
+      for(size_t n = 0; n < interface_nodes.size(); ++n)
+        detail::fast_marching_neighbors( I, J, K, h, &accepted[0], &d[0], far, interface_nodes[n], heap );
+
+      while( !heap.empty() )
+      {
+        entry_type const top = heap.top();
+        heap.pop();
+        int const idx = top.second;
+        if(accepted[idx] || top.first != d[idx])
+          continue;
+        if(top.first > band)
+          break;
+        accepted[idx] = 1;
+        detail::fast_marching_neighbors( I, J, K, h, &accepted[0], &d[0], far, idx, heap );
+      }
+
+      detail::write_signed_distance( phi, d, band, psi );
+    }
+
+  } // namespace grid
+} // namespace OpenTissue
+
+// OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_FAST_REDISTANCE_H
+#endif
@@ -0,0 +1,692 @@
+#ifndef OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_MULTIGRID_POISSON_SOLVER_H
+#define OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_MULTIGRID_POISSON_SOLVER_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace grid
+  {
+
+    /**
+    * Multigrid Poisson Solver with Pure Von Neuman Boundary Conditions.
+    *
+    * Solves the same equation as poisson_solver(), that is
+    *
+    *   \nabla^2 \phi = W
+    *
+    * with \nabla phi = 0 on the boundary, where the Laplacian is discretized
+    * by central differences and values outside the grid are clamped onto the
+    * boundary. Unlike poisson_solver() the number of cycles needed to reach
+    * a given accuracy does not grow with the resolution of the grid.
+    *
+    * Clamping puts the boundary half a spacing outside the outermost nodes,
+    * so the nodes are treated as the centers of cells. The grid is coarsened
+    * by merging pairs of cells along every axis until the coarsest level is
+    * small. If an axis has an odd number of cells the last coarse cell is
+    * only half as wide, so every level keeps the cell widths and center
+    * positions of every axis and discretizes the Laplacian as a finite
+    * volume scheme on the resulting tensor product grid. Axes with a much
+    * larger spacing than the others are not coarsened until the spacings
+    * are similar, which keeps the pointwise smoother effective on
+    * anisotropic grids.
+    *
+    * A cycle smooths the error by red-black Gauss-Seidel sweeps, restricts
+    * the residual to the coarser level, solves for the correction there and
+    * adds the trilinear interpolation of the correction. All nodes of one
+    * color are independent, so every sweep runs in parallel over the
+    * z-slabs of the grid.
+    *
+    * The pure Neumann problem only has a solution if W sums to zero and the
+    * solution is unique up to a constant. The mean of W is therefore removed
+    * before solving, and the coarse grid corrections are kept at zero mean.
+    *
+    * Restriction is the volume weighted transpose of interpolation and the
+    * sweeps after the coarse grid correction are done in the opposite color
+    * order of the ones before it, so one V-cycle with equal numbers of pre
+    * and post sweeps from a zero initial guess is a symmetric operator that
+    * can be used as a preconditioner, see MultigridPreconditioner. F-cycles
+    * are not symmetric.
+    */
+    template < typename grid_type >
+    class MultigridPoissonSolver
+    {
+    public:
+
+      typedef typename grid_type::value_type            value_type;
+      typedef typename grid_type::math_types            math_types;
+      typedef typename math_types::real_type            real_type;
+
+      typedef enum { v_cycle, f_cycle } cycle_type;
+
+    protected:
+
+      /**
+      * The cells along one axis of a level.
+      */
+      class Axis
+      {
+      public:
+
+        int                      m_n;          ///< Number of cells.
+        std::vector<value_type>  m_position;   ///< Cell centers.
+        std::vector<value_type>  m_width;      ///< Cell widths.
+        std::vector<value_type>  m_minus;      ///< Coupling to the previous cell, one over width times distance, zero at the boundary.
+        std::vector<value_type>  m_plus;       ///< Coupling to the next cell, one over width times distance, zero at the boundary.
+
+        /**
+        * Interpolation from the next coarser level, cell f gets the value
+        * of coarse cell m_coarse[2f] with weight m_weight[2f] plus the
+        * value of coarse cell m_coarse[2f+1] with weight m_weight[2f+1].
+        */
+        std::vector<int>         m_coarse;
+        std::vector<value_type>  m_weight;
+      };
+
+      /**
+      * A level of the grid hierarchy.
+      */
+      class Level
+      {
+      public:
+
+        Axis                     m_x;        ///< Cells along the x-axis.
+        Axis                     m_y;        ///< Cells along the y-axis.
+        Axis                     m_z;        ///< Cells along the z-axis.
+        std::vector<value_type>  m_phi;      ///< The solution, on coarse levels the correction.
+        std::vector<value_type>  m_rhs;      ///< The right hand side.
+        std::vector<value_type>  m_res;      ///< The residual.
+
+        int size() const { return m_x.m_n*m_y.m_n*m_z.m_n; }
+      };
+
+      std::vector<Level>  m_levels;           ///< The hierarchy, level 0 is the finest.
+      cycle_type          m_cycle;            ///< The type of cycle.
+      unsigned int        m_pre_sweeps;       ///< Number of red-black sweeps before the coarse grid correction.
+      unsigned int        m_post_sweeps;      ///< Number of red-black sweeps after the coarse grid correction.
+      unsigned int        m_coarse_sweeps;    ///< Number of red-black sweeps on the coarsest level.
+      int                 m_coarsest_size;    ///< Levels with at most this many nodes are not coarsened further.
+
+    public:
+
+      MultigridPoissonSolver()
+        : m_cycle(v_cycle)
+        , m_pre_sweeps(2)
+        , m_post_sweeps(2)
+        , m_coarse_sweeps(32)
+        , m_coarsest_size(64)
+      {}
+
+    public:
+
+      void set_cycle(cycle_type const & cycle)               { m_cycle = cycle; }
+      void set_pre_sweeps(unsigned int const & sweeps)       { m_pre_sweeps = sweeps; }
+      void set_post_sweeps(unsigned int const & sweeps)      { m_post_sweeps = sweeps; }
+      void set_coarse_sweeps(unsigned int const & sweeps)    { m_coarse_sweeps = sweeps; }
+
+      cycle_type   get_cycle()         const { return m_cycle; }
+      unsigned int get_pre_sweeps()    const { return m_pre_sweeps; }
+      unsigned int get_post_sweeps()   const { return m_post_sweeps; }
+      unsigned int get_coarse_sweeps() const { return m_coarse_sweeps; }
+
+      /**
+      * Number of levels in the hierarchy.
+      */
+      size_t levels() const { return m_levels.size(); }
+
+      /**
+      * Initialize.
+      * Builds the grid hierarchy for grids with the same dimensions and
+      * spacing as the specified grid. This is done automatically by solve()
+      * if the dimensions have changed, if only the spacing has changed
+      * init() must be invoked explicitly.
+      *
+      * @param phi    A grid.
+      */
+      void init(grid_type const & phi)
+      {
+        m_levels.clear();
+
+        Level fine;
+        init_axis( static_cast<int>( phi.I() ), value_type( phi.dx() ), fine.m_x );
+        init_axis( static_cast<int>( phi.J() ), value_type( phi.dy() ), fine.m_y );
+        init_axis( static_cast<int>( phi.K() ), value_type( phi.dz() ), fine.m_z );
+        m_levels.push_back( fine );
+
+        while( true )
+        {
+          Level & level = m_levels.back();
+          if( level.size() <= m_coarsest_size || (level.m_x.m_n <= 2 && level.m_y.m_n <= 2 && level.m_z.m_n <= 2) )
+            break;
+
+          //--- Semi-coarsening, axes with a much larger spacing than the smallest are kept
+          value_type h_min = value_type(0);
+          Axis const * axes[3] = { &level.m_x, &level.m_y, &level.m_z };
+          for(int a = 0; a < 3; ++a)
+            if(axes[a]->m_n > 2 && (h_min == value_type(0) || axes[a]->m_width[0] < h_min))
+              h_min = axes[a]->m_width[0];
+          value_type const h_max = value_type(1.5)*h_min;
+
+          Level coarse;
+          coarsen_axis( level.m_x, level.m_x.m_width[0] <= h_max, coarse.m_x );
+          coarsen_axis( level.m_y, level.m_y.m_width[0] <= h_max, coarse.m_y );
+          coarsen_axis( level.m_z, level.m_z.m_width[0] <= h_max, coarse.m_z );
+          m_levels.push_back( coarse );
+        }
+
+        for(size_t l = 0; l < m_levels.size(); ++l)
+        {
+          Level & level = m_levels[l];
+          level.m_phi.assign( level.size(), value_type(0) );
+          level.m_rhs.assign( level.size(), value_type(0) );
+          level.m_res.assign( level.size(), value_type(0) );
+        }
+      }
+
+      /**
+      * Solve.
+      *
+      * @param phi              Contains initial guess for solution, and upon
+      *                         return contains the solution.
+      * @param W                The right hand side of the poisson equation.
+      * @param max_cycles       The maximum number of cycles.
+      * @param tolerance        The iteration stops when the norm of the residual
+      *                         is below tolerance times the norm of W.
+      *
+      * @return                 The number of cycles used.
+      */
+      unsigned int solve(
+        grid_type & phi
+        , grid_type const & W
+        , unsigned int max_cycles = 10
+        , real_type const & tolerance = real_type(1e-6)
+        )
+      {
+        assert(phi.size() == W.size() || !"MultigridPoissonSolver::solve(): phi and W must have the same dimensions");
+
+        if( m_levels.empty()
+          || m_levels[0].m_x.m_n != static_cast<int>( phi.I() )
+          || m_levels[0].m_y.m_n != static_cast<int>( phi.J() )
+          || m_levels[0].m_z.m_n != static_cast<int>( phi.K() ) )
+          init( phi );
+
+        Level & fine = m_levels[0];
+        int const N = fine.size();
+
+        value_type const * w = W.data();
+        value_type       * p = phi.data();
+#pragma omp parallel for
+        for(int idx = 0; idx < N; ++idx)
+        {
+          fine.m_rhs[idx] = w[idx];
+          fine.m_phi[idx] = p[idx];
+        }
+        remove_mean( fine, fine.m_rhs );
+
+        real_type const norm_rhs = norm( fine.m_rhs );
+
+        unsigned int cycles = 0;
+        while(cycles < max_cycles)
+        {
+          cycle( 0, m_cycle );
+          ++cycles;
+
+          residual( fine );
+          if( norm( fine.m_res ) <= tolerance*norm_rhs )
+            break;
+        }
+
+#pragma omp parallel for
+        for(int idx = 0; idx < N; ++idx)
+          p[idx] = fine.m_phi[idx];
+
+        return cycles;
+      }
+
+      /**
+      * Apply Cycle.
+      * Performs a single cycle from a zero initial guess, that is computes
+      * an approximation of the solution of
+      *
+      *   \nabla^2 \phi = W
+      *
+      * where phi and W are given as arrays in the layout of the grid used
+      * with init(). The mean of W is removed first.
+      *
+      * @param W       The right hand side.
+      * @param phi     Upon return holds the approximate solution.
+      */
+      template<typename vector_type>
+      void apply(vector_type const & W, vector_type & phi)
+      {
+        assert(!m_levels.empty() || !"MultigridPoissonSolver::apply(): init() was not invoked");
+
+        Level & fine = m_levels[0];
+        int const N = fine.size();
+#pragma omp parallel for
+        for(int idx = 0; idx < N; ++idx)
+        {
+          fine.m_rhs[idx] = W[idx];
+          fine.m_phi[idx] = value_type(0);
+        }
+        remove_mean( fine, fine.m_rhs );
+
+        cycle( 0, m_cycle );
+
+#pragma omp parallel for
+        for(int idx = 0; idx < N; ++idx)
+          phi[idx] = fine.m_phi[idx];
+      }
+
+    protected:
+
+      /**
+      * Set up n cells of width h.
+      */
+      static void init_axis(int n, value_type const & h, Axis & axis)
+      {
+        axis.m_n = n;
+        axis.m_position.resize( n );
+        axis.m_width.assign( n, h );
+        for(int i = 0; i < n; ++i)
+          axis.m_position[i] = h*i;
+        init_coupling( axis );
+      }
+
+      /**
+      * Compute the couplings between neighboring cells from their widths and positions.
+      */
+      static void init_coupling(Axis & axis)
+      {
+        int const n = axis.m_n;
+        axis.m_minus.assign( n, value_type(0) );
+        axis.m_plus.assign( n, value_type(0) );
+        for(int i = 0; i < n; ++i)
+        {
+          if(i > 0)
+            axis.m_minus[i] = value_type(1) / ( axis.m_width[i] * (axis.m_position[i] - axis.m_position[i - 1]) );
+          if(i < n - 1)
+            axis.m_plus[i]  = value_type(1) / ( axis.m_width[i] * (axis.m_position[i + 1] - axis.m_position[i]) );
+        }
+      }
+
+      /**
+      * Merge pairs of cells along an axis.
+      * Axes with two or fewer cells are never coarsened. Coarse cell centers
+      * are the mean of their children, fine cells interpolate linearly
+      * between the parent and the nearest other coarse cell, and coarse
+      * widths are chosen such that restriction preserves constants.
+      *
+      * @param fine     The fine axis, upon return holds the interpolation weights.
+      * @param merge    If false the coarse axis is a copy of the fine axis.
+      * @param coarse   Upon return holds the coarse axis.
+      */
+      static void coarsen_axis(Axis & fine, bool merge, Axis & coarse)
+      {
+        int const F = fine.m_n;
+        int const C = (merge && F > 2) ? (F + 1)/2 : F;
+
+        coarse.m_n = C;
+        coarse.m_position.assign( C, value_type(0) );
+        coarse.m_width.assign( C, value_type(0) );
+        for(int c = 0; c < C; ++c)
+        {
+          if(C == F)
+            coarse.m_position[c] = fine.m_position[c];
+          else if(2*c + 1 < F)
+            coarse.m_position[c] = ( fine.m_position[2*c] + fine.m_position[2*c + 1] ) / value_type(2);
+          else
+            coarse.m_position[c] = fine.m_position[2*c];
+        }
+
+        fine.m_coarse.resize( 2*F );
+        fine.m_weight.resize( 2*F );
+        for(int f = 0; f < F; ++f)
+        {
+          int const parent = (C == F) ? f : f/2;
+          value_type const x  = fine.m_position[f];
+          value_type const xp = coarse.m_position[parent];
+          int const neighbor  = (x < xp) ? parent - 1 : parent + 1;
+
+          fine.m_coarse[2*f]     = parent;
+          fine.m_weight[2*f]     = value_type(1);
+          fine.m_coarse[2*f + 1] = parent;
+          fine.m_weight[2*f + 1] = value_type(0);
+          if(x != xp && neighbor >= 0 && neighbor < C)
+          {
+            value_type const t = (x - xp) / (coarse.m_position[neighbor] - xp);
+            fine.m_weight[2*f]     = value_type(1) - t;
+            fine.m_coarse[2*f + 1] = neighbor;
+            fine.m_weight[2*f + 1] = t;
+          }
+        }
+
+        for(int f = 0; f < F; ++f)
+        {
+          coarse.m_width[ fine.m_coarse[2*f] ]     += fine.m_weight[2*f]     * fine.m_width[f];
+          coarse.m_width[ fine.m_coarse[2*f + 1] ] += fine.m_weight[2*f + 1] * fine.m_width[f];
+        }
+
+        init_coupling( coarse );
+      }
+
+      /**
+      * Weight of coarse cell c in the interpolation of fine cell f.
+      */
+      static value_type weight(Axis const & fine, int f, int c)
+      {
+        value_type w = value_type(0);
+        if(fine.m_coarse[2*f] == c)     w += fine.m_weight[2*f];
+        if(fine.m_coarse[2*f + 1] == c) w += fine.m_weight[2*f + 1];
+        return w;
+      }
+
+      /**
+      * Red-Black Gauss-Seidel Sweep.
+      * Updates all nodes with (i+j+k) % 2 == color, the slabs of constant
+      * k are processed in parallel.
+      */
+      static void sweep(Level & level, int color)
+      {
+        int const I = level.m_x.m_n;
+        int const J = level.m_y.m_n;
+        int const K = level.m_z.m_n;
+        value_type const * xm = &level.m_x.m_minus[0];
+        value_type const * xp = &level.m_x.m_plus[0];
+        value_type       * phi = &level.m_phi[0];
+        value_type const * rhs = &level.m_rhs[0];
+        int const sj = I;
+        int const sk = I*J;
+
+#pragma omp parallel for
+        for(int k = 0; k < K; ++k)
+        {
+          value_type const zm = level.m_z.m_minus[k];
+          value_type const zp = level.m_z.m_plus[k];
+          for(int j = 0; j < J; ++j)
+          {
+            value_type const ym = level.m_y.m_minus[j];
+            value_type const yp = level.m_y.m_plus[j];
+            value_type const diag_yz = ym + yp + zm + zp;
+
+            int const row = k*sk + j*sj;
+            for(int i = (j + k + color) & 1; i < I; i += 2)
+            {
+              int const idx = row + i;
+              value_type sum = value_type(0);
+              if(i > 0)     sum += xm[i]*phi[idx - 1];
+              if(i < I - 1) sum += xp[i]*phi[idx + 1];
+              if(j > 0)     sum += ym*phi[idx - sj];
+              if(j < J - 1) sum += yp*phi[idx + sj];
+              if(k > 0)     sum += zm*phi[idx - sk];
+              if(k < K - 1) sum += zp*phi[idx + sk];
+              value_type const diag = diag_yz + xm[i] + xp[i];
+              if(diag > value_type(0))
+                phi[idx] = (sum - rhs[idx]) / diag;
+            }
+          }
+        }
+      }
+
+      /**
+      * Compute res = rhs - \nabla^2 phi.
+      */
+      static void residual(Level & level)
+      {
+        int const I = level.m_x.m_n;
+        int const J = level.m_y.m_n;
+        int const K = level.m_z.m_n;
+        value_type const * xm = &level.m_x.m_minus[0];
+        value_type const * xp = &level.m_x.m_plus[0];
+        value_type const * phi = &level.m_phi[0];
+        value_type const * rhs = &level.m_rhs[0];
+        value_type       * res = &level.m_res[0];
+        int const sj = I;
+        int const sk = I*J;
+
+#pragma omp parallel for
+        for(int k = 0; k < K; ++k)
+        {
+          value_type const zm = level.m_z.m_minus[k];
+          value_type const zp = level.m_z.m_plus[k];
+          for(int j = 0; j < J; ++j)
+          {
+            value_type const ym = level.m_y.m_minus[j];
+            value_type const yp = level.m_y.m_plus[j];
+            int const row = k*sk + j*sj;
+            for(int i = 0; i < I; ++i)
+            {
+              int const idx = row + i;
+              value_type const center = phi[idx];
+              value_type laplace = value_type(0);
+              if(i > 0)     laplace += xm[i]*(phi[idx - 1]  - center);
+              if(i < I - 1) laplace += xp[i]*(phi[idx + 1]  - center);
+              if(j > 0)     laplace += ym*(phi[idx - sj] - center);
+              if(j < J - 1) laplace += yp*(phi[idx + sj] - center);
+              if(k > 0)     laplace += zm*(phi[idx - sk] - center);
+              if(k < K - 1) laplace += zp*(phi[idx + sk] - center);
+              res[idx] = rhs[idx] - laplace;
+            }
+          }
+        }
+      }
+
+      /**
+      * Restrict the residual of the fine level to the right hand side of the
+      * coarse level. The residual is weighted by the transpose of the
+      * interpolation and by the fine cell volumes, and divided by the coarse
+      * cell volume. Along a coarsened axis fine cells 2c-1 to 2c+2 contribute
+      * to coarse cell c.
+      */
+      static void restrict_residual(Level const & fine, Level & coarse)
+      {
+        int const I = fine.m_x.m_n;
+        int const J = fine.m_y.m_n;
+        int const CI = coarse.m_x.m_n;
+        int const CJ = coarse.m_y.m_n;
+        int const CK = coarse.m_z.m_n;
+        int const rx = (CI == I) ? 0 : 1;
+        int const ry = (CJ == J) ? 0 : 1;
+        int const rz = (CK == fine.m_z.m_n) ? 0 : 1;
+
+#pragma omp parallel for
+        for(int ck = 0; ck < CK; ++ck)
+        {
+          int const fk = ck << rz;
+          for(int cj = 0; cj < CJ; ++cj)
+          {
+            int const fj = cj << ry;
+            for(int ci = 0; ci < CI; ++ci)
+            {
+              int const fi = ci << rx;
+              value_type sum = value_type(0);
+              for(int k = std::max(fk - rz, 0); k <= std::min(fk + 2*rz, fine.m_z.m_n - 1); ++k)
+              {
+                value_type const az = weight( fine.m_z, k, ck ) * fine.m_z.m_width[k];
+                if(az == value_type(0)) continue;
+                for(int j = std::max(fj - ry, 0); j <= std::min(fj + 2*ry, J - 1); ++j)
+                {
+                  value_type const ay = weight( fine.m_y, j, cj ) * fine.m_y.m_width[j];
+                  if(ay == value_type(0)) continue;
+                  for(int i = std::max(fi - rx, 0); i <= std::min(fi + 2*rx, I - 1); ++i)
+                  {
+                    value_type const ax = weight( fine.m_x, i, ci ) * fine.m_x.m_width[i];
+                    sum += ax*ay*az*fine.m_res[ (k*J + j)*I + i ];
+                  }
+                }
+              }
+              value_type const volume = coarse.m_x.m_width[ci] * coarse.m_y.m_width[cj] * coarse.m_z.m_width[ck];
+              coarse.m_rhs[ (ck*CJ + cj)*CI + ci ] = sum / volume;
+            }
+          }
+        }
+      }
+
+      /**
+      * Add the trilinear interpolation of the coarse correction to the fine level.
+      */
+      static void interpolate_correction(Level const & coarse, Level & fine)
+      {
+        int const I = fine.m_x.m_n;
+        int const J = fine.m_y.m_n;
+        int const K = fine.m_z.m_n;
+        int const CI = coarse.m_x.m_n;
+        int const CJ = coarse.m_y.m_n;
+        Axis const & x = fine.m_x;
+        Axis const & y = fine.m_y;
+        Axis const & z = fine.m_z;
+        value_type const * e = &coarse.m_phi[0];
+
+#pragma omp parallel for
+        for(int k = 0; k < K; ++k)
+        {
+          for(int j = 0; j < J; ++j)
+          {
+            for(int i = 0; i < I; ++i)
+            {
+              value_type sum = value_type(0);
+              for(int c = 0; c < 2; ++c)
+              {
+                value_type const az = z.m_weight[2*k + c];
+                if(az == value_type(0)) continue;
+                int const ck = z.m_coarse[2*k + c];
+                for(int b = 0; b < 2; ++b)
+                {
+                  value_type const ay = y.m_weight[2*j + b];
+                  if(ay == value_type(0)) continue;
+                  int const row = (ck*CJ + y.m_coarse[2*j + b])*CI;
+                  sum += az*ay*( x.m_weight[2*i]*e[ row + x.m_coarse[2*i] ] + x.m_weight[2*i + 1]*e[ row + x.m_coarse[2*i + 1] ] );
+                }
+              }
+              fine.m_phi[ (k*J + j)*I + i ] += sum;
+            }
+          }
+        }
+      }
+
+      static real_type norm(std::vector<value_type> const & v)
+      {
+        int const N = static_cast<int>( v.size() );
+        real_type sum = real_type(0);
+#pragma omp parallel for reduction(+:sum)
+        for(int idx = 0; idx < N; ++idx)
+          sum += v[idx]*v[idx];
+        return std::sqrt(sum);
+      }
+
+      /**
+      * Subtract the volume weighted mean from a field on a level.
+      */
+      static void remove_mean(Level const & level, std::vector<value_type> & v)
+      {
+        int const I = level.m_x.m_n;
+        int const J = level.m_y.m_n;
+        int const K = level.m_z.m_n;
+        real_type sum    = real_type(0);
+        real_type volume = real_type(0);
+#pragma omp parallel for reduction(+:sum,volume)
+        for(int k = 0; k < K; ++k)
+          for(int j = 0; j < J; ++j)
+          {
+            value_type const area = level.m_y.m_width[j]*level.m_z.m_width[k];
+            for(int i = 0; i < I; ++i)
+            {
+              value_type const dV = area*level.m_x.m_width[i];
+              sum    += dV*v[ (k*J + j)*I + i ];
+              volume += dV;
+            }
+          }
+        value_type const mean = value_type( sum / volume );
+        int const N = static_cast<int>( v.size() );
+#pragma omp parallel for
+        for(int idx = 0; idx < N; ++idx)
+          v[idx] -= mean;
+      }
+
+      /**
+      * Perform a cycle on level l, the right hand side and the initial
+      * guess must have been set.
+      */
+      void cycle(size_t l, cycle_type type)
+      {
+        Level & level = m_levels[l];
+
+        if(l + 1 == m_levels.size())
+        {
+          //--- Coarsest level, alternate the color order to keep the sweeps symmetric
+          for(unsigned int s = 0; s < m_coarse_sweeps; ++s)
+          {
+            sweep( level, (s % 2) ? 1 : 0 );
+            sweep( level, (s % 2) ? 0 : 1 );
+          }
+          remove_mean( level, level.m_phi );
+          return;
+        }
+
+        for(unsigned int s = 0; s < m_pre_sweeps; ++s)
+        {
+          sweep( level, 0 );
+          sweep( level, 1 );
+        }
+
+        residual( level );
+        Level & coarse = m_levels[l + 1];
+        restrict_residual( level, coarse );
+        remove_mean( coarse, coarse.m_rhs );
+        std::fill( coarse.m_phi.begin(), coarse.m_phi.end(), value_type(0) );
+
+        cycle( l + 1, type );
+        if(type == f_cycle)
+          cycle( l + 1, v_cycle );
+
+        interpolate_correction( coarse, level );
+
+        for(unsigned int s = 0; s < m_post_sweeps; ++s)
+        {
+          sweep( level, 1 );
+          sweep( level, 0 );
+        }
+      }
+
+    };
+
+    /**
+    * Multigrid Poisson Solver.
+    * Convenience function, see MultigridPoissonSolver.
+    *
+    * @param phi              Contains initial guess for solution, and upon
+    *                         return contains the solution.
+    * @param W                The right hand side of the poisson equation.
+    * @param max_cycles       The maximum number of V-cycles. Default is 10 cycles.
+    * @param tolerance        Relative tolerance on the norm of the residual.
+    *
+    * @return                 The number of cycles used.
+    */
+    template < typename grid_type >
+    inline unsigned int multigrid_poisson_solver(
+      grid_type & phi
+      , grid_type const & W
+      , unsigned int max_cycles = 10
+      , typename grid_type::math_types::real_type const & tolerance = 1e-6
+      )
+    {
+      MultigridPoissonSolver<grid_type> solver;
+      return solver.solve( phi, W, max_cycles, tolerance );
+    }
+
+  } // namespace grid
+} // namespace OpenTissue
+
+// OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_MULTIGRID_POISSON_SOLVER_H
+#endif
@@ -0,0 +1,146 @@
+#ifndef OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_MULTIGRID_PRECONDITIONER_H
+#define OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_MULTIGRID_PRECONDITIONER_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/containers/grid/util/grid_multigrid_poisson_solver.h>
+
+namespace OpenTissue
+{
+  namespace grid
+  {
+
+    /**
+    * Poisson Matrix.
+    * Assembles the matrix A = -\nabla^2 of the discretization used by
+    * poisson_solver() and MultigridPoissonSolver, such that the Poisson
+    * equation \nabla^2 \phi = W becomes A \phi = -W. The matrix is
+    * symmetric positive semi-definite, its null space is the constant
+    * vectors. Rows and columns are ordered like the nodes of the grid.
+    *
+    * @param grid    A grid with the dimensions and spacing of the problem.
+    * @param A       Upon return holds the matrix.
+    */
+    template < typename grid_type, typename matrix_type >
+    inline void poisson_matrix(grid_type const & grid, matrix_type & A)
+    {
+      typedef typename grid_type::value_type  value_type;
+
+      int const I = static_cast<int>( grid.I() );
+      int const J = static_cast<int>( grid.J() );
+      int const K = static_cast<int>( grid.K() );
+      int const N = I*J*K;
+      value_type const wx = value_type( 1.0 / (grid.dx()*grid.dx()) );
+      value_type const wy = value_type( 1.0 / (grid.dy()*grid.dy()) );
+      value_type const wz = value_type( 1.0 / (grid.dz()*grid.dz()) );
+
+      A.resize( N, N, false );
+      A.clear();
+      A.reserve( 7*N );
+
+      //--- Entries are inserted in row major order, which is the cheap way to fill a compressed matrix
+      for(int k = 0; k < K; ++k)
+        for(int j = 0; j < J; ++j)
+          for(int i = 0; i < I; ++i)
+          {
+            int const idx = (k*J + j)*I + i;
+            value_type diag = value_type(0);
+            if(k > 0)     diag += wz;
+            if(j > 0)     diag += wy;
+            if(i > 0)     diag += wx;
+            if(i < I - 1) diag += wx;
+            if(j < J - 1) diag += wy;
+            if(k < K - 1) diag += wz;
+
+            if(k > 0)     A.push_back( idx, idx - I*J, -wz );
+            if(j > 0)     A.push_back( idx, idx - I,   -wy );
+            if(i > 0)     A.push_back( idx, idx - 1,   -wx );
+            A.push_back( idx, idx, diag );
+            if(i < I - 1) A.push_back( idx, idx + 1,   -wx );
+            if(j < J - 1) A.push_back( idx, idx + I,   -wy );
+            if(k < K - 1) A.push_back( idx, idx + I*J, -wz );
+          }
+    }
+
+    /**
+    * Multigrid Preconditioner.
+    * A preconditioner for the matrix assembled by poisson_matrix(), with the
+    * interface used by math::big::gmres() and math::big::conjugate_gradient().
+    * Applying the preconditioner performs a single V-cycle of
+    * MultigridPoissonSolver from a zero initial guess. With equal numbers of
+    * pre and post sweeps the V-cycle is a symmetric operator, so it can be
+    * used with the conjugate gradient method. F-cycles are not symmetric and
+    * are therefore not supported.
+    *
+    * Example usage:
+    *
+    *   poisson_matrix(phi, A);
+    *   MultigridPreconditioner<grid_type> P(phi);
+    *   math::big::conjugate_gradient(A, x, b, max_iterations, epsilon, iterations, P);
+    *
+    * The right hand side b must sum to zero.
+    */
+    template < typename grid_type >
+    class MultigridPreconditioner
+    {
+    public:
+
+      typedef MultigridPoissonSolver<grid_type>   solver_type;
+
+    protected:
+
+      mutable solver_type m_solver;    ///< The levels are work space, so they are modified by the const application.
+
+    public:
+
+      /**
+      * Initialize.
+      *
+      * @param grid    A grid with the dimensions and spacing of the problem.
+      */
+      MultigridPreconditioner(grid_type const & grid)
+      {
+        m_solver.set_cycle( solver_type::v_cycle );
+        m_solver.init( grid );
+      }
+
+    public:
+
+      solver_type       & solver()       { return m_solver; }
+      solver_type const & solver() const { return m_solver; }
+
+      /**
+      * Apply Preconditioner.
+      *
+      * @param A    The matrix, not used, the levels are given by the grid.
+      * @param e    Upon return holds the approximate solution of A e = r.
+      * @param r    The residual.
+      */
+      template<typename matrix_type, typename vector_type>
+      void operator()(
+        matrix_type const & /*A*/
+        , vector_type & e
+        , vector_type const & r
+        ) const
+      {
+        assert( m_solver.get_cycle() == solver_type::v_cycle                || !"MultigridPreconditioner(): only the V-cycle is symmetric");
+        assert( m_solver.get_pre_sweeps() == m_solver.get_post_sweeps()    || !"MultigridPreconditioner(): pre and post sweeps must be equal for a symmetric cycle");
+
+        //--- A = -nabla^2, so A e = r is the same as nabla^2 e = -r
+        vector_type W( -r );
+        m_solver.apply( W, e );
+      }
+    };
+
+  } // namespace grid
+} // namespace OpenTissue
+
+// OPENTISSUE_CORE_CONTAINERS_GRID_UTIL_GRID_MULTIGRID_PRECONDITIONER_H
+#endif
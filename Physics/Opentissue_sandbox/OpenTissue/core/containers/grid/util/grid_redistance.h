@@ -344,6 +344,9 @@ namespace OpenTissue
     * Calculates gradient magnitude of phi using upwind-scheme.
     * Performs PDE update using forward Euler time discretization.
     *
+    * See fast_sweeping_redistance() and fast_marching_redistance() for
+    * faster alternatives that solve the Eikonal equation directly.
+    *
     * @param phi              Input level set that should be redistanced into a signed distance grid.
     * @param psi              Output level set. That is the redistanced phi.
     * @param max_iterations   The maximum number of iterations allowed to do re-initialization.
@@ -28,6 +28,10 @@
 #include <OpenTissue/core/math/big/big_prod_trans.h>
 #include <OpenTissue/core/math/big/big_residual.h>
 
+// Native compressed row and block compressed row matrices with parallel products
+#include <OpenTissue/core/math/big/big_csr_matrix.h>
+#include <OpenTissue/core/math/big/big_bcsr_matrix.h>
+
 // 2007-10-12 kenny: Advanced tools for working with a Shur System
 #include <OpenTissue/core/math/big/big_shur_system.h>
 
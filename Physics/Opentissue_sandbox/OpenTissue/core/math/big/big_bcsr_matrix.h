@@ -0,0 +1,374 @@
+#ifndef OPENTISSUE_CORE_MATH_BIG_BCSR_MATRIX_H
+#define OPENTISSUE_CORE_MATH_BIG_BCSR_MATRIX_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
+
+#include <boost/align/aligned_allocator.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace math
+  {
+    namespace big
+    {
+
+      /**
+      * Block Compressed Sparse Row Matrix.
+      * Stores a sparse matrix as dense N-by-N blocks, only the block columns
+      * and the offsets of the block rows are kept, so there is one index per
+      * N*N values and the products of a block run on contiguous memory.
+      * Matrices from systems with N degrees of freedom per body or node, such
+      * as the Jacobians of rigid bodies or the stiffness matrices of
+      * deformable models, are well suited.
+      *
+      * The number of rows and columns must be multiples of N. Entries of a
+      * block that are not present in the compressed matrix are stored as zero.
+      *
+      * The matrix can be used everywhere a compressed_matrix is accepted by
+      * prod(), prod_add(), prod_sub(), prod_trans(), prod_add_rhs(),
+      * prod_sub_rhs() and residual(), and thereby also with
+      * conjugate_gradient() and gmres().
+      */
+      template<typename T, int N>
+      class BCSRMatrix
+      {
+      public:
+
+        typedef T                                                                  value_type;
+        typedef std::size_t                                                        size_type;
+        typedef std::vector< T, boost::alignment::aligned_allocator<T, 64> >        value_container;
+        typedef std::vector< int >                                                 index_container;
+
+        enum { block_size = N };
+
+      protected:
+
+        size_type        m_size1;     ///< Number of rows.
+        size_type        m_size2;     ///< Number of columns.
+        index_container  m_offsets;   ///< The blocks of block row I are m_offsets[I] to m_offsets[I+1]-1.
+        index_container  m_columns;   ///< Block column of every block, sorted within each block row.
+        value_container  m_values;    ///< Entry (r,c) of block k is m_values[N*N*k + N*r + c].
+
+      public:
+
+        BCSRMatrix()
+          : m_size1(0)
+          , m_size2(0)
+          , m_offsets(1, 0)
+        {}
+
+        explicit BCSRMatrix(ublas::compressed_matrix<T> const & A)
+          : m_size1(0)
+          , m_size2(0)
+          , m_offsets(1, 0)
+        {
+          assign(A);
+        }
+
+      public:
+
+        size_type size1()  const { return m_size1; }
+        size_type size2()  const { return m_size2; }
+        size_type blocks() const { return m_columns.size(); }
+
+        index_container const & index1_data() const { return m_offsets; }
+        index_container const & index2_data() const { return m_columns; }
+        value_container const & value_data()  const { return m_values;  }
+        value_container       & value_data()        { return m_values;  }
+
+        /**
+        * Get Entry.
+        *
+        * @return   The value of entry (i,j), zero if it is not stored.
+        */
+        T operator()(size_type i, size_type j) const
+        {
+          assert(i < m_size1 || !"BCSRMatrix::operator(): row index out of range");
+          assert(j < m_size2 || !"BCSRMatrix::operator(): column index out of range");
+
+          int const k = find( static_cast<int>(i / N), static_cast<int>(j / N) );
+          if(k < 0)
+            return T();
+          return m_values[ static_cast<size_type>(k)*N*N + (i % N)*N + (j % N) ];
+        }
+
+        /**
+        * Find Block.
+        *
+        * @return   The index of block (I,J) or -1 if the block is not stored.
+        */
+        int find(int I, int J) const
+        {
+          int lo = m_offsets[I];
+          int hi = m_offsets[I+1];
+          while(lo < hi)
+          {
+            int const mid = (lo + hi) / 2;
+            if(m_columns[mid] < J)
+              lo = mid + 1;
+            else
+              hi = mid;
+          }
+          return (lo < m_offsets[I+1] && m_columns[lo] == J) ? lo : -1;
+        }
+
+        /**
+        * Assign.
+        * Copies the structure and values of a compressed matrix, every non-zero
+        * entry brings in the whole block it belongs to.
+        *
+        * @param A   The compressed matrix, the number of rows and columns must be multiples of N.
+        */
+        void assign(ublas::compressed_matrix<T> const & A)
+        {
+          if(A.size1() % N != 0 || A.size2() % N != 0)
+            throw std::invalid_argument("BCSRMatrix::assign(): the dimensions of A must be multiples of the block size");
+
+          m_size1 = A.size1();
+          m_size2 = A.size2();
+
+          int const R      = static_cast<int>( m_size1 / N );
+          int const filled = static_cast<int>( A.filled1() - 1 );
+
+          //--- Find the distinct block columns of every block row
+          std::vector< index_container > row_columns( R );
+#pragma omp parallel for
+          for(int I = 0; I < R; ++I)
+          {
+            index_container & columns = row_columns[I];
+            for(int i = I*N; i < (I+1)*N && i < filled; ++i)
+              for(size_type k = A.index1_data()[i]; k < A.index1_data()[i+1]; ++k)
+                columns.push_back( static_cast<int>( A.index2_data()[k] / N ) );
+            std::sort( columns.begin(), columns.end() );
+            columns.erase( std::unique( columns.begin(), columns.end() ), columns.end() );
+          }
+
+          m_offsets.resize( R + 1 );
+          m_offsets[0] = 0;
+          for(int I = 0; I < R; ++I)
+            m_offsets[I+1] = m_offsets[I] + static_cast<int>( row_columns[I].size() );
+
+          m_columns.resize( m_offsets[R] );
+          m_values.assign( static_cast<size_type>( m_offsets[R] )*N*N, T() );
+
+#pragma omp parallel for
+          for(int I = 0; I < R; ++I)
+          {
+            std::copy( row_columns[I].begin(), row_columns[I].end(), m_columns.begin() + m_offsets[I] );
+            for(int i = I*N; i < (I+1)*N && i < filled; ++i)
+              for(size_type k = A.index1_data()[i]; k < A.index1_data()[i+1]; ++k)
+              {
+                size_type const j = A.index2_data()[k];
+                int const b = find( I, static_cast<int>(j / N) );
+                m_values[ static_cast<size_type>(b)*N*N + (i % N)*N + (j % N) ] = A.value_data()[k];
+              }
+          }
+        }
+
+      };
+
+      /**
+      * Compute y = prod(A,x)
+      */
+      template<typename T, int N>
+      inline void prod(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod(): incompatible dimensions");
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(0), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(A,x)*s
+      */
+      template<typename T, int N>
+      inline void prod(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , T const & s
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod(): incompatible dimensions");
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , s, T(0), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y += prod(A,x)
+      */
+      template<typename T, int N>
+      inline void prod_add(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_add(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod_add(): incompatible dimensions");
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(1), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y += prod(A,x)*s
+      */
+      template<typename T, int N>
+      inline void prod_add(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , T const & s
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_add(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod_add(): incompatible dimensions");
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , s, T(1), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y -= prod(A,x)
+      */
+      template<typename T, int N>
+      inline void prod_sub(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_sub(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod_sub(): incompatible dimensions");
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(-1), T(1), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(A,x) + b
+      */
+      template<typename T, int N>
+      inline void prod_add_rhs(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_add_rhs(): incompatible dimensions");
+        assert(A.size1() ==  b.size() || !"prod_add_rhs(): incompatible dimensions");
+
+        if(y.size() != b.size())
+          y.resize(b.size(), false );
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(0), b.data().begin(), T(1), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(A,x) - b
+      */
+      template<typename T, int N>
+      inline void prod_sub_rhs(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_sub_rhs(): incompatible dimensions");
+        assert(A.size1() ==  b.size() || !"prod_sub_rhs(): incompatible dimensions");
+
+        if(y.size() != b.size())
+          y.resize(b.size(), false );
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(0), b.data().begin(), T(-1), y.data().begin() );
+      }
+
+      /**
+      * Compute r = b - prod(A,x)
+      */
+      template<typename T, int N>
+      inline void residual(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & r
+        )
+      {
+        assert(A.size2() ==  x.size() || !"residual(): incompatible dimensions");
+        assert(A.size1() ==  b.size() || !"residual(): incompatible dimensions");
+
+        if(r.size() != b.size())
+          r.resize(b.size(), false );
+
+        detail::bcsr_prod<N>( A.size1()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(-1), T(0), b.data().begin(), T(1), r.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(trans(A),x)
+      */
+      template<typename T, int N>
+      inline void prod_trans(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size1() ==  x.size() || !"prod_trans(): incompatible dimensions");
+        assert(A.size2() ==  y.size() || !"prod_trans(): incompatible dimensions");
+
+        detail::bcsr_prod_trans<N>( A.size1()/N, A.size2()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , static_cast<T const *>(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(trans(A),x) + b
+      */
+      template<typename T, int N>
+      inline void prod_trans(
+          BCSRMatrix<T,N> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size1() ==  x.size() || !"prod_trans(): incompatible dimensions");
+        assert(A.size2() ==  y.size() || !"prod_trans(): incompatible dimensions");
+        assert(b.size()  ==  y.size() || !"prod_trans(): incompatible dimensions");
+
+        detail::bcsr_prod_trans<N>( A.size1()/N, A.size2()/N, A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , b.data().begin(), y.data().begin() );
+      }
+
+    } // end namespace big
+  } // end namespace math
+} // end namespace OpenTissue
+// OPENTISSUE_CORE_MATH_BIG_BCSR_MATRIX_H
+#endif
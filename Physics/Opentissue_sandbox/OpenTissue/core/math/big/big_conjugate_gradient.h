@@ -10,6 +10,8 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/core/math/big/big_types.h>  
+#include <OpenTissue/core/math/big/big_prod.h>
+#include <OpenTissue/core/math/big/big_residual.h>
 #include <OpenTissue/core/math/math_value_traits.h>  
 
 #include <boost/cast.hpp>             // needed for boost::numeric_cast
@@ -30,6 +32,10 @@ namespace OpenTissue
       * This implementation is based on code from Gunther Winkler.
       * See: http://www-user.tu-chemnitz.de/~wgu/ublas/matrix_sparse_usage.html
       *
+      * The matrix vector products are done by prod() and residual(), so
+      * compressed matrices, CSRMatrix and BCSRMatrix use the parallel
+      * kernels, any other matrix type falls back on ublas::axpy_prod.
+      *
       *
       * @param A                 A symmetric positive definite matrix.
       * @param x                 Upon return this argument holds a the solution to the system A x = b
@@ -81,8 +87,7 @@ namespace OpenTissue
         value_type alpha, alpha2, beta, gamma;
 
         // r = b - prod(A, x);
-        ublas::noalias( r ) = b;
-        ublas::axpy_prod( A, -x, r, false );
+        residual( A, x, b, r );
 
         ublas::noalias( g ) = r;
         alpha2 = ublas::inner_prod( r, r );
@@ -94,7 +99,7 @@ namespace OpenTissue
         while ( ( iterations < max_iterations ) && ( alpha2 > threshold ) )
         {
           // d = prod(A, g);
-          ublas::axpy_prod( A, g, d, true );
+          prod( A, g, d );
 
           gamma = ublas::inner_prod( g, d );
           alpha = alpha2;
@@ -111,6 +116,103 @@ namespace OpenTissue
         }       
       }
 
+      /**
+      * Preconditioned Conjugate Gradient Solver.
+      *
+      * The preconditioner has the same interface as the one used by gmres(),
+      * that is P(A,z,r) computes an approximation z of the solution of A z = r.
+      * It must be a fixed symmetric positive definite operator, for instance
+      * a single symmetric multigrid cycle.
+      *
+      * @param A                 A symmetric positive definite matrix.
+      * @param x                 Upon return this argument holds a the solution to the system A x = b
+      * @param b                 The right hand side vector.
+      * @param max_iterations    The maximum number of iterates allowed.
+      * @param epsilon           The stopping threshold to be used, relative to the initial residual.
+      * @param iterations        Upon return this argument holds the number of used iterations.
+      * @param P                 A preconditioner.
+      */
+      template<typename matrix_type, typename vector_type, typename preconditioner_type>
+      inline void conjugate_gradient(
+        matrix_type const & A
+        , vector_type & x
+        , vector_type const & b
+        , size_t const & max_iterations
+        , typename vector_type::value_type const & epsilon
+        , size_t & iterations
+        , preconditioner_type const & P
+        )
+      {
+        typedef typename vector_type::value_type           value_type;
+        typedef typename vector_type::size_type            size_type;
+        typedef OpenTissue::math::ValueTraits<value_type>  value_traits;
+
+        if(max_iterations <= 0)
+          throw std::invalid_argument("Max iterations should be positive" );
+
+        if(epsilon <= value_traits::zero())
+          throw std::invalid_argument("epsilon should be positive" );
+
+        if(A.size1() <= 0 || A.size2() <= 0)
+          throw std::invalid_argument("A was empty");
+
+        if(b.size() != A.size1())
+          throw std::invalid_argument("The size of b must be the same as the number of rows in A");
+
+        if(x.size() != A.size2())
+          throw std::invalid_argument("The size of x must be the same as the number of columns in A");
+
+        if(A.size1() != A.size2())
+          throw std::invalid_argument("A is not quadratic");
+
+        iterations = 0;
+
+        size_type const size = x.size();
+
+        vector_type r( size ); ///< Residual vector.
+        vector_type z( size ); ///< Preconditioned residual.
+        vector_type g( size ); ///< Search direction.
+        vector_type d( size ); ///< The product A*g.
+
+        value_type alpha, rz, rz_old, beta, gamma;
+
+        // r = b - prod(A, x);
+        residual( A, x, b, r );
+
+        P( A, z, r );
+        ublas::noalias( g ) = z;
+        rz = ublas::inner_prod( r, z );
+
+        value_type rr = ublas::inner_prod( r, r );
+
+        ++iterations;
+
+        value_type const threshold = epsilon * epsilon * rr;
+
+        while ( ( iterations < max_iterations ) && ( rr > threshold ) )
+        {
+          // d = prod(A, g);
+          prod( A, g, d );
+
+          gamma = ublas::inner_prod( g, d );
+          alpha = rz / gamma;
+
+          ublas::noalias( x ) +=  alpha * g;
+          ublas::noalias( r ) += -alpha * d;
+
+          rr = ublas::inner_prod( r, r );
+
+          P( A, z, r );
+          rz_old = rz;
+          rz = ublas::inner_prod( r, z );
+          beta = rz / rz_old;
+
+          ublas::noalias( g ) = z + beta * g;
+
+          ++iterations;
+        }
+      }
+
       /**
       * Conjugate Gradient Solver.
       *
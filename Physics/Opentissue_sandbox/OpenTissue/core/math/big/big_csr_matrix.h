@@ -0,0 +1,375 @@
+#ifndef OPENTISSUE_CORE_MATH_BIG_CSR_MATRIX_H
+#define OPENTISSUE_CORE_MATH_BIG_CSR_MATRIX_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
+
+#include <boost/align/aligned_allocator.hpp>
+
+#include <vector>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace math
+  {
+    namespace big
+    {
+
+      /**
+      * Compressed Sparse Row Matrix.
+      * Stores the same data as a ublas compressed_matrix, that is the
+      * non-zero values row by row, their columns and the offsets of the rows,
+      * but uses 32 bit indices and cache line aligned values. The structure is
+      * copied from a compressed_matrix by assign(), if only the values have
+      * changed assign_values() can be used.
+      *
+      * The matrix can be used everywhere a compressed_matrix is accepted by
+      * prod(), prod_add(), prod_sub(), prod_trans(), prod_row(),
+      * prod_add_rhs(), prod_sub_rhs() and residual(), and thereby also with
+      * conjugate_gradient() and gmres().
+      */
+      template<typename T>
+      class CSRMatrix
+      {
+      public:
+
+        typedef T                                                                  value_type;
+        typedef std::size_t                                                        size_type;
+        typedef std::vector< T, boost::alignment::aligned_allocator<T, 64> >        value_container;
+        typedef std::vector< int >                                                 index_container;
+
+      protected:
+
+        size_type        m_size1;     ///< Number of rows.
+        size_type        m_size2;     ///< Number of columns.
+        index_container  m_offsets;   ///< The entries of row i are m_values[m_offsets[i]] to m_values[m_offsets[i+1]-1], has m_size1+1 elements.
+        index_container  m_columns;   ///< Column of every entry, sorted within each row.
+        value_container  m_values;    ///< Value of every entry.
+
+      public:
+
+        CSRMatrix()
+          : m_size1(0)
+          , m_size2(0)
+          , m_offsets(1, 0)
+        {}
+
+        explicit CSRMatrix(ublas::compressed_matrix<T> const & A)
+          : m_size1(0)
+          , m_size2(0)
+          , m_offsets(1, 0)
+        {
+          assign(A);
+        }
+
+      public:
+
+        size_type size1() const { return m_size1; }
+        size_type size2() const { return m_size2; }
+        size_type nnz()   const { return m_values.size(); }
+
+        index_container const & index1_data() const { return m_offsets; }
+        index_container const & index2_data() const { return m_columns; }
+        value_container const & value_data()  const { return m_values;  }
+        value_container       & value_data()        { return m_values;  }
+
+        /**
+        * Get Entry.
+        *
+        * @return   The value of entry (i,j), zero if it is not stored.
+        */
+        T operator()(size_type i, size_type j) const
+        {
+          assert(i < m_size1 || !"CSRMatrix::operator(): row index out of range");
+          assert(j < m_size2 || !"CSRMatrix::operator(): column index out of range");
+
+          int lo = m_offsets[i];
+          int hi = m_offsets[i+1];
+          int const col = static_cast<int>(j);
+          while(lo < hi)
+          {
+            int const mid = (lo + hi) / 2;
+            if(m_columns[mid] < col)
+              lo = mid + 1;
+            else
+              hi = mid;
+          }
+          return (lo < m_offsets[i+1] && m_columns[lo] == col) ? m_values[lo] : T();
+        }
+
+        /**
+        * Assign.
+        * Copies the structure and values of a compressed matrix.
+        *
+        * @param A   The compressed matrix.
+        */
+        void assign(ublas::compressed_matrix<T> const & A)
+        {
+          m_size1 = A.size1();
+          m_size2 = A.size2();
+
+          size_type const filled = A.filled1() - 1;
+          size_type const K      = A.filled2();
+
+          m_offsets.resize( m_size1 + 1 );
+          m_columns.resize( K );
+          m_values.resize( K );
+
+          for(size_type i = 0; i <= m_size1; ++i)
+            m_offsets[i] = static_cast<int>( A.index1_data()[ i < filled ? i : filled ] );
+
+          int const N = static_cast<int>( K );
+#pragma omp parallel for
+          for(int k = 0; k < N; ++k)
+          {
+            m_columns[k] = static_cast<int>( A.index2_data()[k] );
+            m_values[k]  = A.value_data()[k];
+          }
+        }
+
+        /**
+        * Assign Values.
+        * Copies the values of a compressed matrix with the same structure as the
+        * one last given to assign().
+        *
+        * @param A   The compressed matrix.
+        */
+        void assign_values(ublas::compressed_matrix<T> const & A)
+        {
+          assert((A.size1() == m_size1 && A.size2() == m_size2) || !"CSRMatrix::assign_values(): incompatible dimensions");
+          assert(A.filled2() == nnz()                           || !"CSRMatrix::assign_values(): incompatible structure");
+
+          int const N = static_cast<int>( nnz() );
+#pragma omp parallel for
+          for(int k = 0; k < N; ++k)
+            m_values[k] = A.value_data()[k];
+        }
+
+      };
+
+      /**
+      * Compute y = prod(A,x)
+      */
+      template<typename T>
+      inline void prod(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod(): incompatible dimensions");
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(0), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(A,x)*s
+      */
+      template<typename T>
+      inline void prod(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , T const & s
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod(): incompatible dimensions");
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , s, T(0), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y += prod(A,x)
+      */
+      template<typename T>
+      inline void prod_add(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_add(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod_add(): incompatible dimensions");
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(1), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y += prod(A,x)*s
+      */
+      template<typename T>
+      inline void prod_add(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , T const & s
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_add(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod_add(): incompatible dimensions");
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , s, T(1), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y -= prod(A,x)
+      */
+      template<typename T>
+      inline void prod_sub(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_sub(): incompatible dimensions");
+        assert(A.size1() ==  y.size() || !"prod_sub(): incompatible dimensions");
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(-1), T(1), static_cast<T const *>(0), T(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(A,x) + b
+      */
+      template<typename T>
+      inline void prod_add_rhs(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_add_rhs(): incompatible dimensions");
+        assert(A.size1() ==  b.size() || !"prod_add_rhs(): incompatible dimensions");
+
+        if(y.size() != b.size())
+          y.resize(b.size(), false );
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(0), b.data().begin(), T(1), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(A,x) - b
+      */
+      template<typename T>
+      inline void prod_sub_rhs(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_sub_rhs(): incompatible dimensions");
+        assert(A.size1() ==  b.size() || !"prod_sub_rhs(): incompatible dimensions");
+
+        if(y.size() != b.size())
+          y.resize(b.size(), false );
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(1), T(0), b.data().begin(), T(-1), y.data().begin() );
+      }
+
+      /**
+      * Compute r = b - prod(A,x)
+      */
+      template<typename T>
+      inline void residual(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & r
+        )
+      {
+        assert(A.size2() ==  x.size() || !"residual(): incompatible dimensions");
+        assert(A.size1() ==  b.size() || !"residual(): incompatible dimensions");
+
+        if(r.size() != b.size())
+          r.resize(b.size(), false );
+
+        detail::csr_prod( A.size1(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , T(-1), T(0), b.data().begin(), T(1), r.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(trans(A),x)
+      */
+      template<typename T>
+      inline void prod_trans(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size1() ==  x.size() || !"prod_trans(): incompatible dimensions");
+        assert(A.size2() ==  y.size() || !"prod_trans(): incompatible dimensions");
+
+        detail::csr_prod_trans( A.size1(), A.size2(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , static_cast<T const *>(0), y.data().begin() );
+      }
+
+      /**
+      * Compute y = prod(trans(A),x) + b
+      */
+      template<typename T>
+      inline void prod_trans(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , ublas::vector<T> const & b
+        , ublas::vector<T>       & y
+        )
+      {
+        assert(A.size1() ==  x.size() || !"prod_trans(): incompatible dimensions");
+        assert(A.size2() ==  y.size() || !"prod_trans(): incompatible dimensions");
+        assert(b.size()  ==  y.size() || !"prod_trans(): incompatible dimensions");
+
+        detail::csr_prod_trans( A.size1(), A.size2(), A.index1_data().data(), A.index2_data().data(), A.value_data().data(), x.data().begin()
+          , b.data().begin(), y.data().begin() );
+      }
+
+      /**
+      * Compute y_i = prod(row_i(A),x).
+      */
+      template<typename T>
+      inline T prod_row(
+          CSRMatrix<T> const & A
+        , ublas::vector<T> const & x
+        , typename ublas::vector<T>::size_type i
+        )
+      {
+        assert(A.size2() ==  x.size() || !"prod_row(): incompatible dimensions");
+        assert(i < A.size1()          || !"prod_row(): incompatible dimensions");
+
+        int const * columns = A.index2_data().data();
+        T   const * values  = A.value_data().data();
+        T   const * x_data  = x.data().begin();
+        int const   begin   = A.index1_data()[i];
+        int const   end     = A.index1_data()[i + 1];
+
+        T value = T();
+#pragma omp simd reduction(+:value)
+        for(int k = begin; k < end; ++k)
+          value += values[k] * x_data[ columns[k] ];
+        return value;
+      }
+
+    } // end namespace big
+  } // end namespace math
+} // end namespace OpenTissue
+// OPENTISSUE_CORE_MATH_BIG_CSR_MATRIX_H
+#endif
@@ -605,7 +605,7 @@ namespace OpenTissue
 
         // Allocate space for all other temporary data 
         vector_type tmp( N );               // Allocate space for temporary vector.
-        matrix_type H( inner+1, inner );    // Get space for Hessenberg matrix
+        ublas::compressed_matrix<value_type> H( inner+1, inner );    // Get space for Hessenberg matrix
         vector_type g( inner+1 );           // Allocate space for the right hand side vector of the least squares sub problem.
         vector_type c( inner+1 );           // Allocate space for storing the values of cos(theta) of the Givens rotations.
         vector_type s( inner+1 );           // Allocate space for storing the values of sin(theta) of the Givens rotations.
@@ -39,7 +39,6 @@ namespace OpenTissue
       {
         typedef ublas::compressed_matrix<T>     matrix_type;
         typedef ublas::vector<T>                vector_type;
-        typedef typename vector_type::size_type size_type;
 
         if(A.size1() <= 0 || A.size2() <= 0)
           throw std::invalid_argument("jacobi(): A was empty");
@@ -48,9 +47,11 @@ namespace OpenTissue
         if(x.size() != A.size2())
           throw std::invalid_argument("jacobi(): The size of x must be the same as the number of columns in A");
 
-        size_type n = x.size();
+        int const n = static_cast<int>( x.size() );
         vector_type x_old = x;
-        for ( size_type i = 0; i < n; ++i )
+        // Every row only depends on x_old so the rows are updated in parallel
+#pragma omp parallel for if(n >= 1024)
+        for ( int i = 0; i < n; ++i )
         {
           // This is the straigthforward way of implementing a Jacobi iteration
           //x( i ) = b( i );
@@ -10,6 +10,7 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
 
 #include <cassert>
 
@@ -34,7 +35,6 @@ namespace OpenTissue
         )
       {
         typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
         typedef typename vector_type::value_type real_type;
 
         assert(A.size1()>0            || !"prod(): A was empty"            );
@@ -64,16 +64,18 @@ namespace OpenTissue
         //    Note this array have the same dimension as value_data. Each element in index2_data
         //    stores the corresponind column index of the matching element in value_data.
         //
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data()[i];
-          size_type end   = A.index1_data()[i + 1];
-          real_type t = real_type();
-          for (size_type j = begin; j < end; ++ j)
-            t += A.value_data()[j] * x(  A.index2_data()[j]   );
-          y (i) = t;
-        }
+        detail::csr_prod(
+          A.filled1() - 1
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , real_type(1)
+          , real_type(0)
+          , static_cast<real_type const *>(0)
+          , real_type(0)
+          , y.data().begin()
+          );
       }
 
 
@@ -94,7 +96,6 @@ namespace OpenTissue
         )
       {
         typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
         typedef typename vector_type::value_type real_type;
 
         assert(A.size1()>0            || !"prod(): A was empty"            );
@@ -124,19 +125,39 @@ namespace OpenTissue
         //    Note this array have the same dimension as value_data. Each element in index2_data
         //    stores the corresponind column index of the matching element in value_data.
         //
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data()[i];
-          size_type end   = A.index1_data()[i + 1];
-          real_type t = real_type();
-          for (size_type j = begin; j < end; ++ j)
-            t += A.value_data()[j] * x(  A.index2_data()[j]   );
-          y (i) = t*s;
-        }
+        detail::csr_prod(
+          A.filled1() - 1
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , s
+          , real_type(0)
+          , static_cast<real_type const *>(0)
+          , real_type(0)
+          , y.data().begin()
+          );
       }
 
-
+      /**
+       * Compute y = prod(A,x)
+       *
+       * Fallback for matrix types without a specialized product,
+       * the product is computed by ublas::axpy_prod.
+       *
+       * @param A    A matrix.
+       * @param x    A vector.
+       * @param y    Upon return this argument holds the result of A times x.
+       */
+      template<typename matrix_type, typename vector_type>
+      inline void prod(
+          matrix_type const & A
+        , vector_type const & x
+        , vector_type       & y
+        )
+      {
+        ublas::axpy_prod( A, x, y, true );
+      }
 
     } // end  namespace big
   } // end  namespace math
@@ -10,6 +10,7 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
 
 #include <cassert>
 
@@ -36,7 +37,6 @@ namespace OpenTissue
         )
       {
         typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
         typedef typename vector_type::value_type real_type;
 
         assert(A.size1()>0            || !"prod_add_rhs(): A was empty"            );
@@ -69,16 +69,18 @@ namespace OpenTissue
         //    Note this array have the same dimension as value_data. Each element in index2_data
         //    stores the corresponind column index of the matching element in value_data.
         //
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data()[i];
-          size_type end   = A.index1_data()[i + 1];
-          real_type t = b(i);
-          for (size_type j = begin; j < end; ++ j)
-            t += A.value_data()[j] * x(  A.index2_data()[j]   );
-          y (i) = t;
-        }
+        detail::csr_prod(
+          A.filled1() - 1
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , real_type(1)
+          , real_type(0)
+          , b.data().begin()
+          , real_type(1)
+          , y.data().begin()
+          );
       }
 
     } // end of namespace big
@@ -10,6 +10,7 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
 
 #include <OpenTissue/core/math/big/io/big_matlab_write.h>
 
@@ -39,7 +40,6 @@ namespace OpenTissue
         )
       {
         typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
         typedef typename vector_type::value_type real_type;
 
         assert(A.size1()>0            || !"prod_sub(): A was empty"            );
@@ -47,16 +47,18 @@ namespace OpenTissue
         assert(A.size2() ==  x.size() || !"prod_sub(): incompatible dimensions");
         assert(A.size1() ==  y.size() || !"prod_sub(): incompatible dimensions");
 
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data () [i];
-          size_type end   = A.index1_data () [i + 1];
-          real_type t     = real_type();
-          for (size_type j = begin; j < end; ++j)
-            t += A.value_data()[j] * x(  A.index2_data()[j]   );
-          y(i) -= t;
-        }
+        detail::csr_prod(
+          A.filled1() - 1
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , real_type(-1)
+          , real_type(1)
+          , static_cast<real_type const *>(0)
+          , real_type(0)
+          , y.data().begin()
+          );
       }
 
     } // end  namespace big
@@ -10,6 +10,7 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
 
 #include <cassert>
 
@@ -35,7 +36,6 @@ namespace OpenTissue
         )
       {
         typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
         typedef typename vector_type::value_type real_type;
 
         assert(A.size1()>0            || !"prod_trans(): A was empty"            );
@@ -65,16 +65,16 @@ namespace OpenTissue
         //    Note this array have the same dimension as value_data. Each element in index2_data
         //    stores the corresponind column index of the matching element in value_data.
         //
-        y.clear();
-
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data()[i];
-          size_type end   = A.index1_data()[i + 1];
-          for (size_type j = begin; j < end; ++ j)
-            y( A.index2_data()[j] ) += A.value_data()[j] * x( i );
-        }
+        detail::csr_prod_trans(
+          A.filled1() - 1
+          , A.size2()
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , static_cast<real_type const *>(0)
+          , y.data().begin()
+          );
       }
 
 
@@ -94,10 +94,6 @@ namespace OpenTissue
         , boost::numeric::ublas::vector<T>       & y
         )
       {
-        typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
-        typedef typename vector_type::value_type real_type;
-
         assert(A.size1()>0            || !"prod_trans(): A was empty"            );
         assert(A.size2()>0            || !"prod_trans(): A was empty"            );
         assert(A.size1() ==  x.size() || !"prod_trans(): incompatible dimensions");
@@ -126,16 +122,16 @@ namespace OpenTissue
         //    Note this array have the same dimension as value_data. Each element in index2_data
         //    stores the corresponind column index of the matching element in value_data.
         //
-        y.assign( b );
-
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data()[i];
-          size_type end   = A.index1_data()[i + 1];
-          for (size_type j = begin; j < end; ++ j)
-            y( A.index2_data()[j] ) += A.value_data()[j] * x( i );
-        }
+        detail::csr_prod_trans(
+          A.filled1() - 1
+          , A.size2()
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , b.data().begin()
+          , y.data().begin()
+          );
       }
 
     } // end  namespace big
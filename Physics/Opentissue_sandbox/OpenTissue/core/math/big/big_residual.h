@@ -10,6 +10,7 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/core/math/big/big_types.h>
+#include <OpenTissue/core/math/big/big_spmv.h>
 
 #include <cassert>
 
@@ -36,7 +37,6 @@ namespace OpenTissue
         )
       {
         typedef boost::numeric::ublas::vector<T> vector_type;
-        typedef typename vector_type::size_type  size_type;
         typedef typename vector_type::value_type real_type;
 
         assert(A.size1()>0            || !"residual(): A was empty"            );
@@ -69,16 +69,41 @@ namespace OpenTissue
         //    Note this array have the same dimension as value_data. Each element in index2_data
         //    stores the corresponind column index of the matching element in value_data.
         //
-        size_type row_end = A.filled1 () - 1;
-        for (size_type i = 0; i < row_end; ++ i) 
-        {
-          size_type begin = A.index1_data()[i];
-          size_type end   = A.index1_data()[i + 1];
-          real_type t = b(i);
-          for (size_type j = begin; j < end; ++ j)
-            t -= A.value_data()[j] * x(  A.index2_data()[j]   );
-          r (i) = t;
-        }
+        detail::csr_prod(
+          A.filled1() - 1
+          , A.index1_data().begin()
+          , A.index2_data().begin()
+          , A.value_data().begin()
+          , x.data().begin()
+          , real_type(-1)
+          , real_type(0)
+          , b.data().begin()
+          , real_type(1)
+          , r.data().begin()
+          );
+      }
+
+      /**
+      * Compute r  = b - prod(A,x).
+      *
+      * Fallback for matrix types without a specialized product,
+      * the product is computed by ublas::axpy_prod.
+      *
+      * @param A      The matrix.
+      * @param x      The solution vector.
+      * @param b      The right hand side vector.
+      * @param r      Upon return this argument holds the residual value of the matrix equation A x = b.
+      */
+      template<typename matrix_type, typename vector_type>
+      inline void residual(
+          matrix_type const & A
+        , vector_type const & x
+        , vector_type const & b
+        , vector_type       & r
+        )
+      {
+        ublas::noalias( r ) = b;
+        ublas::axpy_prod( A, -x, r, false );
       }
 
     } // end of namespace big
@@ -0,0 +1,301 @@
+#ifndef OPENTISSUE_CORE_MATH_BIG_SPMV_H
+#define OPENTISSUE_CORE_MATH_BIG_SPMV_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <cstddef>
+
+namespace OpenTissue
+{
+  namespace math
+  {
+    namespace big
+    {
+      namespace detail
+      {
+
+        /**
+        * Products with fewer non-zeros than this are done by a single thread,
+        * below this size the cost of starting the threads dominates.
+        */
+        static std::size_t const spmv_parallel_threshold = 16384u;
+
+        /**
+        * Number of partial results used by the transposed products. Rows are
+        * split into this many slices, each slice scatters into its own partial
+        * result and the partial results are summed afterwards.
+        */
+        static int const spmv_transpose_slices = 8;
+
+        /**
+        * Compressed Row Product.
+        * Computes
+        *
+        *   y_i = alpha (A x)_i + beta y_i + gamma b_i
+        *
+        * for all rows of the compressed row matrix A. Rows are processed in
+        * parallel and the products of a row are vectorized. The old value of y
+        * is only read if beta is non-zero and b is only read if it is given.
+        *
+        * @param rows      The number of rows.
+        * @param offsets   The entries of row i are offsets[i] to offsets[i+1]-1.
+        * @param columns   The column of every entry.
+        * @param values    The value of every entry.
+        * @param x         The vector to multiply by.
+        * @param alpha     Scaling of the product.
+        * @param beta      Scaling of the old value of y.
+        * @param b         Vector to add to the product, can be null.
+        * @param gamma     Scaling of b.
+        * @param y         Upon return holds the result.
+        */
+        template<typename index_type, typename T>
+        inline void csr_prod(
+          std::size_t rows
+          , index_type const * offsets
+          , index_type const * columns
+          , T const * values
+          , T const * x
+          , T const & alpha
+          , T const & beta
+          , T const * b
+          , T const & gamma
+          , T * y
+          )
+        {
+          int const N = static_cast<int>( rows );
+          bool const parallel = static_cast<std::size_t>( offsets[rows] - offsets[0] ) >= spmv_parallel_threshold;
+          bool const use_y = beta != T();
+
+#pragma omp parallel for if(parallel)
+          for(int i = 0; i < N; ++i)
+          {
+            index_type const begin = offsets[i];
+            index_type const end   = offsets[i + 1];
+            T t = T();
+#pragma omp simd reduction(+:t)
+            for(index_type k = begin; k < end; ++k)
+              t += values[k] * x[ columns[k] ];
+            T value = alpha * t;
+            if(use_y)
+              value += beta * y[i];
+            if(b)
+              value += gamma * b[i];
+            y[i] = value;
+          }
+        }
+
+        /**
+        * Compressed Row Transposed Product.
+        * Computes
+        *
+        *   y = A^T x + b
+        *
+        * for the compressed row matrix A. The product scatters into y, so when
+        * done in parallel the rows are split into slices that scatter into
+        * separate partial results.
+        *
+        * @param rows      The number of rows.
+        * @param cols      The number of columns, that is the size of y.
+        * @param offsets   The entries of row i are offsets[i] to offsets[i+1]-1.
+        * @param columns   The column of every entry.
+        * @param values    The value of every entry.
+        * @param x         The vector to multiply by.
+        * @param b         Vector to add to the product, can be null.
+        * @param y         Upon return holds the result.
+        */
+        template<typename index_type, typename T>
+        inline void csr_prod_trans(
+          std::size_t rows
+          , std::size_t cols
+          , index_type const * offsets
+          , index_type const * columns
+          , T const * values
+          , T const * x
+          , T const * b
+          , T * y
+          )
+        {
+          int const N = static_cast<int>( rows );
+          int const M = static_cast<int>( cols );
+          bool const parallel = static_cast<std::size_t>( offsets[rows] - offsets[0] ) >= spmv_parallel_threshold;
+          int const S = parallel ? spmv_transpose_slices : 1;
+
+          std::vector<T> partial;
+          if(S > 1)
+            partial.assign( static_cast<std::size_t>(S) * cols, T() );
+          else
+            for(int j = 0; j < M; ++j)
+              y[j] = T();
+
+#pragma omp parallel for schedule(dynamic,1) if(parallel)
+          for(int s = 0; s < S; ++s)
+          {
+            T * y_s = (S > 1) ? &partial[ static_cast<std::size_t>(s) * cols ] : y;
+            int const first = static_cast<int>( (static_cast<long long>(N) * s) / S );
+            int const last  = static_cast<int>( (static_cast<long long>(N) * (s + 1)) / S );
+            for(int i = first; i < last; ++i)
+            {
+              T const x_i = x[i];
+              index_type const end = offsets[i + 1];
+              for(index_type k = offsets[i]; k < end; ++k)
+                y_s[ columns[k] ] += values[k] * x_i;
+            }
+          }
+
+#pragma omp parallel for if(parallel)
+          for(int j = 0; j < M; ++j)
+          {
+            T sum = b ? b[j] : T();
+            if(S > 1)
+            {
+              for(int s = 0; s < S; ++s)
+                sum += partial[ static_cast<std::size_t>(s) * cols + j ];
+            }
+            else
+              sum += y[j];
+            y[j] = sum;
+          }
+        }
+
+        /**
+        * Block Compressed Row Product.
+        * Same as csr_prod() except that every entry is a dense N-by-N block
+        * stored row by row, and offsets and columns refer to block rows and
+        * block columns.
+        */
+        template<int N, typename index_type, typename T>
+        inline void bcsr_prod(
+          std::size_t block_rows
+          , index_type const * offsets
+          , index_type const * columns
+          , T const * values
+          , T const * x
+          , T const & alpha
+          , T const & beta
+          , T const * b
+          , T const & gamma
+          , T * y
+          )
+        {
+          int const R = static_cast<int>( block_rows );
+          bool const parallel = static_cast<std::size_t>( offsets[block_rows] - offsets[0] )*N*N >= spmv_parallel_threshold;
+          bool const use_y = beta != T();
+
+#pragma omp parallel for if(parallel)
+          for(int I = 0; I < R; ++I)
+          {
+            T t[N];
+            for(int r = 0; r < N; ++r)
+              t[r] = T();
+
+            index_type const end = offsets[I + 1];
+            for(index_type k = offsets[I]; k < end; ++k)
+            {
+              T const * B   = values + static_cast<std::size_t>(k)*N*N;
+              T const * x_J = x + static_cast<std::size_t>( columns[k] )*N;
+              for(int r = 0; r < N; ++r)
+              {
+                T sum = T();
+#pragma omp simd reduction(+:sum)
+                for(int c = 0; c < N; ++c)
+                  sum += B[r*N + c] * x_J[c];
+                t[r] += sum;
+              }
+            }
+
+            for(int r = 0; r < N; ++r)
+            {
+              std::size_t const i = static_cast<std::size_t>(I)*N + r;
+              T value = alpha * t[r];
+              if(use_y)
+                value += beta * y[i];
+              if(b)
+                value += gamma * b[i];
+              y[i] = value;
+            }
+          }
+        }
+
+        /**
+        * Block Compressed Row Transposed Product.
+        * Same as csr_prod_trans() except that every entry is a dense N-by-N
+        * block stored row by row.
+        */
+        template<int N, typename index_type, typename T>
+        inline void bcsr_prod_trans(
+          std::size_t block_rows
+          , std::size_t block_cols
+          , index_type const * offsets
+          , index_type const * columns
+          , T const * values
+          , T const * x
+          , T const * b
+          , T * y
+          )
+        {
+          int const R = static_cast<int>( block_rows );
+          int const M = static_cast<int>( block_cols*N );
+          bool const parallel = static_cast<std::size_t>( offsets[block_rows] - offsets[0] )*N*N >= spmv_parallel_threshold;
+          int const S = parallel ? spmv_transpose_slices : 1;
+          std::size_t const cols = block_cols*N;
+
+          std::vector<T> partial;
+          if(S > 1)
+            partial.assign( static_cast<std::size_t>(S) * cols, T() );
+          else
+            for(int j = 0; j < M; ++j)
+              y[j] = T();
+
+#pragma omp parallel for schedule(dynamic,1) if(parallel)
+          for(int s = 0; s < S; ++s)
+          {
+            T * y_s = (S > 1) ? &partial[ static_cast<std::size_t>(s) * cols ] : y;
+            int const first = static_cast<int>( (static_cast<long long>(R) * s) / S );
+            int const last  = static_cast<int>( (static_cast<long long>(R) * (s + 1)) / S );
+            for(int I = first; I < last; ++I)
+            {
+              T const * x_I = x + static_cast<std::size_t>(I)*N;
+              index_type const end = offsets[I + 1];
+              for(index_type k = offsets[I]; k < end; ++k)
+              {
+                T const * B   = values + static_cast<std::size_t>(k)*N*N;
+                T       * y_J = y_s + static_cast<std::size_t>( columns[k] )*N;
+                for(int r = 0; r < N; ++r)
+                {
+                  T const x_r = x_I[r];
+#pragma omp simd
+                  for(int c = 0; c < N; ++c)
+                    y_J[c] += B[r*N + c] * x_r;
+                }
+              }
+            }
+          }
+
+#pragma omp parallel for if(parallel)
+          for(int j = 0; j < M; ++j)
+          {
+            T sum = b ? b[j] : T();
+            if(S > 1)
+            {
+              for(int s = 0; s < S; ++s)
+                sum += partial[ static_cast<std::size_t>(s) * cols + j ];
+            }
+            else
+              sum += y[j];
+            y[j] = sum;
+          }
+        }
+
+      } // end namespace detail
+    } // end namespace big
+  } // end namespace math
+} // end namespace OpenTissue
+// OPENTISSUE_CORE_MATH_BIG_SPMV_H
+#endif
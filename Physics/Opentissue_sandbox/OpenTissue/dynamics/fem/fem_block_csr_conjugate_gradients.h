@@ -0,0 +1,147 @@
+#ifndef OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_CONJUGATE_GRADIENTS_H
+#define OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_CONJUGATE_GRADIENTS_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+
+namespace OpenTissue
+{
+  namespace fem
+  {
+    namespace detail
+    {
+      /**
+      * Preconditioned Conjugate Gradient Solver.
+      * Solves the equation
+      *
+      *   A x = b
+      *
+      * where A is a BlockCSRMatrix. Rows of fixed nodes are left out of the
+      * system, their entries of x are kept as they are and act as known
+      * values. Matrix vector products, preconditioning and dot products are
+      * all done in parallel.
+      *
+      * The iteration stops as in conjugate_gradients(), when at least
+      * min_iterations have been done and the squared norm of the residual
+      * is below the tolerance, or after max_iterations. Unlike
+      * conjugate_gradients() there is no absolute clamp on the denominators,
+      * with a preconditioner r^T P^{-1} r may be many orders of magnitude
+      * smaller than r^T r while the residual is still large. The iteration
+      * only stops early on breakdown, that is if r^T P^{-1} r is zero or the
+      * search direction has no positive curvature.
+      *
+      * @param A                The system matrix, must be symmetric positive definite.
+      * @param b                The right hand side.
+      * @param x                Initial guess, upon return the solution.
+      * @param fixed            Non-zero for fixed nodes.
+      * @param preconditioner   The preconditioner, update() must have been invoked with A.
+      * @param min_iterations   Minimum number of iterations.
+      * @param max_iterations   Maximum number of iterations.
+      * @param tolerance        Tolerance on the squared norm of the residual.
+      *
+      * @return                 The number of iterations done.
+      */
+      template < typename matrix_type, typename preconditioner_type, typename real_type >
+      inline unsigned int block_csr_conjugate_gradients(
+        matrix_type const & A
+        , typename matrix_type::vector_container const & b
+        , typename matrix_type::vector_container & x
+        , std::vector<unsigned char> const & fixed
+        , preconditioner_type & preconditioner
+        , unsigned int min_iterations
+        , unsigned int max_iterations
+        , real_type const & tolerance
+        )
+      {
+        typedef typename matrix_type::vector_container      vector_container;
+
+        int const N = A.rows();
+        vector_container r;
+        vector_container z;
+        vector_container p( N );
+        vector_container q;
+
+        //---  r = b - A x
+        A.multiply( x, q );
+        r.resize( N );
+#pragma omp parallel for
+        for(int i = 0; i < N; ++i)
+        {
+          if(fixed[i])
+            r[i].clear();
+          else
+            r[i] = b[i] - q[i];
+        }
+
+        //--- p = z = P^{-1} r
+        preconditioner.apply( r, z );
+        real_type rz = real_type(0);
+#pragma omp parallel for reduction(+:rz)
+        for(int i = 0; i < N; ++i)
+        {
+          p[i] = z[i];
+          rz += r[i] * z[i];
+        }
+
+        unsigned int iteration = 0;
+        for(; iteration < max_iterations; ++iteration)
+        {
+          //--- q = A p, fixed entries of p are zero so fixed columns do not contribute
+          A.multiply( p, q );
+          real_type pq = real_type(0);
+#pragma omp parallel for reduction(+:pq)
+          for(int i = 0; i < N; ++i)
+            if(!fixed[i])
+              pq += p[i] * q[i];
+
+          if(!(rz > real_type(0)) || !(pq > real_type(0)))
+            break;
+          real_type const alpha = rz / pq;
+
+          //--- x += alpha p
+          //--- r -= alpha q
+          real_type rr = real_type(0);
+#pragma omp parallel for reduction(+:rr)
+          for(int i = 0; i < N; ++i)
+          {
+            if(fixed[i])
+              continue;
+            x[i] += p[i] * alpha;
+            r[i] -= q[i] * alpha;
+            rr   += r[i] * r[i];
+          }
+          if(iteration >= min_iterations && rr < tolerance)
+          {
+            ++iteration;
+            break;
+          }
+
+          //--- p = z + beta p
+          preconditioner.apply( r, z );
+          real_type rz_next = real_type(0);
+#pragma omp parallel for reduction(+:rz_next)
+          for(int i = 0; i < N; ++i)
+            rz_next += r[i] * z[i];
+
+          real_type const beta = rz_next / rz;
+          rz = rz_next;
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+            p[i] = z[i] + p[i] * beta;
+        }
+        return iteration;
+      }
+
+    } // namespace detail
+  } // namespace fem
+} // namespace OpenTissue
+
+//OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_CONJUGATE_GRADIENTS_H
+#endif
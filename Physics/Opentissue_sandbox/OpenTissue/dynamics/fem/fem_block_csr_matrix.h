@@ -0,0 +1,145 @@
+#ifndef OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_MATRIX_H
+#define OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_MATRIX_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace fem
+  {
+    namespace detail
+    {
+
+      /**
+      * Block Compressed Sparse Row Matrix.
+      * A sparse 3n-by-3n matrix stored as 3-by-3 blocks. The blocks of row i
+      * are stored consecutively, sorted by column, so a matrix vector product
+      * is a single sweep over the block array instead of a walk over the
+      * per-node maps used by NodeTraits.
+      *
+      * The structure is set once by set_structure(), afterwards only the
+      * values of the blocks change.
+      */
+      template <typename math_types>
+      class BlockCSRMatrix
+      {
+      public:
+
+        typedef typename math_types::real_type              real_type;
+        typedef typename math_types::vector3_type           vector3_type;
+        typedef typename math_types::matrix3x3_type         matrix3x3_type;
+
+        typedef std::vector<matrix3x3_type>                 block_container;
+        typedef std::vector<vector3_type>                   vector_container;
+        typedef std::vector<int>                            index_container;
+
+      protected:
+
+        index_container  m_row_offsets;  ///< The blocks of row i are m_blocks[m_row_offsets[i]] to m_blocks[m_row_offsets[i+1]-1].
+        index_container  m_columns;      ///< Column of every block, sorted within each row.
+        index_container  m_diagonal;     ///< Index of the diagonal block of every row.
+        block_container  m_blocks;       ///< The values of the blocks.
+
+      public:
+
+        int rows()  const { return m_row_offsets.empty() ? 0 : static_cast<int>( m_row_offsets.size() ) - 1; }
+        int size()  const { return static_cast<int>( m_blocks.size() ); }
+
+        int row_begin(int i) const { return m_row_offsets[i];   }
+        int row_end(int i)   const { return m_row_offsets[i+1]; }
+        int column(int k)    const { return m_columns[k];       }
+        int diagonal(int i)  const { return m_diagonal[i];      }
+
+        matrix3x3_type       & block(int k)       { return m_blocks[k]; }
+        matrix3x3_type const & block(int k) const { return m_blocks[k]; }
+
+        /**
+        * Set Structure.
+        *
+        * @param row_offsets   Offsets of the rows into columns, one more than the number of rows.
+        * @param columns       The columns of the non-zero blocks, sorted within each row. Every row must have a diagonal block.
+        */
+        void set_structure(index_container const & row_offsets, index_container const & columns)
+        {
+          m_row_offsets = row_offsets;
+          m_columns     = columns;
+          m_blocks.resize( columns.size() );
+
+          int const N = rows();
+          m_diagonal.resize( N );
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+          {
+            m_diagonal[i] = find(i, i);
+            assert(m_diagonal[i] >= 0 || !"BlockCSRMatrix::set_structure(): row was missing a diagonal block");
+          }
+          clear();
+        }
+
+        /**
+        * Find Block.
+        *
+        * @return   The index of block (i,j) or -1 if the block is not in the structure.
+        */
+        int find(int i, int j) const
+        {
+          int lo = m_row_offsets[i];
+          int hi = m_row_offsets[i+1];
+          while(lo < hi)
+          {
+            int const mid = (lo + hi) / 2;
+            if(m_columns[mid] < j)
+              lo = mid + 1;
+            else
+              hi = mid;
+          }
+          return (lo < m_row_offsets[i+1] && m_columns[lo] == j) ? lo : -1;
+        }
+
+        /**
+        * Set all blocks to zero, keeping the structure.
+        */
+        void clear()
+        {
+          int const K = size();
+#pragma omp parallel for
+          for(int k = 0; k < K; ++k)
+            m_blocks[k].clear();
+        }
+
+        /**
+        * Matrix Vector Product, y = A x. Rows are processed in parallel.
+        */
+        void multiply(vector_container const & x, vector_container & y) const
+        {
+          int const N = rows();
+          y.resize( N );
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+          {
+            vector3_type sum;
+            sum.clear();
+            int const end = m_row_offsets[i+1];
+            for(int k = m_row_offsets[i]; k < end; ++k)
+              sum += m_blocks[k] * x[ m_columns[k] ];
+            y[i] = sum;
+          }
+        }
+
+      };
+
+    } // namespace detail
+  } // namespace fem
+} // namespace OpenTissue
+
+//OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_MATRIX_H
+#endif
@@ -0,0 +1,391 @@
+#ifndef OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_PRECONDITIONERS_H
+#define OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_PRECONDITIONERS_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/dynamics/fem/fem_block_csr_matrix.h>
+
+#include <vector>
+
+namespace OpenTissue
+{
+  namespace fem
+  {
+    namespace detail
+    {
+
+      /**
+      * The preconditioners of the block CSR conjugate gradient solver all have the interface
+      *
+      *   void init(matrix_type const & A, fixed_container const & fixed)
+      *   void update(matrix_type const & A)
+      *   void apply(vector_container const & r, vector_container & z)
+      *
+      * init() is invoked when the structure of A or the set of fixed nodes
+      * change, update() is invoked whenever the values of A change and
+      * apply() computes z = P^{-1} r. Rows and columns of fixed nodes are
+      * treated as if they were not part of the system, apply() returns zero
+      * for fixed rows.
+      */
+
+      /**
+      * Identity Preconditioner, this gives the plain conjugate gradient method.
+      */
+      template <typename math_types>
+      class IdentityPreconditioner
+      {
+      public:
+
+        typedef BlockCSRMatrix<math_types>                     matrix_type;
+        typedef typename matrix_type::vector_container         vector_container;
+        typedef std::vector<unsigned char>                     fixed_container;
+
+      protected:
+
+        fixed_container m_fixed;
+
+      public:
+
+        void init(matrix_type const & /*A*/, fixed_container const & fixed) { m_fixed = fixed; }
+
+        void update(matrix_type const & /*A*/) {}
+
+        void apply(vector_container const & r, vector_container & z)
+        {
+          int const N = static_cast<int>( r.size() );
+          z.resize( N );
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+          {
+            if(m_fixed[i])
+              z[i].clear();
+            else
+              z[i] = r[i];
+          }
+        }
+      };
+
+      /**
+      * Block Jacobi Preconditioner.
+      * The preconditioner is the block diagonal of A, every 3-by-3 diagonal
+      * block is inverted independently.
+      */
+      template <typename math_types>
+      class BlockJacobiPreconditioner
+      {
+      public:
+
+        typedef BlockCSRMatrix<math_types>                     matrix_type;
+        typedef typename matrix_type::matrix3x3_type           matrix3x3_type;
+        typedef typename matrix_type::block_container          block_container;
+        typedef typename matrix_type::vector_container         vector_container;
+        typedef std::vector<unsigned char>                     fixed_container;
+
+      protected:
+
+        fixed_container  m_fixed;    ///< Non-zero for fixed nodes.
+        block_container  m_inverse;  ///< Inverse of the diagonal blocks.
+
+      public:
+
+        void init(matrix_type const & A, fixed_container const & fixed)
+        {
+          m_fixed = fixed;
+          m_inverse.resize( A.rows() );
+        }
+
+        void update(matrix_type const & A)
+        {
+          int const N = A.rows();
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+          {
+            if(m_fixed[i])
+              m_inverse[i].clear();
+            else
+              m_inverse[i] = inverse( A.block( A.diagonal(i) ) );
+          }
+        }
+
+        void apply(vector_container const & r, vector_container & z)
+        {
+          int const N = static_cast<int>( r.size() );
+          z.resize( N );
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+            z[i] = m_inverse[i] * r[i];
+        }
+      };
+
+      /**
+      * Block Incomplete Cholesky Preconditioner.
+      * Computes the block factorization A ~ L D L^T with the unit lower
+      * triangular L restricted to the structure of A, also known as IC(0).
+      * Row i of the factorization is
+      *
+      *   L_ik = ( A_ik - sum_m L_im D_m L_km^T ) D_k^{-1}     for k < i
+      *   D_i  =   A_ii - sum_k L_ik D_k L_ik^T
+      *
+      * where the sums only runs over blocks in the structure of A. Row i
+      * depends on the rows k < i it has blocks in, so the rows are grouped
+      * into levels such that the rows of a level only depends on rows of
+      * previous levels. The rows of a level are factorized in parallel, and
+      * the same levels are used for the forward substitution. The backward
+      * substitution uses levels of the transposed dependencies.
+      *
+      * The number of levels depends on the node numbering, a numbering that
+      * sweeps through the mesh gives a level count close to the number of
+      * layers of nodes along the sweep direction.
+      *
+      * Should a diagonal block break down (stop being positive definite) it
+      * is replaced by the diagonal block of A.
+      */
+      template <typename math_types>
+      class IncompleteCholeskyPreconditioner
+      {
+      public:
+
+        typedef BlockCSRMatrix<math_types>                     matrix_type;
+        typedef typename matrix_type::real_type                real_type;
+        typedef typename matrix_type::vector3_type             vector3_type;
+        typedef typename matrix_type::matrix3x3_type           matrix3x3_type;
+        typedef typename matrix_type::block_container          block_container;
+        typedef typename matrix_type::vector_container         vector_container;
+        typedef typename matrix_type::index_container          index_container;
+        typedef std::vector<unsigned char>                     fixed_container;
+
+      protected:
+
+        fixed_container  m_fixed;            ///< Non-zero for fixed nodes.
+
+        index_container  m_lower_offsets;    ///< The strict lower blocks of row i are m_lower[m_lower_offsets[i]] to m_lower[m_lower_offsets[i+1]-1].
+        index_container  m_lower_columns;    ///< Column of every strict lower block, sorted within each row.
+        index_container  m_lower_source;     ///< Index of the corresponding block of A.
+        block_container  m_lower;            ///< The strict lower blocks of L.
+
+        index_container  m_upper_offsets;    ///< The strict lower blocks of column i are m_upper_index[m_upper_offsets[i]] to m_upper_index[m_upper_offsets[i+1]-1].
+        index_container  m_upper_rows;       ///< Row of every block in column i.
+        index_container  m_upper_index;      ///< Index into m_lower of every block in column i.
+
+        block_container  m_diagonal;         ///< The blocks of D.
+        block_container  m_inverse;          ///< The inverse blocks of D.
+
+        index_container  m_forward;          ///< Rows sorted by forward level.
+        index_container  m_forward_offsets;  ///< The rows of forward level l are m_forward[m_forward_offsets[l]] to m_forward[m_forward_offsets[l+1]-1].
+        index_container  m_backward;         ///< Rows sorted by backward level.
+        index_container  m_backward_offsets; ///< The rows of backward level l are m_backward[m_backward_offsets[l]] to m_backward[m_backward_offsets[l+1]-1].
+
+      public:
+
+        /**
+        * Number of forward levels, this bounds the parallelism of factorization and substitution.
+        */
+        size_t levels() const { return m_forward_offsets.empty() ? 0 : m_forward_offsets.size() - 1; }
+
+        void init(matrix_type const & A, fixed_container const & fixed)
+        {
+          int const N = A.rows();
+          m_fixed = fixed;
+
+          //--- Strict lower structure, leaving out fixed rows and columns
+          m_lower_offsets.assign( N + 1, 0 );
+          m_lower_columns.clear();
+          m_lower_source.clear();
+          for(int i = 0; i < N; ++i)
+          {
+            if(!m_fixed[i])
+            {
+              int const end = A.diagonal(i);
+              for(int k = A.row_begin(i); k < end; ++k)
+              {
+                if(m_fixed[ A.column(k) ])
+                  continue;
+                m_lower_columns.push_back( A.column(k) );
+                m_lower_source.push_back( k );
+              }
+            }
+            m_lower_offsets[i+1] = static_cast<int>( m_lower_columns.size() );
+          }
+          m_lower.resize( m_lower_columns.size() );
+          m_diagonal.resize( N );
+          m_inverse.resize( N );
+
+          //--- Transposed structure, rows of a column come out sorted since rows are visited in order
+          m_upper_offsets.assign( N + 1, 0 );
+          for(size_t p = 0; p < m_lower_columns.size(); ++p)
+            ++m_upper_offsets[ m_lower_columns[p] + 1 ];
+          for(int i = 0; i < N; ++i)
+            m_upper_offsets[i+1] += m_upper_offsets[i];
+          m_upper_rows.resize( m_lower_columns.size() );
+          m_upper_index.resize( m_lower_columns.size() );
+          index_container next( m_upper_offsets.begin(), m_upper_offsets.end() - 1 );
+          for(int i = 0; i < N; ++i)
+            for(int p = m_lower_offsets[i]; p < m_lower_offsets[i+1]; ++p)
+            {
+              int const slot = next[ m_lower_columns[p] ]++;
+              m_upper_rows[slot]  = i;
+              m_upper_index[slot] = p;
+            }
+
+          //--- Forward levels, a row comes after all rows it has lower blocks in
+          index_container level( N, 0 );
+          for(int i = 0; i < N; ++i)
+            for(int p = m_lower_offsets[i]; p < m_lower_offsets[i+1]; ++p)
+              level[i] = (level[ m_lower_columns[p] ] + 1 > level[i]) ? level[ m_lower_columns[p] ] + 1 : level[i];
+          sort_by_level( level, m_forward, m_forward_offsets );
+
+          //--- Backward levels, a row comes after all rows that have lower blocks in it
+          level.assign( N, 0 );
+          for(int i = N - 1; i >= 0; --i)
+            for(int p = m_upper_offsets[i]; p < m_upper_offsets[i+1]; ++p)
+              level[i] = (level[ m_upper_rows[p] ] + 1 > level[i]) ? level[ m_upper_rows[p] ] + 1 : level[i];
+          sort_by_level( level, m_backward, m_backward_offsets );
+        }
+
+        void update(matrix_type const & A)
+        {
+          for(size_t l = 0; l < levels(); ++l)
+          {
+            int const first = m_forward_offsets[l];
+            int const last  = m_forward_offsets[l+1];
+#pragma omp parallel for
+            for(int r = first; r < last; ++r)
+              factorize_row( A, m_forward[r] );
+          }
+        }
+
+        void apply(vector_container const & r, vector_container & z)
+        {
+          int const N = static_cast<int>( r.size() );
+          z.resize( N );
+
+          //--- Solve L y = r
+          for(size_t l = 0; l < levels(); ++l)
+          {
+            int const first = m_forward_offsets[l];
+            int const last  = m_forward_offsets[l+1];
+#pragma omp parallel for
+            for(int q = first; q < last; ++q)
+            {
+              int const i = m_forward[q];
+              vector3_type y = r[i];
+              for(int p = m_lower_offsets[i]; p < m_lower_offsets[i+1]; ++p)
+                y -= m_lower[p] * z[ m_lower_columns[p] ];
+              z[i] = y;
+            }
+          }
+
+          //--- Solve D w = y
+#pragma omp parallel for
+          for(int i = 0; i < N; ++i)
+          {
+            if(m_fixed[i])
+              z[i].clear();
+            else
+              z[i] = m_inverse[i] * z[i];
+          }
+
+          //--- Solve L^T z = w
+          for(size_t l = 0; l + 1 < m_backward_offsets.size(); ++l)
+          {
+            int const first = m_backward_offsets[l];
+            int const last  = m_backward_offsets[l+1];
+#pragma omp parallel for
+            for(int q = first; q < last; ++q)
+            {
+              int const i = m_backward[q];
+              vector3_type w = z[i];
+              for(int p = m_upper_offsets[i]; p < m_upper_offsets[i+1]; ++p)
+                w -= trans( m_lower[ m_upper_index[p] ] ) * z[ m_upper_rows[p] ];
+              z[i] = w;
+            }
+          }
+        }
+
+      protected:
+
+        /**
+        * Bucket the free rows by level.
+        */
+        void sort_by_level(index_container const & level, index_container & rows, index_container & offsets)
+        {
+          int const N = static_cast<int>( level.size() );
+          int max_level = -1;
+          for(int i = 0; i < N; ++i)
+            if(!m_fixed[i])
+              max_level = level[i] > max_level ? level[i] : max_level;
+
+          offsets.assign( max_level + 2, 0 );
+          for(int i = 0; i < N; ++i)
+            if(!m_fixed[i])
+              ++offsets[ level[i] + 1 ];
+          for(int l = 0; l <= max_level; ++l)
+            offsets[l+1] += offsets[l];
+
+          rows.resize( offsets.back() );
+          index_container next( offsets.begin(), offsets.end() - 1 );
+          for(int i = 0; i < N; ++i)
+            if(!m_fixed[i])
+              rows[ next[ level[i] ]++ ] = i;
+        }
+
+        static bool is_positive(matrix3x3_type const & D)
+        {
+          return D(0,0) > real_type(0) && D(1,1) > real_type(0) && D(2,2) > real_type(0) && det(D) > real_type(0);
+        }
+
+        void factorize_row(matrix_type const & A, int i)
+        {
+          int const begin = m_lower_offsets[i];
+          int const end   = m_lower_offsets[i+1];
+
+          matrix3x3_type D = A.block( A.diagonal(i) );
+          for(int p = begin; p < end; ++p)
+          {
+            int const k = m_lower_columns[p];
+            matrix3x3_type S = A.block( m_lower_source[p] );
+
+            //--- Subtract L_im D_m L_km^T for all m < k in both row i and row k
+            int q = begin;
+            int s = m_lower_offsets[k];
+            int const s_end = m_lower_offsets[k+1];
+            while(q < p && s < s_end)
+            {
+              int const m_i = m_lower_columns[q];
+              int const m_k = m_lower_columns[s];
+              if(m_i < m_k)
+                ++q;
+              else if(m_k < m_i)
+                ++s;
+              else
+              {
+                S -= m_lower[q] * m_diagonal[m_i] * trans( m_lower[s] );
+                ++q;
+                ++s;
+              }
+            }
+
+            m_lower[p] = S * m_inverse[k];
+            D -= m_lower[p] * m_diagonal[k] * trans( m_lower[p] );
+          }
+
+          if(!is_positive(D))
+            D = A.block( A.diagonal(i) );
+          m_diagonal[i] = D;
+          m_inverse[i]  = inverse( D );
+        }
+
+      };
+
+    } // namespace detail
+  } // namespace fem
+} // namespace OpenTissue
+
+//OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_PRECONDITIONERS_H
+#endif
@@ -0,0 +1,471 @@
+#ifndef OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_SYSTEM_H
+#define OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_SYSTEM_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/dynamics/fem/fem_block_csr_matrix.h>
+#include <OpenTissue/dynamics/fem/fem_block_csr_preconditioners.h>
+#include <OpenTissue/dynamics/fem/fem_block_csr_conjugate_gradients.h>
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace fem
+  {
+
+    /**
+    * Block CSR System.
+    * An alternative to the per-node matrix maps of NodeTraits. The global
+    * stiffness matrix and the system matrix of the dynamic equation are
+    * stored in one block CSR matrix with 3-by-3 blocks, and the equation is
+    * solved by a parallel preconditioned conjugate gradient method.
+    *
+    * The structure of the matrix is computed once from the tetrahedra of
+    * the mesh, together with a scatter map that gives the block index of
+    * every pair of nodes of every tetrahedron. The tetrahedra are split into
+    * chunks of consecutive tetrahedra and the chunks are greedy colored such
+    * that no two chunks of a color share a node, thus the chunks of a color
+    * are assembled in parallel without any locking. Coloring chunks rather
+    * than single tetrahedra keeps the memory access of a thread local, as
+    * long as consecutive tetrahedra are close to each other in the mesh.
+    *
+    * The system is used in place of the node maps by passing it to
+    * simulate(), everything else about the mesh stays the same. The stiffness
+    * and system matrices of the node maps are not updated.
+    */
+    template <typename fem_mesh>
+    class BlockCSRSystem
+    {
+    public:
+
+      typedef typename fem_mesh::math_types                  math_types;
+      typedef typename math_types::real_type                 real_type;
+      typedef typename math_types::vector3_type              vector3_type;
+      typedef typename math_types::matrix3x3_type            matrix3x3_type;
+      typedef typename fem_mesh::node_iterator               node_iterator;
+      typedef typename fem_mesh::tetrahedron_iterator        tetrahedron_iterator;
+
+      typedef detail::BlockCSRMatrix<math_types>             matrix_type;
+      typedef typename matrix_type::vector_container         vector_container;
+      typedef typename matrix_type::index_container          index_container;
+      typedef std::vector<unsigned char>                     fixed_container;
+
+      typedef enum {
+        identity_preconditioner
+        , block_jacobi_preconditioner
+        , incomplete_cholesky_preconditioner
+      } preconditioner_type;
+
+    protected:
+
+      static const int max_colors = 64;  ///< Number of colors in the color masks, chunks that cannot be colored are assembled sequentially.
+
+      matrix_type          m_A;                  ///< The stiffness matrix after stiffness assembly, the system matrix after dynamics assembly.
+      index_container      m_scatter;            ///< Block index of node pair (i,j) of tetrahedron e is m_scatter[16*e + 4*i + j].
+      int                  m_chunk_size;         ///< Number of consecutive tetrahedra in a chunk.
+      index_container      m_chunks;             ///< Chunks sorted by color, chunk k holds the tetrahedra k*m_chunk_size to (k+1)*m_chunk_size-1.
+      index_container      m_color_offsets;      ///< The chunks of color c are m_chunks[m_color_offsets[c]] to m_chunks[m_color_offsets[c+1]-1], the last color holds uncolored chunks.
+      size_t               m_nodes;              ///< Number of nodes when the structure was computed.
+      size_t               m_tetrahedra;         ///< Number of tetrahedra when the structure was computed.
+
+      vector_container     m_b;                  ///< Right hand side of the dynamic equation.
+      vector_container     m_x;                  ///< Velocities.
+      fixed_container      m_fixed;              ///< Non-zero for fixed nodes.
+      fixed_container      m_init_fixed;         ///< The fixed nodes when the preconditioner was initialized.
+      int                  m_init_type;          ///< The preconditioner type initialized, -1 if none.
+
+      preconditioner_type  m_preconditioner;     ///< The preconditioner to use.
+      detail::IdentityPreconditioner<math_types>            m_identity;
+      detail::BlockJacobiPreconditioner<math_types>         m_block_jacobi;
+      detail::IncompleteCholeskyPreconditioner<math_types>  m_incomplete_cholesky;
+
+      unsigned int         m_min_iterations;     ///< Minimum number of conjugate gradient iterations.
+      unsigned int         m_max_iterations;     ///< Maximum number of conjugate gradient iterations.
+      real_type            m_tolerance;          ///< Tolerance on the squared norm of the residual.
+      real_type            m_mass_damping;       ///< Mass proportional damping used by simulate().
+      unsigned int         m_iterations;         ///< Number of iterations used by last solve.
+
+    public:
+
+      BlockCSRSystem()
+        : m_chunk_size(64)
+        , m_nodes(0)
+        , m_tetrahedra(0)
+        , m_init_type(-1)
+        , m_preconditioner(block_jacobi_preconditioner)
+        , m_min_iterations(20)
+        , m_max_iterations(20)
+        , m_tolerance(0.001)
+        , m_mass_damping(2.0)
+        , m_iterations(0)
+      {}
+
+    public:
+
+      void set_preconditioner(preconditioner_type const & type) { m_preconditioner = type; }
+      preconditioner_type get_preconditioner() const            { return m_preconditioner; }
+
+      void set_min_iterations(unsigned int const & value) { m_min_iterations = value; }
+      void set_max_iterations(unsigned int const & value) { m_max_iterations = value; }
+      void set_tolerance(real_type const & value)         { m_tolerance = value; }
+      void set_mass_damping(real_type const & value)      { m_mass_damping = value; }
+
+      unsigned int get_min_iterations() const { return m_min_iterations; }
+      unsigned int get_max_iterations() const { return m_max_iterations; }
+      real_type    get_tolerance()      const { return m_tolerance; }
+      real_type    get_mass_damping()   const { return m_mass_damping; }
+
+      /**
+      * Set Chunk Size.
+      * Takes effect at the next init().
+      *
+      * @param size   The number of consecutive tetrahedra colored and assembled as one, must be positive.
+      */
+      void set_chunk_size(int size)
+      {
+        assert( size > 0 || !"BlockCSRSystem::set_chunk_size(): size must be positive");
+        m_chunk_size = size;
+      }
+
+      int get_chunk_size() const { return m_chunk_size; }
+
+      /**
+      * Number of conjugate gradient iterations used by the last call to conjugate_gradients().
+      */
+      unsigned int iterations() const { return m_iterations; }
+
+      matrix_type       & matrix()       { return m_A; }
+      matrix_type const & matrix() const { return m_A; }
+
+      /**
+      * Scatter Map of a tetrahedron, the block index of node pair (i,j) is scatter(e)[4*i + j].
+      */
+      int const * scatter(int e) const { return &m_scatter[16*e]; }
+
+      /**
+      * Initialize Structure.
+      * Computes the matrix structure, the scatter map and the coloring of
+      * the chunks. This is done automatically by stiffness_assembly()
+      * if the number of nodes or tetrahedra has changed, but must be
+      * invoked explicitly if the mesh is changed in any other way.
+      *
+      * @param mesh
+      */
+      void init(fem_mesh & mesh)
+      {
+        int const N = static_cast<int>( mesh.size_nodes() );
+        int const E = static_cast<int>( mesh.size_tetrahedra() );
+        m_nodes      = mesh.size_nodes();
+        m_tetrahedra = mesh.size_tetrahedra();
+
+        //--- Row structure is the set of nodes sharing a tetrahedron with the row node
+        std::vector<index_container> neighbours( N );
+        for(int i = 0; i < N; ++i)
+          neighbours[i].push_back( i );
+        for(int e = 0; e < E; ++e)
+        {
+          tetrahedron_iterator T = mesh.tetrahedron(e);
+          for(int i = 0; i < 4; ++i)
+            for(int j = 0; j < 4; ++j)
+              if(i != j)
+                neighbours[ T->node_idx(i) ].push_back( static_cast<int>( T->node_idx(j) ) );
+        }
+
+        index_container row_offsets( N + 1, 0 );
+        index_container columns;
+        for(int i = 0; i < N; ++i)
+        {
+          index_container & row = neighbours[i];
+          std::sort( row.begin(), row.end() );
+          row.erase( std::unique( row.begin(), row.end() ), row.end() );
+          columns.insert( columns.end(), row.begin(), row.end() );
+          row_offsets[i+1] = static_cast<int>( columns.size() );
+          index_container().swap( row );
+        }
+        m_A.set_structure( row_offsets, columns );
+
+        m_scatter.resize( 16*E );
+#pragma omp parallel for
+        for(int e = 0; e < E; ++e)
+        {
+          tetrahedron_iterator T = mesh.tetrahedron(e);
+          for(int i = 0; i < 4; ++i)
+            for(int j = 0; j < 4; ++j)
+              m_scatter[16*e + 4*i + j] = m_A.find( static_cast<int>( T->node_idx(i) ), static_cast<int>( T->node_idx(j) ) );
+        }
+
+        setup_colors( mesh );
+
+        m_b.resize( N );
+        m_x.resize( N );
+        m_fixed.resize( N );
+        m_init_type = -1;
+      }
+
+      /**
+      * Clear Stiffness Assembly.
+      * Sets the stiffness matrix and the force offset vectors f0' of the nodes
+      * to zero. The structure is initialized if the number of nodes or
+      * tetrahedra has changed.
+      *
+      * @param mesh
+      */
+      void clear_stiffness_assembly(fem_mesh & mesh)
+      {
+        if(m_nodes != mesh.size_nodes() || m_tetrahedra != mesh.size_tetrahedra())
+          init( mesh );
+
+        m_A.clear();
+
+        int const N = static_cast<int>( m_nodes );
+#pragma omp parallel for
+        for(int i = 0; i < N; ++i)
+          mesh.node(i)->m_f0.clear();
+      }
+
+      /**
+      * Colored Chunk Traversal.
+      * Invokes kernel(begin, end) for every chunk of tetrahedra begin to
+      * end-1. The chunks of a color are handled concurrently, so the kernel
+      * may scatter into the matrix and the nodes of its own tetrahedra
+      * without locking. Chunks start at multiples of the chunk size.
+      *
+      * @param kernel
+      */
+      template<typename chunk_kernel>
+      void for_each_chunk(chunk_kernel & kernel)
+      {
+        int const E      = static_cast<int>( m_tetrahedra );
+        int const colors = static_cast<int>( m_color_offsets.size() ) - 1;
+        for(int c = 0; c < colors; ++c)
+        {
+          int const first = m_color_offsets[c];
+          int const last  = m_color_offsets[c+1];
+          bool const parallel = c < max_colors;
+#pragma omp parallel for schedule(dynamic) if(parallel)
+          for(int k = first; k < last; ++k)
+          {
+            int const begin = m_chunks[k]*m_chunk_size;
+            int const end   = std::min( E, begin + m_chunk_size );
+            kernel( begin, end );
+          }
+        }
+      }
+
+      /**
+      * Stiffness Matrix Assembly.
+      * Assembles the warped stiffness matrix K' and the force offset vectors
+      * f0' exactly as stiffness_assembly() does, but into the block CSR
+      * matrix. The rotations of all tetrahedra must have been set.
+      *
+      * @param mesh
+      */
+      void stiffness_assembly(fem_mesh & mesh)
+      {
+        clear_stiffness_assembly( mesh );
+        element_assembler assembler( *this, mesh );
+        for_each_chunk( assembler );
+      }
+
+      /**
+      * Setup dynamic equation.
+      * Computes the right hand side b and turns the stiffness matrix into the
+      * system matrix A of the dynamic equation, exactly as dynamics_assembly()
+      * does. Every row is handled independently so all rows are processed
+      * in parallel.
+      *
+      * @param mesh
+      * @param mass_damping      Coefficient for mass damping in the Raleigh damping equation.
+      * @param dt                The time step, \delta t, which is about to be taken.
+      */
+      void dynamics_assembly(fem_mesh & mesh, real_type const & mass_damping, real_type const & dt)
+      {
+        int const N = static_cast<int>( m_nodes );
+#pragma omp parallel for
+        for(int i = 0; i < N; ++i)
+        {
+          node_iterator n_i = mesh.node(i);
+
+          vector3_type b_i;
+          b_i.clear();
+          int const end = m_A.row_end(i);
+          for(int k = m_A.row_begin(i); k < end; ++k)
+          {
+            matrix3x3_type & K_ij = m_A.block(k);
+            b_i -= K_ij * mesh.node( m_A.column(k) )->m_coord;
+            K_ij *= dt*dt;
+          }
+          real_type const c_i = mass_damping*n_i->m_mass;
+          real_type const tmp = n_i->m_mass + dt*c_i;
+          matrix3x3_type & A_ii = m_A.block( m_A.diagonal(i) );
+          A_ii(0,0) += tmp; A_ii(1,1) += tmp;  A_ii(2,2) += tmp;
+
+          b_i -= n_i->m_f0;
+          b_i += n_i->m_f_external;
+          b_i *= dt;
+          b_i += n_i->m_velocity * n_i->m_mass;
+
+          m_b[i]     = b_i;
+          m_x[i]     = n_i->m_velocity;
+          m_fixed[i] = n_i->m_fixed ? 1 : 0;
+        }
+      }
+
+      /**
+      * Solve the dynamic equation for the velocities of the nodes using the
+      * selected preconditioner. The velocities of fixed nodes are left
+      * unchanged.
+      *
+      * @param mesh
+      *
+      * @return   The number of iterations used.
+      */
+      unsigned int conjugate_gradients(fem_mesh & mesh)
+      {
+        if(m_init_type != static_cast<int>( m_preconditioner ) || m_init_fixed != m_fixed)
+        {
+          switch(m_preconditioner)
+          {
+          case identity_preconditioner:            m_identity.init( m_A, m_fixed );            break;
+          case block_jacobi_preconditioner:        m_block_jacobi.init( m_A, m_fixed );        break;
+          case incomplete_cholesky_preconditioner: m_incomplete_cholesky.init( m_A, m_fixed ); break;
+          }
+          m_init_type  = static_cast<int>( m_preconditioner );
+          m_init_fixed = m_fixed;
+        }
+
+        switch(m_preconditioner)
+        {
+        case identity_preconditioner:            m_iterations = solve( m_identity );            break;
+        case block_jacobi_preconditioner:        m_iterations = solve( m_block_jacobi );        break;
+        case incomplete_cholesky_preconditioner: m_iterations = solve( m_incomplete_cholesky ); break;
+        }
+
+        int const N = static_cast<int>( m_nodes );
+#pragma omp parallel for
+        for(int i = 0; i < N; ++i)
+          if(!m_fixed[i])
+            mesh.node(i)->m_velocity = m_x[i];
+
+        return m_iterations;
+      }
+
+    protected:
+
+      class element_assembler
+      {
+      public:
+        element_assembler(BlockCSRSystem & owner, fem_mesh & mesh) : m_owner(owner), m_mesh(mesh) {}
+        void operator()(int begin, int end)
+        {
+          for(int e = begin; e < end; ++e)
+            m_owner.assemble_element( m_mesh, e );
+        }
+      protected:
+        BlockCSRSystem & m_owner;
+        fem_mesh       & m_mesh;
+      };
+
+      template<typename preconditioner_type_>
+      unsigned int solve(preconditioner_type_ & preconditioner)
+      {
+        preconditioner.update( m_A );
+        return detail::block_csr_conjugate_gradients( m_A, m_b, m_x, m_fixed, preconditioner, m_min_iterations, m_max_iterations, m_tolerance );
+      }
+
+      /**
+      * Greedy coloring of the chunks, such that no two chunks of a color share a node.
+      */
+      void setup_colors(fem_mesh & mesh)
+      {
+        int const N = static_cast<int>( mesh.size_nodes() );
+        int const E = static_cast<int>( mesh.size_tetrahedra() );
+        int const C = (E + m_chunk_size - 1) / m_chunk_size;
+
+        std::vector<boost::uint64_t> used( N, 0 );
+        index_container color( C );
+        index_container count( max_colors + 1, 0 );
+        for(int k = 0; k < C; ++k)
+        {
+          int const begin = k*m_chunk_size;
+          int const end   = std::min( E, begin + m_chunk_size );
+
+          boost::uint64_t mask = 0;
+          for(int e = begin; e < end; ++e)
+          {
+            tetrahedron_iterator T = mesh.tetrahedron(e);
+            for(int i = 0; i < 4; ++i)
+              mask |= used[ T->node_idx(i) ];
+          }
+          int c = 0;
+          while(c < max_colors && (mask & (boost::uint64_t(1) << c)))
+            ++c;
+          if(c < max_colors)
+            for(int e = begin; e < end; ++e)
+            {
+              tetrahedron_iterator T = mesh.tetrahedron(e);
+              for(int i = 0; i < 4; ++i)
+                used[ T->node_idx(i) ] |= boost::uint64_t(1) << c;
+            }
+          color[k] = c;
+          ++count[c];
+        }
+
+        m_color_offsets.assign( max_colors + 2, 0 );
+        for(int c = 0; c <= max_colors; ++c)
+          m_color_offsets[c+1] = m_color_offsets[c] + count[c];
+        m_chunks.resize( C );
+        index_container next( m_color_offsets.begin(), m_color_offsets.end() - 1 );
+        for(int k = 0; k < C; ++k)
+          m_chunks[ next[ color[k] ]++ ] = k;
+      }
+
+      /**
+      * Add the contributions of one tetrahedron, see stiffness_assembly() for the theory.
+      */
+      void assemble_element(fem_mesh & mesh, int e)
+      {
+        tetrahedron_iterator T = mesh.tetrahedron(e);
+        matrix3x3_type const & Re = T->m_Re;
+        int const * scatter = &m_scatter[16*e];
+        for (int i = 0; i < 4; ++i)
+        {
+          node_iterator p_i = T->node(i);
+          vector3_type f;
+          f.clear();
+          for (int j = 0; j < 4; ++j)
+          {
+            node_iterator    p_j   = T->node(j);
+            matrix3x3_type & Ke_ij = T->m_Ke[i][j];
+
+            f += Ke_ij * p_j->m_model_coord;
+            if (j >= i)
+            {
+              matrix3x3_type tmp = Re * Ke_ij * trans(Re);
+              m_A.block( scatter[4*i + j] ) += tmp;
+              if (j > i)
+                m_A.block( scatter[4*j + i] ) += trans(tmp);
+            }
+          }
+          p_i->m_f0 -= Re*f;
+        }
+      }
+
+    };
+
+  } // namespace fem
+} // namespace OpenTissue
+
+//OPENTISSUE_DYNAMICS_FEM_FEM_BLOCK_CSR_SYSTEM_H
+#endif
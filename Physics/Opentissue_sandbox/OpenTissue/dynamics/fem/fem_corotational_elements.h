@@ -0,0 +1,518 @@
+#ifndef OPENTISSUE_DYNAMICS_FEM_FEM_COROTATIONAL_ELEMENTS_H
+#define OPENTISSUE_DYNAMICS_FEM_FEM_COROTATIONAL_ELEMENTS_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/dynamics/fem/fem_block_csr_system.h>
+
+#include <boost/align/aligned_allocator.hpp>
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace fem
+  {
+
+    /**
+    * Corotational Elements.
+    * A data parallel replacement of the per tetrahedron steps of simulate(),
+    * that is update_orientation() or reset_orientation(), stiffness_assembly()
+    * and add_plasticity_force(), for use with a BlockCSRSystem.
+    *
+    * All rest state quantities of the tetrahedra are copied into structure
+    * of arrays: the inverse of the rest edge matrix, the upper blocks of Ke,
+    * the constant products Ke x0, the shape function derivatives B and the
+    * plasticity parameters. The rotations and plastic strains are kept in
+    * the same layout. The tetrahedra are processed in groups of lanes
+    * consecutive tetrahedra, every kernel loops over the lanes of a group
+    * such that the compiler can vectorize the computations across
+    * tetrahedra, only gathering node coordinates and scattering the results
+    * are done one tetrahedron at a time.
+    *
+    * The rotation, warped stiffness blocks and plastic forces of a tetrahedron
+    * are computed in one pass. The pass runs over the colored chunks of the
+    * BlockCSRSystem, so groups are scattered into the matrix and the nodes
+    * concurrently without locking.
+    *
+    * The rotation is found either by orthonormalizing the rows of the
+    * deformation gradient, as update_orientation() does, or by a polar
+    * decomposition of the deformation gradient computed by the Newton
+    * iteration R = (R + R^{-T}) / 2. The polar decomposition gives the
+    * rotation closest to the deformation gradient, whereas orthonormalizing
+    * the rows favors the x-axis.
+    *
+    * Plastic strains are kept by this class while it is used, the m_Re and
+    * m_plastic members of the tetrahedra are not updated. If the material
+    * parameters or the model coordinates are changed init() must be invoked.
+    */
+    template <typename fem_mesh>
+    class CorotationalElements
+    {
+    public:
+
+      typedef typename fem_mesh::math_types                  math_types;
+      typedef typename math_types::real_type                 real_type;
+      typedef typename math_types::vector3_type              vector3_type;
+      typedef typename math_types::matrix3x3_type            matrix3x3_type;
+      typedef typename fem_mesh::node_iterator               node_iterator;
+      typedef typename fem_mesh::tetrahedron_iterator        tetrahedron_iterator;
+      typedef BlockCSRSystem<fem_mesh>                       system_type;
+
+      typedef std::vector< real_type, boost::alignment::aligned_allocator<real_type, 64> >  real_container;
+      typedef std::vector< int >                                                          index_container;
+
+      enum { lanes = 8 };  ///< Number of tetrahedra processed together by the kernels.
+
+    protected:
+
+      int             m_count;             ///< Number of tetrahedra.
+      index_container m_node[4];           ///< Global index of the nodes of every tetrahedron.
+      real_container  m_rest[9];           ///< Inverse of the rest edge matrix [e10 e20 e30], row major.
+      real_container  m_Ke[90];            ///< The ten blocks Ke_ij with j >= i, entry (r,c) of block upper(i,j) is m_Ke[9*upper(i,j) + 3*r + c].
+      real_container  m_Kx0[12];           ///< Component k of sum_j Ke_ij x0_j is m_Kx0[3*i + k].
+      real_container  m_R[9];              ///< The rotation, row major.
+      real_container  m_B[12];             ///< Component k of B_j is m_B[3*j + k].
+      real_container  m_D[3];              ///< The elasticity matrix in vector form.
+      real_container  m_V;                 ///< The volume.
+      real_container  m_plastic[6];        ///< The plastic strain tensor.
+      real_container  m_yield;             ///< Plastic yield.
+      real_container  m_creep;             ///< Plastic creep.
+      real_container  m_max;               ///< Maximum plastic strain.
+
+      bool            m_use_polar_decomposition; ///< If true the rotation is found by a polar decomposition otherwise by orthonormalization.
+      unsigned int    m_polar_iterations;        ///< Maximum number of Newton iterations of the polar decomposition.
+      real_type       m_polar_threshold;         ///< Largest change of an entry of the rotation at which the Newton iteration stops.
+
+    public:
+
+      CorotationalElements()
+        : m_count(0)
+        , m_use_polar_decomposition(false)
+        , m_polar_iterations(16)
+        , m_polar_threshold(1e-8)
+      {}
+
+    public:
+
+      void set_use_polar_decomposition(bool const & value) { m_use_polar_decomposition = value; }
+      bool get_use_polar_decomposition() const             { return m_use_polar_decomposition; }
+
+      void set_polar_iterations(unsigned int const & value) { m_polar_iterations = value; }
+      void set_polar_threshold(real_type const & value)     { m_polar_threshold = value; }
+
+      unsigned int get_polar_iterations() const { return m_polar_iterations; }
+      real_type    get_polar_threshold()  const { return m_polar_threshold; }
+
+      /**
+      * Rotation of a tetrahedron, as computed by the last call to run().
+      */
+      matrix3x3_type rotation(int e) const
+      {
+        assert((e >= 0 && e < m_count) || !"CorotationalElements::rotation(): index out of range");
+        return matrix3x3_type(
+          m_R[0][e], m_R[1][e], m_R[2][e]
+          , m_R[3][e], m_R[4][e], m_R[5][e]
+          , m_R[6][e], m_R[7][e], m_R[8][e]
+          );
+      }
+
+      /**
+      * Initialize.
+      * Copies the rest state of all tetrahedra. Must be invoked after fem::init(),
+      * this is done automatically by run() if the number of tetrahedra has changed.
+      *
+      * @param mesh
+      */
+      void init(fem_mesh & mesh)
+      {
+        m_count = static_cast<int>( mesh.size_tetrahedra() );
+        int const padded = (m_count + lanes - 1) / lanes * lanes;
+
+        //--- Padding lanes are all zero and refer to node zero, they are never scattered
+        for(int k = 0; k < 4; ++k)   m_node[k].assign( padded, 0 );
+        for(int k = 0; k < 9; ++k)   m_rest[k].assign( padded, real_type(0) );
+        for(int k = 0; k < 90; ++k)  m_Ke[k].assign( padded, real_type(0) );
+        for(int k = 0; k < 12; ++k)  m_Kx0[k].assign( padded, real_type(0) );
+        for(int k = 0; k < 9; ++k)   m_R[k].assign( padded, real_type(0) );
+        for(int k = 0; k < 12; ++k)  m_B[k].assign( padded, real_type(0) );
+        for(int k = 0; k < 3; ++k)   m_D[k].assign( padded, real_type(0) );
+        for(int k = 0; k < 6; ++k)   m_plastic[k].assign( padded, real_type(0) );
+        m_V.assign( padded, real_type(0) );
+        m_yield.assign( padded, real_type(0) );
+        m_creep.assign( padded, real_type(0) );
+        m_max.assign( padded, real_type(0) );
+
+#pragma omp parallel for
+        for(int e = 0; e < m_count; ++e)
+        {
+          tetrahedron_iterator T = mesh.tetrahedron(e);
+
+          assert(T->m_yield>=0 || !"CorotationalElements::init(): yield must be non-negative");
+          assert(T->m_creep>=0 || !"CorotationalElements::init(): creep must be non-negative");
+          assert(T->m_max>=0   || !"CorotationalElements::init(): max must be non-negative");
+
+          for(int i = 0; i < 4; ++i)
+            m_node[i][e] = static_cast<int>( T->node_idx(i) );
+
+          matrix3x3_type E(
+            T->m_e10(0), T->m_e20(0), T->m_e30(0)
+            , T->m_e10(1), T->m_e20(1), T->m_e30(1)
+            , T->m_e10(2), T->m_e20(2), T->m_e30(2)
+            );
+          matrix3x3_type invE = inverse(E);
+          for(int r = 0; r < 3; ++r)
+            for(int c = 0; c < 3; ++c)
+            {
+              m_rest[3*r + c][e] = invE(r,c);
+              m_R[3*r + c][e]    = (r == c) ? real_type(1) : real_type(0);
+            }
+
+          for(int i = 0; i < 4; ++i)
+          {
+            vector3_type Kx0;
+            Kx0.clear();
+            for(int j = 0; j < 4; ++j)
+            {
+              Kx0 += T->m_Ke[i][j] * T->node(j)->m_model_coord;
+              if(j < i)
+                continue;
+              int const b = upper(i,j);
+              for(int r = 0; r < 3; ++r)
+                for(int c = 0; c < 3; ++c)
+                  m_Ke[9*b + 3*r + c][e] = T->m_Ke[i][j](r,c);
+            }
+            for(int k = 0; k < 3; ++k)
+            {
+              m_Kx0[3*i + k][e] = Kx0(k);
+              m_B[3*i + k][e]   = T->m_B[i](k);
+            }
+          }
+
+          for(int k = 0; k < 3; ++k)
+            m_D[k][e] = T->m_D(k);
+          for(int k = 0; k < 6; ++k)
+            m_plastic[k][e] = T->m_plastic[k];
+          m_V[e]     = T->m_V;
+          m_yield[e] = T->m_yield;
+          m_creep[e] = T->m_creep;
+          m_max[e]   = T->m_max;
+        }
+      }
+
+      /**
+      * Run Element Pass.
+      * Computes the rotations of all tetrahedra and assembles the warped
+      * stiffness matrix and force offset vectors into the system. Plastic
+      * forces are added to the external forces of the nodes.
+      *
+      * @param mesh
+      * @param system                  The chunk size of the system must be a multiple of lanes.
+      * @param dt                      The time step.
+      * @param use_stiffness_warping   If false all rotations are set to identity.
+      */
+      void run(fem_mesh & mesh, system_type & system, real_type const & dt, bool use_stiffness_warping)
+      {
+        assert( system.get_chunk_size() % lanes == 0 || !"CorotationalElements::run(): chunk size of system must be a multiple of lanes");
+        assert( dt > real_type(0)                    || !"CorotationalElements::run(): time step must be positive");
+
+        if(m_count != static_cast<int>( mesh.size_tetrahedra() ))
+          init( mesh );
+
+        system.clear_stiffness_assembly( mesh );
+        element_kernel kernel( *this, mesh, system, dt, use_stiffness_warping );
+        system.for_each_chunk( kernel );
+      }
+
+    protected:
+
+      /**
+      * Index of the block Ke_ij, j >= i, among the ten upper blocks.
+      */
+      static int upper(int i, int j) { return 4*i - (i*(i-1))/2 + (j - i); }
+
+      class element_kernel
+      {
+      public:
+
+        element_kernel(CorotationalElements & owner, fem_mesh & mesh, system_type & system, real_type const & dt, bool use_stiffness_warping)
+          : m_owner(owner), m_mesh(mesh), m_system(system), m_dt(dt), m_use_stiffness_warping(use_stiffness_warping)
+        {}
+
+        void operator()(int begin, int end)
+        {
+          for(int g = begin; g < end; g += lanes)
+            m_owner.process_group( m_mesh, m_system, g, (end - g < lanes) ? end - g : lanes, m_dt, m_use_stiffness_warping );
+        }
+
+      protected:
+
+        CorotationalElements & m_owner;
+        fem_mesh             & m_mesh;
+        system_type          & m_system;
+        real_type              m_dt;
+        bool                   m_use_stiffness_warping;
+      };
+
+      /**
+      * Rotations of a group by orthonormalizing the rows of the deformation gradient, as ortonormalize() does.
+      */
+      void orthonormalize_group(real_type F[9][lanes], int g)
+      {
+#pragma omp simd
+        for(int l = 0; l < lanes; ++l)
+        {
+          real_type r0x = F[0][l], r0y = F[1][l], r0z = F[2][l];
+          real_type r1x = F[3][l], r1y = F[4][l], r1z = F[5][l];
+
+          real_type const l0 = std::sqrt( r0x*r0x + r0y*r0y + r0z*r0z );
+          real_type const s0 = l0 > real_type(0) ? real_type(1) / l0 : real_type(1);
+          r0x *= s0; r0y *= s0; r0z *= s0;
+
+          real_type const d = r0x*r1x + r0y*r1y + r0z*r1z;
+          r1x -= r0x*d; r1y -= r0y*d; r1z -= r0z*d;
+          real_type const l1 = std::sqrt( r1x*r1x + r1y*r1y + r1z*r1z );
+          real_type const s1 = l1 > real_type(0) ? real_type(1) / l1 : real_type(1);
+          r1x *= s1; r1y *= s1; r1z *= s1;
+
+          m_R[0][g+l] = r0x;  m_R[1][g+l] = r0y;  m_R[2][g+l] = r0z;
+          m_R[3][g+l] = r1x;  m_R[4][g+l] = r1y;  m_R[5][g+l] = r1z;
+          m_R[6][g+l] = r0y*r1z - r0z*r1y;
+          m_R[7][g+l] = r0z*r1x - r0x*r1z;
+          m_R[8][g+l] = r0x*r1y - r0y*r1x;
+        }
+      }
+
+      /**
+      * Rotations of a group by Newton iterations R = (R + R^{-T}) / 2 on all lanes at once.
+      * The iteration stops when no entry of any lane changes more than the threshold.
+      */
+      void polar_decomposition_group(real_type R[9][lanes], int g)
+      {
+        for(unsigned int iteration = 0; iteration < m_polar_iterations; ++iteration)
+        {
+          real_type change = real_type(0);
+#pragma omp simd reduction(max:change)
+          for(int l = 0; l < lanes; ++l)
+          {
+            //--- Cofactor matrix, R^{-T} = C / det R
+            real_type const c0 = R[4][l]*R[8][l] - R[5][l]*R[7][l];
+            real_type const c1 = R[5][l]*R[6][l] - R[3][l]*R[8][l];
+            real_type const c2 = R[3][l]*R[7][l] - R[4][l]*R[6][l];
+            real_type const c3 = R[2][l]*R[7][l] - R[1][l]*R[8][l];
+            real_type const c4 = R[0][l]*R[8][l] - R[2][l]*R[6][l];
+            real_type const c5 = R[1][l]*R[6][l] - R[0][l]*R[7][l];
+            real_type const c6 = R[1][l]*R[5][l] - R[2][l]*R[4][l];
+            real_type const c7 = R[2][l]*R[3][l] - R[0][l]*R[5][l];
+            real_type const c8 = R[0][l]*R[4][l] - R[1][l]*R[3][l];
+            real_type const det = R[0][l]*c0 + R[1][l]*c1 + R[2][l]*c2;
+
+            //--- Singular lanes are left unchanged
+            real_type const s = det != real_type(0) ? real_type(0.5) / det : real_type(0);
+            real_type const h = det != real_type(0) ? real_type(0.5)       : real_type(1);
+            real_type const C[9] = { c0, c1, c2, c3, c4, c5, c6, c7, c8 };
+            for(int k = 0; k < 9; ++k)
+            {
+              real_type const next = h*R[k][l] + s*C[k];
+              real_type const diff = next > R[k][l] ? next - R[k][l] : R[k][l] - next;
+              change = diff > change ? diff : change;
+              R[k][l] = next;
+            }
+          }
+          if(change < m_polar_threshold)
+            break;
+        }
+        for(int k = 0; k < 9; ++k)
+#pragma omp simd
+          for(int l = 0; l < lanes; ++l)
+            m_R[k][g+l] = R[k][l];
+      }
+
+      void process_group(fem_mesh & mesh, system_type & system, int g, int valid, real_type const & dt, bool use_stiffness_warping)
+      {
+        //--- Gather current and model coordinates
+        real_type x[12][lanes];
+        real_type x0[12][lanes];
+        for(int l = 0; l < lanes; ++l)
+          for(int i = 0; i < 4; ++i)
+          {
+            node_iterator n = mesh.node( m_node[i][g+l] );
+            for(int k = 0; k < 3; ++k)
+            {
+              x[3*i + k][l]  = n->m_coord(k);
+              x0[3*i + k][l] = n->m_model_coord(k);
+            }
+          }
+
+        //--- Rotations
+        if(use_stiffness_warping)
+        {
+          //--- Deformation gradient F = [e10' e20' e30'] E^{-1}
+          real_type F[9][lanes];
+          for(int r = 0; r < 3; ++r)
+            for(int c = 0; c < 3; ++c)
+#pragma omp simd
+              for(int l = 0; l < lanes; ++l)
+                F[3*r + c][l] =
+                  (x[3 + r][l] - x[r][l]) * m_rest[c][g+l]
+                  + (x[6 + r][l] - x[r][l]) * m_rest[3 + c][g+l]
+                  + (x[9 + r][l] - x[r][l]) * m_rest[6 + c][g+l];
+
+          if(m_use_polar_decomposition)
+            polar_decomposition_group( F, g );
+          else
+            orthonormalize_group( F, g );
+        }
+        else
+        {
+          for(int k = 0; k < 9; ++k)
+#pragma omp simd
+            for(int l = 0; l < lanes; ++l)
+              m_R[k][g+l] = (k % 4 == 0) ? real_type(1) : real_type(0);
+        }
+
+        //--- Warped stiffness blocks R Ke_ij R^T
+        real_type K[90][lanes];
+        for(int b = 0; b < 10; ++b)
+        {
+#pragma omp simd
+          for(int l = 0; l < lanes; ++l)
+          {
+            real_type RK[9];
+            for(int r = 0; r < 3; ++r)
+              for(int c = 0; c < 3; ++c)
+                RK[3*r + c] =
+                  m_R[3*r][g+l]*m_Ke[9*b + c][g+l]
+                  + m_R[3*r + 1][g+l]*m_Ke[9*b + 3 + c][g+l]
+                  + m_R[3*r + 2][g+l]*m_Ke[9*b + 6 + c][g+l];
+            for(int r = 0; r < 3; ++r)
+              for(int c = 0; c < 3; ++c)
+                K[9*b + 3*r + c][l] = RK[3*r]*m_R[3*c][g+l] + RK[3*r + 1]*m_R[3*c + 1][g+l] + RK[3*r + 2]*m_R[3*c + 2][g+l];
+          }
+        }
+
+        //--- Force offsets f0_i = - R Ke_ij x0_j
+        real_type f0[12][lanes];
+        for(int i = 0; i < 4; ++i)
+          for(int r = 0; r < 3; ++r)
+#pragma omp simd
+            for(int l = 0; l < lanes; ++l)
+              f0[3*i + r][l] = -( m_R[3*r][g+l]*m_Kx0[3*i][g+l] + m_R[3*r + 1][g+l]*m_Kx0[3*i + 1][g+l] + m_R[3*r + 2][g+l]*m_Kx0[3*i + 2][g+l] );
+
+        //--- Plastic forces, see add_plasticity_force() for the theory
+        real_type fp[12][lanes];
+        real_type const max_amount = real_type(1) / dt;
+#pragma omp simd
+        for(int l = 0; l < lanes; ++l)
+        {
+          //--- Total strain: e_total  = Be (Re^{-1} x - x0)
+          real_type e[6] = { 0, 0, 0, 0, 0, 0 };
+          for(int j = 0; j < 4; ++j)
+          {
+            real_type u[3];
+            for(int k = 0; k < 3; ++k)
+              u[k] = m_R[k][g+l]*x[3*j][l] + m_R[3 + k][g+l]*x[3*j + 1][l] + m_R[6 + k][g+l]*x[3*j + 2][l] - x0[3*j + k][l];
+            real_type const bj = m_B[3*j][g+l];
+            real_type const cj = m_B[3*j + 1][g+l];
+            real_type const dj = m_B[3*j + 2][g+l];
+            e[0] += bj*u[0];
+            e[1] += cj*u[1];
+            e[2] += dj*u[2];
+            e[3] += cj*u[0] + bj*u[1];
+            e[4] += dj*u[0] + bj*u[2];
+            e[5] += dj*u[1] + cj*u[2];
+          }
+
+          //--- Elastic strain above yield is added to the plastic strain by creep
+          real_type norm_elastic = 0;
+          for(int k = 0; k < 6; ++k)
+          {
+            e[k] -= m_plastic[k][g+l];
+            norm_elastic += e[k]*e[k];
+          }
+          norm_elastic = std::sqrt(norm_elastic);
+          real_type const creep  = m_creep[g+l] < max_amount ? m_creep[g+l] : max_amount;
+          real_type const amount = norm_elastic > m_yield[g+l] ? dt*creep : real_type(0);
+
+          //--- Plastic strain is clamped to the maximum magnitude
+          real_type p[6];
+          real_type norm_plastic = 0;
+          for(int k = 0; k < 6; ++k)
+          {
+            p[k] = m_plastic[k][g+l] + amount*e[k];
+            norm_plastic += p[k]*p[k];
+          }
+          norm_plastic = std::sqrt(norm_plastic);
+          real_type const scale = norm_plastic > m_max[g+l] ? m_max[g+l] / norm_plastic : real_type(1);
+          for(int k = 0; k < 6; ++k)
+          {
+            p[k] *= scale;
+            m_plastic[k][g+l] = p[k];
+          }
+
+          //--- f_plastic = Re Pe e_plastic, with P_j = Ve B_j^T E
+          real_type const E0 = m_D[0][g+l];
+          real_type const E1 = m_D[1][g+l];
+          real_type const E2 = m_D[2][g+l];
+          real_type const V  = m_V[g+l];
+          for(int j = 0; j < 4; ++j)
+          {
+            real_type const bj = m_B[3*j][g+l];
+            real_type const cj = m_B[3*j + 1][g+l];
+            real_type const dj = m_B[3*j + 2][g+l];
+            real_type f[3];
+            f[0] = V*( bj*E0*p[0] + bj*E1*p[1] + bj*E1*p[2] + cj*E2*p[3] + dj*E2*p[4] );
+            f[1] = V*( cj*E1*p[0] + cj*E0*p[1] + cj*E1*p[2] + bj*E2*p[3] + dj*E2*p[5] );
+            f[2] = V*( dj*E1*p[0] + dj*E1*p[1] + dj*E0*p[2] + bj*E2*p[4] + cj*E2*p[5] );
+            for(int r = 0; r < 3; ++r)
+              fp[3*j + r][l] = m_R[3*r][g+l]*f[0] + m_R[3*r + 1][g+l]*f[1] + m_R[3*r + 2][g+l]*f[2];
+          }
+        }
+
+        //--- Scatter, one tetrahedron at a time
+        typename system_type::matrix_type & A = system.matrix();
+        for(int l = 0; l < valid; ++l)
+        {
+          int const * scatter = system.scatter( g + l );
+          for(int i = 0; i < 4; ++i)
+          {
+            for(int j = i; j < 4; ++j)
+            {
+              int const b = upper(i,j);
+              matrix3x3_type & A_ij = A.block( scatter[4*i + j] );
+              for(int r = 0; r < 3; ++r)
+                for(int c = 0; c < 3; ++c)
+                  A_ij(r,c) += K[9*b + 3*r + c][l];
+              if(j == i)
+                continue;
+              matrix3x3_type & A_ji = A.block( scatter[4*j + i] );
+              for(int r = 0; r < 3; ++r)
+                for(int c = 0; c < 3; ++c)
+                  A_ji(c,r) += K[9*b + 3*r + c][l];
+            }
+
+            node_iterator n = mesh.node( m_node[i][g+l] );
+            for(int k = 0; k < 3; ++k)
+            {
+              n->m_f0(k)         += f0[3*i + k][l];
+              n->m_f_external(k) += fp[3*i + k][l];
+            }
+          }
+        }
+      }
+
+    };
+
+  } // namespace fem
+} // namespace OpenTissue
+
+//OPENTISSUE_DYNAMICS_FEM_FEM_COROTATIONAL_ELEMENTS_H
+#endif
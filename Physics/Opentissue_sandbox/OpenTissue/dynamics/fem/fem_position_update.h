@@ -26,12 +26,12 @@ namespace OpenTissue
       inline void position_update(fem_mesh & mesh, real_type const & dt)
       {
         typedef typename fem_mesh::node_iterator            node_iterator;
-        typedef typename fem_mesh::tetrahedron_iterator     tetrahedron_iterator;
 
-        node_iterator Nbegin = mesh.node_begin();
-        node_iterator Nend   = mesh.node_end();
-        for (node_iterator N = Nbegin;N!=Nend;++N)
+        int const count = static_cast<int>( mesh.size_nodes() );
+#pragma omp parallel for
+        for (int i = 0; i < count; ++i)
         {
+          node_iterator N = mesh.node(i);
           if(N->m_fixed)
             continue;
           N->m_coord += dt * N->m_velocity;
@@ -17,6 +17,8 @@
 #include <OpenTissue/dynamics/fem/fem_dynamics_assembly.h>
 #include <OpenTissue/dynamics/fem/fem_conjugate_gradients.h>
 #include <OpenTissue/dynamics/fem/fem_position_update.h>
+#include <OpenTissue/dynamics/fem/fem_block_csr_system.h>
+#include <OpenTissue/dynamics/fem/fem_corotational_elements.h>
 
 namespace OpenTissue
 {
@@ -112,6 +114,69 @@ namespace OpenTissue
       detail::position_update(mesh,time_step);
     }
 
+    /**
+    * Simulate.
+    * Same as above, except that the stiffness matrix and the dynamic
+    * equation are assembled into the block CSR matrix of the given system
+    * and solved by its preconditioned conjugate gradient method. The
+    * mass damping, number of iterations, tolerance and preconditioner are
+    * taken from the system.
+    *
+    * @param mesh
+    * @param time_step
+    * @param use_stiffness_warping
+    * @param system
+    */
+    template < typename fem_mesh, typename real_type >
+    inline void simulate(
+      fem_mesh & mesh
+      , real_type const & time_step
+      , bool use_stiffness_warping
+      , BlockCSRSystem<fem_mesh> & system
+      )
+    {
+      if(use_stiffness_warping)
+        detail::update_orientation(mesh.tetrahedron_begin(),mesh.tetrahedron_end());
+      else
+        detail::reset_orientation(mesh.tetrahedron_begin(),mesh.tetrahedron_end());
+
+      system.stiffness_assembly(mesh);
+
+      detail::add_plasticity_force(mesh.tetrahedron_begin(),mesh.tetrahedron_end(),time_step);
+
+      system.dynamics_assembly(mesh,system.get_mass_damping(),time_step);
+      system.conjugate_gradients(mesh);
+      detail::position_update(mesh,time_step);
+    }
+
+    /**
+    * Simulate.
+    * Same as above, except that the rotations, warped stiffness matrix and
+    * plastic forces are computed by the data parallel kernels of the given
+    * elements, see CorotationalElements.
+    *
+    * @param mesh
+    * @param time_step
+    * @param use_stiffness_warping
+    * @param system
+    * @param elements
+    */
+    template < typename fem_mesh, typename real_type >
+    inline void simulate(
+      fem_mesh & mesh
+      , real_type const & time_step
+      , bool use_stiffness_warping
+      , BlockCSRSystem<fem_mesh> & system
+      , CorotationalElements<fem_mesh> & elements
+      )
+    {
+      elements.run(mesh, system, time_step, use_stiffness_warping);
+
+      system.dynamics_assembly(mesh,system.get_mass_damping(),time_step);
+      system.conjugate_gradients(mesh);
+      detail::position_update(mesh,time_step);
+    }
+
   } // namespace fem
 } // namespace OpenTissue
 
@@ -88,6 +88,7 @@ namespace OpenTissue
       public:
         edge_traits()
           : m_ccg_time_stamp(0) 
+          , m_ccg_changed(false)
         {}
       public:
         coordsys_type m_ccg_xformAtoB;          ///< Storage holder for relative transform between A and B.
@@ -96,6 +97,7 @@ namespace OpenTissue
         size_type  m_ccg_time_stamp;         ///< Time-stamp indicating when the edge was detected by the broad phase collision detection algorithm.
         CCG_StateType m_ccg_state;              ///< The current contact state
         CCG_ColorType m_ccg_color;              ///< Color type is used for traversing contact groups.
+        bool m_ccg_changed;                     ///< Boolean flag indicating whether the broad phase reported that the overlap state of the body pair changed.
       };
       class constraint_traits { };
 
@@ -144,7 +146,11 @@ namespace OpenTissue
             continue;
           if(!edge->get_body_A()->is_active() || !edge->get_body_B()->is_active())
             continue;
-          if(edge->get_body_A()->m_ccg_absolute_resting &&  edge->get_body_B()->m_ccg_absolute_resting )
+          //--- A body pair that just started overlapping can not reuse
+          //--- anything cached from the last time it was overlapping.
+          bool const changed = edge->m_ccg_changed;
+          edge->m_ccg_changed = false;
+          if(!changed && edge->get_body_A()->m_ccg_absolute_resting &&  edge->get_body_B()->m_ccg_absolute_resting )
           {
             edge->m_relative_resting = true;
             continue;
@@ -159,7 +165,7 @@ namespace OpenTissue
           //--- Test whetever relative placement of objects have
           //--- changed since last iteration
           real_type epsilon = OpenTissue::math::working_precision<real_type>();
-          if( edge->m_ccg_xformAtoB.is_equal(edge->m_ccg_xformAtoB_prev,epsilon))
+          if( !changed && edge->m_ccg_xformAtoB.is_equal(edge->m_ccg_xformAtoB_prev,epsilon))
           {
             //--- A and B have not moved relatively to each other, so
             //--- we should be able to exploit both the narrow phase
@@ -188,6 +194,26 @@ namespace OpenTissue
         return penetration;
       };
 
+      /**
+      * Broad Phase Changes.
+      * Broad phase algorithms that keep track of their reported overlaps
+      * use this method to tell which body pairs started and stopped
+      * overlapping. Cached results of these body pairs are invalidated.
+      *
+      * @param added     The body pairs that started overlapping.
+      * @param removed   The body pairs that stopped overlapping.
+      */
+      void broad_phase_changes( edge_ptr_container & added, edge_ptr_container & removed )
+      {
+        for( indirect_edge_iterator edge = indirect_edge_iterator(added.begin()); edge!=indirect_edge_iterator(added.end()); ++edge )
+          edge->m_ccg_changed = true;
+        for( indirect_edge_iterator edge = indirect_edge_iterator(removed.begin()); edge!=indirect_edge_iterator(removed.end()); ++edge )
+        {
+          edge->m_ccg_changed = true;
+          edge->m_ccg_state = edge_type::separating;
+        }
+      }
+
       /**
       * Absolute Resting Test.
       * This method examines each body in the configuration and tries to determine
@@ -20,6 +20,17 @@ namespace OpenTissue
     * in most others collsion detection engines. The different thing is
     * that there is an explicit contact determination phase and a spatical-temporal
     * analysis phase (see DIKU technical report no. 04-06 for more details).
+    *
+    * Besides init(), clear(), add(), remove() and run(), a broad phase
+    * policy must provide the hook
+    *
+    *   template<typename analyzer_type> void report_changes(analyzer_type & analyzer)
+    *
+    * It is invoked right after every run() of the broad phase. Broad phases
+    * that keep track of which overlaps started and stopped in the last run
+    * (like IncrementalSweepNPrune) pass them on through the analyzer method
+    * broad_phase_changes(added, removed), all others implement it as a no-op.
+    * Analyzer policies must therefore provide broad_phase_changes() too.
     */
     template<
       typename types,                                                ///< This is suppsed to be the TypeBinder.
@@ -126,6 +137,7 @@ namespace OpenTissue
         edge_ptr_container edges;
         bool penetration = false;
         m_broad_phase.run(edges);
+        m_broad_phase.report_changes(m_analyzer);
 
 
         indirect_edge_iterator begin(edges.begin());
@@ -68,6 +68,13 @@ namespace OpenTissue
       void add(body_type * /*body*/)  {  };
       void remove(body_type * /*body*/)  {    };
 
+      /**
+      * Report Changes.
+      * This broad phase do not keep track of which overlaps that changed, so nothing is reported.
+      */
+      template<typename analyzer_type>
+      void report_changes(analyzer_type & /*analyzer*/)  {  };
+
       /**
       * Run Exhaustive Search.
       *
@@ -0,0 +1,468 @@
+#ifndef OPENTISSUE_DYNAMICS_MBD_COLLISION_DETECTION_MBD_INCREMENTAL_SWEEP_AND_PRUNE_H
+#define OPENTISSUE_DYNAMICS_MBD_COLLISION_DETECTION_MBD_INCREMENTAL_SWEEP_AND_PRUNE_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace mbd
+  {
+
+    /**
+    * The Incremental Sweep N' Prune Broad Phase Collision Detection Algorithm.
+    *
+    * Like SweepNPrune this keeps the interval endpoints of the bodies sorted
+    * along the three coordinate axes from one invocation to the next, such
+    * that temporal coherence makes the insertion sort run in expected linear
+    * time. The difference is in the bookkeeping:
+    *
+    *   - The AABBs and the endpoints of every axis are stored as contiguous
+    *     arrays (one array of values and one of endpoint ids per axis)
+    *     instead of linked lists of pointers.
+    *   - The AABBs are updated and the three axes are sorted concurrently.
+    *     A swap of a begin and an end point does not touch the contact
+    *     graph, it only records the body pair as a candidate.
+    *   - The candidates of all axes are tested for overlap on all three
+    *     axes concurrently, and only pairs whose overlap state changed are
+    *     updated in the contact graph.
+    *
+    * If nothing moves there are no swaps and no candidates, so the run
+    * method does no allocations and no contact graph lookups. The body
+    * pairs that started or stopped overlapping in the last invocation are
+    * reported to the analyzer through report_changes(). Parallelization
+    * is done with OpenMP when it is enabled, the body methods used to
+    * compute the collision AABBs are assumed to be thread safe.
+    */
+    template<typename types>
+    class IncrementalSweepNPrune
+    {
+    protected:
+
+      typedef typename types::math_policy::index_type      size_type;
+      typedef typename types::math_policy::real_type       real_type;
+      typedef typename types::math_policy::vector3_type    vector3_type;
+      typedef typename types::math_policy::matrix3x3_type  matrix3x3_type;
+      typedef typename types::configuration_type           configuration_type;
+      typedef typename types::body_type                    body_type;
+      typedef typename types::edge_type                    edge_type;
+      typedef typename types::edge_ptr_container           edge_ptr_container;
+
+      typedef std::vector<real_type>         real_container;
+      typedef std::vector<int>               int_container;
+      typedef std::pair<int,int>             slot_pair;
+      typedef std::vector<slot_pair>         slot_pair_container;
+
+      /**
+      * A reported overlap, the slots are kept such that a removed body can be
+      * purged without touching the edges the configuration already deleted.
+      */
+      class overlap_record
+      {
+      public:
+        edge_type * m_edge;
+        int         m_slot_A;
+        int         m_slot_B;
+      };
+
+      typedef std::vector<overlap_record>    overlap_container;
+
+    public:
+
+      class node_traits
+      {
+      public:
+        node_traits():m_isnp_slot(-1){};
+      public:
+        int m_isnp_slot;   ///< Index of the body in the AABB arrays, -1 if the body is not added.
+      };
+
+      class edge_traits
+      {
+      public:
+        edge_traits():m_isnp_overlap(false),m_isnp_record(0){};
+      public:
+        bool   m_isnp_overlap;   ///< Boolean flag indicating whether the AABBs of the body pair overlap.
+        size_t m_isnp_record;    ///< Index of the overlap record of the edge, only valid if m_isnp_overlap is true.
+      };
+
+      class constraint_traits {  };
+
+    protected:
+
+      configuration_type *     m_configuration;  ///< A pointer to the configuration the broad phase works on.
+      std::vector<body_type*>  m_bodies;         ///< The body of every slot, null for free slots.
+      int_container            m_free_slots;     ///< Slots of removed bodies that can be reused.
+      real_container           m_min[3];         ///< Lower AABB corner of every slot, one array per axis.
+      real_container           m_max[3];         ///< Upper AABB corner of every slot, one array per axis.
+      real_container           m_values[3];      ///< Sorted endpoint values of every axis.
+      int_container            m_endpoints[3];   ///< Endpoint ids of every axis, 2*slot for begin points and 2*slot+1 for end points.
+      slot_pair_container      m_swaps[3];       ///< Body pairs of begin and end points swapped while sorting an axis.
+      slot_pair_container      m_candidates;     ///< Body pairs whose overlap state might have changed.
+      std::vector<char>        m_overlaps;       ///< Overlap state of every candidate.
+      overlap_container        m_reported;       ///< The currently overlapping body pairs.
+      edge_ptr_container       m_added;          ///< Body pairs that started overlapping in the last invocation.
+      edge_ptr_container       m_removed;        ///< Body pairs that stopped overlapping in the last invocation.
+      bool                     m_rebuild;        ///< Boolean flag indicating whether the endpoints must be sorted from scratch.
+
+    public:
+
+      IncrementalSweepNPrune()
+        : m_configuration(0)
+        , m_rebuild(false)
+      {}
+
+    public:
+
+      void clear()
+      {
+        for(size_t slot = 0; slot < m_bodies.size(); ++slot)
+          if(m_bodies[slot])
+            m_bodies[slot]->m_isnp_slot = -1;
+        for(size_t i = 0; i < m_reported.size(); ++i)
+          m_reported[i].m_edge->m_isnp_overlap = false;
+        m_bodies.clear();
+        m_free_slots.clear();
+        for(int axis = 0; axis < 3; ++axis)
+        {
+          m_min[axis].clear();
+          m_max[axis].clear();
+          m_values[axis].clear();
+          m_endpoints[axis].clear();
+          m_swaps[axis].clear();
+        }
+        m_candidates.clear();
+        m_reported.clear();
+        m_added.clear();
+        m_removed.clear();
+        m_rebuild = false;
+        this->m_configuration = 0;
+      }
+
+      void init(configuration_type & configuration)
+      {
+        clear();
+        m_configuration = &configuration;
+      }
+
+      void add(body_type * body)
+      {
+        assert(m_configuration);
+        assert(body->m_isnp_slot < 0 || !"IncrementalSweepNPrune::add(): body was already added");
+        int slot = static_cast<int>(m_bodies.size());
+        if(!m_free_slots.empty())
+        {
+          slot = m_free_slots.back();
+          m_free_slots.pop_back();
+          m_bodies[slot] = body;
+        }
+        else
+        {
+          m_bodies.push_back(body);
+          for(int axis = 0; axis < 3; ++axis)
+          {
+            m_min[axis].push_back(real_type(0));
+            m_max[axis].push_back(real_type(0));
+          }
+        }
+        body->m_isnp_slot = slot;
+        for(int axis = 0; axis < 3; ++axis)
+        {
+          m_endpoints[axis].push_back(2*slot);
+          m_endpoints[axis].push_back(2*slot+1);
+          m_values[axis].resize(m_endpoints[axis].size());
+        }
+        // The AABB of a new body is not known yet, so the endpoints are sorted from scratch in the next run
+        m_rebuild = true;
+      }
+
+      void remove(body_type * body)
+      {
+        assert(m_configuration);
+        int const slot = body->m_isnp_slot;
+        if(slot < 0)
+          return;
+
+        for(int axis = 0; axis < 3; ++axis)
+        {
+          size_t k = 0;
+          for(size_t i = 0; i < m_endpoints[axis].size(); ++i)
+          {
+            if(m_endpoints[axis][i]/2 == slot)
+              continue;
+            m_endpoints[axis][k] = m_endpoints[axis][i];
+            m_values[axis][k] = m_values[axis][i];
+            ++k;
+          }
+          m_endpoints[axis].resize(k);
+          m_values[axis].resize(k);
+        }
+
+        // The configuration have already deleted the edges of the body, so they must not be dereferenced
+        for(size_t i = m_reported.size(); i > 0; --i)
+        {
+          if(m_reported[i-1].m_slot_A == slot || m_reported[i-1].m_slot_B == slot)
+          {
+            m_reported[i-1] = m_reported.back();
+            m_reported.pop_back();
+            if(i-1 < m_reported.size())
+              m_reported[i-1].m_edge->m_isnp_record = i-1;
+          }
+        }
+
+        m_bodies[slot] = 0;
+        m_free_slots.push_back(slot);
+        body->m_isnp_slot = -1;
+      }
+
+      /**
+      * Run Incremental SweepNPrune Algorithm.
+      *
+      * @param edges   Upon return this argument holds all the reported overlaps.
+      */
+      void run(edge_ptr_container & edges)
+      {
+        assert(m_configuration);
+
+        update_aabbs();
+
+        m_candidates.clear();
+        if(m_rebuild)
+        {
+          rebuild();
+          m_rebuild = false;
+        }
+        else
+        {
+#pragma omp parallel for
+          for(int axis = 0; axis < 3; ++axis)
+            sort(axis);
+          for(int axis = 0; axis < 3; ++axis)
+            m_candidates.insert(m_candidates.end(), m_swaps[axis].begin(), m_swaps[axis].end());
+        }
+
+        std::sort(m_candidates.begin(), m_candidates.end());
+        m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()), m_candidates.end());
+
+        // Multi axis overlap test of the candidates
+        int const count = static_cast<int>(m_candidates.size());
+        m_overlaps.resize(count);
+#pragma omp parallel for
+        for(int i = 0; i < count; ++i)
+          m_overlaps[i] = overlap(m_candidates[i].first, m_candidates[i].second) ? 1 : 0;
+
+        m_added.clear();
+        m_removed.clear();
+        for(int i = 0; i < count; ++i)
+          update_pair(m_candidates[i].first, m_candidates[i].second, m_overlaps[i] != 0);
+
+        edges.clear();
+        for(size_t i = 0; i < m_reported.size(); ++i)
+          edges.push_back(m_reported[i].m_edge);
+      }
+
+      /**
+      * Report Changes.
+      * Tells the analyzer which body pairs started and stopped
+      * overlapping in the last invocation of the run method.
+      *
+      * @param analyzer   The spatial temporal analyzer of the collision detection engine.
+      */
+      template<typename analyzer_type>
+      void report_changes(analyzer_type & analyzer)
+      {
+        analyzer.broad_phase_changes(m_added, m_removed);
+      }
+
+      edge_ptr_container const & added()   const { return m_added;   }
+      edge_ptr_container const & removed() const { return m_removed; }
+
+    protected:
+
+      void update_aabbs()
+      {
+        real_type const envelope = m_configuration->get_collision_envelope();
+        int const slots = static_cast<int>(m_bodies.size());
+#pragma omp parallel for
+        for(int slot = 0; slot < slots; ++slot)
+        {
+          body_type * body = m_bodies[slot];
+          if(!body)
+            continue;
+          vector3_type pmin,pmax,r;
+          matrix3x3_type R;
+          body->get_position(r);
+          body->get_orientation(R);
+          body->compute_collision_aabb(r,R,pmin,pmax,envelope);
+          for(int axis = 0; axis < 3; ++axis)
+          {
+            m_min[axis][slot] = pmin(axis);
+            m_max[axis][slot] = pmax(axis);
+          }
+        }
+      }
+
+      real_type value(int axis, int endpoint) const
+      {
+        return (endpoint & 1) ? m_max[axis][endpoint/2] : m_min[axis][endpoint/2];
+      }
+
+      /**
+      * Wrongly Sorted Query Method, see SweepNPrune::isWrong().
+      * Values are sorted in increasing order and begin points come before end points of equal value.
+      */
+      static bool is_wrong(real_type const & left_value, int left, real_type const & right_value, int right)
+      {
+        if(right_value < left_value)
+          return true;
+        return (right_value == left_value) && !(right & 1) && (left & 1);
+      }
+
+      /**
+      * Insertion sort of the endpoints of an axis.
+      * Every swap of a begin and an end point of different bodies records the body pair in m_swaps[axis].
+      */
+      void sort(int axis)
+      {
+        real_container & values = m_values[axis];
+        int_container & endpoints = m_endpoints[axis];
+        slot_pair_container & swaps = m_swaps[axis];
+        swaps.clear();
+
+        int const count = static_cast<int>(endpoints.size());
+        for(int i = 0; i < count; ++i)
+          values[i] = value(axis, endpoints[i]);
+
+        for(int i = 1; i < count; ++i)
+        {
+          real_type const v = values[i];
+          int const e = endpoints[i];
+          int j = i;
+          while(j > 0 && is_wrong(values[j-1], endpoints[j-1], v, e))
+          {
+            int const f = endpoints[j-1];
+            if(((e ^ f) & 1) && (e/2 != f/2))
+              swaps.push_back(make_pair(e/2, f/2));
+            values[j] = values[j-1];
+            endpoints[j] = f;
+            --j;
+          }
+          values[j] = v;
+          endpoints[j] = e;
+        }
+      }
+
+      class endpoint_less
+      {
+      public:
+        endpoint_less(IncrementalSweepNPrune const * owner, int axis):m_owner(owner),m_axis(axis){}
+        bool operator()(int a, int b) const
+        {
+          return is_wrong(m_owner->value(m_axis,b), b, m_owner->value(m_axis,a), a);
+        }
+      protected:
+        IncrementalSweepNPrune const * m_owner;
+        int m_axis;
+      };
+
+      /**
+      * Sort all axes from scratch and find all overlaps by a single sweep along the x-axis.
+      * The candidates are all overlaps found and all previously reported overlaps.
+      */
+      void rebuild()
+      {
+        for(int axis = 0; axis < 3; ++axis)
+        {
+          m_swaps[axis].clear();
+          std::sort(m_endpoints[axis].begin(), m_endpoints[axis].end(), endpoint_less(this,axis));
+          for(size_t i = 0; i < m_endpoints[axis].size(); ++i)
+            m_values[axis][i] = value(axis, m_endpoints[axis][i]);
+        }
+
+        int_container active;
+        int_container position(m_bodies.size(), -1);
+        for(size_t i = 0; i < m_endpoints[0].size(); ++i)
+        {
+          int const e = m_endpoints[0][i];
+          int const slot = e/2;
+          if(e & 1)
+          {
+            active[position[slot]] = active.back();
+            position[active.back()] = position[slot];
+            active.pop_back();
+            continue;
+          }
+          for(size_t j = 0; j < active.size(); ++j)
+            m_candidates.push_back(make_pair(slot, active[j]));
+          position[slot] = static_cast<int>(active.size());
+          active.push_back(slot);
+        }
+
+        for(size_t i = 0; i < m_reported.size(); ++i)
+          m_candidates.push_back(make_pair(m_reported[i].m_slot_A, m_reported[i].m_slot_B));
+      }
+
+      slot_pair make_pair(int a, int b) const
+      {
+        return (a < b) ? slot_pair(a,b) : slot_pair(b,a);
+      }
+
+      bool overlap(int a, int b) const
+      {
+        for(int axis = 0; axis < 3; ++axis)
+        {
+          if(m_min[axis][a] > m_max[axis][b] || m_min[axis][b] > m_max[axis][a])
+            return false;
+        }
+        return true;
+      }
+
+      void update_pair(int a, int b, bool overlapping)
+      {
+        body_type * A = m_bodies[a];
+        body_type * B = m_bodies[b];
+        edge_type * edge = m_configuration->get_edge(A,B);
+        bool const reported = edge && edge->m_isnp_overlap;
+
+        if(overlapping && !reported)
+        {
+          if(!edge)
+            edge = m_configuration->add(A,B);
+          overlap_record record;
+          record.m_edge = edge;
+          record.m_slot_A = a;
+          record.m_slot_B = b;
+          edge->m_isnp_overlap = true;
+          edge->m_isnp_record = m_reported.size();
+          m_reported.push_back(record);
+          m_added.push_back(edge);
+        }
+        if(!overlapping && reported)
+        {
+          size_t const i = edge->m_isnp_record;
+          m_reported[i] = m_reported.back();
+          m_reported.pop_back();
+          if(i < m_reported.size())
+            m_reported[i].m_edge->m_isnp_record = i;
+          edge->m_isnp_overlap = false;
+          m_removed.push_back(edge);
+        }
+      }
+
+    };
+
+  } // namespace mbd
+} // namespace OpenTissue
+
+// OPENTISSUE_DYNAMICS_MBD_COLLISION_DETECTION_MBD_INCREMENTAL_SWEEP_AND_PRUNE_H
+#endif
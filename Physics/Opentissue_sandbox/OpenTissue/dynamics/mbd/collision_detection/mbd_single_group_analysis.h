@@ -341,6 +341,7 @@ namespace OpenTissue
 
       void add(body_type * /*body*/){};
       void remove(body_type * /*body*/){};
+      void broad_phase_changes(edge_ptr_container & /*added*/, edge_ptr_container & /*removed*/){};
       void init(configuration_type & configuration)
       {
         clear();
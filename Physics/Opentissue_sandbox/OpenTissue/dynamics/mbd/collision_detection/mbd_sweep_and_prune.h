@@ -248,6 +248,13 @@ namespace OpenTissue
         edges.assign(m_reported.begin(),m_reported.end());
       }
 
+      /**
+      * Report Changes.
+      * This broad phase do not keep track of which overlaps that changed, so nothing is reported.
+      */
+      template<typename analyzer_type>
+      void report_changes(analyzer_type & /*analyzer*/)  {  };
+
     protected:
 
       /**
@@ -0,0 +1,526 @@
+#ifndef OPENTISSUE_DYNAMICS_MBD_UTIL_SOLVERS_MBD_PARALLEL_PROJECTED_GAUSS_SEIDEL_H
+#define OPENTISSUE_DYNAMICS_MBD_UTIL_SOLVERS_MBD_PARALLEL_PROJECTED_GAUSS_SEIDEL_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/dynamics/mbd/interfaces/mbd_ncp_solver_interface.h>
+#include <OpenTissue/dynamics/mbd/solvers/mbd_merit.h>
+#include <OpenTissue/dynamics/mbd/math/mbd_math_compute_WJT.h>
+#include <OpenTissue/core/math/math_is_number.h>
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+
+namespace OpenTissue
+{
+  namespace mbd
+  {
+
+    /**
+    * Parallel Projected Gauss-Seidel.
+    *
+    * Solves the same problem as ProjectedGaussSeidel, but decomposes the
+    * constraint graph into independent islands first. Two rows belong to
+    * the same island if they are connected through non-fixed bodies, fixed
+    * bodies have a zero inverse mass and do not connect islands. This is
+    * the same connected component search as done by the contact graph
+    * analysis, but it is done on the body blocks of the jacobian, since the
+    * solver only sees the assembled system of a group.
+    *
+    * Small islands are solved concurrently, each by an ordinary sequential
+    * sweep. Islands with more rows than the coloring threshold are split
+    * into blocks of consecutive rows acting on the same body pair, the
+    * blocks are greedy colored such that no two blocks of a color share a
+    * non-fixed body and the blocks of a color are solved concurrently.
+    *
+    * The jacobian and W J^T rows are copied into contiguous storage of
+    * twelve values per row together with the two body indices, and the
+    * f = W J^T x vector is updated per body, so the sweeps never touch the
+    * compressed matrices. Parallelization is done with OpenMP when it is
+    * enabled, otherwise the solver runs sequentially.
+    */
+    template<  typename math_policy  >
+    class ParallelProjectedGaussSeidel
+      : public NCPSolverInterface<math_policy>
+    {
+    protected:
+
+      typedef typename math_policy::value_traits        value_traits;
+      typedef typename math_policy::real_type           real_type;
+      typedef typename math_policy::size_type           size_type;
+      typedef typename math_policy::matrix_type         matrix_type;
+      typedef typename math_policy::system_matrix_type  system_matrix_type;
+      typedef typename math_policy::vector_type         vector_type;
+      typedef typename math_policy::idx_vector_type     idx_vector_type;
+
+      typedef std::vector<real_type>  real_container;
+      typedef std::vector<int>        int_container;
+
+      static const int max_colors = 64;  ///< Number of colors in the color masks, blocks that cannot be colored are solved sequentially.
+
+    protected:
+
+      size_type            m_iterations;          ///< Maximum allowed number of iterations, default value is 5.
+      bool                 m_profiling;           ///< Boolean flag indicating whether profiling of the solver is turned on or off. Default value is false.
+      vector_type          m_theta;               ///< vector used for profiling. The i'th entry stores the value of the merit-function after the i'th iteration of the solver.
+      system_matrix_type   m_A;                   ///< System matrix, only used for profiling.
+      size_type            m_coloring_threshold;  ///< Islands with more rows than this are solved by graph colored sweeps. Default value is 256.
+
+      matrix_type          m_WJT;                 ///< The value of prod(W,trans(J)) stored as prod(J,W).
+      real_container       m_J_blocks;            ///< Twelve jacobian values per row.
+      real_container       m_WJT_blocks;          ///< Twelve W J^T values per row.
+      int_container        m_bodies;              ///< The two body indices of every row.
+      std::vector<char>    m_fixed;               ///< Per body, non-zero if the body has zero inverse mass.
+      real_container       m_d;                   ///< Diagonal of the system matrix.
+      real_container       m_f;                   ///< The f = W J^T x vector, six values per body.
+
+      int_container        m_rows;                ///< Rows sorted by island, in their original order within an island.
+      int_container        m_island_begin;        ///< First position in m_rows of every island, one extra entry at the end.
+      int_container        m_small_islands;       ///< Islands solved by sequential sweeps.
+      int_container        m_large_islands;       ///< Islands solved by colored sweeps.
+      int_container        m_island_phase_begin;  ///< First phase of every large island, one extra entry at the end.
+      int_container        m_phase_begin;         ///< First block in m_phase_blocks of every phase, one extra entry at the end.
+      std::vector<char>    m_phase_parallel;      ///< Per phase, zero if the blocks of the phase must be solved sequentially.
+      int_container        m_phase_blocks;        ///< Blocks of all phases.
+      int_container        m_block_begin;         ///< First position in m_rows of every block.
+      int_container        m_block_end;           ///< One past the last position in m_rows of every block.
+
+    public:
+
+      void set_max_iterations(size_type value)
+      {
+        assert(value>0 || !"ParallelProjectedGaussSeidel::set_max_iterations(): value must be positive");
+        m_iterations = value;
+      }
+
+      void set_coloring_threshold(size_type value)
+      {
+        m_coloring_threshold = value;
+      }
+
+      bool       & profiling()       { return m_profiling; }
+      bool const & profiling() const { return m_profiling; }
+
+      vector_type const & theta() const { return m_theta; }
+
+
+      real_type get_accuracy() const { return value_traits::zero(); } // Oups not implemented!
+      size_t    get_iteration() const { return 0; }                   // Oups not implemented!
+
+
+    public:
+
+      ParallelProjectedGaussSeidel()
+        : m_iterations(5)
+        , m_profiling(false)
+        , m_coloring_threshold(256)
+      {}
+
+      virtual ~ParallelProjectedGaussSeidel(){}
+
+    public:
+
+      void run(
+          matrix_type const & J
+        , matrix_type const & W
+        , vector_type const & gamma
+        , vector_type const & b
+        , vector_type & lo
+        , vector_type & hi
+        , idx_vector_type const & pi
+        , vector_type const & mu
+        , vector_type & x
+        )
+      {
+        if(this->profiling())
+          math_policy::resize(m_theta,m_iterations);
+
+        size_type m;
+        math_policy::get_dimension(b,m);
+
+        if(m==0)
+          return;
+
+        if(this->profiling())
+          math_policy::compute_system_matrix(W, J, m_A);
+
+        setup_blocks(J, W);
+        setup_islands();
+        setup_colors();
+
+        int const small_count = static_cast<int>(m_small_islands.size());
+
+        // f = W J^T x, every body belongs to a single island so the islands can be initialized concurrently
+        std::fill(m_f.begin(), m_f.end(), value_traits::zero());
+        int const island_count = static_cast<int>(m_island_begin.size()) - 1;
+#pragma omp parallel for schedule(dynamic)
+        for (int island = 0; island < island_count; ++island)
+        {
+          for (int pos = m_island_begin[island]; pos < m_island_begin[island+1]; ++pos)
+            update_f(m_rows[pos], x(m_rows[pos]));
+        }
+
+        for (size_type k = 0; k < m_iterations; ++k)
+        {
+#pragma omp parallel for schedule(dynamic)
+          for (int s = 0; s < small_count; ++s)
+          {
+            int const island = m_small_islands[s];
+            for (int pos = m_island_begin[island]; pos < m_island_begin[island+1]; ++pos)
+              solve_row(m_rows[pos], k, m, gamma, b, lo, hi, pi, mu, x);
+          }
+
+          for (size_t l = 0; l < m_large_islands.size(); ++l)
+          {
+            for (int phase = m_island_phase_begin[l]; phase < m_island_phase_begin[l+1]; ++phase)
+            {
+              int const first = m_phase_begin[phase];
+              int const last  = m_phase_begin[phase+1];
+              if(m_phase_parallel[phase])
+              {
+#pragma omp parallel for schedule(dynamic, 16)
+                for (int block = first; block < last; ++block)
+                  solve_block(m_phase_blocks[block], k, m, gamma, b, lo, hi, pi, mu, x);
+              }
+              else
+              {
+                for (int block = first; block < last; ++block)
+                  solve_block(m_phase_blocks[block], k, m, gamma, b, lo, hi, pi, mu, x);
+              }
+            }
+          }
+
+          if(this->profiling())
+          {
+            math_policy::init_system_matrix(m_A,x);
+            m_theta(k) = mbd::merit(m_A,x,b,lo,hi,math_policy());
+          }
+        }
+      }
+
+    protected:
+
+      /**
+      * Copy the jacobian and W J^T rows into contiguous storage.
+      */
+      void setup_blocks(matrix_type const & J, matrix_type const & W)
+      {
+        size_type const m = J.size1();
+        size_type const n = J.size2()/6;
+
+        math::compute_WJT(W,J,m_WJT);
+
+        m_J_blocks.resize(12*m);
+        m_WJT_blocks.resize(12*m);
+        m_bodies.resize(2*m);
+        m_d.resize(m);
+        m_f.resize(6*n);
+
+        for (size_type i = 0; i < m; ++i)
+        {
+          size_type const begin = J.index1_data()[i];
+          assert((J.index1_data()[i+1]-begin)==12          || !"ParallelProjectedGaussSeidel::run(): J cannot be a jacobian matrix?");
+          assert(m_WJT.index1_data()[i] == begin           || !"ParallelProjectedGaussSeidel::run(): WJT and J did not have the same format");
+
+          m_bodies[2*i]   = static_cast<int>(J.index2_data()[begin]/6);
+          m_bodies[2*i+1] = static_cast<int>(J.index2_data()[begin+6]/6);
+
+          real_type d = value_traits::zero();
+          for (size_type j = 0; j < 12; ++j)
+          {
+            m_J_blocks[12*i+j]   = J.value_data()[begin+j];
+            m_WJT_blocks[12*i+j] = m_WJT.value_data()[begin+j];
+            d += m_J_blocks[12*i+j]*m_WJT_blocks[12*i+j];
+          }
+          m_d[i] = d;
+        }
+
+        m_fixed.resize(n);
+        for (size_type body = 0; body < n; ++body)
+        {
+          bool fixed = true;
+          for (size_type j = 6*body; j < 6*body+6; ++j)
+            fixed = fixed && !(W(j,j) > value_traits::zero());
+          m_fixed[body] = fixed ? 1 : 0;
+        }
+      }
+
+      int find_root(int_container & parent, int body) const
+      {
+        while(parent[body] != body)
+        {
+          parent[body] = parent[parent[body]];
+          body = parent[body];
+        }
+        return body;
+      }
+
+      /**
+      * Connected component search, the rows are sorted by island.
+      */
+      void setup_islands()
+      {
+        int const m = static_cast<int>(m_d.size());
+        int const n = static_cast<int>(m_fixed.size());
+
+        int_container parent(n);
+        for (int body = 0; body < n; ++body)
+          parent[body] = body;
+
+        for (int i = 0; i < m; ++i)
+        {
+          int const a = m_bodies[2*i];
+          int const c = m_bodies[2*i+1];
+          if(!m_fixed[a] && !m_fixed[c])
+            parent[find_root(parent,a)] = find_root(parent,c);
+        }
+
+        // island index of every root body, rows between two fixed bodies get an island of their own
+        int_container island_of_body(n, -1);
+        int_container island_of_row(m);
+        int islands = 0;
+        for (int i = 0; i < m; ++i)
+        {
+          int const a = m_bodies[2*i];
+          int const c = m_bodies[2*i+1];
+          if(m_fixed[a] && m_fixed[c])
+          {
+            island_of_row[i] = islands++;
+            continue;
+          }
+          int const root = find_root(parent, m_fixed[a] ? c : a);
+          if(island_of_body[root] < 0)
+            island_of_body[root] = islands++;
+          island_of_row[i] = island_of_body[root];
+        }
+
+        // counting sort of the rows by island
+        m_island_begin.assign(islands+1, 0);
+        for (int i = 0; i < m; ++i)
+          ++m_island_begin[island_of_row[i]+1];
+        for (int island = 0; island < islands; ++island)
+          m_island_begin[island+1] += m_island_begin[island];
+        int_container next(m_island_begin.begin(), m_island_begin.end()-1);
+        m_rows.resize(m);
+        for (int i = 0; i < m; ++i)
+          m_rows[next[island_of_row[i]]++] = i;
+
+        m_small_islands.clear();
+        m_large_islands.clear();
+        for (int island = 0; island < islands; ++island)
+        {
+          size_type const rows = m_island_begin[island+1] - m_island_begin[island];
+          if(rows > m_coloring_threshold)
+            m_large_islands.push_back(island);
+          else
+            m_small_islands.push_back(island);
+        }
+      }
+
+      /**
+      * Greedy coloring of the blocks of the large islands.
+      */
+      void setup_colors()
+      {
+        int const n = static_cast<int>(m_fixed.size());
+        std::vector<boost::uint64_t> used(n);
+
+        m_island_phase_begin.assign(1, 0);
+        m_phase_begin.assign(1, 0);
+        m_phase_parallel.clear();
+        m_phase_blocks.clear();
+        m_block_begin.clear();
+        m_block_end.clear();
+
+        std::vector<int_container> colors(max_colors + 1);
+
+        for (size_t l = 0; l < m_large_islands.size(); ++l)
+        {
+          int const island = m_large_islands[l];
+          int const first = m_island_begin[island];
+          int const last  = m_island_begin[island+1];
+
+          for (int color = 0; color <= max_colors; ++color)
+            colors[color].clear();
+
+          int pos = first;
+          while(pos < last)
+          {
+            int const a = m_bodies[2*m_rows[pos]];
+            int const c = m_bodies[2*m_rows[pos]+1];
+
+            // consecutive rows acting on the same body pair form a block, e.g. the normal and friction rows of a contact
+            int end = pos + 1;
+            while(end < last && m_rows[end] == m_rows[end-1]+1 && m_bodies[2*m_rows[end]] == a && m_bodies[2*m_rows[end]+1] == c)
+              ++end;
+
+            boost::uint64_t mask = 0;
+            if(!m_fixed[a])
+              mask |= used[a];
+            if(!m_fixed[c])
+              mask |= used[c];
+
+            int color = 0;
+            while(color < max_colors && (mask & (boost::uint64_t(1) << color)))
+              ++color;
+            if(color < max_colors)
+            {
+              if(!m_fixed[a])
+                used[a] |= boost::uint64_t(1) << color;
+              if(!m_fixed[c])
+                used[c] |= boost::uint64_t(1) << color;
+            }
+
+            colors[color].push_back(static_cast<int>(m_block_begin.size()));
+            m_block_begin.push_back(pos);
+            m_block_end.push_back(end);
+            pos = end;
+          }
+
+          for (int color = 0; color <= max_colors; ++color)
+          {
+            if(colors[color].empty())
+              continue;
+            m_phase_blocks.insert(m_phase_blocks.end(), colors[color].begin(), colors[color].end());
+            m_phase_begin.push_back(static_cast<int>(m_phase_blocks.size()));
+            m_phase_parallel.push_back(color < max_colors ? 1 : 0);
+          }
+          m_island_phase_begin.push_back(static_cast<int>(m_phase_parallel.size()));
+
+          // clear the masks of the bodies of this island
+          for (int p = first; p < last; ++p)
+          {
+            used[m_bodies[2*m_rows[p]]] = 0;
+            used[m_bodies[2*m_rows[p]+1]] = 0;
+          }
+        }
+      }
+
+      /**
+      * Computes: f += row_i(J W) dx
+      */
+      void update_f(int i, real_type const & dx)
+      {
+        for (int side = 0; side < 2; ++side)
+        {
+          int const body = m_bodies[2*i+side];
+          if(m_fixed[body])
+            continue;
+          real_type const * wjt = &m_WJT_blocks[12*i+6*side];
+          real_type * f = &m_f[6*body];
+          for (int j = 0; j < 6; ++j)
+            f[j] += wjt[j]*dx;
+        }
+      }
+
+      /**
+      * Computes: row_i(A) x = row_i(J) f
+      */
+      real_type row_prod(int i) const
+      {
+        real_type const * jac = &m_J_blocks[12*i];
+        real_type const * f_a = &m_f[6*m_bodies[2*i]];
+        real_type const * f_b = &m_f[6*m_bodies[2*i+1]];
+        real_type res = value_traits::zero();
+        for (int j = 0; j < 6; ++j)
+          res += jac[j]*f_a[j] + jac[j+6]*f_b[j];
+        return res;
+      }
+
+      void solve_block(
+          int block
+        , size_type k
+        , size_type m
+        , vector_type const & gamma
+        , vector_type const & b
+        , vector_type & lo
+        , vector_type & hi
+        , idx_vector_type const & pi
+        , vector_type const & mu
+        , vector_type & x
+        )
+      {
+        for (int pos = m_block_begin[block]; pos < m_block_end[block]; ++pos)
+          solve_row(m_rows[pos], k, m, gamma, b, lo, hi, pi, mu, x);
+      }
+
+      /**
+      * Projected Gauss-Seidel update of a single row, see ProjectedGaussSeidel::run().
+      */
+      void solve_row(
+          int i
+        , size_type k
+        , size_type m
+        , vector_type const & gamma
+        , vector_type const & b
+        , vector_type & lo
+        , vector_type & hi
+        , idx_vector_type const & pi
+        , vector_type const & mu
+        , vector_type & x
+        )
+      {
+        using std::fabs;
+
+        real_type new_x  = - b(i);
+        new_x -= row_prod(i);
+
+        assert(is_number(gamma(i))             || !"ParallelProjectedGaussSeidel::run(): not a number encountered");
+        assert(gamma(i)>= value_traits::zero() || !"ParallelProjectedGaussSeidel::run(): gamma(i) was less than 0");
+
+        if(gamma(i) > value_traits::zero())
+        {
+          // Take regularization term lineary to zero
+          real_type alpha = (m_iterations > 1) ? value_traits::one()*(m_iterations-1-k)/(m_iterations-1) : value_traits::zero();
+
+          new_x -= gamma(i)*alpha*x(i);
+          new_x /= m_d[i] + gamma(i)*alpha;
+        }
+        else
+        {
+          assert(m_d[i]>0 || m_d[i]<0 || !"ParallelProjectedGaussSeidel::run(): diagonal entry is zero?");
+          new_x /= m_d[i];
+        }
+
+        new_x += x(i);
+
+        assert(is_number(new_x) || !"ParallelProjectedGaussSeidel::run(): not a number encountered");
+
+        size_type j = pi(i);
+        if (j < m )
+        {
+          assert(is_number(mu(i)) || !"ParallelProjectedGaussSeidel::run(): not a number encountered");
+          hi(i) = fabs(mu(i)*x(j));
+          lo(i) = - hi(i);
+        }
+
+        assert(lo(i)<= value_traits::zero()  || !"ParallelProjectedGaussSeidel::run(): lower limit was positive");
+        assert(hi(i)>= value_traits::zero()  || !"ParallelProjectedGaussSeidel::run(): upper limit was negative");
+
+        real_type old_x = x(i);
+        if(new_x < lo(i))
+          x(i) = lo(i);
+        else if(new_x > hi(i))
+          x(i) = hi(i);
+        else
+          x(i) = new_x;
+
+        update_f(i, x(i)-old_x);
+
+        assert(is_number(x(i)) || !"ParallelProjectedGaussSeidel::run(): not a number encountered");
+      }
+
+    };
+
+  } // namespace mbd
+} // namespace OpenTissue
+
+// OPENTISSUE_DYNAMICS_MBD_UTIL_SOLVERS_MBD_PARALLEL_PROJECTED_GAUSS_SEIDEL_H
+#endif
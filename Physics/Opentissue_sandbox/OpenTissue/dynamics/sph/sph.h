@@ -21,6 +21,7 @@
 #include <OpenTissue/dynamics/sph/sph_particle.h>
 #include <OpenTissue/dynamics/sph/sph_solver.h>
 #include <OpenTissue/dynamics/sph/sph_system.h>
+#include <OpenTissue/dynamics/sph/sph_soa_system.h>
 
 #include <OpenTissue/dynamics/sph/collision/sph_collision.h>
 #include <OpenTissue/dynamics/sph/emitters/sph_emitters.h>
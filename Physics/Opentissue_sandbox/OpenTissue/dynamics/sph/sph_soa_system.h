@@ -0,0 +1,585 @@
+#ifndef OPENTISSUE_DYNAMICS_SPH_SPH_SOA_SYSTEM_H
+#define OPENTISSUE_DYNAMICS_SPH_SPH_SOA_SYSTEM_H
+//
+// OpenTissue Template Library
+// - A generic toolbox for physics-based modeling and simulation.
+// Copyright (C) 2008 Department of Computer Science, University of Copenhagen.
+//
+// OTTL is licensed under zlib: http://opensource.org/licenses/zlib-license.php
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/dynamics/sph/sph_material.h>
+#include <OpenTissue/core/math/math_constants.h>
+#include <OpenTissue/core/math/math_prime_numbers.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace OpenTissue
+{
+  namespace sph
+  {
+
+    /**
+    * Normalization constants of the W_poly6, W_spiky and W_viscosity smoothing kernels.
+    * - Same constants as WPoly6, WSpiky and WViscosity, but without the range check,
+    *   the callers mask the contributions of particles outside the kernel radius so
+    *   the neighbour loops stay branch free and vectorize.
+    */
+    template< typename real_type >
+    class SoAKernels
+    {
+    public:
+
+      SoAKernels()
+      {
+        radius(1);
+      }
+
+      void radius(const real_type& h)
+      {
+        using std::pow;
+        const real_type pi = math::detail::pi<real_type>();
+        m_h = h;
+        m_h2 = h*h;
+        m_poly6 = 315./(64.*pi*pow(h, 9));
+        m_poly6_gradient = -945./(32.*pi*pow(h, 9));
+        m_poly6_laplacian = -945./(32.*pi*pow(h, 9));
+        m_spiky_gradient = -45./(pi*pow(h, 6));
+        m_viscosity_laplacian = 45./(pi*pow(h, 6));
+      }
+
+    public:
+      real_type  m_h;                    ///< Kernel radius.
+      real_type  m_h2;                   ///< Kernel radius squared.
+      real_type  m_poly6;                ///< W_poly6 normalization, times (h^2-r^2)^3.
+      real_type  m_poly6_gradient;       ///< W_poly6 gradient normalization, times (h^2-r^2)^2 r.
+      real_type  m_poly6_laplacian;      ///< W_poly6 laplacian normalization, times (h^2-r^2)(3h^2-7r^2).
+      real_type  m_spiky_gradient;       ///< W_spiky gradient normalization, times (h-|r|)^2 r/|r|.
+      real_type  m_viscosity_laplacian;  ///< W_viscosity laplacian normalization, times (h-|r|).
+    };
+
+
+    /**
+    * SPH System Class with Structure of Arrays particle storage.
+    *
+    * Solves the same model as System with the usual choice of solvers, i.e.
+    * poly6 density, ideal gas pressure, symmetric spiky pressure force,
+    * viscosity kernel viscosity force, poly6 surface normals and tension,
+    * gravity or buoyancy and Verlet integration. As in SurfaceForce the
+    * particle itself is part of the tension laplacian. Densities, pressures,
+    * normals and forces agree with System up to round-off, except that
+    * - the pressure force between two coincident particles is zero, System
+    *   pushes them apart in a random direction, and
+    * - there are no fixed particles, System only has those while they wait
+    *   in an emitter.
+    *
+    * Particles are stored as one array per component. Every step they are
+    * counting sorted by the hash cell of their grid cell (cell size equals the
+    * kernel radius), so the particles of a cell are contiguous in memory. The
+    * density and force passes then loop over the 27 neighbour cells of each
+    * particle directly, no neighbour pair list is built. Both passes, the
+    * sort keys, the permutation and the integration are parallelized with
+    * OpenMP when it is enabled, the inner neighbour loops are branch free
+    * over contiguous arrays and are vectorized.
+    *
+    * Since the particles are reordered every step, id() maps a particle back
+    * to its index at initialization. Emitters are not supported, all particles
+    * are released at initialization.
+    */
+    template< typename Types >
+    class SoASystem
+    {
+    public:
+      typedef typename Types::real_type            real_type;
+      typedef typename Types::vector               vector;
+      typedef typename Types::particle             particle;
+      typedef typename Types::particle_container   particle_container;
+      typedef typename Types::collision_detection  collision_detection;
+      typedef          Material<Types>             fluid_material;
+      typedef          SoAKernels<real_type>       kernels;
+
+    protected:
+      typedef std::vector<real_type>  real_container;
+      typedef std::vector<int>        index_container;
+
+      static const int block_size = 256;  ///< Particles per parallel work item, consecutive particles share their neighbour cells.
+
+    public:
+      /**
+      * Default Constructor.
+      */
+      SoASystem()
+        : m_material(NULL)
+        , m_buoyancy(false)
+        , m_buckets(1)
+      {}
+
+      /**
+      * Deconstructor.
+      */
+      virtual ~SoASystem()
+      {}
+
+    public:
+      /**
+      * Create the SPH system.
+      *
+      * @param material  The fluid material, must outlive the system.
+      * @param gravity   Gravitational acceleration.
+      * @param radius    Smoothing kernel radius, this is also the grid cell size.
+      */
+      bool create(const fluid_material& material, const vector& gravity, const real_type& radius)
+      {
+        assert(radius > 0);
+        clear();
+        m_material = &material;
+        m_kernels.radius(radius);
+        m_gravity = gravity;
+        m_buoyancy = material.buoyancy() > 0;
+        m_dt = material.timestep();
+        m_restitution = material.restitution();
+        return true;
+      }
+
+      collision_detection& collisionSystem()
+      {
+        return m_colisys;
+      }
+
+      const collision_detection& collisionSystem() const
+      {
+        return m_colisys;
+      }
+
+      /**
+      * System Initialization of particles (positions)
+      */
+      template< typename PositionIterator >
+      bool init(const PositionIterator& begin, const PositionIterator& end)
+      {
+        return init<PositionIterator, PositionIterator>(begin, end, end, end);
+      }
+
+      /**
+      * System Initialization of particles (positions and velocities)
+      */
+      template< typename PositionIterator, typename VelocityIterator >
+      bool init(const PositionIterator& pbegin, const PositionIterator& pend, const VelocityIterator& vbegin, const VelocityIterator& vend)
+      {
+        if (!m_material)
+          return false;
+
+        clear();
+        VelocityIterator vel = vbegin;
+        for (PositionIterator pos = pbegin; pos != pend; ++pos) {
+          const vector& x = *pos;
+          vector v(0,0,0);
+          if (vel != vend) {
+            v = *vel;
+            ++vel;
+          }
+          m_id.push_back(static_cast<int>(m_id.size()));
+          m_x.push_back(x(0));  m_y.push_back(x(1));  m_z.push_back(x(2));
+          m_ox.push_back(x(0)-v(0));  m_oy.push_back(x(1)-v(1));  m_oz.push_back(x(2)-v(2));
+          m_vx.push_back(v(0));  m_vy.push_back(v(1));  m_vz.push_back(v(2));
+        }
+
+        const size_t n = m_id.size();
+        m_density.resize(n);
+        m_pressure.resize(n);
+        m_fx.resize(n);  m_fy.resize(n);  m_fz.resize(n);
+        m_nx.resize(n);  m_ny.resize(n);  m_nz.resize(n);
+        m_key.resize(n);
+        m_permutation.resize(n);
+        m_scratch.resize(n);
+        m_index_scratch.resize(n);
+
+        // about two hash cells per particle keeps the buckets short
+        m_buckets = math::prime_search(static_cast<int>(2*n+1));
+        m_bucket_begin.resize(m_buckets+1);
+
+        // init dynamics (no integration)
+        return solve();
+      }
+
+      /**
+      * Sort particles by cell and compute densities, pressures, normals and forces.
+      */
+      bool solve()
+      {
+        if (m_id.empty()) return false;
+
+        sort();
+        density_pass();
+        force_pass();
+        return true;
+      }
+
+      /**
+      * Advance the system a single timestep.
+      */
+      bool simulate()
+      {
+        if (m_id.empty()) return false;
+
+        integrate();
+        return solve();
+      }
+
+    public:
+
+      size_t size() const { return m_id.size(); }
+
+      const fluid_material* material() const { return m_material; }
+
+      /**
+      * Index of the particle at initialization.
+      */
+      int id(size_t i) const { return m_id[i]; }
+
+      vector position(size_t i) const { return vector(m_x[i], m_y[i], m_z[i]); }
+      vector velocity(size_t i) const { return vector(m_vx[i], m_vy[i], m_vz[i]); }
+      vector force(size_t i) const { return vector(m_fx[i], m_fy[i], m_fz[i]); }
+      vector normal(size_t i) const { return vector(m_nx[i], m_ny[i], m_nz[i]); }
+      const real_type& density(size_t i) const { return m_density[i]; }
+      const real_type& pressure(size_t i) const { return m_pressure[i]; }
+
+      /**
+      * Copy the particles into an Array of Structures container, in the order they were initialized.
+      *
+      * @param particles  Upon return holds one particle per particle of the system.
+      */
+      void get_particles(particle_container& particles) const
+      {
+        const size_t n = m_id.size();
+        particles.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+          particle& par = particles[m_id[i]];
+          par.position() = position(i);
+          par.position_old() = vector(m_ox[i], m_oy[i], m_oz[i]);
+          par.velocity() = velocity(i);
+          par.force() = force(i);
+          par.normal() = normal(i);
+          par.mass() = m_material->particle_mass();
+          par.density() = m_density[i];
+          par.pressure() = m_pressure[i];
+        }
+      }
+
+    protected:
+
+      void clear()
+      {
+        m_id.clear();
+        m_x.clear();  m_y.clear();  m_z.clear();
+        m_ox.clear();  m_oy.clear();  m_oz.clear();
+        m_vx.clear();  m_vy.clear();  m_vz.clear();
+      }
+
+      int cell(const real_type& x) const
+      {
+        return static_cast<int>(std::floor(x/m_kernels.m_h));
+      }
+
+      int bucket(int i, int j, int k) const
+      {
+        // Hash Function suggested by Teschner et. al., see PrimeNumberHashFunction
+        int hash_key = (i*73856093 ^ j*19349663 ^ k*83492791) % m_buckets;
+        if (hash_key < 0)
+          hash_key += m_buckets;
+        return hash_key;
+      }
+
+      /**
+      * Hash cells of the 27 neighbour cells of a grid cell.
+      * Neighbour cells may share a hash cell, the duplicates are removed so no particle is visited twice.
+      *
+      * @param buckets  Upon return holds the distinct hash cells.
+      * @return         The number of distinct hash cells.
+      */
+      int neighbour_buckets(int ci, int cj, int ck, int* buckets) const
+      {
+        int count = 0;
+        for (int i = ci-1; i <= ci+1; ++i)
+          for (int j = cj-1; j <= cj+1; ++j)
+            for (int k = ck-1; k <= ck+1; ++k)
+              buckets[count++] = bucket(i, j, k);
+        std::sort(buckets, buckets+count);
+        return static_cast<int>(std::unique(buckets, buckets+count)-buckets);
+      }
+
+      void permute(real_container& data)
+      {
+        const int n = static_cast<int>(m_id.size());
+        const int* permutation = &m_permutation[0];
+        const real_type* source = &data[0];
+        real_type* target = &m_scratch[0];
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i)
+          target[i] = source[permutation[i]];
+        data.swap(m_scratch);
+      }
+
+      /**
+      * Counting sort of the particles by hash cell.
+      * The sort is stable, so mostly coherent particles stay mostly in place.
+      */
+      void sort()
+      {
+        const int n = static_cast<int>(m_id.size());
+        int* key = &m_key[0];
+
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i)
+          key[i] = bucket(cell(m_x[i]), cell(m_y[i]), cell(m_z[i]));
+
+        // histogram, exclusive scan and scatter
+        std::fill(m_bucket_begin.begin(), m_bucket_begin.end(), 0);
+        for (int i = 0; i < n; ++i)
+          ++m_bucket_begin[key[i]+1];
+        for (int b = 0; b < m_buckets; ++b)
+          m_bucket_begin[b+1] += m_bucket_begin[b];
+        m_bucket_next.assign(m_bucket_begin.begin(), m_bucket_begin.end()-1);
+        for (int i = 0; i < n; ++i)
+          m_permutation[m_bucket_next[key[i]]++] = i;
+
+        permute(m_x);  permute(m_y);  permute(m_z);
+        permute(m_ox);  permute(m_oy);  permute(m_oz);
+        permute(m_vx);  permute(m_vy);  permute(m_vz);
+
+        const int* permutation = &m_permutation[0];
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i)
+          m_index_scratch[i] = m_id[permutation[i]];
+        m_id.swap(m_index_scratch);
+      }
+
+      /**
+      * Densities (W_poly6, including the particle itself) and pressures.
+      */
+      void density_pass()
+      {
+        const int n = static_cast<int>(m_id.size());
+        const int blocks = (n+block_size-1)/block_size;
+        const real_type h2 = m_kernels.m_h2;
+        const real_type poly6 = m_material->particle_mass()*m_kernels.m_poly6;
+        const real_type k = m_material->gas_stiffness();
+        const real_type rho0 = m_material->density();
+        const real_type* x = &m_x[0];
+        const real_type* y = &m_y[0];
+        const real_type* z = &m_z[0];
+        const int* bucket_begin = &m_bucket_begin[0];
+
+#pragma omp parallel for schedule(dynamic)
+        for (int block = 0; block < blocks; ++block) {
+          int buckets[27];
+          int bucket_count = 0;
+          int ci = 0, cj = 0, ck = 0;
+          const int end = std::min(n, (block+1)*block_size);
+          for (int i = block*block_size; i < end; ++i) {
+            const int ni = cell(x[i]), nj = cell(y[i]), nk = cell(z[i]);
+            if (i == block*block_size || ni != ci || nj != cj || nk != ck) {
+              ci = ni;  cj = nj;  ck = nk;
+              bucket_count = neighbour_buckets(ci, cj, ck, buckets);
+            }
+
+            const real_type xi = x[i], yi = y[i], zi = z[i];
+            real_type sum = 0;
+            for (int b = 0; b < bucket_count; ++b) {
+              const int jend = bucket_begin[buckets[b]+1];
+#pragma omp simd reduction(+:sum)
+              for (int j = bucket_begin[buckets[b]]; j < jend; ++j) {
+                const real_type dx = xi-x[j], dy = yi-y[j], dz = zi-z[j];
+                const real_type r2 = dx*dx+dy*dy+dz*dz;
+                const real_type d = r2 < h2 ? h2-r2 : 0;
+                sum += d*d*d;
+              }
+            }
+            m_density[i] = poly6*sum;
+            m_pressure[i] = k*(m_density[i]-rho0);
+          }
+        }
+      }
+
+      /**
+      * Surface normals and pressure, viscosity, surface tension and gravity or buoyancy forces.
+      */
+      void force_pass()
+      {
+        const int n = static_cast<int>(m_id.size());
+        const int blocks = (n+block_size-1)/block_size;
+        const real_type mass = m_material->particle_mass();
+        const real_type h = m_kernels.m_h;
+        const real_type h2 = m_kernels.m_h2;
+        const real_type spiky = mass*m_kernels.m_spiky_gradient;
+        const real_type viscosity = mass*m_material->viscosity()*m_kernels.m_viscosity_laplacian;
+        const real_type poly6_gradient = mass*m_kernels.m_poly6_gradient;
+        const real_type poly6_laplacian = mass*m_kernels.m_poly6_laplacian;
+        const real_type tension = m_material->tension();
+        const real_type threshold = m_material->threshold();
+        const real_type buoyancy = m_material->buoyancy();
+        const real_type rho0 = m_material->density();
+        const real_type gx = m_gravity(0), gy = m_gravity(1), gz = m_gravity(2);
+        const real_type* x = &m_x[0];
+        const real_type* y = &m_y[0];
+        const real_type* z = &m_z[0];
+        const real_type* vx = &m_vx[0];
+        const real_type* vy = &m_vy[0];
+        const real_type* vz = &m_vz[0];
+        const real_type* density = &m_density[0];
+        const real_type* pressure = &m_pressure[0];
+        const int* bucket_begin = &m_bucket_begin[0];
+
+#pragma omp parallel for schedule(dynamic)
+        for (int block = 0; block < blocks; ++block) {
+          int buckets[27];
+          int bucket_count = 0;
+          int ci = 0, cj = 0, ck = 0;
+          const int end = std::min(n, (block+1)*block_size);
+          for (int i = block*block_size; i < end; ++i) {
+            const int ni = cell(x[i]), nj = cell(y[i]), nk = cell(z[i]);
+            if (i == block*block_size || ni != ci || nj != cj || nk != ck) {
+              ci = ni;  cj = nj;  ck = nk;
+              bucket_count = neighbour_buckets(ci, cj, ck, buckets);
+            }
+
+            const real_type xi = x[i], yi = y[i], zi = z[i];
+            const real_type vxi = vx[i], vyi = vy[i], vzi = vz[i];
+            const real_type P_rho2 = pressure[i]/(density[i]*density[i]);
+            real_type px = 0, py = 0, pz = 0;
+            real_type ux = 0, uy = 0, uz = 0;
+            real_type nx = 0, ny = 0, nz = 0;
+            real_type lap = 0;
+            for (int b = 0; b < bucket_count; ++b) {
+              const int jend = bucket_begin[buckets[b]+1];
+#pragma omp simd reduction(+:px,py,pz,ux,uy,uz,nx,ny,nz,lap)
+              for (int j = bucket_begin[buckets[b]]; j < jend; ++j) {
+                const real_type dx = xi-x[j], dy = yi-y[j], dz = zi-z[j];
+                const real_type r2 = dx*dx+dy*dy+dz*dz;
+                // the particle itself and coincident particles are masked out of the pressure force only,
+                // they add nothing to the viscosity force and normal, and do count in the tension laplacian
+                const real_type in_range = r2 < h2 ? 1 : 0;
+                const real_type inside = (r2 < h2 && r2 > 0) ? 1 : 0;
+                const real_type r = std::sqrt(r2);
+                const real_type inv_r = inside/(r+(1-inside));
+                const real_type rho_j = density[j];
+                const real_type inv_rho_j = 1/rho_j;
+
+                // symmetric pressure force, W_spiky gradient
+                const real_type s = h-r;
+                const real_type p = (P_rho2+pressure[j]*inv_rho_j*inv_rho_j)*s*s*inv_r;
+                px += p*dx;  py += p*dy;  pz += p*dz;
+
+                // viscosity force, W_viscosity laplacian
+                const real_type u = s*inv_rho_j*in_range;
+                ux += u*(vx[j]-vxi);  uy += u*(vy[j]-vyi);  uz += u*(vz[j]-vzi);
+
+                // surface normal and tension, W_poly6 gradient and laplacian
+                const real_type d = in_range*(h2-r2);
+                const real_type g = d*d*inv_rho_j;
+                nx += g*dx;  ny += g*dy;  nz += g*dz;
+                lap += d*(3*h2-7*r2)*inv_rho_j;
+              }
+            }
+
+            const real_type rho_i = density[i];
+            real_type fx = -rho_i*spiky*px+viscosity*ux;
+            real_type fy = -rho_i*spiky*py+viscosity*uy;
+            real_type fz = -rho_i*spiky*pz+viscosity*uz;
+
+            nx *= poly6_gradient;  ny *= poly6_gradient;  nz *= poly6_gradient;
+            m_nx[i] = nx;  m_ny[i] = ny;  m_nz[i] = nz;
+            const real_type nn = nx*nx+ny*ny+nz*nz;
+            if (tension > 0 && nn >= threshold) {
+              const real_type t = -tension*poly6_laplacian*lap/std::sqrt(nn);
+              fx += t*nx;  fy += t*ny;  fz += t*nz;
+            }
+
+            const real_type e = m_buoyancy ? buoyancy*(rho_i-rho0) : rho_i;
+            m_fx[i] = fx+e*gx;
+            m_fy[i] = fy+e*gy;
+            m_fz[i] = fz+e*gz;
+          }
+        }
+      }
+
+      /**
+      * Verlet integration, see Verlet integrator.
+      */
+      void integrate()
+      {
+        const int n = static_cast<int>(m_id.size());
+        const real_type dt2 = m_dt*m_dt;
+        const real_type damping = 0.98;
+
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i) {
+          const real_type inv_rho = 1/m_density[i];
+          const real_type x = m_x[i], y = m_y[i], z = m_z[i];
+          m_x[i] += damping*(x-m_ox[i])+m_fx[i]*inv_rho*dt2;
+          m_y[i] += damping*(y-m_oy[i])+m_fy[i]*inv_rho*dt2;
+          m_z[i] += damping*(z-m_oz[i])+m_fz[i]*inv_rho*dt2;
+          m_ox[i] = x;  m_oy[i] = y;  m_oz[i] = z;
+        }
+
+        // collision policies are not thread safe, so the collision test is sequential
+        particle par;
+        for (int i = 0; i < n; ++i) {
+          typename collision_detection::collision_type coli;
+          par.position() = position(i);
+          if (m_colisys.collision(coli, par)) {
+            // project particle out from obstacle and reflect the velocity
+            const vector x = coli.contact();
+            vector ox(m_ox[i], m_oy[i], m_oz[i]);
+            ox -= (1+m_restitution)*((x-ox)*coli.normal())*coli.normal();
+            m_x[i] = x(0);  m_y[i] = x(1);  m_z[i] = x(2);
+            m_ox[i] = ox(0);  m_oy[i] = ox(1);  m_oz[i] = ox(2);
+          }
+        }
+
+        const real_type s = damping/m_dt;
+#pragma omp parallel for
+        for (int i = 0; i < n; ++i) {
+          m_vx[i] = s*(m_x[i]-m_ox[i]);
+          m_vy[i] = s*(m_y[i]-m_oy[i]);
+          m_vz[i] = s*(m_z[i]-m_oz[i]);
+        }
+      }
+
+    protected:
+      const fluid_material*  m_material;
+      collision_detection    m_colisys;
+      kernels                m_kernels;
+      vector                 m_gravity;
+      bool                   m_buoyancy;     ///< Buoyancy force instead of gravity.
+      real_type              m_dt;
+      real_type              m_restitution;
+
+      index_container  m_id;                 ///< Particle index at initialization.
+      real_container   m_x, m_y, m_z;        ///< Positions.
+      real_container   m_ox, m_oy, m_oz;     ///< Old positions.
+      real_container   m_vx, m_vy, m_vz;     ///< Velocities.
+      real_container   m_fx, m_fy, m_fz;     ///< Forces.
+      real_container   m_nx, m_ny, m_nz;     ///< Surface normals.
+      real_container   m_density;
+      real_container   m_pressure;
+
+      int              m_buckets;            ///< Number of hash cells.
+      index_container  m_bucket_begin;       ///< First particle of every hash cell, m_buckets+1 entries.
+      index_container  m_key;                ///< Hash cell of every particle.
+      index_container  m_bucket_next;        ///< Next free position of every hash cell during the scatter.
+      index_container  m_permutation;        ///< Sorted position to unsorted position.
+      real_container   m_scratch;
+      index_container  m_index_scratch;
+
+    }; // End class SoASystem
+
+  } // namespace sph
+} // namespace OpenTissue
+
+// OPENTISSUE_DYNAMICS_SPH_SPH_SOA_SYSTEM_H
+#endif
@@ -5,6 +5,12 @@
 #include <OpenTissue/configuration.h>
 
 #include <OpenTissue/collision/bvh/bvh_bounding_volume_hierarchy.h>
+#include <OpenTissue/collision/bvh/bvh_flat_bounding_volume_hierarchy.h>
+#include <OpenTissue/collision/bvh/bvh_flat_lbvh_constructor.h>
+#include <OpenTissue/collision/bvh/bvh_flat_binned_sah_constructor.h>
+#include <OpenTissue/collision/bvh/bvh_flat_bottom_up_refitter.h>
+#include <OpenTissue/collision/bvh/bvh_flat_self_collision_query.h>
+#include <OpenTissue/core/math/math_vector3.h>
 
 #define BOOST_AUTO_TEST_MAIN
 #include <OpenTissue/utility/utility_push_boost_filter.h>
@@ -15,6 +21,10 @@
 #include <OpenTissue/utility/utility_pop_boost_filter.h>
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
 
 using namespace OpenTissue;
 
@@ -423,4 +433,140 @@ BOOST_AUTO_TEST_CASE(remove_functionality_testing)
 }
 
 
+typedef OpenTissue::math::Vector3<double>                                  flat_vector3_type;
+typedef OpenTissue::bvh::FlatBoundingVolumeHierarchy<flat_vector3_type,int>  flat_bvh_type;
+typedef std::vector< std::pair<int,int> >                                  flat_result_type;
+
+// The geometry are indices into a global array of spheres
+std::vector<flat_vector3_type> flat_centers;
+std::vector<double>            flat_radii;
+
+class flat_policy
+{
+public:
+  typedef flat_bvh_type bvh_type;
+
+  void compute_aabb(int const & g, flat_vector3_type & min_coord, flat_vector3_type & max_coord)
+  {
+    flat_vector3_type r(flat_radii[g],flat_radii[g],flat_radii[g]);
+    min_coord = flat_centers[g] - r;
+    max_coord = flat_centers[g] + r;
+  }
+
+  void reset(flat_result_type & results) { results.clear(); }
+
+  void report(int const & a, int const & b, flat_result_type & results)
+  {
+    results.push_back( std::make_pair( std::min(a,b), std::max(a,b) ) );
+  }
+};
+
+void flat_random_spheres(int N)
+{
+  flat_centers.resize(N);
+  flat_radii.resize(N);
+  for(int i=0;i<N;++i)
+  {
+    flat_centers[i] = flat_vector3_type( 10.0*std::rand()/RAND_MAX, 10.0*std::rand()/RAND_MAX, 10.0*std::rand()/RAND_MAX );
+    flat_radii[i]   = 0.05 + 0.2*std::rand()/RAND_MAX;
+  }
+}
+
+flat_result_type flat_brute_force_overlaps()
+{
+  flat_result_type results;
+  int N = flat_centers.size();
+  for(int i=0;i<N;++i)
+    for(int j=i+1;j<N;++j)
+    {
+      double r = flat_radii[i] + flat_radii[j];
+      flat_vector3_type d = flat_centers[i] - flat_centers[j];
+      if( std::fabs(d(0))<=r && std::fabs(d(1))<=r && std::fabs(d(2))<=r )
+        results.push_back( std::make_pair(i,j) );
+    }
+  return results;
+}
+
+// Verifies the depth first layout: children are consecutive, skip indices bound the subtrees and volumes enclose the children
+void flat_check_layout(flat_bvh_type const & bvh, int N)
+{
+  BOOST_CHECK( static_cast<int>(bvh.size()) == 2*N-1 );
+  BOOST_CHECK( static_cast<int>(bvh.leaves().size()) == N );
+  BOOST_CHECK( bvh.node(0).m_parent == -1 );
+  BOOST_CHECK( bvh.node(0).m_skip == 2*N-1 );
+
+  std::vector<int> seen(N,0);
+  for(int i=0;i<2*N-1;++i)
+  {
+    flat_bvh_type::node_type const & nd = bvh.node(i);
+    if(nd.is_leaf())
+    {
+      BOOST_CHECK( nd.m_skip == i+1 );
+      ++seen[nd.m_geometry];
+      continue;
+    }
+    flat_bvh_type::node_type const & left  = bvh.node(i+1);
+    flat_bvh_type::node_type const & right = bvh.node(nd.m_right);
+    BOOST_CHECK( left.m_parent == i );
+    BOOST_CHECK( right.m_parent == i );
+    BOOST_CHECK( left.m_skip == nd.m_right );
+    BOOST_CHECK( right.m_skip == nd.m_skip );
+    for(int j=0;j<3;++j)
+    {
+      BOOST_CHECK( nd.m_min(j) <= left.m_min(j) && nd.m_min(j) <= right.m_min(j) );
+      BOOST_CHECK( nd.m_max(j) >= left.m_max(j) && nd.m_max(j) >= right.m_max(j) );
+    }
+  }
+  BOOST_CHECK( std::count(seen.begin(),seen.end(),1) == N );
+}
+
+template<typename constructor_type>
+void flat_construct_refit_and_query(int N)
+{
+  flat_random_spheres(N);
+
+  std::vector<int> geometry(N);
+  for(int i=0;i<N;++i)
+    geometry[i] = i;
+
+  flat_bvh_type bvh;
+  constructor_type constructor;
+  constructor.run(geometry.begin(), geometry.end(), bvh);
+  flat_check_layout(bvh, N);
+
+  OpenTissue::bvh::FlatSelfCollisionQuery<flat_policy> query;
+  flat_result_type results;
+  query.run(bvh, results);
+  std::sort(results.begin(), results.end());
+  BOOST_CHECK( results == flat_brute_force_overlaps() );
+
+  // Deform the geometry, refit and query again
+  for(int i=0;i<N;++i)
+    flat_centers[i] += flat_vector3_type( 0.5*std::rand()/RAND_MAX, -0.5*std::rand()/RAND_MAX, 0.25 );
+  OpenTissue::bvh::FlatBottomUpRefitter<flat_policy> refitter;
+  refitter.run(bvh);
+  flat_check_layout(bvh, N);
+
+  query.run(bvh, results);
+  std::sort(results.begin(), results.end());
+  BOOST_CHECK( results == flat_brute_force_overlaps() );
+}
+
+BOOST_AUTO_TEST_CASE(flat_lbvh_testing)
+{
+  flat_construct_refit_and_query< OpenTissue::bvh::LBVHConstructor<flat_policy> >(1);
+  flat_construct_refit_and_query< OpenTissue::bvh::LBVHConstructor<flat_policy> >(2);
+  flat_construct_refit_and_query< OpenTissue::bvh::LBVHConstructor<flat_policy> >(1000);
+}
+
+BOOST_AUTO_TEST_CASE(flat_binned_sah_testing)
+{
+  flat_construct_refit_and_query< OpenTissue::bvh::BinnedSAHConstructor<flat_policy> >(1);
+  flat_construct_refit_and_query< OpenTissue::bvh::BinnedSAHConstructor<flat_policy> >(2);
+  flat_construct_refit_and_query< OpenTissue::bvh::BinnedSAHConstructor<flat_policy> >(1000);
+  // Large enough for subtrees to be build as tasks
+  flat_construct_refit_and_query< OpenTissue::bvh::BinnedSAHConstructor<flat_policy> >(10000);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END();
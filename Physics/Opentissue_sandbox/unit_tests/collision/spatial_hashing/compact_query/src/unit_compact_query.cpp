@@ -0,0 +1,255 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_vector3.h>
+#include <OpenTissue/core/math/math_random.h>
+#include <OpenTissue/collision/spatial_hashing/spatial_hashing.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef OpenTissue::math::Vector3<double>                     vector3_type;
+typedef OpenTissue::math::Vector3<int>                        triplet_type;
+typedef OpenTissue::spatial_hashing::PrimeNumberHashFunction  hash_function;
+
+/**
+* A box that is also used as a point at its center and as
+* the line segment from its center to its end point.
+*/
+struct Box
+{
+  int          m_id;
+  vector3_type m_center;
+  vector3_type m_extent;
+  vector3_type m_end;
+};
+
+typedef std::vector<Box>                   box_container;
+typedef std::vector< std::pair<int,int> >  result_container;
+
+bool overlap(vector3_type const & min_a, vector3_type const & max_a, vector3_type const & min_b, vector3_type const & max_b)
+{
+  for(int i = 0; i < 3; ++i)
+    if(max_a(i) < min_b(i) || max_b(i) < min_a(i))
+      return false;
+  return true;
+}
+
+/**
+* Slab test of the segment from o to d against a box.
+*/
+bool segment_overlap(vector3_type const & o, vector3_type const & d, vector3_type const & min_b, vector3_type const & max_b)
+{
+  double t0 = 0.0;
+  double t1 = 1.0;
+  for(int i = 0; i < 3; ++i)
+  {
+    double const delta = d(i) - o(i);
+    if(delta == 0.0)
+    {
+      if(o(i) < min_b(i) || o(i) > max_b(i))
+        return false;
+      continue;
+    }
+    double a = (min_b(i) - o(i)) / delta;
+    double b = (max_b(i) - o(i)) / delta;
+    if(a > b)
+      std::swap(a, b);
+    t0 = std::max(t0, a);
+    t1 = std::min(t1, b);
+    if(t0 > t1)
+      return false;
+  }
+  return true;
+}
+
+enum geometry_type { point_geometry, line_geometry, aabb_geometry };
+
+/**
+* Reports the query and data ids of the pairs that really overlap, so that
+* every query type must find the same pairs regardless of the hash cells.
+*/
+template<geometry_type geometry>
+class Policy
+{
+public:
+
+  typedef Box  data_type;
+  typedef Box  query_type;
+
+  vector3_type position(Box const & box) const { return box.m_center; }
+  vector3_type origin(Box const & box) const { return box.m_center; }
+  vector3_type destination(Box const & box) const { return box.m_end; }
+  vector3_type min_coord(Box const & box) const { return box.m_center - box.m_extent; }
+  vector3_type max_coord(Box const & box) const { return box.m_center + box.m_extent; }
+
+  void reset(result_container & results) { results.clear(); }
+
+  void report(data_type const & data, query_type const & query, result_container & results)
+  {
+    if(intersect(data, query))
+      results.push_back( std::make_pair(query.m_id, data.m_id) );
+  }
+
+  bool intersect(data_type const & data, query_type const & query) const
+  {
+    switch(geometry)
+    {
+    case point_geometry: return overlap( position(data), position(data), min_coord(query), max_coord(query) );
+    case line_geometry:  return segment_overlap( origin(data), destination(data), min_coord(query), max_coord(query) );
+    default:             return overlap( min_coord(data), max_coord(data), min_coord(query), max_coord(query) );
+    }
+  }
+};
+
+/**
+* Random boxes with extents up to one grid cell and segments
+* spanning several cells, including some boxes far outside the
+* cluster that hash onto the same cells as the rest.
+*/
+void make_boxes(box_container & boxes, int count)
+{
+  OpenTissue::math::Random<double> position(-5.0, 5.0);
+  OpenTissue::math::Random<double> extent(0.05, 1.0);
+  OpenTissue::math::Random<double> offset(-3.0, 3.0);
+  boxes.resize(count);
+  for(int i = 0; i < count; ++i)
+  {
+    Box & box = boxes[i];
+    box.m_id = i;
+    box.m_center = vector3_type( position(), position(), position() );
+    if(i % 10 == 0)
+      box.m_center += vector3_type( 1000.0, 0.0, -1000.0 );
+    box.m_extent = vector3_type( extent(), extent(), extent() );
+    box.m_end = box.m_center + vector3_type( offset(), offset(), offset() );
+  }
+}
+
+/**
+* Runs the query and its compact counterpart on the same data with
+* several chunk sizes and compares the result sets.
+*/
+template<typename query_type, typename compact_query_type, typename report_type, typename compact_report_type>
+void test_query(box_container const & data, box_container const & queries, report_type const & type, compact_report_type const & compact_type)
+{
+  query_type query;
+  query.resize( data.size() );
+  query.set_spacing( 1.0 );
+  result_container expected;
+  query( data.begin(), data.end(), queries.begin(), queries.end(), expected, type );
+  std::sort( expected.begin(), expected.end() );
+
+  // Guard against a test where nothing overlaps
+  BOOST_CHECK( expected.size() > queries.size() );
+
+  int const chunk_sizes[3] = { 1, 7, 256 };
+  result_container first;
+  for(int c = 0; c < 3; ++c)
+  {
+    compact_query_type compact;
+    compact.resize( data.size() );
+    compact.set_spacing( 1.0 );
+    compact.set_chunk_size( chunk_sizes[c] );
+
+    result_container results;
+    compact( data.begin(), data.end(), queries.begin(), queries.end(), results, compact_type );
+    if(c == 0)
+      first = results;
+
+    // Chunk results are appended in query order, re-running gives the same sequence
+    result_container rerun;
+    compact( queries.begin(), queries.end(), rerun, compact_type );
+    BOOST_CHECK( rerun == results );
+
+    std::sort( results.begin(), results.end() );
+    BOOST_CHECK( results.size() == expected.size() );
+    BOOST_CHECK( results == expected );
+  }
+
+  // Single shoot queries agree with the batched query
+  compact_query_type compact;
+  compact.resize( data.size() );
+  compact.set_spacing( 1.0 );
+  compact.init_data( data.begin(), data.end() );
+  result_container single;
+  for(box_container::const_iterator q = queries.begin(); q != queries.end(); ++q)
+  {
+    result_container results;
+    compact( *q, results, compact_type );
+    single.insert( single.end(), results.begin(), results.end() );
+  }
+  BOOST_CHECK( single == first );
+}
+
+/**
+* Without hash collisions every overlapping pair is reported exactly once.
+*/
+template<geometry_type geometry>
+void test_brute_force(box_container const & data, box_container const & queries, result_container const & results)
+{
+  Policy<geometry> policy;
+  result_container expected;
+  for(size_t q = 0; q < queries.size(); ++q)
+    for(size_t d = 0; d < data.size(); ++d)
+      policy.report( data[d], queries[q], expected );
+  result_container sorted(results);
+  std::sort( sorted.begin(), sorted.end() );
+  BOOST_CHECK( sorted == expected );
+}
+
+template<geometry_type geometry, template<typename,typename> class Q, template<typename,typename> class C>
+void test_geometry()
+{
+  typedef OpenTissue::spatial_hashing::Grid<vector3_type, triplet_type, Box, hash_function>         grid_type;
+  typedef OpenTissue::spatial_hashing::CompactGrid<vector3_type, triplet_type, Box, hash_function>  compact_grid_type;
+  typedef Q<grid_type, Policy<geometry> >                                                          query_type;
+  typedef C<compact_grid_type, Policy<geometry> >                                                  compact_query_type;
+
+  box_container data, queries;
+  make_boxes(data, 2000);
+  make_boxes(queries, 1500);
+
+  test_query<query_type, compact_query_type>(
+    data, queries, typename query_type::all_tag(), typename compact_query_type::all_tag()
+    );
+  test_query<query_type, compact_query_type>(
+    data, queries, typename query_type::no_collisions_tag(), typename compact_query_type::no_collisions_tag()
+    );
+
+  compact_query_type compact;
+  compact.resize( data.size() );
+  compact.set_spacing( 1.0 );
+  result_container results;
+  compact( data.begin(), data.end(), queries.begin(), queries.end(), results, typename compact_query_type::no_collisions_tag() );
+  test_brute_force<geometry>( data, queries, results );
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_spatial_hashing_compact_query);
+
+BOOST_AUTO_TEST_CASE(point_data_query_test_case)
+{
+  test_geometry<point_geometry, OpenTissue::spatial_hashing::PointDataQuery, OpenTissue::spatial_hashing::CompactPointDataQuery>();
+}
+
+BOOST_AUTO_TEST_CASE(line_data_query_test_case)
+{
+  test_geometry<line_geometry, OpenTissue::spatial_hashing::LineDataQuery, OpenTissue::spatial_hashing::CompactLineDataQuery>();
+}
+
+BOOST_AUTO_TEST_CASE(aabb_data_query_test_case)
+{
+  test_geometry<aabb_geometry, OpenTissue::spatial_hashing::AABBDataQuery, OpenTissue::spatial_hashing::CompactAABBDataQuery>();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,133 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_basic_types.h>
+#include <OpenTissue/core/containers/grid/grid.h>
+#include <OpenTissue/core/containers/grid/util/grid_fast_redistance.h>
+#include <cmath>
+#include <limits>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef OpenTissue::math::BasicMathTypes<double, size_t>  math_types;
+typedef math_types::vector3_type                          vector3_type;
+typedef OpenTissue::grid::Grid<double,math_types>         grid_type;
+
+double const radius = 0.5;
+
+/**
+* Exact signed distance to a sphere slightly off the grid center.
+*/
+double sphere_distance(grid_type const & phi, size_t i, size_t j, size_t k)
+{
+  double const x = phi.min_coord()(0) + i*phi.dx() - 0.05;
+  double const y = phi.min_coord()(1) + j*phi.dy() + 0.03;
+  double const z = phi.min_coord()(2) + k*phi.dz() - 0.02;
+  return std::sqrt(x*x + y*y + z*z) - radius;
+}
+
+/**
+* A level set of the sphere that is far from a distance field.
+*/
+void make_sphere(grid_type & phi, size_t I, size_t J, size_t K)
+{
+  phi.create(vector3_type(-1.0, -1.0, -1.0), vector3_type(1.0, 1.0, 1.0), I, J, K);
+  for(size_t k=0;k<K;++k)
+    for(size_t j=0;j<J;++j)
+      for(size_t i=0;i<I;++i)
+      {
+        double const d = sphere_distance(phi, i, j, k);
+        phi(i,j,k) = d*(d + 2.0*radius)*(1.0 + 0.5*i/I);
+      }
+}
+
+double max_spacing(grid_type const & phi)
+{
+  return std::max(phi.dx(), std::max(phi.dy(), phi.dz()));
+}
+
+void test_fast_sweeping(size_t I, size_t J, size_t K)
+{
+  grid_type phi, psi;
+  make_sphere(phi, I, J, K);
+
+  size_t const iterations = OpenTissue::grid::fast_sweeping_redistance(phi, psi);
+  BOOST_CHECK( iterations <= 4u );
+
+  double const h = max_spacing(phi);
+  for(size_t k=0;k<K;++k)
+    for(size_t j=0;j<J;++j)
+      for(size_t i=0;i<I;++i)
+      {
+        BOOST_CHECK( (psi(i,j,k) > 0.0) == (phi(i,j,k) > 0.0) );
+        BOOST_CHECK_SMALL( psi(i,j,k) - sphere_distance(phi, i, j, k), h );
+      }
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_grid_fast_redistance);
+
+BOOST_AUTO_TEST_CASE(fast_sweeping_test_case)
+{
+  test_fast_sweeping(41, 41, 41);
+
+  // Anisotropic spacing and sizes that are not multiples of the tile size
+  test_fast_sweeping(37, 29, 21);
+}
+
+BOOST_AUTO_TEST_CASE(fast_marching_test_case)
+{
+  grid_type phi, fsm, fmm;
+  make_sphere(phi, 41, 41, 41);
+
+  OpenTissue::grid::fast_sweeping_redistance(phi, fsm);
+
+  double const band = 0.3;
+  OpenTissue::grid::fast_marching_redistance(phi, fmm, band);
+
+  // Both methods solve the same discretization
+  for(size_t idx=0;idx<phi.size();++idx)
+  {
+    if(std::fabs(fsm(idx)) < band)
+      BOOST_CHECK_SMALL( fmm(idx) - fsm(idx), 1e-10 );
+    else
+      BOOST_CHECK_CLOSE( std::fabs(fmm(idx)), band, 1e-10 );
+    BOOST_CHECK( (fmm(idx) > 0.0) == (phi(idx) > 0.0) );
+  }
+
+  // In-place redistancing
+  OpenTissue::grid::fast_marching_redistance(phi, phi, band);
+  for(size_t idx=0;idx<phi.size();++idx)
+    BOOST_CHECK( phi(idx) == fmm(idx) );
+}
+
+BOOST_AUTO_TEST_CASE(unused_test_case)
+{
+  grid_type phi, psi;
+  make_sphere(phi, 21, 21, 21);
+
+  // A wall of unused nodes
+  for(size_t k=0;k<21;++k)
+    for(size_t j=0;j<21;++j)
+      phi(2,j,k) = phi.unused();
+
+  OpenTissue::grid::fast_sweeping_redistance(phi, psi);
+  for(size_t k=0;k<21;++k)
+    for(size_t j=0;j<21;++j)
+    {
+      BOOST_CHECK( psi(2,j,k) == phi.unused() );
+      // Nodes behind the wall can not be reached
+      BOOST_CHECK( psi(0,j,k) == std::numeric_limits<double>::max() );
+      BOOST_CHECK( psi(10,j,k) < 1.0 );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,167 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_basic_types.h>
+#include <OpenTissue/core/math/math_random.h>
+#include <OpenTissue/core/math/big/big_conjugate_gradient.h>
+#include <OpenTissue/core/containers/grid/grid.h>
+#include <OpenTissue/core/containers/grid/util/grid_multigrid_poisson_solver.h>
+#include <OpenTissue/core/containers/grid/util/grid_multigrid_preconditioner.h>
+#include <cmath>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef OpenTissue::math::BasicMathTypes<double, size_t>  math_types;
+typedef math_types::vector3_type                          vector3_type;
+typedef OpenTissue::grid::Grid<double,math_types>         grid_type;
+typedef ublas::compressed_matrix<double>                  matrix_type;
+typedef ublas::vector<double>                             vector_type;
+
+/**
+* Create a grid and a random right hand side that sums to zero.
+*/
+void make_problem(grid_type & phi, grid_type & W, vector3_type const & max_coord, size_t I, size_t J, size_t K)
+{
+  vector3_type const min_coord(0.0, 0.0, 0.0);
+  phi.create(min_coord, max_coord, I, J, K);
+  W.create(min_coord, max_coord, I, J, K);
+
+  OpenTissue::math::Random<double> value(-1.0,1.0);
+  double sum = 0.0;
+  for(size_t idx=0;idx<W.size();++idx)
+  {
+    W(idx) = value();
+    sum += W(idx);
+  }
+  for(size_t idx=0;idx<W.size();++idx)
+  {
+    W(idx) -= sum / W.size();
+    phi(idx) = 0.0;
+  }
+}
+
+/**
+* The norm of the residual W - \nabla^2 phi relative to the norm of W.
+*/
+double relative_residual(grid_type const & phi, grid_type const & W)
+{
+  matrix_type A;
+  OpenTissue::grid::poisson_matrix(phi, A);
+
+  size_t const N = phi.size();
+  vector_type x(N), b(N), r(N);
+  for(size_t idx=0;idx<N;++idx)
+  {
+    x(idx) = phi(idx);
+    b(idx) = -W(idx);
+  }
+  r = b - ublas::prod(A,x);
+  return ublas::norm_2(r) / ublas::norm_2(b);
+}
+
+void test_solver(grid_type & phi, grid_type const & W, OpenTissue::grid::MultigridPoissonSolver<grid_type> & solver)
+{
+  unsigned int const cycles = solver.solve(phi, W, 30u, 1e-8);
+  BOOST_CHECK( solver.levels() > 2u );
+  BOOST_CHECK( cycles < 15u );
+  BOOST_CHECK( relative_residual(phi, W) < 1e-8 );
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_grid_multigrid_poisson);
+
+BOOST_AUTO_TEST_CASE(v_cycle_test_case)
+{
+  grid_type phi, W;
+  OpenTissue::grid::MultigridPoissonSolver<grid_type> solver;
+
+  make_problem(phi, W, vector3_type(1.0, 1.0, 1.0), 33, 33, 33);
+  test_solver(phi, W, solver);
+
+  // Odd and even sizes with anisotropic spacing
+  make_problem(phi, W, vector3_type(1.0, 2.0, 0.5), 30, 20, 17);
+  test_solver(phi, W, solver);
+}
+
+BOOST_AUTO_TEST_CASE(f_cycle_test_case)
+{
+  grid_type phi, W;
+  OpenTissue::grid::MultigridPoissonSolver<grid_type> solver;
+  solver.set_cycle( OpenTissue::grid::MultigridPoissonSolver<grid_type>::f_cycle );
+
+  make_problem(phi, W, vector3_type(1.0, 1.0, 1.0), 33, 33, 33);
+  test_solver(phi, W, solver);
+
+  BOOST_CHECK( OpenTissue::grid::multigrid_poisson_solver(phi, W, 1u) == 1u );
+}
+
+BOOST_AUTO_TEST_CASE(preconditioner_test_case)
+{
+  grid_type phi, W;
+  make_problem(phi, W, vector3_type(1.0, 1.0, 1.0), 32, 32, 32);
+
+  matrix_type A;
+  OpenTissue::grid::poisson_matrix(phi, A);
+
+  size_t const N = phi.size();
+  vector_type b(N), x(N), y(N);
+  for(size_t idx=0;idx<N;++idx)
+    b(idx) = -W(idx);
+
+  size_t cg_iterations, pcg_iterations;
+
+  x.clear();
+  OpenTissue::math::big::conjugate_gradient(A, x, b, 1000u, 1e-8, cg_iterations);
+
+  OpenTissue::grid::MultigridPreconditioner<grid_type> P(phi);
+  y.clear();
+  OpenTissue::math::big::conjugate_gradient(A, y, b, 1000u, 1e-8, pcg_iterations, P);
+
+  BOOST_CHECK( pcg_iterations < 15u );
+  BOOST_CHECK( pcg_iterations < cg_iterations );
+
+  // Solutions are unique up to a constant
+  double const offset = ublas::sum(x - y) / N;
+  for(size_t idx=0;idx<N;++idx)
+    BOOST_CHECK_SMALL( x(idx) - y(idx) - offset, 1e-5 );
+}
+
+BOOST_AUTO_TEST_CASE(preconditioner_symmetry_test_case)
+{
+  grid_type phi, W;
+  make_problem(phi, W, vector3_type(1.0, 1.0, 1.0), 17, 17, 17);
+
+  matrix_type A;
+  OpenTissue::grid::poisson_matrix(phi, A);
+
+  // Zero mean residuals, the right hand sides the conjugate gradient method sees
+  size_t const N = phi.size();
+  OpenTissue::math::Random<double> value(-1.0,1.0);
+  vector_type r1(N), r2(N), e1(N), e2(N);
+  for(size_t idx=0;idx<N;++idx)
+  {
+    r1(idx) = value();
+    r2(idx) = value();
+  }
+  r1 -= ublas::scalar_vector<double>(N, ublas::sum(r1) / N);
+  r2 -= ublas::scalar_vector<double>(N, ublas::sum(r2) / N);
+
+  OpenTissue::grid::MultigridPreconditioner<grid_type> P(phi);
+  P(A, e1, r1);
+  P(A, e2, r2);
+
+  // <P r1, r2> = <r1, P r2> for a symmetric preconditioner
+  double const a = ublas::inner_prod(e1, r2);
+  double const b = ublas::inner_prod(r1, e2);
+  BOOST_CHECK_SMALL( a - b, 1e-10*std::fabs(a) );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
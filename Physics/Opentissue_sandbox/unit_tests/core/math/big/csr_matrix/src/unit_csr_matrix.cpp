@@ -0,0 +1,236 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_random.h>
+#include <OpenTissue/core/math/big/big_prod.h>
+#include <OpenTissue/core/math/big/big_prod_add.h>
+#include <OpenTissue/core/math/big/big_prod_sub.h>
+#include <OpenTissue/core/math/big/big_prod_add_rhs.h>
+#include <OpenTissue/core/math/big/big_prod_sub_rhs.h>
+#include <OpenTissue/core/math/big/big_prod_trans.h>
+#include <OpenTissue/core/math/big/big_prod_row.h>
+#include <OpenTissue/core/math/big/big_residual.h>
+#include <OpenTissue/core/math/big/big_csr_matrix.h>
+#include <OpenTissue/core/math/big/big_bcsr_matrix.h>
+#include <OpenTissue/core/math/big/big_conjugate_gradient.h>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef ublas::compressed_matrix<double> matrix_type;
+typedef ublas::vector<double>            vector_type;
+
+/**
+* Random sparse matrix with entries in a band around the diagonal, large
+* enough for the products to run in parallel.
+*/
+void make_sparse(matrix_type & A, size_t N, size_t band, bool symmetric)
+{
+  OpenTissue::math::Random<double> value(-1.0,1.0);
+  OpenTissue::math::Random<double> coin(0.0,1.0);
+
+  A.resize(N,N,false);
+  A.clear();
+  for(size_t i=0;i<N;++i)
+  {
+    size_t const begin = i > band ? i - band : 0;
+    size_t const end   = i + band < N ? i + band + 1 : N;
+    for(size_t j=begin;j<end;++j)
+    {
+      if(symmetric && j < i)
+        continue;
+      if(j != i && coin() > 0.5)
+        continue;
+      double const v = (j == i) ? 2.0*band + 1.0 : value();
+      A(i,j) = v;
+      if(symmetric && j != i)
+        A(j,i) = v;
+    }
+  }
+}
+
+void make_vector(vector_type & x, size_t N)
+{
+  OpenTissue::math::Random<double> value(-1.0,1.0);
+  x.resize(N,false);
+  for(size_t i=0;i<N;++i)
+    x(i) = value();
+}
+
+void check_close(vector_type const & y, vector_type const & tst)
+{
+  BOOST_CHECK( y.size() == tst.size() );
+  double const tol = 1e-10;
+  for(size_t i=0;i<y.size();++i)
+    BOOST_CHECK_SMALL( y(i) - tst(i), tol );
+}
+
+/**
+* Compare all products of a matrix with the ublas results for the compressed matrix B.
+*/
+template<typename sparse_type>
+void test_products(sparse_type const & A, matrix_type const & B)
+{
+  using namespace OpenTissue::math::big;
+
+  size_t const N = B.size1();
+  vector_type x, b, y, tst;
+  make_vector(x,N);
+  make_vector(b,N);
+  make_vector(y,N);
+  double const s = 0.5;
+
+  tst = ublas::prod(B,x);
+  prod(A,x,y);
+  check_close(y,tst);
+
+  tst = ublas::prod(B,x)*s;
+  prod(A,x,s,y);
+  check_close(y,tst);
+
+  tst = y + ublas::prod(B,x);
+  prod_add(A,x,y);
+  check_close(y,tst);
+
+  tst = y + ublas::prod(B,x)*s;
+  prod_add(A,x,s,y);
+  check_close(y,tst);
+
+  tst = y - ublas::prod(B,x);
+  prod_sub(A,x,y);
+  check_close(y,tst);
+
+  tst = ublas::prod(B,x) + b;
+  prod_add_rhs(A,x,b,y);
+  check_close(y,tst);
+
+  tst = ublas::prod(B,x) - b;
+  prod_sub_rhs(A,x,b,y);
+  check_close(y,tst);
+
+  tst = b - ublas::prod(B,x);
+  residual(A,x,b,y);
+  check_close(y,tst);
+
+  tst = ublas::prod(ublas::trans(B),x);
+  prod_trans(A,x,y);
+  check_close(y,tst);
+
+  tst = ublas::prod(ublas::trans(B),x) + b;
+  prod_trans(A,x,b,y);
+  check_close(y,tst);
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_math_big_csr_matrix);
+
+BOOST_AUTO_TEST_CASE(compressed_matrix_test_case)
+{
+  matrix_type A;
+  make_sparse(A,900,40,false);
+  test_products(A,A);
+}
+
+BOOST_AUTO_TEST_CASE(csr_matrix_test_case)
+{
+  matrix_type A;
+  make_sparse(A,900,40,false);
+
+  OpenTissue::math::big::CSRMatrix<double> C(A);
+  BOOST_CHECK( C.size1() == A.size1() );
+  BOOST_CHECK( C.size2() == A.size2() );
+  BOOST_CHECK( C.nnz()   == A.nnz()   );
+  for(size_t i=0;i<A.size1();i+=7)
+    for(size_t j=0;j<A.size2();j+=5)
+      BOOST_CHECK( C(i,j) == A(i,j) );
+
+  test_products(C,A);
+
+  vector_type x;
+  make_vector(x,A.size2());
+  for(size_t i=0;i<A.size1();++i)
+    BOOST_CHECK_SMALL( OpenTissue::math::big::prod_row(C,x,i) - OpenTissue::math::big::prod_row(A,x,i), 1e-10 );
+
+  // Small matrices use the sequential code path
+  matrix_type S;
+  make_sparse(S,10,3,false);
+  OpenTissue::math::big::CSRMatrix<double> D(S);
+  test_products(D,S);
+
+  // Change the values but not the structure
+  OpenTissue::math::Random<double> value(-1.0,1.0);
+  for(size_t k=0;k<A.nnz();++k)
+    A.value_data()[k] = value();
+  C.assign_values(A);
+  BOOST_CHECK( C.nnz() == A.nnz() );
+  for(size_t i=0;i<A.size1();i+=7)
+    for(size_t j=0;j<A.size2();j+=5)
+      BOOST_CHECK( C(i,j) == A(i,j) );
+
+  test_products(C,A);
+}
+
+BOOST_AUTO_TEST_CASE(bcsr_matrix_test_case)
+{
+  matrix_type A;
+  make_sparse(A,900,40,false);
+
+  OpenTissue::math::big::BCSRMatrix<double,3> C(A);
+  BOOST_CHECK( C.size1() == A.size1() );
+  BOOST_CHECK( C.size2() == A.size2() );
+  for(size_t i=0;i<A.size1();i+=7)
+    for(size_t j=0;j<A.size2();j+=5)
+      BOOST_CHECK( C(i,j) == A(i,j) );
+
+  test_products(C,A);
+
+  matrix_type S;
+  make_sparse(S,12,3,false);
+  OpenTissue::math::big::BCSRMatrix<double,6> D(S);
+  test_products(D,S);
+
+  matrix_type W;
+  W.resize(10,10,false);
+  OpenTissue::math::big::BCSRMatrix<double,3> E;
+  BOOST_CHECK_THROW( E.assign(W), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(conjugate_gradient_test_case)
+{
+  matrix_type A;
+  make_sparse(A,900,40,true);
+
+  vector_type y, b;
+  make_vector(y,A.size1());
+  b = ublas::prod(A,y);
+
+  OpenTissue::math::big::CSRMatrix<double>    C(A);
+  OpenTissue::math::big::BCSRMatrix<double,3> D(A);
+
+  size_t iterations;
+  vector_type x(A.size2());
+
+  x.clear();
+  OpenTissue::math::big::conjugate_gradient(A,x,b,100u,1e-12,iterations);
+  BOOST_CHECK( iterations < 100u );
+  check_close(x,y);
+
+  x.clear();
+  OpenTissue::math::big::conjugate_gradient(C,x,b,100u,1e-12,iterations);
+  BOOST_CHECK( iterations < 100u );
+  check_close(x,y);
+
+  x.clear();
+  OpenTissue::math::big::conjugate_gradient(D,x,b,100u,1e-12,iterations);
+  BOOST_CHECK( iterations < 100u );
+  check_close(x,y);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
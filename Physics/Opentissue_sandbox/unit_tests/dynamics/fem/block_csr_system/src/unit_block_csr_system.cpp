@@ -0,0 +1,268 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_basic_types.h>
+#include <OpenTissue/core/containers/t4mesh/util/t4mesh_block_generator.h>
+#include <OpenTissue/dynamics/fem/fem.h>
+#include <OpenTissue/dynamics/fem/fem_block_csr_system.h>
+#include <cmath>
+#include <vector>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef OpenTissue::math::BasicMathTypes<double, size_t>  math_types;
+typedef math_types::vector3_type                          vector3_type;
+typedef math_types::matrix3x3_type                        matrix3x3_type;
+typedef OpenTissue::fem::Mesh<math_types>                 mesh_type;
+typedef mesh_type::node_iterator                          node_iterator;
+typedef mesh_type::tetrahedron_iterator                   tetrahedron_iterator;
+typedef OpenTissue::fem::BlockCSRSystem<mesh_type>        system_type;
+typedef system_type::matrix_type                          matrix_type;
+
+/**
+* A bar of blocks with the nodes at x=0 fixed.
+*/
+void make_bar(mesh_type & mesh, unsigned int I, unsigned int J, unsigned int K, double young)
+{
+  OpenTissue::t4mesh::generate_blocks(I, J, K, 0.1, 0.1, 0.1, mesh);
+  OpenTissue::fem::update_original_coord(mesh.node_begin(), mesh.node_end());
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+  {
+    n->m_fixed = n->m_model_coord(0) < 0.01;
+    n->m_velocity.clear();
+  }
+  OpenTissue::fem::init(mesh, young, 0.33, 1000.0, 10e30, 0.0, 0.0);
+}
+
+/**
+* Twist and bend the bar so the tetrahedra get non-trivial rotations.
+*/
+void deform(mesh_type & mesh)
+{
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+  {
+    if(n->m_fixed)
+      continue;
+    vector3_type const & x0 = n->m_model_coord;
+    double const angle = 0.5*x0(0);
+    double const c = std::cos(angle);
+    double const s = std::sin(angle);
+    n->m_coord = vector3_type( x0(0), c*x0(1) - s*x0(2) - 0.1*x0(0)*x0(0), s*x0(1) + c*x0(2) );
+  }
+}
+
+void gravity(mesh_type & mesh)
+{
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+    n->m_f_external = vector3_type(0.0, -9.81*n->m_mass, 0.0);
+}
+
+double max_difference(matrix3x3_type const & A, matrix3x3_type const & B)
+{
+  double d = 0.0;
+  for(int r = 0; r < 3; ++r)
+    for(int c = 0; c < 3; ++c)
+      d = std::max( d, std::fabs( A(r,c) - B(r,c) ) );
+  return d;
+}
+
+/**
+* Counts how often every tetrahedron is visited by the chunk traversal.
+*/
+class visit_counter
+{
+public:
+  visit_counter(std::vector<int> & visits) : m_visits(visits) {}
+  void operator()(int begin, int end)
+  {
+    for(int e = begin; e < end; ++e)
+      ++m_visits[e];
+  }
+protected:
+  std::vector<int> & m_visits;
+};
+
+BOOST_AUTO_TEST_SUITE(opentissue_fem_block_csr_system);
+
+BOOST_AUTO_TEST_CASE(structure_test_case)
+{
+  mesh_type mesh;
+  make_bar(mesh, 10, 3, 3, 500000.0);
+
+  system_type system;
+  system.set_chunk_size(7);
+  system.init(mesh);
+
+  matrix_type const & A = system.matrix();
+  int const N = static_cast<int>( mesh.size_nodes() );
+  int const E = static_cast<int>( mesh.size_tetrahedra() );
+  BOOST_CHECK( A.rows() == N );
+
+  for(int i = 0; i < N; ++i)
+  {
+    BOOST_CHECK( A.column( A.diagonal(i) ) == i );
+    for(int k = A.row_begin(i) + 1; k < A.row_end(i); ++k)
+      BOOST_CHECK( A.column(k - 1) < A.column(k) );
+  }
+
+  // Every node pair of a tetrahedron maps to the block of its row and column
+  for(int e = 0; e < E; ++e)
+  {
+    tetrahedron_iterator T = mesh.tetrahedron(e);
+    int const * scatter = system.scatter(e);
+    for(int i = 0; i < 4; ++i)
+      for(int j = 0; j < 4; ++j)
+      {
+        int const k   = scatter[4*i + j];
+        int const row = static_cast<int>( T->node_idx(i) );
+        BOOST_CHECK( k >= A.row_begin(row) && k < A.row_end(row) );
+        BOOST_CHECK( A.column(k) == static_cast<int>( T->node_idx(j) ) );
+      }
+  }
+
+  // Every tetrahedron belongs to exactly one chunk
+  std::vector<int> visits( E, 0 );
+  visit_counter counter( visits );
+  system.for_each_chunk( counter );
+  for(int e = 0; e < E; ++e)
+    BOOST_CHECK( visits[e] == 1 );
+}
+
+BOOST_AUTO_TEST_CASE(stiffness_assembly_test_case)
+{
+  mesh_type a, b;
+  make_bar(a, 10, 3, 3, 500000.0);
+  make_bar(b, 10, 3, 3, 500000.0);
+  deform(a);
+  deform(b);
+
+  OpenTissue::fem::detail::clear_stiffness_assembly(a.node_begin(), a.node_end());
+  OpenTissue::fem::detail::update_orientation(a.tetrahedron_begin(), a.tetrahedron_end());
+  OpenTissue::fem::detail::stiffness_assembly(a.tetrahedron_begin(), a.tetrahedron_end());
+
+  // Small chunks give many colors and many concurrent chunks
+  system_type system;
+  system.set_chunk_size(4);
+  OpenTissue::fem::detail::update_orientation(b.tetrahedron_begin(), b.tetrahedron_end());
+  system.stiffness_assembly(b);
+
+  matrix_type const & K = system.matrix();
+  int const N = static_cast<int>( a.size_nodes() );
+  for(int i = 0; i < N; ++i)
+  {
+    node_iterator n = a.node(i);
+    BOOST_CHECK( K.row_end(i) - K.row_begin(i) == static_cast<int>( n->m_K_row.size() ) );
+    for(mesh_type::node_type::matrix_iterator Kij = n->Kbegin(); Kij != n->Kend(); ++Kij)
+    {
+      int const k = K.find(i, Kij->first);
+      BOOST_REQUIRE( k >= 0 );
+      BOOST_CHECK_SMALL( max_difference( K.block(k), Kij->second ), 1e-6 );
+    }
+    BOOST_CHECK_SMALL( std::sqrt( (n->m_f0 - b.node(i)->m_f0)*(n->m_f0 - b.node(i)->m_f0) ), 1e-8 );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(simulate_test_case)
+{
+  // With the identity preconditioner and the same number of iterations
+  // the block CSR path repeats the computations of the node map path
+  mesh_type a, b;
+  make_bar(a, 10, 3, 3, 500000.0);
+  make_bar(b, 10, 3, 3, 500000.0);
+
+  system_type system;
+  system.set_preconditioner( system_type::identity_preconditioner );
+
+  double max_displacement = 0.0;
+  for(int step = 0; step < 20; ++step)
+  {
+    gravity(a);
+    gravity(b);
+    OpenTissue::fem::simulate(a, 0.01, true);
+    OpenTissue::fem::simulate(b, 0.01, true, system);
+  }
+  for(size_t i = 0; i < a.size_nodes(); ++i)
+  {
+    vector3_type const u = a.node(i)->m_coord - a.node(i)->m_model_coord;
+    vector3_type const d = a.node(i)->m_coord - b.node(i)->m_coord;
+    max_displacement = std::max( max_displacement, std::sqrt(u*u) );
+    BOOST_CHECK_SMALL( std::sqrt(d*d), 1e-5 );
+  }
+  BOOST_CHECK( max_displacement > 1e-2 );
+
+  // More mass damping slows the bar down
+  mesh_type c;
+  make_bar(c, 10, 3, 3, 500000.0);
+
+  system_type damped;
+  damped.set_preconditioner( system_type::identity_preconditioner );
+  damped.set_mass_damping( 20.0 );
+  BOOST_CHECK( damped.get_mass_damping() == 20.0 );
+
+  for(int step = 0; step < 20; ++step)
+  {
+    gravity(c);
+    OpenTissue::fem::simulate(c, 0.01, true, damped);
+  }
+  double max_damped_displacement = 0.0;
+  for(size_t i = 0; i < c.size_nodes(); ++i)
+  {
+    vector3_type const u = c.node(i)->m_coord - c.node(i)->m_model_coord;
+    max_damped_displacement = std::max( max_damped_displacement, std::sqrt(u*u) );
+  }
+  BOOST_CHECK( max_damped_displacement < 0.5*max_displacement );
+}
+
+BOOST_AUTO_TEST_CASE(preconditioner_test_case)
+{
+  system_type::preconditioner_type const types[3] = {
+    system_type::identity_preconditioner
+    , system_type::block_jacobi_preconditioner
+    , system_type::incomplete_cholesky_preconditioner
+  };
+
+  mesh_type meshes[3];
+  unsigned int iterations[3];
+  for(int p = 0; p < 3; ++p)
+  {
+    mesh_type & mesh = meshes[p];
+    make_bar(mesh, 20, 6, 6, 5000000.0);
+    deform(mesh);
+    gravity(mesh);
+
+    system_type system;
+    system.set_preconditioner( types[p] );
+    system.set_min_iterations( 0 );
+    system.set_max_iterations( 5000 );
+    system.set_tolerance( 1e-16 );
+
+    OpenTissue::fem::detail::update_orientation(mesh.tetrahedron_begin(), mesh.tetrahedron_end());
+    system.stiffness_assembly(mesh);
+    system.dynamics_assembly(mesh, 2.0, 0.01);
+    iterations[p] = system.conjugate_gradients(mesh);
+    BOOST_CHECK( iterations[p] < 5000u );
+  }
+
+  // Preconditioning pays off on the stiff bar
+  BOOST_CHECK( iterations[1] < iterations[0] );
+  BOOST_CHECK( iterations[2] < iterations[1] );
+
+  // All preconditioners converge to the same velocities
+  for(int p = 1; p < 3; ++p)
+    for(size_t i = 0; i < meshes[0].size_nodes(); ++i)
+    {
+      vector3_type const d = meshes[p].node(i)->m_velocity - meshes[0].node(i)->m_velocity;
+      BOOST_CHECK_SMALL( std::sqrt(d*d), 1e-6 );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,244 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_basic_types.h>
+#include <OpenTissue/core/containers/t4mesh/util/t4mesh_block_generator.h>
+#include <OpenTissue/dynamics/fem/fem.h>
+#include <OpenTissue/dynamics/fem/fem_corotational_elements.h>
+#include <cmath>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef OpenTissue::math::BasicMathTypes<double, size_t>  math_types;
+typedef math_types::vector3_type                          vector3_type;
+typedef math_types::matrix3x3_type                        matrix3x3_type;
+typedef OpenTissue::fem::Mesh<math_types>                 mesh_type;
+typedef mesh_type::node_iterator                          node_iterator;
+typedef mesh_type::tetrahedron_iterator                   tetrahedron_iterator;
+typedef OpenTissue::fem::BlockCSRSystem<mesh_type>        system_type;
+typedef OpenTissue::fem::CorotationalElements<mesh_type>  elements_type;
+typedef system_type::matrix_type                          matrix_type;
+
+/**
+* A bar of blocks with the nodes at x=0 fixed. A yield below
+* the expected strains turns on plasticity.
+*/
+void make_bar(mesh_type & mesh, double yield)
+{
+  OpenTissue::t4mesh::generate_blocks(10u, 3u, 3u, 0.1, 0.1, 0.1, mesh);
+  OpenTissue::fem::update_original_coord(mesh.node_begin(), mesh.node_end());
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+  {
+    n->m_fixed = n->m_model_coord(0) < 0.01;
+    n->m_velocity.clear();
+    n->m_f_external.clear();
+  }
+  OpenTissue::fem::init(mesh, 500000.0, 0.33, 1000.0, yield, 0.2, 0.2);
+}
+
+/**
+* Twist, bend and stretch the bar so the tetrahedra get non-trivial rotations and strains.
+*/
+void deform(mesh_type & mesh)
+{
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+  {
+    if(n->m_fixed)
+      continue;
+    vector3_type const & x0 = n->m_model_coord;
+    double const angle = 0.5*x0(0);
+    double const c = std::cos(angle);
+    double const s = std::sin(angle);
+    n->m_coord = vector3_type( 1.05*x0(0), c*x0(1) - s*x0(2) - 0.1*x0(0)*x0(0), s*x0(1) + c*x0(2) );
+  }
+}
+
+void gravity(mesh_type & mesh)
+{
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+    n->m_f_external = vector3_type(0.0, -50.0*9.81*n->m_mass, 0.0);
+}
+
+double max_difference(matrix3x3_type const & A, matrix3x3_type const & B)
+{
+  double d = 0.0;
+  for(int r = 0; r < 3; ++r)
+    for(int c = 0; c < 3; ++c)
+      d = std::max( d, std::fabs( A(r,c) - B(r,c) ) );
+  return d;
+}
+
+double length(vector3_type const & v)
+{
+  return std::sqrt(v*v);
+}
+
+/**
+* Check that R is orthonormal with determinant one.
+*/
+void check_rotation(matrix3x3_type const & R)
+{
+  BOOST_CHECK_SMALL( max_difference( R*trans(R), OpenTissue::math::diag(1.0) ), 1e-8 );
+  BOOST_CHECK_CLOSE( OpenTissue::math::det(R), 1.0, 1e-6 );
+}
+
+/**
+* Runs the element pass next to update_orientation(), stiffness_assembly()
+* and add_plasticity_force() on the same deformed bar and compares the
+* rotations, the stiffness matrix, the force offsets and the plastic forces.
+*/
+void test_element_pass(bool use_stiffness_warping, double yield)
+{
+  mesh_type a, b;
+  make_bar(a, yield);
+  make_bar(b, yield);
+  deform(a);
+  deform(b);
+
+  system_type system_a;
+  if(use_stiffness_warping)
+    OpenTissue::fem::detail::update_orientation(a.tetrahedron_begin(), a.tetrahedron_end());
+  else
+    OpenTissue::fem::detail::reset_orientation(a.tetrahedron_begin(), a.tetrahedron_end());
+  system_a.stiffness_assembly(a);
+  OpenTissue::fem::detail::add_plasticity_force(a.tetrahedron_begin(), a.tetrahedron_end(), 0.01);
+
+  system_type system_b;
+  elements_type elements;
+  elements.run(b, system_b, 0.01, use_stiffness_warping);
+
+  for(size_t e = 0; e < a.size_tetrahedra(); ++e)
+  {
+    matrix3x3_type const R = elements.rotation( static_cast<int>(e) );
+    BOOST_CHECK_SMALL( max_difference( R, a.tetrahedron(e)->m_Re ), 1e-10 );
+    check_rotation( R );
+  }
+
+  matrix_type const & K_a = system_a.matrix();
+  matrix_type const & K_b = system_b.matrix();
+  BOOST_REQUIRE( K_a.size() == K_b.size() );
+  for(int k = 0; k < K_a.size(); ++k)
+    BOOST_CHECK_SMALL( max_difference( K_a.block(k), K_b.block(k) ), 1e-6 );
+
+  double max_plastic = 0.0;
+  for(size_t i = 0; i < a.size_nodes(); ++i)
+  {
+    BOOST_CHECK_SMALL( length( a.node(i)->m_f0 - b.node(i)->m_f0 ), 1e-8 );
+    BOOST_CHECK_SMALL( length( a.node(i)->m_f_external - b.node(i)->m_f_external ), 1e-8 );
+    max_plastic = std::max( max_plastic, length( a.node(i)->m_f_external ) );
+  }
+  if(yield < 1.0)
+    BOOST_CHECK( max_plastic > 1.0 );
+  else
+    BOOST_CHECK( max_plastic == 0.0 );
+}
+
+/**
+* Steps the node map simulate() next to the overload using the element pass.
+*/
+void test_simulate(bool use_stiffness_warping, double yield)
+{
+  mesh_type a, b;
+  make_bar(a, yield);
+  make_bar(b, yield);
+
+  system_type system;
+  system.set_preconditioner( system_type::identity_preconditioner );
+  elements_type elements;
+
+  for(int step = 0; step < 20; ++step)
+  {
+    gravity(a);
+    gravity(b);
+    OpenTissue::fem::simulate(a, 0.01, use_stiffness_warping);
+    OpenTissue::fem::simulate(b, 0.01, use_stiffness_warping, system, elements);
+  }
+
+  double max_displacement = 0.0;
+  for(size_t i = 0; i < a.size_nodes(); ++i)
+  {
+    max_displacement = std::max( max_displacement, length( a.node(i)->m_coord - a.node(i)->m_model_coord ) );
+    BOOST_CHECK_SMALL( length( a.node(i)->m_coord - b.node(i)->m_coord ), 1e-5 );
+  }
+  BOOST_CHECK( max_displacement > 1e-1 );
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_fem_corotational_elements);
+
+BOOST_AUTO_TEST_CASE(element_pass_test_case)
+{
+  test_element_pass(true,  10e30);
+  test_element_pass(false, 10e30);
+  test_element_pass(true,  0.001);
+  test_element_pass(false, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(simulate_test_case)
+{
+  test_simulate(true,  10e30);
+  test_simulate(false, 10e30);
+  test_simulate(true,  0.001);
+  test_simulate(false, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(polar_decomposition_test_case)
+{
+  // Two tetrahedra on the same nodes in different order
+  mesh_type mesh;
+  for(int i = 0; i < 4; ++i)
+    mesh.insert();
+  mesh.node(0)->m_coord = vector3_type(0.0, 0.0, 0.0);
+  mesh.node(1)->m_coord = vector3_type(1.0, 0.0, 0.0);
+  mesh.node(2)->m_coord = vector3_type(0.0, 1.0, 0.0);
+  mesh.node(3)->m_coord = vector3_type(0.0, 0.0, 1.0);
+  mesh.insert(0, 1, 2, 3);
+  mesh.insert(2, 3, 0, 1);
+  OpenTissue::fem::update_original_coord(mesh.node_begin(), mesh.node_end());
+  OpenTissue::fem::init(mesh, 500000.0, 0.33, 1000.0, 10e30, 0.0, 0.0);
+
+  // Shear the tetrahedron in the xy-plane, F = [1 s 0; 0 1 0; 0 0 1]
+  double const s = 0.8;
+  for(node_iterator n = mesh.node_begin(); n != mesh.node_end(); ++n)
+  {
+    vector3_type const & x0 = n->m_model_coord;
+    n->m_coord = vector3_type( x0(0) + s*x0(1), x0(1), x0(2) );
+  }
+
+  // The rotation of the polar decomposition F = R U
+  double const w = std::sqrt(4.0 + s*s);
+  matrix3x3_type const expected(
+    2.0/w, s/w,   0.0
+    , -s/w, 2.0/w, 0.0
+    , 0.0,  0.0,   1.0
+    );
+
+  system_type system;
+  elements_type elements;
+  elements.set_use_polar_decomposition(true);
+  elements.run(mesh, system, 0.01, true);
+  for(int e = 0; e < 2; ++e)
+  {
+    check_rotation( elements.rotation(e) );
+    BOOST_CHECK_SMALL( max_difference( elements.rotation(e), expected ), 1e-8 );
+  }
+
+  // Orthonormalization of the rows favors the x-axis and is not the closest rotation
+  elements.set_use_polar_decomposition(false);
+  elements.run(mesh, system, 0.01, true);
+  for(int e = 0; e < 2; ++e)
+  {
+    check_rotation( elements.rotation(e) );
+    BOOST_CHECK( max_difference( elements.rotation(e), expected ) > 1e-2 );
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -166,3 +166,25 @@ OpenTissue::mbd::default_ublas_math_policy<double>
 
 void (*interface_ptr2)() = &(interface_compile_test<types2> );
 void (*utility_ptr2)() = &(utilities_compile_test<types2> );
+
+
+template<typename types>
+class MyIncrementalCollisionDetection
+  : public OpenTissue::mbd::CollisionDetection<
+  types
+  , OpenTissue::mbd::IncrementalSweepNPrune
+  , OpenTissue::mbd::GeometryDispatcher
+  , OpenTissue::mbd::CachingContactGraphAnalysis
+  >
+{};
+
+
+typedef OpenTissue::mbd::Types<
+OpenTissue::mbd::default_ublas_math_policy<double>
+, OpenTissue::mbd::NoSleepyPolicy
+, stepper_type
+, MyIncrementalCollisionDetection
+, OpenTissue::mbd::ExplicitFixedStepSimulator
+> types3;
+
+void (*interface_ptr3)() = &(interface_compile_test<types3> );
@@ -0,0 +1,385 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/core/math/math_vector3.h>
+#include <OpenTissue/core/math/math_matrix3x3.h>
+#include <OpenTissue/dynamics/mbd/collision_detection/mbd_sweep_and_prune.h>
+#include <OpenTissue/dynamics/mbd/collision_detection/mbd_incremental_sweep_and_prune.h>
+
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+#include <boost/iterator/indirect_iterator.hpp>
+
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+* The parts of the mbd type binder used by the broad phases.
+*
+* The broad phases only see bodies through their position, orientation
+* and collision AABB, and the configuration through its body iterators,
+* the collision envelope and the contact graph edges, so bodies are
+* spheres and the configuration deletes the edges of a removed body
+* before the broad phase is told, just like mbd::Configuration.
+*/
+template< template<typename> class broad_phase_policy >
+class BroadPhaseTypes
+{
+public:
+
+  typedef BroadPhaseTypes<broad_phase_policy>  types;
+
+  class math_policy
+  {
+  public:
+    typedef size_t                                index_type;
+    typedef double                                real_type;
+    typedef OpenTissue::math::Vector3<double>     vector3_type;
+    typedef OpenTissue::math::Matrix3x3<double>   matrix3x3_type;
+  };
+
+  class body_type;
+  class edge_type;
+  class configuration_type;
+
+  typedef broad_phase_policy<types>                                                      broad_phase_type;
+  typedef int                                                                            contact_type;
+  typedef std::list<edge_type*>                                                          edge_ptr_container;
+  typedef boost::indirect_iterator<typename edge_ptr_container::iterator, edge_type>     indirect_edge_iterator;
+
+  class body_type
+    : public broad_phase_type::node_traits
+  {
+  public:
+
+    typedef typename types::indirect_edge_iterator  indirect_edge_iterator;
+
+    typename math_policy::vector3_type  m_r;
+    double                              m_radius;
+    edge_ptr_container                  m_edges;
+
+    indirect_edge_iterator edge_begin() { return indirect_edge_iterator(m_edges.begin()); }
+    indirect_edge_iterator edge_end()   { return indirect_edge_iterator(m_edges.end());   }
+
+    void get_position(typename math_policy::vector3_type & r) const { r = m_r; }
+    void get_orientation(typename math_policy::matrix3x3_type & R) const { R = OpenTissue::math::diag(1.0); }
+
+    void compute_collision_aabb(
+      typename math_policy::vector3_type const & r
+      , typename math_policy::matrix3x3_type const & /*R*/
+      , typename math_policy::vector3_type & pmin
+      , typename math_policy::vector3_type & pmax
+      , double const & envelope
+      ) const
+    {
+      double const e = m_radius + envelope;
+      pmin = r - typename math_policy::vector3_type(e, e, e);
+      pmax = r + typename math_policy::vector3_type(e, e, e);
+    }
+  };
+
+  class edge_type
+    : public broad_phase_type::edge_traits
+  {
+  public:
+
+    body_type * m_A;
+    body_type * m_B;
+
+    body_type * get_body_A() { return m_A; }
+    body_type * get_body_B() { return m_B; }
+  };
+
+  class configuration_type
+  {
+  public:
+
+    typedef std::list<body_type*>                                                       body_ptr_container;
+    typedef boost::indirect_iterator<typename body_ptr_container::iterator, body_type>  body_iterator;
+    typedef std::pair<body_type*, body_type*>                                           edge_key;
+
+    body_ptr_container               m_bodies;
+    std::map<edge_key, edge_type>    m_edges;
+    broad_phase_type *               m_broad_phase;
+
+    body_iterator body_begin() { return body_iterator(m_bodies.begin()); }
+    body_iterator body_end()   { return body_iterator(m_bodies.end());   }
+
+    double get_collision_envelope() const { return 0.01; }
+
+    static edge_key key(body_type * A, body_type * B) { return (A < B) ? edge_key(A, B) : edge_key(B, A); }
+
+    edge_type * get_edge(body_type * A, body_type * B)
+    {
+      typename std::map<edge_key, edge_type>::iterator edge = m_edges.find(key(A, B));
+      return (edge == m_edges.end()) ? 0 : &(edge->second);
+    }
+
+    edge_type * add(body_type * A, body_type * B)
+    {
+      edge_type & edge = m_edges[key(A, B)];
+      edge.m_A = A;
+      edge.m_B = B;
+      A->m_edges.push_back(&edge);
+      B->m_edges.push_back(&edge);
+      return &edge;
+    }
+
+    void add(body_type * body)
+    {
+      m_bodies.push_back(body);
+      m_broad_phase->add(body);
+    }
+
+    void remove(body_type * body)
+    {
+      while(!body->m_edges.empty())
+      {
+        edge_type * edge = body->m_edges.front();
+        edge->m_A->m_edges.remove(edge);
+        edge->m_B->m_edges.remove(edge);
+        m_edges.erase(key(edge->m_A, edge->m_B));
+      }
+      m_bodies.remove(body);
+      m_broad_phase->remove(body);
+    }
+  };
+};
+
+typedef BroadPhaseTypes<OpenTissue::mbd::SweepNPrune>             snp_types;
+typedef BroadPhaseTypes<OpenTissue::mbd::IncrementalSweepNPrune>  isnp_types;
+typedef OpenTissue::math::Vector3<double>                         vector3_type;
+
+typedef std::pair<int,int>    body_pair;
+typedef std::set<body_pair>   body_pair_set;
+
+/**
+* A broad phase with its configuration, bodies are identified by their position in the body array.
+*/
+template<typename types>
+class Scene
+{
+public:
+
+  typedef typename types::broad_phase_type    broad_phase_type;
+  typedef typename types::configuration_type  configuration_type;
+  typedef typename types::body_type           body_type;
+  typedef typename types::edge_ptr_container  edge_ptr_container;
+
+  broad_phase_type        m_broad_phase;
+  configuration_type      m_configuration;
+  std::vector<body_type>  m_bodies;
+  std::vector<char>       m_added;
+
+  Scene(std::vector<double> const & radii)
+    : m_bodies(radii.size())
+    , m_added(radii.size(), 1)
+  {
+    m_broad_phase.init(m_configuration);
+    m_configuration.m_broad_phase = &m_broad_phase;
+    for(size_t i = 0; i < m_bodies.size(); ++i)
+    {
+      m_bodies[i].m_radius = radii[i];
+      m_configuration.add(&m_bodies[i]);
+    }
+  }
+
+  int id(body_type const * body) const { return static_cast<int>(body - &m_bodies[0]); }
+
+  void insert(edge_ptr_container const & edges, body_pair_set & pairs) const
+  {
+    pairs.clear();
+    for(typename edge_ptr_container::const_iterator edge = edges.begin(); edge != edges.end(); ++edge)
+    {
+      int const a = id( (*edge)->get_body_A() );
+      int const b = id( (*edge)->get_body_B() );
+      pairs.insert( (a < b) ? body_pair(a,b) : body_pair(b,a) );
+    }
+  }
+
+  void set_position(int i, vector3_type const & r) { m_bodies[i].m_r = r; }
+
+  void add(int i)
+  {
+    m_configuration.add(&m_bodies[i]);
+    m_added[i] = 1;
+  }
+
+  void remove(int i)
+  {
+    m_configuration.remove(&m_bodies[i]);
+    m_added[i] = 0;
+  }
+
+  size_t run(body_pair_set & pairs)
+  {
+    edge_ptr_container edges;
+    m_broad_phase.run(edges);
+    insert(edges, pairs);
+    return edges.size();
+  }
+};
+
+/**
+* Removes all pairs of a body.
+*/
+void erase(body_pair_set & pairs, int body)
+{
+  body_pair_set::iterator pair = pairs.begin();
+  while(pair != pairs.end())
+  {
+    if(pair->first == body || pair->second == body)
+      pairs.erase(pair++);
+    else
+      ++pair;
+  }
+}
+
+double random(double lower, double upper)
+{
+  return lower + (upper - lower)*std::rand()/RAND_MAX;
+}
+
+/**
+* Removes a body from both scenes and from the pairs of the last frame.
+*/
+void remove(Scene<snp_types> & reference, Scene<isnp_types> & incremental, body_pair_set & previous, int i)
+{
+  // SweepNPrune purges its reported overlaps through the edges of the body,
+  // so it must be told before the configuration deletes them
+  reference.m_broad_phase.remove(&reference.m_bodies[i]);
+  reference.remove(i);
+  incremental.remove(i);
+  erase(previous, i);
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_dynamics_multibody_incremental_sweep_and_prune);
+
+BOOST_AUTO_TEST_CASE(incremental_sweep_and_prune_test_case)
+{
+  int const N = 200;
+  int const frames = 120;
+  double const size = 8.0;
+
+  std::srand(7);
+  std::vector<double> radii(N);
+  std::vector<vector3_type> positions(N);
+  std::vector<vector3_type> velocities(N);
+  for(int i = 0; i < N; ++i)
+  {
+    radii[i]      = random(0.2, 0.5);
+    positions[i]  = vector3_type( random(0.0, size), random(0.0, size), random(0.0, size) );
+    velocities[i] = vector3_type( random(-0.1, 0.1), random(-0.1, 0.1), random(-0.1, 0.1) );
+  }
+
+  Scene<snp_types>  reference(radii);
+  Scene<isnp_types> incremental(radii);
+
+  body_pair_set previous;
+  size_t changes = 0;
+  for(int frame = 0; frame < frames; ++frame)
+  {
+    // Every tenth frame nothing moves, otherwise a third of the bodies rest
+    bool const still = (frame % 10 == 9);
+    if(!still)
+    {
+      for(int i = 0; i < N; ++i)
+      {
+        if(i % 3 == frame % 3)
+          continue;
+        positions[i] += velocities[i];
+        for(int k = 0; k < 3; ++k)
+          if(positions[i](k) < 0.0 || positions[i](k) > size)
+            velocities[i](k) = -velocities[i](k);
+      }
+    }
+    for(int i = 0; i < N; ++i)
+    {
+      reference.set_position(i, positions[i]);
+      incremental.set_position(i, positions[i]);
+    }
+
+    // Remove and add bodies, single ones and many at a time
+    bool structural = false;
+    if(frame % 7 == 3)
+    {
+      int const i = std::rand() % N;
+      if(incremental.m_added[i])
+        remove(reference, incremental, previous, i);
+      else
+      {
+        reference.add(i);
+        incremental.add(i);
+      }
+      structural = true;
+    }
+    if(frame % 20 == 11)
+    {
+      for(int i = 0; i < N; i += 17)
+        if(incremental.m_added[i])
+          remove(reference, incremental, previous, i);
+      structural = true;
+    }
+    if(frame % 20 == 15)
+    {
+      for(int i = 0; i < N; ++i)
+      {
+        if(incremental.m_added[i])
+          continue;
+        reference.add(i);
+        incremental.add(i);
+      }
+      structural = true;
+    }
+
+    body_pair_set expected, overlaps;
+    reference.run(expected);
+    size_t const reported = incremental.run(overlaps);
+
+    BOOST_CHECK( reported == overlaps.size() );
+    BOOST_CHECK( overlaps == expected );
+
+    // The pairs that started and stopped overlapping since the last frame
+    body_pair_set added, removed;
+    incremental.insert( incremental.m_broad_phase.added(), added );
+    incremental.insert( incremental.m_broad_phase.removed(), removed );
+    BOOST_CHECK( added.size()   == incremental.m_broad_phase.added().size() );
+    BOOST_CHECK( removed.size() == incremental.m_broad_phase.removed().size() );
+
+    body_pair_set expected_added, expected_removed;
+    for(body_pair_set::const_iterator pair = expected.begin(); pair != expected.end(); ++pair)
+      if(previous.find(*pair) == previous.end())
+        expected_added.insert(*pair);
+    for(body_pair_set::const_iterator pair = previous.begin(); pair != previous.end(); ++pair)
+      if(expected.find(*pair) == expected.end())
+        expected_removed.insert(*pair);
+    BOOST_CHECK( added == expected_added );
+    BOOST_CHECK( removed == expected_removed );
+
+    if(still && !structural)
+    {
+      BOOST_CHECK( added.empty() );
+      BOOST_CHECK( removed.empty() );
+    }
+
+    changes += added.size() + removed.size();
+    previous.swap(expected);
+  }
+
+  // Guard against a test where nothing overlaps or nothing changes
+  BOOST_CHECK( previous.size() > 10u );
+  BOOST_CHECK( changes > 100u );
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,227 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#include <OpenTissue/dynamics/mbd/math/mbd_default_math_policy.h>
+#include <OpenTissue/dynamics/mbd/math/mbd_optimized_ublas_math_policy.h>
+#include <OpenTissue/dynamics/mbd/solvers/mbd_projected_gauss_seidel.h>
+#include <OpenTissue/dynamics/mbd/solvers/mbd_parallel_projected_gauss_seidel.h>
+
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/**
+* Contact problem of piles of bodies resting on a fixed ground body.
+*
+* Body zero is the ground, it has a zero inverse mass so all piles share
+* it without being connected. Every contact has a normal row and two
+* friction rows bounded by the normal row.
+*/
+template<typename math_policy>
+class PileProblem
+{
+public:
+
+  typedef typename math_policy::matrix_type      matrix_type;
+  typedef typename math_policy::vector_type      vector_type;
+  typedef typename math_policy::idx_vector_type  idx_vector_type;
+
+  matrix_type     m_J;
+  matrix_type     m_W;
+  vector_type     m_gamma;
+  vector_type     m_b;
+  vector_type     m_lo;
+  vector_type     m_hi;
+  idx_vector_type m_pi;
+  vector_type     m_mu;
+
+  PileProblem(std::vector<int> const & heights)
+  {
+    int bodies = 1;
+    for(size_t p = 0; p < heights.size(); ++p)
+      bodies += heights[p];
+    int const m = 3*(bodies - 1);
+
+    m_J.resize(m, 6*bodies, false);
+    m_W.resize(6*bodies, 6*bodies, false);
+    for(int body = 1; body < bodies; ++body)
+    {
+      int const j = 6*body;
+      for(int k = 0; k < 6; ++k)
+        m_W(j+k, j+k) = 1.0;
+      m_W(j+3, j+4) = 0.1;
+      m_W(j+4, j+3) = 0.1;
+    }
+
+    m_gamma.resize(m, false);
+    m_b.resize(m, false);
+    m_lo.resize(m, false);
+    m_hi.resize(m, false);
+    m_pi.resize(m, false);
+    m_mu.resize(m, false);
+
+    std::srand(3);
+    int row  = 0;
+    int base = 1;
+    for(size_t p = 0; p < heights.size(); ++p)
+    {
+      for(int h = 0; h < heights[p]; ++h, row += 3)
+      {
+        int const below = (h == 0) ? 0 : base + h - 1;
+        int const above = base + h;
+        for(int r = 0; r < 3; ++r)
+        {
+          for(int k = 0; k < 6; ++k)
+          {
+            m_J(row+r, 6*below+k) = (k == r ? -1.0 : 0.1*(std::rand()%7 - 3)) + 1e-3;
+            m_J(row+r, 6*above+k) = (k == r ?  1.0 : 0.1*(std::rand()%7 - 3)) + 1e-3;
+          }
+          m_gamma(row+r) = 0.0;
+          if(r == 0)
+          {
+            m_b(row)  = -1.0 - 0.1*(std::rand()%5);
+            m_lo(row) = 0.0;
+            m_hi(row) = 1e30;
+            m_pi(row) = m;
+            m_mu(row) = 0.0;
+          }
+          else
+          {
+            m_b(row+r)  = 0.2*(std::rand()%5 - 2);
+            m_lo(row+r) = 0.0;
+            m_hi(row+r) = 0.0;
+            m_pi(row+r) = row;
+            m_mu(row+r) = 0.5;
+          }
+        }
+      }
+      base += heights[p];
+    }
+  }
+
+  int size() const { return static_cast<int>(m_b.size()); }
+};
+
+/**
+* Runs ProjectedGaussSeidel and ParallelProjectedGaussSeidel on the same
+* problem and returns the largest difference of the solutions.
+*/
+template<typename math_policy>
+double solve_both(
+  PileProblem<math_policy> const & problem
+  , size_t iterations
+  , size_t coloring_threshold
+  , typename math_policy::vector_type & theta
+  )
+{
+  typedef typename math_policy::vector_type  vector_type;
+
+  int const m = problem.size();
+  vector_type lo_1 = problem.m_lo;
+  vector_type hi_1 = problem.m_hi;
+  vector_type lo_2 = problem.m_lo;
+  vector_type hi_2 = problem.m_hi;
+  vector_type x_1(m);
+  vector_type x_2(m);
+  for(int i = 0; i < m; ++i)
+  {
+    x_1(i) = 0.0;
+    x_2(i) = 0.0;
+  }
+
+  OpenTissue::mbd::ProjectedGaussSeidel<math_policy> sequential;
+  sequential.set_max_iterations(iterations);
+  sequential.run(problem.m_J, problem.m_W, problem.m_gamma, problem.m_b, lo_1, hi_1, problem.m_pi, problem.m_mu, x_1);
+
+  OpenTissue::mbd::ParallelProjectedGaussSeidel<math_policy> parallel;
+  parallel.set_max_iterations(iterations);
+  parallel.set_coloring_threshold(coloring_threshold);
+  parallel.profiling() = true;
+  parallel.run(problem.m_J, problem.m_W, problem.m_gamma, problem.m_b, lo_2, hi_2, problem.m_pi, problem.m_mu, x_2);
+  theta = parallel.theta();
+
+  double norm = 0.0;
+  double difference = 0.0;
+  for(int i = 0; i < m; ++i)
+  {
+    norm       = std::max(norm, std::fabs(x_1(i)));
+    difference = std::max(difference, std::fabs(x_1(i) - x_2(i)));
+  }
+  BOOST_CHECK( norm > 1.0 );
+  return difference;
+}
+
+template<typename math_policy>
+void test_single_island()
+{
+  // A single pile is a single island, it is swept in the same order as the sequential solver
+  std::vector<int> heights(1, 10);
+  PileProblem<math_policy> problem(heights);
+  typename math_policy::vector_type theta;
+  BOOST_CHECK_SMALL( solve_both(problem, 5, 256, theta), 1e-10 );
+  BOOST_CHECK( theta(4) < theta(0) );
+}
+
+template<typename math_policy>
+void test_small_islands()
+{
+  // Islands only share the fixed ground, they are independent and every island is swept in order
+  std::vector<int> heights;
+  for(int p = 0; p < 40; ++p)
+    heights.push_back(1 + p%6);
+  PileProblem<math_policy> problem(heights);
+  typename math_policy::vector_type theta;
+  BOOST_CHECK_SMALL( solve_both(problem, 5, 256, theta), 1e-10 );
+  BOOST_CHECK( theta(4) < theta(0) );
+}
+
+template<typename math_policy>
+void test_large_islands()
+{
+  // The tall piles are above the coloring threshold, their rows are visited
+  // in another order, so only the converged solutions are compared
+  std::vector<int> heights;
+  for(int p = 0; p < 10; ++p)
+    heights.push_back(4);
+  heights.push_back(40);
+  heights.push_back(100);
+  PileProblem<math_policy> problem(heights);
+  typename math_policy::vector_type theta;
+  int const iterations = 500;
+  BOOST_CHECK_SMALL( solve_both(problem, iterations, 60, theta), 1e-8 );
+  BOOST_CHECK( theta(iterations-1) < 1e-12*theta(0) );
+  for(int k = 1; k < iterations; ++k)
+    BOOST_CHECK( theta(k) <= theta(k-1) || theta(k) < 1e-20 );
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_dynamics_multibody_parallel_projected_gauss_seidel);
+
+BOOST_AUTO_TEST_CASE(single_island_test_case)
+{
+  test_single_island< OpenTissue::mbd::default_ublas_math_policy<double> >();
+  test_single_island< OpenTissue::mbd::optimized_ublas_math_policy<double> >();
+}
+
+BOOST_AUTO_TEST_CASE(small_islands_test_case)
+{
+  test_small_islands< OpenTissue::mbd::default_ublas_math_policy<double> >();
+  test_small_islands< OpenTissue::mbd::optimized_ublas_math_policy<double> >();
+}
+
+BOOST_AUTO_TEST_CASE(large_islands_test_case)
+{
+  test_large_islands< OpenTissue::mbd::default_ublas_math_policy<double> >();
+  test_large_islands< OpenTissue::mbd::optimized_ublas_math_policy<double> >();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
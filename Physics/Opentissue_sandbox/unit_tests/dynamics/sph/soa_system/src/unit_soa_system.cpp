@@ -0,0 +1,154 @@
+//
+// OpenTissue, A toolbox for physical based simulation and animation.
+// Copyright (C) 2007 Department of Computer Science, University of Copenhagen
+//
+#include <OpenTissue/configuration.h>
+
+#define SPHSH
+
+#include <OpenTissue/core/math/math_basic_types.h>
+#include <OpenTissue/core/math/math_random.h>
+#include <OpenTissue/collision/spatial_hashing/spatial_hashing.h>
+#include <OpenTissue/dynamics/sph/sph.h>
+#include <OpenTissue/utility/utility_runtime_type.h>
+#include <cmath>
+#include <vector>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <OpenTissue/utility/utility_push_boost_filter.h>
+#include <boost/test/auto_unit_test.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+#include <boost/test/test_tools.hpp>
+#include <OpenTissue/utility/utility_pop_boost_filter.h>
+
+typedef OpenTissue::utility::RuntimeType<double>  RTreal;
+RTreal Radius;
+
+typedef OpenTissue::math::BasicMathTypes<double,int>  math_types;
+typedef math_types::vector3_type                      vector3_type;
+typedef OpenTissue::sph::Particle<double, OpenTissue::math::Vector3, &Radius>  particle_type;
+typedef OpenTissue::sph::ImplicitPrimitivesCollisionDetectionPolicy<double, vector3_type, particle_type>  collision_detection;
+
+typedef OpenTissue::sph::Types<
+  double
+  , OpenTissue::math::Vector3
+  , particle_type
+  , collision_detection
+  , OpenTissue::spatial_hashing::PrimeNumberHashFunction
+  , OpenTissue::spatial_hashing::Grid
+  , OpenTissue::spatial_hashing::PointDataQuery
+> sph_types;
+
+typedef OpenTissue::sph::WPoly6<sph_types, &Radius, false>      poly6_kernel;
+typedef OpenTissue::sph::WSpiky<sph_types, &Radius, false>      spiky_kernel;
+typedef OpenTissue::sph::WViscosity<sph_types, &Radius, false>  viscosity_kernel;
+
+typedef OpenTissue::sph::System<
+  sph_types
+  , OpenTissue::sph::Density<sph_types, poly6_kernel>
+  , OpenTissue::sph::Pressure<sph_types>
+  , OpenTissue::sph::SurfaceNormal<sph_types, poly6_kernel>
+  , OpenTissue::sph::Gravity<sph_types>
+  , OpenTissue::sph::Buoyancy<sph_types>
+  , OpenTissue::sph::PressureForce<sph_types, spiky_kernel>
+  , OpenTissue::sph::ViscosityForce<sph_types, viscosity_kernel>
+  , OpenTissue::sph::SurfaceForce<sph_types, poly6_kernel>
+  , OpenTissue::sph::Verlet<sph_types>
+  , OpenTissue::sph::ColorField<sph_types, poly6_kernel>
+> system_type;
+
+typedef OpenTissue::sph::SoASystem<sph_types>  soa_system_type;
+typedef OpenTissue::sph::Water<sph_types>      material_type;
+
+/**
+* A jittered block of particles with random velocities.
+*/
+void make_block(std::vector<vector3_type> & positions, std::vector<vector3_type> & velocities)
+{
+  OpenTissue::math::Random<double> jitter(-0.002, 0.002);
+  OpenTissue::math::Random<double> speed(-0.05, 0.05);
+  double const spacing = 1.0/45.0;
+  for(int k = 0; k < 8; ++k)
+    for(int j = 0; j < 8; ++j)
+      for(int i = 0; i < 8; ++i)
+      {
+        positions.push_back( vector3_type( i*spacing + jitter(), j*spacing + jitter(), k*spacing + jitter() ) );
+        velocities.push_back( vector3_type( speed(), speed(), speed() ) );
+      }
+}
+
+double relative_difference(vector3_type const & a, vector3_type const & b)
+{
+  return std::sqrt( (a - b)*(a - b) ) / std::max( 1.0, std::sqrt( b*b ) );
+}
+
+/**
+* Compare every particle of the structure of arrays system with the particle of System it was initialized from.
+*/
+void compare(soa_system_type const & soa, system_type const & system)
+{
+  system_type::particle_container const & particles = system.particles();
+  BOOST_REQUIRE( soa.size() == particles.size() );
+
+  std::vector<int> seen( particles.size(), 0 );
+  size_t surface = 0;
+  for(size_t i = 0; i < soa.size(); ++i)
+  {
+    particle_type const & par = particles[ soa.id(i) ];
+    ++seen[ soa.id(i) ];
+
+    BOOST_CHECK_SMALL( relative_difference( soa.position(i), par.position() ), 1e-12 );
+    BOOST_CHECK_SMALL( relative_difference( soa.velocity(i), par.velocity() ), 1e-10 );
+    BOOST_CHECK_CLOSE( soa.density(i), par.density(), 1e-8 );
+    BOOST_CHECK_SMALL( soa.pressure(i) - par.pressure(), 1e-8*std::fabs( par.density() ) );
+    BOOST_CHECK_SMALL( relative_difference( soa.normal(i), par.normal() ), 1e-8 );
+    BOOST_CHECK_SMALL( relative_difference( soa.force(i), par.force() ), 1e-8 );
+
+    if( par.normal()*par.normal() >= soa.material()->threshold() )
+      ++surface;
+  }
+  for(size_t i = 0; i < seen.size(); ++i)
+    BOOST_CHECK( seen[i] == 1 );
+
+  // The surface tension must have been exercised
+  BOOST_CHECK( surface > 0 );
+}
+
+BOOST_AUTO_TEST_SUITE(opentissue_sph_soa_system);
+
+BOOST_AUTO_TEST_CASE(soa_system_test_case)
+{
+  material_type material;
+  material.threshold() = material.density() / material.kernel_particles();
+  Radius = 0.0457;
+
+  std::vector<vector3_type> positions, velocities;
+  make_block(positions, velocities);
+
+  vector3_type const gravity(0.0, 0.0, -9.82);
+
+  system_type system;
+  BOOST_REQUIRE( system.create(material, gravity) );
+  BOOST_REQUIRE( system.initHashing(2u*positions.size(), Radius) );
+  BOOST_REQUIRE( system.init(positions.begin(), positions.end(), velocities.begin(), velocities.end()) );
+
+  soa_system_type soa;
+  BOOST_REQUIRE( soa.create(material, gravity, Radius) );
+  BOOST_REQUIRE( soa.init(positions.begin(), positions.end(), velocities.begin(), velocities.end()) );
+
+  compare(soa, system);
+
+  // System solves before it integrates, SoASystem after, so System
+  // needs an extra solve to get the forces of the final positions
+  for(int step = 0; step < 3; ++step)
+  {
+    BOOST_REQUIRE( system.simulate() );
+    BOOST_REQUIRE( soa.simulate() );
+  }
+  BOOST_REQUIRE( system.solve() );
+
+  compare(soa, system);
+}
+
+BOOST_AUTO_TEST_SUITE_END();